@@ -0,0 +1,186 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Network topology
+//
+//       n0 -------------- n1 -------------- n2
+//          access link       bottleneck link
+//
+// - A single BulkSend flow from n0 to n2.
+// - The same scenario is run four times: plain TCP, TCP with pacing, TCP
+//   with segmentation offload (GSO) and TCP with both. For each run the
+//   program reports the number of events scheduled by the simulator, the
+//   wall-clock time of the run and the goodput, so that the event savings
+//   of GSO and the event cost of pacing can be compared.
+//
+// Usage examples:
+//   ./waf --run "tcp-pacing-gso"
+//   ./waf --run "tcp-pacing-gso --bottleneckRate=40Gbps --gsoSegments=44"
+//   ./waf --run "tcp-pacing-gso --transportProt=TcpBbr"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/system-wall-clock-ms.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpPacingGsoExample");
+
+static void
+Nothing (void)
+{
+}
+
+/*
+ * Event identifiers are allocated sequentially by the simulator: the uid of
+ * an event scheduled at the end of the run is the number of events scheduled
+ * so far.
+ */
+static void
+RecordEventCount (uint64_t *count)
+{
+  *count = Simulator::ScheduleNow (&Nothing).GetUid ();
+}
+
+struct RunResult
+{
+  uint64_t events;   //!< Events scheduled during the run
+  uint64_t wallMs;   //!< Wall-clock time of the run
+  uint64_t rxBytes;  //!< Bytes received by the sink
+};
+
+static RunResult
+RunOnce (bool pacing, uint32_t gsoSegments, std::string transportProt,
+         std::string accessRate, std::string bottleneckRate, std::string delay,
+         double duration)
+{
+  Config::SetDefault ("ns3::TcpL4Protocol::SocketType",
+                      StringValue ("ns3::" + transportProt));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (1 << 22));
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (1 << 22));
+  // Data center-like loss recovery, so that a slow start overshoot does not
+  // stall the flow for a whole second
+  Config::SetDefault ("ns3::TcpSocketBase::MinRto", TimeValue (MilliSeconds (10)));
+  Config::SetDefault ("ns3::TcpSocketBase::Sack", BooleanValue (true));
+  Config::SetDefault ("ns3::TcpSocketBase::Rack", BooleanValue (true));
+  Config::SetDefault ("ns3::TcpSocketBase::Pacing", BooleanValue (pacing));
+  Config::SetDefault ("ns3::TcpSocketBase::GsoMaxSegments", UintegerValue (gsoSegments));
+
+  NodeContainer nodes;
+  nodes.Create (3);
+
+  PointToPointHelper access;
+  access.SetDeviceAttribute ("DataRate", StringValue (accessRate));
+  access.SetChannelAttribute ("Delay", StringValue (delay));
+  NetDeviceContainer accessDevices = access.Install (nodes.Get (0), nodes.Get (1));
+
+  PointToPointHelper bottleneck;
+  bottleneck.SetDeviceAttribute ("DataRate", StringValue (bottleneckRate));
+  bottleneck.SetChannelAttribute ("Delay", StringValue (delay));
+  bottleneck.SetQueue ("ns3::DropTailQueue", "MaxPackets", UintegerValue (1000));
+  NetDeviceContainer bottleneckDevices = bottleneck.Install (nodes.Get (1), nodes.Get (2));
+
+  InternetStackHelper stack;
+  stack.Install (nodes);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  address.Assign (accessDevices);
+  address.SetBase ("10.1.2.0", "255.255.255.0");
+  Ipv4InterfaceContainer sinkInterfaces = address.Assign (bottleneckDevices);
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  uint16_t port = 9;
+  BulkSendHelper source ("ns3::TcpSocketFactory",
+                         InetSocketAddress (sinkInterfaces.GetAddress (1), port));
+  source.SetAttribute ("MaxBytes", UintegerValue (0));
+  ApplicationContainer sourceApps = source.Install (nodes.Get (0));
+  sourceApps.Start (Seconds (0.0));
+  sourceApps.Stop (Seconds (duration));
+
+  PacketSinkHelper sink ("ns3::TcpSocketFactory",
+                         InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sink.Install (nodes.Get (2));
+  sinkApps.Start (Seconds (0.0));
+  sinkApps.Stop (Seconds (duration));
+
+  RunResult result;
+  Simulator::Schedule (Seconds (duration), &RecordEventCount, &result.events);
+  Simulator::Stop (Seconds (duration));
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  result.wallMs = clock.End ();
+
+  result.rxBytes = DynamicCast<PacketSink> (sinkApps.Get (0))->GetTotalRx ();
+  Simulator::Destroy ();
+  return result;
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string transportProt = "TcpNewReno";
+  std::string accessRate = "40Gbps";
+  std::string bottleneckRate = "10Gbps";
+  std::string delay = "50us";
+  uint32_t gsoSegments = 16;
+  double duration = 0.1;
+
+  CommandLine cmd;
+  cmd.AddValue ("transportProt", "Transport protocol to use: TcpNewReno, TcpBbr, ...",
+                transportProt);
+  cmd.AddValue ("accessRate", "Access link data rate", accessRate);
+  cmd.AddValue ("bottleneckRate", "Bottleneck link data rate", bottleneckRate);
+  cmd.AddValue ("delay", "Delay of each link", delay);
+  cmd.AddValue ("gsoSegments", "Maximum number of segments in a super-segment", gsoSegments);
+  cmd.AddValue ("duration", "Simulated time, in seconds", duration);
+  cmd.Parse (argc, argv);
+
+  std::cout << std::setw (10) << "pacing" << std::setw (6) << "gso"
+            << std::setw (12) << "events" << std::setw (10) << "wall(ms)"
+            << std::setw (16) << "goodput(Mbps)" << std::setw (14) << "events/MB"
+            << std::endl;
+
+  for (uint32_t pacing = 0; pacing < 2; ++pacing)
+    {
+      for (uint32_t gso = 0; gso < 2; ++gso)
+        {
+          uint32_t segments = gso ? gsoSegments : 1;
+          RunResult r = RunOnce (pacing, segments, transportProt,
+                                 accessRate, bottleneckRate, delay, duration);
+          double goodput = r.rxBytes * 8.0 / duration / 1e6;
+          double perMb = r.rxBytes ? r.events / (r.rxBytes / 1e6) : 0;
+          std::cout << std::setw (10) << (pacing ? "on" : "off")
+                    << std::setw (6) << segments
+                    << std::setw (12) << r.events
+                    << std::setw (10) << r.wallMs
+                    << std::setw (16) << std::fixed << std::setprecision (1) << goodput
+                    << std::setw (14) << perMb
+                    << std::endl;
+        }
+    }
+  return 0;
+}
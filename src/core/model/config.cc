@@ -25,8 +25,13 @@
 #include "names.h"
 #include "pointer.h"
 #include "log.h"
+#include "simple-ref-count.h"
 
 #include <sstream>
+#include <cctype>
+#include <algorithm>
+#include <limits>
+#include <map>
 
 /**
  * \file
@@ -166,7 +171,22 @@ public:
    * \returns \c true if the index matches the Config Path.
    */
   bool Matches (uint32_t i) const;
+
+  /** A range of indexes, both bounds included. */
+  typedef std::pair<uint32_t, uint32_t> Range;
+  /**
+   * Get the indexes which match the Config path specification.
+   *
+   * \returns The disjoint ranges of matching indexes, in increasing order.
+   */
+  const std::vector<Range> &GetRanges (void) const;
 private:
+  /**
+   * Add the indexes matched by a specification without '|'.
+   *
+   * \param [in] element The Config path specification.
+   */
+  void AddAlternative (std::string element);
   /**
    * Convert a string to an \c uint32_t.
    *
@@ -175,102 +195,297 @@ private:
    * \returns \c true if the string could be converted.
    */
   bool StringToUint32 (std::string str, uint32_t *value) const;
-  /** The Config path element. */
-  std::string m_element;
+  /** The matching indexes. */
+  std::vector<Range> m_ranges;
 };
 
 
 ArrayMatcher::ArrayMatcher (std::string element)
-  : m_element (element)
 {
   NS_LOG_FUNCTION (this << element);
-}
-bool
-ArrayMatcher::Matches (uint32_t i) const
-{
-  NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  std::string::size_type start = 0;
+  std::string::size_type tmp = element.find ("|");
+  while (tmp != std::string::npos)
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches *");
-      return true;
+      AddAlternative (element.substr (start, tmp - start));
+      start = tmp + 1;
+      tmp = element.find ("|", start);
     }
-  std::string::size_type tmp;
-  tmp = m_element.find ("|");
-  if (tmp != std::string::npos)
+  AddAlternative (element.substr (start));
+
+  // Merge the overlapping and adjacent ranges
+  std::sort (m_ranges.begin (), m_ranges.end ());
+  std::vector<Range> ranges;
+  for (std::vector<Range>::const_iterator i = m_ranges.begin (); i != m_ranges.end (); ++i)
     {
-      std::string left = m_element.substr (0, tmp-0);
-      std::string right = m_element.substr (tmp+1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
+      if (!ranges.empty ()
+          && (ranges.back ().second == std::numeric_limits<uint32_t>::max ()
+              || i->first <= ranges.back ().second + 1))
         {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<left);
-          return true;
+          ranges.back ().second = std::max (ranges.back ().second, i->second);
         }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
+      else
         {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<right);
-          return true;
+          ranges.push_back (*i);
         }
-      NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
-      return false;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1 &&
+  m_ranges.swap (ranges);
+}
+void
+ArrayMatcher::AddAlternative (std::string element)
+{
+  NS_LOG_FUNCTION (this << element);
+  if (element == "*")
+    {
+      m_ranges.push_back (Range (0, std::numeric_limits<uint32_t>::max ()));
+      return;
+    }
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1 &&
       dash > leftBracket && dash < rightBracket)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
       uint32_t min;
       uint32_t max;
       if (StringToUint32 (lowerBound, &min) && 
           StringToUint32 (upperBound, &max) &&
-          i >= min && i <= max)
+          min <= max)
         {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-          return true;
-        }
-      else
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" does not "<<m_element);
-          return false;
+          m_ranges.push_back (Range (min, max));
         }
+      return;
     }
   uint32_t value;
-  if (StringToUint32 (m_element, &value) &&
-      i == value)
+  if (StringToUint32 (element, &value))
+    {
+      m_ranges.push_back (Range (value, value));
+    }
+}
+bool
+ArrayMatcher::Matches (uint32_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  for (std::vector<Range>::const_iterator j = m_ranges.begin (); j != m_ranges.end (); ++j)
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-      return true;
+      if (i >= j->first && i <= j->second)
+        {
+          NS_LOG_DEBUG ("Array "<<i<<" matches ["<<j->first<<"-"<<j->second<<"]");
+          return true;
+        }
     }
-  NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
+  NS_LOG_DEBUG ("Array "<<i<<" does not match");
   return false;
 }
+const std::vector<ArrayMatcher::Range> &
+ArrayMatcher::GetRanges (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_ranges;
+}
 
 bool
 ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
 {
   NS_LOG_FUNCTION (this << str << value);
+  // Most elements are attribute names: do not bother the stream with them
+  if (str.empty () || std::isalpha (str[0]) || str[0] == '$')
+    {
+      return false;
+    }
   std::istringstream iss;
   iss.str (str);
   iss >> (*value);
   return !iss.bad () && !iss.fail ();
 }
 
+namespace Config {
+
 /**
- * Abstract class to parse Config paths into object references.
+ * The parsed form of a Config path, shared by the copies of a Config::Path.
  */
-class Resolver
+class PathImpl : public SimpleRefCount<PathImpl>
 {
 public:
   /**
-   * Construct from a base Config path.
+   * Parse a Config path.
    *
    * \param [in] path The Config path.
    */
-  Resolver (std::string path);
+  PathImpl (std::string path);
+
+  /** A pointer or container attribute matched by an element of the path. */
+  struct Member
+  {
+    std::string name;                      //!< The attribute name
+    Ptr<const AttributeAccessor> accessor; //!< The attribute accessor
+    /** The accessor of a container attribute, or zero. */
+    Ptr<const ObjectPtrContainerAccessor> container;
+    bool isContainer;                      //!< Whether it is a container
+    bool gettable;                         //!< Whether it has a getter
+  };
+  /** The attributes matched by an element in a TypeId. */
+  typedef std::vector<Member> Members;
+
+  /** An element of the path, between two '/'. */
+  struct Element
+  {
+    /**
+     * Parse an element.
+     *
+     * \param [in] item The element.
+     */
+    Element (std::string item);
+    std::string item;       //!< The element
+    bool names;             //!< Whether the element starts with "Names"
+    bool getObject;         //!< Whether the element is a "$" TypeId name
+    std::string tidName;    //!< The TypeId name of a "$" element
+    bool hasTid;            //!< Whether the TypeId was found when parsing
+    TypeId tid;             //!< The TypeId of a "$" element
+    ArrayMatcher matcher;   //!< The element as an index of a container
+    /** The attributes matched, by TypeId uid of the object. */
+    std::map<uint16_t, Members> members;
+  };
+
+  /**
+   * Get the attributes which an element matches in objects of a TypeId.
+   *
+   * \param [in] level The index of the element.
+   * \param [in] tid The TypeId of the object.
+   * \returns The matching pointer and container attributes, the
+   *          attributes of \p tid first, then those of its parents.
+   */
+  const Members &GetMembers (uint32_t level, TypeId tid);
+
+  std::string m_path;               //!< The Config path
+  std::vector<Element> m_elements;  //!< The elements of the path
+  /** The number of elements of the path up to the final slash. */
+  uint32_t m_leafDepth;
+};
+
+PathImpl::Element::Element (std::string item)
+  : item (item),
+    names (item.find ("Names") == 0),
+    getObject (item.find ("$") == 0),
+    hasTid (false),
+    matcher (item)
+{
+  NS_LOG_FUNCTION (this << item);
+  if (getObject)
+    {
+      tidName = item.substr (1, item.size () - 1);
+      hasTid = TypeId::LookupByNameFailSafe (tidName, &tid);
+    }
+}
+
+PathImpl::PathImpl (std::string path)
+  : m_path (path),
+    m_leafDepth (0)
+{
+  NS_LOG_FUNCTION (this << path);
+
+  // ensure that we start and end with a '/'
+  std::string canonical = path;
+  if (canonical.find ("/") != 0)
+    {
+      canonical = "/" + canonical;
+    }
+  if (canonical.find_last_of ("/") != canonical.size () - 1)
+    {
+      canonical = canonical + "/";
+    }
+  std::string::size_type cur = 0;
+  std::string::size_type next = canonical.find ("/", 1);
+  while (next != std::string::npos)
+    {
+      m_elements.push_back (Element (canonical.substr (cur + 1, next - (cur + 1))));
+      cur = next;
+      next = canonical.find ("/", cur + 1);
+    }
+
+  // The elements of the path up to the final slash are the first elements
+  // of the path, but for the trailing part and an empty element before it.
+  std::string::size_type slash = path.find_last_of ("/");
+  if (slash != std::string::npos)
+    {
+      m_leafDepth = m_elements.size ();
+      if (slash != path.size () - 1)
+        {
+          m_leafDepth--;
+        }
+      if (slash > 0 && path[slash - 1] == '/')
+        {
+          m_leafDepth--;
+        }
+    }
+}
+
+const PathImpl::Members &
+PathImpl::GetMembers (uint32_t level, TypeId instanceTid)
+{
+  NS_LOG_FUNCTION (this << level << instanceTid);
+  Element &element = m_elements[level];
+  std::map<uint16_t, Members>::const_iterator found = element.members.find (instanceTid.GetUid ());
+  if (found != element.members.end ())
+    {
+      return found->second;
+    }
+
+  Members &members = element.members[instanceTid.GetUid ()];
+  TypeId tid;
+  TypeId nextTid = instanceTid;
+  do
+    {
+      tid = nextTid;
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+          if (info.name != element.item && element.item != "*")
+            {
+              continue;
+            }
+          bool isPointer = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0;
+          bool isContainer = dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0;
+          if (!isPointer && !isContainer)
+            {
+              // this could be anything else and we don't know what to do with it.
+              // So, we just ignore it.
+              continue;
+            }
+          // The value of the attribute is got by name, as
+          // ObjectBase::GetAttribute does.
+          bool ok = instanceTid.LookupAttributeByName (info.name, &info);
+          NS_ASSERT (ok);
+          Member member;
+          member.name = info.name;
+          member.accessor = info.accessor;
+          member.container = DynamicCast<const ObjectPtrContainerAccessor> (info.accessor);
+          member.isContainer = isContainer;
+          member.gettable = (info.flags & TypeId::ATTR_GET) && info.accessor->HasGetter ();
+          members.push_back (member);
+        }
+      nextTid = tid.GetParent ();
+    } while (nextTid != tid);
+  return members;
+}
+
+} // namespace Config
+
+/**
+ * Abstract class to match the objects of a parsed Config path.
+ */
+class Resolver
+{
+public:
+  /**
+   * Construct from a parsed Config path.
+   *
+   * \param [in] path The parsed Config path.
+   * \param [in] depth The number of elements of the path to match.
+   */
+  Resolver (Config::PathImpl *path, uint32_t depth);
   /** Destructor. */
   virtual ~Resolver ();
 
@@ -284,23 +499,22 @@ public:
   void Resolve (Ptr<Object> root);
   
 private:
-  /** Ensure the Config path starts and ends with a '/'. */
-  void Canonicalize (void);
   /**
-   * Parse the next element in the Config path.
+   * Match the next element in the Config path.
    *
-   * \param [in] path The remaining portion of the Config path.
+   * \param [in] level The index of the element.
    * \param [in] root The object corresponding to the current positon
    *                  in the Config path.
    */
-  void DoResolve (std::string path, Ptr<Object> root);
+  void DoResolve (uint32_t level, Ptr<Object> root);
   /**
-   * Parse an index on the Config path.
+   * Match an index on the Config path.
    *
-   * \param [in] path The remaining Config path.
-   * \param [in,out] vector The resulting list of matching objects.
+   * \param [in] level The index of the element.
+   * \param [in] root The object holding the container.
+   * \param [in] member The container attribute.
    */
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void DoArrayResolve (uint32_t level, Ptr<Object> root, const Config::PathImpl::Member &member);
   /**
    * Handle one object found on the path.
    *
@@ -321,61 +535,40 @@ private:
    */
   virtual void DoOne (Ptr<Object> object, std::string path) = 0;
 
-  /** Current list of path tokens. */
-  std::vector<std::string> m_workStack;
-  /** The Config path. */
-  std::string m_path;
+  /** The parsed Config path. */
+  Config::PathImpl *m_path;
+  /** The number of elements to match. */
+  uint32_t m_depth;
+  /** The Config path matched so far. */
+  std::string m_resolved;
 };
 
-Resolver::Resolver (std::string path)
-  : m_path (path)
+Resolver::Resolver (Config::PathImpl *path, uint32_t depth)
+  : m_path (path),
+    m_depth (depth),
+    m_resolved ("/")
 {
-  NS_LOG_FUNCTION (this << path);
-  Canonicalize ();
+  NS_LOG_FUNCTION (this << path << depth);
+  NS_ASSERT (depth <= path->m_elements.size ());
 }
 Resolver::~Resolver ()
 {
   NS_LOG_FUNCTION (this);
 }
-void
-Resolver::Canonicalize (void)
-{
-  NS_LOG_FUNCTION (this);
-
-  // ensure that we start and end with a '/'
-  std::string::size_type tmp = m_path.find ("/");
-  if (tmp != 0)
-    {
-      // no slash at start
-      m_path = "/" + m_path;
-    }
-  tmp = m_path.find_last_of ("/");
-  if (tmp != (m_path.size () - 1))
-    {
-      // no slash at end
-      m_path = m_path + "/";
-    }
-}
 
 void 
 Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  DoResolve (0, root);
 }
 
 std::string
 Resolver::GetResolvedPath (void) const
 {
   NS_LOG_FUNCTION (this);
-
-  std::string fullPath = "/";
-  for (std::vector<std::string>::const_iterator i = m_workStack.begin (); i != m_workStack.end (); i++)
-    {
-      fullPath += *i + "/";
-    }
-  return fullPath;
+  return m_resolved;
 }
 
 void 
@@ -388,13 +581,11 @@ Resolver::DoResolveOne (Ptr<Object> object)
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::DoResolve (uint32_t level, Ptr<Object> root)
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << level << root);
 
-  if (next == std::string::npos)
+  if (level == m_depth)
     {
       //
       // If root is zero, we're beginning to see if we can use the object name 
@@ -410,8 +601,8 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
         }
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  Config::PathImpl::Element &element = m_path->m_elements[level];
+  std::string::size_type resolvedSize = m_resolved.size ();
 
   //
   // If root is zero, we're beginning to see if we can use the object name 
@@ -420,16 +611,12 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   // the root of the "/Names" namespace, so we just ignore it and move on to 
   // the next segment.
   //
-  if (root == 0)
+  if (root == 0 && element.names)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
-        {
-          m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
-          m_workStack.pop_back ();
-          return;
-        }
+      m_resolved += element.item + "/";
+      DoResolve (level + 1, root);
+      m_resolved.resize (resolvedSize);
+      return;
     }
 
   //
@@ -438,13 +625,13 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   // zero, this means to look in the root of the "/Names" name space, otherwise
   // it refers to a name space context (level).
   //
-  Ptr<Object> namedObject = Names::Find<Object> (root, item);
+  Ptr<Object> namedObject = Names::Find<Object> (root, element.item);
   if (namedObject)
     {
-      NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
-      m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
-      m_workStack.pop_back ();
+      NS_LOG_DEBUG ("Name system resolved item = " << element.item << " to " << namedObject);
+      m_resolved += element.item + "/";
+      DoResolve (level + 1, namedObject);
+      m_resolved.resize (resolvedSize);
       return;
     }
 
@@ -459,117 +646,157 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       return;
     }
-  std::string::size_type dollarPos = item.find ("$");
-  if (dollarPos == 0)
+  if (element.getObject)
     {
       // This is a call to GetObject
-      std::string tidString = item.substr (1, item.size () - 1);
-      NS_LOG_DEBUG ("GetObject="<<tidString<<" on path="<<GetResolvedPath ());
-      TypeId tid = TypeId::LookupByName (tidString);
+      NS_LOG_DEBUG ("GetObject="<<element.tidName<<" on path="<<GetResolvedPath ());
+      TypeId tid = element.hasTid ? element.tid : TypeId::LookupByName (element.tidName);
       Ptr<Object> object = root->GetObject<Object> (tid);
       if (object == 0)
         {
-          NS_LOG_DEBUG ("GetObject ("<<tidString<<") failed on path="<<GetResolvedPath ());
+          NS_LOG_DEBUG ("GetObject ("<<element.tidName<<") failed on path="<<GetResolvedPath ());
           return;
         }
-      m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
-      m_workStack.pop_back ();
+      m_resolved += element.item + "/";
+      DoResolve (level + 1, object);
+      m_resolved.resize (resolvedSize);
     }
   else 
     {
       // this is a normal attribute.
-      TypeId tid;
-      TypeId nextTid = root->GetInstanceTypeId ();
+      TypeId tid = root->GetInstanceTypeId ();
+      const Config::PathImpl::Members &members = m_path->GetMembers (level, tid);
       bool foundMatch = false;
-      
-      do
+
+      for (Config::PathImpl::Members::const_iterator i = members.begin (); i != members.end (); ++i)
         {
-          tid = nextTid;
-          
-          for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+          if (!i->gettable)
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute(i);
-              if (info.name != item && item != "*")
-                {
-                  continue;
-                }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *ptr = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
-              if (ptr != 0)
+              NS_FATAL_ERROR ("Attribute name="<<i->name<<" is not gettable for this object: tid="<<tid.GetName ());
+            }
+          if (!i->isContainer)
+            {
+              NS_LOG_DEBUG ("GetAttribute(ptr)="<<i->name<<" on path="<<GetResolvedPath ());
+              PointerValue ptr;
+              if (!i->accessor->Get (PeekPointer (root), ptr))
                 {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)="<<info.name<<" on path="<<GetResolvedPath ());
-                  PointerValue ptr;
-                  root->GetAttribute (info.name, ptr);
-                  Ptr<Object> object = ptr.Get<Object> ();
-                  if (object == 0)
-                    {
-                      NS_LOG_ERROR ("Requested object name=\""<<item<<
-                                    "\" exists on path=\""<<GetResolvedPath ()<<"\""
-                                    " but is null.");
-                      continue;
-                    }
-                  foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
-                  m_workStack.pop_back ();
+                  NS_FATAL_ERROR ("Attribute name="<<i->name<<" tid="<<tid.GetName () << ": could not get value");
                 }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker = 
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
+              Ptr<Object> object = ptr.Get<Object> ();
+              if (object == 0)
                 {
-                  NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath () << pathLeft);
-                  foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
-                  m_workStack.pop_back ();
+                  NS_LOG_ERROR ("Requested object name=\""<<element.item<<
+                                "\" exists on path=\""<<GetResolvedPath ()<<"\""
+                                " but is null.");
+                  continue;
                 }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
+              foundMatch = true;
+              m_resolved += i->name + "/";
+              DoResolve (level + 1, object);
+              m_resolved.resize (resolvedSize);
+            }
+          else
+            {
+              NS_LOG_DEBUG ("GetAttribute(vector)="<<i->name<<" on path="<<GetResolvedPath ());
+              foundMatch = true;
+              m_resolved += i->name + "/";
+              DoArrayResolve (level + 1, root, *i);
+              m_resolved.resize (resolvedSize);
             }
+        }
 
-          nextTid = tid.GetParent ();
-        } while (nextTid != tid);
-      
       if (!foundMatch)
         {
-          NS_LOG_DEBUG ("Requested item="<<item<<" does not exist on path="<<GetResolvedPath ());
+          NS_LOG_DEBUG ("Requested item="<<element.item<<" does not exist on path="<<GetResolvedPath ());
           return;
         }
     }
 }
 
 void 
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Resolver::DoArrayResolve (uint32_t level, Ptr<Object> root, const Config::PathImpl::Member &member)
 {
-  NS_LOG_FUNCTION(this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION (this << level << root << member.name);
+  if (level == m_depth)
     {
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  const ArrayMatcher &matcher = m_path->m_elements[level].matcher;
 
-  ArrayMatcher matcher = ArrayMatcher (item);
-  ObjectPtrContainerValue::Iterator it;
-  for (it = container.Begin (); it != container.End (); ++it)
+  //
+  // Fetch the matching objects only, by their position in the container.
+  // This requires the index of each object to be its position: as the
+  // indexes increase with the positions, this holds if the index of the
+  // last object is its position. Otherwise, fall back to matching the
+  // index of each object of the container.
+  //
+  typedef std::vector<std::pair<uint32_t, Ptr<Object> > > Items;
+  Items items;
+  bool direct = member.container != 0;
+  uint32_t n = 0;
+  if (direct && !member.container->GetN (PeekPointer (root), &n))
     {
-      if (matcher.Matches ((*it).first))
+      NS_FATAL_ERROR ("Attribute name="<<member.name<<" tid="<<root->GetInstanceTypeId ().GetName () << ": could not get value");
+    }
+  if (direct && n > 0)
+    {
+      uint32_t index;
+      member.container->Get (PeekPointer (root), n - 1, &index);
+      direct = index == n - 1;
+    }
+  const std::vector<ArrayMatcher::Range> &ranges = matcher.GetRanges ();
+  for (std::vector<ArrayMatcher::Range>::const_iterator r = ranges.begin (); direct && r != ranges.end (); ++r)
+    {
+      for (uint32_t i = r->first; i < n && i <= r->second; i++)
         {
-          std::ostringstream oss;
-          oss << (*it).first;
-          m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
-          m_workStack.pop_back ();
+          uint32_t index;
+          Ptr<Object> object = member.container->Get (PeekPointer (root), i, &index);
+          if (index != i)
+            {
+              direct = false;
+              break;
+            }
+          items.push_back (std::make_pair (index, object));
         }
     }
+  if (!direct)
+    {
+      items.clear ();
+      ObjectPtrContainerValue container;
+      if (!member.accessor->Get (PeekPointer (root), container))
+        {
+          NS_FATAL_ERROR ("Attribute name="<<member.name<<" tid="<<root->GetInstanceTypeId ().GetName () << ": could not get value");
+        }
+      for (ObjectPtrContainerValue::Iterator it = container.Begin (); it != container.End (); ++it)
+        {
+          if (matcher.Matches ((*it).first))
+            {
+              items.push_back (*it);
+            }
+        }
+    }
+
+  std::string::size_type resolvedSize = m_resolved.size ();
+  for (Items::const_iterator it = items.begin (); it != items.end (); ++it)
+    {
+      // Append the decimal index
+      char digits[10];
+      uint32_t nDigits = 0;
+      uint32_t index = it->first;
+      do
+        {
+          digits[nDigits++] = '0' + index % 10;
+          index /= 10;
+        }
+      while (index != 0);
+      while (nDigits > 0)
+        {
+          m_resolved += digits[--nDigits];
+        }
+      m_resolved += '/';
+      DoResolve (level + 1, it->second);
+      m_resolved.resize (resolvedSize);
+    }
 }
 
 /** Config system implementation class. */
@@ -588,6 +815,16 @@ public:
   void Disconnect (std::string path, const CallbackBase &cb);
   /** \copydoc Config::LookupMatches() */
   Config::MatchContainer LookupMatches (std::string path);
+  /**
+   * Match the first elements of a parsed Config path.
+   *
+   * \param [in] path The parsed Config path.
+   * \param [in] depth The number of elements to match.
+   * \param [in] matchPath The path stored in the returned container.
+   * \returns A container which contains all the objects which match the
+   *          first \p depth elements of \p path.
+   */
+  Config::MatchContainer LookupMatches (Config::PathImpl *path, uint32_t depth, std::string matchPath);
 
   /** \copydoc Config::RegisterRootNamespaceObject() */
   void RegisterRootNamespaceObject (Ptr<Object> obj);
@@ -681,11 +918,19 @@ Config::MatchContainer
 ConfigImpl::LookupMatches (std::string path)
 {
   NS_LOG_FUNCTION (this << path);
+  Config::PathImpl parsed (path);
+  return LookupMatches (&parsed, parsed.m_elements.size (), path);
+}
+
+Config::MatchContainer 
+ConfigImpl::LookupMatches (Config::PathImpl *path, uint32_t depth, std::string matchPath)
+{
+  NS_LOG_FUNCTION (this << path << depth << matchPath);
   class LookupMatchesResolver : public Resolver 
   {
   public:
-    LookupMatchesResolver (std::string path)
-      : Resolver (path)
+    LookupMatchesResolver (Config::PathImpl *path, uint32_t depth)
+      : Resolver (path, depth)
     {}
     virtual void DoOne (Ptr<Object> object, std::string path) {
       m_objects.push_back (object);
@@ -693,7 +938,7 @@ ConfigImpl::LookupMatches (std::string path)
     }
     std::vector<Ptr<Object> > m_objects;
     std::vector<std::string> m_contexts;
-  } resolver = LookupMatchesResolver (path);
+  } resolver = LookupMatchesResolver (path, depth);
   for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
     {
       resolver.Resolve (*i);
@@ -706,7 +951,7 @@ ConfigImpl::LookupMatches (std::string path)
   //
   resolver.Resolve (0);
 
-  return Config::MatchContainer (resolver.m_objects, resolver.m_contexts, path);
+  return Config::MatchContainer (resolver.m_objects, resolver.m_contexts, matchPath);
 }
 
 void 
@@ -873,6 +1118,91 @@ Ptr<Object> GetRootNamespaceObject (uint32_t i)
   return ConfigImpl::Get ()->GetRootNamespaceObject (i);
 }
 
+Path::Path ()
+  : m_impl (Create<PathImpl> (""))
+{
+  NS_LOG_FUNCTION (this);
+}
+Path::Path (std::string path)
+  : m_impl (Create<PathImpl> (path))
+{
+  NS_LOG_FUNCTION (this << path);
+}
+Path::Path (const Path &o)
+  : m_impl (o.m_impl)
+{
+  NS_LOG_FUNCTION (this << &o);
+}
+Path &
+Path::operator = (const Path &o)
+{
+  NS_LOG_FUNCTION (this << &o);
+  m_impl = o.m_impl;
+  return *this;
+}
+Path::~Path ()
+{
+  NS_LOG_FUNCTION (this);
+}
+std::string
+Path::GetPath (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_impl->m_path;
+}
+MatchContainer
+Path::LookupMatches (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return ConfigImpl::Get ()->LookupMatches (PeekPointer (m_impl), m_impl->m_elements.size (), m_impl->m_path);
+}
+MatchContainer
+Path::LookupLeafMatches (void) const
+{
+  NS_LOG_FUNCTION (this);
+  std::string::size_type slash = m_impl->m_path.find_last_of ("/");
+  NS_ASSERT (slash != std::string::npos);
+  return ConfigImpl::Get ()->LookupMatches (PeekPointer (m_impl), m_impl->m_leafDepth, m_impl->m_path.substr (0, slash));
+}
+std::string
+Path::GetLeaf (void) const
+{
+  NS_LOG_FUNCTION (this);
+  std::string::size_type slash = m_impl->m_path.find_last_of ("/");
+  NS_ASSERT (slash != std::string::npos);
+  return m_impl->m_path.substr (slash + 1, m_impl->m_path.size () - (slash + 1));
+}
+void
+Path::Set (const AttributeValue &value) const
+{
+  NS_LOG_FUNCTION (this << &value);
+  LookupLeafMatches ().Set (GetLeaf (), value);
+}
+void
+Path::Connect (const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << &cb);
+  LookupLeafMatches ().Connect (GetLeaf (), cb);
+}
+void
+Path::ConnectWithoutContext (const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << &cb);
+  LookupLeafMatches ().ConnectWithoutContext (GetLeaf (), cb);
+}
+void
+Path::Disconnect (const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << &cb);
+  LookupLeafMatches ().Disconnect (GetLeaf (), cb);
+}
+void
+Path::DisconnectWithoutContext (const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << &cb);
+  LookupLeafMatches ().DisconnectWithoutContext (GetLeaf (), cb);
+}
+
 } // namespace Config
 
 } // namespace ns3
@@ -258,6 +258,114 @@ private:
  */
 MatchContainer LookupMatches (std::string path);
 
+class PathImpl;
+
+/**
+ * \ingroup config
+ * \brief A Config path parsed once, to be matched many times.
+ *
+ * Config::Set, Config::Connect and Config::LookupMatches parse their path
+ * on each call. A Path parses it once, looks up the TypeId of each "$"
+ * element once, and remembers, for each element and for each TypeId met
+ * while matching, which pointer and container attributes the element
+ * matches. Container elements such as "/NodeList/5" or "/NodeList/[2-7]"
+ * fetch the matching objects only, instead of all the objects of the
+ * container.
+ *
+ * The objects are matched when the Path is used, hence a Path can be
+ * built before the topology, and reused when objects are added:
+ *
+ * \code
+ *   Config::Path path ("/NodeList/[0-999]/DeviceList/0/MacTx");
+ *   Config::MatchContainer devices = path.LookupMatches ();
+ *   path.ConnectWithoutContext (MakeCallback (&MacTxSink));
+ * \endcode
+ *
+ * Copies of a Path share the parsed path and its cache.
+ */
+class Path
+{
+public:
+  /** Create an empty path, matching the root namespace objects. */
+  Path ();
+  /**
+   * Parse a path.
+   *
+   * \param [in] path The path, with the same syntax as the path of
+   *                  Config::Set and Config::Connect.
+   */
+  Path (std::string path);
+  /**
+   * Copy constructor.
+   * \param [in] o The Path to copy.
+   */
+  Path (const Path &o);
+  /**
+   * Assignment.
+   * \param [in] o The Path to copy.
+   * \returns This Path.
+   */
+  Path &operator = (const Path &o);
+  /** Destructor. */
+  ~Path ();
+
+  /**
+   * \returns The path parsed.
+   */
+  std::string GetPath (void) const;
+
+  /**
+   * Match all the objects of the path in one pass.
+   *
+   * \returns A container which contains all the objects which match the
+   *          whole path.
+   * \sa ns3::Config::LookupMatches
+   */
+  MatchContainer LookupMatches (void) const;
+  /**
+   * \param [in] value The value to set in all the attributes matching
+   *                   the path.
+   * \sa ns3::Config::Set
+   */
+  void Set (const AttributeValue &value) const;
+  /**
+   * \param [in] cb The callback to connect to the matching trace sources.
+   * \sa ns3::Config::Connect
+   */
+  void Connect (const CallbackBase &cb) const;
+  /**
+   * \param [in] cb The callback to connect to the matching trace sources.
+   * \sa ns3::Config::ConnectWithoutContext
+   */
+  void ConnectWithoutContext (const CallbackBase &cb) const;
+  /**
+   * \param [in] cb The callback to disconnect from the matching trace sources.
+   * \sa ns3::Config::Disconnect
+   */
+  void Disconnect (const CallbackBase &cb) const;
+  /**
+   * \param [in] cb The callback to disconnect from the matching trace sources.
+   * \sa ns3::Config::DisconnectWithoutContext
+   */
+  void DisconnectWithoutContext (const CallbackBase &cb) const;
+
+private:
+  /**
+   * Match the objects of the path but its last element.
+   *
+   * \returns A container which contains all the objects which match the
+   *          path without its last element.
+   */
+  MatchContainer LookupLeafMatches (void) const;
+  /**
+   * \returns The last element of the path.
+   */
+  std::string GetLeaf (void) const;
+
+  /** The parsed path, shared by the copies of this Path. */
+  Ptr<PathImpl> m_impl;
+};
+
 /**
  * \ingroup config
  * \param [in] obj A new root object
@@ -79,97 +79,134 @@ ObjectBase::NotifyConstructionCompleted (void)
 void
 ObjectBase::ConstructSelf (const AttributeConstructionList &attributes)
 {
-  // loop over the inheritance tree back to the Object base class.
+  // loop over the attributes of the inheritance tree back to the Object base class.
   NS_LOG_FUNCTION (this << &attributes);
-  TypeId tid = GetInstanceTypeId ();
-  do {
-      // loop over all attributes in object type
-      NS_LOG_DEBUG ("construct tid="<<tid.GetName ()<<", params="<<tid.GetAttributeN ());
-      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+  Ptr<const TypeId::AttributeChain> chain = GetInstanceTypeId ().GetAttributeChain ();
+  const char *envVar = 0;
+#ifdef HAVE_GETENV
+  envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
+#endif /* HAVE_GETENV */
+  for (std::vector<struct TypeId::InheritedAttribute>::const_iterator i = chain->attributes.begin ();
+       i != chain->attributes.end (); ++i)
+    {
+      const struct TypeId::AttributeInformation &info = i->info;
+      NS_LOG_DEBUG ("try to construct \""<< i->tidName <<"::"<<
+                    info.name <<"\"");
+      // is this attribute stored in this AttributeConstructionList instance ?
+      Ptr<AttributeValue> value = attributes.Find(info.checker);
+      // See if this attribute should not be set here in the
+      // constructor.
+      if (!(info.flags & TypeId::ATTR_CONSTRUCT))
         {
-          struct TypeId::AttributeInformation info = tid.GetAttribute(i);
-          NS_LOG_DEBUG ("try to construct \""<< tid.GetName ()<<"::"<<
-                        info.name <<"\"");
-          // is this attribute stored in this AttributeConstructionList instance ?
-          Ptr<AttributeValue> value = attributes.Find(info.checker);
-          // See if this attribute should not be set here in the
-          // constructor.
-          if (!(info.flags & TypeId::ATTR_CONSTRUCT))
-            {
-              // Handle this attribute if it should not be 
-              // set here.
-              if (value == 0)
-                {
-                  // Skip this attribute if it's not in the
-                  // AttributeConstructionList.
-                  continue;
-                }              
-              else
-                {
-                  // This is an error because this attribute is not
-                  // settable in its constructor but is present in
-                  // the AttributeConstructionList.
-                  NS_FATAL_ERROR ("Attribute name="<<info.name<<" tid="<<tid.GetName () << ": initial value cannot be set using attributes");
-                }
-            }
-          bool found = false;
-          if (value != 0)
+          // Handle this attribute if it should not be 
+          // set here.
+          if (value == 0)
             {
-              // We have a matching attribute value.
-              if (DoSet (info.accessor, info.checker, *value))
-                {
-                  NS_LOG_DEBUG ("construct \""<< tid.GetName ()<<"::"<<
-                                info.name<<"\"");
-                  found = true;
-                  continue;
-                }
+              // Skip this attribute if it's not in the
+              // AttributeConstructionList.
+              continue;
             }              
-          if (!found)
+          else
+            {
+              // This is an error because this attribute is not
+              // settable in its constructor but is present in
+              // the AttributeConstructionList.
+              NS_FATAL_ERROR ("Attribute name="<<info.name<<" tid="<<i->tidName << ": initial value cannot be set using attributes");
+            }
+        }
+      if (value != 0)
+        {
+          // We have a matching attribute value.
+          if (DoSet (info.accessor, info.checker, *value))
             {
-              // No matching attribute value so we try to look at the env var.
+              NS_LOG_DEBUG ("construct \""<< i->tidName <<"::"<<
+                            info.name<<"\"");
+              continue;
+            }
+        }              
+      ConstructDefault (*i, envVar);
+    }
+  NotifyConstructionCompleted ();
+}
+
+void
+ObjectBase::ConstructSelf (const AttributeConstructionPlan &plan)
+{
+  NS_LOG_FUNCTION (this << &plan);
+  NS_ASSERT (plan.chain->attributes.size () == plan.items.size ());
+  const char *envVar = 0;
 #ifdef HAVE_GETENV
-              char *envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
-              if (envVar != 0)
+  envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
+#endif /* HAVE_GETENV */
+  for (uint32_t i = 0; i < plan.items.size (); i++)
+    {
+      const struct TypeId::InheritedAttribute &attribute = plan.chain->attributes[i];
+      const struct AttributeConstructionPlan::Item &item = plan.items[i];
+      if (!(attribute.info.flags & TypeId::ATTR_CONSTRUCT))
+        {
+          // The plan has no value for these attributes.
+          continue;
+        }
+      if (item.value != 0)
+        {
+          if (item.checked ? attribute.info.accessor->Set (this, *item.value)
+              : DoSet (attribute.info.accessor, attribute.info.checker, *item.value))
+            {
+              continue;
+            }
+        }
+      ConstructDefault (attribute, envVar);
+    }
+  NotifyConstructionCompleted ();
+}
+
+void
+ObjectBase::ConstructDefault (const struct TypeId::InheritedAttribute &attribute,
+                              const char *envVar)
+{
+  const struct TypeId::AttributeInformation &info = attribute.info;
+  // No matching attribute value so we try to look at the env var.
+  if (envVar != 0)
+    {
+      std::string env = std::string (envVar);
+      std::string fullName = attribute.tidName + "::" + info.name;
+      std::string::size_type cur = 0;
+      std::string::size_type next = 0;
+      while (next != std::string::npos)
+        {
+          next = env.find (";", cur);
+          std::string tmp = std::string (env, cur, next-cur);
+          std::string::size_type equal = tmp.find ("=");
+          if (equal != std::string::npos)
+            {
+              std::string name = tmp.substr (0, equal);
+              std::string value = tmp.substr (equal+1, tmp.size () - equal - 1);
+              if (name == fullName)
                 {
-                  std::string env = std::string (envVar);
-                  std::string::size_type cur = 0;
-                  std::string::size_type next = 0;
-                  while (next != std::string::npos)
+                  if (DoSet (info.accessor, info.checker, StringValue (value)))
                     {
-                      next = env.find (";", cur);
-                      std::string tmp = std::string (env, cur, next-cur);
-                      std::string::size_type equal = tmp.find ("=");
-                      if (equal != std::string::npos)
-                        {
-                          std::string name = tmp.substr (0, equal);
-                          std::string value = tmp.substr (equal+1, tmp.size () - equal - 1);
-                          if (name == tid.GetAttributeFullName (i))
-                            {
-                              if (DoSet (info.accessor, info.checker, StringValue (value)))
-                                {
-                                  NS_LOG_DEBUG ("construct \""<< tid.GetName ()<<"::"<<
-                                                info.name <<"\" from env var");
-                                  found = true;
-                                  break;
-                                }
-                            }
-                        }
-                      cur = next + 1;
+                      NS_LOG_DEBUG ("construct \""<< fullName <<"\" from env var");
+                      return;
                     }
                 }
-#endif /* HAVE_GETENV */
-            }
-          if (!found)
-            {
-              // No matching attribute value so we try to set the default value.
-              DoSet (info.accessor, info.checker, *info.initialValue);
-              NS_LOG_DEBUG ("construct \""<< tid.GetName ()<<"::"<<
-                            info.name <<"\" from initial value.");
             }
+          cur = next + 1;
         }
-      tid = tid.GetParent ();
-    } while (tid != ObjectBase::GetTypeId ());
-  NotifyConstructionCompleted ();
+    }
+  // No matching attribute value so we try to set the default value.
+  // An initial value of the type of the attribute is set as is, others
+  // are converted for each object, so that, e.g., each object gets its
+  // own random variable.
+  if (attribute.initialValueChecked)
+    {
+      info.accessor->Set (this, *info.initialValue);
+    }
+  else
+    {
+      DoSet (info.accessor, info.checker, *info.initialValue);
+    }
+  NS_LOG_DEBUG ("construct \""<< attribute.tidName <<"::"<<
+                info.name <<"\" from initial value.");
 }
 
 bool
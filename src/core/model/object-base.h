@@ -24,6 +24,7 @@
 #include "callback.h"
 #include <string>
 #include <list>
+#include <vector>
 
 /**
  * \file
@@ -55,6 +56,32 @@ namespace ns3 {
 
 class AttributeConstructionList;
 
+/**
+ * \ingroup object
+ *
+ * \brief The attribute values of an AttributeConstructionList, matched
+ * once to the attributes of a TypeId.
+ *
+ * ObjectFactory keeps one to construct many objects of the same TypeId
+ * without searching its AttributeConstructionList for each attribute of
+ * each object.
+ */
+struct AttributeConstructionPlan : public SimpleRefCount<AttributeConstructionPlan>
+{
+  /** The value of an attribute of the chain. */
+  struct Item
+  {
+    /** The value given to the attribute, or 0 to use its initial value. */
+    Ptr<const AttributeValue> value;
+    /** \c true if the checker accepts the value as is. */
+    bool checked;
+  };
+  /** The attributes of the TypeId and of its parents. */
+  Ptr<const TypeId::AttributeChain> chain;
+  /** The value of each attribute of the chain. */
+  std::vector<struct Item> items;
+};
+
 /**
  * \ingroup object
  *
@@ -213,8 +240,28 @@ protected:
    *        the member variables of this object's instance.
    */
   void ConstructSelf (const AttributeConstructionList &attributes);
+  /**
+   * Complete construction of ObjectBase with the values of a plan.
+   *
+   * Equivalent to ConstructSelf with the AttributeConstructionList
+   * the plan was made from.
+   *
+   * \param [in] plan The attribute values, matched to the attributes
+   *        of the TypeId of this object.
+   */
+  void ConstructSelf (const AttributeConstructionPlan &plan);
 
 private:
+  /**
+   * Set an attribute which was not given a value to its value in
+   * the \c NS_ATTRIBUTE_DEFAULT environment variable, if any, or to
+   * its initial value.
+   *
+   * \param [in] attribute The attribute.
+   * \param [in] envVar The value of \c NS_ATTRIBUTE_DEFAULT, or 0.
+   */
+  void ConstructDefault (const struct TypeId::InheritedAttribute &attribute,
+                         const char *envVar);
   /**
    * Attempt to set the value referenced by the accessor \p spec
    * to a valid value according to the \c checker, based on \p value.
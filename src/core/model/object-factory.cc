@@ -47,18 +47,21 @@ ObjectFactory::SetTypeId (TypeId tid)
 {
   NS_LOG_FUNCTION (this << tid.GetName ());
   m_tid = tid;
+  m_plan = 0;
 }
 void
 ObjectFactory::SetTypeId (std::string tid)
 {
   NS_LOG_FUNCTION (this << tid);
   m_tid = TypeId::LookupByName (tid);
+  m_plan = 0;
 }
 void
 ObjectFactory::SetTypeId (const char *tid)
 {
   NS_LOG_FUNCTION (this << tid);
   m_tid = TypeId::LookupByName (tid);
+  m_plan = 0;
 }
 void
 ObjectFactory::Set (std::string name, const AttributeValue &value)
@@ -82,6 +85,7 @@ ObjectFactory::Set (std::string name, const AttributeValue &value)
       return;
     }
   m_parameters.Add (name, info.checker, value.Copy ());
+  m_plan = 0;
 }
 
 TypeId 
@@ -100,11 +104,41 @@ ObjectFactory::Create (void) const
   Object *derived = dynamic_cast<Object *> (base);
   NS_ASSERT (derived != 0);
   derived->SetTypeId (m_tid);
-  derived->Construct (m_parameters);
+  Ptr<const TypeId::AttributeChain> chain = m_tid.GetAttributeChain ();
+  if (m_plan == 0 || m_plan->chain != chain)
+    {
+      m_plan = MakePlan (chain);
+    }
+  derived->Construct (*m_plan);
   Ptr<Object> object = Ptr<Object> (derived, false);
   return object;
 }
 
+Ptr<const AttributeConstructionPlan>
+ObjectFactory::MakePlan (Ptr<const TypeId::AttributeChain> chain) const
+{
+  NS_LOG_FUNCTION (this << chain);
+  Ptr<AttributeConstructionPlan> plan = ns3::Create<AttributeConstructionPlan> ();
+  plan->chain = chain;
+  for (std::vector<struct TypeId::InheritedAttribute>::const_iterator i = chain->attributes.begin ();
+       i != chain->attributes.end (); ++i)
+    {
+      struct AttributeConstructionPlan::Item item;
+      item.value = m_parameters.Find (i->info.checker);
+      item.checked = false;
+      if (item.value != 0)
+        {
+          if (!(i->info.flags & TypeId::ATTR_CONSTRUCT))
+            {
+              NS_FATAL_ERROR ("Attribute name=" << i->info.name << " tid=" << i->tidName << ": initial value cannot be set using attributes");
+            }
+          item.checked = i->info.checker->Check (*item.value);
+        }
+      plan->items.push_back (item);
+    }
+  return plan;
+}
+
 std::ostream & operator << (std::ostream &os, const ObjectFactory &factory)
 {
   os << factory.m_tid.GetName () << "[";
@@ -184,6 +218,7 @@ std::istream & operator >> (std::istream &is, ObjectFactory &factory)
               else
                 {
                   factory.m_parameters.Add (name, info.checker, val);
+                  factory.m_plan = 0;
                 }
             }
         }
@@ -106,6 +106,14 @@ public:
   Ptr<T> Create (void) const;
 
 private:
+  /**
+   * Match the parameters to the attributes of the TypeId.
+   *
+   * \param [in] chain The attributes of the TypeId and of its parents.
+   * \returns The plan to construct objects with.
+   */
+  Ptr<const AttributeConstructionPlan> MakePlan (Ptr<const TypeId::AttributeChain> chain) const;
+
   /**
    * Print the factory configuration on an output stream.
    *
@@ -136,6 +144,11 @@ private:
    * objects by this factory.
    */
   AttributeConstructionList m_parameters;  
+  /**
+   * The parameters matched to the attributes of m_tid, made by the
+   * first Create and remade once the attributes change.
+   */
+  mutable Ptr<const AttributeConstructionPlan> m_plan;
 };
 
 std::ostream & operator << (std::ostream &os, const ObjectFactory &factory);
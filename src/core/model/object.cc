@@ -97,11 +97,10 @@ Object::Object ()
   : m_tid (Object::GetTypeId ()),
     m_disposed (false),
     m_initialized (false),
-    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates))),
+    m_aggregates (AllocateAggregates (1)),
     m_getObjectCount (0)
 {
   NS_LOG_FUNCTION (this);
-  m_aggregates->n = 1;
   m_aggregates->buffer[0] = this;
 }
 Object::~Object () 
@@ -120,11 +119,14 @@ Object::~Object ()
           m_aggregates->n--;
         }
     }
+  // the cache may point to this object
+  std::free (m_aggregates->cache);
+  m_aggregates->cache = 0;
   // finally, if all objects have been removed from the list,
   // delete the aggregate list
   if (m_aggregates->n == 0)
     {
-      std::free (m_aggregates);
+      FreeAggregates (m_aggregates);
     }
   m_aggregates = 0;
 }
@@ -132,10 +134,9 @@ Object::Object (const Object &o)
   : m_tid (o.m_tid),
     m_disposed (false),
     m_initialized (false),
-    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates))),
+    m_aggregates (AllocateAggregates (1)),
     m_getObjectCount (0)
 {
-  m_aggregates->n = 1;
   m_aggregates->buffer[0] = this;
 }
 void
@@ -144,6 +145,45 @@ Object::Construct (const AttributeConstructionList &attributes)
   NS_LOG_FUNCTION (this << &attributes);
   ConstructSelf (attributes);
 }
+void
+Object::Construct (const AttributeConstructionPlan &plan)
+{
+  NS_LOG_FUNCTION (this << &plan);
+  ConstructSelf (plan);
+}
+
+/**
+ * Size of the cache of DoGetObject: the number of TypeIds looked up
+ * in the aggregates of a typical Node is well below.
+ */
+#define LOOKUP_CACHE_SIZE 16
+
+struct Object::LookupCache
+{
+  /** The uid of the TypeId looked up, or 0 if the entry is empty. */
+  uint16_t uid[LOOKUP_CACHE_SIZE];
+  /** The Object found, or 0 if there was none. */
+  Object *object[LOOKUP_CACHE_SIZE];
+};
+
+struct Object::Aggregates *
+Object::AllocateAggregates (uint32_t n)
+{
+  NS_LOG_FUNCTION (n);
+  struct Aggregates *aggregates =
+    (struct Aggregates *)std::malloc (sizeof (struct Aggregates) + (n - 1) * sizeof (Object *));
+  aggregates->n = n;
+  aggregates->cache = 0;
+  return aggregates;
+}
+
+void
+Object::FreeAggregates (struct Aggregates *aggregates)
+{
+  NS_LOG_FUNCTION (aggregates);
+  std::free (aggregates->cache);
+  std::free (aggregates);
+}
 
 Ptr<Object>
 Object::DoGetObject (TypeId tid) const
@@ -151,6 +191,21 @@ Object::DoGetObject (TypeId tid) const
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (CheckLoose ());
 
+  uint16_t uid = tid.GetUid ();
+  uint32_t slot = uid % LOOKUP_CACHE_SIZE;
+  struct LookupCache *cache = m_aggregates->cache;
+  if (cache != 0 && cache->uid[slot] == uid)
+    {
+      return cache->object[slot];
+    }
+  if (cache == 0)
+    {
+      cache = (struct LookupCache *) std::calloc (1, sizeof (struct LookupCache));
+      m_aggregates->cache = cache;
+    }
+  cache->uid[slot] = uid;
+  cache->object[slot] = 0;
+
   uint32_t n = m_aggregates->n;
   TypeId objectTid = Object::GetTypeId ();
   for (uint32_t i = 0; i < n; i++)
@@ -174,6 +229,7 @@ Object::DoGetObject (TypeId tid) const
           // then, update the sort
           UpdateSortedArray (m_aggregates, i);
           // finally, return the match
+          cache->object[slot] = current;
           return const_cast<Object *> (current);
         }
     }
@@ -260,9 +316,7 @@ Object::AggregateObject (Ptr<Object> o)
   Object *other = PeekPointer (o);
   // first create the new aggregate buffer.
   uint32_t total = m_aggregates->n + other->m_aggregates->n;
-  struct Aggregates *aggregates = 
-    (struct Aggregates *)std::malloc (sizeof(struct Aggregates)+(total-1)*sizeof(Object*));
-  aggregates->n = total;
+  struct Aggregates *aggregates = AllocateAggregates (total);
 
   // copy our buffer to the new buffer
   std::memcpy (&aggregates->buffer[0], 
@@ -314,8 +368,8 @@ Object::AggregateObject (Ptr<Object> o)
     }
 
   // Now that we are done with them, we can free our old aggregate buffers
-  std::free (a);
-  std::free (b);
+  FreeAggregates (a);
+  FreeAggregates (b);
 }
 /**
  * This function must be implemented in the stack that needs to notify
@@ -149,6 +149,12 @@ private:
   /**
    * Get a pointer to the requested aggregated Object.
    *
+   * \warning Although it is const, a lookup updates the cache of
+   * the aggregates and may reorder them, and the Ptr returned changes
+   * the reference count of the Object: GetObject must not be called
+   * concurrently on any of the Objects aggregated together, including
+   * from threads which only look up Objects.
+   *
    * \returns A pointer to the requested Object, or zero
    *          if it could not be found.
    */
@@ -157,6 +163,9 @@ private:
   /**
    * Get a pointer to the requested aggregated Object by TypeId.
    * 
+   * \warning As GetObject(void), this may not be called
+   * concurrently on Objects aggregated together.
+   *
    * \param [in] tid The TypeId of the requested Object.
    * \returns A pointer to the requested Object, or zero
    *          if it could not be found.
@@ -323,6 +332,20 @@ private:
   friend class AggregateIterator;
   friend struct ObjectDeleter;
 
+  /**
+   * The Objects found by DoGetObject, indexed by the uid of the TypeId
+   * looked up.
+   *
+   * The aggregates of an Object only change when a new array of
+   * aggregates is made by AggregateObject, and when the Objects are
+   * deleted, hence the cache is dropped with the array.
+   *
+   * The cache is allocated and its slots are overwritten by lookups,
+   * without any lock: a concurrent lookup could see a slot being
+   * updated, and return zero or the Object found for another TypeId.
+   */
+  struct LookupCache;
+
   /**
    * The list of Objects aggregated to this one.
    *
@@ -338,9 +361,24 @@ private:
   struct Aggregates {
     /** The number of entries in \c buffer. */
     uint32_t n;
+    /** The results of DoGetObject, allocated by the first lookup. */
+    struct LookupCache *cache;
     /** The array of Objects. */
     Object *buffer[1];
   };
+  /**
+   * Allocate an array of aggregates, with an empty cache.
+   *
+   * \param [in] n The number of entries of the array.
+   * \return The array.
+   */
+  static struct Aggregates *AllocateAggregates (uint32_t n);
+  /**
+   * Free an array of aggregates and its cache.
+   *
+   * \param [in] aggregates The array.
+   */
+  static void FreeAggregates (struct Aggregates *aggregates);
 
   /**
    * Find an Object of TypeId tid in the aggregates of this Object.
@@ -388,6 +426,15 @@ private:
    * registered with the associated TypeId.
   */
   void Construct (const AttributeConstructionList &attributes);
+  /**
+   * Initialize all member variables registered as Attributes of this TypeId.
+   *
+   * \param [in] plan The attribute values, matched to the attributes
+   *        of this TypeId.
+   *
+   * Invoked from ns3::ObjectFactory::Create only.
+   */
+  void Construct (const AttributeConstructionPlan &plan);
 
   /**
    * Keep the list of aggregates in most-recently-used order
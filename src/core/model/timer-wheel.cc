@@ -0,0 +1,432 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "timer-wheel.h"
+#include "simulator.h"
+#include "log.h"
+#include "assert.h"
+
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TimerWheel");
+
+NS_OBJECT_ENSURE_REGISTERED (TimerWheel);
+
+const uint32_t TimerWheel::LEVELS;
+const uint32_t TimerWheel::SLOT_BITS;
+const uint32_t TimerWheel::SLOTS;
+const uint32_t TimerWheel::OVERFLOW_LIST;
+const uint32_t TimerWheel::NONE;
+
+namespace {
+
+/**
+ * \param x a non-zero bitmap
+ * \returns the index of the least significant bit set in x
+ */
+uint32_t
+LowestBit (uint64_t x)
+{
+  return __builtin_ctzll (x);
+}
+
+} // anonymous namespace
+
+TypeId
+TimerWheel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TimerWheel")
+    .SetParent<Object> ()
+    .SetGroupName ("Core")
+    .AddConstructor<TimerWheel> ()
+    .AddAttribute ("Granularity",
+                   "The duration of a tick: timers are run at the first "
+                   "tick boundary following their expiration time.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&TimerWheel::SetGranularity,
+                                     &TimerWheel::GetGranularity),
+                   MakeTimeChecker (TimeStep (1)))
+  ;
+  return tid;
+}
+
+TimerWheel::TimerWheel ()
+  : m_granularity (MilliSeconds (1)),
+    m_currentTick (0),
+    m_freeList (NONE),
+    m_nTimers (0),
+    m_eventTick (0)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i <= OVERFLOW_LIST; ++i)
+    {
+      m_heads[i] = NONE;
+      m_tails[i] = NONE;
+    }
+  for (uint32_t i = 0; i < LEVELS; ++i)
+    {
+      m_occupied[i] = 0;
+    }
+}
+
+TimerWheel::~TimerWheel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TimerWheel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_event.Cancel ();
+  m_nodes.clear ();
+  m_freeList = NONE;
+  m_nTimers = 0;
+  for (uint32_t i = 0; i <= OVERFLOW_LIST; ++i)
+    {
+      m_heads[i] = NONE;
+      m_tails[i] = NONE;
+    }
+  for (uint32_t i = 0; i < LEVELS; ++i)
+    {
+      m_occupied[i] = 0;
+    }
+  Object::DoDispose ();
+}
+
+void
+TimerWheel::SetGranularity (Time granularity)
+{
+  NS_LOG_FUNCTION (this << granularity);
+  NS_ASSERT_MSG (m_nTimers == 0, "Cannot change the granularity of a TimerWheel with pending timers");
+  NS_ASSERT (granularity.IsStrictlyPositive ());
+  m_granularity = granularity;
+  m_currentTick = Simulator::Now ().GetTimeStep () / m_granularity.GetTimeStep ();
+}
+
+Time
+TimerWheel::GetGranularity (void) const
+{
+  return m_granularity;
+}
+
+TimerWheel::TimerId
+TimerWheel::Schedule (Time delay, const Callback<void> &callback)
+{
+  NS_LOG_FUNCTION (this << delay);
+  NS_ASSERT (!delay.IsStrictlyNegative ());
+  Catchup ();
+
+  int64_t g = m_granularity.GetTimeStep ();
+  uint64_t expire = ((Simulator::Now () + delay).GetTimeStep () + g - 1) / g;
+  expire = std::max (expire, m_currentTick + 1);
+
+  uint32_t index;
+  if (m_freeList != NONE)
+    {
+      index = m_freeList;
+      m_freeList = m_nodes[index].m_next;
+    }
+  else
+    {
+      index = m_nodes.size ();
+      m_nodes.push_back (Node ());
+      m_nodes[index].m_generation = 0;
+    }
+  Node &node = m_nodes[index];
+  node.m_expire = expire;
+  node.m_callback = callback;
+  Insert (index);
+  ++m_nTimers;
+  ScheduleNext ();
+
+  return (static_cast<uint64_t> (node.m_generation) << 32) | (index + 1);
+}
+
+void
+TimerWheel::Cancel (TimerId id)
+{
+  NS_LOG_FUNCTION (this << id);
+  uint32_t index = Find (id);
+  if (index == NONE)
+    {
+      return;
+    }
+  // The pending simulator event, if any, is kept: the timer is likely
+  // to be restarted shortly, and an event that finds nothing to do is
+  // cheaper than rescheduling one.
+  Unlink (index);
+  Release (index);
+}
+
+bool
+TimerWheel::IsRunning (TimerId id) const
+{
+  return Find (id) != NONE;
+}
+
+Time
+TimerWheel::GetDelayLeft (TimerId id) const
+{
+  uint32_t index = Find (id);
+  if (index == NONE)
+    {
+      return Time (0);
+    }
+  Time expire = TimeStep (m_nodes[index].m_expire * m_granularity.GetTimeStep ());
+  return std::max (expire - Simulator::Now (), Time (0));
+}
+
+uint32_t
+TimerWheel::GetNTimers (void) const
+{
+  return m_nTimers;
+}
+
+uint32_t
+TimerWheel::Find (TimerId id) const
+{
+  uint64_t low = id & 0xffffffff;
+  if (low == 0 || low > m_nodes.size ())
+    {
+      return NONE;
+    }
+  uint32_t index = low - 1;
+  const Node &node = m_nodes[index];
+  if (node.m_list == NONE || node.m_generation != (id >> 32))
+    {
+      return NONE;
+    }
+  return index;
+}
+
+void
+TimerWheel::Insert (uint32_t index)
+{
+  Node &node = m_nodes[index];
+  NS_ASSERT (node.m_expire >= m_currentTick);
+  uint64_t delta = node.m_expire - m_currentTick;
+
+  uint32_t list = OVERFLOW_LIST;
+  for (uint32_t level = 0; level < LEVELS; ++level)
+    {
+      if (delta < (1ULL << (SLOT_BITS * (level + 1))))
+        {
+          uint32_t slot = (node.m_expire >> (SLOT_BITS * level)) & (SLOTS - 1);
+          list = level * SLOTS + slot;
+          m_occupied[level] |= 1ULL << slot;
+          break;
+        }
+    }
+
+  node.m_list = list;
+  node.m_next = NONE;
+  node.m_prev = m_tails[list];
+  if (m_tails[list] != NONE)
+    {
+      m_nodes[m_tails[list]].m_next = index;
+    }
+  else
+    {
+      m_heads[list] = index;
+    }
+  m_tails[list] = index;
+}
+
+void
+TimerWheel::Unlink (uint32_t index)
+{
+  Node &node = m_nodes[index];
+  uint32_t list = node.m_list;
+  if (node.m_prev != NONE)
+    {
+      m_nodes[node.m_prev].m_next = node.m_next;
+    }
+  else
+    {
+      m_heads[list] = node.m_next;
+    }
+  if (node.m_next != NONE)
+    {
+      m_nodes[node.m_next].m_prev = node.m_prev;
+    }
+  else
+    {
+      m_tails[list] = node.m_prev;
+    }
+  if (m_heads[list] == NONE && list != OVERFLOW_LIST)
+    {
+      m_occupied[list / SLOTS] &= ~(1ULL << (list % SLOTS));
+    }
+}
+
+void
+TimerWheel::Release (uint32_t index)
+{
+  Node &node = m_nodes[index];
+  node.m_callback = Callback<void> ();
+  node.m_list = NONE;
+  ++node.m_generation;
+  node.m_next = m_freeList;
+  m_freeList = index;
+  --m_nTimers;
+}
+
+uint64_t
+TimerWheel::NextTick (void) const
+{
+  uint64_t next = UINT64_MAX;
+  for (uint32_t level = 0; level < LEVELS; ++level)
+    {
+      uint64_t occupied = m_occupied[level];
+      if (occupied == 0)
+        {
+          continue;
+        }
+      // Slot s is due at the first tick after the current one whose
+      // level-index is s
+      uint32_t shift = SLOT_BITS * level;
+      uint64_t current = m_currentTick >> shift;
+      uint32_t position = current & (SLOTS - 1);
+      uint64_t base = current - position;
+      uint64_t later = position == SLOTS - 1 ? 0 : occupied & (~0ULL << (position + 1));
+      uint64_t due;
+      if (later != 0)
+        {
+          due = base + LowestBit (later);
+        }
+      else
+        {
+          due = base + SLOTS + LowestBit (occupied);
+        }
+      next = std::min (next, due << shift);
+    }
+  if (m_heads[OVERFLOW_LIST] != NONE)
+    {
+      uint32_t shift = SLOT_BITS * LEVELS;
+      next = std::min (next, ((m_currentTick >> shift) + 1) << shift);
+    }
+  return next;
+}
+
+void
+TimerWheel::ProcessTick (uint64_t tick)
+{
+  NS_LOG_FUNCTION (this << tick);
+  NS_ASSERT (tick > m_currentTick);
+  m_currentTick = tick;
+
+  // Move the timers of the slots starting at this tick to lower levels,
+  // highest level first so that a timer can be cascaded more than once.
+  std::vector<uint32_t> cascade;
+  if ((tick & ((1ULL << (SLOT_BITS * LEVELS)) - 1)) == 0)
+    {
+      cascade.push_back (OVERFLOW_LIST);
+    }
+  for (uint32_t level = LEVELS - 1; level > 0; --level)
+    {
+      uint32_t shift = SLOT_BITS * level;
+      if ((tick & ((1ULL << shift) - 1)) == 0)
+        {
+          cascade.push_back (level * SLOTS + ((tick >> shift) & (SLOTS - 1)));
+        }
+    }
+  for (std::vector<uint32_t>::const_iterator it = cascade.begin (); it != cascade.end (); ++it)
+    {
+      uint32_t list = *it;
+      uint32_t index = m_heads[list];
+      m_heads[list] = NONE;
+      m_tails[list] = NONE;
+      if (list != OVERFLOW_LIST)
+        {
+          m_occupied[list / SLOTS] &= ~(1ULL << (list % SLOTS));
+        }
+      while (index != NONE)
+        {
+          uint32_t next = m_nodes[index].m_next;
+          Insert (index);
+          index = next;
+        }
+    }
+
+  // Run the expired timers. A timer scheduled by a callback expires at a
+  // later tick, hence it cannot be added to this slot.
+  uint32_t list = tick & (SLOTS - 1);
+  while (m_heads[list] != NONE)
+    {
+      uint32_t index = m_heads[list];
+      NS_ASSERT (m_nodes[index].m_expire == tick);
+      Callback<void> callback = m_nodes[index].m_callback;
+      Unlink (index);
+      Release (index);
+      callback ();
+    }
+}
+
+void
+TimerWheel::Catchup (void)
+{
+  uint64_t now = Simulator::Now ().GetTimeStep () / m_granularity.GetTimeStep ();
+  if (now > m_currentTick && (m_nTimers == 0 || NextTick () > now))
+    {
+      m_currentTick = now;
+    }
+}
+
+void
+TimerWheel::ScheduleNext (void)
+{
+  if (m_nTimers == 0)
+    {
+      return;
+    }
+  uint64_t next = NextTick ();
+  if (m_event.IsRunning () && m_eventTick <= next)
+    {
+      return;
+    }
+  m_event.Cancel ();
+  m_eventTick = next;
+  Time at = TimeStep (next * m_granularity.GetTimeStep ());
+  Time now = Simulator::Now ();
+  m_event = Simulator::Schedule (at > now ? at - now : Time (0), &TimerWheel::Expire, this);
+}
+
+void
+TimerWheel::Expire (void)
+{
+  NS_LOG_FUNCTION (this);
+  // Process every tick due by now; a tick may be late when a timer was
+  // scheduled at the time of the pending event but before it ran.
+  uint64_t now = Simulator::Now ().GetTimeStep () / m_granularity.GetTimeStep ();
+  uint64_t next = NextTick ();
+  while (m_nTimers > 0 && next <= now)
+    {
+      ProcessTick (next);
+      next = NextTick ();
+    }
+  ScheduleNext ();
+}
+
+} // namespace ns3
@@ -0,0 +1,209 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "object.h"
+#include "nstime.h"
+#include "event-id.h"
+#include "callback.h"
+#include <vector>
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup timer
+ * \brief A hierarchical timer wheel multiplexing many coarse timers on
+ * a single simulator event.
+ *
+ * Protocols that keep one timer per peer (neighbor caches, for instance)
+ * restart and cancel their timers far more often than they let them
+ * expire. With one simulator event per timer, each restart costs an
+ * insertion in the scheduler, and thousands of peers mean thousands of
+ * pending events.
+ *
+ * The wheel keeps its timers in four levels of 64 slots each, as in
+ * the Linux kernel: level 0 holds the timers expiring in the current
+ * block of 64 ticks, level 1 those expiring in the current block of
+ * 64*64 ticks, and so on; timers beyond the range of the last level
+ * wait in an overflow list. Scheduling and cancelling a timer are O(1)
+ * and never touch the simulator. The wheel itself has at most one
+ * pending simulator event, at the next tick at which a timer expires or
+ * a slot must be cascaded to a lower level, and all the timers expiring
+ * in the same tick are run by the same event.
+ *
+ * Time is quantized in ticks of the Granularity attribute: a timer runs
+ * at the first tick boundary at or after its nominal expiration time,
+ * i.e., up to one tick late. The order in which the timers expiring in
+ * the same tick are run is unspecified.
+ *
+ * Timers are identified by an opaque TimerId, which remains safe to use
+ * (e.g., to cancel) after the timer has expired or has been cancelled.
+ */
+class TimerWheel : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /** Timer identifier; the null identifier never refers to a timer. */
+  typedef uint64_t TimerId;
+
+  TimerWheel ();
+  virtual ~TimerWheel ();
+
+  /**
+   * \brief Set the tick duration
+   * \param granularity the tick duration
+   *
+   * Can be changed only while no timer is pending.
+   */
+  void SetGranularity (Time granularity);
+  /**
+   * \brief Get the tick duration
+   * \returns the tick duration
+   */
+  Time GetGranularity (void) const;
+
+  /**
+   * \brief Schedule a timer
+   * \param delay the delay after which the callback is invoked
+   * \param callback the callback to invoke
+   * \returns the identifier of the timer
+   */
+  TimerId Schedule (Time delay, const Callback<void> &callback);
+
+  /**
+   * \brief Cancel a timer
+   * \param id the identifier of the timer
+   *
+   * Does nothing if the timer has already expired or been cancelled.
+   */
+  void Cancel (TimerId id);
+
+  /**
+   * \param id the identifier of a timer
+   * \returns true if the timer is pending
+   */
+  bool IsRunning (TimerId id) const;
+
+  /**
+   * \param id the identifier of a timer
+   * \returns the time left before the timer expires, or zero if the
+   * timer is not pending
+   */
+  Time GetDelayLeft (TimerId id) const;
+
+  /**
+   * \returns the number of pending timers
+   */
+  uint32_t GetNTimers (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// Number of levels of the wheel
+  static const uint32_t LEVELS = 4;
+  /// log2 of the number of slots of each level
+  static const uint32_t SLOT_BITS = 6;
+  /// Number of slots of each level
+  static const uint32_t SLOTS = 1 << SLOT_BITS;
+  /// Index of the overflow list in m_heads
+  static const uint32_t OVERFLOW_LIST = LEVELS * SLOTS;
+  /// Null node index
+  static const uint32_t NONE = 0xffffffff;
+
+  /// A timer, chained in the list of its slot
+  struct Node
+  {
+    uint64_t m_expire;           //!< Expiration tick
+    Callback<void> m_callback;   //!< Function to run at expiration
+    uint32_t m_generation;       //!< Incremented each time the node is released
+    uint32_t m_list;             //!< Slot holding the node, NONE if free
+    uint32_t m_prev;             //!< Previous node in the list
+    uint32_t m_next;             //!< Next node in the list (or in the free list)
+  };
+
+  /**
+   * \brief Put a node in the slot matching its expiration tick
+   * \param index the node index
+   */
+  void Insert (uint32_t index);
+  /**
+   * \brief Unchain a node from its slot
+   * \param index the node index
+   */
+  void Unlink (uint32_t index);
+  /**
+   * \brief Release a node
+   * \param index the node index
+   */
+  void Release (uint32_t index);
+  /**
+   * \param id a timer identifier
+   * \returns the index of the node of the timer, NONE if not pending
+   */
+  uint32_t Find (TimerId id) const;
+  /**
+   * \returns the next tick at which a timer expires or a slot must be
+   * cascaded, or UINT64_MAX if no timer is pending
+   */
+  uint64_t NextTick (void) const;
+  /**
+   * \brief Cascade the slots due at a tick and run the expired timers
+   * \param tick the tick
+   */
+  void ProcessTick (uint64_t tick);
+  /**
+   * \brief Move the current tick to the current time, if possible
+   * without processing any slot
+   */
+  void Catchup (void);
+  /**
+   * \brief (Re)schedule the simulator event at the next tick, if needed
+   */
+  void ScheduleNext (void);
+  /**
+   * \brief Simulator event handler
+   */
+  void Expire (void);
+
+  Time m_granularity;              //!< Tick duration
+  uint64_t m_currentTick;          //!< Last tick processed
+  std::vector<Node> m_nodes;       //!< Timer storage
+  uint32_t m_freeList;             //!< First free node
+  uint32_t m_nTimers;              //!< Number of pending timers
+  uint32_t m_heads[OVERFLOW_LIST + 1]; //!< First node of each slot
+  uint32_t m_tails[OVERFLOW_LIST + 1]; //!< Last node of each slot
+  uint64_t m_occupied[LEVELS];     //!< Bitmap of the non-empty slots of each level
+  EventId m_event;                 //!< Pending simulator event
+  uint64_t m_eventTick;            //!< Tick of the pending simulator event
+};
+
+} // namespace ns3
+
+#endif /* TIMER_WHEEL_H */
@@ -21,7 +21,7 @@
 #ifndef TRACED_CALLBACK_H
 #define TRACED_CALLBACK_H
 
-#include <list>
+#include <vector>
 #include "callback.h"
 
 /**
@@ -46,6 +46,13 @@ namespace ns3 {
  * calling one of the \c operator() forms with the appropriate
  * number of arguments.
  *
+ * Most trace sources have no Callback connected, or only one, and fire
+ * on every packet. Hence the first Callback of the chain is stored in
+ * the TracedCallback itself, and the following ones in a vector which is
+ * only allocated when a second Callback is connected. Firing a trace
+ * source without any Callback connected only tests whether the first
+ * Callback is null.
+ *
  * \tparam T1 \explicit Type of the first argument to the functor.
  * \tparam T2 \explicit Type of the second argument to the functor.
  * \tparam T3 \explicit Type of the third argument to the functor.
@@ -64,6 +71,21 @@ class TracedCallback
 public:
   /** Constructor. */
   TracedCallback ();
+  /**
+   * Copy constructor.
+   *
+   * \param [in] o The TracedCallback to copy.
+   */
+  TracedCallback (const TracedCallback &o);
+  /**
+   * Assignment operator.
+   *
+   * \param [in] o The TracedCallback to copy.
+   * \returns This TracedCallback.
+   */
+  TracedCallback &operator = (const TracedCallback &o);
+  /** Destructor. */
+  ~TracedCallback ();
   /**
    * Append a Callback to the chain (without a context).
    *
@@ -93,6 +115,13 @@ public:
    * \param [in] path Context path which was used to connect the Callback.
    */
   void Disconnect (const CallbackBase & callback, std::string path);
+  /**
+   * \returns true if no Callback is connected.
+   */
+  bool IsEmpty (void) const
+  {
+    return m_first.IsNull ();
+  }
   /**
    * \name Functors taking various numbers of arguments.
    *
@@ -223,7 +252,7 @@ public:
   
 private:
   /**
-   * Container type for holding the chain of Callbacks.
+   * The type of the Callbacks of the chain.
    *
    * \tparam T1 \deduced Type of the first argument to the functor.
    * \tparam T2 \deduced Type of the second argument to the functor.
@@ -234,9 +263,25 @@ private:
    * \tparam T7 \deduced Type of the seventh argument to the functor.
    * \tparam T8 \deduced Type of the eighth argument to the functor.
    */
-  typedef std::list<Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> > CallbackList;
-  /** The chain of Callbacks. */
-  CallbackList m_callbackList;
+  typedef Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> CallbackType;
+  /** Container type for holding the Callbacks following the first one. */
+  typedef std::vector<CallbackType> CallbackList;
+  /**
+   * Append a Callback to the chain.
+   *
+   * \param [in] cb The Callback.
+   */
+  void Append (const CallbackType &cb);
+  /**
+   * The first Callback of the chain, or a null Callback if the chain
+   * is empty.
+   */
+  CallbackType m_first;
+  /**
+   * The Callbacks following the first one, or 0 if a second Callback was
+   * never connected.
+   */
+  CallbackList *m_others;
 };
 
 } // namespace ns3
@@ -253,9 +298,61 @@ template<typename T1, typename T2,
          typename T5, typename T6,
          typename T7, typename T8>
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::TracedCallback ()
-  : m_callbackList () 
+  : m_first (),
+    m_others (0)
 {
 }
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::TracedCallback (const TracedCallback &o)
+  : m_first (o.m_first),
+    m_others (o.m_others == 0 ? 0 : new CallbackList (*o.m_others))
+{
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8> &
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator = (const TracedCallback &o)
+{
+  if (this != &o)
+    {
+      m_first = o.m_first;
+      delete m_others;
+      m_others = o.m_others == 0 ? 0 : new CallbackList (*o.m_others);
+    }
+  return *this;
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::~TracedCallback ()
+{
+  delete m_others;
+  m_others = 0;
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Append (const CallbackType &cb)
+{
+  if (m_first.IsNull ())
+    {
+      m_first = cb;
+      return;
+    }
+  if (m_others == 0)
+    {
+      m_others = new CallbackList ();
+    }
+  m_others->push_back (cb);
+}
 template<typename T1, typename T2,
          typename T3, typename T4,
          typename T5, typename T6,
@@ -263,10 +360,10 @@ template<typename T1, typename T2,
 void
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::ConnectWithoutContext (const CallbackBase & callback)
 {
-  Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> cb;
+  CallbackType cb;
   if (!cb.Assign (callback))
     NS_FATAL_ERROR_NO_MSG();
-  m_callbackList.push_back (cb);
+  Append (cb);
 }
 template<typename T1, typename T2,
          typename T3, typename T4,
@@ -278,8 +375,8 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Connect (const CallbackBase & callback,
   Callback<void,std::string,T1,T2,T3,T4,T5,T6,T7,T8> cb;
   if (!cb.Assign (callback))
     NS_FATAL_ERROR ("when connecting to " << path);
-  Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = cb.Bind (path);
-  m_callbackList.push_back (realCb);
+  CallbackType realCb = cb.Bind (path);
+  Append (realCb);
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -288,17 +385,28 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::DisconnectWithoutContext (const CallbackBase & callback)
 {
-  for (typename CallbackList::iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); /* empty */)
+  // Rebuild the chain from the Callbacks which are kept, in order
+  CallbackList kept;
+  if (!m_first.IsNull () && !m_first.IsEqual (callback))
     {
-      if ((*i).IsEqual (callback))
-        {
-          i = m_callbackList.erase (i);
-        }
-      else
+      kept.push_back (m_first);
+    }
+  if (m_others != 0)
+    {
+      for (typename CallbackList::const_iterator i = m_others->begin ();
+           i != m_others->end (); i++)
         {
-          i++;
+          if (!(*i).IsEqual (callback))
+            {
+              kept.push_back (*i);
+            }
         }
+      m_others->clear ();
+    }
+  m_first = CallbackType ();
+  for (typename CallbackList::const_iterator i = kept.begin (); i != kept.end (); i++)
+    {
+      Append (*i);
     }
 }
 template<typename T1, typename T2, 
@@ -311,7 +419,7 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Disconnect (const CallbackBase & callba
   Callback<void,std::string,T1,T2,T3,T4,T5,T6,T7,T8> cb;
   if (!cb.Assign (callback))
     NS_FATAL_ERROR ("when disconnecting from " << path);
-  Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = cb.Bind (path);
+  CallbackType realCb = cb.Bind (path);
   DisconnectWithoutContext (realCb);
 }
 template<typename T1, typename T2, 
@@ -321,10 +429,18 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (void) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_first.IsNull ())
     {
-      (*i)();
+      return;
+    }
+  m_first ();
+  if (m_others != 0)
+    {
+      // A Callback may connect another one: the vector may grow
+      for (typename CallbackList::size_type i = 0; i < m_others->size (); ++i)
+        {
+          (*m_others)[i] ();
+        }
     }
 }
 template<typename T1, typename T2, 
@@ -334,10 +450,18 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_first.IsNull ())
+    {
+      return;
+    }
+  m_first (a1);
+  if (m_others != 0)
     {
-      (*i)(a1);
+      // A Callback may connect another one: the vector may grow
+      for (typename CallbackList::size_type i = 0; i < m_others->size (); ++i)
+        {
+          (*m_others)[i] (a1);
+        }
     }
 }
 template<typename T1, typename T2, 
@@ -347,10 +471,18 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_first.IsNull ())
     {
-      (*i)(a1, a2);
+      return;
+    }
+  m_first (a1, a2);
+  if (m_others != 0)
+    {
+      // A Callback may connect another one: the vector may grow
+      for (typename CallbackList::size_type i = 0; i < m_others->size (); ++i)
+        {
+          (*m_others)[i] (a1, a2);
+        }
     }
 }
 template<typename T1, typename T2, 
@@ -360,10 +492,18 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_first.IsNull ())
+    {
+      return;
+    }
+  m_first (a1, a2, a3);
+  if (m_others != 0)
     {
-      (*i)(a1, a2, a3);
+      // A Callback may connect another one: the vector may grow
+      for (typename CallbackList::size_type i = 0; i < m_others->size (); ++i)
+        {
+          (*m_others)[i] (a1, a2, a3);
+        }
     }
 }
 template<typename T1, typename T2, 
@@ -373,10 +513,18 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_first.IsNull ())
+    {
+      return;
+    }
+  m_first (a1, a2, a3, a4);
+  if (m_others != 0)
     {
-      (*i)(a1, a2, a3, a4);
+      // A Callback may connect another one: the vector may grow
+      for (typename CallbackList::size_type i = 0; i < m_others->size (); ++i)
+        {
+          (*m_others)[i] (a1, a2, a3, a4);
+        }
     }
 }
 template<typename T1, typename T2, 
@@ -386,10 +534,18 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_first.IsNull ())
     {
-      (*i)(a1, a2, a3, a4, a5);
+      return;
+    }
+  m_first (a1, a2, a3, a4, a5);
+  if (m_others != 0)
+    {
+      // A Callback may connect another one: the vector may grow
+      for (typename CallbackList::size_type i = 0; i < m_others->size (); ++i)
+        {
+          (*m_others)[i] (a1, a2, a3, a4, a5);
+        }
     }
 }
 template<typename T1, typename T2, 
@@ -399,10 +555,18 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_first.IsNull ())
+    {
+      return;
+    }
+  m_first (a1, a2, a3, a4, a5, a6);
+  if (m_others != 0)
     {
-      (*i)(a1, a2, a3, a4, a5, a6);
+      // A Callback may connect another one: the vector may grow
+      for (typename CallbackList::size_type i = 0; i < m_others->size (); ++i)
+        {
+          (*m_others)[i] (a1, a2, a3, a4, a5, a6);
+        }
     }
 }
 template<typename T1, typename T2, 
@@ -412,10 +576,18 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_first.IsNull ())
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7);
+      return;
+    }
+  m_first (a1, a2, a3, a4, a5, a6, a7);
+  if (m_others != 0)
+    {
+      // A Callback may connect another one: the vector may grow
+      for (typename CallbackList::size_type i = 0; i < m_others->size (); ++i)
+        {
+          (*m_others)[i] (a1, a2, a3, a4, a5, a6, a7);
+        }
     }
 }
 template<typename T1, typename T2, 
@@ -425,10 +597,18 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7, T8 a8) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_first.IsNull ())
+    {
+      return;
+    }
+  m_first (a1, a2, a3, a4, a5, a6, a7, a8);
+  if (m_others != 0)
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7, a8);
+      // A Callback may connect another one: the vector may grow
+      for (typename CallbackList::size_type i = 0; i < m_others->size (); ++i)
+        {
+          (*m_others)[i] (a1, a2, a3, a4, a5, a6, a7, a8);
+        }
     }
 }
 
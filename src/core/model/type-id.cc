@@ -27,6 +27,7 @@
 #include <vector>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
 
 /**
  * \file
@@ -74,10 +75,28 @@ NS_LOG_COMPONENT_DEFINE ("TypeId");
  * the high order bit of the hash value, and assert on higher level
  * collisions.  The three-fold collision probability should be an
  * acceptablly small error rate.
+ *
+ * <b>Attribute and TraceSource lookup</b>
+ *
+ * The attributes and trace sources of a type id and of its parents
+ * are flattened in a chain, indexed by the hash of their names, the
+ * first time they are looked up.  Any change to a type id (new parent,
+ * attribute or trace source, new initial value) increments a
+ * generation counter, and the chains of an older generation are
+ * rebuilt when next used.
+ *
+ * The lookups thus write to the IidManager: neither the chains nor the
+ * generation counter are protected by a lock, and the chains are handed
+ * out as Ptr, whose reference counts are not atomic.  A lookup must not
+ * run on one thread while another thread looks up any attribute or
+ * trace source, or changes a type id.  ObjectBase::ConstructSelf and
+ * ObjectFactory::Create use the chains too, so that Objects must not be
+ * created concurrently either.
  */
 class IidManager : public Singleton<IidManager>
 {
 public:
+  IidManager ();
   /**
    * Create a new unique type id.
    * \param [in] name The name of this type id.
@@ -270,6 +289,30 @@ public:
    * \returns \c true if this TypeId should be hidden from the user.
    */
   bool MustHideFromDocumentation (uint16_t uid) const;
+  /**
+   * Get the attributes of a type id and of its parents.
+   * \param [in] uid The id.
+   * \returns The attributes of \p uid and of its parents.
+   */
+  Ptr<const TypeId::AttributeChain> GetAttributeChain (uint16_t uid);
+  /**
+   * Find an attribute of a type id or of its parents.
+   * \param [in] uid The id.
+   * \param [in] name The Attribute name.
+   * \returns The first attribute named \p name, from \p uid up to its
+   *          root parent, or 0.  The pointer is valid until the next
+   *          change to a type id.
+   */
+  const struct TypeId::AttributeInformation *FindAttribute (uint16_t uid, const std::string &name);
+  /**
+   * Find a trace source of a type id or of its parents.
+   * \param [in] uid The id.
+   * \param [in] name The TraceSource name.
+   * \returns The first trace source named \p name, from \p uid up to
+   *          its root parent, or 0.  The pointer is valid until the next
+   *          change to a type id.
+   */
+  const struct TypeId::TraceSourceInformation *FindTraceSource (uint16_t uid, const std::string &name);
 
 private:
   /**
@@ -319,6 +362,16 @@ private:
     TypeId::SupportLevel supportLevel;
     /** Support message. */
     std::string supportMsg;
+    /** The generation of the chains below, 0 if they were never built. */
+    uint32_t chainGeneration;
+    /** The attributes of this type id and of its parents. */
+    Ptr<TypeId::AttributeChain> attributeChain;
+    /** The hash of each name in attributeChain and its index, sorted. */
+    std::vector<std::pair<uint32_t, uint32_t> > attributeIndex;
+    /** The trace sources of this type id and of its parents. */
+    std::vector<struct TypeId::TraceSourceInformation> traceSourceChain;
+    /** The hash of each name in traceSourceChain and its index, sorted. */
+    std::vector<std::pair<uint32_t, uint32_t> > traceSourceIndex;
   };
   /** Iterator type. */
   typedef std::vector<struct IidInformation>::const_iterator Iterator;
@@ -329,6 +382,27 @@ private:
    * \returns The information record.
    */
   struct IidManager::IidInformation *LookupInformation (uint16_t uid) const;
+  /**
+   * Build the attribute and trace source chains of a type id, unless
+   * they are up to date.
+   * \param [in] information The information record of the type id.
+   */
+  void UpdateChains (struct IidInformation *information);
+  /**
+   * Find a name in a chain index.
+   * \param [in] index The sorted hashes and indexes of a chain.
+   * \param [in] name The name to look for.
+   * \param [in] names The names of the chain, in chain order.
+   * \returns The index of the first item named \p name in the chain,
+   *          or -1.
+   */
+  template <typename T>
+  static int32_t FindInChain (const std::vector<std::pair<uint32_t, uint32_t> > &index,
+                              const std::string &name,
+                              const std::vector<T> &names);
+
+  /** The generation of the type id records. */
+  uint32_t m_generation;
 
   /** The container of all type id records. */
   std::vector<struct IidInformation> m_information;
@@ -368,6 +442,11 @@ IidManager::Hasher (const std::string name)
 #define IID "IidManager"
 #define IIDL IID << ": "
 
+IidManager::IidManager ()
+  : m_generation (1)
+{
+}
+
 uint16_t
 IidManager::AllocateUid (std::string name)
 {
@@ -429,6 +508,7 @@ IidManager::AllocateUid (std::string name)
   information.size = (std::size_t)(-1);
   information.hasConstructor = false;
   information.mustHideFromDocumentation = false;
+  information.chainGeneration = 0;
   m_information.push_back (information);
   uint32_t uid = m_information.size ();
   NS_ASSERT (uid <= 0xffff);
@@ -456,6 +536,7 @@ IidManager::SetParent (uint16_t uid, uint16_t parent)
   NS_ASSERT (parent <= m_information.size ());
   struct IidInformation *information = LookupInformation (uid);
   information->parent = parent;
+  m_generation++;
 }
 void 
 IidManager::SetGroupName (uint16_t uid, std::string groupName)
@@ -665,6 +746,7 @@ IidManager::AddAttribute (uint16_t uid,
   info.supportLevel = supportLevel;
   info.supportMsg = supportMsg;
   information->attributes.push_back (info);
+  m_generation++;
   NS_LOG_LOGIC (IIDL << information->attributes.size () - 1);
 }
 void 
@@ -676,6 +758,7 @@ IidManager::SetAttributeInitialValue(uint16_t uid,
   struct IidInformation *information = LookupInformation (uid);
   NS_ASSERT (i < information->attributes.size ());
   information->attributes[i].initialValue = initialValue;
+  m_generation++;
 }
 
 
@@ -756,6 +839,7 @@ IidManager::AddTraceSource (uint16_t uid,
   source.supportLevel = supportLevel;
   source.supportMsg = supportMsg;
   information->traceSources.push_back (source);
+  m_generation++;
   NS_LOG_LOGIC (IIDL << information->traceSources.size () - 1);
 }
 uint32_t 
@@ -786,6 +870,123 @@ IidManager::MustHideFromDocumentation (uint16_t uid) const
   return hide;
 }
 
+/**
+ * Get the name of an attribute of a chain.
+ * \param [in] attribute The attribute.
+ * \returns The name of the attribute.
+ */
+static const std::string &
+GetChainName (const struct TypeId::InheritedAttribute &attribute)
+{
+  return attribute.info.name;
+}
+/**
+ * Get the name of a trace source of a chain.
+ * \param [in] source The trace source.
+ * \returns The name of the trace source.
+ */
+static const std::string &
+GetChainName (const struct TypeId::TraceSourceInformation &source)
+{
+  return source.name;
+}
+
+void
+IidManager::UpdateChains (struct IidInformation *information)
+{
+  if (information->chainGeneration == m_generation)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (IID << information->name << m_generation);
+  Ptr<TypeId::AttributeChain> attributes = Create<TypeId::AttributeChain> ();
+  information->attributeIndex.clear ();
+  information->traceSourceChain.clear ();
+  information->traceSourceIndex.clear ();
+  struct IidInformation *tid = information;
+  while (true)
+    {
+      for (std::vector<struct TypeId::AttributeInformation>::const_iterator i = tid->attributes.begin ();
+           i != tid->attributes.end (); ++i)
+        {
+          struct TypeId::InheritedAttribute attribute;
+          attribute.info = *i;
+          attribute.tidName = tid->name;
+          attribute.initialValueChecked = i->checker->Check (*i->initialValue);
+          information->attributeIndex.push_back (std::make_pair (Hash32 (i->name.c_str (), i->name.size ()),
+                                                                 attributes->attributes.size ()));
+          attributes->attributes.push_back (attribute);
+        }
+      for (std::vector<struct TypeId::TraceSourceInformation>::const_iterator i = tid->traceSources.begin ();
+           i != tid->traceSources.end (); ++i)
+        {
+          information->traceSourceIndex.push_back (std::make_pair (Hash32 (i->name.c_str (), i->name.size ()),
+                                                                   information->traceSourceChain.size ()));
+          information->traceSourceChain.push_back (*i);
+        }
+      if (tid->parent == 0 || LookupInformation (tid->parent) == tid)
+        {
+          // top of inheritance tree
+          break;
+        }
+      tid = LookupInformation (tid->parent);
+    }
+  // Equal hashes stay in chain order, so that a child hides its parents
+  std::sort (information->attributeIndex.begin (), information->attributeIndex.end ());
+  std::sort (information->traceSourceIndex.begin (), information->traceSourceIndex.end ());
+  information->attributeChain = attributes;
+  information->chainGeneration = m_generation;
+}
+
+template <typename T>
+int32_t
+IidManager::FindInChain (const std::vector<std::pair<uint32_t, uint32_t> > &index,
+                         const std::string &name,
+                         const std::vector<T> &names)
+{
+  uint32_t hash = Hash32 (name.c_str (), name.size ());
+  std::vector<std::pair<uint32_t, uint32_t> >::const_iterator i =
+    std::lower_bound (index.begin (), index.end (), std::make_pair (hash, 0U));
+  for (; i != index.end () && i->first == hash; ++i)
+    {
+      if (GetChainName (names[i->second]) == name)
+        {
+          return i->second;
+        }
+    }
+  return -1;
+}
+
+Ptr<const TypeId::AttributeChain>
+IidManager::GetAttributeChain (uint16_t uid)
+{
+  NS_LOG_FUNCTION (IID << uid);
+  struct IidInformation *information = LookupInformation (uid);
+  UpdateChains (information);
+  return information->attributeChain;
+}
+
+const struct TypeId::AttributeInformation *
+IidManager::FindAttribute (uint16_t uid, const std::string &name)
+{
+  NS_LOG_FUNCTION (IID << uid << name);
+  struct IidInformation *information = LookupInformation (uid);
+  UpdateChains (information);
+  const std::vector<struct TypeId::InheritedAttribute> &chain = information->attributeChain->attributes;
+  int32_t i = FindInChain (information->attributeIndex, name, chain);
+  return i < 0 ? 0 : &chain[i].info;
+}
+
+const struct TypeId::TraceSourceInformation *
+IidManager::FindTraceSource (uint16_t uid, const std::string &name)
+{
+  NS_LOG_FUNCTION (IID << uid << name);
+  struct IidInformation *information = LookupInformation (uid);
+  UpdateChains (information);
+  int32_t i = FindInChain (information->traceSourceIndex, name, information->traceSourceChain);
+  return i < 0 ? 0 : &information->traceSourceChain[i];
+}
+
 } // namespace ns3
 
 namespace ns3 {
@@ -866,38 +1067,31 @@ bool
 TypeId::LookupAttributeByName (std::string name, struct TypeId::AttributeInformation *info) const
 {
   NS_LOG_FUNCTION (this << name << info);
-  TypeId tid;
-  TypeId nextTid = *this;
-  do {
-      tid = nextTid;
-      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
-        {
-          struct TypeId::AttributeInformation tmp = tid.GetAttribute(i);
-          if (tmp.name == name)
-            {
-              if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                  *info = tmp;
-                  return true;
-                }
-              else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                  std::cerr << "Attribute '" << name << "' is deprecated: "
-                                 << tmp.supportMsg << std::endl;
-                  *info = tmp;
-                  return true;
-                }
-              else if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                  NS_FATAL_ERROR ("Attribute '" << name
-                                  << "' is obsolete, with no fallback: "
-                                  << tmp.supportMsg);
-                }
-            }
-        }
-      nextTid = tid.GetParent ();
-    } while (nextTid != tid);
-  return false;
+  const struct TypeId::AttributeInformation *tmp = IidManager::Get ()->FindAttribute (m_tid, name);
+  if (tmp == 0)
+    {
+      return false;
+    }
+  if (tmp->supportLevel == TypeId::DEPRECATED)
+    {
+      std::cerr << "Attribute '" << name << "' is deprecated: "
+                << tmp->supportMsg << std::endl;
+    }
+  else if (tmp->supportLevel == TypeId::OBSOLETE)
+    {
+      NS_FATAL_ERROR ("Attribute '" << name
+                      << "' is obsolete, with no fallback: "
+                      << tmp->supportMsg);
+    }
+  *info = *tmp;
+  return true;
+}
+
+Ptr<const TypeId::AttributeChain>
+TypeId::GetAttributeChain (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return IidManager::Get ()->GetAttributeChain (m_tid);
 }
 
 TypeId 
@@ -1126,39 +1320,24 @@ TypeId::LookupTraceSourceByName (std::string name,
                                  struct TraceSourceInformation *info) const
 {
   NS_LOG_FUNCTION (this << name);
-  TypeId tid;
-  TypeId nextTid = *this;
-  struct TypeId::TraceSourceInformation tmp;
-  do {
-      tid = nextTid;
-      for (uint32_t i = 0; i < tid.GetTraceSourceN (); i++)
-        {
-          tmp = tid.GetTraceSource (i);
-          if (tmp.name == name)
-            {
-              if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                  *info = tmp;
-                   return tmp.accessor;
-                }
-              else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                  std::cerr << "TraceSource '" << name << "' is deprecated: "
-                                 << tmp.supportMsg << std::endl;
-                  *info = tmp;
-                  return tmp.accessor;
-                }
-              else  if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                  NS_FATAL_ERROR ("TraceSource '" << name
-                                  << "' is obsolete, with no fallback: "
-                                  << tmp.supportMsg);
-                }
-            }
-        }
-      nextTid = tid.GetParent ();
-    } while (nextTid != tid);
-  return 0;
+  const struct TypeId::TraceSourceInformation *tmp = IidManager::Get ()->FindTraceSource (m_tid, name);
+  if (tmp == 0)
+    {
+      return 0;
+    }
+  if (tmp->supportLevel == TypeId::DEPRECATED)
+    {
+      std::cerr << "TraceSource '" << name << "' is deprecated: "
+                << tmp->supportMsg << std::endl;
+    }
+  else if (tmp->supportLevel == TypeId::OBSOLETE)
+    {
+      NS_FATAL_ERROR ("TraceSource '" << name
+                      << "' is obsolete, with no fallback: "
+                      << tmp->supportMsg);
+    }
+  *info = *tmp;
+  return tmp->accessor;
 }
 
 Ptr<const TraceSourceAccessor> 
@@ -27,7 +27,9 @@
 #include "callback.h"
 #include "deprecated.h"
 #include "hash.h"
+#include "simple-ref-count.h"
 #include <string>
+#include <vector>
 #include <stdint.h>
 
 /**
@@ -108,6 +110,24 @@ public:
     /** Support message. */
     std::string supportMsg;
   };
+  /** An attribute of a TypeId or of one of its parents. */
+  struct InheritedAttribute {
+    /** The attribute. */
+    struct AttributeInformation info;
+    /** The name of the TypeId which registered the attribute. */
+    std::string tidName;
+    /** \c true if the checker accepts the initial value as is. */
+    bool initialValueChecked;
+  };
+  /**
+   * The attributes of a TypeId and of its parents: those of the TypeId
+   * first, then those of its parent, and so on, which is the order in
+   * which ObjectBase::ConstructSelf sets them.
+   */
+  struct AttributeChain : public SimpleRefCount<AttributeChain> {
+    /** The attributes. */
+    std::vector<struct InheritedAttribute> attributes;
+  };
 
   /** Type of hash values. */
   typedef uint32_t hash_t;
@@ -478,6 +498,11 @@ public:
   /**
    * Find an Attribute by name, retrieving the associated AttributeInformation.
    *
+   * \warning The lookups of attributes and trace sources may rebuild
+   * the chain of this TypeId (see GetAttributeChain), without any lock:
+   * they must not be made concurrently with any other lookup, nor with
+   * a change to any TypeId, as Config::SetDefault makes.
+   *
    * \param [in]  name The name of the requested attribute
    * \param [in,out] info A pointer to the TypeId::AttributeInformation
    *              data structure where the result value of this method
@@ -485,10 +510,23 @@ public:
    * \returns \c true if the requested attribute could be found.
    */
   bool LookupAttributeByName (std::string name, struct AttributeInformation *info) const;
+  /**
+   * Get the attributes of this TypeId and of its parents.
+   *
+   * The chain is built on first use, and rebuilt once a TypeId gets a
+   * new parent or attribute, or an initial value changes. It is indexed
+   * by the hash of the attribute names, for LookupAttributeByName.
+   * As the lookups, this is not safe to call from several threads.
+   *
+   * \returns The attributes of this TypeId and of its parents.
+   */
+  Ptr<const AttributeChain> GetAttributeChain (void) const;
   /**
    * Find a TraceSource by name.
    *
    * If no matching trace source is found, this method returns zero.
+   * As LookupAttributeByName, this is not safe to call from several
+   * threads.
    *
    * \param [in] name The name of the requested trace source
    * \return The trace source accessor which can be used to connect
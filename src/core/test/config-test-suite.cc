@@ -27,6 +27,7 @@
 #include "ns3/singleton.h"
 #include "ns3/object.h"
 #include "ns3/object-vector.h"
+#include "ns3/object-map.h"
 #include "ns3/names.h"
 #include "ns3/pointer.h"
 #include "ns3/log.h"
@@ -46,6 +47,7 @@ public:
 
   void AddNodeA (Ptr<ConfigTestObject> a);
   void AddNodeB (Ptr<ConfigTestObject> b);
+  void AddNodeC (uint32_t index, Ptr<ConfigTestObject> c);
 
   void SetNodeA (Ptr<ConfigTestObject> a);
   void SetNodeB (Ptr<ConfigTestObject> b);
@@ -56,6 +58,7 @@ public:
 private:
   std::vector<Ptr<ConfigTestObject> > m_nodesA;
   std::vector<Ptr<ConfigTestObject> > m_nodesB;
+  std::map<uint32_t, Ptr<ConfigTestObject> > m_nodesC;
   Ptr<ConfigTestObject> m_nodeA;
   Ptr<ConfigTestObject> m_nodeB;
   int8_t m_a;
@@ -76,6 +79,10 @@ ConfigTestObject::GetTypeId (void)
                    ObjectVectorValue (),
                    MakeObjectVectorAccessor (&ConfigTestObject::m_nodesB),
                    MakeObjectVectorChecker<ConfigTestObject> ())
+    .AddAttribute ("NodesC", "",
+                   ObjectMapValue (),
+                   MakeObjectMapAccessor (&ConfigTestObject::m_nodesC),
+                   MakeObjectMapChecker<ConfigTestObject> ())
     .AddAttribute ("NodeA", "",
                    PointerValue (),
                    MakePointerAccessor (&ConfigTestObject::m_nodeA),
@@ -127,6 +134,12 @@ ConfigTestObject::AddNodeB (Ptr<ConfigTestObject> b)
   m_nodesB.push_back (b);
 }
 
+void 
+ConfigTestObject::AddNodeC (uint32_t index, Ptr<ConfigTestObject> c)
+{
+  m_nodesC[index] = c;
+}
+
 int8_t 
 ConfigTestObject::GetA (void) const
 {
@@ -669,6 +682,137 @@ ObjectVectorTraceConfigTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_path, "/NodeA/NodeB/NodesB/1/Source", "Trace 1 did not provide expected context");
 }
 
+// ===========================================================================
+// Test for the ability to parse a path once and match it many times.
+// ===========================================================================
+class PathConfigTestCase : public TestCase
+{
+public:
+  PathConfigTestCase ();
+  virtual ~PathConfigTestCase () {}
+
+  void TraceWithPath (std::string path, int16_t old, int16_t newValue) { m_newValue = newValue; m_path = path; }
+
+private:
+  virtual void DoRun (void);
+
+  int16_t m_newValue;
+  std::string m_path;
+};
+
+PathConfigTestCase::PathConfigTestCase ()
+  : TestCase ("Check ability to configure and trace connect with parsed paths")
+{
+}
+
+void
+PathConfigTestCase::DoRun (void)
+{
+  IntegerValue iv;
+
+  //
+  // Create a root namespace object, with five objects in its NodesA vector.
+  // Only the even ones have a NodeB.
+  //
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  std::vector<Ptr<ConfigTestObject> > nodes;
+  for (uint32_t i = 0; i < 5; ++i)
+    {
+      Ptr<ConfigTestObject> node = CreateObject<ConfigTestObject> ();
+      if (i % 2 == 0)
+        {
+          node->SetNodeB (CreateObject<ConfigTestObject> ());
+        }
+      root->AddNodeA (node);
+      nodes.push_back (node);
+    }
+
+  //
+  // Match a path in one pass, and check that the parsed path finds what
+  // Config::LookupMatches finds.
+  //
+  Config::Path path ("/NodesA/[1-3]|0/NodeB");
+  Config::MatchContainer matches = path.LookupMatches ();
+  Config::MatchContainer expected = Config::LookupMatches ("/NodesA/[1-3]|0/NodeB");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 2, "Unexpected number of matches");
+  NS_TEST_ASSERT_MSG_EQ (expected.GetN (), 2, "Unexpected number of matches");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (0), "/NodesA/0/NodeB/", "Unexpected matched path");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (1), "/NodesA/2/NodeB/", "Unexpected matched path");
+  for (uint32_t i = 0; i < matches.GetN (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (i), expected.GetMatchedPath (i), "Matched paths differ");
+      NS_TEST_ASSERT_MSG_EQ (matches.Get (i), expected.Get (i), "Matched objects differ");
+    }
+
+  //
+  // The objects are matched when the path is used: an object added after
+  // the path was parsed is found.
+  //
+  nodes[1]->SetNodeB (CreateObject<ConfigTestObject> ());
+  Config::Path copy = path;
+  matches = copy.LookupMatches ();
+  NS_TEST_ASSERT_MSG_EQ (copy.GetPath (), "/NodesA/[1-3]|0/NodeB", "Unexpected path");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 3, "New object not matched");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (1), "/NodesA/1/NodeB/", "Unexpected matched path");
+
+  //
+  // Set an attribute of all the objects matched by a wildcard.
+  //
+  Config::Path set ("/NodesA/*/NodeB/A");
+  set.Set (IntegerValue (-5));
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      PointerValue ptr;
+      nodes[i]->GetAttribute ("NodeB", ptr);
+      ptr.Get<ConfigTestObject> ()->GetAttribute ("A", iv);
+      NS_TEST_ASSERT_MSG_EQ (iv.Get (), -5, "Object Attribute \"A\" not set as expected");
+    }
+  nodes[0]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 10, "Object Attribute \"A\" unexpectedly set");
+
+  //
+  // Trace connect with context, then disconnect.
+  //
+  Config::Path source ("/NodesA/3|4/Source");
+  source.Connect (MakeCallback (&PathConfigTestCase::TraceWithPath, this));
+  m_newValue = 0;
+  m_path = "";
+  nodes[4]->SetAttribute ("Source", IntegerValue (-6));
+  NS_TEST_ASSERT_MSG_EQ (m_newValue, -6, "Trace 4 did not fire as expected");
+  NS_TEST_ASSERT_MSG_EQ (m_path, "/NodesA/4/Source", "Trace 4 did not provide expected context");
+  m_newValue = 0;
+  nodes[2]->SetAttribute ("Source", IntegerValue (-6));
+  NS_TEST_ASSERT_MSG_EQ (m_newValue, 0, "Trace 2 fired unexpectedly");
+  source.Disconnect (MakeCallback (&PathConfigTestCase::TraceWithPath, this));
+  nodes[4]->SetAttribute ("Source", IntegerValue (-7));
+  NS_TEST_ASSERT_MSG_EQ (m_newValue, 0, "Trace 4 fired after disconnection");
+
+  //
+  // Paths through the object name service.
+  //
+  Names::Add ("PathConfigTestNode", nodes[3]);
+  Config::Path named ("/Names/PathConfigTestNode/A");
+  named.Set (IntegerValue (-8));
+  nodes[3]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), -8, "Named object Attribute \"A\" not set as expected");
+  Names::Clear ();
+
+  //
+  // The indexes of a map are not the positions of its objects.
+  //
+  root->AddNodeC (0, nodes[0]);
+  root->AddNodeC (5, nodes[1]);
+  root->AddNodeC (7, nodes[2]);
+  matches = Config::Path ("/NodesC/5|7").LookupMatches ();
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 2, "Unexpected number of matches in a map");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (0), "/NodesC/5/", "Unexpected matched path");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (0), nodes[1], "Unexpected object matched in a map");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (1), nodes[2], "Unexpected object matched in a map");
+
+  Config::UnregisterRootNamespaceObject (root);
+}
+
 // ===========================================================================
 // Test for the ability to search attributes of parent classes
 // when Resolver searches for attributes in a derived class object.
@@ -737,6 +881,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase, TestCase::QUICK);
   AddTestCase (new ObjectVectorConfigTestCase, TestCase::QUICK);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase, TestCase::QUICK);
+  AddTestCase (new PathConfigTestCase, TestCase::QUICK);
 }
 
 static ConfigTestSuite configTestSuite;
@@ -359,6 +359,66 @@ AggregateObjectTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_NE (baseA, 0, "Unable to GetObject on released object");
 }
 
+// ===========================================================================
+// Test case to make sure that the lookups follow the aggregation
+// ===========================================================================
+class AggregateLookupTestCase : public TestCase
+{
+public:
+  AggregateLookupTestCase ();
+  virtual ~AggregateLookupTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+AggregateLookupTestCase::AggregateLookupTestCase ()
+  : TestCase ("Check GetObject as the aggregation grows")
+{
+}
+
+AggregateLookupTestCase::~AggregateLookupTestCase ()
+{
+}
+
+void
+AggregateLookupTestCase::DoRun (void)
+{
+  Ptr<BaseA> baseA = CreateObject<BaseA> ();
+  Ptr<DerivedB> derivedB = CreateObject<DerivedB> ();
+
+  //
+  // Look up the missing types more than once, so that the results of the
+  // lookups are remembered.
+  //
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), 0, "Unexpectedly found a BaseB through baseA");
+      NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseA> (BaseA::GetTypeId ()), baseA, "Cannot GetObject for BaseA");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<BaseA> (), 0, "Unexpectedly found a BaseA through derivedB");
+    }
+
+  //
+  // The types missing before the aggregation must be found after.
+  //
+  baseA->AggregateObject (derivedB);
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), derivedB, "Cannot GetObject (through baseA) for BaseB Object");
+      NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<DerivedB> (), derivedB, "Cannot GetObject (through baseA) for DerivedB Object");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<BaseA> (), baseA, "Cannot GetObject (through derivedB) for BaseA Object");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<DerivedA> (), 0, "Unexpectedly found a DerivedA through derivedB");
+    }
+
+  //
+  // And so must the types of a second aggregation.
+  //
+  Ptr<DerivedA> derivedA = CreateObject<DerivedA> ();
+  derivedB->AggregateObject (derivedA);
+  NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<DerivedA> (), derivedA, "Cannot GetObject (through derivedB) for DerivedA Object");
+  NS_TEST_ASSERT_MSG_EQ (derivedA->GetObject<DerivedB> (), derivedB, "Cannot GetObject (through derivedA) for DerivedB Object");
+}
+
 // ===========================================================================
 // Test case to make sure that an Object factory can create Objects
 // ===========================================================================
@@ -445,6 +505,7 @@ ObjectTestSuite::ObjectTestSuite ()
 {
   AddTestCase (new CreateObjectTestCase, TestCase::QUICK);
   AddTestCase (new AggregateObjectTestCase, TestCase::QUICK);
+  AddTestCase (new AggregateLookupTestCase, TestCase::QUICK);
   AddTestCase (new ObjectFactoryTestCase, TestCase::QUICK);
 }
 
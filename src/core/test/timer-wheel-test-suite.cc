@@ -0,0 +1,217 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/timer-wheel.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include <vector>
+#include <stdlib.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup timer-tests
+ * Check the expiration time of the timers and their cancellation.
+ */
+class TimerWheelTestCase : public TestCase
+{
+public:
+  TimerWheelTestCase ();
+  virtual void DoRun (void);
+  /**
+   * Record the expiration of a timer
+   * \param i the index of the timer
+   */
+  void Expire (uint32_t i);
+  /**
+   * Schedule a timer from the simulator
+   * \param i the index of the timer
+   * \param delay the delay of the timer
+   */
+  void Start (uint32_t i, Time delay);
+
+  Ptr<TimerWheel> m_wheel;          //!< The wheel under test
+  std::vector<Time> m_expired;      //!< Expiration time of each timer
+  std::vector<TimerWheel::TimerId> m_ids; //!< Identifier of each timer
+};
+
+TimerWheelTestCase::TimerWheelTestCase ()
+  : TestCase ("Check the expiration and cancellation of timers")
+{
+}
+
+void
+TimerWheelTestCase::Expire (uint32_t i)
+{
+  m_expired[i] = Simulator::Now ();
+}
+
+void
+TimerWheelTestCase::Start (uint32_t i, Time delay)
+{
+  m_ids[i] = m_wheel->Schedule (delay, MakeCallback (&TimerWheelTestCase::Expire, this).Bind (i));
+}
+
+void
+TimerWheelTestCase::DoRun (void)
+{
+  m_wheel = CreateObject<TimerWheel> ();
+  m_wheel->SetGranularity (MilliSeconds (1));
+  m_expired.assign (6, Seconds (-1));
+  m_ids.assign (6, 0);
+
+  Start (0, MilliSeconds (10));
+  Start (1, MicroSeconds (10500));
+  Start (2, Seconds (100));
+  Start (3, MilliSeconds (20));
+  Simulator::Schedule (MilliSeconds (5), &TimerWheel::Cancel, m_wheel, m_ids[3]);
+  Simulator::Schedule (MilliSeconds (7), &TimerWheelTestCase::Start, this, 4, MilliSeconds (3));
+  Simulator::Schedule (Seconds (50), &TimerWheelTestCase::Start, this, 5, Seconds (0));
+
+  NS_TEST_ASSERT_MSG_EQ (m_wheel->IsRunning (m_ids[0]), true, "Timer should be pending");
+  NS_TEST_ASSERT_MSG_EQ (m_wheel->GetDelayLeft (m_ids[2]), Seconds (100), "Wrong delay left");
+  NS_TEST_ASSERT_MSG_EQ (m_wheel->GetNTimers (), 4, "Wrong number of timers");
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_expired[0], MilliSeconds (10), "Wrong expiration time");
+  NS_TEST_ASSERT_MSG_EQ (m_expired[1], MilliSeconds (11), "Expiration not rounded up to a tick");
+  NS_TEST_ASSERT_MSG_EQ (m_expired[2], Seconds (100), "Wrong expiration time of a cascaded timer");
+  NS_TEST_ASSERT_MSG_EQ (m_expired[3], Seconds (-1), "Cancelled timer expired");
+  NS_TEST_ASSERT_MSG_EQ (m_expired[4], MilliSeconds (10), "Wrong expiration time");
+  NS_TEST_ASSERT_MSG_EQ (m_expired[5], Seconds (50) + MilliSeconds (1), "Null delay not run at the next tick");
+  NS_TEST_ASSERT_MSG_EQ (m_wheel->IsRunning (m_ids[0]), false, "Expired timer still pending");
+  NS_TEST_ASSERT_MSG_EQ (m_wheel->GetNTimers (), 0, "Wrong number of timers");
+
+  m_wheel->Dispose ();
+  m_wheel = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup timer-tests
+ * Schedule, restart and cancel many timers at random and check that
+ * each one expires exactly once, at the first tick following its
+ * expiration time.
+ */
+class TimerWheelRandomTestCase : public TestCase
+{
+public:
+  TimerWheelRandomTestCase ();
+  virtual void DoRun (void);
+  /**
+   * Record the expiration of a timer
+   * \param i the index of the timer
+   */
+  void Expire (uint32_t i);
+  /**
+   * Restart or cancel a random timer
+   */
+  void Churn (void);
+
+  Ptr<TimerWheel> m_wheel;          //!< The wheel under test
+  std::vector<TimerWheel::TimerId> m_ids; //!< Identifier of each timer
+  std::vector<Time> m_expected;     //!< Expected expiration time of each timer
+  uint32_t m_errors;                //!< Number of misplaced expirations
+  uint32_t m_expirations;           //!< Number of expirations
+  uint32_t m_churn;                 //!< Number of restarts and cancellations left
+};
+
+TimerWheelRandomTestCase::TimerWheelRandomTestCase ()
+  : TestCase ("Check random timers against their expected expiration time")
+{
+}
+
+void
+TimerWheelRandomTestCase::Expire (uint32_t i)
+{
+  ++m_expirations;
+  if (Simulator::Now () != m_expected[i])
+    {
+      ++m_errors;
+    }
+  m_expected[i] = Seconds (-1);
+}
+
+void
+TimerWheelRandomTestCase::Churn (void)
+{
+  uint32_t i = rand () % m_ids.size ();
+  if (rand () % 4 == 0)
+    {
+      m_wheel->Cancel (m_ids[i]);
+      m_expected[i] = Seconds (-1);
+    }
+  else
+    {
+      m_wheel->Cancel (m_ids[i]);
+      // Delays spanning all the levels and the overflow list
+      int64_t delay = rand () % (1 << (rand () % 26));
+      Time expected = MicroSeconds ((Simulator::Now ().GetMicroSeconds () + delay) + 1);
+      m_expected[i] = expected;
+      m_ids[i] = m_wheel->Schedule (MicroSeconds (delay) + NanoSeconds (500),
+                                    MakeCallback (&TimerWheelRandomTestCase::Expire, this).Bind (i));
+    }
+  if (--m_churn > 0)
+    {
+      Simulator::Schedule (MicroSeconds (rand () % 5000), &TimerWheelRandomTestCase::Churn, this);
+    }
+}
+
+void
+TimerWheelRandomTestCase::DoRun (void)
+{
+  srand (1);
+  m_wheel = CreateObject<TimerWheel> ();
+  m_wheel->SetGranularity (MicroSeconds (1));
+  m_ids.assign (200, 0);
+  m_expected.assign (200, Seconds (-1));
+  m_errors = 0;
+  m_expirations = 0;
+  m_churn = 20000;
+  Simulator::ScheduleNow (&TimerWheelRandomTestCase::Churn, this);
+  Simulator::Run ();
+
+  uint32_t pending = 0;
+  for (uint32_t i = 0; i < m_expected.size (); ++i)
+    {
+      if (m_expected[i] != Seconds (-1))
+        {
+          ++pending;
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_errors, 0, "Timers expired at the wrong time");
+  NS_TEST_ASSERT_MSG_EQ (pending, 0, "Timers did not expire");
+  NS_TEST_ASSERT_MSG_GT (m_expirations, 1000, "Too few expirations to be meaningful");
+
+  m_wheel->Dispose ();
+  m_wheel = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup timer-tests
+ * TimerWheel test suite
+ */
+static class TimerWheelTestSuite : public TestSuite
+{
+public:
+  TimerWheelTestSuite ()
+    : TestSuite ("timer-wheel", UNIT)
+  {
+    AddTestCase (new TimerWheelTestCase (), TestCase::QUICK);
+    AddTestCase (new TimerWheelRandomTestCase (), TestCase::QUICK);
+  }
+} g_timerWheelTestSuite;
@@ -18,6 +18,7 @@
 
 #include "ns3/test.h"
 #include "ns3/traced-callback.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -108,6 +109,104 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+/**
+ * Check the order of the Callbacks of a chain, the disconnection of
+ * the first Callback of a chain, copies of a chain and Callbacks which
+ * connect other Callbacks.
+ */
+class ChainTracedCallbackTestCase : public TestCase
+{
+public:
+  ChainTracedCallbackTestCase ();
+  virtual ~ChainTracedCallbackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Record a call
+   * \param i the index of the Callback
+   * \param a the argument of the trace
+   */
+  void Record (uint32_t i, uint32_t a);
+  /**
+   * Connect Callback 9 to m_trace
+   * \param a the argument of the trace
+   */
+  void ConnectMore (uint32_t a);
+
+  TracedCallback<uint32_t> m_trace; //!< The traced callback under test
+  std::vector<uint32_t> m_calls;    //!< The indexes of the Callbacks called
+};
+
+ChainTracedCallbackTestCase::ChainTracedCallbackTestCase ()
+  : TestCase ("Check the chain of Callbacks of a TracedCallback")
+{
+}
+
+void
+ChainTracedCallbackTestCase::Record (uint32_t i, uint32_t a)
+{
+  m_calls.push_back (i);
+}
+
+void
+ChainTracedCallbackTestCase::ConnectMore (uint32_t a)
+{
+  m_calls.push_back (8);
+  m_trace.ConnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::Record, this).Bind (9U));
+}
+
+void
+ChainTracedCallbackTestCase::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "New chain not empty");
+  m_trace (0);
+  NS_TEST_ASSERT_MSG_EQ (m_calls.size (), 0, "Empty chain called");
+
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      m_trace.ConnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::Record, this).Bind (i));
+    }
+  // Connected twice: both are called, and both are disconnected together
+  m_trace.ConnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::Record, this).Bind (1U));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), false, "Chain empty");
+  m_trace (0);
+  NS_TEST_ASSERT_MSG_EQ (m_calls.size (), 5, "Wrong number of calls");
+  NS_TEST_ASSERT_MSG_EQ (m_calls[0], 0, "Callbacks not called in order");
+  NS_TEST_ASSERT_MSG_EQ (m_calls[3], 3, "Callbacks not called in order");
+  NS_TEST_ASSERT_MSG_EQ (m_calls[4], 1, "Callbacks not called in order");
+
+  TracedCallback<uint32_t> copy = m_trace;
+  m_trace.DisconnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::Record, this).Bind (0U));
+  m_trace.DisconnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::Record, this).Bind (1U));
+  m_calls.clear ();
+  m_trace (0);
+  NS_TEST_ASSERT_MSG_EQ (m_calls.size (), 2, "Wrong number of calls after disconnection");
+  NS_TEST_ASSERT_MSG_EQ (m_calls[0], 2, "Wrong Callback after disconnection of the first one");
+  NS_TEST_ASSERT_MSG_EQ (m_calls[1], 3, "Wrong Callback after disconnection of the first one");
+
+  m_calls.clear ();
+  copy (0);
+  NS_TEST_ASSERT_MSG_EQ (m_calls.size (), 5, "Copy changed by the disconnections");
+
+  m_trace.DisconnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::Record, this).Bind (2U));
+  m_trace.DisconnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::Record, this).Bind (3U));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "Chain not empty after disconnections");
+
+  // A Callback which connects another one: the new one is called too
+  m_trace.ConnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::ConnectMore, this));
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      m_trace.ConnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::Record, this).Bind (i));
+    }
+  m_calls.clear ();
+  m_trace (0);
+  NS_TEST_ASSERT_MSG_EQ (m_calls.size (), 6, "Wrong number of calls");
+  NS_TEST_ASSERT_MSG_EQ (m_calls[0], 8, "Wrong order of calls");
+  NS_TEST_ASSERT_MSG_EQ (m_calls[5], 9, "Callback connected while firing not called");
+}
+
 class TracedCallbackTestSuite : public TestSuite
 {
 public:
@@ -118,6 +217,7 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new ChainTracedCallbackTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite tracedCallbackTestSuite;
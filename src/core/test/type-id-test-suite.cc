@@ -24,6 +24,9 @@
 
 #include "ns3/integer.h"
 #include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/config.h"
+#include "ns3/object-factory.h"
 #include "ns3/object.h"
 #include "ns3/traced-value.h"
 #include "ns3/type-id.h"
@@ -325,6 +328,136 @@ DeprecatedAttributeTestCase::DoRun (void)
        << endl;
 }
 
+
+//----------------------------
+//
+// Attribute chain test
+
+class ChainParent : public Object
+{
+public:
+  ChainParent () : m_a (0) { };
+  virtual ~ChainParent () { };
+  int GetA (void) const { return m_a; }
+
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ChainParent")
+      .SetParent<Object> ()
+      .AddAttribute ("A", "an attribute of the parent",
+                     IntegerValue (1),
+                     MakeIntegerAccessor (&ChainParent::m_a),
+                     MakeIntegerChecker<int> ())
+      .AddTraceSource ("T", "a trace source of the parent",
+                       MakeTraceSourceAccessor (&ChainParent::m_t),
+                       "ns3::TracedValueCallback::Double")
+      ;
+    return tid;
+  }
+private:
+  int m_a;
+  TracedValue<double> m_t;
+};
+
+class ChainChild : public ChainParent
+{
+public:
+  ChainChild () : m_b (0) { };
+  virtual ~ChainChild () { };
+  int GetB (void) const { return m_b; }
+
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ChainChild")
+      .SetParent<ChainParent> ()
+      .AddConstructor<ChainChild> ()
+      .AddAttribute ("B", "an attribute of the child",
+                     IntegerValue (2),
+                     MakeIntegerAccessor (&ChainChild::m_b),
+                     MakeIntegerChecker<int> ())
+      .AddTraceSource ("U", "a trace source of the child",
+                       MakeTraceSourceAccessor (&ChainChild::m_u),
+                       "ns3::TracedValueCallback::Double")
+      ;
+    return tid;
+  }
+private:
+  int m_b;
+  TracedValue<double> m_u;
+};
+
+class AttributeChainTestCase : public TestCase
+{
+public:
+  AttributeChainTestCase ();
+  virtual ~AttributeChainTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+AttributeChainTestCase::AttributeChainTestCase ()
+  : TestCase ("Check the lookup of inherited Attributes and TraceSources")
+{
+}
+
+AttributeChainTestCase::~AttributeChainTestCase ()
+{
+}
+
+void
+AttributeChainTestCase::DoRun (void)
+{
+  TypeId tid = ChainChild::GetTypeId ();
+
+  struct TypeId::AttributeInformation ainfo;
+  NS_TEST_ASSERT_MSG_EQ (tid.LookupAttributeByName ("B", &ainfo), true, "lookup child attribute");
+  NS_TEST_ASSERT_MSG_EQ (ainfo.name, "B", "wrong attribute");
+  NS_TEST_ASSERT_MSG_EQ (tid.LookupAttributeByName ("A", &ainfo), true, "lookup parent attribute");
+  NS_TEST_ASSERT_MSG_EQ (ainfo.name, "A", "wrong attribute");
+  NS_TEST_ASSERT_MSG_EQ (tid.LookupAttributeByName ("C", &ainfo), false, "lookup missing attribute");
+  NS_TEST_ASSERT_MSG_EQ (ChainParent::GetTypeId ().LookupAttributeByName ("B", &ainfo), false,
+                         "lookup child attribute in parent");
+
+  struct TypeId::TraceSourceInformation tinfo;
+  NS_TEST_ASSERT_MSG_NE (tid.LookupTraceSourceByName ("U", &tinfo), 0, "lookup child trace source");
+  NS_TEST_ASSERT_MSG_EQ (tinfo.name, "U", "wrong trace source");
+  NS_TEST_ASSERT_MSG_NE (tid.LookupTraceSourceByName ("T", &tinfo), 0, "lookup parent trace source");
+  NS_TEST_ASSERT_MSG_EQ (tinfo.name, "T", "wrong trace source");
+  NS_TEST_ASSERT_MSG_EQ (tid.LookupTraceSourceByName ("V"), 0, "lookup missing trace source");
+
+  Ptr<const TypeId::AttributeChain> chain = tid.GetAttributeChain ();
+  NS_TEST_ASSERT_MSG_EQ (chain->attributes.size (), 2, "wrong number of attributes");
+  NS_TEST_ASSERT_MSG_EQ (chain->attributes[0].info.name, "B", "child attributes not first");
+  NS_TEST_ASSERT_MSG_EQ (chain->attributes[0].tidName, "ChainChild", "wrong TypeId name");
+  NS_TEST_ASSERT_MSG_EQ (chain->attributes[1].info.name, "A", "parent attributes not last");
+  NS_TEST_ASSERT_MSG_EQ (chain->attributes[1].tidName, "ChainParent", "wrong TypeId name");
+  NS_TEST_ASSERT_MSG_EQ (tid.GetAttributeChain (), chain, "chain rebuilt without changes");
+
+  ObjectFactory factory;
+  factory.SetTypeId (tid);
+  factory.Set ("A", IntegerValue (5));
+  Ptr<ChainChild> object = factory.Create<ChainChild> ();
+  NS_TEST_ASSERT_MSG_EQ (object->GetA (), 5, "factory value not set");
+  NS_TEST_ASSERT_MSG_EQ (object->GetB (), 2, "initial value not set");
+
+  // A new default must be seen by a factory which already created objects
+  Config::SetDefault ("ChainChild::B", IntegerValue (7));
+  NS_TEST_ASSERT_MSG_NE (tid.GetAttributeChain (), chain, "chain not rebuilt");
+  object = factory.Create<ChainChild> ();
+  NS_TEST_ASSERT_MSG_EQ (object->GetA (), 5, "factory value not set");
+  NS_TEST_ASSERT_MSG_EQ (object->GetB (), 7, "new default not set");
+  object = CreateObject<ChainChild> ();
+  NS_TEST_ASSERT_MSG_EQ (object->GetA (), 1, "initial value not set");
+  NS_TEST_ASSERT_MSG_EQ (object->GetB (), 7, "new default not set");
+  Config::SetDefault ("ChainChild::B", IntegerValue (2));
+
+  // And so must a new value, also when converted from a string
+  factory.Set ("B", StringValue ("9"));
+  object = factory.Create<ChainChild> ();
+  NS_TEST_ASSERT_MSG_EQ (object->GetA (), 5, "factory value not set");
+  NS_TEST_ASSERT_MSG_EQ (object->GetB (), 9, "factory string value not set");
+}
+
   
 //----------------------------
 //
@@ -437,6 +570,7 @@ TypeIdTestSuite::TypeIdTestSuite ()
   AddTestCase (new UniqueTypeIdTestCase, QUICK);
   AddTestCase (new CollisionTestCase, QUICK);
   AddTestCase (new DeprecatedAttributeTestCase, QUICK);
+  AddTestCase (new AttributeChainTestCase, QUICK);
 }
 
 static TypeIdTestSuite g_TypeIdTestSuite;  
@@ -30,6 +30,7 @@
 #include "ns3/uinteger.h"
 #include "ns3/pointer.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/packet-burst.h"
 #include "csma-net-device.h"
 #include "csma-channel.h"
 
@@ -77,6 +78,27 @@ CsmaNetDevice::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&CsmaNetDevice::m_receiveErrorModel),
                    MakePointerChecker<ErrorModel> ())
+    .AddAttribute ("RxCoalesceFrames",
+                   "The maximum number of received frames that the device holds "
+                   "before handing them to the higher layers in bursts, like the "
+                   "interrupt moderation of a NIC. The value 1 disables the "
+                   "coalescing. Frames are only coalesced if the device has no "
+                   "promiscuous receive callback. The delivery of a frame to the "
+                   "higher layers is then delayed by up to RxCoalesceTime, while the "
+                   "MacRx and sniffer traces still fire when the frame is received.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&CsmaNetDevice::m_rxCoalesceFrames),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("RxCoalesceTime",
+                   "The maximum time a received frame is held when RxCoalesceFrames "
+                   "is greater than 1, i.e., the largest delay added to the delivery "
+                   "of a frame to the higher layers. The frames of a burst keep their "
+                   "own arrival time (see PacketBurst::GetArrivalTime). With a null "
+                   "time, only the frames received at the same time are delivered "
+                   "together.",
+                   TimeValue (Seconds (0.0)),
+                   MakeTimeAccessor (&CsmaNetDevice::m_rxCoalesceTime),
+                   MakeTimeChecker (Seconds (0.0)))
 
     //
     // Transmit queueing discipline for the device which includes its own set
@@ -184,7 +206,8 @@ CsmaNetDevice::GetTypeId (void)
 }
 
 CsmaNetDevice::CsmaNetDevice ()
-  : m_linkUp (false)
+  : m_rxCoalesceFrames (1),
+    m_linkUp (false)
 {
   NS_LOG_FUNCTION (this);
   m_txMachineState = READY;
@@ -217,6 +240,8 @@ CsmaNetDevice::DoDispose ()
   NS_LOG_FUNCTION_NOARGS ();
   m_channel = 0;
   m_node = 0;
+  m_rxFlushEvent.Cancel ();
+  m_rxPending.clear ();
   NetDevice::DoDispose ();
 }
 
@@ -815,7 +840,60 @@ CsmaNetDevice::Receive (Ptr<Packet> packet, Ptr<CsmaNetDevice> senderDevice)
     {
       m_snifferTrace (originalPacket);
       m_macRxTrace (originalPacket);
-      m_rxCallback (this, packet, protocol, header.GetSource ());
+      if (m_rxCoalesceFrames <= 1 || m_rxBurstCallback.IsNull () || !m_promiscRxCallback.IsNull ())
+        {
+          m_rxCallback (this, packet, protocol, header.GetSource ());
+          return;
+        }
+
+      RxPendingFrame frame;
+      frame.packet = packet;
+      frame.protocol = protocol;
+      frame.source = header.GetSource ();
+      frame.arrival = Simulator::Now ();
+      m_rxPending.push_back (frame);
+      if (m_rxPending.size () >= m_rxCoalesceFrames)
+        {
+          m_rxFlushEvent.Cancel ();
+          FlushRxPending ();
+        }
+      else if (!m_rxFlushEvent.IsRunning ())
+        {
+          m_rxFlushEvent = Simulator::Schedule (m_rxCoalesceTime, &CsmaNetDevice::FlushRxPending, this);
+        }
+    }
+}
+
+void
+CsmaNetDevice::FlushRxPending (void)
+{
+  NS_LOG_FUNCTION (this << m_rxPending.size ());
+  std::vector<RxPendingFrame> pending;
+  pending.swap (m_rxPending);
+  std::vector<RxPendingFrame>::const_iterator i = pending.begin ();
+  while (i != pending.end ())
+    {
+      std::vector<RxPendingFrame>::const_iterator j = i + 1;
+      while (j != pending.end () && j->protocol == i->protocol && j->source == i->source)
+        {
+          ++j;
+        }
+      if (j - i == 1)
+        {
+          m_rxCallback (this, i->packet, i->protocol, i->source);
+        }
+      else
+        {
+          // The higher layers get the arrival time of each frame, e.g., to
+          // refresh the ARP cache as of the frame reception
+          Ptr<PacketBurst> burst = CreateObject<PacketBurst> ();
+          for (std::vector<RxPendingFrame>::const_iterator k = i; k != j; ++k)
+            {
+              burst->AddPacket (k->packet, k->arrival);
+            }
+          m_rxBurstCallback (this, burst, i->protocol, i->source);
+        }
+      i = j;
     }
 }
 
@@ -1023,6 +1101,15 @@ CsmaNetDevice::SetReceiveCallback (NetDevice::ReceiveCallback cb)
 {
   NS_LOG_FUNCTION (&cb);
   m_rxCallback = cb;
+  // A burst callback set earlier may no longer match the receive callback
+  m_rxBurstCallback = NetDevice::ReceiveBurstCallback ();
+}
+
+void
+CsmaNetDevice::SetReceiveBurstCallback (NetDevice::ReceiveBurstCallback cb)
+{
+  NS_LOG_FUNCTION (&cb);
+  m_rxBurstCallback = cb;
 }
 
 Address CsmaNetDevice::GetMulticast (Ipv6Address addr) const
@@ -22,6 +22,7 @@
 #define CSMA_NET_DEVICE_H
 
 #include <cstring>
+#include <vector>
 #include "ns3/node.h"
 #include "ns3/backoff.h"
 #include "ns3/address.h"
@@ -30,6 +31,7 @@
 #include "ns3/packet.h"
 #include "ns3/traced-callback.h"
 #include "ns3/nstime.h"
+#include "ns3/event-id.h"
 #include "ns3/data-rate.h"
 #include "ns3/ptr.h"
 #include "ns3/mac48-address.h"
@@ -314,6 +316,14 @@ public:
    */
   virtual void SetReceiveCallback (NetDevice::ReceiveCallback cb);
 
+  /**
+   * Set the callback to be used to notify higher layers when a burst of
+   * coalesced frames has been received.
+   *
+   * \param cb The callback.
+   */
+  virtual void SetReceiveBurstCallback (NetDevice::ReceiveBurstCallback cb);
+
   /**
    * \brief Get the MAC multicast address corresponding
    * to the IPv6 address provided.
@@ -399,6 +409,13 @@ private:
    */
   void TransmitStart ();
 
+  /**
+   * Deliver the frames held by the receive coalescing to the higher layers.
+   * Consecutive frames with the same source and protocol are delivered as
+   * a single burst.
+   */
+  void FlushRxPending (void);
+
   /**
    * Stop Sending a Packet Down the Wire and Begin the Interframe Gap.
    *
@@ -539,6 +556,39 @@ private:
    */
   Ptr<ErrorModel> m_receiveErrorModel;
 
+  /**
+   * The maximum number of received frames held before they are delivered
+   * to the higher layers as bursts; 1 disables the receive coalescing.
+   */
+  uint32_t m_rxCoalesceFrames;
+
+  /**
+   * The maximum time a received frame is held before being delivered to
+   * the higher layers, when the receive coalescing is enabled.
+   */
+  Time m_rxCoalesceTime;
+
+  /**
+   * A frame held by the receive coalescing.
+   */
+  struct RxPendingFrame
+  {
+    Ptr<Packet> packet;     //!< The frame, without its Ethernet header
+    uint16_t protocol;      //!< The protocol number of the frame
+    Mac48Address source;    //!< The sender of the frame
+    Time arrival;           //!< The time the frame has been received
+  };
+
+  /**
+   * The frames held by the receive coalescing, in order of arrival.
+   */
+  std::vector<RxPendingFrame> m_rxPending;
+
+  /**
+   * The delivery of the frames held by the receive coalescing.
+   */
+  EventId m_rxFlushEvent;
+
   /**
    * The trace source fired when packets come into the "top" of the device
    * at the L3/L2 transition, before being queued for transmission.
@@ -693,6 +743,12 @@ private:
    */
   NetDevice::ReceiveCallback m_rxCallback;
 
+  /**
+   * The callback used to notify higher layers that a burst of coalesced
+   * frames has been received.
+   */
+  NetDevice::ReceiveBurstCallback m_rxBurstCallback;
+
   /**
    * The callback used to notify higher layers that a packet has been received in promiscuous mode.
    */
@@ -71,6 +71,10 @@ public:
   /// \param indent number of spaces to use as base indentation level
   virtual void SerializeToXmlStream (std::ostream &os, int indent) const = 0;
 
+  /// Forgets a flow evicted by the FlowMonitor; does nothing by default
+  /// \param flowId the FlowId of the flow
+  virtual void RemoveFlow (FlowId flowId);
+
 protected:
   /// Returns a new, unique Flow Identifier
   /// \returns a new FlowId
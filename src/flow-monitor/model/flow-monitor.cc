@@ -22,12 +22,15 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/enum.h"
 #include <fstream>
 #include <sstream>
 
 #define INDENT(level) for (int __xpto = 0; __xpto < level; __xpto++) os << ' ';
 
-#define PERIODIC_CHECK_INTERVAL (Seconds (1))
+/// Version of the binary export files
+#define EXPORT_BINARY_VERSION 1
 
 namespace ns3 {
 
@@ -72,6 +75,27 @@ FlowMonitor::GetTypeId (void)
                    TimeValue (Seconds (0.5)),
                    MakeTimeAccessor (&FlowMonitor::m_flowInterruptionsMinTime),
                    MakeTimeChecker ())
+    .AddAttribute ("ExportInterval", ("The interval between two exports of the stats of the flows "
+                                      "which changed to ExportFile.  Zero disables the exports."),
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&FlowMonitor::SetExportInterval,
+                                     &FlowMonitor::GetExportInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("ExportFile", ("The name of the file the stats of the flows are exported to."),
+                   StringValue ("flow-stats.csv"),
+                   MakeStringAccessor (&FlowMonitor::m_exportFile),
+                   MakeStringChecker ())
+    .AddAttribute ("ExportFormat", ("The format of ExportFile."),
+                   EnumValue (FlowMonitor::CSV),
+                   MakeEnumAccessor (&FlowMonitor::m_exportFormat),
+                   MakeEnumChecker (FlowMonitor::CSV, "Csv",
+                                    FlowMonitor::BINARY, "Binary"))
+    .AddAttribute ("FlowIdleTimeout", ("The time after which a flow without any packet is evicted, "
+                                       "once its packets in flight are received or lost.  "
+                                       "Zero keeps all the flows."),
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&FlowMonitor::m_flowIdleTimeout),
+                   MakeTimeChecker ())
   ;
   return tid;
 }
@@ -86,11 +110,21 @@ FlowMonitor::FlowMonitor ()
   : m_enabled (false)
 {
   // m_histogramBinWidth=DEFAULT_BIN_WIDTH;
+  m_timerWheel = CreateObject<TimerWheel> ();
 }
 
 void
 FlowMonitor::DoDispose (void)
 {
+  ExportFlowStats ();
+  if (m_exportStream.is_open ())
+    {
+      m_exportStream.close ();
+    }
+  Simulator::Cancel (m_exportEvent);
+  Simulator::Cancel (m_exportDestroyEvent);
+  m_timerWheel->Dispose ();
+  m_timerWheel = 0;
   for (std::list<Ptr<FlowClassifier> >::iterator iter = m_classifiers.begin ();
       iter != m_classifiers.end ();
       iter ++)
@@ -137,16 +171,32 @@ FlowMonitor::GetStatsForFlow (FlowId flowId)
 
 void
 FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetId, uint32_t packetSize)
+{
+  ReportFirstTxSegments (probe, flowId, packetId, packetSize, 1);
+}
+
+void
+FlowMonitor::ReportFirstTxSegments (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetId,
+                                    uint32_t packetSize, uint32_t segments)
 {
   if (!m_enabled)
     {
       return;
     }
   Time now = Simulator::Now ();
-  TrackedPacket &tracked = m_trackedPackets[std::make_pair (flowId, packetId)];
+  uint64_t key = GetTrackedPacketKey (flowId, packetId);
+  std::pair<TrackedPacketMap::iterator, bool> inserted = m_trackedPackets.insert (std::make_pair (key, TrackedPacket ()));
+  TrackedPacket &tracked = inserted.first->second;
+  if (!inserted.second)
+    {
+      m_timerWheel->Cancel (tracked.lossTimer);
+    }
   tracked.firstSeenTime = now;
   tracked.lastSeenTime = tracked.firstSeenTime;
   tracked.timesForwarded = 0;
+  tracked.segments = segments;
+  tracked.lossTimer = m_timerWheel->Schedule (m_maxPerHopDelay,
+                                              MakeCallback (&FlowMonitor::HandleLossTimeout, this).Bind (key));
   NS_LOG_DEBUG ("ReportFirstTx: adding tracked packet (flowId=" << flowId << ", packetId=" << packetId
                                                                 << ").");
 
@@ -154,12 +204,18 @@ FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t pack
 
   FlowStats &stats = GetStatsForFlow (flowId);
   stats.txBytes += packetSize;
-  stats.txPackets++;
-  if (stats.txPackets == 1)
+  stats.txPackets += segments;
+  if (stats.txPackets == segments)
     {
       stats.timeFirstTxPacket = now;
     }
   stats.timeLastTxPacket = now;
+
+  FlowState *state = NotifyFlowChange (flowId, true);
+  if (state != 0 && inserted.second)
+    {
+      state->inFlight++;
+    }
 }
 
 
@@ -170,8 +226,7 @@ FlowMonitor::ReportForwarding (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t p
     {
       return;
     }
-  std::pair<FlowId, FlowPacketId> key (flowId, packetId);
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (key);
+  TrackedPacketMap::iterator tracked = m_trackedPackets.find (GetTrackedPacketKey (flowId, packetId));
   if (tracked == m_trackedPackets.end ())
     {
       NS_LOG_WARN ("Received packet forward report (flowId=" << flowId << ", packetId=" << packetId
@@ -184,6 +239,7 @@ FlowMonitor::ReportForwarding (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t p
 
   Time delay = (Simulator::Now () - tracked->second.firstSeenTime);
   probe->AddPacketStats (flowId, packetSize, delay);
+  NotifyFlowChange (flowId, true);
 }
 
 
@@ -194,7 +250,7 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
     {
       return;
     }
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
+  TrackedPacketMap::iterator tracked = m_trackedPackets.find (GetTrackedPacketKey (flowId, packetId));
   if (tracked == m_trackedPackets.end ())
     {
       NS_LOG_WARN ("Received packet last-tx report (flowId=" << flowId << ", packetId=" << packetId
@@ -244,15 +300,30 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
   stats.timeLastRxPacket = now;
   stats.timesForwarded += tracked->second.timesForwarded;
 
+  NotifyFlowChange (flowId, true);
+  if (--tracked->second.segments > 0)
+    { // other segments of the packet are still on their way
+      tracked->second.timesForwarded = 0;
+      tracked->second.lastSeenTime = now;
+      return;
+    }
+
   NS_LOG_DEBUG ("ReportLastTx: removing tracked packet (flowId="
                 << flowId << ", packetId=" << packetId << ").");
 
-  m_trackedPackets.erase (tracked); // we don't need to track this packet anymore
+  RemoveTrackedPacket (tracked); // we don't need to track this packet anymore
 }
 
 void
 FlowMonitor::ReportDrop (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetId, uint32_t packetSize,
                          uint32_t reasonCode)
+{
+  ReportDropSegments (probe, flowId, packetId, packetSize, reasonCode, 1);
+}
+
+void
+FlowMonitor::ReportDropSegments (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetId,
+                                 uint32_t packetSize, uint32_t reasonCode, uint32_t segments)
 {
   if (!m_enabled)
     {
@@ -262,24 +333,30 @@ FlowMonitor::ReportDrop (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetI
   probe->AddPacketDropStats (flowId, packetSize, reasonCode);
 
   FlowStats &stats = GetStatsForFlow (flowId);
-  stats.lostPackets++;
+  stats.lostPackets += segments;
   if (stats.packetsDropped.size () < reasonCode + 1)
     {
       stats.packetsDropped.resize (reasonCode + 1, 0);
       stats.bytesDropped.resize (reasonCode + 1, 0);
     }
-  ++stats.packetsDropped[reasonCode];
+  stats.packetsDropped[reasonCode] += segments;
   stats.bytesDropped[reasonCode] += packetSize;
   NS_LOG_DEBUG ("++stats.packetsDropped[" << reasonCode<< "]; // becomes: " << stats.packetsDropped[reasonCode]);
 
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
-  if (tracked != m_trackedPackets.end ())
+  NotifyFlowChange (flowId, true);
+
+  TrackedPacketMap::iterator tracked = m_trackedPackets.find (GetTrackedPacketKey (flowId, packetId));
+  if (tracked != m_trackedPackets.end () && tracked->second.segments > segments)
+    {
+      tracked->second.segments -= segments;
+    }
+  else if (tracked != m_trackedPackets.end ())
     {
       // we don't need to track this packet anymore
       // FIXME: this will not necessarily be true with broadcast/multicast
       NS_LOG_DEBUG ("ReportDrop: removing tracked packet (flowId="
                     << flowId << ", packetId=" << packetId << ").");
-      m_trackedPackets.erase (tracked);
+      RemoveTrackedPacket (tracked);
     }
 }
 
@@ -290,49 +367,326 @@ FlowMonitor::GetFlowStats () const
 }
 
 
+uint64_t
+FlowMonitor::GetTrackedPacketKey (FlowId flowId, FlowPacketId packetId)
+{
+  return (static_cast<uint64_t> (flowId) << 32) | packetId;
+}
+
+void
+FlowMonitor::RemoveTrackedPacket (TrackedPacketMap::iterator tracked)
+{
+  m_timerWheel->Cancel (tracked->second.lossTimer);
+  if (IsStreaming ())
+    {
+      FlowStateMap::iterator state = m_flowStates.find (tracked->first >> 32);
+      if (state != m_flowStates.end () && state->second.inFlight > 0)
+        {
+          state->second.inFlight--;
+        }
+    }
+  m_trackedPackets.erase (tracked);
+}
+
+void
+FlowMonitor::LosePacket (TrackedPacketMap::iterator tracked)
+{
+  FlowId flowId = tracked->first >> 32;
+  NS_LOG_DEBUG ("Packet (flowId=" << flowId << ", packetId=" << (tracked->first & 0xffffffff)
+                                  << ") is considered lost.");
+  // packets of flows evicted while they were in flight are not counted
+  FlowStatsContainerI flow = m_flowStats.find (flowId);
+  if (flow != m_flowStats.end ())
+    {
+      flow->second.lostPackets += tracked->second.segments;
+      NotifyFlowChange (flowId, false);
+    }
+  RemoveTrackedPacket (tracked);
+}
+
+void
+FlowMonitor::HandleLossTimeout (uint64_t key)
+{
+  TrackedPacketMap::iterator tracked = m_trackedPackets.find (key);
+  NS_ASSERT (tracked != m_trackedPackets.end ());
+  tracked->second.lossTimer = 0;
+  // the timer is not moved when the packet is forwarded, but here
+  Time idle = Simulator::Now () - tracked->second.lastSeenTime;
+  if (idle >= m_maxPerHopDelay)
+    {
+      LosePacket (tracked);
+    }
+  else
+    {
+      tracked->second.lossTimer = m_timerWheel->Schedule (m_maxPerHopDelay - idle,
+                                                          MakeCallback (&FlowMonitor::HandleLossTimeout, this).Bind (key));
+    }
+}
+
 void
 FlowMonitor::CheckForLostPackets (Time maxDelay)
 {
   Time now = Simulator::Now ();
 
+  // erasing invalidates the iterators of m_trackedPackets
+  std::vector<uint64_t> lost;
   for (TrackedPacketMap::iterator iter = m_trackedPackets.begin ();
-       iter != m_trackedPackets.end (); )
+       iter != m_trackedPackets.end (); iter++)
     {
       if (now - iter->second.lastSeenTime >= maxDelay)
         {
-          // packet is considered lost, add it to the loss statistics
-          FlowStatsContainerI flow = m_flowStats.find (iter->first.first);
-          NS_ASSERT (flow != m_flowStats.end ());
-          flow->second.lostPackets++;
+          lost.push_back (iter->first);
+        }
+    }
+  for (std::vector<uint64_t>::const_iterator iter = lost.begin (); iter != lost.end (); iter++)
+    {
+      LosePacket (m_trackedPackets.find (*iter));
+    }
+}
+
+void
+FlowMonitor::CheckForLostPackets ()
+{
+  CheckForLostPackets (m_maxPerHopDelay);
+}
 
-          // we won't track it anymore
-          m_trackedPackets.erase (iter++);
+bool
+FlowMonitor::IsStreaming () const
+{
+  return m_exportInterval.IsStrictlyPositive () || m_flowIdleTimeout.IsStrictlyPositive ();
+}
+
+FlowMonitor::FlowState *
+FlowMonitor::NotifyFlowChange (FlowId flowId, bool activity)
+{
+  if (!IsStreaming ())
+    {
+      return 0;
+    }
+  FlowState &state = m_flowStates[flowId];
+  if (!state.dirty && m_exportInterval.IsStrictlyPositive ())
+    {
+      state.dirty = true;
+      m_dirtyFlows.push_back (flowId);
+    }
+  if (activity)
+    {
+      state.lastActivity = Simulator::Now ();
+      if (m_flowIdleTimeout.IsStrictlyPositive () && !m_timerWheel->IsRunning (state.idleTimer))
+        {
+          state.idleTimer = m_timerWheel->Schedule (std::max (m_flowIdleTimeout, m_maxPerHopDelay),
+                                                    MakeCallback (&FlowMonitor::HandleIdleTimeout, this).Bind (flowId));
         }
-      else
+    }
+  return &state;
+}
+
+void
+FlowMonitor::HandleIdleTimeout (FlowId flowId)
+{
+  FlowStateMap::iterator state = m_flowStates.find (flowId);
+  if (state == m_flowStates.end ())
+    {
+      return;
+    }
+  state->second.idleTimer = 0;
+  // the timer is not moved by the activity of the flow, but here
+  Time timeout = std::max (m_flowIdleTimeout, m_maxPerHopDelay);
+  Time idle = Simulator::Now () - state->second.lastActivity;
+  if (idle < timeout)
+    {
+      state->second.idleTimer = m_timerWheel->Schedule (timeout - idle,
+                                                        MakeCallback (&FlowMonitor::HandleIdleTimeout, this).Bind (flowId));
+    }
+  else if (state->second.inFlight > 0)
+    {
+      // the packets are lost at the same tick, wait for their timers
+      state->second.idleTimer = m_timerWheel->Schedule (m_timerWheel->GetGranularity (),
+                                                        MakeCallback (&FlowMonitor::HandleIdleTimeout, this).Bind (flowId));
+    }
+  else
+    {
+      EvictFlow (flowId);
+    }
+}
+
+void
+FlowMonitor::EvictFlow (FlowId flowId)
+{
+  NS_LOG_FUNCTION (this << flowId);
+  FlowStatsContainerI flow = m_flowStats.find (flowId);
+  if (flow != m_flowStats.end ())
+    {
+      if (m_exportInterval.IsStrictlyPositive () && OpenExportFile ())
         {
-          iter++;
+          WriteFlowStats (flowId, flow->second, true);
         }
+      m_flowStats.erase (flow);
+    }
+  // the flow is skipped by the next export, as it has no state anymore
+  FlowStateMap::iterator state = m_flowStates.find (flowId);
+  if (state != m_flowStates.end ())
+    {
+      m_timerWheel->Cancel (state->second.idleTimer);
+      m_flowStates.erase (state);
+    }
+  for (uint32_t i = 0; i < m_flowProbes.size (); i++)
+    {
+      m_flowProbes[i]->RemoveFlow (flowId);
+    }
+  for (std::list<Ptr<FlowClassifier> >::iterator iter = m_classifiers.begin ();
+       iter != m_classifiers.end (); iter++)
+    {
+      (*iter)->RemoveFlow (flowId);
     }
 }
 
 void
-FlowMonitor::CheckForLostPackets ()
+FlowMonitor::SetExportInterval (Time interval)
 {
-  CheckForLostPackets (m_maxPerHopDelay);
+  NS_LOG_FUNCTION (this << interval);
+  m_exportInterval = interval;
+  Simulator::Cancel (m_exportEvent);
+  Simulator::Cancel (m_exportDestroyEvent);
+  if (m_exportInterval.IsStrictlyPositive ())
+    {
+      m_exportEvent = Simulator::Schedule (m_exportInterval, &FlowMonitor::PeriodicExport, this);
+      // the last export, while the simulation time is still known
+      m_exportDestroyEvent = Simulator::ScheduleDestroy (&FlowMonitor::ExportFlowStats, this);
+    }
+}
+
+Time
+FlowMonitor::GetExportInterval () const
+{
+  return m_exportInterval;
 }
 
 void
-FlowMonitor::PeriodicCheckForLostPackets ()
+FlowMonitor::PeriodicExport ()
 {
-  CheckForLostPackets ();
-  Simulator::Schedule (PERIODIC_CHECK_INTERVAL, &FlowMonitor::PeriodicCheckForLostPackets, this);
+  ExportFlowStats ();
+  m_exportEvent = Simulator::Schedule (m_exportInterval, &FlowMonitor::PeriodicExport, this);
 }
 
 void
-FlowMonitor::NotifyConstructionCompleted ()
+FlowMonitor::ExportFlowStats ()
 {
-  Object::NotifyConstructionCompleted ();
-  Simulator::Schedule (PERIODIC_CHECK_INTERVAL, &FlowMonitor::PeriodicCheckForLostPackets, this);
+  if (!m_exportInterval.IsStrictlyPositive () || !OpenExportFile ())
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << m_dirtyFlows.size ());
+  for (std::vector<FlowId>::const_iterator iter = m_dirtyFlows.begin (); iter != m_dirtyFlows.end (); iter++)
+    {
+      // an evicted flow may have been listed again
+      FlowStateMap::iterator state = m_flowStates.find (*iter);
+      if (state == m_flowStates.end () || !state->second.dirty)
+        {
+          continue;
+        }
+      state->second.dirty = false;
+      FlowStatsContainerCI flow = m_flowStats.find (*iter);
+      if (flow != m_flowStats.end ())
+        {
+          WriteFlowStats (*iter, flow->second, false);
+        }
+    }
+  m_dirtyFlows.clear ();
+  m_exportStream.flush ();
+}
+
+bool
+FlowMonitor::OpenExportFile ()
+{
+  if (m_exportStream.is_open ())
+    {
+      return true;
+    }
+  if (m_exportFormat == BINARY)
+    {
+      m_exportStream.open (m_exportFile.c_str (), std::ios::out | std::ios::binary);
+    }
+  else
+    {
+      m_exportStream.open (m_exportFile.c_str (), std::ios::out);
+    }
+  if (!m_exportStream.is_open ())
+    {
+      NS_LOG_ERROR ("Unable to open the export file " << m_exportFile);
+      return false;
+    }
+  if (m_exportFormat == BINARY)
+    {
+      m_exportStream.write ("ns3flows", 8);
+      uint32_t version = EXPORT_BINARY_VERSION;
+      for (uint32_t i = 0; i < 4; i++)
+        {
+          m_exportStream.put ((version >> (8 * i)) & 0xff);
+        }
+    }
+  else
+    {
+      m_exportStream << "time,flowId,timeFirstTxPacket,timeFirstRxPacket,timeLastTxPacket,timeLastRxPacket,"
+                     << "delaySum,jitterSum,lastDelay,txBytes,rxBytes,txPackets,rxPackets,"
+                     << "lostPackets,timesForwarded,evicted\n";
+    }
+  return true;
+}
+
+/**
+ * Write an integer in little endian
+ * \param os the output stream
+ * \param value the value
+ * \param bytes the number of bytes to write
+ */
+static void
+WriteLittleEndian (std::ostream &os, uint64_t value, uint32_t bytes)
+{
+  for (uint32_t i = 0; i < bytes; i++)
+    {
+      os.put (static_cast<char> ((value >> (8 * i)) & 0xff));
+    }
+}
+
+void
+FlowMonitor::WriteFlowStats (FlowId flowId, const FlowStats &stats, bool evicted)
+{
+  Time now = Simulator::Now ();
+  if (m_exportFormat == BINARY)
+    {
+      WriteLittleEndian (m_exportStream, now.GetNanoSeconds (), 8);
+      WriteLittleEndian (m_exportStream, flowId, 4);
+      WriteLittleEndian (m_exportStream, stats.timeFirstTxPacket.GetNanoSeconds (), 8);
+      WriteLittleEndian (m_exportStream, stats.timeFirstRxPacket.GetNanoSeconds (), 8);
+      WriteLittleEndian (m_exportStream, stats.timeLastTxPacket.GetNanoSeconds (), 8);
+      WriteLittleEndian (m_exportStream, stats.timeLastRxPacket.GetNanoSeconds (), 8);
+      WriteLittleEndian (m_exportStream, stats.delaySum.GetNanoSeconds (), 8);
+      WriteLittleEndian (m_exportStream, stats.jitterSum.GetNanoSeconds (), 8);
+      WriteLittleEndian (m_exportStream, stats.lastDelay.GetNanoSeconds (), 8);
+      WriteLittleEndian (m_exportStream, stats.txBytes, 8);
+      WriteLittleEndian (m_exportStream, stats.rxBytes, 8);
+      WriteLittleEndian (m_exportStream, stats.txPackets, 4);
+      WriteLittleEndian (m_exportStream, stats.rxPackets, 4);
+      WriteLittleEndian (m_exportStream, stats.lostPackets, 4);
+      WriteLittleEndian (m_exportStream, stats.timesForwarded, 4);
+      WriteLittleEndian (m_exportStream, evicted, 1);
+    }
+  else
+    {
+      m_exportStream << now.GetNanoSeconds () << ',' << flowId
+                     << ',' << stats.timeFirstTxPacket.GetNanoSeconds ()
+                     << ',' << stats.timeFirstRxPacket.GetNanoSeconds ()
+                     << ',' << stats.timeLastTxPacket.GetNanoSeconds ()
+                     << ',' << stats.timeLastRxPacket.GetNanoSeconds ()
+                     << ',' << stats.delaySum.GetNanoSeconds ()
+                     << ',' << stats.jitterSum.GetNanoSeconds ()
+                     << ',' << stats.lastDelay.GetNanoSeconds ()
+                     << ',' << stats.txBytes << ',' << stats.rxBytes
+                     << ',' << stats.txPackets << ',' << stats.rxPackets
+                     << ',' << stats.lostPackets << ',' << stats.timesForwarded
+                     << ',' << evicted << '\n';
+    }
 }
 
 void
@@ -392,6 +746,7 @@ FlowMonitor::StopRightNow ()
     }
   m_enabled = false;
   CheckForLostPackets ();
+  ExportFlowStats ();
 }
 
 void
@@ -23,6 +23,7 @@
 
 #include <vector>
 #include <map>
+#include <fstream>
 
 #include "ns3/ptr.h"
 #include "ns3/object.h"
@@ -31,6 +32,8 @@
 #include "ns3/histogram.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
+#include "ns3/timer-wheel.h"
+#include "ns3/open-hash-map.h"
 
 namespace ns3 {
 
@@ -46,6 +49,31 @@ namespace ns3 {
  * The FlowMonitor class is responsible for coordinating efforts
  * regarding probes, and collects end-to-end flow statistics.
  *
+ * The packets in flight are kept in a hash table, and each of them has
+ * a timer on a TimerWheel which declares it lost once it has not been
+ * seen for MaxPerHopDelay.
+ *
+ * For long simulations with many flows, the statistics can also be
+ * streamed: every ExportInterval, the statistics of the flows which
+ * changed since the previous export are appended to ExportFile, in CSV
+ * or binary form. And the flows idle for FlowIdleTimeout (and for
+ * MaxPerHopDelay) are written a last time and evicted from the monitor
+ * and its probes, so that the memory used depends on the number of
+ * active flows only. A flow which becomes active again after its
+ * eviction keeps its FlowId, with statistics starting from zero.
+ *
+ * The CSV file has a header line, then one line per record with the
+ * fields: time, flowId, timeFirstTxPacket, timeFirstRxPacket,
+ * timeLastTxPacket, timeLastRxPacket, delaySum, jitterSum, lastDelay
+ * (all times in nanoseconds), txBytes, rxBytes, txPackets, rxPackets,
+ * lostPackets, timesForwarded, evicted (1 for the last record of an
+ * evicted flow).
+ *
+ * The binary file starts with the 8 bytes "ns3flows" and a 32 bits
+ * version; the records follow, with the same fields in the same order,
+ * as little endian integers: 64 bits for the times and the byte
+ * counts, 32 bits for the flowId and the packet counts, 8 bits for the
+ * eviction flag.
  */
 class FlowMonitor : public Object
 {
@@ -177,6 +205,16 @@ public:
   /// \param packetId Packet ID
   /// \param packetSize packet size
   void ReportFirstTx (Ptr<FlowProbe> probe, FlowId flowId, FlowPacketId packetId, uint32_t packetSize);
+  /// Same as ReportFirstTx, for a packet split into several packets
+  /// before reaching the device (TCP segmentation offload). These
+  /// segments are received and dropped one by one under the same packet ID.
+  /// \param probe the reporting probe
+  /// \param flowId flow identification
+  /// \param packetId Packet ID
+  /// \param packetSize total size of the segments
+  /// \param segments number of segments
+  void ReportFirstTxSegments (Ptr<FlowProbe> probe, FlowId flowId, FlowPacketId packetId,
+                              uint32_t packetSize, uint32_t segments);
   /// FlowProbe implementations are supposed to call this method to
   /// report that a known packet is being forwarded.
   /// \param probe the reporting probe
@@ -200,10 +238,25 @@ public:
   /// \param reasonCode drop reason code
   void ReportDrop (Ptr<FlowProbe> probe, FlowId flowId, FlowPacketId packetId,
                    uint32_t packetSize, uint32_t reasonCode);
+  /// Same as ReportDrop, for a packet dropped before being split into
+  /// segments (see ReportFirstTxSegments).
+  /// \param probe the reporting probe
+  /// \param flowId flow identification
+  /// \param packetId Packet ID
+  /// \param packetSize total size of the segments
+  /// \param reasonCode drop reason code
+  /// \param segments number of segments dropped
+  void ReportDropSegments (Ptr<FlowProbe> probe, FlowId flowId, FlowPacketId packetId,
+                           uint32_t packetSize, uint32_t reasonCode, uint32_t segments);
 
   /// Check right now for packets that appear to be lost
   void CheckForLostPackets ();
 
+  /// Append the statistics of the flows which changed since the
+  /// previous export to the export file, right now.  Does nothing
+  /// unless ExportInterval is set.
+  void ExportFlowStats ();
+
   /// Check right now for packets that appear to be lost, considering
   /// packets as lost if not seen in the network for a time larger
   /// than maxDelay
@@ -236,6 +289,13 @@ public:
   /// \returns a list of all the probes
   const FlowProbeContainer& GetAllProbes () const;
 
+  /// Format of the export file
+  enum ExportFormat
+  {
+    CSV,   //!< Comma separated values, with a header line
+    BINARY //!< Fixed size little endian records
+  };
+
   /// Serializes the results to an std::ostream in XML format
   /// \param os the output stream
   /// \param indent number of spaces to use as base indentation level
@@ -259,7 +319,6 @@ public:
 
 protected:
 
-  virtual void NotifyConstructionCompleted ();
   virtual void DoDispose (void);
 
 private:
@@ -270,16 +329,63 @@ private:
     Time firstSeenTime; //!< absolute time when the packet was first seen by a probe
     Time lastSeenTime; //!< absolute time when the packet was last seen by a probe
     uint32_t timesForwarded; //!< number of times the packet was reportedly forwarded
+    uint32_t segments; //!< number of segments of the packet not received nor dropped yet
+    TimerWheel::TimerId lossTimer; //!< timer declaring the packet lost
+  };
+
+  /// Streaming state of a flow
+  struct FlowState
+  {
+    FlowState () : inFlight (0), dirty (false), idleTimer (0) {}
+    Time lastActivity;             //!< last time a packet of the flow was seen
+    uint32_t inFlight;             //!< number of tracked packets of the flow
+    bool dirty;                    //!< the stats changed since the last export
+    TimerWheel::TimerId idleTimer; //!< timer evicting the flow
+  };
+
+  /// Hash of the key of a tracked packet
+  struct TrackedPacketHash
+  {
+    /// \param key the key
+    /// \returns the hash of the key
+    uint64_t operator() (uint64_t key) const
+    {
+      return key;
+    }
+  };
+
+  /// Hash of a FlowId
+  struct FlowIdHash
+  {
+    /// \param flowId the FlowId
+    /// \returns the hash of the FlowId
+    uint32_t operator() (FlowId flowId) const
+    {
+      return flowId;
+    }
   };
 
   /// FlowId --> FlowStats
   FlowStatsContainer m_flowStats;
 
-  /// (FlowId,PacketId) --> TrackedPacket
-  typedef std::map< std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
+  /// (FlowId << 32 | PacketId) --> TrackedPacket
+  typedef OpenHashMap<uint64_t, TrackedPacket, TrackedPacketHash> TrackedPacketMap;
   TrackedPacketMap m_trackedPackets; //!< Tracked packets
   Time m_maxPerHopDelay; //!< Minimum per-hop delay
   FlowProbeContainer m_flowProbes; //!< all the FlowProbes
+  Ptr<TimerWheel> m_timerWheel; //!< Timers of the tracked packets and flows
+
+  /// FlowId --> FlowState
+  typedef OpenHashMap<FlowId, FlowState, FlowIdHash> FlowStateMap;
+  FlowStateMap m_flowStates;        //!< Streaming state of the flows
+  std::vector<FlowId> m_dirtyFlows; //!< Flows changed since the last export
+  Time m_exportInterval;            //!< Interval between exports, zero if disabled
+  std::string m_exportFile;         //!< Name of the export file
+  ExportFormat m_exportFormat;      //!< Format of the export file
+  std::ofstream m_exportStream;     //!< The export file
+  EventId m_exportEvent;            //!< Next export
+  EventId m_exportDestroyEvent;     //!< Last export, at the end of the simulation
+  Time m_flowIdleTimeout;           //!< Idle time before eviction, zero if disabled
 
   // note: this is needed only for serialization
   std::list<Ptr<FlowClassifier> > m_classifiers; //!< the FlowClassifiers
@@ -298,8 +404,60 @@ private:
   /// \returns the stats of the flow
   FlowStats& GetStatsForFlow (FlowId flowId);
 
-  /// Periodic function to check for lost packets and prune statistics
-  void PeriodicCheckForLostPackets ();
+  /// \param flowId the Flow identification
+  /// \param packetId the Packet identification
+  /// \returns the key of the packet in m_trackedPackets
+  static uint64_t GetTrackedPacketKey (FlowId flowId, FlowPacketId packetId);
+
+  /// Stop tracking a packet
+  /// \param tracked the packet
+  void RemoveTrackedPacket (TrackedPacketMap::iterator tracked);
+
+  /// Count a tracked packet as lost, and stop tracking it
+  /// \param tracked the packet
+  void LosePacket (TrackedPacketMap::iterator tracked);
+
+  /// Loss timer of a tracked packet
+  /// \param key the key of the packet
+  void HandleLossTimeout (uint64_t key);
+
+  /// \returns true if the stats of the flows are exported or evicted
+  bool IsStreaming () const;
+
+  /// Record a change of the stats of a flow
+  /// \param flowId the Flow identification
+  /// \param activity true if a packet of the flow was seen
+  /// \returns the streaming state of the flow, valid until the next
+  /// change of m_flowStates, or 0 if not streaming
+  FlowState *NotifyFlowChange (FlowId flowId, bool activity);
+
+  /// Idle timer of a flow
+  /// \param flowId the Flow identification
+  void HandleIdleTimeout (FlowId flowId);
+
+  /// Write the last stats of a flow, and forget it
+  /// \param flowId the Flow identification
+  void EvictFlow (FlowId flowId);
+
+  /// Export the flow stats, and schedule the next export
+  void PeriodicExport ();
+
+  /// Set the interval between exports, and schedule the next one
+  /// \param interval the interval, zero to disable the exports
+  void SetExportInterval (Time interval);
+
+  /// \returns the interval between exports
+  Time GetExportInterval () const;
+
+  /// Open the export file, unless it is already open
+  /// \returns true if the file is open
+  bool OpenExportFile ();
+
+  /// Append the stats of a flow to the export file
+  /// \param flowId the Flow identification
+  /// \param stats the stats
+  /// \param evicted true if the flow is being evicted
+  void WriteFlowStats (FlowId flowId, const FlowStats &stats, bool evicted);
 };
 
 
@@ -82,6 +82,12 @@ FlowProbe::GetStats () const
   return m_stats;
 }
 
+void
+FlowProbe::RemoveFlow (FlowId flowId)
+{
+  m_stats.erase (flowId);
+}
+
 void
 FlowProbe::SerializeToXmlStream (std::ostream &os, int indent, uint32_t index) const
 {
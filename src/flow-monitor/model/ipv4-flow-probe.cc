@@ -27,6 +27,8 @@
 #include "ns3/pointer.h"
 #include "ns3/config.h"
 #include "ns3/flow-id-tag.h"
+#include "ns3/tcp-gso-tag.h"
+#include "ns3/tcp-header.h"
 
 namespace ns3 {
 
@@ -112,7 +114,7 @@ public:
 private:
   uint32_t m_flowId;      //!< flow identifier
   uint32_t m_packetId;    //!< packet identifier
-  uint32_t m_packetSize;  //!< packet size
+  uint32_t m_packetSize;  //!< packet size (average size of the segments of a TCP super-segment)
   Ipv4Address m_src;      //!< IP source
   Ipv4Address m_dst;      //!< IP destination
 };
@@ -287,6 +289,32 @@ Ipv4FlowProbe::DoDispose ()
   FlowProbe::DoDispose ();
 }
 
+/**
+ * \brief Get the number of segments a packet is split into before the device
+ *
+ * A TCP super-segment is split in segments below IP, each one with its own
+ * TCP and IP headers (see TcpGsoTag).
+ *
+ * \param ipPayload the IP payload
+ * \param ipHeaderSize the size of the IP header
+ * \param size the size of the IP packet, set to the total size of the segments
+ * \return the number of segments, 1 if the packet is not a super-segment
+ */
+static uint32_t
+GetGsoSegments (Ptr<const Packet> ipPayload, uint32_t ipHeaderSize, uint32_t &size)
+{
+  TcpGsoTag gsoTag;
+  if (!ipPayload->PeekPacketTag (gsoTag))
+    {
+      return 1;
+    }
+  TcpHeader tcpHeader;
+  ipPayload->PeekHeader (tcpHeader);
+  uint32_t segments = gsoTag.GetSegments ();
+  size += (segments - 1) * (ipHeaderSize + tcpHeader.GetSerializedSize ());
+  return segments;
+}
+
 void
 Ipv4FlowProbe::SendOutgoingLogger (const Ipv4Header &ipHeader, Ptr<const Packet> ipPayload, uint32_t interface)
 {
@@ -309,13 +337,14 @@ Ipv4FlowProbe::SendOutgoingLogger (const Ipv4Header &ipHeader, Ptr<const Packet>
   if (m_classifier->Classify (ipHeader, ipPayload, &flowId, &packetId))
     {
       uint32_t size = (ipPayload->GetSize () + ipHeader.GetSerializedSize ());
-      NS_LOG_DEBUG ("ReportFirstTx ("<<this<<", "<<flowId<<", "<<packetId<<", "<<size<<"); "
+      uint32_t segments = GetGsoSegments (ipPayload, ipHeader.GetSerializedSize (), size);
+      NS_LOG_DEBUG ("ReportFirstTx ("<<this<<", "<<flowId<<", "<<packetId<<", "<<size<<", "<<segments<<"); "
                                      << ipHeader << *ipPayload);
-      m_flowMonitor->ReportFirstTx (this, flowId, packetId, size);
+      m_flowMonitor->ReportFirstTxSegments (this, flowId, packetId, size, segments);
 
       // tag the packet with the flow id and packet id, so that the packet can be identified even
       // when Ipv4Header is not accessible at some non-IPv4 protocol layer
-      Ipv4FlowProbeTag fTag (flowId, packetId, size, ipHeader.GetSource (), ipHeader.GetDestination ());
+      Ipv4FlowProbeTag fTag (flowId, packetId, size / segments, ipHeader.GetSource (), ipHeader.GetDestination ());
       ipPayload->AddByteTag (fTag);
     }
 }
@@ -403,6 +432,7 @@ Ipv4FlowProbe::DropLogger (const Ipv4Header &ipHeader, Ptr<const Packet> ipPaylo
       FlowPacketId packetId = fTag.GetPacketId ();
 
       uint32_t size = (ipPayload->GetSize () + ipHeader.GetSerializedSize ());
+      uint32_t segments = GetGsoSegments (ipPayload, ipHeader.GetSerializedSize (), size);
       NS_LOG_DEBUG ("Drop ("<<this<<", "<<flowId<<", "<<packetId<<", "<<size<<", " << reason 
                             << ", destIp=" << ipHeader.GetDestination () << "); "
                             << "HDR: " << ipHeader << " PKT: " << *ipPayload);
@@ -442,7 +472,7 @@ Ipv4FlowProbe::DropLogger (const Ipv4Header &ipHeader, Ptr<const Packet> ipPaylo
           NS_FATAL_ERROR ("Unexpected drop reason code " << reason);
         }
 
-      m_flowMonitor->ReportDrop (this, flowId, packetId, size, myReason);
+      m_flowMonitor->ReportDropSegments (this, flowId, packetId, size, myReason, segments);
     }
 }
 
@@ -480,12 +510,19 @@ Ipv4FlowProbe::QueueDiscDropLogger (Ptr<const QueueItem> item)
 
   FlowId flowId = fTag.GetFlowId ();
   FlowPacketId packetId = fTag.GetPacketId ();
-  uint32_t size = fTag.GetPacketSize ();
+  // queue discs may drop a TCP super-segment, which is not split yet
+  uint32_t segments = 1;
+  TcpGsoTag gsoTag;
+  if (item->GetPacket ()->PeekPacketTag (gsoTag))
+    {
+      segments = gsoTag.GetSegments ();
+    }
+  uint32_t size = fTag.GetPacketSize () * segments;
 
   NS_LOG_DEBUG ("Drop ("<<this<<", "<<flowId<<", "<<packetId<<", "<<size<<", " << DROP_QUEUE_DISC
                         << "); ");
 
-  m_flowMonitor->ReportDrop (this, flowId, packetId, size, DROP_QUEUE_DISC);
+  m_flowMonitor->ReportDropSegments (this, flowId, packetId, size, DROP_QUEUE_DISC, segments);
 }
 
 } // namespace ns3
@@ -156,15 +156,17 @@ Ipv6FlowClassifier::Classify (const Ipv6Header &ipHeader, Ptr<const Packet> ipPa
     {
       FlowId newFlowId = GetNewFlowId ();
       insert.first->second = newFlowId;
-      m_flowPktIdMap[newFlowId] = 0;
+      FlowEntry &entry = m_flowPktIdMap[newFlowId];
+      entry.tuple = insert.first;
+      entry.lastPacketId = 0;
     }
   else
     {
-      m_flowPktIdMap[insert.first->second] ++;
+      m_flowPktIdMap[insert.first->second].lastPacketId ++;
     }
 
   *out_flowId = insert.first->second;
-  *out_packetId = m_flowPktIdMap[*out_flowId];
+  *out_packetId = m_flowPktIdMap[*out_flowId].lastPacketId;
 
   return true;
 }
@@ -173,19 +175,27 @@ Ipv6FlowClassifier::Classify (const Ipv6Header &ipHeader, Ptr<const Packet> ipPa
 Ipv6FlowClassifier::FiveTuple
 Ipv6FlowClassifier::FindFlow (FlowId flowId) const
 {
-  for (std::map<FiveTuple, FlowId>::const_iterator
-       iter = m_flowMap.begin (); iter != m_flowMap.end (); iter++)
+  std::map<FlowId, FlowEntry>::const_iterator iter = m_flowPktIdMap.find (flowId);
+  if (iter != m_flowPktIdMap.end ())
     {
-      if (iter->second == flowId)
-        {
-          return iter->first;
-        }
+      return iter->second.tuple->first;
     }
   NS_FATAL_ERROR ("Could not find the flow with ID " << flowId);
   FiveTuple retval = { Ipv6Address::GetZero (), Ipv6Address::GetZero (), 0, 0, 0 };
   return retval;
 }
 
+void
+Ipv6FlowClassifier::RemoveFlow (FlowId flowId)
+{
+  std::map<FlowId, FlowEntry>::iterator iter = m_flowPktIdMap.find (flowId);
+  if (iter != m_flowPktIdMap.end ())
+    {
+      m_flowMap.erase (iter->second.tuple);
+      m_flowPktIdMap.erase (iter);
+    }
+}
+
 void
 Ipv6FlowClassifier::SerializeToXmlStream (std::ostream &os, int indent) const
 {
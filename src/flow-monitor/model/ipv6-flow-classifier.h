@@ -70,14 +70,26 @@ public:
   /// \returns the FiveTuple corresponding to flowId
   FiveTuple FindFlow (FlowId flowId) const;
 
+  /// Forgets the tuple of a flow evicted by the FlowMonitor; the next
+  /// packet with this tuple starts a new flow, with a new FlowId
+  /// \param flowId the FlowId to forget
+  virtual void RemoveFlow (FlowId flowId);
+
   virtual void SerializeToXmlStream (std::ostream &os, int indent) const;
 
 private:
 
   /// Map to Flows Identifiers to FlowIds
   std::map<FiveTuple, FlowId> m_flowMap;
-  /// Map to FlowIds to FlowPacketId
-  std::map<FlowId, FlowPacketId> m_flowPktIdMap;
+  /// Tuple and last FlowPacketId of a flow
+  struct FlowEntry
+  {
+    std::map<FiveTuple, FlowId>::iterator tuple; //!< Entry of the flow in m_flowMap
+    FlowPacketId lastPacketId;                     //!< Last packet identifier
+  };
+
+  /// Map to FlowIds to their tuple and FlowPacketId
+  std::map<FlowId, FlowEntry> m_flowPktIdMap;
 
 };
 
@@ -28,6 +28,8 @@
 #include "ns3/pointer.h"
 #include "ns3/config.h"
 #include "ns3/flow-id-tag.h"
+#include "ns3/tcp-gso-tag.h"
+#include "ns3/tcp-header.h"
 
 namespace ns3 {
 
@@ -100,7 +102,7 @@ public:
 private:
   uint32_t m_flowId;      //!< flow identifier
   uint32_t m_packetId;    //!< packet identifier
-  uint32_t m_packetSize;  //!< packet size
+  uint32_t m_packetSize;  //!< packet size (average size of the segments of a TCP super-segment)
 
 };
 
@@ -255,6 +257,32 @@ Ipv6FlowProbe::DoDispose ()
   FlowProbe::DoDispose ();
 }
 
+/**
+ * \brief Get the number of segments a packet is split into before the device
+ *
+ * A TCP super-segment is split in segments below IP, each one with its own
+ * TCP and IP headers (see TcpGsoTag).
+ *
+ * \param ipPayload the IP payload
+ * \param ipHeaderSize the size of the IP header
+ * \param size the size of the IP packet, set to the total size of the segments
+ * \return the number of segments, 1 if the packet is not a super-segment
+ */
+static uint32_t
+GetGsoSegments (Ptr<const Packet> ipPayload, uint32_t ipHeaderSize, uint32_t &size)
+{
+  TcpGsoTag gsoTag;
+  if (!ipPayload->PeekPacketTag (gsoTag))
+    {
+      return 1;
+    }
+  TcpHeader tcpHeader;
+  ipPayload->PeekHeader (tcpHeader);
+  uint32_t segments = gsoTag.GetSegments ();
+  size += (segments - 1) * (ipHeaderSize + tcpHeader.GetSerializedSize ());
+  return segments;
+}
+
 void
 Ipv6FlowProbe::SendOutgoingLogger (const Ipv6Header &ipHeader, Ptr<const Packet> ipPayload, uint32_t interface)
 {
@@ -264,13 +292,14 @@ Ipv6FlowProbe::SendOutgoingLogger (const Ipv6Header &ipHeader, Ptr<const Packet>
   if (m_classifier->Classify (ipHeader, ipPayload, &flowId, &packetId))
     {
       uint32_t size = (ipPayload->GetSize () + ipHeader.GetSerializedSize ());
-      NS_LOG_DEBUG ("ReportFirstTx ("<<this<<", "<<flowId<<", "<<packetId<<", "<<size<<"); "
+      uint32_t segments = GetGsoSegments (ipPayload, ipHeader.GetSerializedSize (), size);
+      NS_LOG_DEBUG ("ReportFirstTx ("<<this<<", "<<flowId<<", "<<packetId<<", "<<size<<", "<<segments<<"); "
                                      << ipHeader << *ipPayload);
-      m_flowMonitor->ReportFirstTx (this, flowId, packetId, size);
+      m_flowMonitor->ReportFirstTxSegments (this, flowId, packetId, size, segments);
 
       // tag the packet with the flow id and packet id, so that the packet can be identified even
       // when Ipv6Header is not accessible at some non-IPv6 protocol layer
-      Ipv6FlowProbeTag fTag (flowId, packetId, size);
+      Ipv6FlowProbeTag fTag (flowId, packetId, size / segments);
       ipPayload->AddByteTag (fTag);
     }
 }
@@ -340,6 +369,7 @@ Ipv6FlowProbe::DropLogger (const Ipv6Header &ipHeader, Ptr<const Packet> ipPaylo
       FlowPacketId packetId = fTag.GetPacketId ();
 
       uint32_t size = (ipPayload->GetSize () + ipHeader.GetSerializedSize ());
+      uint32_t segments = GetGsoSegments (ipPayload, ipHeader.GetSerializedSize (), size);
       NS_LOG_DEBUG ("Drop ("<<this<<", "<<flowId<<", "<<packetId<<", "<<size<<", " << reason 
                             << ", destIp=" << ipHeader.GetDestinationAddress () << "); "
                             << "HDR: " << ipHeader << " PKT: " << *ipPayload);
@@ -386,7 +416,7 @@ Ipv6FlowProbe::DropLogger (const Ipv6Header &ipHeader, Ptr<const Packet> ipPaylo
           NS_FATAL_ERROR ("Unexpected drop reason code " << reason);
         }
 
-      m_flowMonitor->ReportDrop (this, flowId, packetId, size, myReason);
+      m_flowMonitor->ReportDropSegments (this, flowId, packetId, size, myReason, segments);
     }
 }
 
@@ -424,12 +454,19 @@ Ipv6FlowProbe::QueueDiscDropLogger (Ptr<const QueueItem> item)
 
   FlowId flowId = fTag.GetFlowId ();
   FlowPacketId packetId = fTag.GetPacketId ();
-  uint32_t size = fTag.GetPacketSize ();
+  // queue discs may drop a TCP super-segment, which is not split yet
+  uint32_t segments = 1;
+  TcpGsoTag gsoTag;
+  if (item->GetPacket ()->PeekPacketTag (gsoTag))
+    {
+      segments = gsoTag.GetSegments ();
+    }
+  uint32_t size = fTag.GetPacketSize () * segments;
 
   NS_LOG_DEBUG ("Drop ("<<this<<", "<<flowId<<", "<<packetId<<", "<<size<<", " << DROP_QUEUE_DISC
                         << "); ");
 
-  m_flowMonitor->ReportDrop (this, flowId, packetId, size, DROP_QUEUE_DISC);
+  m_flowMonitor->ReportDropSegments (this, flowId, packetId, size, DROP_QUEUE_DISC, segments);
 }
 
 } // namespace ns3
@@ -0,0 +1,341 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-probe.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * A probe reporting the packets of the test cases
+ */
+class TestFlowProbe : public FlowProbe
+{
+public:
+  /// \param monitor the FlowMonitor
+  TestFlowProbe (Ptr<FlowMonitor> monitor)
+    : FlowProbe (monitor)
+  {
+  }
+};
+
+/**
+ * Check that the packets are declared lost by their timers, without
+ * any call to CheckForLostPackets.
+ */
+class FlowMonitorLossTestCase : public TestCase
+{
+public:
+  FlowMonitorLossTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the number of lost packets of flow 1
+   * \param expected the expected number
+   */
+  void CheckLost (uint32_t expected);
+
+  Ptr<FlowMonitor> m_monitor; //!< The monitor
+};
+
+FlowMonitorLossTestCase::FlowMonitorLossTestCase ()
+  : TestCase ("Check the loss timers of the tracked packets")
+{
+}
+
+void
+FlowMonitorLossTestCase::CheckLost (uint32_t expected)
+{
+  FlowMonitor::FlowStatsContainer stats = m_monitor->GetFlowStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.size (), 1, "Wrong number of flows");
+  NS_TEST_EXPECT_MSG_EQ (stats[1].lostPackets, expected, "Wrong number of lost packets at " << Simulator::Now ().GetSeconds ());
+}
+
+void
+FlowMonitorLossTestCase::DoRun (void)
+{
+  m_monitor = CreateObject<FlowMonitor> ();
+  m_monitor->SetAttribute ("MaxPerHopDelay", TimeValue (Seconds (1)));
+  Ptr<FlowProbe> probe = Create<TestFlowProbe> (m_monitor);
+
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Simulator::Schedule (Seconds (0.1), &FlowMonitor::ReportFirstTx, m_monitor, probe, 1, i, 100);
+    }
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      Simulator::Schedule (Seconds (0.2), &FlowMonitor::ReportLastRx, m_monitor, probe, 1, i, 100);
+    }
+  // the timer of packet 5 runs from its last forwarding
+  Simulator::Schedule (Seconds (0.6), &FlowMonitor::ReportForwarding, m_monitor, probe, 1, 5, 100);
+  Simulator::Schedule (Seconds (1.0), &FlowMonitorLossTestCase::CheckLost, this, 0);
+  Simulator::Schedule (Seconds (1.3), &FlowMonitorLossTestCase::CheckLost, this, 4);
+  Simulator::Schedule (Seconds (1.7), &FlowMonitorLossTestCase::CheckLost, this, 5);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  FlowMonitor::FlowStatsContainer stats = m_monitor->GetFlowStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats[1].txPackets, 10, "Wrong number of transmitted packets");
+  NS_TEST_EXPECT_MSG_EQ (stats[1].rxPackets, 5, "Wrong number of received packets");
+  m_monitor->Dispose ();
+  m_monitor = 0;
+}
+
+/**
+ * Check the periodic export of the flow stats, and the eviction of the
+ * idle flows.
+ */
+class FlowMonitorExportTestCase : public TestCase
+{
+public:
+  FlowMonitorExportTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Send and receive a packet
+   * \param flowId the flow of the packet
+   * \param packetId the packet
+   */
+  void SendPacket (FlowId flowId, uint32_t packetId);
+  /**
+   * Check the flows known to the monitor and to the probe
+   * \param flow1 whether flow 1 should be known
+   */
+  void CheckFlows (bool flow1);
+
+  Ptr<FlowMonitor> m_monitor; //!< The monitor
+  Ptr<FlowProbe> m_probe;     //!< The probe
+};
+
+FlowMonitorExportTestCase::FlowMonitorExportTestCase ()
+  : TestCase ("Check the export of the flow stats and the eviction of the idle flows")
+{
+}
+
+void
+FlowMonitorExportTestCase::SendPacket (FlowId flowId, uint32_t packetId)
+{
+  m_monitor->ReportFirstTx (m_probe, flowId, packetId, 100);
+  m_monitor->ReportLastRx (m_probe, flowId, packetId, 100);
+}
+
+void
+FlowMonitorExportTestCase::CheckFlows (bool flow1)
+{
+  FlowMonitor::FlowStatsContainer stats = m_monitor->GetFlowStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats.count (1), flow1, "Flow 1 not evicted from the monitor");
+  NS_TEST_EXPECT_MSG_EQ (stats.count (2), 1, "Flow 2 evicted from the monitor");
+  FlowProbe::Stats probeStats = m_probe->GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (probeStats.count (1), flow1, "Flow 1 not evicted from the probe");
+  NS_TEST_EXPECT_MSG_EQ (probeStats.count (2), 1, "Flow 2 evicted from the probe");
+}
+
+void
+FlowMonitorExportTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("flow-stats.csv");
+  m_monitor = CreateObject<FlowMonitor> ();
+  m_monitor->SetAttribute ("MaxPerHopDelay", TimeValue (Seconds (0.5)));
+  m_monitor->SetAttribute ("ExportFile", StringValue (filename));
+  m_monitor->SetAttribute ("ExportInterval", TimeValue (Seconds (1)));
+  m_monitor->SetAttribute ("FlowIdleTimeout", TimeValue (Seconds (2)));
+  m_probe = Create<TestFlowProbe> (m_monitor);
+
+  Simulator::Schedule (Seconds (0.1), &FlowMonitorExportTestCase::SendPacket, this, 1, 0);
+  for (uint32_t i = 0; i < 9; i++)
+    {
+      Simulator::Schedule (Seconds (0.1 + 0.5 * i), &FlowMonitorExportTestCase::SendPacket, this, 2, i);
+    }
+  Simulator::Schedule (Seconds (2.0), &FlowMonitorExportTestCase::CheckFlows, this, true);
+  Simulator::Schedule (Seconds (2.2), &FlowMonitorExportTestCase::CheckFlows, this, false);
+  Simulator::Stop (Seconds (5.5));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::ifstream is (filename.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (is.is_open (), true, "Unable to read " << filename);
+  std::string line;
+  std::getline (is, line);
+  NS_TEST_EXPECT_MSG_EQ (line.substr (0, 12), "time,flowId,", "Wrong header");
+  std::vector<std::string> flow1;
+  std::vector<std::string> flow2;
+  while (std::getline (is, line))
+    {
+      std::istringstream fields (line);
+      std::string time;
+      std::string flowId;
+      std::getline (fields, time, ',');
+      std::getline (fields, flowId, ',');
+      if (flowId == "1")
+        {
+          flow1.push_back (line);
+        }
+      else
+        {
+          NS_TEST_EXPECT_MSG_EQ (flowId, "2", "Unknown flow");
+          flow2.push_back (line);
+        }
+    }
+  // flow 1 is exported at 1 s, then evicted at 2.1 s
+  NS_TEST_ASSERT_MSG_EQ (flow1.size (), 2, "Wrong number of records of flow 1");
+  NS_TEST_EXPECT_MSG_EQ (flow1[0].substr (0, 13), "1000000000,1,", "Wrong first record of flow 1");
+  NS_TEST_EXPECT_MSG_EQ (flow1[1].substr (0, 13), "2100000000,1,", "Wrong last record of flow 1");
+  NS_TEST_EXPECT_MSG_EQ (flow1[1].substr (flow1[1].size () - 10), ",1,1,0,0,1", "Wrong stats of flow 1");
+  // flow 2 is exported at 1, 2, 3, 4, 5 s, and at the end
+  NS_TEST_EXPECT_MSG_EQ (flow2.size (), 5, "Wrong number of records of flow 2");
+  NS_TEST_EXPECT_MSG_EQ (flow2.back ().substr (flow2.back ().size () - 10), ",9,9,0,0,0", "Wrong stats of flow 2");
+
+  m_monitor->Dispose ();
+  m_monitor = 0;
+  m_probe = 0;
+  std::remove (filename.c_str ());
+}
+
+/**
+ * Check that the tuples of the evicted flows are removed from the
+ * classifier, and that a returning tuple starts a new flow.
+ */
+class FlowMonitorClassifierEvictionTestCase : public TestCase
+{
+public:
+  FlowMonitorClassifierEvictionTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Classify, send and receive a packet
+   * \param sourcePort the source port of the packet
+   * \param flowId the expected FlowId
+   * \param packetId the expected packet identifier
+   */
+  void SendPacket (uint16_t sourcePort, FlowId flowId, uint32_t packetId);
+  /**
+   * Check the number of tuples known to the classifier
+   * \param expected the expected number
+   */
+  void CheckTuples (uint32_t expected);
+
+  Ptr<FlowMonitor> m_monitor;             //!< The monitor
+  Ptr<FlowProbe> m_probe;                 //!< The probe
+  Ptr<Ipv4FlowClassifier> m_classifier;   //!< The classifier
+};
+
+FlowMonitorClassifierEvictionTestCase::FlowMonitorClassifierEvictionTestCase ()
+  : TestCase ("Check the eviction of the idle flows from the classifier")
+{
+}
+
+void
+FlowMonitorClassifierEvictionTestCase::SendPacket (uint16_t sourcePort, FlowId flowId, uint32_t packetId)
+{
+  Ipv4Header ipHeader;
+  ipHeader.SetSource (Ipv4Address ("10.1.1.1"));
+  ipHeader.SetDestination (Ipv4Address ("10.1.1.2"));
+  ipHeader.SetProtocol (17);
+  // the ports are read from the first four bytes of the payload
+  uint8_t ports[4] = { (uint8_t) (sourcePort >> 8), (uint8_t) sourcePort, 0x00, 0x09 };
+  Ptr<Packet> payload = Create<Packet> (ports, 4);
+
+  FlowId outFlowId;
+  uint32_t outPacketId;
+  bool classified = m_classifier->Classify (ipHeader, payload, &outFlowId, &outPacketId);
+  NS_TEST_ASSERT_MSG_EQ (classified, true, "Packet not classified");
+  NS_TEST_EXPECT_MSG_EQ (outFlowId, flowId, "Wrong FlowId at " << Simulator::Now ().GetSeconds ());
+  NS_TEST_EXPECT_MSG_EQ (outPacketId, packetId, "Wrong packet identifier at " << Simulator::Now ().GetSeconds ());
+  NS_TEST_EXPECT_MSG_EQ (m_classifier->FindFlow (outFlowId).sourcePort, sourcePort, "Wrong tuple of the flow");
+  m_monitor->ReportFirstTx (m_probe, outFlowId, outPacketId, 100);
+  m_monitor->ReportLastRx (m_probe, outFlowId, outPacketId, 100);
+}
+
+void
+FlowMonitorClassifierEvictionTestCase::CheckTuples (uint32_t expected)
+{
+  std::ostringstream os;
+  m_classifier->SerializeToXmlStream (os, 0);
+  std::string xml = os.str ();
+  uint32_t tuples = 0;
+  for (std::string::size_type pos = xml.find ("<Flow "); pos != std::string::npos;
+       pos = xml.find ("<Flow ", pos + 1))
+    {
+      tuples++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (tuples, expected, "Wrong number of tuples at " << Simulator::Now ().GetSeconds ());
+}
+
+void
+FlowMonitorClassifierEvictionTestCase::DoRun (void)
+{
+  m_monitor = CreateObject<FlowMonitor> ();
+  m_monitor->SetAttribute ("MaxPerHopDelay", TimeValue (Seconds (0.5)));
+  m_monitor->SetAttribute ("FlowIdleTimeout", TimeValue (Seconds (1)));
+  m_probe = Create<TestFlowProbe> (m_monitor);
+  m_classifier = Create<Ipv4FlowClassifier> ();
+  m_monitor->AddFlowClassifier (m_classifier);
+
+  // port 1000 is idle from 0.2 s, and evicted at 1.2 s; port 2000 stays active
+  Simulator::Schedule (Seconds (0.1), &FlowMonitorClassifierEvictionTestCase::SendPacket, this, 1000, 1, 0);
+  Simulator::Schedule (Seconds (0.2), &FlowMonitorClassifierEvictionTestCase::SendPacket, this, 1000, 1, 1);
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      Simulator::Schedule (Seconds (0.15 + 0.5 * i), &FlowMonitorClassifierEvictionTestCase::SendPacket, this, 2000, 2, i);
+    }
+  Simulator::Schedule (Seconds (1.1), &FlowMonitorClassifierEvictionTestCase::CheckTuples, this, 2);
+  Simulator::Schedule (Seconds (1.3), &FlowMonitorClassifierEvictionTestCase::CheckTuples, this, 1);
+  // the returning tuple is a new flow
+  Simulator::Schedule (Seconds (1.5), &FlowMonitorClassifierEvictionTestCase::SendPacket, this, 1000, 3, 0);
+  Simulator::Schedule (Seconds (1.6), &FlowMonitorClassifierEvictionTestCase::CheckTuples, this, 2);
+  Simulator::Stop (Seconds (2.4));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  FlowMonitor::FlowStatsContainer stats = m_monitor->GetFlowStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats.count (1), 0, "Flow 1 not evicted from the monitor");
+  NS_TEST_EXPECT_MSG_EQ (stats[2].rxPackets, 5, "Wrong number of received packets of flow 2");
+  NS_TEST_EXPECT_MSG_EQ (stats[3].rxPackets, 1, "Wrong number of received packets of flow 3");
+
+  m_monitor->Dispose ();
+  m_monitor = 0;
+  m_probe = 0;
+  m_classifier = 0;
+}
+
+/**
+ * FlowMonitor test suite
+ */
+static class FlowMonitorTestSuite : public TestSuite
+{
+public:
+  FlowMonitorTestSuite ()
+    : TestSuite ("flow-monitor", UNIT)
+  {
+    AddTestCase (new FlowMonitorLossTestCase (), TestCase::QUICK);
+    AddTestCase (new FlowMonitorExportTestCase (), TestCase::QUICK);
+    AddTestCase (new FlowMonitorClassifierEvictionTestCase (), TestCase::QUICK);
+  }
+} g_FlowMonitorTestSuite;
@@ -0,0 +1,164 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// A single broadcast LAN of many hosts, each one sending small UDP
+// datagrams to random peers, over IPv4 (ARP) and/or IPv6 (Neighbor
+// Discovery). The program reports the number of events scheduled by the
+// simulator and the wall-clock time of the run, to measure the cost of
+// the neighbor caches' timers.
+//
+// Usage examples:
+//   ./waf --run "neighbor-cache-events"
+//   ./waf --run "neighbor-cache-events --hosts=200 --ipv4=0"
+
+#include <iostream>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/system-wall-clock-ms.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("NeighborCacheEvents");
+
+static void
+Nothing (void)
+{
+}
+
+/*
+ * Event identifiers are allocated sequentially by the simulator: the uid of
+ * an event scheduled at the end of the run is the number of events scheduled
+ * so far.
+ */
+static void
+RecordEventCount (uint64_t *count)
+{
+  *count = Simulator::ScheduleNow (&Nothing).GetUid ();
+}
+
+static uint64_t g_received = 0;
+
+static void
+Drain (Ptr<Socket> socket)
+{
+  while (socket->Recv ())
+    {
+      ++g_received;
+    }
+}
+
+static void
+SendToRandomPeer (Ptr<Socket> socket, std::vector<Address> *peers,
+                  Ptr<UniformRandomVariable> random, Time interval)
+{
+  uint32_t peer = random->GetInteger (0, peers->size () - 1);
+  socket->SendTo (Create<Packet> (64), 0, (*peers)[peer]);
+  Simulator::Schedule (interval, &SendToRandomPeer, socket, peers, random, interval);
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t hosts = 50;
+  bool ipv4 = true;
+  bool ipv6 = true;
+  double interval = 0.05;
+  double duration = 30;
+
+  CommandLine cmd;
+  cmd.AddValue ("hosts", "Number of hosts on the LAN", hosts);
+  cmd.AddValue ("ipv4", "Send IPv4 traffic", ipv4);
+  cmd.AddValue ("ipv6", "Send IPv6 traffic", ipv6);
+  cmd.AddValue ("interval", "Interval between two datagrams of a host, in seconds", interval);
+  cmd.AddValue ("duration", "Simulated time, in seconds", duration);
+  cmd.Parse (argc, argv);
+
+  NodeContainer nodes;
+  nodes.Create (hosts);
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  NetDeviceContainer devices;
+  for (uint32_t i = 0; i < hosts; ++i)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      device->SetChannel (channel);
+      nodes.Get (i)->AddDevice (device);
+      devices.Add (device);
+    }
+
+  InternetStackHelper stack;
+  stack.Install (nodes);
+
+  Ipv4AddressHelper ipv4Address;
+  ipv4Address.SetBase ("10.0.0.0", "255.255.0.0");
+  Ipv4InterfaceContainer ipv4Interfaces = ipv4Address.Assign (devices);
+  Ipv6AddressHelper ipv6Address;
+  ipv6Address.SetBase (Ipv6Address ("2001:db8::"), Ipv6Prefix (64));
+  Ipv6InterfaceContainer ipv6Interfaces = ipv6Address.Assign (devices);
+
+  uint16_t port = 9;
+  std::vector<Address> peers;
+  for (uint32_t i = 0; i < hosts; ++i)
+    {
+      if (ipv4)
+        {
+          peers.push_back (InetSocketAddress (ipv4Interfaces.GetAddress (i), port));
+        }
+      if (ipv6)
+        {
+          peers.push_back (Inet6SocketAddress (ipv6Interfaces.GetAddress (i, 1), port));
+        }
+    }
+
+  TypeId tid = TypeId::LookupByName ("ns3::UdpSocketFactory");
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  for (uint32_t i = 0; i < hosts; ++i)
+    {
+      if (ipv4)
+        {
+          Ptr<Socket> sink = Socket::CreateSocket (nodes.Get (i), tid);
+          sink->Bind (InetSocketAddress (Ipv4Address::GetAny (), port));
+          sink->SetRecvCallback (MakeCallback (&Drain));
+        }
+      if (ipv6)
+        {
+          Ptr<Socket> sink = Socket::CreateSocket (nodes.Get (i), tid);
+          sink->Bind (Inet6SocketAddress (Ipv6Address::GetAny (), port));
+          sink->SetRecvCallback (MakeCallback (&Drain));
+        }
+      Ptr<Socket> source = Socket::CreateSocket (nodes.Get (i), tid);
+      // Wait for the IPv6 Duplicate Address Detection to complete
+      Time start = Seconds (2) + Seconds (random->GetValue (0, interval));
+      Simulator::Schedule (start, &SendToRandomPeer, source, &peers, random, Seconds (interval));
+    }
+
+  uint64_t events = 0;
+  Simulator::Schedule (Seconds (duration), &RecordEventCount, &events);
+  Simulator::Stop (Seconds (duration));
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  uint64_t wallMs = clock.End ();
+  Simulator::Destroy ();
+
+  std::cout << "hosts " << hosts << " ipv4 " << ipv4 << " ipv6 " << ipv6
+            << " received " << g_received
+            << " events " << events << " wall(ms) " << wallMs << std::endl;
+  return 0;
+}
@@ -49,6 +49,7 @@
 #include "ns3/traffic-control-layer.h"
 #include <limits>
 #include <map>
+#include <sstream>
 
 namespace ns3 {
 
@@ -64,6 +65,24 @@ NS_LOG_COMPONENT_DEFINE ("InternetStackHelper");
 //
 #define INTERFACE_CONTEXT
 
+/**
+ * \brief Build the context written to the ascii traces by the sinks with context
+ * \param context the trace context
+ * \param interface the interface of the event
+ * \returns the context, followed by the interface if INTERFACE_CONTEXT is defined
+ */
+static std::string
+GetInterfaceContext (std::string const &context, uint32_t interface)
+{
+#ifdef INTERFACE_CONTEXT
+  std::ostringstream oss;
+  oss << context << "(" << interface << ")";
+  return oss.str ();
+#else
+  return context;
+#endif
+}
+
 //
 // Things are going to work differently here with respect to trace file handling
 // than in most places because the Tx and Rx trace sources we are interested in
@@ -589,7 +608,10 @@ Ipv4L3ProtocolDropSinkWithoutContext (
 
   Ptr<Packet> p = packet->Copy ();
   p->AddHeader (header);
-  *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+  if (!AsciiTraceHelper::WriteBinaryEvent (stream, 'd', std::string (), p))
+    {
+      *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+    }
 }
 
 /**
@@ -613,7 +635,10 @@ Ipv4L3ProtocolTxSinkWithoutContext (
       return;
     }
 
-  *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << *packet << std::endl;
+  if (!AsciiTraceHelper::WriteBinaryEvent (stream, 't', std::string (), packet))
+    {
+      *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << *packet << std::endl;
+    }
 }
 
 /**
@@ -637,7 +662,10 @@ Ipv4L3ProtocolRxSinkWithoutContext (
       return;
     }
 
-  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *packet << std::endl;
+  if (!AsciiTraceHelper::WriteBinaryEvent (stream, 'r', std::string (), packet))
+    {
+      *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *packet << std::endl;
+    }
 }
 
 /**
@@ -675,12 +703,11 @@ Ipv4L3ProtocolDropSinkWithContext (
 
   Ptr<Packet> p = packet->Copy ();
   p->AddHeader (header);
-#ifdef INTERFACE_CONTEXT
-  *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << "(" << interface << ") " 
-                        << *p << std::endl;
-#else
-  *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << " "  << *p << std::endl;
-#endif
+  std::string fullContext = GetInterfaceContext (context, interface);
+  if (!AsciiTraceHelper::WriteBinaryEvent (stream, 'd', fullContext, p))
+    {
+      *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << fullContext << " " << *p << std::endl;
+    }
 }
 
 /**
@@ -706,12 +733,11 @@ Ipv4L3ProtocolTxSinkWithContext (
       return;
     }
 
-#ifdef INTERFACE_CONTEXT
-  *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << context << "(" << interface << ") " 
-                        << *packet << std::endl;
-#else
-  *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << context << " "  << *packet << std::endl;
-#endif
+  std::string fullContext = GetInterfaceContext (context, interface);
+  if (!AsciiTraceHelper::WriteBinaryEvent (stream, 't', fullContext, packet))
+    {
+      *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << fullContext << " " << *packet << std::endl;
+    }
 }
 
 /**
@@ -737,12 +763,11 @@ Ipv4L3ProtocolRxSinkWithContext (
       return;
     }
 
-#ifdef INTERFACE_CONTEXT
-  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << "(" << interface << ") " 
-                        << *packet << std::endl;
-#else
-  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " "  << *packet << std::endl;
-#endif
+  std::string fullContext = GetInterfaceContext (context, interface);
+  if (!AsciiTraceHelper::WriteBinaryEvent (stream, 'r', fullContext, packet))
+    {
+      *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << fullContext << " " << *packet << std::endl;
+    }
 }
 
 bool
@@ -927,7 +952,10 @@ Ipv6L3ProtocolDropSinkWithoutContext (
 
   Ptr<Packet> p = packet->Copy ();
   p->AddHeader (header);
-  *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+  if (!AsciiTraceHelper::WriteBinaryEvent (stream, 'd', std::string (), p))
+    {
+      *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+    }
 }
 
 /**
@@ -951,7 +979,10 @@ Ipv6L3ProtocolTxSinkWithoutContext (
       return;
     }
 
-  *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << *packet << std::endl;
+  if (!AsciiTraceHelper::WriteBinaryEvent (stream, 't', std::string (), packet))
+    {
+      *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << *packet << std::endl;
+    }
 }
 
 /**
@@ -975,7 +1006,10 @@ Ipv6L3ProtocolRxSinkWithoutContext (
       return;
     }
 
-  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *packet << std::endl;
+  if (!AsciiTraceHelper::WriteBinaryEvent (stream, 'r', std::string (), packet))
+    {
+      *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *packet << std::endl;
+    }
 }
 
 /**
@@ -1013,12 +1047,11 @@ Ipv6L3ProtocolDropSinkWithContext (
 
   Ptr<Packet> p = packet->Copy ();
   p->AddHeader (header);
-#ifdef INTERFACE_CONTEXT
-  *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << "(" << interface << ") " 
-                        << *p << std::endl;
-#else
-  *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
-#endif
+  std::string fullContext = GetInterfaceContext (context, interface);
+  if (!AsciiTraceHelper::WriteBinaryEvent (stream, 'd', fullContext, p))
+    {
+      *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << fullContext << " " << *p << std::endl;
+    }
 }
 
 /**
@@ -1044,12 +1077,11 @@ Ipv6L3ProtocolTxSinkWithContext (
       return;
     }
 
-#ifdef INTERFACE_CONTEXT
-  *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << context << "(" << interface << ") " 
-                        << *packet << std::endl;
-#else
-  *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << context << " " << *packet << std::endl;
-#endif
+  std::string fullContext = GetInterfaceContext (context, interface);
+  if (!AsciiTraceHelper::WriteBinaryEvent (stream, 't', fullContext, packet))
+    {
+      *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << fullContext << " " << *packet << std::endl;
+    }
 }
 
 /**
@@ -1075,12 +1107,11 @@ Ipv6L3ProtocolRxSinkWithContext (
       return;
     }
 
-#ifdef INTERFACE_CONTEXT
-  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << "(" << interface << ") " 
-                        << *packet << std::endl;
-#else
-  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *packet << std::endl;
-#endif
+  std::string fullContext = GetInterfaceContext (context, interface);
+  if (!AsciiTraceHelper::WriteBinaryEvent (stream, 'r', fullContext, packet))
+    {
+      *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << fullContext << " " << *packet << std::endl;
+    }
 }
 
 bool
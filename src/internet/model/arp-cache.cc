@@ -57,8 +57,7 @@ ArpCache::GetTypeId (void)
                    MakeTimeChecker ())
     .AddAttribute ("WaitReplyTimeout",
                    "When this timeout expires, "
-                   "the cache entries will be scanned and "
-                   "entries in WaitReply state will resend ArpRequest "
+                   "an entry in WaitReply state will resend ArpRequest "
                    "unless MaxRetries has been exceeded, "
                    "in which case the entry is marked dead",
                    TimeValue (Seconds (1)),
@@ -103,10 +102,7 @@ ArpCache::DoDispose (void)
   Flush ();
   m_device = 0;
   m_interface = 0;
-  if (!m_waitReplyTimer.IsRunning ())
-    {
-      Simulator::Remove (m_waitReplyTimer);
-    }
+  m_timerWheel = 0;
   Object::DoDispose ();
 }
 
@@ -116,6 +112,26 @@ ArpCache::SetDevice (Ptr<NetDevice> device, Ptr<Ipv4Interface> interface)
   NS_LOG_FUNCTION (this << device << interface);
   m_device = device;
   m_interface = interface;
+  Ptr<Node> node = device->GetNode ();
+  if (node != 0)
+    {
+      m_timerWheel = node->GetObject<TimerWheel> ();
+      if (m_timerWheel == 0)
+        {
+          m_timerWheel = CreateObject<TimerWheel> ();
+          node->AggregateObject (m_timerWheel);
+        }
+    }
+}
+
+Ptr<TimerWheel>
+ArpCache::GetTimerWheel (void)
+{
+  if (m_timerWheel == 0)
+    {
+      m_timerWheel = CreateObject<TimerWheel> ();
+    }
+  return m_timerWheel;
 }
 
 Ptr<NetDevice>
@@ -179,64 +195,51 @@ ArpCache::SetArpRequestCallback (Callback<void, Ptr<const ArpCache>,
 }
 
 void 
-ArpCache::StartWaitReplyTimer (void)
+ArpCache::StartWaitReplyTimer (ArpCache::Entry *entry)
 {
-  NS_LOG_FUNCTION (this);
-  if (!m_waitReplyTimer.IsRunning ())
-    {
-      NS_LOG_LOGIC ("Starting WaitReplyTimer at " << Simulator::Now () << " for " <<
-                    m_waitReplyTimeout);
-      m_waitReplyTimer = Simulator::Schedule (m_waitReplyTimeout, 
-                                              &ArpCache::HandleWaitReplyTimeout, this);
-    }
+  NS_LOG_FUNCTION (this << entry);
+  NS_LOG_LOGIC ("Starting WaitReplyTimer at " << Simulator::Now () << " for " <<
+                m_waitReplyTimeout);
+  Ptr<TimerWheel> wheel = GetTimerWheel ();
+  wheel->Cancel (entry->m_waitReplyTimer);
+  entry->m_waitReplyTimer = wheel->Schedule (m_waitReplyTimeout,
+                                             MakeCallback (&ArpCache::HandleWaitReplyTimeout, this).Bind (entry));
 }
 
 void
-ArpCache::HandleWaitReplyTimeout (void)
+ArpCache::HandleWaitReplyTimeout (ArpCache::Entry *entry)
 {
-  NS_LOG_FUNCTION (this);
-  ArpCache::Entry* entry;
-  bool restartWaitReplyTimer = false;
-  for (CacheI i = m_arpCache.begin (); i != m_arpCache.end (); i++) 
+  NS_LOG_FUNCTION (this << entry);
+  if (!entry->IsWaitReply ())
     {
-      entry = (*i).second;
-      if (entry != 0 && entry->IsWaitReply ())
-        {
-          if (entry->GetRetries () < m_maxRetries)
-            {
-              NS_LOG_LOGIC ("node="<< m_device->GetNode ()->GetId () <<
-                            ", ArpWaitTimeout for " << entry->GetIpv4Address () <<
-                            " expired -- retransmitting arp request since retries = " <<
-                            entry->GetRetries ());
-              m_arpRequestCallback (this, entry->GetIpv4Address ());
-              restartWaitReplyTimer = true;
-              entry->IncrementRetries ();
-            }
-          else
-            {
-              NS_LOG_LOGIC ("node="<<m_device->GetNode ()->GetId () <<
-                            ", wait reply for " << entry->GetIpv4Address () <<
-                            " expired -- drop since max retries exceeded: " <<
-                            entry->GetRetries ());
-              entry->MarkDead ();
-              entry->ClearRetries ();
-              Ipv4PayloadHeaderPair pending = entry->DequeuePending ();
-              while (pending.first != 0)
-                {
-                  // add the Ipv4 header for tracing purposes
-                  pending.first->AddHeader (pending.second);
-                  m_dropTrace (pending.first);
-                  pending = entry->DequeuePending ();
-                }
-            }
-        }
-
+      return;
     }
-  if (restartWaitReplyTimer)
+  if (entry->GetRetries () < m_maxRetries)
     {
-      NS_LOG_LOGIC ("Restarting WaitReplyTimer at " << Simulator::Now ().GetSeconds ());
-      m_waitReplyTimer = Simulator::Schedule (m_waitReplyTimeout, 
-                                              &ArpCache::HandleWaitReplyTimeout, this);
+      NS_LOG_LOGIC ("node="<< m_device->GetNode ()->GetId () <<
+                    ", ArpWaitTimeout for " << entry->GetIpv4Address () <<
+                    " expired -- retransmitting arp request since retries = " <<
+                    entry->GetRetries ());
+      m_arpRequestCallback (this, entry->GetIpv4Address ());
+      entry->IncrementRetries ();
+      StartWaitReplyTimer (entry);
+    }
+  else
+    {
+      NS_LOG_LOGIC ("node="<<m_device->GetNode ()->GetId () <<
+                    ", wait reply for " << entry->GetIpv4Address () <<
+                    " expired -- drop since max retries exceeded: " <<
+                    entry->GetRetries ());
+      entry->MarkDead ();
+      entry->ClearRetries ();
+      Ipv4PayloadHeaderPair pending = entry->DequeuePending ();
+      while (pending.first != 0)
+        {
+          // add the Ipv4 header for tracing purposes
+          pending.first->AddHeader (pending.second);
+          m_dropTrace (pending.first);
+          pending = entry->DequeuePending ();
+        }
     }
 }
 
@@ -248,12 +251,7 @@ ArpCache::Flush (void)
     {
       delete (*i).second;
     }
-  m_arpCache.erase (m_arpCache.begin (), m_arpCache.end ());
-  if (m_waitReplyTimer.IsRunning ())
-    {
-      NS_LOG_LOGIC ("Stopping WaitReplyTimer at " << Simulator::Now ().GetSeconds () << " due to ArpCache flush");
-      m_waitReplyTimer.Cancel ();
-    }
+  m_arpCache.clear ();
 }
 
 void
@@ -318,10 +316,10 @@ ArpCache::Entry *
 ArpCache::Lookup (Ipv4Address to)
 {
   NS_LOG_FUNCTION (this << to);
-  if (m_arpCache.find (to) != m_arpCache.end ()) 
+  CacheI it = m_arpCache.find (to);
+  if (it != m_arpCache.end ())
     {
-      ArpCache::Entry *entry = m_arpCache[to];
-      return entry;
+      return it->second;
     }
   return 0;
 }
@@ -342,16 +340,14 @@ void
 ArpCache::Remove (ArpCache::Entry *entry)
 {
   NS_LOG_FUNCTION (this << entry);
-  
-  for (CacheI i = m_arpCache.begin (); i != m_arpCache.end (); i++)
+
+  CacheI i = m_arpCache.find (entry->GetIpv4Address ());
+  if (i != m_arpCache.end () && (*i).second == entry)
     {
-      if ((*i).second == entry)
-        {
-          m_arpCache.erase (i);
-          entry->ClearPendingPacket (); //clear the pending packets for entry's ipaddress
-          delete entry;
-          return;
-        }
+      m_arpCache.erase (i);
+      entry->ClearPendingPacket (); //clear the pending packets for entry's ipaddress
+      delete entry;
+      return;
     }
   NS_LOG_WARN ("Entry not found in this ARP Cache");
 }
@@ -359,11 +355,18 @@ ArpCache::Remove (ArpCache::Entry *entry)
 ArpCache::Entry::Entry (ArpCache *arp)
   : m_arp (arp),
     m_state (ALIVE),
-    m_retries (0)
+    m_retries (0),
+    m_waitReplyTimer (0)
 {
   NS_LOG_FUNCTION (this << arp);
 }
 
+ArpCache::Entry::~Entry ()
+{
+  NS_LOG_FUNCTION (this);
+  CancelWaitReplyTimer ();
+}
+
 
 bool 
 ArpCache::Entry::IsDead (void)
@@ -397,6 +400,7 @@ ArpCache::Entry::MarkDead (void)
   NS_LOG_FUNCTION (this);
   NS_ASSERT (m_state == ALIVE || m_state == WAIT_REPLY || m_state == DEAD);
   m_state = DEAD;
+  CancelWaitReplyTimer ();
   ClearRetries ();
   UpdateSeen ();
 }
@@ -407,6 +411,7 @@ ArpCache::Entry::MarkAlive (Address macAddress)
   NS_ASSERT (m_state == WAIT_REPLY);
   m_macAddress = macAddress;
   m_state = ALIVE;
+  CancelWaitReplyTimer ();
   ClearRetries ();
   UpdateSeen ();
 }
@@ -417,6 +422,7 @@ ArpCache::Entry::MarkPermanent (void)
   NS_ASSERT (!m_macAddress.IsInvalid ());
 
   m_state = PERMANENT;
+  CancelWaitReplyTimer ();
   ClearRetries ();
   UpdateSeen ();
 }
@@ -447,7 +453,7 @@ ArpCache::Entry::MarkWaitReply (Ipv4PayloadHeaderPair waiting)
   m_state = WAIT_REPLY;
   m_pending.push_back (waiting);
   UpdateSeen ();
-  m_arp->StartWaitReplyTimer ();
+  m_arp->StartWaitReplyTimer (this);
 }
 
 Address
@@ -493,6 +499,15 @@ ArpCache::Entry::GetTimeout (void) const
       /* NOTREACHED */
     }
 }
+void
+ArpCache::Entry::CancelWaitReplyTimer (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_arp->m_timerWheel != 0)
+    {
+      m_arp->m_timerWheel->Cancel (m_waitReplyTimer);
+    }
+}
 bool 
 ArpCache::Entry::IsExpired (void) const
 {
@@ -534,6 +549,15 @@ ArpCache::Entry::UpdateSeen (void)
   NS_LOG_FUNCTION (this);
   m_lastSeen = Simulator::Now ();
 }
+void
+ArpCache::Entry::UpdateSeen (Time seen)
+{
+  NS_LOG_FUNCTION (this << seen);
+  if (seen > m_lastSeen)
+    {
+      m_lastSeen = seen;
+    }
+}
 uint32_t
 ArpCache::Entry::GetRetries (void) const
 {
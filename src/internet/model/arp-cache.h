@@ -32,7 +32,8 @@
 #include "ns3/ptr.h"
 #include "ns3/object.h"
 #include "ns3/traced-callback.h"
-#include "ns3/sgi-hashmap.h"
+#include "ns3/timer-wheel.h"
+#include "ns3/open-hash-map.h"
 #include "ns3/output-stream-wrapper.h"
 
 namespace ns3 {
@@ -135,11 +136,12 @@ public:
   void SetArpRequestCallback (Callback<void, Ptr<const ArpCache>, 
                                        Ipv4Address> arpRequestCallback);
   /**
-   * This method will schedule a timeout at WaitReplyTimeout interval
-   * in the future, unless a timer is already running for the cache,
-   * in which case this method does nothing.
+   * This method will schedule a timeout for an entry at WaitReplyTimeout
+   * interval in the future, replacing the entry's pending timeout if any.
+   *
+   * \param entry the entry waiting for a reply
    */
-  void StartWaitReplyTimer (void);
+  void StartWaitReplyTimer (ArpCache::Entry *entry);
   /**
    * \brief Do lookup in the ARP cache against an IP address
    * \param destination The destination IPv4 address to lookup the MAC address
@@ -190,6 +192,7 @@ public:
      * \param arp The ArpCache this entry belongs to
      */
     Entry (ArpCache *arp);
+    ~Entry ();
 
     /**
      * \brief Changes the state of this entry to dead
@@ -281,6 +284,13 @@ public:
      */
     void UpdateSeen (void);
 
+    /**
+     * \brief Update the entry when seeing a packet received earlier, e.g.,
+     * held by the receive coalescing of the device
+     * \param seen the time the packet has been received
+     */
+    void UpdateSeen (Time seen);
+
 private:
     /**
      * \brief ARP cache entry states
@@ -297,6 +307,10 @@ private:
      * \returns the entry timeout
      */
     Time GetTimeout (void) const;
+    /**
+     * \brief Cancel the WaitReply timeout of the entry, if any
+     */
+    void CancelWaitReplyTimer (void);
 
     ArpCache *m_arp; //!< pointer to the ARP cache owning the entry
     ArpCacheEntryState_e m_state; //!< state of the entry
@@ -305,35 +319,50 @@ private:
     Ipv4Address m_ipv4Address; //!< entry's IP address
     std::list<Ipv4PayloadHeaderPair> m_pending; //!< list of pending packets for the entry's IP
     uint32_t m_retries; //!< rerty counter
+    TimerWheel::TimerId m_waitReplyTimer; //!< WaitReply timeout of the entry
+
+    friend class ArpCache;
   };
 
 private:
   /**
    * \brief ARP Cache container
    */
-  typedef sgi::hash_map<Ipv4Address, ArpCache::Entry *, Ipv4AddressHash> Cache;
+  typedef OpenHashMap<Ipv4Address, ArpCache::Entry *, Ipv4AddressHash> Cache;
   /**
    * \brief ARP Cache container iterator
    */
-  typedef sgi::hash_map<Ipv4Address, ArpCache::Entry *, Ipv4AddressHash>::iterator CacheI;
+  typedef OpenHashMap<Ipv4Address, ArpCache::Entry *, Ipv4AddressHash>::iterator CacheI;
 
   virtual void DoDispose (void);
 
+  /**
+   * \brief Get the timer wheel of the entries' timeouts
+   *
+   * The wheel is shared by all the neighbor caches of the node, and is
+   * created on first use if the node has none.
+   *
+   * \returns the timer wheel
+   */
+  Ptr<TimerWheel> GetTimerWheel (void);
+
   Ptr<NetDevice> m_device; //!< NetDevice associated with the cache
   Ptr<Ipv4Interface> m_interface; //!< Ipv4Interface associated with the cache
   Time m_aliveTimeout; //!< cache alive state timeout
   Time m_deadTimeout; //!< cache dead state timeout
   Time m_waitReplyTimeout; //!< cache reply state timeout
-  EventId m_waitReplyTimer;  //!< cache alive state timer
+  Ptr<TimerWheel> m_timerWheel; //!< wheel of the WaitReply timeouts
   Callback<void, Ptr<const ArpCache>, Ipv4Address> m_arpRequestCallback;  //!< reply timeout callback
   uint32_t m_maxRetries; //!< max retries for a resolution
 
   /**
-   * This function is an event handler for the event that the
-   * ArpCache wants to check whether it must retry any Arp requests.
-   * If there are no Arp requests pending, this event is not scheduled.
+   * This function is an event handler for the event that an entry
+   * waiting for a reply timed out: the ArpCache retries the Arp request,
+   * or marks the entry dead if it already retried MaxRetries times.
+   *
+   * \param entry the entry
    */
-  void HandleWaitReplyTimeout (void);
+  void HandleWaitReplyTimeout (ArpCache::Entry *entry);
   uint32_t m_pendingQueueSize; //!< number of packets waiting for a resolution
   Cache m_arpCache; //!< the ARP cache
   TracedCallback<Ptr<const Packet> > m_dropTrace; //!< trace for packets dropped by the ARP cache queue
@@ -24,6 +24,7 @@
 #include "ipv4-queue-disc-item.h"
 #include "arp-l3-protocol.h"
 #include "arp-cache.h"
+#include "tcp-gso-tag.h"
 #include "ns3/net-device.h"
 #include "ns3/log.h"
 #include "ns3/packet.h"
@@ -223,6 +224,9 @@ Ipv4Interface::Send (Ptr<Packet> p, const Ipv4Header & hdr, Ipv4Address dest)
     {
       /// \todo additional checks needed here (such as whether multicast
       /// goes to loopback)?
+      // As on Linux, TCP super-segments are delivered whole on loopback
+      TcpGsoTag gsoTag;
+      p->RemovePacketTag (gsoTag);
       p->AddHeader (hdr);
       m_device->Send (p, m_device->GetBroadcast (), Ipv4L3Protocol::PROT_NUMBER);
       return;
@@ -235,6 +239,8 @@ Ipv4Interface::Send (Ptr<Packet> p, const Ipv4Header & hdr, Ipv4Address dest)
     {
       if (dest == (*i).GetLocal ())
         {
+          TcpGsoTag gsoTag;
+          p->RemovePacketTag (gsoTag);
           p->AddHeader (hdr);
           m_tc->Receive (m_device, p, Ipv4L3Protocol::PROT_NUMBER,
                          m_device->GetBroadcast (),
@@ -19,6 +19,7 @@
 //
 
 #include "ns3/packet.h"
+#include "ns3/packet-burst.h"
 #include "ns3/log.h"
 #include "ns3/callback.h"
 #include "ns3/ipv4-address.h"
@@ -41,6 +42,7 @@
 #include "icmpv4-l4-protocol.h"
 #include "ipv4-interface.h"
 #include "ipv4-raw-socket-impl.h"
+#include "tcp-gso-tag.h"
 
 namespace ns3 {
 
@@ -110,6 +112,10 @@ Ipv4L3Protocol::GetTypeId (void)
 Ipv4L3Protocol::Ipv4L3Protocol()
 {
   NS_LOG_FUNCTION (this);
+  m_ipForwardCallback = MakeCallback (&Ipv4L3Protocol::IpForward, this);
+  m_ipMulticastForwardCallback = MakeCallback (&Ipv4L3Protocol::IpMulticastForward, this);
+  m_localDeliverCallback = MakeCallback (&Ipv4L3Protocol::LocalDeliver, this);
+  m_routeInputErrorCallback = MakeCallback (&Ipv4L3Protocol::RouteInputError, this);
 }
 
 Ipv4L3Protocol::~Ipv4L3Protocol ()
@@ -374,11 +380,13 @@ Ipv4L3Protocol::AddInterface (Ptr<NetDevice> device)
   NS_ASSERT (tc != 0);
 
   m_node->RegisterProtocolHandler (MakeCallback (&TrafficControlLayer::Receive, tc),
+                                   MakeCallback (&TrafficControlLayer::ReceiveBurst, tc),
                                    Ipv4L3Protocol::PROT_NUMBER, device);
   m_node->RegisterProtocolHandler (MakeCallback (&TrafficControlLayer::Receive, tc),
                                    ArpL3Protocol::PROT_NUMBER, device);
 
   tc->RegisterProtocolHandler (MakeCallback (&Ipv4L3Protocol::Receive, this),
+                               MakeCallback (&Ipv4L3Protocol::ReceiveBurst, this),
                                Ipv4L3Protocol::PROT_NUMBER, device);
   tc->RegisterProtocolHandler (MakeCallback (&ArpL3Protocol::Receive, PeekPointer (GetObject<ArpL3Protocol> ())),
                                ArpL3Protocol::PROT_NUMBER, device);
@@ -556,20 +564,61 @@ Ipv4L3Protocol::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t p
   int32_t interface = GetInterfaceForDevice(device);
   NS_ASSERT_MSG (interface != -1, "Received a packet from an interface that is not known to IPv4");
 
+  DoReceive (device, p, from, interface, m_node->GetObject<Ipv4> (), Simulator::Now (), 0);
+}
+
+void
+Ipv4L3Protocol::ReceiveBurst (Ptr<NetDevice> device, Ptr<const PacketBurst> burst, uint16_t protocol,
+                              const Address &from, const Address &to, NetDevice::PacketType packetType)
+{
+  NS_LOG_FUNCTION (this << device << burst << protocol << from << to << packetType);
+
+  NS_LOG_LOGIC (burst->GetNPackets () << " packets from " << from <<
+                " received on node " << m_node->GetId ());
+
+  int32_t interface = GetInterfaceForDevice(device);
+  NS_ASSERT_MSG (interface != -1, "Received a packet from an interface that is not known to IPv4");
+
+  Ptr<Ipv4> ipv4 = m_node->GetObject<Ipv4> ();
+  // The broadcast address is never the source of a valid packet
+  Ipv4Address refreshed = Ipv4Address::GetBroadcast ();
+  Time lastArrival;
+  uint32_t index = 0;
+  for (std::list<Ptr<Packet> >::const_iterator i = burst->Begin (); i != burst->End (); ++i, ++index)
+    {
+      // The device may have held the packets of the burst for a while: each
+      // one refreshes the ARP cache as of its own arrival time
+      Time arrival = burst->GetArrivalTime (index);
+      if (index > 0 && arrival != lastArrival)
+        {
+          refreshed = Ipv4Address::GetBroadcast ();
+        }
+      lastArrival = arrival;
+      DoReceive (device, *i, from, interface, ipv4, arrival, &refreshed);
+    }
+}
+
+void
+Ipv4L3Protocol::DoReceive (Ptr<NetDevice> device, Ptr<const Packet> p, const Address &from,
+                           uint32_t interface, Ptr<Ipv4> ipv4, Time arrival,
+                           Ipv4Address *refreshed)
+{
+  NS_LOG_FUNCTION (this << device << p << from << interface);
+
   Ptr<Packet> packet = p->Copy ();
 
   Ptr<Ipv4Interface> ipv4Interface = m_interfaces[interface];
 
   if (ipv4Interface->IsUp ())
     {
-      m_rxTrace (packet, m_node->GetObject<Ipv4> (), interface);
+      m_rxTrace (packet, ipv4, interface);
     }
   else
     {
       NS_LOG_LOGIC ("Dropping received packet -- interface is down");
       Ipv4Header ipHeader;
       packet->RemoveHeader (ipHeader);
-      m_dropTrace (ipHeader, packet, DROP_INTERFACE_DOWN, m_node->GetObject<Ipv4> (), interface);
+      m_dropTrace (ipHeader, packet, DROP_INTERFACE_DOWN, ipv4, interface);
       return;
     }
 
@@ -589,21 +638,31 @@ Ipv4L3Protocol::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t p
   if (!ipHeader.IsChecksumOk ()) 
     {
       NS_LOG_LOGIC ("Dropping received packet -- checksum not ok");
-      m_dropTrace (ipHeader, packet, DROP_BAD_CHECKSUM, m_node->GetObject<Ipv4> (), interface);
+      m_dropTrace (ipHeader, packet, DROP_BAD_CHECKSUM, ipv4, interface);
       return;
     }
 
   // the packet is valid, we update the ARP cache entry (if present)
   Ptr<ArpCache> arpCache = ipv4Interface->GetArpCache ();
+  if (arpCache && refreshed != 0 && *refreshed == ipHeader.GetSource ())
+    {
+      // Same source and same arrival time as the previous packet of the
+      // burst: the entry has just been refreshed.
+      arpCache = 0;
+    }
   if (arpCache)
     {
+      if (refreshed != 0)
+        {
+          *refreshed = ipHeader.GetSource ();
+        }
       // case one, it's a a direct routing.
       ArpCache::Entry *entry = arpCache->Lookup (ipHeader.GetSource ());
       if (entry)
         {
           if (entry->IsAlive ())
             {
-              entry->UpdateSeen ();
+              entry->UpdateSeen (arrival);
             }
         }
       else
@@ -617,7 +676,7 @@ Ipv4L3Protocol::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t p
             {
               if ((*iter)->IsAlive ())
                 {
-                  (*iter)->UpdateSeen ();
+                  (*iter)->UpdateSeen (arrival);
                 }
             }
         }
@@ -632,14 +691,14 @@ Ipv4L3Protocol::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t p
 
   NS_ASSERT_MSG (m_routingProtocol != 0, "Need a routing protocol object to process packets");
   if (!m_routingProtocol->RouteInput (packet, ipHeader, device,
-                                      MakeCallback (&Ipv4L3Protocol::IpForward, this),
-                                      MakeCallback (&Ipv4L3Protocol::IpMulticastForward, this),
-                                      MakeCallback (&Ipv4L3Protocol::LocalDeliver, this),
-                                      MakeCallback (&Ipv4L3Protocol::RouteInputError, this)
+                                      m_ipForwardCallback,
+                                      m_ipMulticastForwardCallback,
+                                      m_localDeliverCallback,
+                                      m_routeInputErrorCallback
                                       ))
     {
       NS_LOG_WARN ("No route found for forwarding packet.  Drop.");
-      m_dropTrace (ipHeader, packet, DROP_NO_ROUTE, m_node->GetObject<Ipv4> (), interface);
+      m_dropTrace (ipHeader, packet, DROP_NO_ROUTE, ipv4, interface);
     }
 }
 
@@ -925,12 +984,22 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
   Ptr<Ipv4Interface> outInterface = GetInterface (interface);
   NS_LOG_LOGIC ("Send via NetDevice ifIndex " << outDev->GetIfIndex () << " ipv4InterfaceIndex " << interface);
 
+  // TCP super-segments are not fragmented: they are split in segments when
+  // dequeued from the queue disc, each segment taking the next identification
+  TcpGsoTag gsoTag;
+  bool gso = packet->PeekPacketTag (gsoTag);
+  if (gso)
+    {
+      uint64_t srcDst = ipHeader.GetDestination ().Get () | (uint64_t (ipHeader.GetSource ().Get ()) << 32);
+      m_identification[std::make_pair (srcDst, ipHeader.GetProtocol ())] += gsoTag.GetSegments () - 1;
+    }
+
   if (!route->GetGateway ().IsEqual (Ipv4Address ("0.0.0.0")))
     {
       if (outInterface->IsUp ())
         {
           NS_LOG_LOGIC ("Send to gateway " << route->GetGateway ());
-          if ( packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu () )
+          if ( !gso && packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu () )
             {
               std::list<Ipv4PayloadHeaderPair> listFragments;
               DoFragmentation (packet, ipHeader, outInterface->GetDevice ()->GetMtu (), listFragments);
@@ -957,7 +1026,7 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
       if (outInterface->IsUp ())
         {
           NS_LOG_LOGIC ("Send to destination " << ipHeader.GetDestination ());
-          if ( packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu () )
+          if ( !gso && packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu () )
             {
               std::list<Ipv4PayloadHeaderPair> listFragments;
               DoFragmentation (packet, ipHeader, outInterface->GetDevice ()->GetMtu (), listFragments);
@@ -1045,6 +1114,9 @@ Ipv4L3Protocol::IpForward (Ptr<Ipv4Route> rtentry, Ptr<const Packet> p, const Ip
   // in case the packet still has a priority tag attached, remove it
   SocketPriorityTag priorityTag;
   packet->RemovePacketTag (priorityTag);
+  // the pacing rate is the one of a local socket
+  SocketPacingRateTag pacingRateTag;
+  packet->RemovePacketTag (pacingRateTag);
   uint8_t priority = Socket::IpTos2Priority (ipHeader.GetTos ());
   // add a priority tag if the priority is not null
   if (priority)
@@ -40,6 +40,7 @@ class Ipv4L3ProtocolTestCase;
 namespace ns3 {
 
 class Packet;
+class PacketBurst;
 class NetDevice;
 class Ipv4Interface;
 class Ipv4Address;
@@ -154,6 +155,24 @@ public:
   void Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from,
                  const Address &to, NetDevice::PacketType packetType);
 
+  /**
+   * Lower layer calls this method to deliver a burst of packets received
+   * at once on the same device. The result is the same as calling Receive
+   * for each packet of the burst, in order, but the interface lookup is
+   * done once per burst, and the ARP cache entry of a source is refreshed
+   * once for the packets it sent that have been received at the same time.
+   * The ARP cache entries are refreshed with the arrival time of the
+   * packets (see PacketBurst::GetArrivalTime), not the delivery time.
+   * \param device network device
+   * \param burst the packets
+   * \param protocol protocol value
+   * \param from address of the correspondent
+   * \param to address of the destination
+   * \param packetType type of the packets
+   */
+  void ReceiveBurst (Ptr<NetDevice> device, Ptr<const PacketBurst> burst, uint16_t protocol,
+                     const Address &from, const Address &to, NetDevice::PacketType packetType);
+
   /**
    * \param packet packet to send
    * \param source source address of packet
@@ -362,6 +381,23 @@ private:
    */
   void RouteInputError (Ptr<const Packet> p, const Ipv4Header & ipHeader, Socket::SocketErrno sockErrno);
 
+  /**
+   * \brief Process a packet received on an interface.
+   * \param device network device
+   * \param p the packet
+   * \param from address of the correspondent
+   * \param interface index of the interface of the device
+   * \param ipv4 the Ipv4 object aggregated to the node, passed to the traces
+   * \param arrival the time the packet has been received by the device,
+   *        which the ARP cache entry of the source is refreshed with
+   * \param refreshed if not null, the source address whose ARP cache entry
+   *        was last refreshed with the same arrival time; the refresh is
+   *        skipped if the packet comes from the same source, and the address
+   *        is updated otherwise.
+   */
+  void DoReceive (Ptr<NetDevice> device, Ptr<const Packet> p, const Address &from,
+                  uint32_t interface, Ptr<Ipv4> ipv4, Time arrival, Ipv4Address *refreshed);
+
   /**
    * \brief Add an IPv4 interface to the stack.
    * \param interface interface to add
@@ -487,6 +523,14 @@ private:
 
   Ptr<Ipv4RoutingProtocol> m_routingProtocol; //!< Routing protocol associated with the stack
 
+  /// \name Callbacks passed to RouteInput for each received packet
+  /// @{
+  Ipv4RoutingProtocol::UnicastForwardCallback m_ipForwardCallback;
+  Ipv4RoutingProtocol::MulticastForwardCallback m_ipMulticastForwardCallback;
+  Ipv4RoutingProtocol::LocalDeliverCallback m_localDeliverCallback;
+  Ipv4RoutingProtocol::ErrorCallback m_routeInputErrorCallback;
+  /// @}
+
   SocketList m_sockets; //!< List of IPv4 raw sockets.
 
   /**
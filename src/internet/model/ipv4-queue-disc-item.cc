@@ -17,6 +17,11 @@
  */
 
 #include "ns3/log.h"
+#include "ns3/hash.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-option-sack.h"
+#include "ns3/udp-header.h"
+#include "tcp-l4-protocol.h"
 #include "ipv4-queue-disc-item.h"
 
 namespace ns3 {
@@ -95,4 +100,120 @@ Ipv4QueueDiscItem::GetUint8Value (QueueItem::Uint8Values field, uint8_t& value)
   return ret;
 }
 
+uint32_t
+Ipv4QueueDiscItem::Hash (uint32_t perturbation) const
+{
+  NS_LOG_FUNCTION (this << perturbation);
+
+  Ipv4Address src = m_header.GetSource ();
+  Ipv4Address dest = m_header.GetDestination ();
+  uint8_t prot = m_header.GetProtocol ();
+  uint16_t fragOffset = m_header.GetFragmentOffset ();
+
+  TcpHeader tcpHdr;
+  UdpHeader udpHdr;
+  uint16_t srcPort = 0;
+  uint16_t destPort = 0;
+
+  if (prot == 6 && fragOffset == 0) // TCP
+    {
+      GetPacket ()->PeekHeader (tcpHdr);
+      srcPort = tcpHdr.GetSourcePort ();
+      destPort = tcpHdr.GetDestinationPort ();
+    }
+  else if (prot == 17 && fragOffset == 0) // UDP
+    {
+      GetPacket ()->PeekHeader (udpHdr);
+      srcPort = udpHdr.GetSourcePort ();
+      destPort = udpHdr.GetDestinationPort ();
+    }
+
+  /* serialize the 5-tuple and the perturbation in buf */
+  uint8_t buf[17];
+  src.Serialize (buf);
+  dest.Serialize (buf + 4);
+  buf[8] = prot;
+  buf[9] = (srcPort >> 8) & 0xff;
+  buf[10] = srcPort & 0xff;
+  buf[11] = (destPort >> 8) & 0xff;
+  buf[12] = destPort & 0xff;
+  buf[13] = (perturbation >> 24) & 0xff;
+  buf[14] = (perturbation >> 16) & 0xff;
+  buf[15] = (perturbation >> 8) & 0xff;
+  buf[16] = perturbation & 0xff;
+
+  /* Linux calculates the jhash2 (jenkins hash), we calculate the murmur3 */
+  return Hash32 ((char*) buf, 17);
+}
+
+bool
+Ipv4QueueDiscItem::GetHostHashes (uint32_t &src, uint32_t &dst) const
+{
+  uint8_t buf[4];
+  m_header.GetSource ().Serialize (buf);
+  src = Hash32 ((char*) buf, 4);
+  m_header.GetDestination ().Serialize (buf);
+  dst = Hash32 ((char*) buf, 4);
+  return true;
+}
+
+bool
+Ipv4QueueDiscItem::GetPureTcpAck (uint32_t &ack, std::vector<std::pair<uint32_t, uint32_t> > &sackBlocks) const
+{
+  if (m_headerAdded || m_header.GetProtocol () != 6 || m_header.GetFragmentOffset () != 0)
+    {
+      return false;
+    }
+  TcpHeader tcpHdr;
+  Ptr<Packet> p = GetPacket ();
+  p->PeekHeader (tcpHdr);
+  if (tcpHdr.GetFlags () != TcpHeader::ACK || p->GetSize () != tcpHdr.GetSerializedSize ())
+    {
+      return false;
+    }
+  if (tcpHdr.HasOption (TcpOption::MSS) || tcpHdr.HasOption (TcpOption::WINSCALE)
+      || tcpHdr.HasOption (TcpOption::SACKPERMITTED) || tcpHdr.HasOption (TcpOption::UNKNOWN))
+    {
+      return false;
+    }
+  ack = tcpHdr.GetAckNumber ().GetValue ();
+  sackBlocks.clear ();
+  if (tcpHdr.HasOption (TcpOption::SACK))
+    {
+      Ptr<const TcpOptionSack> sack = DynamicCast<const TcpOptionSack> (tcpHdr.GetOption (TcpOption::SACK));
+      TcpOptionSack::SackList list = sack->GetSackList ();
+      for (TcpOptionSack::SackList::const_iterator i = list.begin (); i != list.end (); ++i)
+        {
+          sackBlocks.push_back (std::make_pair (i->first.GetValue (), i->second.GetValue ()));
+        }
+    }
+  return true;
+}
+
+bool
+Ipv4QueueDiscItem::Segment (std::vector<Ptr<QueueDiscItem> > &segments)
+{
+  std::vector<Ptr<Packet> > tcpSegments;
+  if (m_headerAdded || m_header.GetProtocol () != TcpL4Protocol::PROT_NUMBER
+      || !TcpL4Protocol::GsoSegment (GetPacket (), m_header.GetSource (),
+                                     m_header.GetDestination (), tcpSegments))
+    {
+      return false;
+    }
+
+  // Ipv4L3Protocol reserved an identification value for each segment
+  uint16_t identification = m_header.GetIdentification ();
+  for (std::vector<Ptr<Packet> >::iterator it = tcpSegments.begin (); it != tcpSegments.end (); it++)
+    {
+      Ipv4Header header = m_header;
+      header.SetPayloadSize ((*it)->GetSize ());
+      header.SetIdentification (identification++);
+      Ptr<QueueDiscItem> item = Create<Ipv4QueueDiscItem> (*it, GetAddress (), GetProtocol (), header);
+      item->SetTxQueueIndex (GetTxQueueIndex ());
+      item->SetTimeStamp (GetTimeStamp ());
+      segments.push_back (item);
+    }
+  return true;
+}
+
 } // namespace ns3
@@ -79,6 +79,45 @@ public:
    */
   virtual bool GetUint8Value (Uint8Values field, uint8_t &value) const;
 
+  /**
+   * \brief Computes the hash of the packet's 5-tuple
+   *
+   * The addresses, the protocol and, for TCP and UDP, the ports are
+   * hashed with the perturbation as FqCoDelIpv4PacketFilter does.
+   *
+   * \param perturbation hash perturbation value
+   * \return the hash of the packet's 5-tuple
+   */
+  virtual uint32_t Hash (uint32_t perturbation = 0) const;
+
+  /**
+   * \brief Computes the hashes of the source and destination addresses
+   * \param src the hash of the source address
+   * \param dst the hash of the destination address
+   * \return true
+   */
+  virtual bool GetHostHashes (uint32_t &src, uint32_t &dst) const;
+
+  /**
+   * \brief Check whether the packet is a pure TCP acknowledgment
+   * \param ack the acknowledgment number
+   * \param sackBlocks the left and right edges of the SACK blocks, if any
+   * \return true if the packet is a TCP segment with the ACK flag only, no
+   *         payload and no option other than SACK and timestamps
+   */
+  virtual bool GetPureTcpAck (uint32_t &ack, std::vector<std::pair<uint32_t, uint32_t> > &sackBlocks) const;
+
+  /**
+   * \brief Split a TCP super-segment in MSS-sized segments
+   *
+   * Each segment gets a copy of the IPv4 header with its own payload length and an
+   * increasing identification.
+   *
+   * \param segments the segments, appended if the packet is split
+   * \return true if the packet is a TCP super-segment and has been split
+   */
+  virtual bool Segment (std::vector<Ptr<QueueDiscItem> > &segments);
+
 private:
   /**
    * \brief Default constructor
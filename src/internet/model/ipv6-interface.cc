@@ -32,6 +32,7 @@
 #include "icmpv6-l4-protocol.h"
 #include "ipv6-header.h"
 #include "ndisc-cache.h"
+#include "tcp-gso-tag.h"
 
 namespace ns3
 {
@@ -399,6 +400,9 @@ void Ipv6Interface::Send (Ptr<Packet> p, const Ipv6Header & hdr, Ipv6Address des
       /** \todo additional checks needed here (such as whether multicast
        * goes to loopback)?
        */
+      // As on Linux, TCP super-segments are delivered whole on loopback
+      TcpGsoTag gsoTag;
+      p->RemovePacketTag (gsoTag);
       p->AddHeader (hdr);
       m_device->Send (p, m_device->GetBroadcast (), Ipv6L3Protocol::PROT_NUMBER);
       return;
@@ -411,6 +415,8 @@ void Ipv6Interface::Send (Ptr<Packet> p, const Ipv6Header & hdr, Ipv6Address des
     {
       if (dest == it->first.GetAddress ())
         {
+          TcpGsoTag gsoTag;
+          p->RemovePacketTag (gsoTag);
           p->AddHeader (hdr);
           m_tc->Receive (m_device, p, Ipv6L3Protocol::PROT_NUMBER,
                          m_device->GetBroadcast (),
@@ -44,6 +44,7 @@
 #include "ipv6-option.h"
 #include "icmpv6-l4-protocol.h"
 #include "ndisc-cache.h"
+#include "tcp-gso-tag.h"
 
 /// Minimum IPv6 MTU, as defined by \RFC{2460}
 #define IPV6_MIN_MTU 1280
@@ -1131,7 +1132,10 @@ void Ipv6L3Protocol::SendRealOut (Ptr<Ipv6Route> route, Ptr<Packet> packet, Ipv6
       targetMtu = dev->GetMtu ();
     }
 
-  if (packet->GetSize () > targetMtu + 40) /* 40 => size of IPv6 header */
+  // TCP super-segments are not fragmented: they are split in segments when
+  // dequeued from the queue disc
+  TcpGsoTag gsoTag;
+  if (!packet->PeekPacketTag (gsoTag) && packet->GetSize () > targetMtu + 40) /* 40 => size of IPv6 header */
     {
       // Router => drop
 
@@ -1303,6 +1307,9 @@ void Ipv6L3Protocol::IpForward (Ptr<const NetDevice> idev, Ptr<Ipv6Route> rtentr
   // in case the packet still has a priority tag attached, remove it
   SocketPriorityTag priorityTag;
   packet->RemovePacketTag (priorityTag);
+  // the pacing rate is the one of a local socket
+  SocketPacingRateTag pacingRateTag;
+  packet->RemovePacketTag (pacingRateTag);
   int32_t interface = GetInterfaceForDevice (rtentry->GetOutputDevice ());
   m_unicastForwardTrace (ipHeader, packet, interface);
   SendRealOut (rtentry, packet, ipHeader);
@@ -17,6 +17,11 @@
  */
 
 #include "ns3/log.h"
+#include "ns3/hash.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-option-sack.h"
+#include "ns3/udp-header.h"
+#include "tcp-l4-protocol.h"
 #include "ipv6-queue-disc-item.h"
 
 namespace ns3 {
@@ -95,4 +100,116 @@ Ipv6QueueDiscItem::GetUint8Value (QueueItem::Uint8Values field, uint8_t& value)
   return ret;
 }
 
+uint32_t
+Ipv6QueueDiscItem::Hash (uint32_t perturbation) const
+{
+  NS_LOG_FUNCTION (this << perturbation);
+
+  Ipv6Address src = m_header.GetSourceAddress ();
+  Ipv6Address dest = m_header.GetDestinationAddress ();
+  uint8_t prot = m_header.GetNextHeader ();
+
+  TcpHeader tcpHdr;
+  UdpHeader udpHdr;
+  uint16_t srcPort = 0;
+  uint16_t destPort = 0;
+
+  if (prot == 6) // TCP
+    {
+      GetPacket ()->PeekHeader (tcpHdr);
+      srcPort = tcpHdr.GetSourcePort ();
+      destPort = tcpHdr.GetDestinationPort ();
+    }
+  else if (prot == 17) // UDP
+    {
+      GetPacket ()->PeekHeader (udpHdr);
+      srcPort = udpHdr.GetSourcePort ();
+      destPort = udpHdr.GetDestinationPort ();
+    }
+
+  /* serialize the 5-tuple and the perturbation in buf */
+  uint8_t buf[41];
+  src.Serialize (buf);
+  dest.Serialize (buf + 16);
+  buf[32] = prot;
+  buf[33] = (srcPort >> 8) & 0xff;
+  buf[34] = srcPort & 0xff;
+  buf[35] = (destPort >> 8) & 0xff;
+  buf[36] = destPort & 0xff;
+  buf[37] = (perturbation >> 24) & 0xff;
+  buf[38] = (perturbation >> 16) & 0xff;
+  buf[39] = (perturbation >> 8) & 0xff;
+  buf[40] = perturbation & 0xff;
+
+  /* Linux calculates the jhash2 (jenkins hash), we calculate the murmur3 */
+  return Hash32 ((char*) buf, 41);
+}
+
+bool
+Ipv6QueueDiscItem::GetHostHashes (uint32_t &src, uint32_t &dst) const
+{
+  uint8_t buf[16];
+  m_header.GetSourceAddress ().Serialize (buf);
+  src = Hash32 ((char*) buf, 16);
+  m_header.GetDestinationAddress ().Serialize (buf);
+  dst = Hash32 ((char*) buf, 16);
+  return true;
+}
+
+bool
+Ipv6QueueDiscItem::GetPureTcpAck (uint32_t &ack, std::vector<std::pair<uint32_t, uint32_t> > &sackBlocks) const
+{
+  if (m_headerAdded || m_header.GetNextHeader () != 6)
+    {
+      return false;
+    }
+  TcpHeader tcpHdr;
+  Ptr<Packet> p = GetPacket ();
+  p->PeekHeader (tcpHdr);
+  if (tcpHdr.GetFlags () != TcpHeader::ACK || p->GetSize () != tcpHdr.GetSerializedSize ())
+    {
+      return false;
+    }
+  if (tcpHdr.HasOption (TcpOption::MSS) || tcpHdr.HasOption (TcpOption::WINSCALE)
+      || tcpHdr.HasOption (TcpOption::SACKPERMITTED) || tcpHdr.HasOption (TcpOption::UNKNOWN))
+    {
+      return false;
+    }
+  ack = tcpHdr.GetAckNumber ().GetValue ();
+  sackBlocks.clear ();
+  if (tcpHdr.HasOption (TcpOption::SACK))
+    {
+      Ptr<const TcpOptionSack> sack = DynamicCast<const TcpOptionSack> (tcpHdr.GetOption (TcpOption::SACK));
+      TcpOptionSack::SackList list = sack->GetSackList ();
+      for (TcpOptionSack::SackList::const_iterator i = list.begin (); i != list.end (); ++i)
+        {
+          sackBlocks.push_back (std::make_pair (i->first.GetValue (), i->second.GetValue ()));
+        }
+    }
+  return true;
+}
+
+bool
+Ipv6QueueDiscItem::Segment (std::vector<Ptr<QueueDiscItem> > &segments)
+{
+  std::vector<Ptr<Packet> > tcpSegments;
+  if (m_headerAdded || m_header.GetNextHeader () != TcpL4Protocol::PROT_NUMBER
+      || !TcpL4Protocol::GsoSegment (GetPacket (), m_header.GetSourceAddress (),
+                                     m_header.GetDestinationAddress (), tcpSegments))
+    {
+      return false;
+    }
+
+  for (std::vector<Ptr<Packet> >::iterator it = tcpSegments.begin (); it != tcpSegments.end (); it++)
+    {
+      Ipv6Header header = m_header;
+      header.SetPayloadLength ((*it)->GetSize ());
+      Ptr<QueueDiscItem> item = Create<Ipv6QueueDiscItem> (*it, GetAddress (), GetProtocol (), header);
+      item->SetTxQueueIndex (GetTxQueueIndex ());
+      item->SetTimeStamp (GetTimeStamp ());
+      segments.push_back (item);
+    }
+  return true;
+}
+
 } // namespace ns3
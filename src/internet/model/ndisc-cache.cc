@@ -66,6 +66,7 @@ void NdiscCache::DoDispose ()
   Flush ();
   m_device = 0;
   m_interface = 0;
+  m_timerWheel = 0;
   Object::DoDispose ();
 }
 
@@ -74,6 +75,25 @@ void NdiscCache::SetDevice (Ptr<NetDevice> device, Ptr<Ipv6Interface> interface)
   NS_LOG_FUNCTION (this << device << interface);
   m_device = device;
   m_interface = interface;
+  Ptr<Node> node = device->GetNode ();
+  if (node != 0)
+    {
+      m_timerWheel = node->GetObject<TimerWheel> ();
+      if (m_timerWheel == 0)
+        {
+          m_timerWheel = CreateObject<TimerWheel> ();
+          node->AggregateObject (m_timerWheel);
+        }
+    }
+}
+
+Ptr<TimerWheel> NdiscCache::GetTimerWheel ()
+{
+  if (m_timerWheel == 0)
+    {
+      m_timerWheel = CreateObject<TimerWheel> ();
+    }
+  return m_timerWheel;
 }
 
 Ptr<Ipv6Interface> NdiscCache::GetInterface () const
@@ -92,10 +112,10 @@ NdiscCache::Entry* NdiscCache::Lookup (Ipv6Address dst)
 {
   NS_LOG_FUNCTION (this << dst);
 
-  if (m_ndCache.find (dst) != m_ndCache.end ())
+  CacheI it = m_ndCache.find (dst);
+  if (it != m_ndCache.end ())
     {
-      NdiscCache::Entry* entry = m_ndCache[dst];
-      return entry;
+      return it->second;
     }
   return 0;
 }
@@ -132,15 +152,12 @@ void NdiscCache::Remove (NdiscCache::Entry* entry)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
-  for (CacheI i = m_ndCache.begin (); i != m_ndCache.end (); i++)
+  CacheI i = m_ndCache.find (entry->GetIpv6Address ());
+  if (i != m_ndCache.end () && (*i).second == entry)
     {
-      if ((*i).second == entry)
-        {
-          m_ndCache.erase (i);
-          entry->ClearWaitingPacket ();
-          delete entry;
-          return;
-        }
+      m_ndCache.erase (i);
+      entry->ClearWaitingPacket ();
+      delete entry;
     }
 }
 
@@ -153,7 +170,7 @@ void NdiscCache::Flush ()
       delete (*i).second; /* delete the pointer NdiscCache::Entry */
     }
 
-  m_ndCache.erase (m_ndCache.begin (), m_ndCache.end ());
+  m_ndCache.clear ();
 }
 
 void NdiscCache::SetUnresQlen (uint32_t unresQlen)
@@ -223,13 +240,22 @@ NdiscCache::Entry::Entry (NdiscCache* nd)
   : m_ndCache (nd),
     m_waiting (),
     m_router (false),
-    m_nudTimer (Timer::CANCEL_ON_DESTROY),
+    m_nudTimer (0),
     m_lastReachabilityConfirmation (Seconds (0.0)),
     m_nsRetransmit (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
 
+NdiscCache::Entry::~Entry ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  if (m_ndCache->m_timerWheel != 0)
+    {
+      m_ndCache->m_timerWheel->Cancel (m_nudTimer);
+    }
+}
+
 void NdiscCache::Entry::SetRouter (bool router)
 {
   NS_LOG_FUNCTION (this << router);
@@ -414,18 +440,24 @@ Time NdiscCache::Entry::GetLastReachabilityConfirmation () const
   return m_lastReachabilityConfirmation;
 }
 
-void NdiscCache::Entry::StartReachableTimer ()
+Ipv6Address NdiscCache::Entry::GetIpv6Address (void) const
 {
   NS_LOG_FUNCTION_NOARGS ();
-  if (m_nudTimer.IsRunning ())
-    {
-      m_nudTimer.Cancel ();
-    }
+  return m_ipv6Address;
+}
+
+void NdiscCache::Entry::ScheduleNudTimer (Time delay, void (NdiscCache::Entry::*timeout)())
+{
+  Ptr<TimerWheel> wheel = m_ndCache->GetTimerWheel ();
+  wheel->Cancel (m_nudTimer);
+  m_nudTimer = wheel->Schedule (delay, MakeCallback (timeout, this));
+}
 
+void NdiscCache::Entry::StartReachableTimer ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
   m_lastReachabilityConfirmation = Simulator::Now ();
-  m_nudTimer.SetFunction (&NdiscCache::Entry::FunctionReachableTimeout, this);
-  m_nudTimer.SetDelay (MilliSeconds (Icmpv6L4Protocol::REACHABLE_TIME));
-  m_nudTimer.Schedule ();
+  ScheduleNudTimer (MilliSeconds (Icmpv6L4Protocol::REACHABLE_TIME), &NdiscCache::Entry::FunctionReachableTimeout);
 }
 
 void NdiscCache::Entry::UpdateReachableTimer ()
@@ -435,54 +467,35 @@ void NdiscCache::Entry::UpdateReachableTimer ()
   if (m_state == REACHABLE)
     {
       m_lastReachabilityConfirmation = Simulator::Now ();
-      if (m_nudTimer.IsRunning ())
-        {
-          m_nudTimer.Cancel ();
-        }
-      m_nudTimer.Schedule ();
+      ScheduleNudTimer (MilliSeconds (Icmpv6L4Protocol::REACHABLE_TIME), &NdiscCache::Entry::FunctionReachableTimeout);
     }
 }
 
 void NdiscCache::Entry::StartProbeTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  if (m_nudTimer.IsRunning ())
-    {
-      m_nudTimer.Cancel ();
-    }
-  m_nudTimer.SetFunction (&NdiscCache::Entry::FunctionProbeTimeout, this);
-  m_nudTimer.SetDelay (MilliSeconds (Icmpv6L4Protocol::RETRANS_TIMER));
-  m_nudTimer.Schedule ();
+  ScheduleNudTimer (MilliSeconds (Icmpv6L4Protocol::RETRANS_TIMER), &NdiscCache::Entry::FunctionProbeTimeout);
 }
 
 void NdiscCache::Entry::StartDelayTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  if (m_nudTimer.IsRunning ())
-    {
-      m_nudTimer.Cancel ();
-    }
-  m_nudTimer.SetFunction (&NdiscCache::Entry::FunctionDelayTimeout, this);
-  m_nudTimer.SetDelay (Seconds (Icmpv6L4Protocol::DELAY_FIRST_PROBE_TIME));
-  m_nudTimer.Schedule ();
+  ScheduleNudTimer (Seconds (Icmpv6L4Protocol::DELAY_FIRST_PROBE_TIME), &NdiscCache::Entry::FunctionDelayTimeout);
 }
 
 void NdiscCache::Entry::StartRetransmitTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  if (m_nudTimer.IsRunning ())
-    {
-      m_nudTimer.Cancel ();
-    }
-  m_nudTimer.SetFunction (&NdiscCache::Entry::FunctionRetransmitTimeout, this);
-  m_nudTimer.SetDelay (MilliSeconds (Icmpv6L4Protocol::RETRANS_TIMER));
-  m_nudTimer.Schedule ();
+  ScheduleNudTimer (MilliSeconds (Icmpv6L4Protocol::RETRANS_TIMER), &NdiscCache::Entry::FunctionRetransmitTimeout);
 }
 
 void NdiscCache::Entry::StopNudTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_nudTimer.Cancel ();
+  if (m_ndCache->m_timerWheel != 0)
+    {
+      m_ndCache->m_timerWheel->Cancel (m_nudTimer);
+    }
   m_nsRetransmit = 0;
 }
 
@@ -29,8 +29,9 @@
 #include "ns3/net-device.h"
 #include "ns3/ipv6-address.h"
 #include "ns3/ptr.h"
-#include "ns3/timer.h"
-#include "ns3/sgi-hashmap.h"
+#include "ns3/simulator.h"
+#include "ns3/timer-wheel.h"
+#include "ns3/open-hash-map.h"
 #include "ns3/output-stream-wrapper.h"
 
 namespace ns3
@@ -159,6 +160,11 @@ public:
      */
     Entry (NdiscCache* nd);
 
+    /**
+     * \brief Destructor.
+     */
+    ~Entry ();
+
     /**
      * \brief Changes the state to this entry to INCOMPLETE.
      * \param p packet that wait to be sent
@@ -339,7 +345,19 @@ public:
      */
     void SetIpv6Address (Ipv6Address ipv6Address);
 
+    /**
+     * \brief Get the IPv6 address.
+     * \return the IPv6 address
+     */
+    Ipv6Address GetIpv6Address (void) const;
+
 private:
+    /**
+     * \brief Restart the NUD timer.
+     * \param delay the delay of the timer
+     * \param timeout the function called when the timer expires
+     */
+    void ScheduleNudTimer (Time delay, void (NdiscCache::Entry::*timeout)());
     /**
      * \brief The IPv6 address.
      */
@@ -384,9 +402,9 @@ private:
     bool m_router;
 
     /**
-     * \brief Timer (used for NUD).
+     * \brief Timer (used for NUD), in the timer wheel of the cache.
      */
-    Timer m_nudTimer;
+    TimerWheel::TimerId m_nudTimer;
 
     /**
      * \brief Last time we see a reachability confirmation.
@@ -403,11 +421,11 @@ private:
   /**
    * \brief Neighbor Discovery Cache container
    */
-  typedef sgi::hash_map<Ipv6Address, NdiscCache::Entry *, Ipv6AddressHash> Cache;
+  typedef OpenHashMap<Ipv6Address, NdiscCache::Entry *, Ipv6AddressHash> Cache;
   /**
    * \brief Neighbor Discovery Cache container iterator
    */
-  typedef sgi::hash_map<Ipv6Address, NdiscCache::Entry *, Ipv6AddressHash>::iterator CacheI;
+  typedef OpenHashMap<Ipv6Address, NdiscCache::Entry *, Ipv6AddressHash>::iterator CacheI;
 
   /**
    * \brief Copy constructor.
@@ -429,6 +447,16 @@ private:
    */
   void DoDispose ();
 
+  /**
+   * \brief Get the timer wheel of the entries' NUD timers.
+   *
+   * The wheel is shared by all the neighbor caches of the node, and is
+   * created on first use if the node has none.
+   *
+   * \return the timer wheel
+   */
+  Ptr<TimerWheel> GetTimerWheel ();
+
   /**
    * \brief The NetDevice.
    */
@@ -439,6 +467,11 @@ private:
    */
   Ptr<Ipv6Interface> m_interface;
 
+  /**
+   * \brief The timer wheel of the NUD timers.
+   */
+  Ptr<TimerWheel> m_timerWheel;
+
   /**
    * \brief A list of Entry.
    */
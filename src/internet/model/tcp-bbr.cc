@@ -88,6 +88,7 @@ TcpBbr::TcpBbr (void) :
   m_slowStartPacketscount(3),
   m_drainFactor(0.75),
   m_probeFactor(1.25),
+  m_pacingGain(2.885),
   m_currentRtt(Time(0))
 
 {
@@ -118,6 +119,7 @@ TcpBbr::TcpBbr (const TcpBbr& sock) :
   m_slowStartPacketscount(sock.m_slowStartPacketscount),
   m_drainFactor(sock.m_drainFactor),
   m_probeFactor(sock.m_probeFactor),
+  m_pacingGain(sock.m_pacingGain),
   m_currentRtt(sock.m_currentRtt)
 
 {
@@ -188,6 +190,12 @@ TcpBbr::PktsAcked (Ptr<TcpSocketState> tcb, uint32_t packetsAcked,
   m_rttCounter++;
   m_currentRtt = rtt;
 
+  // Pace at the bottleneck bandwidth estimate (bytes/s)
+  if (m_maxBwd > 0)
+    {
+      tcb->m_pacingRate = DataRate (static_cast<uint64_t> (m_pacingGain * m_maxBwd * 8));
+    }
+
 
 
 //  m_baseRtt = std::min (m_baseRtt, rtt);
@@ -270,6 +278,7 @@ TcpBbr::IncreaseWindow (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
       std::cerr<<"IncreaseWindow: slowstart current rtt: "<<m_currentRtt.GetSeconds()<<std::endl;
 
       segmentsAcked = TcpNewReno::SlowStart (tcb, segmentsAcked);
+      m_pacingGain = 2.885; // 2/ln(2), as the startup gain of BBR
       if(m_slowStartPacketscount>=1)
         m_slowStartPacketscount--;
       if(m_slowStartPacketscount<1 && fabs(m_maxBwd-m_currentBW)<0.2*m_maxBwd)
@@ -291,6 +300,7 @@ TcpBbr::IncreaseWindow (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
 
    // m_cWnd = m_cWnd*m_drainFactor;
        tcb->m_cWnd = tcb->m_cWnd*m_drainFactor;
+       m_pacingGain = m_drainFactor;
             std::cerr<<"IncreaseWindow: drain phase window "<<tcb->m_cWnd<<std::endl;
             m_lastTimeStamp = Simulator::Now();
 
@@ -301,6 +311,7 @@ TcpBbr::IncreaseWindow (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
    else if(fabs(m_lastTimeStamp.GetSeconds()-Simulator::Now().GetSeconds())>0.08){ // A Bbr cycle has finished, we do Bbr cwnd adjustment every RTT.
 
     tcb->m_cWnd = tcb->m_cWnd*m_probeFactor;
+    m_pacingGain = m_probeFactor;
               std::cerr<<"IncreaseWindow: probe phase max bandwidth: "<<m_maxBwd<<std::endl;
             std::cerr<<"IncreaseWindow: probe phase current bandwidth: "<<m_currentBW<<std::endl;
 
@@ -415,6 +426,7 @@ TcpBbr::IncreaseWindow (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
     }
     //BDP
     else{
+      m_pacingGain = 1.0;
       //std::cout<< "tcb->m_cWnd= " <<std::max(5000.0,m_minRtt.GetSeconds()*20*1024*1024/16)<<std::endl;
       //std::cout<<"m_minRtt= "<<m_minRtt.GetSeconds()<<std::endl;
          // tcb->m_cWnd = std::max(5000.0,m_minRtt.GetSeconds()*20*1024*1024/2/10);
@@ -506,4 +518,10 @@ TcpBbr::Fork ()
   return CreateObject<TcpBbr> (*this);
 }
 
+bool
+TcpBbr::HasPacingRate (void) const
+{
+  return true;
+}
+
 } // namespace ns3
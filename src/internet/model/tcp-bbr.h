@@ -113,6 +113,14 @@ public:
 
   virtual Ptr<TcpCongestionOps> Fork ();
 
+  /**
+   * \brief Bbr paces at the maximum bandwidth estimate, scaled by the gain
+   * of the current phase
+   *
+   * \return true
+   */
+  virtual bool HasPacingRate (void) const;
+
 private:
   /**
    * Update the total number of acknowledged packets during the current RTT
@@ -158,6 +166,7 @@ protected:
   uint32_t m_slowStartPacketscount; //count to exit slowstart if throughput is not changing
   double m_drainFactor;
   double m_probeFactor;
+  double m_pacingGain;       //!< Pacing rate/maximum bandwidth ratio of the current phase
   Time m_currentRtt;
   Time m_lastTimeStamp;
 };
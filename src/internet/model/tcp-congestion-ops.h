@@ -136,6 +136,19 @@ public:
   {
   }
 
+  /**
+   * \brief Tell if the congestion control computes the pacing rate
+   *
+   * Rate-based algorithms set tcb->m_pacingRate themselves (e.g. in
+   * PktsAcked); the others let the socket derive it from cWnd and the RTT.
+   *
+   * \return true if the algorithm sets the pacing rate
+   */
+  virtual bool HasPacingRate (void) const
+  {
+    return false;
+  }
+
   // Present in Linux but not in ns-3 yet:
   /* call when cwnd event occurs (optional) */
   // void (*cwnd_event)(struct sock *sk, enum tcp_ca_event ev);
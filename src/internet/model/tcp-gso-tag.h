@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef TCP_GSO_TAG_H
+#define TCP_GSO_TAG_H
+
+#include "ns3/tag.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Marks a TCP super-segment (generic segmentation offload)
+ *
+ * A TcpSocketBase with GsoMaxSegments greater than one hands down to IP
+ * packets carrying up to that number of MSS of payload, with a single TCP
+ * header. Such a packet goes through the TCP and IP layers and the queue
+ * disc as a whole, and it is split in MSS-sized segments, each with its own
+ * TCP and IP header, when it is dequeued from the root queue disc, or before
+ * being handed to the device if the device has no queue disc (see
+ * QueueDiscItem::Segment and TcpL4Protocol::GsoSegment). The tag carries the
+ * size and the number of the segments to produce.
+ */
+class TcpGsoTag : public Tag
+{
+public:
+  TcpGsoTag ();
+
+  /**
+   * \brief Set the payload size of the segments to produce
+   * \param segmentSize the segment size
+   */
+  void SetSegmentSize (uint16_t segmentSize);
+
+  /**
+   * \brief Get the payload size of the segments to produce
+   * \returns the segment size
+   */
+  uint16_t GetSegmentSize (void) const;
+
+  /**
+   * \brief Set the number of segments to produce
+   * \param segments the number of segments
+   */
+  void SetSegments (uint16_t segments);
+
+  /**
+   * \brief Get the number of segments to produce
+   * \returns the number of segments
+   */
+  uint16_t GetSegments (void) const;
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  // inherited function, no need to doc.
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  // inherited function, no need to doc.
+  virtual uint32_t GetSerializedSize (void) const;
+
+  // inherited function, no need to doc.
+  virtual void Serialize (TagBuffer i) const;
+
+  // inherited function, no need to doc.
+  virtual void Deserialize (TagBuffer i);
+
+  // inherited function, no need to doc.
+  virtual void Print (std::ostream &os) const;
+
+private:
+  uint16_t m_segmentSize; //!< Payload size of each segment
+  uint16_t m_segments;    //!< Number of segments
+};
+
+} // namespace ns3
+
+#endif /* TCP_GSO_TAG_H */
@@ -32,6 +32,7 @@
 
 #include "tcp-l4-protocol.h"
 #include "tcp-header.h"
+#include "tcp-gso-tag.h"
 #include "ipv4-end-point-demux.h"
 #include "ipv6-end-point-demux.h"
 #include "ipv4-end-point.h"
@@ -45,6 +46,7 @@
 #include "rtt-estimator.h"
 
 #include <vector>
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
 
@@ -636,6 +638,49 @@ TcpL4Protocol::SendPacketV6 (Ptr<Packet> packet, const TcpHeader &outgoing,
     }
 }
 
+bool
+TcpL4Protocol::GsoSegment (Ptr<const Packet> packet, const Address &saddr, const Address &daddr,
+                           std::vector<Ptr<Packet> > &segments)
+{
+  NS_LOG_FUNCTION (packet << saddr << daddr);
+
+  TcpGsoTag gsoTag;
+  if (!packet->PeekPacketTag (gsoTag))
+    {
+      return false;
+    }
+  uint32_t segmentSize = gsoTag.GetSegmentSize ();
+  NS_ASSERT (segmentSize > 0);
+
+  Ptr<Packet> payload = packet->Copy ();
+  payload->RemovePacketTag (gsoTag);
+  TcpHeader header;
+  payload->RemoveHeader (header);
+  if (Node::ChecksumEnabled ())
+    {
+      header.EnableChecksums ();
+    }
+  header.InitializeChecksum (saddr, daddr, PROT_NUMBER);
+
+  uint32_t payloadSize = payload->GetSize ();
+  segments.reserve (segments.size () + gsoTag.GetSegments ());
+  for (uint32_t offset = 0; offset < payloadSize; offset += segmentSize)
+    {
+      uint32_t size = std::min (segmentSize, payloadSize - offset);
+      Ptr<Packet> segment = payload->CreateFragment (offset, size);
+
+      TcpHeader segmentHeader = header;
+      segmentHeader.SetSequenceNumber (header.GetSequenceNumber () + SequenceNumber32 (offset));
+      if (offset + size < payloadSize)
+        {
+          segmentHeader.SetFlags (header.GetFlags () & ~(TcpHeader::FIN | TcpHeader::PSH));
+        }
+      segment->AddHeader (segmentHeader);
+      segments.push_back (segment);
+    }
+  return true;
+}
+
 void
 TcpL4Protocol::SendPacket (Ptr<Packet> pkt, const TcpHeader &outgoing,
                            const Address &saddr, const Address &daddr,
@@ -22,6 +22,7 @@
 #define TCP_L4_PROTOCOL_H
 
 #include <stdint.h>
+#include <vector>
 
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv6-address.h"
@@ -197,6 +198,23 @@ public:
                    const Address &saddr, const Address &daddr,
                    Ptr<NetDevice> oif = 0) const;
 
+  /**
+   * \brief Split a TCP super-segment in MSS-sized segments
+   *
+   * The packet starts with the single TCP header of the super-segment and
+   * carries a TcpGsoTag. Each segment gets a copy of this header with its
+   * own sequence number and checksum; FIN and PSH are kept on the last
+   * segment only.
+   *
+   * \param packet the super-segment, TCP header included
+   * \param saddr the source address
+   * \param daddr the destination address
+   * \param segments the segments, TCP header included, appended in order
+   * \return false if the packet is not a super-segment
+   */
+  static bool GsoSegment (Ptr<const Packet> packet, const Address &saddr, const Address &daddr,
+                          std::vector<Ptr<Packet> > &segments);
+
   /**
    * \brief Make a socket fully operational
    *
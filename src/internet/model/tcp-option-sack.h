@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef TCP_OPTION_SACK_H
+#define TCP_OPTION_SACK_H
+
+#include <list>
+#include "ns3/tcp-option.h"
+#include "ns3/sequence-number.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Defines the TCP option of kind 5 (selective acknowledgment option) as
+ * in \RFC{2018}
+ *
+ * The option carries a list of blocks of contiguous data that the receiver
+ * holds above the cumulative acknowledgment. Each block is described by its
+ * left edge (first sequence number of the block) and its right edge (the
+ * sequence number immediately following the last byte of the block).
+ *
+ * The option is 2 + 8 * n bytes long; since the option space is limited to
+ * 40 bytes, at most 4 blocks can be carried (3 if the timestamp option is
+ * present as well).
+ */
+class TcpOptionSack : public TcpOption
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  /// SACK block definition: [left edge, right edge)
+  typedef std::pair<SequenceNumber32, SequenceNumber32> SackBlock;
+  /// SACK list definition
+  typedef std::list<SackBlock> SackList;
+
+  TcpOptionSack ();
+  virtual ~TcpOptionSack ();
+
+  virtual void Print (std::ostream &os) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+  virtual uint8_t GetKind (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+
+  /**
+   * \brief Add a SACK block at the end of the list
+   * \param s the block to add
+   */
+  void AddSackBlock (SackBlock s);
+
+  /**
+   * \brief Count the total number of SACK blocks
+   * \return the number of SACK blocks
+   */
+  uint32_t GetNumSackBlocks (void) const;
+
+  /**
+   * \brief Discard all the SACK blocks
+   */
+  void ClearSackList (void);
+
+  /**
+   * \brief Get the SACK list
+   * \return the SACK list
+   */
+  SackList GetSackList (void) const;
+
+  /**
+   * \brief Maximum number of blocks that fits in the given option space
+   * \param space free option space (in bytes)
+   * \return the number of blocks
+   */
+  static uint32_t GetMaxSackBlocks (uint32_t space);
+
+protected:
+  SackList m_sackList; //!< the list of SACK blocks
+};
+
+/**
+ * \brief Output operator.
+ * \param os The output stream.
+ * \param sackList the SACK list to print.
+ * \returns The output stream.
+ */
+std::ostream & operator<< (std::ostream & os, TcpOptionSack const & sackList);
+
+} // namespace ns3
+
+#endif /* TCP_OPTION_SACK_H */
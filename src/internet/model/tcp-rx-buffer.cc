@@ -156,61 +156,72 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
       if (maxSeq < tailSeq) tailSeq = maxSeq;
       if (tailSeq < headSeq) headSeq = tailSeq;
     }
-  // Remove overlapped bytes from packet
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end () && i->first <= tailSeq)
+  if (headSeq >= tailSeq)
+    {
+      NS_LOG_LOGIC ("Nothing to buffer");
+      return false; // Nothing to buffer anyway
+    }
+
+  // The block starting before the packet, if it overlaps or touches it
+  SequenceNumber32 blockHead = headSeq;
+  Ptr<Packet> block;
+  BufIterator i = m_data.upper_bound (headSeq);
+  if (i != m_data.begin ())
     {
-      SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      if (lastByteSeq > headSeq)
+      BufIterator prev = i;
+      --prev;
+      SequenceNumber32 prevTail = prev->first + SequenceNumber32 (prev->second->GetSize ());
+      if (prevTail >= tailSeq)
         {
-          if (i->first > headSeq && lastByteSeq < tailSeq)
-            { // Rare case: Existing packet is embedded fully in the new packet
-              m_size -= i->second->GetSize ();
-              m_data.erase (i++);
-              continue;
-            }
-          if (i->first <= headSeq)
-            { // Incoming head is overlapped
-              headSeq = lastByteSeq;
-            }
-          if (lastByteSeq >= tailSeq)
-            { // Incoming tail is overlapped
-              tailSeq = i->first;
-            }
+          NS_LOG_LOGIC ("Nothing to buffer");
+          return false; // Already fully buffered
+        }
+      if (prevTail >= headSeq)
+        { // Data already buffered takes precedence over the incoming one
+          headSeq = prevTail;
+          blockHead = prev->first;
+          block = prev->second;
+          m_size -= block->GetSize ();
+          m_data.erase (prev);
         }
-      ++i;
     }
-  // We now know how much we are going to store, trim the packet
-  if (headSeq >= tailSeq)
+
+  uint32_t start = headSeq - tcph.GetSequenceNumber ();
+  Ptr<Packet> fragment = p->CreateFragment (start, tailSeq - headSeq);
+  if (block)
     {
-      NS_LOG_LOGIC ("Nothing to buffer");
-      return false; // Nothing to buffer anyway
+      block->AddAtEnd (fragment);
     }
   else
     {
-      uint32_t start = headSeq - tcph.GetSequenceNumber ();
-      uint32_t length = tailSeq - headSeq;
-      p = p->CreateFragment (start, length);
-      NS_ASSERT (length == p->GetSize ());
+      block = fragment;
     }
-  // Insert packet into buffer
-  NS_ASSERT (m_data.find (headSeq) == m_data.end ()); // Shouldn't be there yet
-  m_data [ headSeq ] = p;
-  NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize ());
-  // Update variables
-  m_size += p->GetSize ();      // Occupancy
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+
+  // Swallow the blocks starting inside or right after the packet
+  while (i != m_data.end () && i->first <= tailSeq)
     {
-      if (i->first < m_nextRxSeq)
-        {
-          continue;
+      SequenceNumber32 nextTail = i->first + SequenceNumber32 (i->second->GetSize ());
+      if (nextTail > tailSeq)
+        { // Keep the buffered bytes of the overlapped region
+          block->RemoveAtEnd (tailSeq - i->first);
+          block->AddAtEnd (i->second);
+          tailSeq = nextTail;
         }
-      else if (i->first > m_nextRxSeq)
-        {
-          break;
-        };
-      m_nextRxSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      m_availBytes += i->second->GetSize ();
+      m_size -= i->second->GetSize ();
+      m_data.erase (i++);
+    }
+
+  NS_ASSERT (block->GetSize () == static_cast<uint32_t> (tailSeq - blockHead));
+  m_data.insert (i, std::make_pair (blockHead, block));
+  m_lastAddedSeq = headSeq;
+  NS_LOG_LOGIC ("Buffered block of seqno=" << blockHead << " len=" << block->GetSize ());
+
+  // Update variables
+  m_size += block->GetSize ();      // Occupancy
+  if (blockHead <= m_nextRxSeq && m_nextRxSeq < tailSeq)
+    {
+      m_availBytes += tailSeq - m_nextRxSeq.Get ();
+      m_nextRxSeq = tailSeq;
     }
   NS_LOG_LOGIC ("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
   if (m_gotFin && m_nextRxSeq == m_finSeq)
@@ -229,40 +240,73 @@ TcpRxBuffer::Extract (uint32_t maxSize)
   NS_LOG_LOGIC ("Requested to extract " << extractSize << " bytes from TcpRxBuffer of size=" << m_size);
   if (extractSize == 0) return 0;  // No contiguous block to return
   NS_ASSERT (m_data.size ()); // At least we have something to extract
-  Ptr<Packet> outPkt = Create<Packet> (); // The packet that contains all the data to return
-  BufIterator i;
-  while (extractSize)
-    { // Check the buffered data for delivery
-      i = m_data.begin ();
-      NS_ASSERT (i->first <= m_nextRxSeq); // in-sequence data expected
-      // Check if we send the whole pkt or just a partial
-      uint32_t pktSize = i->second->GetSize ();
-      if (pktSize <= extractSize)
-        { // Whole packet is extracted
-          outPkt->AddAtEnd (i->second);
-          m_data.erase (i);
-          m_size -= pktSize;
-          m_availBytes -= pktSize;
-          extractSize -= pktSize;
-        }
-      else
-        { // Partial is extracted and done
-          outPkt->AddAtEnd (i->second->CreateFragment (0, extractSize));
-          m_data[i->first + SequenceNumber32 (extractSize)] = i->second->CreateFragment (extractSize, pktSize - extractSize);
-          m_data.erase (i);
-          m_size -= extractSize;
-          m_availBytes -= extractSize;
-          extractSize = 0;
-        }
+  // In-sequence data is coalesced in the first block
+  BufIterator i = m_data.begin ();
+  NS_ASSERT (i->first <= m_nextRxSeq); // in-sequence data expected
+  Ptr<Packet> outPkt;
+  uint32_t pktSize = i->second->GetSize ();
+  if (pktSize <= extractSize)
+    { // Whole block is extracted
+      outPkt = i->second;
+      m_data.erase (i);
+    }
+  else
+    { // Partial is extracted and done
+      outPkt = i->second->CreateFragment (0, extractSize);
+      Ptr<Packet> rest = i->second->CreateFragment (extractSize, pktSize - extractSize);
+      SequenceNumber32 restSeq = i->first + SequenceNumber32 (extractSize);
+      m_data.erase (i++);
+      m_data.insert (i, std::make_pair (restSeq, rest));
     }
+  m_size -= outPkt->GetSize ();
+  m_availBytes -= outPkt->GetSize ();
+
   if (outPkt->GetSize () == 0)
     {
       NS_LOG_LOGIC ("Nothing extracted.");
       return 0;
     }
   NS_LOG_LOGIC ("Extracted " << outPkt->GetSize ( ) << " bytes, bufsize=" << m_size
-                             << ", num pkts in buffer=" << m_data.size ());
+                             << ", num blocks in buffer=" << m_data.size ());
   return outPkt;
 }
 
+TcpOptionSack::SackList
+TcpRxBuffer::GetSackList (uint32_t maxBlocks) const
+{
+  NS_LOG_FUNCTION (this << maxBlocks);
+
+  TcpOptionSack::SackList list;
+  if (maxBlocks == 0 || m_data.empty ())
+    {
+      return list;
+    }
+
+  // Block holding the most recently received segment, if out of order
+  ConstBufIterator recent = m_data.upper_bound (m_lastAddedSeq);
+  if (m_lastAddedSeq > m_nextRxSeq && recent != m_data.begin ())
+    {
+      --recent;
+      list.push_back (std::make_pair (recent->first,
+                                      recent->first + SequenceNumber32 (recent->second->GetSize ())));
+    }
+  else
+    {
+      recent = m_data.end ();
+    }
+
+  // Every other block above RCV.NXT is preceded by a hole
+  for (ConstBufIterator i = m_data.upper_bound (m_nextRxSeq);
+       i != m_data.end () && list.size () < maxBlocks; ++i)
+    {
+      if (i != recent)
+        {
+          list.push_back (std::make_pair (i->first,
+                                          i->first + SequenceNumber32 (i->second->GetSize ())));
+        }
+    }
+
+  return list;
+}
+
 } //namepsace ns3
@@ -27,6 +27,7 @@
 #include "ns3/sequence-number.h"
 #include "ns3/ptr.h"
 #include "ns3/tcp-header.h"
+#include "ns3/tcp-option-sack.h"
 
 namespace ns3 {
 class Packet;
@@ -36,6 +37,13 @@ class Packet;
  *
  * \brief class for the reordering buffer that keeps the data from lower layer, i.e.
  *        TcpL4Protocol, sent to the application
+ *
+ * Contiguous data is coalesced into a single packet as it arrives, so the
+ * buffer holds one block per run of contiguous bytes: the in-sequence
+ * data waiting to be read, followed by one block after each hole. The cost
+ * of an insertion depends on the number of holes, not on the number of
+ * segments received out of order, and the holes are directly available to
+ * build the SACK option.
  */
 class TcpRxBuffer : public Object
 {
@@ -105,10 +113,9 @@ public:
 
   /**
    * Insert a packet into the buffer and update the availBytes counter to
-   * reflect the number of bytes ready to send to the application. This
-   * function handles overlap by triming the head of the inputted packet and
-   * removing data from the buffer that overlaps the tail of the inputted
-   * packet
+   * reflect the number of bytes ready to send to the application. The packet
+   * is merged with the blocks it overlaps or touches; in the overlapped
+   * regions, the data already buffered is kept
    *
    * \param p packet
    * \param tcph packet's TCP header
@@ -125,16 +132,30 @@ public:
    */
   Ptr<Packet> Extract (uint32_t maxSize);
 
+  /**
+   * \brief Get the blocks of out-of-order data held in the buffer
+   *
+   * As required by \RFC{2018}, the block containing the most recently
+   * received segment comes first; the other blocks follow in sequence order.
+   *
+   * \param maxBlocks maximum number of blocks to report
+   * \returns the list of blocks, empty if there is no out-of-order data
+   */
+  TcpOptionSack::SackList GetSackList (uint32_t maxBlocks) const;
+
 private:
   /// container for data stored in the buffer
   typedef std::map<SequenceNumber32, Ptr<Packet> >::iterator BufIterator;
+  /// const iterator over the data stored in the buffer
+  typedef std::map<SequenceNumber32, Ptr<Packet> >::const_iterator ConstBufIterator;
   TracedValue<SequenceNumber32> m_nextRxSeq; //!< Seqnum of the first missing byte in data (RCV.NXT)
   SequenceNumber32 m_finSeq;                 //!< Seqnum of the FIN packet
   bool m_gotFin;                             //!< Did I received FIN packet?
   uint32_t m_size;                           //!< Number of total data bytes in the buffer, not necessarily contiguous
   uint32_t m_maxBuffer;                      //!< Upper bound of the number of data bytes in buffer (RCV.WND)
   uint32_t m_availBytes;                     //!< Number of bytes available to read, i.e. contiguous block at head
-  std::map<SequenceNumber32, Ptr<Packet> > m_data; //!< Corresponding data (may be null)
+  std::map<SequenceNumber32, Ptr<Packet> > m_data; //!< Blocks of contiguous data, keyed by their first byte
+  SequenceNumber32 m_lastAddedSeq;           //!< Seqnum of the most recently buffered segment
 };
 
 } //namepsace ns3
@@ -47,8 +47,11 @@
 #include "ipv6-end-point.h"
 #include "ipv6-l3-protocol.h"
 #include "tcp-header.h"
+#include "tcp-gso-tag.h"
 #include "tcp-option-winscale.h"
 #include "tcp-option-ts.h"
+#include "tcp-option-sack-permitted.h"
+#include "tcp-option-sack.h"
 #include "rtt-estimator.h"
 #include "tcp-congestion-ops.h"
 
@@ -98,6 +101,39 @@ TcpSocketBase::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&TcpSocketBase::m_timestampEnabled),
                    MakeBooleanChecker ())
+    .AddAttribute ("Sack", "Enable or disable the SACK option and the SACK-based loss recovery",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_sackEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Rack", "Enable or disable the RACK time-based loss detection "
+                   "(effective only if SACK is negotiated)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_rackEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Pacing", "Enable or disable the pacing of the transmissions",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_pacing),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxPacingRate", "Upper bound of the pacing rate",
+                   DataRateValue (DataRate ("100Gb/s")),
+                   MakeDataRateAccessor (&TcpSocketBase::m_maxPacingRate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("PacingSsRatio", "Pacing rate, as a percentage of cWnd/RTT, "
+                   "in slow start (unless set by the congestion control)",
+                   UintegerValue (200),
+                   MakeUintegerAccessor (&TcpSocketBase::m_pacingSsRatio),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("PacingCaRatio", "Pacing rate, as a percentage of cWnd/RTT, "
+                   "in congestion avoidance (unless set by the congestion control)",
+                   UintegerValue (120),
+                   MakeUintegerAccessor (&TcpSocketBase::m_pacingCaRatio),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("GsoMaxSegments", "Maximum number of segments handed down to IP "
+                   "in a single super-segment, split in segments when leaving the queue disc "
+                   "(1 disables segmentation offload)",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&TcpSocketBase::m_gsoMaxSegments),
+                   MakeUintegerChecker<uint32_t> (1, 44))
     .AddAttribute ("MinRto",
                    "Minimum retransmit timeout value",
                    TimeValue (Seconds (1.0)), // RFC 6298 says min RTO=1 sec, but Linux uses 200ms.
@@ -238,7 +274,8 @@ TcpSocketState::TcpSocketState (void)
     m_congState (CA_OPEN),
     m_highTxMark (0),
     // Change m_nextTxSequence for non-zero initial sequence number
-    m_nextTxSequence (0)
+    m_nextTxSequence (0),
+    m_pacingRate (0)
 {
 }
 
@@ -252,7 +289,8 @@ TcpSocketState::TcpSocketState (const TcpSocketState &other)
     m_lastAckedSeq (other.m_lastAckedSeq),
     m_congState (other.m_congState),
     m_highTxMark (other.m_highTxMark),
-    m_nextTxSequence (other.m_nextTxSequence)
+    m_nextTxSequence (other.m_nextTxSequence),
+    m_pacingRate (other.m_pacingRate)
 {
 }
 
@@ -311,6 +349,13 @@ TcpSocketBase::TcpSocketBase (void)
     m_sndWindShift (0),
     m_timestampEnabled (true),
     m_timestampToEcho (0),
+    m_sackEnabled (false),
+    m_rackEnabled (false),
+    m_pacing (false),
+    m_maxPacingRate (0),
+    m_pacingSsRatio (200),
+    m_pacingCaRatio (120),
+    m_gsoMaxSegments (1),
     m_sendPendingDataEvent (),
     // Set m_recover to the initial sequence number
     m_recover (0),
@@ -389,6 +434,13 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     m_sndWindShift (sock.m_sndWindShift),
     m_timestampEnabled (sock.m_timestampEnabled),
     m_timestampToEcho (sock.m_timestampToEcho),
+    m_sackEnabled (sock.m_sackEnabled),
+    m_rackEnabled (sock.m_rackEnabled),
+    m_pacing (sock.m_pacing),
+    m_maxPacingRate (sock.m_maxPacingRate),
+    m_pacingSsRatio (sock.m_pacingSsRatio),
+    m_pacingCaRatio (sock.m_pacingCaRatio),
+    m_gsoMaxSegments (sock.m_gsoMaxSegments),
     m_recover (sock.m_recover),
     m_retxThresh (sock.m_retxThresh),
     m_limitedTx (sock.m_limitedTx),
@@ -1253,6 +1305,14 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, const Address &fromAddress,
           m_timestampEnabled = false;
         }
 
+      // SACK is used only if both ends sent the SACK-permitted option
+      if (!tcpHeader.HasOption (TcpOption::SACKPERMITTED))
+        {
+          m_sackEnabled = false;
+        }
+      m_rackEnabled = m_rackEnabled && m_sackEnabled;
+      m_txBuffer->SetRackEnabled (m_rackEnabled);
+
       // Initialize cWnd and ssThresh
       m_tcb->m_cWnd = GetInitialCwnd () * GetSegSize ();
       m_tcb->m_ssThresh = GetInitialSSThresh ();
@@ -1463,6 +1523,24 @@ TcpSocketBase::FastRetransmit ()
 
   m_tcb->m_ssThresh = m_congestionControl->GetSsThresh (m_tcb,
                                                         BytesInFlight ());
+
+  if (m_sackEnabled)
+    { // RFC 6675: no window inflation, the pipe tells what is in flight
+      m_tcb->m_cWnd = m_tcb->m_ssThresh;
+
+      SequenceNumber32 head = m_txBuffer->HeadSequence ();
+      if (!m_txBuffer->IsLost (head) && !m_txBuffer->IsSacked (head))
+        {
+          m_txBuffer->MarkLost (head, m_tcb->m_segmentSize);
+        }
+
+      NS_LOG_INFO ("Enter SACK fast recovery mode. Reset cwnd to " << m_tcb->m_cWnd <<
+                   ", ssthresh to " << m_tcb->m_ssThresh << " at fast recovery seqnum " <<
+                   m_recover);
+      SendPendingData (m_connected);
+      return;
+    }
+
   m_tcb->m_cWnd = m_tcb->m_ssThresh + m_dupAckCount * m_tcb->m_segmentSize;
 
   NS_LOG_INFO (m_dupAckCount << " dupack. Enter fast recovery mode." <<
@@ -1491,7 +1569,12 @@ TcpSocketBase::DupAck ()
 
   if (m_tcb->m_congState == TcpSocketState::CA_DISORDER)
     {
-      if ((m_dupAckCount == m_retxThresh) && (m_highRxAckMark >= m_recover))
+      // With SACK, the scoreboard may declare the first segment lost before
+      // the third duplicate ACK (RFC 6675, sec. 5 step 4)
+      bool lost = (m_dupAckCount == m_retxThresh)
+        || (m_sackEnabled && m_txBuffer->IsLost (m_txBuffer->HeadSequence ()));
+
+      if (lost && (m_highRxAckMark >= m_recover))
         {
           // triple duplicate ack triggers fast retransmit (RFC2582 sec.3 bullet #1)
           NS_LOG_DEBUG (TcpSocketState::TcpCongStateName[m_tcb->m_congState] <<
@@ -1504,6 +1587,10 @@ TcpSocketBase::DupAck ()
           LimitedTransmit ();
         }
     }
+  else if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY && m_sackEnabled)
+    { // The SACK information released some room in the pipe
+      SendPendingData (m_connected);
+    }
   else if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY)
     { // Increase cwnd for every additional dupack (RFC2582, sec.3 bullet #3)
       m_tcb->m_cWnd += m_tcb->m_segmentSize;
@@ -1533,6 +1620,11 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
 
   m_tcb->m_lastAckedSeq = ackNumber;
 
+  if (m_sackEnabled && tcpHeader.HasOption (TcpOption::SACK))
+    {
+      ProcessOptionSack (tcpHeader.GetOption (TcpOption::SACK));
+    }
+
   if (ackNumber == m_txBuffer->HeadSequence ()
       && ackNumber < m_tcb->m_nextTxSequence
       && packet->GetSize () == 0)
@@ -1619,19 +1711,32 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
                * fast recovery procedure (i.e., if any duplicate ACKs subsequently
                * arrive, execute step 4 of Section 3.2 of [RFC5681]).
                 */
-              m_tcb->m_cWnd = SafeSubtraction (m_tcb->m_cWnd, bytesAcked);
-
-              if (segsAcked >= 1)
-                {
-                  m_tcb->m_cWnd += m_tcb->m_segmentSize;
-                }
-
               callCongestionControl = false; // No congestion control on cWnd show be invoked
               m_dupAckCount = SafeSubtraction (m_dupAckCount, segsAcked); // Update the dupAckCount
-              m_retransOut  = SafeSubtraction (m_retransOut, 1);  // at least one retransmission
-                                                                  // has reached the other side
               m_txBuffer->DiscardUpTo (ackNumber);  //Bug 1850:  retransmit before newack
-              DoRetransmit (); // Assume the next seq is lost. Retransmit lost packet
+
+              if (m_sackEnabled)
+                { // No window deflation: the lost segments are sent
+                  // from the scoreboard as the pipe drains
+                  SequenceNumber32 head = m_txBuffer->HeadSequence ();
+                  if (!m_txBuffer->IsLost (head) && !m_txBuffer->IsSacked (head))
+                    {
+                      m_txBuffer->MarkLost (head, m_tcb->m_segmentSize);
+                    }
+                }
+              else
+                {
+                  m_tcb->m_cWnd = SafeSubtraction (m_tcb->m_cWnd, bytesAcked);
+
+                  if (segsAcked >= 1)
+                    {
+                      m_tcb->m_cWnd += m_tcb->m_segmentSize;
+                    }
+
+                  m_retransOut  = SafeSubtraction (m_retransOut, 1);  // at least one retransmission
+                                                                      // has reached the other side
+                  DoRetransmit (); // Assume the next seq is lost. Retransmit lost packet
+                }
 
               if (m_isFirstPartialAck)
                 {
@@ -1719,6 +1824,13 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
         }
     }
 
+  UpdatePacingRate ();
+
+  if (m_rackEnabled)
+    {
+      RackDetectLoss ();
+    }
+
   // If there is any data piggybacked, store it into m_rxBuffer
   if (packet->GetSize () > 0)
     {
@@ -2250,6 +2362,11 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
           AddOptionWScale (header);
         }
 
+      if (m_sackEnabled)
+        {
+          AddOptionSackPermitted (header);
+        }
+
       if (m_synCount == 0)
         { // No more connection retries, give up
           NS_LOG_LOGIC ("Connection failed.");
@@ -2468,6 +2585,16 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
 
   Ptr<Packet> p = m_txBuffer->CopyFromSequence (maxSize, seq);
   uint32_t sz = p->GetSize (); // Size of packet
+
+  if (m_sackEnabled)
+    { // The scoreboard keeps track of each segment of a super-segment
+      for (uint32_t offset = 0; offset < sz; offset += m_tcb->m_segmentSize)
+        {
+          m_txBuffer->MarkTransmitted (seq + SequenceNumber32 (offset),
+                                       std::min (sz - offset, m_tcb->m_segmentSize),
+                                       isRetransmission);
+        }
+    }
   uint8_t flags = withAck ? TcpHeader::ACK : 0;
   uint32_t remainingData = m_txBuffer->SizeFromSequence (seq + SequenceNumber32 (sz));
 
@@ -2519,6 +2646,21 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
       p->ReplacePacketTag (priorityTag);
     }
 
+  if (m_pacing && m_tcb->m_pacingRate.GetBitRate () > 0)
+    { // Queue discs pacing the flows, such as FqPacingQueueDisc, use this rate
+      SocketPacingRateTag pacingRateTag;
+      pacingRateTag.SetPacingRate (m_tcb->m_pacingRate);
+      p->ReplacePacketTag (pacingRateTag);
+    }
+
+  if (sz > m_tcb->m_segmentSize)
+    { // Super-segment: it is split in MSS-sized segments below IP
+      TcpGsoTag gsoTag;
+      gsoTag.SetSegmentSize (static_cast<uint16_t> (m_tcb->m_segmentSize));
+      gsoTag.SetSegments (static_cast<uint16_t> ((sz + m_tcb->m_segmentSize - 1) / m_tcb->m_segmentSize));
+      p->ReplacePacketTag (gsoTag);
+    }
+
   if (m_closeOnEmpty && (remainingData == 0))
     {
       flags |= TcpHeader::FIN;
@@ -2586,7 +2728,11 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
                     ". Header " << header);
     }
 
-  UpdateRttHistory (seq, sz, isRetransmission);
+  for (uint32_t offset = 0; offset < sz; offset += m_tcb->m_segmentSize)
+    {
+      UpdateRttHistory (seq + SequenceNumber32 (offset),
+                        std::min (sz - offset, m_tcb->m_segmentSize), isRetransmission);
+    }
 
   // Notify the application of the data being sent unless this is a retransmit
   if (seq + sz > m_tcb->m_highTxMark)
@@ -2640,7 +2786,40 @@ TcpSocketBase::SendPendingData (bool withAck)
       NS_LOG_INFO ("TcpSocketBase::SendPendingData: No endpoint; m_shutdownSend=" << m_shutdownSend);
       return false; // Is this the right way to handle this condition?
     }
+  if (m_pacingEvent.IsRunning ())
+    {
+      NS_LOG_LOGIC ("Pacing: wait " << Simulator::GetDelayLeft (m_pacingEvent).GetSeconds () <<
+                    " s before sending");
+      return false;
+    }
   uint32_t nPacketsSent = 0;
+
+  if (m_sackEnabled)
+    { // Lost segments go first, as long as the pipe allows (RFC 6675, sec. 5)
+      SequenceNumber32 seq;
+      uint32_t length;
+      while (m_txBuffer->NextSeg (&seq, &length))
+        {
+          uint32_t pipe = m_txBuffer->BytesInFlight (m_tcb->m_highTxMark);
+          if (m_tcb->m_cWnd.Get () < pipe + m_tcb->m_segmentSize)
+            {
+              break;
+            }
+          uint32_t sz = SendDataPacket (seq, std::min (length, m_tcb->m_segmentSize), withAck);
+          if (sz == 0)
+            {
+              break;
+            }
+          NS_LOG_LOGIC ("Retransmitted lost segment " << seq << " size " << sz <<
+                        " pipe " << pipe);
+          nPacketsSent++;
+          if (SchedulePacing (sz))
+            {
+              return true;
+            }
+        }
+    }
+
   while (m_txBuffer->SizeFromSequence (m_tcb->m_nextTxSequence))
     {
       uint32_t w = AvailableWindow (); // Get available window size
@@ -2672,9 +2851,21 @@ TcpSocketBase::SendPendingData (bool withAck)
                     " unAck: " << UnAckDataCount ());
 
       uint32_t s = std::min (w, m_tcb->m_segmentSize);  // Send no more than window
+      if (m_gsoMaxSegments > 1 && w >= 2 * m_tcb->m_segmentSize)
+        { // Segmentation offload: hand down as many full segments as allowed.
+          // The super-segment, with its TCP and IP headers, must fit in a
+          // single IP packet
+          s = std::min (w, std::min (m_gsoMaxSegments * m_tcb->m_segmentSize,
+                                     65535u - 60 - 60));
+          s = std::max (s - s % m_tcb->m_segmentSize, m_tcb->m_segmentSize);
+        }
       uint32_t sz = SendDataPacket (m_tcb->m_nextTxSequence, s, withAck);
       nPacketsSent++;                             // Count sent this loop
       m_tcb->m_nextTxSequence += sz;                     // Advance next tx sequence
+      if (SchedulePacing (sz))
+        {
+          break;
+        }
     }
   if (nPacketsSent > 0)
     {
@@ -2683,6 +2874,54 @@ TcpSocketBase::SendPendingData (bool withAck)
   return (nPacketsSent > 0);
 }
 
+bool
+TcpSocketBase::SchedulePacing (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+
+  if (!m_pacing || m_tcb->m_pacingRate.GetBitRate () == 0)
+    {
+      return false;
+    }
+
+  Time gap = m_tcb->m_pacingRate.CalculateBytesTxTime (size);
+  NS_LOG_LOGIC ("Pacing at " << m_tcb->m_pacingRate << ", next transmission in " <<
+                gap.GetSeconds () << " s");
+  m_pacingEvent = Simulator::Schedule (gap, &TcpSocketBase::SendPendingData,
+                                       this, m_connected);
+  return true;
+}
+
+void
+TcpSocketBase::UpdatePacingRate (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (!m_pacing)
+    {
+      return;
+    }
+
+  if (!m_congestionControl->HasPacingRate ())
+    {
+      // No pacing until the RTT has been measured: the initial estimate is
+      // far too large for a sensible rate
+      Time rtt = m_rtt->GetEstimate ();
+      if (m_rtt->GetNSamples () == 0 || rtt.IsZero ())
+        {
+          return;
+        }
+      uint16_t ratio = m_tcb->m_cWnd < m_tcb->m_ssThresh ? m_pacingSsRatio : m_pacingCaRatio;
+      double rate = m_tcb->m_cWnd.Get () * 8.0 * ratio / 100.0 / rtt.GetSeconds ();
+      m_tcb->m_pacingRate = DataRate (static_cast<uint64_t> (rate));
+    }
+
+  if (m_tcb->m_pacingRate > m_maxPacingRate)
+    {
+      m_tcb->m_pacingRate = m_maxPacingRate;
+    }
+}
+
 uint32_t
 TcpSocketBase::UnAckDataCount () const
 {
@@ -2704,7 +2943,11 @@ TcpSocketBase::BytesInFlight ()
   uint32_t duplicatedSize;
   uint32_t bytesInFlight;
 
-  if (m_retransOut > m_dupAckCount)
+  if (m_sackEnabled)
+    { // RFC 6675 SetPipe (), from the scoreboard
+      bytesInFlight = m_txBuffer->BytesInFlight (m_tcb->m_highTxMark);
+    }
+  else if (m_retransOut > m_dupAckCount)
     {
       duplicatedSize = (m_retransOut - m_dupAckCount)*m_tcb->m_segmentSize;
       bytesInFlight = flightSize + duplicatedSize;
@@ -2739,6 +2982,16 @@ TcpSocketBase::AvailableWindow () const
   uint32_t unack = UnAckDataCount (); // Number of outstanding bytes
   uint32_t win = Window ();           // Number of bytes allowed to be outstanding
 
+  if (m_sackEnabled)
+    { // The congestion window limits the pipe, the receiver window the
+      // outstanding data
+      uint32_t pipe = m_txBuffer->BytesInFlight (m_tcb->m_highTxMark);
+      uint32_t cwndRoom = SafeSubtraction (m_tcb->m_cWnd, pipe);
+      uint32_t rwndRoom = SafeSubtraction (m_rWnd, unack);
+      NS_LOG_DEBUG ("Pipe=" << pipe << ", UnAckCount=" << unack);
+      return std::min (cwndRoom, rwndRoom);
+    }
+
   NS_LOG_DEBUG ("UnAckCount=" << unack << ", Win=" << win);
   return (win < unack) ? 0 : (win - unack);
 }
@@ -3058,7 +3311,16 @@ TcpSocketBase::Retransmit ()
       m_tcb->m_cWnd = m_tcb->m_segmentSize;
     }
 
-  m_tcb->m_nextTxSequence = m_txBuffer->HeadSequence (); // Restart from highest Ack
+  if (m_sackEnabled)
+    { // Everything not SACKed is lost; it is resent from the scoreboard,
+      // so there is no need to go back to the highest Ack
+      m_txBuffer->MarkLost (m_txBuffer->HeadSequence (),
+                            m_tcb->m_highTxMark.Get () - m_txBuffer->HeadSequence ());
+    }
+  else
+    {
+      m_tcb->m_nextTxSequence = m_txBuffer->HeadSequence (); // Restart from highest Ack
+    }
   m_dupAckCount = 0;
 
   NS_LOG_DEBUG ("RTO. Reset cwnd to " <<  m_tcb->m_cWnd << ", ssthresh to " <<
@@ -3125,6 +3387,8 @@ TcpSocketBase::CancelAllTimers ()
   m_lastAckEvent.Cancel ();
   m_timewaitEvent.Cancel ();
   m_sendPendingDataEvent.Cancel ();
+  m_rackEvent.Cancel ();
+  m_pacingEvent.Cancel ();
 }
 
 /* Move TCP to Time_Wait state and schedule a transition to Closed state */
@@ -3307,6 +3571,11 @@ TcpSocketBase::AddOptions (TcpHeader& header)
     {
       AddOptionTimestamp (header);
     }
+
+  if (m_sackEnabled)
+    {
+      AddOptionSack (header);
+    }
 }
 
 void
@@ -3406,6 +3675,81 @@ TcpSocketBase::AddOptionTimestamp (TcpHeader& header)
                option->GetTimestamp () << " echo=" << m_timestampToEcho);
 }
 
+uint32_t
+TcpSocketBase::ProcessOptionSack (const Ptr<const TcpOption> option)
+{
+  NS_LOG_FUNCTION (this << option);
+
+  Ptr<const TcpOptionSack> s = DynamicCast<const TcpOptionSack> (option);
+  return m_txBuffer->Update (s->GetSackList (), m_retxThresh, m_tcb->m_segmentSize);
+}
+
+void
+TcpSocketBase::AddOptionSackPermitted (TcpHeader &header)
+{
+  NS_LOG_FUNCTION (this << header);
+
+  Ptr<TcpOptionSackPermitted> option = CreateObject<TcpOptionSackPermitted> ();
+  header.AppendOption (option);
+  NS_LOG_INFO (m_node->GetId () << " Add option SACK-PERMITTED");
+}
+
+void
+TcpSocketBase::AddOptionSack (TcpHeader& header)
+{
+  NS_LOG_FUNCTION (this << header);
+
+  uint32_t maxBlocks = TcpOptionSack::GetMaxSackBlocks (header.GetMaxOptionLength ()
+                                                        - header.GetOptionLength ());
+  TcpOptionSack::SackList list = m_rxBuffer->GetSackList (maxBlocks);
+  if (list.empty ())
+    {
+      return;
+    }
+
+  Ptr<TcpOptionSack> option = CreateObject<TcpOptionSack> ();
+  for (TcpOptionSack::SackList::const_iterator it = list.begin (); it != list.end (); ++it)
+    {
+      option->AddSackBlock (*it);
+    }
+
+  header.AppendOption (option);
+  NS_LOG_INFO (m_node->GetId () << " Add option SACK " << *option);
+}
+
+void
+TcpSocketBase::RackDetectLoss (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  bool newLoss = false;
+  Time timeout = m_txBuffer->RackDetectLoss (&newLoss);
+
+  m_rackEvent.Cancel ();
+  if (timeout.IsStrictlyPositive ())
+    {
+      m_rackEvent = Simulator::Schedule (timeout, &TcpSocketBase::RackDetectLoss, this);
+    }
+
+  if (!newLoss)
+    {
+      return;
+    }
+
+  if ((m_tcb->m_congState == TcpSocketState::CA_OPEN
+       || m_tcb->m_congState == TcpSocketState::CA_DISORDER)
+      && m_highRxAckMark >= m_recover)
+    {
+      NS_LOG_DEBUG (TcpSocketState::TcpCongStateName[m_tcb->m_congState] <<
+                    " -> RECOVERY (RACK)");
+      FastRetransmit ();
+    }
+  else
+    {
+      SendPendingData (m_connected);
+    }
+}
+
 void TcpSocketBase::UpdateWindowSize (const TcpHeader &header)
 {
   NS_LOG_FUNCTION (this << header);
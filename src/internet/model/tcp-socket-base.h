@@ -33,6 +33,7 @@
 #include "ns3/ipv6-header.h"
 #include "ns3/ipv6-interface.h"
 #include "ns3/event-id.h"
+#include "ns3/data-rate.h"
 #include "tcp-tx-buffer.h"
 #include "tcp-rx-buffer.h"
 #include "rtt-estimator.h"
@@ -164,6 +165,9 @@ public:
   TracedValue<SequenceNumber32> m_highTxMark; //!< Highest seqno ever sent, regardless of ReTx
   TracedValue<SequenceNumber32> m_nextTxSequence; //!< Next seqnum to be sent (SND.NXT), ReTx pushes it back
 
+  // Pacing
+  DataRate               m_pacingRate;      //!< Current pacing rate
+
   /**
    * \brief Get cwnd in segments rather than bytes
    *
@@ -963,6 +967,63 @@ protected:
    */
   void AddOptionTimestamp (TcpHeader& header);
 
+  /**
+   * \brief Read the SACK option and update the scoreboard
+   *
+   * \param option SACK option from the header
+   * \returns the number of bytes newly SACKed
+   */
+  uint32_t ProcessOptionSack (const Ptr<const TcpOption> option);
+
+  /**
+   * \brief Add the SACK-permitted option to the header
+   *
+   * The option is sent only on SYN segments (RFC 2018).
+   *
+   * \param header TcpHeader to which add the option to
+   */
+  void AddOptionSackPermitted (TcpHeader &header);
+
+  /**
+   * \brief Add the SACK option to the header
+   *
+   * As many blocks of out-of-order data as the free option space allows
+   * are reported, starting from the one containing the last segment received.
+   *
+   * \param header TcpHeader to which add the option to
+   */
+  void AddOptionSack (TcpHeader& header);
+
+  /**
+   * \brief Run the RACK loss detection and react to the losses found
+   *
+   * The reference is the most recent transmission time of a delivered
+   * segment: the segments sent before it are marked lost once they have
+   * been outstanding for RACK.rtt plus the reordering window (see
+   * TcpTxBuffer::RackDetectLoss). Enters fast recovery if a loss is
+   * detected outside of it, and (re)schedules itself for the segments sent
+   * before the reference that are not yet overdue.
+   */
+  void RackDetectLoss (void);
+
+  /**
+   * \brief Recompute the pacing rate after an ACK
+   *
+   * Unless the congestion control sets the rate itself, the rate is the
+   * congestion window over the smoothed RTT, scaled by PacingSsRatio in slow
+   * start and by PacingCaRatio otherwise, and bounded by MaxPacingRate.
+   */
+  void UpdatePacingRate (void);
+
+  /**
+   * \brief Start the pacing timer after the transmission of a segment
+   *
+   * \param size the size of the segment (or super-segment) just sent
+   * \returns true if the timer has been started, i.e. if no other segment
+   * can be sent now
+   */
+  bool SchedulePacing (uint32_t size);
+
   /**
    * \brief Performs a safe subtraction between a and b (a-b)
    *
@@ -981,6 +1042,7 @@ protected:
   EventId           m_delAckEvent;     //!< Delayed ACK timeout event
   EventId           m_persistEvent;    //!< Persist event: Send 1 byte to probe for a non-zero Rx window
   EventId           m_timewaitEvent;   //!< TIME_WAIT expiration event: Move this socket to CLOSED state
+  EventId           m_rackEvent;       //!< RACK reordering timer
   uint32_t          m_dupAckCount;     //!< Dupack counter
   uint32_t          m_delAckCount;     //!< Delayed ACK counter
   uint32_t          m_delAckMaxCount;  //!< Number of packet to fire an ACK before delay timeout
@@ -1039,6 +1101,17 @@ protected:
   bool     m_timestampEnabled;    //!< Timestamp option enabled
   uint32_t m_timestampToEcho;     //!< Timestamp to echo
 
+  bool     m_sackEnabled;         //!< SACK option enabled (RFC 2018)
+  bool     m_rackEnabled;         //!< RACK loss detection enabled (requires SACK)
+
+  // Pacing and segmentation offload
+  bool     m_pacing;              //!< Pacing enabled
+  DataRate m_maxPacingRate;       //!< Upper bound of the pacing rate
+  uint16_t m_pacingSsRatio;       //!< Pacing rate/(cWnd/RTT) ratio in slow start, in percent
+  uint16_t m_pacingCaRatio;       //!< Pacing rate/(cWnd/RTT) ratio in congestion avoidance, in percent
+  uint32_t m_gsoMaxSegments;      //!< Maximum number of segments in a GSO super-segment
+  EventId  m_pacingEvent;         //!< Pacing timer: next transmission allowed when expired
+
   EventId m_sendPendingDataEvent; //!< micro-delay event to send pending data
 
   // Fast Retransmit and Recovery
@@ -25,6 +25,7 @@
 #include "ns3/packet.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include "ns3/simulator.h"
 
 #include "tcp-tx-buffer.h"
 
@@ -34,6 +35,195 @@ NS_LOG_COMPONENT_DEFINE ("TcpTxBuffer");
 
 NS_OBJECT_ENSURE_REGISTERED (TcpTxBuffer);
 
+TcpSeqRangeSet::TcpSeqRangeSet ()
+  : m_bytes (0)
+{
+}
+
+uint32_t
+TcpSeqRangeSet::Add (const SequenceNumber32 &begin, const SequenceNumber32 &end)
+{
+  if (end <= begin)
+    {
+      return 0;
+    }
+
+  SequenceNumber32 first = begin;
+  SequenceNumber32 last = end;
+
+  // Merge with a range starting before us, if it overlaps or touches
+  RangeMap::iterator it = m_ranges.upper_bound (first);
+  if (it != m_ranges.begin ())
+    {
+      RangeMap::iterator prev = it;
+      --prev;
+      if (prev->second >= last)
+        {
+          return 0; // Already fully covered
+        }
+      if (prev->second >= first)
+        {
+          first = prev->first;
+          it = prev;
+        }
+    }
+
+  // Swallow every range starting inside [first, last]
+  uint32_t removed = 0;
+  while (it != m_ranges.end () && it->first <= last)
+    {
+      if (it->second > last)
+        {
+          last = it->second;
+        }
+      removed += it->second - it->first;
+      m_ranges.erase (it++);
+    }
+
+  m_ranges[first] = last;
+  uint32_t added = (last - first) - removed;
+  m_bytes += added;
+  return added;
+}
+
+uint32_t
+TcpSeqRangeSet::AddExcluding (const SequenceNumber32 &begin, const SequenceNumber32 &end,
+                              const TcpSeqRangeSet &excluded)
+{
+  uint32_t added = 0;
+  SequenceNumber32 s = begin;
+  while (s < end)
+    {
+      ConstIterator r = excluded.Find (s);
+      if (r != excluded.End ())
+        {
+          s = r->second;
+          continue;
+        }
+      ConstIterator next = excluded.UpperBound (s);
+      SequenceNumber32 gapEnd = end;
+      if (next != excluded.End () && next->first < end)
+        {
+          gapEnd = next->first;
+        }
+      added += Add (s, gapEnd);
+      s = gapEnd;
+    }
+  return added;
+}
+
+uint32_t
+TcpSeqRangeSet::Remove (const SequenceNumber32 &begin, const SequenceNumber32 &end)
+{
+  if (end <= begin || m_ranges.empty ())
+    {
+      return 0;
+    }
+
+  // First range whose right edge is beyond begin
+  RangeMap::iterator it = m_ranges.upper_bound (begin);
+  if (it != m_ranges.begin ())
+    {
+      --it;
+      if (it->second <= begin)
+        {
+          ++it;
+        }
+    }
+
+  uint32_t removed = 0;
+  while (it != m_ranges.end () && it->first < end)
+    {
+      SequenceNumber32 first = it->first;
+      SequenceNumber32 last = it->second;
+      m_ranges.erase (it++);
+
+      SequenceNumber32 lo = first < begin ? begin : first;
+      SequenceNumber32 hi = last < end ? last : end;
+      removed += hi - lo;
+
+      if (first < begin)
+        {
+          m_ranges[first] = begin;
+        }
+      if (last > end)
+        {
+          m_ranges[end] = last;
+        }
+    }
+
+  m_bytes -= removed;
+  return removed;
+}
+
+void
+TcpSeqRangeSet::DiscardUpTo (const SequenceNumber32 &seq)
+{
+  if (!m_ranges.empty () && m_ranges.begin ()->first < seq)
+    {
+      Remove (m_ranges.begin ()->first, seq);
+    }
+}
+
+bool
+TcpSeqRangeSet::Contains (const SequenceNumber32 &seq) const
+{
+  return Find (seq) != m_ranges.end ();
+}
+
+TcpSeqRangeSet::ConstIterator
+TcpSeqRangeSet::Find (const SequenceNumber32 &seq) const
+{
+  ConstIterator it = m_ranges.upper_bound (seq);
+  if (it == m_ranges.begin ())
+    {
+      return m_ranges.end ();
+    }
+  --it;
+  if (seq < it->second)
+    {
+      return it;
+    }
+  return m_ranges.end ();
+}
+
+TcpSeqRangeSet::ConstIterator
+TcpSeqRangeSet::UpperBound (const SequenceNumber32 &seq) const
+{
+  return m_ranges.upper_bound (seq);
+}
+
+TcpSeqRangeSet::ConstIterator
+TcpSeqRangeSet::Begin (void) const
+{
+  return m_ranges.begin ();
+}
+
+TcpSeqRangeSet::ConstIterator
+TcpSeqRangeSet::End (void) const
+{
+  return m_ranges.end ();
+}
+
+uint32_t
+TcpSeqRangeSet::GetBytes (void) const
+{
+  return m_bytes;
+}
+
+uint32_t
+TcpSeqRangeSet::GetNRanges (void) const
+{
+  return static_cast<uint32_t> (m_ranges.size ());
+}
+
+void
+TcpSeqRangeSet::Clear (void)
+{
+  m_ranges.clear ();
+  m_bytes = 0;
+}
+
 TypeId
 TcpTxBuffer::GetTypeId (void)
 {
@@ -57,7 +247,13 @@ TcpTxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpTxBuffer::TcpTxBuffer (uint32_t n)
-  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_data (0)
+  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_data (0),
+    m_lostMark (n),
+    m_rackEnabled (false),
+    m_rackXmitTs (Seconds (0)),
+    m_rackEndSeq (n),
+    m_rackRtt (Seconds (0)),
+    m_rackMinRtt (Time::Max ())
 {
 }
 
@@ -206,6 +402,8 @@ TcpTxBuffer::SetHeadSequence (const SequenceNumber32& seq)
 {
   NS_LOG_FUNCTION (this << seq);
   m_firstByteSeq = seq;
+  m_lostMark = seq;
+  m_rackEndSeq = seq;
 }
 
 void
@@ -248,9 +446,390 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
     {
       m_firstByteSeq = seq;
     }
+
+  // Cumulatively ACKed data leaves the scoreboard
+  m_sacked.DiscardUpTo (seq);
+  m_lost.DiscardUpTo (seq);
+  m_retx.DiscardUpTo (seq);
+  m_pending.DiscardUpTo (seq);
+
+  if (m_sacked.Contains (seq))
+    { // The ACK points into SACKed data: the receiver reneged on it (RFC 2018,
+      // sec. 8). Forget the SACK information, the next SACKs rebuild it
+      NS_LOG_LOGIC ("Peer reneged on SACKed data from " << seq);
+      m_sacked = TcpSeqRangeSet ();
+      m_lostMark = seq;
+      for (std::deque<TcpTxRecord>::iterator r = m_records.begin (); r != m_records.end (); ++r)
+        {
+          r->m_delivered = false;
+        }
+    }
+
+  while (!m_records.empty () && m_records.front ().m_seq + m_records.front ().m_size <= seq)
+    {
+      if (!m_records.front ().m_delivered)
+        {
+          RackUpdate (m_records.front ());
+        }
+      m_records.pop_front ();
+    }
+  if (!m_records.empty () && m_records.front ().m_seq < seq)
+    { // Partially acknowledged segment
+      TcpTxRecord &r = m_records.front ();
+      r.m_size -= seq - r.m_seq;
+      r.m_seq = seq;
+    }
   NS_LOG_LOGIC ("size=" << m_size << " headSeq=" << m_firstByteSeq << " maxBuffer=" << m_maxBuffer
                         <<" numPkts="<< m_data.size ());
   NS_ASSERT (m_firstByteSeq == seq);
 }
 
+uint32_t
+TcpTxBuffer::Update (const TcpOptionSack::SackList &list, uint32_t dupThresh,
+                     uint32_t segmentSize)
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t newlySacked = 0;
+  SequenceNumber32 tail = TailSequence ();
+  for (TcpOptionSack::SackList::const_iterator it = list.begin (); it != list.end (); ++it)
+    {
+      // Trim the block to [SND.UNA, tail); D-SACK and stale blocks vanish
+      SequenceNumber32 begin = std::max (it->first, m_firstByteSeq.Get ());
+      SequenceNumber32 end = std::min (it->second, tail);
+      if (end <= begin)
+        {
+          NS_LOG_LOGIC ("Ignoring SACK block [" << it->first << ";" << it->second << ")");
+          continue;
+        }
+
+      uint32_t added = m_sacked.Add (begin, end);
+      if (added == 0)
+        {
+          continue;
+        }
+      newlySacked += added;
+      m_lost.Remove (begin, end);
+      m_retx.Remove (begin, end);
+      m_pending.Remove (begin, end);
+
+      if (m_rackEnabled)
+        {
+          for (std::deque<TcpTxRecord>::iterator r = FindRecord (begin);
+               r != m_records.end () && r->m_seq < end; ++r)
+            {
+              if (r->m_delivered)
+                {
+                  continue;
+                }
+              TcpSeqRangeSet::ConstIterator range = m_sacked.Find (r->m_seq);
+              if (range != m_sacked.End () && range->second >= r->m_seq + r->m_size)
+                {
+                  r->m_delivered = true;
+                  RackUpdate (*r);
+                }
+            }
+        }
+    }
+
+  if (newlySacked > 0)
+    {
+      UpdateLostBoundary (dupThresh, segmentSize);
+    }
+
+  NS_LOG_LOGIC ("Newly SACKed " << newlySacked << " bytes, SACKed=" << m_sacked.GetBytes () <<
+                " lost=" << m_lost.GetBytes () << " retx=" << m_retx.GetBytes ());
+  return newlySacked;
+}
+
+void
+TcpTxBuffer::UpdateLostBoundary (uint32_t dupThresh, uint32_t segmentSize)
+{
+  NS_LOG_FUNCTION (this << dupThresh << segmentSize);
+
+  // Walk the SACKed ranges from the highest one, until enough discontiguous
+  // ranges or bytes are found above the left edge of a range: every hole
+  // below that edge is lost (RFC 6675, IsLost ())
+  uint32_t ranges = 0;
+  uint32_t bytes = 0;
+  bool found = false;
+  SequenceNumber32 boundary = m_firstByteSeq;
+  TcpSeqRangeSet::ConstIterator it = m_sacked.End ();
+  while (it != m_sacked.Begin ())
+    {
+      --it;
+      ++ranges;
+      bytes += it->second - it->first;
+      if (ranges >= dupThresh || bytes > (dupThresh - 1) * segmentSize)
+        {
+          boundary = it->first;
+          found = true;
+          break;
+        }
+    }
+
+  if (!found)
+    {
+      return;
+    }
+
+  // Holes below m_lostMark have already been marked
+  SequenceNumber32 s = std::max (m_lostMark, m_firstByteSeq.Get ());
+  while (s < boundary)
+    {
+      TcpSeqRangeSet::ConstIterator r = m_sacked.Find (s);
+      if (r != m_sacked.End ())
+        {
+          s = r->second;
+          continue;
+        }
+      TcpSeqRangeSet::ConstIterator next = m_sacked.UpperBound (s);
+      SequenceNumber32 holeEnd = boundary;
+      if (next != m_sacked.End () && next->first < boundary)
+        {
+          holeEnd = next->first;
+        }
+      NS_LOG_LOGIC ("Hole [" << s << ";" << holeEnd << ") is lost");
+      m_lost.Add (s, holeEnd);
+      m_pending.AddExcluding (s, holeEnd, m_retx);
+      s = holeEnd;
+    }
+
+  if (m_lostMark < boundary)
+    {
+      m_lostMark = boundary;
+    }
+}
+
+bool
+TcpTxBuffer::IsSacked (const SequenceNumber32 &seq) const
+{
+  return m_sacked.Contains (seq);
+}
+
+bool
+TcpTxBuffer::IsLost (const SequenceNumber32 &seq) const
+{
+  return m_lost.Contains (seq);
+}
+
+void
+TcpTxBuffer::MarkLost (const SequenceNumber32 &seq, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << seq << size);
+
+  SequenceNumber32 end = std::min (seq + SequenceNumber32 (size), TailSequence ());
+  SequenceNumber32 s = std::max (seq, m_firstByteSeq.Get ());
+  while (s < end)
+    {
+      TcpSeqRangeSet::ConstIterator r = m_sacked.Find (s);
+      if (r != m_sacked.End ())
+        {
+          s = r->second;
+          continue;
+        }
+      TcpSeqRangeSet::ConstIterator next = m_sacked.UpperBound (s);
+      SequenceNumber32 holeEnd = end;
+      if (next != m_sacked.End () && next->first < end)
+        {
+          holeEnd = next->first;
+        }
+      m_lost.Add (s, holeEnd);
+      m_retx.Remove (s, holeEnd);
+      m_pending.Add (s, holeEnd);
+      s = holeEnd;
+    }
+}
+
+void
+TcpTxBuffer::MarkTransmitted (const SequenceNumber32 &seq, uint32_t size,
+                              bool isRetransmission)
+{
+  NS_LOG_FUNCTION (this << seq << size << isRetransmission);
+
+  if (size == 0)
+    {
+      return;
+    }
+
+  SequenceNumber32 end = seq + SequenceNumber32 (size);
+  if (isRetransmission)
+    {
+      m_retx.AddExcluding (seq, end, m_sacked);
+      m_pending.Remove (seq, end);
+    }
+
+  if (!m_rackEnabled)
+    {
+      return;
+    }
+
+  if (m_records.empty () || m_records.back ().m_seq + m_records.back ().m_size <= seq)
+    {
+      TcpTxRecord record;
+      record.m_seq = seq;
+      record.m_size = size;
+      record.m_xmitTime = Simulator::Now ();
+      record.m_retx = isRetransmission;
+      record.m_delivered = false;
+      record.m_lost = false;
+      m_records.push_back (record);
+      return;
+    }
+
+  // Retransmission of already recorded segments: refresh their send time
+  for (std::deque<TcpTxRecord>::iterator r = FindRecord (seq);
+       r != m_records.end () && r->m_seq < end; ++r)
+    {
+      r->m_xmitTime = Simulator::Now ();
+      r->m_retx = true;
+      r->m_lost = false;
+    }
+}
+
+bool
+TcpTxBuffer::NextSeg (SequenceNumber32 *seq, uint32_t *length) const
+{
+  TcpSeqRangeSet::ConstIterator it = m_pending.Begin ();
+  if (it == m_pending.End ())
+    {
+      return false;
+    }
+  *seq = it->first;
+  *length = it->second - it->first;
+  return true;
+}
+
+uint32_t
+TcpTxBuffer::BytesInFlight (const SequenceNumber32 &highTxMark) const
+{
+  if (highTxMark <= m_firstByteSeq)
+    {
+      return 0;
+    }
+
+  int64_t pipe = static_cast<int64_t> (highTxMark - m_firstByteSeq.Get ())
+    - m_sacked.GetBytes () - m_lost.GetBytes () + m_retx.GetBytes ();
+
+  return pipe > 0 ? static_cast<uint32_t> (pipe) : 0;
+}
+
+uint32_t
+TcpTxBuffer::GetSackedBytes (void) const
+{
+  return m_sacked.GetBytes ();
+}
+
+uint32_t
+TcpTxBuffer::GetLostBytes (void) const
+{
+  return m_lost.GetBytes ();
+}
+
+void
+TcpTxBuffer::SetRackEnabled (bool enabled)
+{
+  NS_LOG_FUNCTION (this << enabled);
+  m_rackEnabled = enabled;
+  if (!enabled)
+    {
+      m_records.clear ();
+    }
+}
+
+void
+TcpTxBuffer::RackUpdate (const TcpTxRecord &record)
+{
+  Time rtt = Simulator::Now () - record.m_xmitTime;
+
+  if (record.m_retx && rtt < m_rackMinRtt)
+    { // The ACK may be for the original transmission: ambiguous sample
+      return;
+    }
+  if (!record.m_retx && rtt < m_rackMinRtt)
+    {
+      m_rackMinRtt = rtt;
+    }
+
+  m_rackRtt = rtt;
+  SequenceNumber32 end = record.m_seq + SequenceNumber32 (record.m_size);
+  if (record.m_xmitTime > m_rackXmitTs
+      || (record.m_xmitTime == m_rackXmitTs && end > m_rackEndSeq))
+    {
+      m_rackXmitTs = record.m_xmitTime;
+      m_rackEndSeq = end;
+    }
+}
+
+Time
+TcpTxBuffer::RackDetectLoss (bool *newLoss)
+{
+  NS_LOG_FUNCTION (this);
+
+  *newLoss = false;
+  if (!m_rackEnabled || m_rackXmitTs.IsZero ())
+    {
+      return Time (0);
+    }
+
+  Time now = Simulator::Now ();
+  Time reoWnd = m_rackMinRtt / 4;
+  Time timeout (0);
+
+  for (std::deque<TcpTxRecord>::iterator r = m_records.begin (); r != m_records.end (); ++r)
+    {
+      if (r->m_delivered || r->m_lost)
+        {
+          continue;
+        }
+
+      // Only segments sent before the most recently delivered one
+      SequenceNumber32 end = r->m_seq + SequenceNumber32 (r->m_size);
+      if (r->m_xmitTime > m_rackXmitTs
+          || (r->m_xmitTime == m_rackXmitTs && end >= m_rackEndSeq))
+        {
+          continue;
+        }
+
+      Time remaining = r->m_xmitTime + m_rackRtt + reoWnd - now;
+      if (!remaining.IsStrictlyPositive ())
+        {
+          NS_LOG_LOGIC ("RACK: segment " << r->m_seq << " sent at " <<
+                        r->m_xmitTime.GetSeconds () << " is lost");
+          MarkLost (r->m_seq, r->m_size);
+          r->m_lost = true;
+          *newLoss = true;
+        }
+      else if (remaining > timeout)
+        {
+          timeout = remaining;
+        }
+    }
+
+  return timeout;
+}
+
+std::deque<TcpTxBuffer::TcpTxRecord>::iterator
+TcpTxBuffer::FindRecord (const SequenceNumber32 &seq)
+{
+  // Binary search of the first record ending after seq
+  std::deque<TcpTxRecord>::iterator first = m_records.begin ();
+  std::deque<TcpTxRecord>::difference_type count = m_records.size ();
+  while (count > 0)
+    {
+      std::deque<TcpTxRecord>::difference_type step = count / 2;
+      std::deque<TcpTxRecord>::iterator it = first + step;
+      if (it->m_seq + SequenceNumber32 (it->m_size) <= seq)
+        {
+          first = ++it;
+          count -= step + 1;
+        }
+      else
+        {
+          count = step;
+        }
+    }
+  return first;
+}
+
 } // namepsace ns3
@@ -22,20 +22,141 @@
 #define TCP_TX_BUFFER_H
 
 #include <list>
+#include <map>
+#include <deque>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/object.h"
 #include "ns3/sequence-number.h"
 #include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/tcp-option-sack.h"
 
 namespace ns3 {
 class Packet;
 
+/**
+ * \ingroup tcp
+ *
+ * \brief Set of disjoint sequence number ranges
+ *
+ * Each range is stored as [begin, end) in a balanced tree keyed by its left
+ * edge. Overlapping or adjacent ranges are merged on insertion, so lookups,
+ * insertions and removals cost O(log n) in the number of ranges, whatever
+ * the number of segments they cover. The number of bytes covered by the
+ * set is maintained incrementally.
+ */
+class TcpSeqRangeSet
+{
+public:
+  /// Container of the ranges: left edge -> right edge
+  typedef std::map<SequenceNumber32, SequenceNumber32> RangeMap;
+  /// Const iterator over the ranges
+  typedef RangeMap::const_iterator ConstIterator;
+
+  TcpSeqRangeSet ();
+
+  /**
+   * \brief Add the range [begin, end) to the set
+   * \param begin left edge of the range
+   * \param end right edge of the range
+   * \returns the number of bytes that were not in the set before
+   */
+  uint32_t Add (const SequenceNumber32 &begin, const SequenceNumber32 &end);
+
+  /**
+   * \brief Add the parts of [begin, end) that are not covered by another set
+   * \param begin left edge of the range
+   * \param end right edge of the range
+   * \param excluded the ranges to leave out
+   * \returns the number of bytes that were not in the set before
+   */
+  uint32_t AddExcluding (const SequenceNumber32 &begin, const SequenceNumber32 &end,
+                         const TcpSeqRangeSet &excluded);
+
+  /**
+   * \brief Remove the range [begin, end) from the set
+   * \param begin left edge of the range
+   * \param end right edge of the range
+   * \returns the number of bytes removed from the set
+   */
+  uint32_t Remove (const SequenceNumber32 &begin, const SequenceNumber32 &end);
+
+  /**
+   * \brief Remove everything below seq
+   * \param seq the first sequence number to keep
+   */
+  void DiscardUpTo (const SequenceNumber32 &seq);
+
+  /**
+   * \brief Check if a sequence number is in the set
+   * \param seq the sequence number
+   * \returns true if seq is covered by one of the ranges
+   */
+  bool Contains (const SequenceNumber32 &seq) const;
+
+  /**
+   * \brief Get the range containing seq
+   * \param seq the sequence number
+   * \returns an iterator to the range, or End () if seq is not in the set
+   */
+  ConstIterator Find (const SequenceNumber32 &seq) const;
+
+  /**
+   * \brief Get the first range that starts after seq
+   * \param seq the sequence number
+   * \returns an iterator to the range, or End () if there is none
+   */
+  ConstIterator UpperBound (const SequenceNumber32 &seq) const;
+
+  /**
+   * \returns an iterator to the lowest range
+   */
+  ConstIterator Begin (void) const;
+
+  /**
+   * \returns the past-the-end iterator
+   */
+  ConstIterator End (void) const;
+
+  /**
+   * \returns the number of bytes covered by the set
+   */
+  uint32_t GetBytes (void) const;
+
+  /**
+   * \returns the number of disjoint ranges in the set
+   */
+  uint32_t GetNRanges (void) const;
+
+  /**
+   * \brief Empty the set
+   */
+  void Clear (void);
+
+private:
+  RangeMap m_ranges; //!< Ranges, keyed by their left edge
+  uint32_t m_bytes;  //!< Number of bytes covered
+};
+
 /**
  * \ingroup tcp
  *
  * \brief class for keeping the data sent by the application to the TCP socket, i.e.
  *        the sending buffer.
+ *
+ * Besides the data, the buffer keeps the SACK scoreboard of the connection
+ * (\RFC{6675}): the ranges reported as received by the peer through the
+ * SACK option, the ranges considered lost and the ranges retransmitted
+ * since they were marked lost. All of them are TcpSeqRangeSet, so the cost
+ * of an update depends on the number of holes rather than on the amount of
+ * outstanding data. The scoreboard is populated only when the socket feeds
+ * it, i.e. when SACK has been negotiated.
+ *
+ * Optionally, the buffer records the transmission time of each segment to
+ * run the RACK time-based loss detection (draft-ietf-tcpm-rack): a segment
+ * is deemed lost when another segment sent at least a reordering window
+ * later has already been delivered.
  */
 class TcpTxBuffer : public Object
 {
@@ -123,11 +244,151 @@ public:
   /**
    * Discard data up to but not including this sequence number.
    *
+   * The cumulatively ACKed data leaves the scoreboard. If the ACK points
+   * into SACKed data, the peer has reneged on it: the SACK information is
+   * dropped, so that the data can be marked lost again.
+   *
    * \param seq The sequence number of the head byte
    */
   void DiscardUpTo (const SequenceNumber32& seq);
 
+  /**
+   * \brief Update the scoreboard with the blocks of a received SACK option
+   *
+   * Blocks below SND.UNA or beyond the data in the buffer are trimmed. Holes
+   * that, per \RFC{6675}, have at least dupThresh discontiguous SACKed
+   * blocks or more than (dupThresh - 1) * segmentSize SACKed bytes above
+   * them are marked lost.
+   *
+   * \param list the SACK list received
+   * \param dupThresh the duplicate ACK threshold
+   * \param segmentSize the sender maximum segment size
+   * \returns the number of bytes newly SACKed
+   */
+  uint32_t Update (const TcpOptionSack::SackList &list, uint32_t dupThresh,
+                   uint32_t segmentSize);
+
+  /**
+   * \brief Check if a sequence number has been SACKed by the peer
+   * \param seq the sequence number
+   * \returns true if the byte has been SACKed
+   */
+  bool IsSacked (const SequenceNumber32 &seq) const;
+
+  /**
+   * \brief Check if a sequence number is considered lost
+   * \param seq the sequence number
+   * \returns true if the byte is considered lost
+   */
+  bool IsLost (const SequenceNumber32 &seq) const;
+
+  /**
+   * \brief Mark [seq, seq + size) as lost, excluding the SACKed bytes
+   *
+   * The range becomes eligible again for retransmission through NextSeg ().
+   *
+   * \param seq first sequence number of the range
+   * \param size size of the range
+   */
+  void MarkLost (const SequenceNumber32 &seq, uint32_t size);
+
+  /**
+   * \brief Record that [seq, seq + size) has been sent
+   *
+   * Retransmitted ranges are accounted in the pipe until they are
+   * acknowledged. If RACK is enabled, the transmission time is recorded.
+   *
+   * \param seq first sequence number sent
+   * \param size number of bytes sent
+   * \param isRetransmission true if the range was already sent before
+   */
+  void MarkTransmitted (const SequenceNumber32 &seq, uint32_t size,
+                        bool isRetransmission);
+
+  /**
+   * \brief Find the next segment to retransmit (\RFC{6675} NextSeg (), rule 1)
+   *
+   * \param seq output: first sequence number of the lost range
+   * \param length output: length of the lost, not retransmitted range
+   * \returns true if a lost range that has not been retransmitted exists
+   */
+  bool NextSeg (SequenceNumber32 *seq, uint32_t *length) const;
+
+  /**
+   * \brief Estimate the data in flight (\RFC{6675} SetPipe ())
+   *
+   * pipe = outstanding - SACKed - lost + retransmitted, where outstanding
+   * is the data between SND.UNA and highTxMark.
+   *
+   * \param highTxMark highest sequence number ever sent
+   * \returns the number of bytes considered in flight
+   */
+  uint32_t BytesInFlight (const SequenceNumber32 &highTxMark) const;
+
+  /**
+   * \returns the number of bytes SACKed by the peer
+   */
+  uint32_t GetSackedBytes (void) const;
+
+  /**
+   * \returns the number of bytes marked lost (retransmitted or not)
+   */
+  uint32_t GetLostBytes (void) const;
+
+  /**
+   * \brief Enable or disable the recording of transmission times for RACK
+   * \param enabled true to enable RACK
+   */
+  void SetRackEnabled (bool enabled);
+
+  /**
+   * \brief Run the RACK loss detection
+   *
+   * The reference is the most recent transmission time of a delivered
+   * segment (RACK.xmit_ts). The unacknowledged segments sent before it are
+   * marked lost when RACK.rtt plus the reordering window (min RTT / 4) have
+   * elapsed since their own transmission.
+   *
+   * \param newLoss output: true if at least one segment has been marked lost
+   * \returns the time until the last of the segments sent before RACK.xmit_ts
+   * that are not overdue yet would be marked lost, or zero if there is none
+   */
+  Time RackDetectLoss (bool *newLoss);
+
 private:
+  /**
+   * \brief Transmission record of a segment, used by RACK
+   */
+  struct TcpTxRecord
+  {
+    SequenceNumber32 m_seq;      //!< First sequence number
+    uint32_t         m_size;     //!< Segment size
+    Time             m_xmitTime; //!< Time of the last (re)transmission
+    bool             m_retx;     //!< Segment has been retransmitted
+    bool             m_delivered; //!< Segment has been SACKed
+    bool             m_lost;     //!< Segment has been marked lost by RACK
+  };
+
+  /**
+   * \brief Mark lost the holes below the RFC 6675 IsLost () boundary
+   * \param dupThresh the duplicate ACK threshold
+   * \param segmentSize the sender maximum segment size
+   */
+  void UpdateLostBoundary (uint32_t dupThresh, uint32_t segmentSize);
+
+  /**
+   * \brief Update the RACK state with a delivered segment
+   * \param record the delivered segment
+   */
+  void RackUpdate (const TcpTxRecord &record);
+
+  /**
+   * \brief Get the first record whose data extends beyond seq
+   * \param seq the sequence number
+   * \returns an iterator to the record
+   */
+  std::deque<TcpTxRecord>::iterator FindRecord (const SequenceNumber32 &seq);
+
   /// container for data stored in the buffer
   typedef std::list<Ptr<Packet> >::iterator BufIterator;
 
@@ -135,6 +396,21 @@ private:
   uint32_t m_size;                              //!< Number of data bytes
   uint32_t m_maxBuffer;                         //!< Max number of data bytes in buffer (SND.WND)
   std::list<Ptr<Packet> > m_data;               //!< Corresponding data (may be null)
+
+  // SACK scoreboard
+  TcpSeqRangeSet   m_sacked;     //!< Ranges SACKed by the peer
+  TcpSeqRangeSet   m_lost;       //!< Ranges considered lost
+  TcpSeqRangeSet   m_retx;       //!< Ranges retransmitted, not yet acknowledged
+  TcpSeqRangeSet   m_pending;    //!< Ranges lost and not retransmitted yet
+  SequenceNumber32 m_lostMark;   //!< Holes below this have been checked by IsLost ()
+
+  // RACK
+  bool             m_rackEnabled; //!< Record transmission times for RACK
+  std::deque<TcpTxRecord> m_records; //!< Transmission records, in sequence order
+  Time             m_rackXmitTs;  //!< Most recent transmission time of a delivered segment
+  SequenceNumber32 m_rackEndSeq;  //!< End sequence of that segment
+  Time             m_rackRtt;     //!< RTT of the most recently delivered segment
+  Time             m_rackMinRtt;  //!< Minimum RTT seen over delivered segments
 };
 
 } // namepsace ns3
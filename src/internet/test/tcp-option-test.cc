@@ -22,6 +22,8 @@
 #include "ns3/tcp-option.h"
 #include "ns3/private/tcp-option-winscale.h"
 #include "ns3/private/tcp-option-ts.h"
+#include "ns3/tcp-option-sack.h"
+#include "ns3/tcp-option-sack-permitted.h"
 
 #include <string.h>
 
@@ -164,6 +166,70 @@ TcpOptionTSTestCase::DoTeardown ()
 {
 }
 
+class TcpOptionSackTestCase : public TestCase
+{
+public:
+  TcpOptionSackTestCase (std::string name, uint32_t nBlocks);
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_nBlocks;
+};
+
+TcpOptionSackTestCase::TcpOptionSackTestCase (std::string name, uint32_t nBlocks)
+  : TestCase (name),
+    m_nBlocks (nBlocks)
+{
+}
+
+void
+TcpOptionSackTestCase::DoRun ()
+{
+  Buffer buffer;
+  TcpOptionSack opt;
+
+  for (uint32_t i = 0; i < m_nBlocks; ++i)
+    {
+      opt.AddSackBlock (std::make_pair (SequenceNumber32 (1000 * i + 1),
+                                        SequenceNumber32 (1000 * i + 501)));
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (opt.GetSerializedSize (), 2 + 8 * m_nBlocks, "Wrong size");
+
+  buffer.AddAtStart (opt.GetSerializedSize ());
+  opt.Serialize (buffer.Begin ());
+
+  NS_TEST_EXPECT_MSG_EQ (buffer.Begin ().PeekU8 (), TcpOption::SACK, "Different kind found");
+
+  TcpOptionSack read;
+  NS_TEST_ASSERT_MSG_EQ (read.Deserialize (buffer.Begin ()), opt.GetSerializedSize (),
+                         "Deserialization failed");
+  NS_TEST_ASSERT_MSG_EQ (read.GetNumSackBlocks (), m_nBlocks, "Different number of blocks");
+
+  TcpOptionSack::SackList written = opt.GetSackList ();
+  TcpOptionSack::SackList received = read.GetSackList ();
+  TcpOptionSack::SackList::iterator w = written.begin ();
+  for (TcpOptionSack::SackList::iterator r = received.begin (); r != received.end (); ++r, ++w)
+    {
+      NS_TEST_EXPECT_MSG_EQ (r->first, w->first, "Different left edge");
+      NS_TEST_EXPECT_MSG_EQ (r->second, w->second, "Different right edge");
+    }
+
+  // With the timestamp option in, there is room for three blocks only
+  NS_TEST_EXPECT_MSG_EQ (TcpOptionSack::GetMaxSackBlocks (40), 4, "Wrong max blocks");
+  NS_TEST_EXPECT_MSG_EQ (TcpOptionSack::GetMaxSackBlocks (40 - 10), 3, "Wrong max blocks");
+
+  Buffer permittedBuffer;
+  TcpOptionSackPermitted permitted;
+  permittedBuffer.AddAtStart (permitted.GetSerializedSize ());
+  permitted.Serialize (permittedBuffer.Begin ());
+  NS_TEST_EXPECT_MSG_EQ (permittedBuffer.Begin ().PeekU8 (), TcpOption::SACKPERMITTED,
+                         "Different kind found");
+  NS_TEST_EXPECT_MSG_EQ (permitted.Deserialize (permittedBuffer.Begin ()), 2,
+                         "Deserialization failed");
+}
+
 static class TcpOptionTestSuite : public TestSuite
 {
 public:
@@ -176,6 +242,10 @@ public:
                                               "scale value", i), TestCase::QUICK);
       }
     AddTestCase (new TcpOptionTSTestCase ("Testing serialization of random values for timestamp"), TestCase::QUICK);
+    for (uint32_t i = 1; i <= 4; ++i)
+      {
+        AddTestCase (new TcpOptionSackTestCase ("Testing SACK option", i), TestCase::QUICK);
+      }
   }
 
 } g_TcpOptionTestSuite;
@@ -0,0 +1,392 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "tcp-general-test.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/queue-disc.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpPacingGsoTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the time between the data segments of a paced sender
+ *
+ * Once the pacing rate is known, a data segment may not be sent before
+ * the transmission time, at the pacing rate, of the previous one. Without
+ * pacing, the segments allowed by the window leave in a burst.
+ */
+class TcpPacingTest : public TcpGeneralTest
+{
+public:
+  /**
+   * \brief Constructor
+   * \param desc the test description
+   * \param pacing whether the sender paces its segments
+   */
+  TcpPacingTest (const std::string &desc, bool pacing);
+
+protected:
+  virtual void ConfigureEnvironment ();
+  virtual void ConfigureProperties ();
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void FinalChecks ();
+
+  bool m_pacing;             //!< Whether the sender paces its segments
+  Time m_lastTx;             //!< The time of the last data segment
+  Time m_nextTx;             //!< The earliest time of the next data segment
+  uint32_t m_pacedSegments;  //!< Number of segments sent at a known pacing rate
+  uint32_t m_burstSegments;  //!< Number of segments sent at the time of the previous one
+};
+
+TcpPacingTest::TcpPacingTest (const std::string &desc, bool pacing)
+  : TcpGeneralTest (desc),
+    m_pacing (pacing),
+    m_lastTx (Seconds (-1)),
+    m_nextTx (Seconds (0)),
+    m_pacedSegments (0),
+    m_burstSegments (0)
+{
+}
+
+void
+TcpPacingTest::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktCount (200);
+  SetAppPktInterval (MicroSeconds (100));
+  SetPropagationDelay (MilliSeconds (50));
+}
+
+void
+TcpPacingTest::ConfigureProperties ()
+{
+  TcpGeneralTest::ConfigureProperties ();
+  SetInitialCwnd (SENDER, 10);
+  GetSenderSocket ()->SetAttribute ("Pacing", BooleanValue (m_pacing));
+}
+
+void
+TcpPacingTest::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who != SENDER || p->GetSize () == 0)
+    {
+      return;
+    }
+
+  Time now = Simulator::Now ();
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (now, m_nextTx, "Segment " << h.GetSequenceNumber () <<
+                               " sent before its pacing time");
+  if (now == m_lastTx)
+    {
+      m_burstSegments++;
+    }
+  m_lastTx = now;
+
+  DataRate rate = GetTcb (SENDER)->m_pacingRate;
+  if (m_pacing && rate.GetBitRate () > 0)
+    {
+      m_nextTx = now + rate.CalculateBytesTxTime (p->GetSize ());
+      m_pacedSegments++;
+    }
+}
+
+void
+TcpPacingTest::FinalChecks ()
+{
+  if (m_pacing)
+    {
+      NS_TEST_ASSERT_MSG_GT (m_pacedSegments, 0u, "No segment has been paced");
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_GT (m_burstSegments, 0u, "No segments have been sent in a burst");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the split of the super-segments of segmentation offload
+ *
+ * With GsoMaxSegments, the socket hands down super-segments of up to this
+ * number of segments. TCP, IP and the queue disc handle each super-segment
+ * once, and it is split when dequeued from the queue disc: the device and the
+ * receiver only see segments of at most one MSS, with consecutive sequence
+ * numbers and IP identifications.
+ */
+class TcpGsoTest : public TcpGeneralTest
+{
+public:
+  /**
+   * \brief Constructor
+   * \param desc the test description
+   * \param gsoMaxSegments the maximum number of segments of a super-segment
+   */
+  TcpGsoTest (const std::string &desc, uint32_t gsoMaxSegments);
+
+protected:
+  virtual void ConfigureEnvironment ();
+  virtual void ConfigureProperties ();
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void Rx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void DataSent (uint32_t size, SocketWho who);
+  virtual void FinalChecks ();
+
+  /**
+   * \brief Count a data packet sent by the IP layer of the sender
+   * \param p the packet
+   * \param ipv4 the IP layer
+   * \param interface the interface
+   */
+  void IpTx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface);
+
+  /**
+   * \brief Count a data packet enqueued in the queue disc of the sender
+   * \param item the queue disc item
+   */
+  void QueueDiscEnqueue (Ptr<const QueueItem> item);
+
+  /**
+   * \brief Check a packet enqueued in the device of the sender
+   * \param p the packet
+   */
+  void DeviceEnqueue (Ptr<const Packet> p);
+
+  uint32_t m_gsoMaxSegments;  //!< Maximum number of segments of a super-segment
+  SequenceNumber32 m_nextSeq; //!< The next sequence number sent
+  uint32_t m_maxDataSent;     //!< The largest amount of data sent at once
+  uint32_t m_tcpPackets;      //!< Number of data packets sent by TCP
+  uint32_t m_ipPackets;       //!< Number of data packets sent by IP
+  uint32_t m_qdiscPackets;    //!< Number of data packets enqueued in the queue disc
+  uint32_t m_segments;        //!< Number of segments of the data packets sent by TCP
+  uint32_t m_deviceSegments;  //!< Number of data segments enqueued in the device
+  uint32_t m_devicePackets;   //!< Number of packets enqueued in the device
+  uint16_t m_nextId;          //!< The next IP identification
+  uint32_t m_rxBytes;         //!< Number of bytes received
+  bool m_finReceived;         //!< Whether the receiver got the FIN
+};
+
+TcpGsoTest::TcpGsoTest (const std::string &desc, uint32_t gsoMaxSegments)
+  : TcpGeneralTest (desc),
+    m_gsoMaxSegments (gsoMaxSegments),
+    m_maxDataSent (0),
+    m_tcpPackets (0),
+    m_ipPackets (0),
+    m_qdiscPackets (0),
+    m_segments (0),
+    m_deviceSegments (0),
+    m_devicePackets (0),
+    m_nextId (0),
+    m_rxBytes (0),
+    m_finReceived (false)
+{
+}
+
+void
+TcpGsoTest::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktCount (100);
+  SetAppPktInterval (MicroSeconds (100));
+  SetPropagationDelay (MilliSeconds (50));
+}
+
+void
+TcpGsoTest::ConfigureProperties ()
+{
+  TcpGeneralTest::ConfigureProperties ();
+  SetInitialCwnd (SENDER, 10);
+  GetSenderSocket ()->SetAttribute ("GsoMaxSegments", UintegerValue (m_gsoMaxSegments));
+
+  Ptr<Node> node = GetSenderSocket ()->GetNode ();
+  node->GetObject<Ipv4L3Protocol> ()->TraceConnectWithoutContext (
+    "Tx", MakeCallback (&TcpGsoTest::IpTx, this));
+  for (uint32_t i = 0; i < node->GetNDevices (); i++)
+    {
+      Ptr<SimpleNetDevice> device = DynamicCast<SimpleNetDevice> (node->GetDevice (i));
+      if (device == 0)
+        {
+          continue;
+        }
+      Ptr<QueueDisc> qdisc = node->GetObject<TrafficControlLayer> ()->GetRootQueueDiscOnDevice (device);
+      NS_TEST_ASSERT_MSG_NE (qdisc, 0, "The device of the sender has no queue disc");
+      qdisc->TraceConnectWithoutContext ("Enqueue", MakeCallback (&TcpGsoTest::QueueDiscEnqueue, this));
+      device->GetQueue ()->TraceConnectWithoutContext ("Enqueue", MakeCallback (&TcpGsoTest::DeviceEnqueue, this));
+    }
+}
+
+void
+TcpGsoTest::IpTx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  Ptr<Packet> copy = p->Copy ();
+  Ipv4Header ipHeader;
+  copy->RemoveHeader (ipHeader);
+  TcpHeader tcpHeader;
+  copy->RemoveHeader (tcpHeader);
+  if (copy->GetSize () > 0)
+    {
+      m_ipPackets++;
+    }
+}
+
+void
+TcpGsoTest::QueueDiscEnqueue (Ptr<const QueueItem> item)
+{
+  Ptr<Packet> copy = item->GetPacket ()->Copy ();
+  TcpHeader tcpHeader;
+  copy->RemoveHeader (tcpHeader);
+  if (copy->GetSize () > 0)
+    {
+      m_qdiscPackets++;
+    }
+}
+
+void
+TcpGsoTest::DeviceEnqueue (Ptr<const Packet> p)
+{
+  Ptr<Packet> copy = p->Copy ();
+  Ipv4Header ipHeader;
+  copy->RemoveHeader (ipHeader);
+  NS_TEST_ASSERT_MSG_EQ (ipHeader.GetPayloadSize (), copy->GetSize (), "Wrong IP payload size");
+  if (m_devicePackets > 0)
+    {
+      NS_TEST_ASSERT_MSG_EQ (ipHeader.GetIdentification (), m_nextId,
+                             "The IP identifications do not follow each other");
+    }
+  m_nextId = ipHeader.GetIdentification () + 1;
+  m_devicePackets++;
+
+  TcpHeader tcpHeader;
+  copy->RemoveHeader (tcpHeader);
+  if (copy->GetSize () > 0)
+    {
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (copy->GetSize (), GetSegSize (SENDER),
+                                   "The device got a segment larger than the MSS");
+      m_deviceSegments++;
+    }
+}
+
+void
+TcpGsoTest::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who != SENDER || p->GetSize () == 0)
+    {
+      return;
+    }
+
+  uint32_t segSize = GetSegSize (SENDER);
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (p->GetSize (), m_gsoMaxSegments * segSize,
+                               "TCP sent a super-segment larger than GsoMaxSegments segments");
+  if (m_tcpPackets > 0)
+    {
+      NS_TEST_ASSERT_MSG_EQ (h.GetSequenceNumber (), m_nextSeq,
+                             "The segments do not follow each other");
+    }
+  m_nextSeq = h.GetSequenceNumber () + SequenceNumber32 (p->GetSize ());
+  m_tcpPackets++;
+  m_segments += (p->GetSize () + segSize - 1) / segSize;
+}
+
+void
+TcpGsoTest::Rx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who != RECEIVER)
+    {
+      return;
+    }
+
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (p->GetSize (), GetSegSize (SENDER),
+                               "The receiver got a segment larger than the MSS");
+  if (p->GetSize () > 0)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_finReceived, false, "Data received after the FIN");
+    }
+  m_rxBytes += p->GetSize ();
+  if (h.GetFlags () & TcpHeader::FIN)
+    {
+      m_finReceived = true;
+    }
+}
+
+void
+TcpGsoTest::DataSent (uint32_t size, SocketWho who)
+{
+  if (who == SENDER)
+    {
+      m_maxDataSent = std::max (m_maxDataSent, size);
+    }
+}
+
+void
+TcpGsoTest::FinalChecks ()
+{
+  uint32_t segSize = GetSegSize (SENDER);
+  NS_TEST_ASSERT_MSG_EQ (m_maxDataSent, m_gsoMaxSegments * segSize,
+                         "The socket did not send full super-segments");
+  NS_TEST_ASSERT_MSG_EQ (m_ipPackets, m_tcpPackets, "IP did not send the packets of TCP as they are");
+  NS_TEST_ASSERT_MSG_EQ (m_qdiscPackets, m_tcpPackets,
+                         "The queue disc did not get the packets of TCP as they are");
+  NS_TEST_ASSERT_MSG_EQ (m_deviceSegments, m_segments,
+                         "The device did not get every segment of the super-segments");
+  if (m_gsoMaxSegments > 1)
+    {
+      NS_TEST_ASSERT_MSG_LT (m_qdiscPackets, m_deviceSegments,
+                             "IP and the queue disc handled each segment of the bursts");
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_qdiscPackets, m_deviceSegments,
+                             "Packets sent without segmentation offload have been split");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_rxBytes, GetPktSize () * GetPktCount (), "Data lost");
+  NS_TEST_ASSERT_MSG_EQ (m_finReceived, true, "The FIN has not been received");
+}
+
+//-----------------------------------------------------------------------------
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP pacing and segmentation offload TestSuite
+ */
+static class TcpPacingGsoTestSuite : public TestSuite
+{
+public:
+  TcpPacingGsoTestSuite () : TestSuite ("tcp-pacing-gso", UNIT)
+  {
+    AddTestCase (new TcpPacingTest ("Segments sent in bursts without pacing", false),
+                 TestCase::QUICK);
+    AddTestCase (new TcpPacingTest ("Segments spaced by their transmission time with pacing", true),
+                 TestCase::QUICK);
+    AddTestCase (new TcpGsoTest ("Segments sent one by one without segmentation offload", 1),
+                 TestCase::QUICK);
+    AddTestCase (new TcpGsoTest ("Super-segments split in segments of one MSS at the queue disc", 4),
+                 TestCase::QUICK);
+  }
+} g_tcpPacingGsoTestSuite;
+
+} // namespace ns3
@@ -0,0 +1,349 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-rx-buffer.h"
+#include "ns3/tcp-option-sack.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Base class of the TcpRxBuffer tests: segments carry the bytes
+ * of a stream whose byte of sequence number s is a function of s, so
+ * that the data extracted can be checked whatever the way it was
+ * received.
+ */
+class TcpRxBufferBaseTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param name Test description
+   */
+  TcpRxBufferBaseTestCase (std::string name);
+
+protected:
+  /**
+   * \brief Add a segment of the stream to the buffer
+   * \param rxBuf The buffer
+   * \param seq The sequence number of the segment
+   * \param size The size of the segment
+   * \return The value returned by TcpRxBuffer::Add
+   */
+  bool AddSegment (TcpRxBuffer &rxBuf, SequenceNumber32 seq, uint32_t size);
+
+  /**
+   * \brief Extract data from the buffer and check its content
+   * \param rxBuf The buffer
+   * \param seq The sequence number of the first byte expected
+   * \param size The number of bytes expected
+   */
+  void CheckExtract (TcpRxBuffer &rxBuf, SequenceNumber32 seq, uint32_t size);
+
+  /**
+   * \brief Check the SACK blocks reported by the buffer
+   * \param rxBuf The buffer
+   * \param maxBlocks The number of blocks the option can carry
+   * \param expected The blocks expected, in order
+   */
+  void CheckSackList (const TcpRxBuffer &rxBuf, uint32_t maxBlocks,
+                      const TcpOptionSack::SackList &expected);
+
+  /**
+   * \param seq A sequence number
+   * \return The byte of the stream of this sequence number
+   */
+  static uint8_t StreamByte (SequenceNumber32 seq);
+};
+
+TcpRxBufferBaseTestCase::TcpRxBufferBaseTestCase (std::string name)
+  : TestCase (name)
+{
+}
+
+uint8_t
+TcpRxBufferBaseTestCase::StreamByte (SequenceNumber32 seq)
+{
+  return static_cast<uint8_t> (seq.GetValue () * 7 + (seq.GetValue () >> 8));
+}
+
+bool
+TcpRxBufferBaseTestCase::AddSegment (TcpRxBuffer &rxBuf, SequenceNumber32 seq, uint32_t size)
+{
+  std::vector<uint8_t> data (size);
+  for (uint32_t i = 0; i < size; i++)
+    {
+      data[i] = StreamByte (seq + SequenceNumber32 (i));
+    }
+  TcpHeader tcph;
+  tcph.SetSequenceNumber (seq);
+  return rxBuf.Add (Create<Packet> (&data[0], size), tcph);
+}
+
+void
+TcpRxBufferBaseTestCase::CheckExtract (TcpRxBuffer &rxBuf, SequenceNumber32 seq, uint32_t size)
+{
+  Ptr<Packet> p = rxBuf.Extract (size);
+  NS_TEST_ASSERT_MSG_NE (p, 0, "Nothing extracted");
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), size, "Wrong size extracted");
+  std::vector<uint8_t> data (size);
+  p->CopyData (&data[0], size);
+  for (uint32_t i = 0; i < size; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((uint32_t) data[i], (uint32_t) StreamByte (seq + SequenceNumber32 (i)),
+                             "Wrong byte at seq " << seq + SequenceNumber32 (i));
+    }
+}
+
+void
+TcpRxBufferBaseTestCase::CheckSackList (const TcpRxBuffer &rxBuf, uint32_t maxBlocks,
+                                        const TcpOptionSack::SackList &expected)
+{
+  TcpOptionSack::SackList list = rxBuf.GetSackList (maxBlocks);
+  NS_TEST_ASSERT_MSG_EQ (list.size (), expected.size (), "Wrong number of SACK blocks");
+  TcpOptionSack::SackList::const_iterator a = list.begin ();
+  TcpOptionSack::SackList::const_iterator e = expected.begin ();
+  for (; a != list.end () && e != expected.end (); ++a, ++e)
+    {
+      NS_TEST_ASSERT_MSG_EQ (a->first, e->first, "Wrong left edge of SACK block");
+      NS_TEST_ASSERT_MSG_EQ (a->second, e->second, "Wrong right edge of SACK block");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Out-of-order segments: holes are reported as SACK blocks, the
+ * most recent first, and filling them makes the data available at once.
+ */
+class TcpRxBufferOutOfOrderTestCase : public TcpRxBufferBaseTestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param name Test description
+   * \param isn The sequence number of the first byte expected
+   */
+  TcpRxBufferOutOfOrderTestCase (std::string name, SequenceNumber32 isn);
+
+private:
+  virtual void DoRun (void);
+
+  SequenceNumber32 m_isn; //!< The sequence number of the first byte expected
+};
+
+TcpRxBufferOutOfOrderTestCase::TcpRxBufferOutOfOrderTestCase (std::string name, SequenceNumber32 isn)
+  : TcpRxBufferBaseTestCase (name),
+    m_isn (isn)
+{
+}
+
+void
+TcpRxBufferOutOfOrderTestCase::DoRun (void)
+{
+  TcpRxBuffer rxBuf;
+  rxBuf.SetMaxBufferSize (10000);
+  rxBuf.SetNextRxSequence (m_isn);
+  TcpOptionSack::SackList expected;
+
+  // segments 1 and 3 of 0..4, of 100 bytes each
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (rxBuf, m_isn + 100, 100), true, "Segment 1 not buffered");
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (rxBuf, m_isn + 300, 100), true, "Segment 3 not buffered");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 200u, "Wrong occupancy");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Available (), 0u, "Data available despite the hole");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.NextRxSequence (), m_isn, "RCV.NXT moved");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Extract (1000), 0, "Data extracted despite the hole");
+  expected.push_back (std::make_pair (m_isn + 300, m_isn + 400));
+  expected.push_back (std::make_pair (m_isn + 100, m_isn + 200));
+  CheckSackList (rxBuf, 4, expected);
+  expected.pop_back ();
+  CheckSackList (rxBuf, 1, expected);
+
+  // segment 2 merges segments 1 to 3 into one block
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (rxBuf, m_isn + 200, 100), true, "Segment 2 not buffered");
+  expected.clear ();
+  expected.push_back (std::make_pair (m_isn + 100, m_isn + 400));
+  CheckSackList (rxBuf, 4, expected);
+
+  // segment 0 makes everything available
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (rxBuf, m_isn, 100), true, "Segment 0 not buffered");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.NextRxSequence (), m_isn + 400, "Wrong RCV.NXT");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Available (), 400u, "Wrong available data");
+  CheckSackList (rxBuf, 4, TcpOptionSack::SackList ());
+  CheckExtract (rxBuf, m_isn, 150);
+  CheckExtract (rxBuf, m_isn + 150, 250);
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 0u, "Buffer not empty");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Available (), 0u, "Data still available");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Overlapping segments: duplicated bytes are stored once, whether
+ * a segment is covered by, covers, or straddles the blocks buffered.
+ */
+class TcpRxBufferOverlapTestCase : public TcpRxBufferBaseTestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param name Test description
+   * \param isn The sequence number of the first byte expected
+   */
+  TcpRxBufferOverlapTestCase (std::string name, SequenceNumber32 isn);
+
+private:
+  virtual void DoRun (void);
+
+  SequenceNumber32 m_isn; //!< The sequence number of the first byte expected
+};
+
+TcpRxBufferOverlapTestCase::TcpRxBufferOverlapTestCase (std::string name, SequenceNumber32 isn)
+  : TcpRxBufferBaseTestCase (name),
+    m_isn (isn)
+{
+}
+
+void
+TcpRxBufferOverlapTestCase::DoRun (void)
+{
+  TcpRxBuffer rxBuf;
+  rxBuf.SetMaxBufferSize (10000);
+  rxBuf.SetNextRxSequence (m_isn);
+  TcpOptionSack::SackList expected;
+
+  AddSegment (rxBuf, m_isn + 100, 100);
+  AddSegment (rxBuf, m_isn + 300, 100);
+  // covered by a block
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (rxBuf, m_isn + 120, 50), false, "Duplicate segment buffered");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 200u, "Wrong occupancy after a duplicate");
+  // straddles the tail of the first block
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (rxBuf, m_isn + 150, 100), true, "Segment not buffered");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 250u, "Wrong occupancy after a straddling segment");
+  // covers the second block and straddles the first one
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (rxBuf, m_isn + 240, 260), true, "Segment not buffered");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 400u, "Wrong occupancy after a covering segment");
+  expected.push_back (std::make_pair (m_isn + 100, m_isn + 500));
+  CheckSackList (rxBuf, 4, expected);
+
+  // partly below RCV.NXT, and covering the whole block
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (rxBuf, m_isn - 50, 600), true, "Segment not buffered");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.NextRxSequence (), m_isn + 550, "Wrong RCV.NXT");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 550u, "Wrong occupancy");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Available (), 550u, "Wrong available data");
+  CheckSackList (rxBuf, 4, TcpOptionSack::SackList ());
+  CheckExtract (rxBuf, m_isn, 550);
+
+  // already delivered
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (rxBuf, m_isn + 500, 50), false, "Old segment buffered");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 0u, "Old segment buffered");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Receive window: the bytes beyond it are trimmed, and a partial
+ * extraction keeps the rest of the in-sequence block.
+ */
+class TcpRxBufferWindowTestCase : public TcpRxBufferBaseTestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param name Test description
+   * \param isn The sequence number of the first byte expected
+   */
+  TcpRxBufferWindowTestCase (std::string name, SequenceNumber32 isn);
+
+private:
+  virtual void DoRun (void);
+
+  SequenceNumber32 m_isn; //!< The sequence number of the first byte expected
+};
+
+TcpRxBufferWindowTestCase::TcpRxBufferWindowTestCase (std::string name, SequenceNumber32 isn)
+  : TcpRxBufferBaseTestCase (name),
+    m_isn (isn)
+{
+}
+
+void
+TcpRxBufferWindowTestCase::DoRun (void)
+{
+  TcpRxBuffer rxBuf;
+  rxBuf.SetMaxBufferSize (1000);
+  rxBuf.SetNextRxSequence (m_isn);
+
+  AddSegment (rxBuf, m_isn, 300);
+  // the window is counted from the first byte buffered
+  AddSegment (rxBuf, m_isn + 800, 500);
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 500u, "Segment beyond the window not trimmed");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.MaxRxSequence (), m_isn + 1000, "Wrong window");
+  TcpOptionSack::SackList expected;
+  expected.push_back (std::make_pair (m_isn + 800, m_isn + 1000));
+  CheckSackList (rxBuf, 4, expected);
+
+  CheckExtract (rxBuf, m_isn, 100);
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.MaxRxSequence (), m_isn + 1100, "Window not moved");
+  AddSegment (rxBuf, m_isn + 300, 500);
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.NextRxSequence (), m_isn + 1000, "Wrong RCV.NXT");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Available (), 900u, "Wrong available data");
+  CheckExtract (rxBuf, m_isn + 100, 400);
+  CheckExtract (rxBuf, m_isn + 500, 500);
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 0u, "Buffer not empty");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TcpRxBuffer TestSuite
+ */
+static class TcpRxBufferTestSuite : public TestSuite
+{
+public:
+  TcpRxBufferTestSuite ()
+    : TestSuite ("tcp-rx-buffer", UNIT)
+  {
+    AddTestCase (new TcpRxBufferOutOfOrderTestCase ("Out-of-order segments", SequenceNumber32 (1000)),
+                 TestCase::QUICK);
+    AddTestCase (new TcpRxBufferOutOfOrderTestCase ("Out-of-order segments, wrapped",
+                                                    SequenceNumber32 (0xFFFFFF60)),
+                 TestCase::QUICK);
+    AddTestCase (new TcpRxBufferOverlapTestCase ("Overlapping segments", SequenceNumber32 (1000)),
+                 TestCase::QUICK);
+    AddTestCase (new TcpRxBufferOverlapTestCase ("Overlapping segments, wrapped",
+                                                 SequenceNumber32 (0xFFFFFF00)),
+                 TestCase::QUICK);
+    AddTestCase (new TcpRxBufferWindowTestCase ("Receive window", SequenceNumber32 (1000)),
+                 TestCase::QUICK);
+    AddTestCase (new TcpRxBufferWindowTestCase ("Receive window, wrapped",
+                                                SequenceNumber32 (0xFFFFFE00)),
+                 TestCase::QUICK);
+  }
+} g_tcpRxBufferTestSuite;
+
+} // namespace ns3
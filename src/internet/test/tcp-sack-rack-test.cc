@@ -0,0 +1,681 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "tcp-general-test.h"
+#include "tcp-error-model.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+#include "ns3/tcp-option-sack.h"
+#include "ns3/tcp-rx-buffer.h"
+#include "ns3/tcp-tx-buffer.h"
+
+#include <map>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpSackRackTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Socket that starts its sequence space from a given number
+ *
+ * The sequence numbers of TcpSocketBase always start from zero: this
+ * socket moves them, e.g. to make the data wrap around 2^32.
+ */
+class TcpSocketIsn : public TcpSocketMsgBase
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TcpSocketIsn ()
+    : TcpSocketMsgBase (),
+      m_isn (0)
+  {
+  }
+
+  /**
+   * \brief Constructor.
+   * \param other the object to copy
+   */
+  TcpSocketIsn (const TcpSocketIsn &other)
+    : TcpSocketMsgBase (other),
+      m_isn (other.m_isn)
+  {
+  }
+
+  /**
+   * \brief Set the initial sequence number
+   * \param isn the sequence number of the SYN
+   */
+  void SetIsn (const SequenceNumber32 &isn)
+  {
+    m_isn = isn;
+  }
+
+  virtual int Connect (const Address &address);
+
+protected:
+  virtual Ptr<TcpSocketBase> Fork (void);
+
+  SequenceNumber32 m_isn; //!< The sequence number of the SYN
+};
+
+NS_OBJECT_ENSURE_REGISTERED (TcpSocketIsn);
+
+TypeId
+TcpSocketIsn::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpSocketIsn")
+    .SetParent<TcpSocketMsgBase> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpSocketIsn> ()
+  ;
+  return tid;
+}
+
+int
+TcpSocketIsn::Connect (const Address &address)
+{
+  NS_LOG_FUNCTION (this << address);
+
+  m_tcb->m_nextTxSequence = m_isn;
+  m_tcb->m_highTxMark = m_isn;
+  m_txBuffer->SetHeadSequence (m_isn);
+  m_highRxAckMark = m_isn;
+  m_recover = m_isn;
+
+  return TcpSocketMsgBase::Connect (address);
+}
+
+Ptr<TcpSocketBase>
+TcpSocketIsn::Fork (void)
+{
+  return CopyObject<TcpSocketIsn> (this);
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Socket that reneges on its out-of-order data
+ *
+ * When the segment starting at a given sequence number arrives, the socket
+ * throws away the out-of-order data it holds (and has SACKed) before
+ * processing the segment, as a receiver short of memory may do.
+ */
+class TcpSocketReneging : public TcpSocketMsgBase
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TcpSocketReneging ()
+    : TcpSocketMsgBase (),
+      m_renegeSeq (0),
+      m_reneged (false)
+  {
+  }
+
+  /**
+   * \brief Constructor.
+   * \param other the object to copy
+   */
+  TcpSocketReneging (const TcpSocketReneging &other)
+    : TcpSocketMsgBase (other),
+      m_renegeSeq (other.m_renegeSeq),
+      m_reneged (other.m_reneged)
+  {
+  }
+
+  /**
+   * \brief Set the segment whose arrival makes the socket renege
+   * \param seq the sequence number of the segment
+   */
+  void SetRenegeSeq (const SequenceNumber32 &seq)
+  {
+    m_renegeSeq = seq;
+  }
+
+protected:
+  virtual Ptr<TcpSocketBase> Fork (void);
+  virtual void ReceivedData (Ptr<Packet> packet, const TcpHeader& tcpHeader);
+
+  SequenceNumber32 m_renegeSeq; //!< The segment whose arrival makes the socket renege
+  bool m_reneged;               //!< Whether the socket has reneged
+};
+
+NS_OBJECT_ENSURE_REGISTERED (TcpSocketReneging);
+
+TypeId
+TcpSocketReneging::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpSocketReneging")
+    .SetParent<TcpSocketMsgBase> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpSocketReneging> ()
+  ;
+  return tid;
+}
+
+Ptr<TcpSocketBase>
+TcpSocketReneging::Fork (void)
+{
+  return CopyObject<TcpSocketReneging> (this);
+}
+
+void
+TcpSocketReneging::ReceivedData (Ptr<Packet> packet, const TcpHeader &tcpHeader)
+{
+  NS_LOG_FUNCTION (this << packet << tcpHeader);
+
+  if (!m_reneged && tcpHeader.GetSequenceNumber () == m_renegeSeq)
+    {
+      // The application reads everything, hence only out-of-order data is lost
+      NS_ASSERT (m_rxBuffer->Available () == 0);
+      NS_LOG_INFO ("Reneging on " << m_rxBuffer->Size () << " out-of-order bytes");
+
+      Ptr<TcpRxBuffer> rxBuffer = CreateObject<TcpRxBuffer> ();
+      rxBuffer->SetNextRxSequence (m_rxBuffer->NextRxSequence ());
+      rxBuffer->SetMaxBufferSize (m_rxBuffer->MaxBufferSize ());
+      m_rxBuffer = rxBuffer;
+      m_reneged = true;
+    }
+
+  TcpSocketMsgBase::ReceivedData (packet, tcpHeader);
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the SACK-based recovery of several losses in a window
+ *
+ * Segments 4, 5 and 7 of the first window are lost. The receiver SACKs
+ * the segments around them, and the sender must retransmit these three
+ * segments, and only them, once each, without a retransmission timeout.
+ * The initial sequence number is a parameter, so that the lost segments
+ * can straddle the wrap around of the sequence space.
+ */
+class TcpSackRecoveryTest : public TcpGeneralTest
+{
+public:
+  /**
+   * \brief Constructor
+   * \param desc the test description
+   * \param isn the initial sequence number of the sender
+   */
+  TcpSackRecoveryTest (const std::string &desc, uint32_t isn);
+
+protected:
+  virtual void ConfigureEnvironment ();
+  virtual void ConfigureProperties ();
+  virtual Ptr<TcpSocketMsgBase> CreateSenderSocket (Ptr<Node> node);
+  virtual Ptr<ErrorModel> CreateReceiverErrorModel ();
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void Rx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void RTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who);
+  virtual void FinalChecks ();
+
+  /**
+   * \param index the index of a data segment
+   * \returns the sequence number of the segment
+   */
+  SequenceNumber32 GetSegmentSeq (uint32_t index) const;
+  /**
+   * \param seq the sequence number of a data segment
+   * \returns true if the first transmission of the segment is dropped
+   */
+  bool IsDropped (const SequenceNumber32 &seq) const;
+
+  SequenceNumber32 m_isn;     //!< The initial sequence number of the sender
+  std::map<SequenceNumber32, uint32_t> m_txCount; //!< Transmissions of each segment
+  uint32_t m_retransmissions; //!< Number of retransmitted segments
+  uint32_t m_sackAcks;        //!< Number of ACKs with a SACK option
+  uint32_t m_rtoExpired;      //!< Number of retransmission timeouts
+  SequenceNumber32 m_highAck; //!< The highest ACK received by the sender
+};
+
+TcpSackRecoveryTest::TcpSackRecoveryTest (const std::string &desc, uint32_t isn)
+  : TcpGeneralTest (desc),
+    m_isn (isn),
+    m_retransmissions (0),
+    m_sackAcks (0),
+    m_rtoExpired (0),
+    m_highAck (isn)
+{
+}
+
+void
+TcpSackRecoveryTest::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktCount (50);
+  SetAppPktInterval (MicroSeconds (100));
+  SetPropagationDelay (MilliSeconds (50));
+}
+
+void
+TcpSackRecoveryTest::ConfigureProperties ()
+{
+  TcpGeneralTest::ConfigureProperties ();
+  SetInitialCwnd (SENDER, 10);
+  GetSenderSocket ()->SetAttribute ("Sack", BooleanValue (true));
+  GetReceiverSocket ()->SetAttribute ("Sack", BooleanValue (true));
+}
+
+Ptr<TcpSocketMsgBase>
+TcpSackRecoveryTest::CreateSenderSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketIsn> socket = DynamicCast<TcpSocketIsn> (
+      CreateSocket (node, TcpSocketIsn::GetTypeId (), m_congControlTypeId));
+  socket->SetIsn (m_isn);
+  socket->SetAttribute ("MinRto", TimeValue (Seconds (10.0)));
+  return socket;
+}
+
+Ptr<ErrorModel>
+TcpSackRecoveryTest::CreateReceiverErrorModel ()
+{
+  Ptr<TcpSeqErrorModel> errorModel = CreateObject<TcpSeqErrorModel> ();
+  errorModel->AddSeqToKill (GetSegmentSeq (4));
+  errorModel->AddSeqToKill (GetSegmentSeq (5));
+  errorModel->AddSeqToKill (GetSegmentSeq (7));
+  return errorModel;
+}
+
+SequenceNumber32
+TcpSackRecoveryTest::GetSegmentSeq (uint32_t index) const
+{
+  return m_isn + SequenceNumber32 (1 + index * 500);
+}
+
+bool
+TcpSackRecoveryTest::IsDropped (const SequenceNumber32 &seq) const
+{
+  return seq == GetSegmentSeq (4) || seq == GetSegmentSeq (5) || seq == GetSegmentSeq (7);
+}
+
+void
+TcpSackRecoveryTest::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who != SENDER || p->GetSize () == 0)
+    {
+      return;
+    }
+
+  SequenceNumber32 seq = h.GetSequenceNumber ();
+  if (++m_txCount[seq] > 1)
+    {
+      NS_TEST_ASSERT_MSG_EQ (IsDropped (seq), true, "Segment " << seq <<
+                             " retransmitted, but it was not lost");
+      NS_TEST_ASSERT_MSG_EQ (m_txCount[seq], 2u, "Segment " << seq <<
+                             " retransmitted more than once");
+      m_retransmissions++;
+    }
+}
+
+void
+TcpSackRecoveryTest::Rx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who != SENDER || !(h.GetFlags () & TcpHeader::ACK))
+    {
+      return;
+    }
+
+  if (h.HasOption (TcpOption::SACK))
+    {
+      m_sackAcks++;
+    }
+  if (h.GetAckNumber () > m_highAck)
+    {
+      m_highAck = h.GetAckNumber ();
+    }
+}
+
+void
+TcpSackRecoveryTest::RTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who)
+{
+  if (who == SENDER)
+    {
+      m_rtoExpired++;
+    }
+}
+
+void
+TcpSackRecoveryTest::FinalChecks ()
+{
+  NS_TEST_ASSERT_MSG_GT (m_sackAcks, 0u, "The receiver sent no SACK");
+  NS_TEST_ASSERT_MSG_EQ (m_retransmissions, 3u, "Not all the lost segments have been retransmitted");
+  NS_TEST_ASSERT_MSG_EQ (m_rtoExpired, 0u, "The losses have been recovered by a timeout");
+  // The data and the FIN
+  NS_TEST_ASSERT_MSG_EQ (m_highAck, GetSegmentSeq (GetPktCount ()) + SequenceNumber32 (1),
+                         "Not all the data has been acknowledged");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the recovery from a receiver reneging on SACKed data
+ *
+ * Segment 3 of the first window is lost, and the receiver SACKs the
+ * following ones. When the retransmission of segment 3 arrives, the
+ * receiver throws these away. The cumulative ACK then points into data
+ * the sender has seen SACKed: the sender must forget the SACK information
+ * and resend the segments, without waiting for a retransmission timeout.
+ */
+class TcpSackRenegingTest : public TcpGeneralTest
+{
+public:
+  /**
+   * \brief Constructor
+   * \param desc the test description
+   */
+  TcpSackRenegingTest (const std::string &desc);
+
+protected:
+  virtual void ConfigureEnvironment ();
+  virtual void ConfigureProperties ();
+  virtual Ptr<TcpSocketMsgBase> CreateSenderSocket (Ptr<Node> node);
+  virtual Ptr<TcpSocketMsgBase> CreateReceiverSocket (Ptr<Node> node);
+  virtual Ptr<ErrorModel> CreateReceiverErrorModel ();
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void Rx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void RTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who);
+  virtual void ErrorClose (SocketWho who);
+  virtual void FinalChecks ();
+
+  std::map<SequenceNumber32, uint32_t> m_txCount; //!< Transmissions of each segment
+  uint32_t m_renegedRetransmissions; //!< Retransmissions of segments that were not lost
+  uint32_t m_rtoExpired;      //!< Number of retransmission timeouts
+  SequenceNumber32 m_highAck; //!< The highest ACK received by the sender
+  bool m_errorClose;          //!< Whether a socket has been closed on error
+};
+
+TcpSackRenegingTest::TcpSackRenegingTest (const std::string &desc)
+  : TcpGeneralTest (desc),
+    m_renegedRetransmissions (0),
+    m_rtoExpired (0),
+    m_highAck (0),
+    m_errorClose (false)
+{
+}
+
+void
+TcpSackRenegingTest::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktCount (50);
+  SetAppPktInterval (MicroSeconds (100));
+  SetPropagationDelay (MilliSeconds (50));
+}
+
+void
+TcpSackRenegingTest::ConfigureProperties ()
+{
+  TcpGeneralTest::ConfigureProperties ();
+  SetInitialCwnd (SENDER, 10);
+  GetSenderSocket ()->SetAttribute ("Sack", BooleanValue (true));
+  GetReceiverSocket ()->SetAttribute ("Sack", BooleanValue (true));
+}
+
+Ptr<TcpSocketMsgBase>
+TcpSackRenegingTest::CreateSenderSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket (node);
+  socket->SetAttribute ("MinRto", TimeValue (Seconds (10.0)));
+  return socket;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpSackRenegingTest::CreateReceiverSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketReneging> socket = DynamicCast<TcpSocketReneging> (
+      CreateSocket (node, TcpSocketReneging::GetTypeId (), m_congControlTypeId));
+  socket->SetRenegeSeq (SequenceNumber32 (1 + 3 * 500));
+  return socket;
+}
+
+Ptr<ErrorModel>
+TcpSackRenegingTest::CreateReceiverErrorModel ()
+{
+  Ptr<TcpSeqErrorModel> errorModel = CreateObject<TcpSeqErrorModel> ();
+  errorModel->AddSeqToKill (SequenceNumber32 (1 + 3 * 500));
+  return errorModel;
+}
+
+void
+TcpSackRenegingTest::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who != SENDER || p->GetSize () == 0)
+    {
+      return;
+    }
+
+  SequenceNumber32 seq = h.GetSequenceNumber ();
+  if (++m_txCount[seq] > 1 && seq != SequenceNumber32 (1 + 3 * 500))
+    {
+      m_renegedRetransmissions++;
+    }
+}
+
+void
+TcpSackRenegingTest::Rx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who == SENDER && (h.GetFlags () & TcpHeader::ACK) && h.GetAckNumber () > m_highAck)
+    {
+      m_highAck = h.GetAckNumber ();
+    }
+}
+
+void
+TcpSackRenegingTest::RTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who)
+{
+  if (who == SENDER)
+    {
+      m_rtoExpired++;
+    }
+}
+
+void
+TcpSackRenegingTest::ErrorClose (SocketWho who)
+{
+  m_errorClose = true;
+}
+
+void
+TcpSackRenegingTest::FinalChecks ()
+{
+  NS_TEST_ASSERT_MSG_GT (m_renegedRetransmissions, 0u,
+                         "The segments the receiver reneged on have not been retransmitted");
+  NS_TEST_ASSERT_MSG_EQ (m_rtoExpired, 0u, "The reneging has been recovered by a timeout");
+  NS_TEST_ASSERT_MSG_EQ (m_errorClose, false, "The connection has been closed on error");
+  // The data and the FIN
+  NS_TEST_ASSERT_MSG_EQ (m_highAck, SequenceNumber32 (1 + GetPktSize () * GetPktCount () + 1),
+                         "Not all the data has been acknowledged");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the RACK detection of a tail loss
+ *
+ * The whole data fits in the initial window, and its next to last segment
+ * is lost: a single duplicate ACK follows, which is not enough for the
+ * duplicate ACK threshold nor for the SACK scoreboard. RACK marks the
+ * segment lost once it has been outstanding for an RTT plus the reordering
+ * window after the delivery of the last segment; without RACK, only the
+ * retransmission timeout recovers the loss.
+ */
+class TcpRackTailLossTest : public TcpGeneralTest
+{
+public:
+  /**
+   * \brief Constructor
+   * \param desc the test description
+   * \param rack whether the sender uses RACK
+   */
+  TcpRackTailLossTest (const std::string &desc, bool rack);
+
+protected:
+  virtual void ConfigureEnvironment ();
+  virtual void ConfigureProperties ();
+  virtual Ptr<TcpSocketMsgBase> CreateSenderSocket (Ptr<Node> node);
+  virtual Ptr<ErrorModel> CreateReceiverErrorModel ();
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void RTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who);
+  virtual void FinalChecks ();
+
+  bool m_rack;                //!< Whether the sender uses RACK
+  SequenceNumber32 m_lostSeq; //!< The lost segment
+  Time m_lostTx;              //!< The first transmission of the lost segment
+  Time m_retxTime;            //!< The retransmission of the lost segment
+  uint32_t m_retransmissions; //!< Number of retransmitted segments
+  uint32_t m_rtoExpired;      //!< Number of retransmission timeouts
+};
+
+TcpRackTailLossTest::TcpRackTailLossTest (const std::string &desc, bool rack)
+  : TcpGeneralTest (desc),
+    m_rack (rack),
+    m_lostSeq (1 + 18 * 500),
+    m_lostTx (0),
+    m_retxTime (0),
+    m_retransmissions (0),
+    m_rtoExpired (0)
+{
+}
+
+void
+TcpRackTailLossTest::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktCount (20);
+  SetAppPktInterval (MicroSeconds (100));
+  SetPropagationDelay (MilliSeconds (50));
+}
+
+void
+TcpRackTailLossTest::ConfigureProperties ()
+{
+  TcpGeneralTest::ConfigureProperties ();
+  SetInitialCwnd (SENDER, 20);
+  GetSenderSocket ()->SetAttribute ("Sack", BooleanValue (true));
+  GetSenderSocket ()->SetAttribute ("Rack", BooleanValue (m_rack));
+  GetReceiverSocket ()->SetAttribute ("Sack", BooleanValue (true));
+}
+
+Ptr<TcpSocketMsgBase>
+TcpRackTailLossTest::CreateSenderSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket (node);
+  socket->SetAttribute ("MinRto", TimeValue (Seconds (1.0)));
+  return socket;
+}
+
+Ptr<ErrorModel>
+TcpRackTailLossTest::CreateReceiverErrorModel ()
+{
+  Ptr<TcpSeqErrorModel> errorModel = CreateObject<TcpSeqErrorModel> ();
+  errorModel->AddSeqToKill (m_lostSeq);
+  return errorModel;
+}
+
+void
+TcpRackTailLossTest::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who != SENDER || p->GetSize () == 0 || h.GetSequenceNumber () != m_lostSeq)
+    {
+      return;
+    }
+
+  if (m_lostTx.IsZero ())
+    {
+      m_lostTx = Simulator::Now ();
+    }
+  else
+    {
+      m_retxTime = Simulator::Now ();
+      m_retransmissions++;
+    }
+}
+
+void
+TcpRackTailLossTest::RTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who)
+{
+  if (who == SENDER)
+    {
+      m_rtoExpired++;
+    }
+}
+
+void
+TcpRackTailLossTest::FinalChecks ()
+{
+  NS_TEST_ASSERT_MSG_EQ (m_retransmissions, 1u, "The lost segment has not been retransmitted once");
+  if (m_rack)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_rtoExpired, 0u, "RACK did not detect the tail loss");
+      // Not before the delivery of the last segment could be known
+      NS_TEST_ASSERT_MSG_GT (m_retxTime - m_lostTx, MilliSeconds (100),
+                             "The segment has been declared lost before an RTT");
+      NS_TEST_ASSERT_MSG_LT (m_retxTime - m_lostTx, GetMinRto (SENDER),
+                             "The segment has been declared lost after the RTO");
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_rtoExpired, 1u, "The tail loss should need the RTO without RACK");
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP SACK and RACK loss recovery TestSuite
+ */
+static class TcpSackRackTestSuite : public TestSuite
+{
+public:
+  TcpSackRackTestSuite () : TestSuite ("tcp-sack-rack", UNIT)
+  {
+    AddTestCase (new TcpSackRecoveryTest ("SACK recovery of three losses in a window", 0),
+                 TestCase::QUICK);
+    AddTestCase (new TcpSackRecoveryTest ("SACK recovery of losses across the sequence number wrap around",
+                                          0xffffffff - 2500),
+                 TestCase::QUICK);
+    AddTestCase (new TcpSackRenegingTest ("SACK recovery from a receiver reneging"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpRackTailLossTest ("Tail loss recovered by the RTO without RACK", false),
+                 TestCase::QUICK);
+    AddTestCase (new TcpRackTailLossTest ("Tail loss detected by RACK", true),
+                 TestCase::QUICK);
+  }
+} g_tcpSackRackTestSuite;
+
+} // namespace ns3
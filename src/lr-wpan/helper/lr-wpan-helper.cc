@@ -47,7 +47,10 @@ AsciiLrWpanMacTransmitSinkWithContext (
   std::string context,
   Ptr<const Packet> p)
 {
-  *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
+  if (!AsciiTraceHelper::WriteBinaryEvent (stream, 't', context, p))
+    {
+      *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
+    }
 }
 
 /**
@@ -60,7 +63,10 @@ AsciiLrWpanMacTransmitSinkWithoutContext (
   Ptr<OutputStreamWrapper> stream,
   Ptr<const Packet> p)
 {
-  *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+  if (!AsciiTraceHelper::WriteBinaryEvent (stream, 't', std::string (), p))
+    {
+      *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+    }
 }
 
 LrWpanHelper::LrWpanHelper (void)
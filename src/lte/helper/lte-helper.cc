@@ -43,6 +43,7 @@
 #include <ns3/lte-enb-net-device.h>
 #include <ns3/lte-ue-net-device.h>
 #include <ns3/ff-mac-scheduler.h>
+#include <ns3/lte-scheduler-thread-pool.h>
 #include <ns3/lte-ffr-algorithm.h>
 #include <ns3/lte-handover-algorithm.h>
 #include <ns3/lte-anr.h>
@@ -71,7 +72,8 @@ NS_OBJECT_ENSURE_REGISTERED (LteHelper);
 LteHelper::LteHelper (void)
   : m_fadingStreamsAssigned (false),
     m_imsiCounter (0),
-    m_cellIdCounter (0)
+    m_cellIdCounter (0),
+    m_schedulerThreads (0)
 {
   NS_LOG_FUNCTION (this);
   m_enbNetDeviceFactory.SetTypeId (LteEnbNetDevice::GetTypeId ());
@@ -200,6 +202,14 @@ TypeId LteHelper::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&LteHelper::m_usePdschForCqiGeneration),
                    MakeBooleanChecker ())
+    .AddAttribute ("SchedulerThreads",
+                   "If not zero, the requests of all the eNBs to their scheduler "
+                   "at each TTI are made in parallel by this number of threads, "
+                   "see LteSchedulerThreadPool. If zero, each eNB makes its "
+                   "requests in turn.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&LteHelper::m_schedulerThreads),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -210,6 +220,7 @@ LteHelper::DoDispose ()
   NS_LOG_FUNCTION (this);
   m_downlinkChannel = 0;
   m_uplinkChannel = 0;
+  m_schedulerThreadPool = 0;
   Object::DoDispose ();
 }
 
@@ -501,6 +512,16 @@ LteHelper::InstallSingleEnbDevice (Ptr<Node> n)
   phy->SetLteEnbPhySapUser (mac->GetLteEnbPhySapUser ());
   mac->SetLteEnbPhySapProvider (phy->GetLteEnbPhySapProvider ());
 
+  if (m_schedulerThreads > 0)
+    {
+      if (m_schedulerThreadPool == 0)
+        {
+          m_schedulerThreadPool = CreateObject<LteSchedulerThreadPool> ();
+          m_schedulerThreadPool->SetAttribute ("Threads", UintegerValue (m_schedulerThreads));
+        }
+      mac->SetSchedulerThreadPool (m_schedulerThreadPool);
+    }
+
   phy->SetLteEnbCphySapUser (rrc->GetLteEnbCphySapUser ());
   rrc->SetLteEnbCphySapProvider (phy->GetLteEnbCphySapProvider ());
 
@@ -45,6 +45,7 @@ class LteUePhy;
 class LteEnbPhy;
 class SpectrumChannel;
 class EpcHelper;
+class LteSchedulerThreadPool;
 class PropagationLossModel;
 class SpectrumPropagationLossModel;
 
@@ -731,6 +732,17 @@ private:
    * DL-CQI will be calculated from PDCCH as signal and PDCCH as interference.
    */
   bool m_usePdschForCqiGeneration;
+  /**
+   * The `SchedulerThreads` attribute. The number of threads making the
+   * requests of the eNBs to their scheduler at each TTI, or zero to make
+   * them in turn, each eNB on its own.
+   */
+  uint32_t m_schedulerThreads;
+  /**
+   * The pool shared by the eNBs to make the requests to their scheduler,
+   * created by the first eNB installed if `SchedulerThreads` is not zero.
+   */
+  Ptr<LteSchedulerThreadPool> m_schedulerThreadPool;
 
 }; // end of `class LteHelper`
 
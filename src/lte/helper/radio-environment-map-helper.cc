@@ -37,9 +37,20 @@
 #include <ns3/node.h>
 #include <ns3/buildings-helper.h>
 #include <ns3/lte-spectrum-value-helper.h>
+#include <ns3/lte-enb-net-device.h>
+#include <ns3/lte-enb-phy.h>
+#include <ns3/lte-spectrum-phy.h>
+#include <ns3/node-list.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+#include <ns3/spectrum-converter.h>
+#include <ns3/antenna-model.h>
+#include <ns3/angles.h>
 
 #include <fstream>
 #include <limits>
+#include <algorithm>
+#include <cmath>
 
 namespace ns3 {
 
@@ -48,6 +59,7 @@ NS_LOG_COMPONENT_DEFINE ("RadioEnvironmentMapHelper");
 NS_OBJECT_ENSURE_REGISTERED (RadioEnvironmentMapHelper);
 
 RadioEnvironmentMapHelper::RadioEnvironmentMapHelper ()
+  : m_useDirectComputation (false)
 {
 }
 
@@ -62,6 +74,8 @@ void
 RadioEnvironmentMapHelper::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_transmitters.clear ();
+  m_tile.clear ();
 }
 
 TypeId
@@ -144,6 +158,13 @@ RadioEnvironmentMapHelper::GetTypeId (void)
                    IntegerValue (-1),
                    MakeIntegerAccessor (&RadioEnvironmentMapHelper::m_rbId),
                    MakeIntegerChecker<int32_t> ())
+    .AddAttribute ("UseDirectComputation",
+                   "If true, the REM is computed directly from the loss models of the channel "
+                   "and the eNBs attached to it, rather than by simulating the reception "
+                   "of their signals, and all eNBs are assumed to transmit over all RBs",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RadioEnvironmentMapHelper::m_useDirectComputation),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -181,7 +202,7 @@ void
 RadioEnvironmentMapHelper::Install ()
 {
   NS_LOG_FUNCTION (this);
-  if (!m_rem.empty ())
+  if (!m_rem.empty () || !m_tile.empty ())
     {
       NS_FATAL_ERROR ("only one REM supported per instance of RadioEnvironmentMapHelper");
     }
@@ -225,7 +246,35 @@ RadioEnvironmentMapHelper::DelayedInstall ()
     {
       m_maxPointsPerIteration = m_xRes * m_yRes;
     }
-  
+
+  if (m_useDirectComputation)
+    {
+      for (uint32_t i = 0; i < m_maxPointsPerIteration; ++i)
+        {
+          Ptr<MobilityModel> mm = CreateObject<ConstantPositionMobilityModel> ();
+          Ptr<MobilityBuildingInfo> buildingInfo = CreateObject<MobilityBuildingInfo> ();
+          mm->AggregateObject (buildingInfo); // operation usually done by BuildingsHelper::Install
+          m_tile.push_back (mm);
+        }
+      for (NodeList::Iterator nodeIt = NodeList::Begin (); nodeIt != NodeList::End (); ++nodeIt)
+        {
+          for (uint32_t i = 0; i < (*nodeIt)->GetNDevices (); ++i)
+            {
+              Ptr<LteEnbNetDevice> enbDev = DynamicCast<LteEnbNetDevice> ((*nodeIt)->GetDevice (i));
+              if (enbDev != 0
+                  && enbDev->GetPhy ()->GetDownlinkSpectrumPhy ()->GetChannel () == m_channel)
+                {
+                  RemTransmitter tx;
+                  tx.device = enbDev;
+                  m_transmitters.push_back (tx);
+                }
+            }
+        }
+      RunDirectly (0, m_transmitters.size ());
+      Finalize ();
+      return;
+    }
+
   for (uint32_t i = 0; i < m_maxPointsPerIteration; ++i)
     {
       RemPoint p;
@@ -340,6 +389,158 @@ RadioEnvironmentMapHelper::PrintAndReset ()
     }
 }
 
+void
+RadioEnvironmentMapHelper::Recompute (Ptr<NetDevice> enbDevice)
+{
+  NS_LOG_FUNCTION (this << enbDevice);
+  NS_ABORT_MSG_IF (m_tile.empty (), "Recompute () applies only to a REM computed directly, once computed");
+  Ptr<LteEnbNetDevice> enbDev = DynamicCast<LteEnbNetDevice> (enbDevice);
+  NS_ABORT_MSG_IF (enbDev == 0, "device " << enbDevice << " is not a LteEnbNetDevice");
+
+  uint32_t i = 0;
+  while (i < m_transmitters.size () && m_transmitters[i].device != enbDev)
+    {
+      ++i;
+    }
+  if (i == m_transmitters.size ())
+    {
+      RemTransmitter tx;
+      tx.device = enbDev;
+      m_transmitters.push_back (tx);
+    }
+  RunDirectly (i, i + 1);
+  m_outFile.close ();
+}
+
+void
+RadioEnvironmentMapHelper::RunDirectly (uint32_t first, uint32_t end)
+{
+  NS_LOG_FUNCTION (this << first << end);
+  uint32_t numPoints = (uint32_t) m_xRes * m_yRes;
+  Ptr<const SpectrumModel> rxModel = LteSpectrumValueHelper::GetSpectrumModel (m_earfcn, m_bandwidth);
+  DoubleValue maxLossDb (std::numeric_limits<double>::max ());
+  m_channel->GetAttributeFailSafe ("MaxLossDb", maxLossDb);
+
+  // the signal of each eNB as received with no loss, i.e., a control frame
+  std::vector<Ptr<SpectrumValue> > psds;
+  for (uint32_t t = first; t < end; ++t)
+    {
+      Ptr<LteEnbNetDevice> enbDev = m_transmitters[t].device;
+      std::vector<int> rbs;
+      for (uint8_t i = 0; i < enbDev->GetDlBandwidth (); ++i)
+        {
+          rbs.push_back (i);
+        }
+      Ptr<SpectrumValue> psd = LteSpectrumValueHelper::CreateTxPowerSpectralDensity (enbDev->GetDlEarfcn (),
+                                                                                    enbDev->GetDlBandwidth (),
+                                                                                    enbDev->GetPhy ()->GetTxPower (),
+                                                                                    rbs);
+      if (psd->GetSpectrumModelUid () != rxModel->GetUid ())
+        {
+          SpectrumConverter converter (psd->GetSpectrumModel (), rxModel);
+          psd = converter.Convert (psd);
+        }
+      psds.push_back (psd);
+      m_transmitters[t].power.resize (numPoints);
+    }
+
+  if (!m_outFile.is_open ())
+    {
+      m_outFile.open (m_outputFile.c_str ());
+      if (!m_outFile.is_open ())
+        {
+          NS_FATAL_ERROR ("Can't open file " << (m_outputFile));
+        }
+    }
+
+  for (uint32_t tileStart = 0; tileStart < numPoints; tileStart += m_maxPointsPerIteration)
+    {
+      uint32_t tileEnd = std::min (tileStart + m_maxPointsPerIteration, numPoints);
+      NS_LOG_LOGIC ("tile of points " << tileStart << " to " << tileEnd);
+      for (uint32_t k = tileStart; k < tileEnd; ++k)
+        {
+          Ptr<MobilityModel> point = m_tile[k - tileStart];
+          point->SetPosition (Vector (m_xMin + (k / m_yRes) * m_xStep,
+                                      m_yMin + (k % m_yRes) * m_yStep,
+                                      m_z));
+          BuildingsHelper::MakeConsistent (point);
+          for (uint32_t t = first; t < end; ++t)
+            {
+              m_transmitters[t].power[k] = CalcRxPower (psds[t - first], m_transmitters[t].device,
+                                                        point, maxLossDb.Get ());
+            }
+        }
+      PrintDirectly (tileStart, tileEnd);
+    }
+}
+
+double
+RadioEnvironmentMapHelper::CalcRxPower (Ptr<const SpectrumValue> psd, Ptr<LteEnbNetDevice> enbDevice,
+                                        Ptr<MobilityModel> point, double maxLossDb)
+{
+  // as done by MultiModelSpectrumChannel::StartTx for a RemSpectrumPhy
+  Ptr<LteSpectrumPhy> txPhy = enbDevice->GetPhy ()->GetDownlinkSpectrumPhy ();
+  Ptr<MobilityModel> txMobility = txPhy->GetMobility ();
+  double gain = 1;
+  Ptr<const SpectrumValue> rxPsd = psd;
+  if (txMobility != 0)
+    {
+      double pathLossDb = 0;
+      Ptr<AntennaModel> txAntenna = txPhy->GetRxAntenna ();
+      if (txAntenna != 0)
+        {
+          Angles txAngles (point->GetPosition (), txMobility->GetPosition ());
+          pathLossDb -= txAntenna->GetGainDb (txAngles);
+        }
+      Ptr<PropagationLossModel> propagationLoss = m_channel->GetPropagationLossModel ();
+      if (propagationLoss != 0)
+        {
+          pathLossDb -= propagationLoss->CalcRxPower (0, txMobility, point);
+        }
+      if (pathLossDb > maxLossDb)
+        {
+          return 0;
+        }
+      gain = std::pow (10.0, (-pathLossDb) / 10.0);
+      Ptr<SpectrumPropagationLossModel> spectrumPropagationLoss = m_channel->GetSpectrumPropagationLossModel ();
+      if (spectrumPropagationLoss != 0)
+        {
+          Ptr<SpectrumValue> txPsd = Copy<SpectrumValue> (psd);
+          *txPsd *= gain;
+          rxPsd = spectrumPropagationLoss->CalcRxPowerSpectralDensity (txPsd, txMobility, point);
+          gain = 1;
+        }
+    }
+  if (m_rbId >= 0)
+    {
+      return (*rxPsd)[m_rbId] * 180000 * gain;
+    }
+  return Integral (*rxPsd) * gain;
+}
+
+void
+RadioEnvironmentMapHelper::PrintDirectly (uint32_t first, uint32_t end)
+{
+  NS_LOG_FUNCTION (this << first << end);
+  for (uint32_t k = first; k < end; ++k)
+    {
+      double referenceSignalPower = 0;
+      double sumPower = 0;
+      for (uint32_t t = 0; t < m_transmitters.size (); ++t)
+        {
+          double power = m_transmitters[t].power[k];
+          sumPower += power;
+          referenceSignalPower = std::max (referenceSignalPower, power);
+        }
+      Vector pos = m_tile[k - first]->GetPosition ();
+      m_outFile << pos.x << "\t"
+                << pos.y << "\t"
+                << pos.z << "\t"
+                << referenceSignalPower / (sumPower - referenceSignalPower + m_noisePower)
+                << "\n";
+    }
+}
+
 void 
 RadioEnvironmentMapHelper::Finalize ()
 {
@@ -25,6 +25,7 @@
 
 #include <ns3/object.h>
 #include <fstream>
+#include <vector>
 
 
 namespace ns3 {
@@ -33,6 +34,8 @@ class RemSpectrumPhy;
 class Node;
 class NetDevice;
 class SpectrumChannel;
+class SpectrumValue;
+class LteEnbNetDevice;
 //class BuildingsMobilityModel;
 class MobilityModel;
 
@@ -42,6 +45,13 @@ class MobilityModel;
  * Generates a 2D map of the SINR from the strongest transmitter in the
  * downlink of an LTE FDD system. For instructions on usage, please refer to
  * the User Documentation.
+ *
+ * By default, the map is generated by simulating the reception of the
+ * signals of the eNBs at every point. With the `UseDirectComputation`
+ * attribute, the power received from every eNB attached to the channel
+ * is instead computed directly from the loss models of the channel,
+ * tile by tile, and kept so that the map can be computed again for a
+ * single eNB with Recompute().
  */
 class RadioEnvironmentMapHelper : public Object
 {
@@ -75,6 +85,17 @@ public:
    */
   void Install ();
 
+  /**
+   * Compute again the power received from an eNB at every point of a map
+   * computed directly, e.g., after its position, antenna or transmission
+   * power changed, and write the map again to the output file. An eNB
+   * which was not attached to the channel when the map was first computed
+   * is added to the map.
+   *
+   * \param enbDevice the LteEnbNetDevice of the eNB
+   */
+  void Recompute (Ptr<NetDevice> enbDevice);
+
 private:
 
   /**
@@ -108,6 +129,34 @@ private:
   /// Called when the map generation procedure has been completed.
   void Finalize ();
 
+  /**
+   * Compute the power received from some eNBs at every point of the map,
+   * tile by tile, and write the SINR of the points of each tile to the
+   * output file once it is computed.
+   *
+   * \param first the index of the first eNB in m_transmitters
+   * \param end one past the index of the last eNB
+   */
+  void RunDirectly (uint32_t first, uint32_t end);
+
+  /**
+   * \param psd the signal of an eNB, on the spectrum of the map
+   * \param enbDevice the eNB
+   * \param point the position of a point of the map
+   * \param maxLossDb the `MaxLossDb` attribute of the channel
+   * \return the power received from the eNB at the point, in W
+   */
+  double CalcRxPower (Ptr<const SpectrumValue> psd, Ptr<LteEnbNetDevice> enbDevice,
+                      Ptr<MobilityModel> point, double maxLossDb);
+
+  /**
+   * Write the SINR of some points of a map computed directly.
+   *
+   * \param first the index of the first point
+   * \param end one past the index of the last point
+   */
+  void PrintDirectly (uint32_t first, uint32_t end);
+
   /// A complete Radio Environment Map is composed of many of this structure.
   struct RemPoint 
   {
@@ -120,6 +169,21 @@ private:
   /// List of listeners in the environment.
   std::list<RemPoint> m_rem;
 
+  /// An eNB contributing to a map computed directly.
+  struct RemTransmitter
+  {
+    /// The eNB.
+    Ptr<LteEnbNetDevice> device;
+    /// The power received from the eNB at every point of the map, in W.
+    std::vector<double> power;
+  };
+
+  /// The eNBs contributing to a map computed directly.
+  std::vector<RemTransmitter> m_transmitters;
+
+  /// The positions of the points of a tile of a map computed directly.
+  std::vector<Ptr<MobilityModel> > m_tile;
+
   double m_xMin;   ///< The `XMin` attribute.
   double m_xMax;   ///< The `XMax` attribute.
   uint16_t m_xRes; ///< The `XRes` attribute.
@@ -152,6 +216,8 @@ private:
   bool m_useDataChannel;  ///< The `UseDataChannel` attribute.
   int32_t m_rbId;         ///< The `RbId` attribute.
 
+  bool m_useDirectComputation;  ///< The `UseDirectComputation` attribute.
+
 }; // end of `class RadioEnvironmentMapHelper`
 
 
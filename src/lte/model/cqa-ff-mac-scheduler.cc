@@ -283,6 +283,7 @@ void
 CqaFfMacScheduler::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_ues.Clear ();
   m_dlHarqProcessesDciBuffer.clear ();
   m_dlHarqProcessesTimer.clear ();
   m_dlHarqProcessesRlcPduListBuffer.clear ();
@@ -290,6 +291,11 @@ CqaFfMacScheduler::DoDispose ()
   m_ulHarqCurrentProcessId.clear ();
   m_ulHarqProcessesStatus.clear ();
   m_ulHarqProcessesDciBuffer.clear ();
+  m_flowStatsDl.Clear ();
+  m_flowStatsUl.Clear ();
+  m_p10CqiRxed.Clear ();
+  m_a30CqiRxed.Clear ();
+  m_ceBsrRxed.Clear ();
   delete m_cschedSapProvider;
   delete m_schedSapProvider;
   delete m_ffrSapUser;
@@ -381,41 +387,69 @@ void
 CqaFfMacScheduler::DoCschedUeConfigReq (const struct FfMacCschedSapProvider::CschedUeConfigReqParameters& params)
 {
   NS_LOG_FUNCTION (this << " RNTI " << params.m_rnti << " txMode " << (uint16_t)params.m_transmissionMode);
-  std::map <uint16_t,uint8_t>::iterator it = m_uesTxMode.find (params.m_rnti);
-  if (it == m_uesTxMode.end ())
-    {
-      m_uesTxMode.insert (std::pair <uint16_t, uint8_t> (params.m_rnti, params.m_transmissionMode));
-      // generate HARQ buffers
-      m_dlHarqCurrentProcessId.insert (std::pair <uint16_t,uint8_t > (params.m_rnti, 0));
-      DlHarqProcessesStatus_t dlHarqPrcStatus;
-      dlHarqPrcStatus.resize (8,0);
-      m_dlHarqProcessesStatus.insert (std::pair <uint16_t, DlHarqProcessesStatus_t> (params.m_rnti, dlHarqPrcStatus));
-      DlHarqProcessesTimer_t dlHarqProcessesTimer;
-      dlHarqProcessesTimer.resize (8,0);
-      m_dlHarqProcessesTimer.insert (std::pair <uint16_t, DlHarqProcessesTimer_t> (params.m_rnti, dlHarqProcessesTimer));
-      DlHarqProcessesDciBuffer_t dlHarqdci;
-      dlHarqdci.resize (8);
-      m_dlHarqProcessesDciBuffer.insert (std::pair <uint16_t, DlHarqProcessesDciBuffer_t> (params.m_rnti, dlHarqdci));
-      DlHarqRlcPduListBuffer_t dlHarqRlcPdu;
-      dlHarqRlcPdu.resize (2);
-      dlHarqRlcPdu.at (0).resize (8);
-      dlHarqRlcPdu.at (1).resize (8);
-      m_dlHarqProcessesRlcPduListBuffer.insert (std::pair <uint16_t, DlHarqRlcPduListBuffer_t> (params.m_rnti, dlHarqRlcPdu));
-      m_ulHarqCurrentProcessId.insert (std::pair <uint16_t,uint8_t > (params.m_rnti, 0));
-      UlHarqProcessesStatus_t ulHarqPrcStatus;
-      ulHarqPrcStatus.resize (8,0);
-      m_ulHarqProcessesStatus.insert (std::pair <uint16_t, UlHarqProcessesStatus_t> (params.m_rnti, ulHarqPrcStatus));
-      UlHarqProcessesDciBuffer_t ulHarqdci;
-      ulHarqdci.resize (8);
-      m_ulHarqProcessesDciBuffer.insert (std::pair <uint16_t, UlHarqProcessesDciBuffer_t> (params.m_rnti, ulHarqdci));
-    }
-  else
+  uint32_t slot = m_ues.GetSlot (params.m_rnti);
+  if (slot == FfMacSchedulerUeTable::NO_SLOT)
     {
-      (*it).second = params.m_transmissionMode;
+      slot = AddUe (params.m_rnti);
     }
+  m_uesTxMode.at (slot) = params.m_transmissionMode;
   return;
 }
 
+uint32_t
+CqaFfMacScheduler::AddUe (uint16_t rnti)
+{
+  uint32_t slot = m_ues.AddUe (rnti);
+  uint32_t nSlots = m_ues.GetNSlots ();
+  if (m_uesTxMode.size () < nSlots)
+    {
+      m_uesTxMode.resize (nSlots);
+      m_dlHarqCurrentProcessId.resize (nSlots);
+      m_dlHarqProcessesStatus.resize (nSlots * HARQ_PROC_NUM);
+      m_dlHarqProcessesTimer.resize (nSlots * HARQ_PROC_NUM);
+      m_dlHarqProcessesDciBuffer.resize (nSlots);
+      m_dlHarqProcessesRlcPduListBuffer.resize (nSlots);
+      m_ulHarqCurrentProcessId.resize (nSlots);
+      m_ulHarqProcessesStatus.resize (nSlots * HARQ_PROC_NUM);
+      m_ulHarqProcessesDciBuffer.resize (nSlots);
+      m_p10CqiTimers.resize (nSlots);
+      m_a30CqiTimers.resize (nSlots);
+    }
+  // generate HARQ buffers, reusing those of the previous UE of the slot
+  m_dlHarqCurrentProcessId.at (slot) = 0;
+  m_ulHarqCurrentProcessId.at (slot) = 0;
+  for (uint16_t i = 0; i < HARQ_PROC_NUM; i++)
+    {
+      m_dlHarqProcessesStatus.at (slot * HARQ_PROC_NUM + i) = 0;
+      m_dlHarqProcessesTimer.at (slot * HARQ_PROC_NUM + i) = 0;
+      m_ulHarqProcessesStatus.at (slot * HARQ_PROC_NUM + i) = 0;
+    }
+  m_dlHarqProcessesDciBuffer.at (slot).assign (HARQ_PROC_NUM, DlDciListElement_s ());
+  DlHarqRlcPduListBuffer_t& dlHarqRlcPdu = m_dlHarqProcessesRlcPduListBuffer.at (slot);
+  dlHarqRlcPdu.resize (2);
+  for (uint16_t layer = 0; layer < 2; layer++)
+    {
+      dlHarqRlcPdu.at (layer).resize (HARQ_PROC_NUM);
+      for (uint16_t i = 0; i < HARQ_PROC_NUM; i++)
+        {
+          dlHarqRlcPdu.at (layer).at (i).clear ();
+        }
+    }
+  m_ulHarqProcessesDciBuffer.at (slot).assign (HARQ_PROC_NUM, UlDciListElement_s ());
+  return slot;
+}
+
+uint32_t
+CqaFfMacScheduler::GetUeSlot (uint16_t rnti) const
+{
+  uint32_t slot = m_ues.GetSlot (rnti);
+  if (slot == FfMacSchedulerUeTable::NO_SLOT)
+    {
+      NS_FATAL_ERROR ("No info found for this RNTI " << rnti);
+    }
+  return slot;
+}
+
 void
 CqaFfMacScheduler::DoCschedLcConfigReq (const struct FfMacCschedSapProvider::CschedLcConfigReqParameters& params)
 {
@@ -455,17 +489,19 @@ CqaFfMacScheduler::DoCschedLcConfigReq (const struct FfMacCschedSapProvider::Csc
     }
 
 
-  std::map <uint16_t, CqasFlowPerf_t>::iterator it;
-
+  uint32_t slot = m_ues.GetSlot (params.m_rnti);
+  if (slot == FfMacSchedulerUeTable::NO_SLOT)
+    {
+      NS_LOG_ERROR (this << " LC configured for unknown RNTI " << params.m_rnti);
+      return;
+    }
   for (uint16_t i = 0; i < params.m_logicalChannelConfigList.size (); i++)
     {
-      it = m_flowStatsDl.find (params.m_rnti);
+      double tbrDlInBytes = params.m_logicalChannelConfigList.at (i).m_eRabGuaranteedBitrateDl / 8;   // byte/s
+      double tbrUlInBytes = params.m_logicalChannelConfigList.at (i).m_eRabGuaranteedBitrateUl / 8;   // byte/s
 
-      if (it == m_flowStatsDl.end ())
+      if (!m_flowStatsDl.Has (slot))
         {
-          double tbrDlInBytes = params.m_logicalChannelConfigList.at (i).m_eRabGuaranteedBitrateDl / 8;   // byte/s
-          double tbrUlInBytes = params.m_logicalChannelConfigList.at (i).m_eRabGuaranteedBitrateUl / 8;   // byte/s
-
           CqasFlowPerf_t flowStatsDl;
           flowStatsDl.flowStart = Simulator::Now ();
           flowStatsDl.totalBytesTransmitted = 0;
@@ -473,7 +509,7 @@ CqaFfMacScheduler::DoCschedLcConfigReq (const struct FfMacCschedSapProvider::Csc
           flowStatsDl.lastAveragedThroughput = 1;
           flowStatsDl.secondLastAveragedThroughput = 1;
           flowStatsDl.targetThroughput = tbrDlInBytes;
-          m_flowStatsDl.insert (std::pair<uint16_t, CqasFlowPerf_t> (params.m_rnti, flowStatsDl));
+          m_flowStatsDl.Set (slot, flowStatsDl);
           CqasFlowPerf_t flowStatsUl;
           flowStatsUl.flowStart = Simulator::Now ();
           flowStatsUl.totalBytesTransmitted = 0;
@@ -481,16 +517,13 @@ CqaFfMacScheduler::DoCschedLcConfigReq (const struct FfMacCschedSapProvider::Csc
           flowStatsUl.lastAveragedThroughput = 1;
           flowStatsUl.secondLastAveragedThroughput = 1;
           flowStatsUl.targetThroughput = tbrUlInBytes;
-          m_flowStatsUl.insert (std::pair<uint16_t, CqasFlowPerf_t> (params.m_rnti, flowStatsUl));
+          m_flowStatsUl.Set (slot, flowStatsUl);
         }
       else
         {
           // update GBR from UeManager::SetupDataRadioBearer ()
-          double tbrDlInBytes = params.m_logicalChannelConfigList.at (i).m_eRabGuaranteedBitrateDl / 8;   // byte/s
-          double tbrUlInBytes = params.m_logicalChannelConfigList.at (i).m_eRabGuaranteedBitrateUl / 8;   // byte/s
-          m_flowStatsDl[(*it).first].targetThroughput = tbrDlInBytes;
-          m_flowStatsUl[(*it).first].targetThroughput = tbrUlInBytes;
-
+          m_flowStatsDl.Get (slot).targetThroughput = tbrDlInBytes;
+          m_flowStatsUl.Get (slot).targetThroughput = tbrUlInBytes;
         }
     }
 
@@ -554,18 +587,16 @@ CqaFfMacScheduler::DoCschedUeReleaseReq (const struct FfMacCschedSapProvider::Cs
         }
     }
 
-  m_uesTxMode.erase (params.m_rnti);
-  m_dlHarqCurrentProcessId.erase (params.m_rnti);
-  m_dlHarqProcessesStatus.erase  (params.m_rnti);
-  m_dlHarqProcessesTimer.erase (params.m_rnti);
-  m_dlHarqProcessesDciBuffer.erase  (params.m_rnti);
-  m_dlHarqProcessesRlcPduListBuffer.erase  (params.m_rnti);
-  m_ulHarqCurrentProcessId.erase  (params.m_rnti);
-  m_ulHarqProcessesStatus.erase  (params.m_rnti);
-  m_ulHarqProcessesDciBuffer.erase  (params.m_rnti);
-  m_flowStatsDl.erase  (params.m_rnti);
-  m_flowStatsUl.erase  (params.m_rnti);
-  m_ceBsrRxed.erase (params.m_rnti);
+  uint32_t slot = m_ues.RemoveUe (params.m_rnti);
+  if (slot != FfMacSchedulerUeTable::NO_SLOT)
+    {
+      // the HARQ buffers are reset when the slot is reused
+      m_flowStatsDl.Reset (slot);
+      m_flowStatsUl.Reset (slot);
+      m_p10CqiRxed.Reset (slot);
+      m_a30CqiRxed.Reset (slot);
+      m_ceBsrRxed.Reset (slot);
+    }
   std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it = m_rlcBufferReq.begin ();
   std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator temp;
   while (it!=m_rlcBufferReq.end ())
@@ -650,18 +681,18 @@ CqaFfMacScheduler::LcActivePerFlow (uint16_t rnti)
 {
   std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
   int lcActive = 0;
-  for (it = m_rlcBufferReq.begin (); it != m_rlcBufferReq.end (); it++)
+  for (it = m_rlcBufferReq.lower_bound (LteFlowId_t (rnti, 0)); it != m_rlcBufferReq.end (); it++)
     {
-      if (((*it).first.m_rnti == rnti) && (((*it).second.m_rlcTransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcRetransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcStatusPduSize > 0) ))
-        {
-          lcActive++;
-        }
       if ((*it).first.m_rnti > rnti)
         {
           break;
         }
+      if (((*it).second.m_rlcTransmissionQueueSize > 0)
+          || ((*it).second.m_rlcRetransmissionQueueSize > 0)
+          || ((*it).second.m_rlcStatusPduSize > 0))
+        {
+          lcActive++;
+        }
     }
   return (lcActive);
 
@@ -673,23 +704,16 @@ CqaFfMacScheduler::HarqProcessAvailability (uint16_t rnti)
 {
   NS_LOG_FUNCTION (this << rnti);
 
-  std::map <uint16_t, uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
-  if (it == m_dlHarqCurrentProcessId.end ())
-    {
-      NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
-    }
-  std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
-  if (itStat == m_dlHarqProcessesStatus.end ())
-    {
-      NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
-    }
-  uint8_t i = (*it).second;
+  uint32_t slot = GetUeSlot (rnti);
+  uint8_t current = m_dlHarqCurrentProcessId[slot];
+  const uint8_t *status = &m_dlHarqProcessesStatus[slot * HARQ_PROC_NUM];
+  uint8_t i = current;
   do
     {
       i = (i + 1) % HARQ_PROC_NUM;
     }
-  while ( ((*itStat).second.at (i) != 0)&&(i != (*it).second));
-  if ((*itStat).second.at (i) == 0)
+  while ((status[i] != 0)&&(i != current));
+  if (status[i] == 0)
     {
       return (true);
     }
@@ -712,33 +736,26 @@ CqaFfMacScheduler::UpdateHarqProcessId (uint16_t rnti)
     }
 
 
-  std::map <uint16_t, uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
-  if (it == m_dlHarqCurrentProcessId.end ())
-    {
-      NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
-    }
-  std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
-  if (itStat == m_dlHarqProcessesStatus.end ())
-    {
-      NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
-    }
-  uint8_t i = (*it).second;
+  uint32_t slot = GetUeSlot (rnti);
+  uint8_t& current = m_dlHarqCurrentProcessId[slot];
+  uint8_t *status = &m_dlHarqProcessesStatus[slot * HARQ_PROC_NUM];
+  uint8_t i = current;
   do
     {
       i = (i + 1) % HARQ_PROC_NUM;
     }
-  while ( ((*itStat).second.at (i) != 0)&&(i != (*it).second));
-  if ((*itStat).second.at (i) == 0)
+  while ((status[i] != 0)&&(i != current));
+  if (status[i] == 0)
     {
-      (*it).second = i;
-      (*itStat).second.at (i) = 1;
+      current = i;
+      status[i] = 1;
     }
   else
     {
       NS_FATAL_ERROR ("No HARQ process available for RNTI " << rnti << " check before update with HarqProcessAvailability");
     }
 
-  return ((*it).second);
+  return (current);
 }
 
 
@@ -747,27 +764,23 @@ CqaFfMacScheduler::RefreshHarqProcesses ()
 {
   NS_LOG_FUNCTION (this);
 
-  std::map <uint16_t, DlHarqProcessesTimer_t>::iterator itTimers;
-  for (itTimers = m_dlHarqProcessesTimer.begin (); itTimers != m_dlHarqProcessesTimer.end (); itTimers++)
+  for (uint32_t u = 0; u < m_ues.GetNUes (); u++)
     {
+      uint32_t slot = m_ues.GetUeSlot (u);
+      uint8_t *timers = &m_dlHarqProcessesTimer[slot * HARQ_PROC_NUM];
       for (uint16_t i = 0; i < HARQ_PROC_NUM; i++)
         {
-          if ((*itTimers).second.at (i) == HARQ_DL_TIMEOUT)
+          if (timers[i] == HARQ_DL_TIMEOUT)
             {
               // reset HARQ process
 
-              NS_LOG_DEBUG (this << " Reset HARQ proc " << i << " for RNTI " << (*itTimers).first);
-              std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find ((*itTimers).first);
-              if (itStat == m_dlHarqProcessesStatus.end ())
-                {
-                  NS_FATAL_ERROR ("No Process Id Status found for this RNTI " << (*itTimers).first);
-                }
-              (*itStat).second.at (i) = 0;
-              (*itTimers).second.at (i) = 0;
+              NS_LOG_DEBUG (this << " Reset HARQ proc " << i << " for RNTI " << m_ues.GetRnti (slot));
+              m_dlHarqProcessesStatus[slot * HARQ_PROC_NUM + i] = 0;
+              timers[i] = 0;
             }
           else
             {
-              (*itTimers).second.at (i)++;
+              timers[i]++;
             }
         }
     }
@@ -814,10 +827,10 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
   FfMacSchedSapUser::SchedDlConfigIndParameters ret;
 
   //   update UL HARQ proc id
-  std::map <uint16_t, uint8_t>::iterator itProcId;
-  for (itProcId = m_ulHarqCurrentProcessId.begin (); itProcId != m_ulHarqCurrentProcessId.end (); itProcId++)
+  for (uint32_t u = 0; u < m_ues.GetNUes (); u++)
     {
-      (*itProcId).second = ((*itProcId).second + 1) % HARQ_PROC_NUM;
+      uint8_t& procId = m_ulHarqCurrentProcessId[m_ues.GetUeSlot (u)];
+      procId = (procId + 1) % HARQ_PROC_NUM;
     }
 
 
@@ -924,19 +937,13 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
           uldci.m_pdcchPowerOffset = 0; // not used
 
           uint8_t harqId = 0;
-          std::map <uint16_t, uint8_t>::iterator itProcId;
-          itProcId = m_ulHarqCurrentProcessId.find (uldci.m_rnti);
-          if (itProcId == m_ulHarqCurrentProcessId.end ())
+          uint32_t slot = m_ues.GetSlot (uldci.m_rnti);
+          if (slot == FfMacSchedulerUeTable::NO_SLOT)
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << uldci.m_rnti);
             }
-          harqId = (*itProcId).second;
-          std::map <uint16_t, UlHarqProcessesDciBuffer_t>::iterator itDci = m_ulHarqProcessesDciBuffer.find (uldci.m_rnti);
-          if (itDci == m_ulHarqProcessesDciBuffer.end ())
-            {
-              NS_FATAL_ERROR ("Unable to find RNTI entry in UL DCI HARQ buffer for RNTI " << uldci.m_rnti);
-            }
-          (*itDci).second.at (harqId) = uldci;
+          harqId = m_ulHarqCurrentProcessId[slot];
+          m_ulHarqProcessesDciBuffer[slot].at (harqId) = uldci;
         }
       
       rbStart = rbStart + rbLen;
@@ -996,13 +1003,15 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
           uint16_t rnti = m_dlInfoListBuffered.at (i).m_rnti;
           uint8_t harqId = m_dlInfoListBuffered.at (i).m_harqProcessId;
           NS_LOG_INFO (this << " HARQ retx RNTI " << rnti << " harqId " << (uint16_t)harqId);
-          std::map <uint16_t, DlHarqProcessesDciBuffer_t>::iterator itHarq = m_dlHarqProcessesDciBuffer.find (rnti);
-          if (itHarq == m_dlHarqProcessesDciBuffer.end ())
+          uint32_t slot = m_ues.GetSlot (rnti);
+          if (slot == FfMacSchedulerUeTable::NO_SLOT)
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << rnti);
             }
+          DlHarqProcessesDciBuffer_t& harqDci = m_dlHarqProcessesDciBuffer[slot];
+          DlHarqRlcPduListBuffer_t& harqRlcPdu = m_dlHarqProcessesRlcPduListBuffer[slot];
 
-          DlDciListElement_s dci = (*itHarq).second.at (harqId);
+          DlDciListElement_s dci = harqDci.at (harqId);
           int rv = 0;
           if (dci.m_rv.size () == 1)
             {
@@ -1017,20 +1026,10 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
             {
               // maximum number of retx reached -> drop process
               NS_LOG_INFO ("Maximum number of retransmissions reached -> drop process");
-              std::map <uint16_t, DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (rnti);
-              if (it == m_dlHarqProcessesStatus.end ())
+              m_dlHarqProcessesStatus[slot * HARQ_PROC_NUM + harqId] = 0;
+              for (uint16_t k = 0; k < harqRlcPdu.size (); k++)
                 {
-                  NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << m_dlInfoListBuffered.at (i).m_rnti);
-                }
-              (*it).second.at (harqId) = 0;
-              std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
-              if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
-                {
-                  NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << m_dlInfoListBuffered.at (i).m_rnti);
-                }
-              for (uint16_t k = 0; k < (*itRlcPdu).second.size (); k++)
-                {
-                  (*itRlcPdu).second.at (k).at (harqId).clear ();
+                  harqRlcPdu.at (k).at (harqId).clear ();
                 }
               continue;
             }
@@ -1109,11 +1108,6 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
             }
           // retrieve RLC PDU list for retx TBsize and update DCI
           BuildDataListElement_s newEl;
-          std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
-          if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
-            {
-              NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << rnti);
-            }
           for (uint8_t j = 0; j < nLayers; j++)
             {
               if (retx.at (j))
@@ -1131,7 +1125,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
                     {
                       dci.m_ndi.at (j) = 0;
                       dci.m_rv.at (j)++;
-                      (*itHarq).second.at (harqId).m_rv.at (j)++;
+                      harqDci.at (harqId).m_rv.at (j)++;
                       NS_LOG_INFO (this << " layer " << (uint16_t)j << " RV " << (uint16_t)dci.m_rv.at (j));
                     }
                 }
@@ -1145,7 +1139,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
                   NS_LOG_INFO (this << " layer " << (uint16_t)j << " no retx");
                 }
             }
-          for (uint16_t k = 0; k < (*itRlcPdu).second.at (0).at (dci.m_harqProcess).size (); k++)
+          for (uint16_t k = 0; k < harqRlcPdu.at (0).at (dci.m_harqProcess).size (); k++)
             {
               std::vector <struct RlcPduListElement_s> rlcPduListPerLc;
               for (uint8_t j = 0; j < nLayers; j++)
@@ -1154,7 +1148,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
                     {
                       if (j < dci.m_ndi.size ())
                         {
-                          rlcPduListPerLc.push_back ((*itRlcPdu).second.at (j).at (dci.m_harqProcess).at (k));
+                          rlcPduListPerLc.push_back (harqRlcPdu.at (j).at (dci.m_harqProcess).at (k));
                         }
                     }
                 }
@@ -1166,14 +1160,9 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
             }
           newEl.m_rnti = rnti;
           newEl.m_dci = dci;
-          (*itHarq).second.at (harqId).m_rv = dci.m_rv;
+          harqDci.at (harqId).m_rv = dci.m_rv;
           // refresh timer
-          std::map <uint16_t, DlHarqProcessesTimer_t>::iterator itHarqTimer = m_dlHarqProcessesTimer.find (rnti);
-          if (itHarqTimer== m_dlHarqProcessesTimer.end ())
-            {
-              NS_FATAL_ERROR ("Unable to find HARQ timer for RNTI " << (uint16_t)rnti);
-            }
-          (*itHarqTimer).second.at (harqId) = 0;
+          m_dlHarqProcessesTimer[slot * HARQ_PROC_NUM + harqId] = 0;
           ret.m_buildDataList.push_back (newEl);
           rntiAllocated.insert (rnti);
         }
@@ -1181,20 +1170,17 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
         {
           // update HARQ process status
           NS_LOG_INFO (this << " HARQ received ACK for UE " << m_dlInfoListBuffered.at (i).m_rnti);
-          std::map <uint16_t, DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (m_dlInfoListBuffered.at (i).m_rnti);
-          if (it == m_dlHarqProcessesStatus.end ())
+          uint32_t slot = m_ues.GetSlot (m_dlInfoListBuffered.at (i).m_rnti);
+          if (slot == FfMacSchedulerUeTable::NO_SLOT)
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << m_dlInfoListBuffered.at (i).m_rnti);
             }
-          (*it).second.at (m_dlInfoListBuffered.at (i).m_harqProcessId) = 0;
-          std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (m_dlInfoListBuffered.at (i).m_rnti);
-          if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
-            {
-              NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << m_dlInfoListBuffered.at (i).m_rnti);
-            }
-          for (uint16_t k = 0; k < (*itRlcPdu).second.size (); k++)
+          uint8_t harqId = m_dlInfoListBuffered.at (i).m_harqProcessId;
+          m_dlHarqProcessesStatus[slot * HARQ_PROC_NUM + harqId] = 0;
+          DlHarqRlcPduListBuffer_t& harqRlcPdu = m_dlHarqProcessesRlcPduListBuffer[slot];
+          for (uint16_t k = 0; k < harqRlcPdu.size (); k++)
             {
-              (*itRlcPdu).second.at (k).at (m_dlInfoListBuffered.at (i).m_harqProcessId).clear ();
+              harqRlcPdu.at (k).at (harqId).clear ();
             }
         }
     }
@@ -1279,8 +1265,6 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
   std::map<LteFlowId_t, int> UeToAmountOfDataToTransfer;
   //Initialize the map per UE, how much resources is already assigned to the user
   std::map<LteFlowId_t, int> UeToAmountOfAssignedResources;
-  // prepare values to calculate FF metric, this metric will be the same for all flows(logical channels) that belong to the same RNTI
-  std::map < uint16_t, uint8_t > sbCqiSum;
 
   for( std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itrbr = m_rlcBufferReq.begin ();
        itrbr!=m_rlcBufferReq.end (); itrbr++)
@@ -1288,64 +1272,11 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
 
       LteFlowId_t flowId = itrbr->first;                // Prepare data for the scheduling mechanism
       // map: UE, to the amount of traffic they have to transfer
-      int amountOfDataToTransfer =  8*((int)m_rlcBufferReq.find (flowId)->second.m_rlcRetransmissionQueueSize +
-                                       (int)m_rlcBufferReq.find (flowId)->second.m_rlcTransmissionQueueSize);
+      int amountOfDataToTransfer =  8*((int)itrbr->second.m_rlcRetransmissionQueueSize +
+                                       (int)itrbr->second.m_rlcTransmissionQueueSize);
 
       UeToAmountOfDataToTransfer.insert (std::pair<LteFlowId_t,int>(flowId,amountOfDataToTransfer));
       UeToAmountOfAssignedResources.insert (std::pair<LteFlowId_t,int>(flowId,0));
-
-      uint8_t sum = 0;
-      for (int i = 0; i < numberOfRBGs; i++)
-        {
-          std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-          itCqi = m_a30CqiRxed.find ((*itrbr).first.m_rnti);
-          std::map <uint16_t,uint8_t>::iterator itTxMode;
-          itTxMode = m_uesTxMode.find ((*itrbr).first.m_rnti);
-          if (itTxMode == m_uesTxMode.end ())
-            {
-              NS_FATAL_ERROR ("No Transmission Mode info on user " << (*itrbr).first.m_rnti);
-            }
-          int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-          std::vector <uint8_t> sbCqis;
-          if (itCqi == m_a30CqiRxed.end ())
-            {
-              for (uint8_t k = 0; k < nLayer; k++)
-                {
-                  sbCqis.push_back (1);                        // start with lowest value
-                }
-            }
-          else
-            {
-              sbCqis = (*itCqi).second.m_higherLayerSelected.at (i).m_sbCqi;
-            }
-
-          uint8_t cqi1 = sbCqis.at (0);
-          uint8_t cqi2 = 1;
-          if (sbCqis.size () > 1)
-            {
-              cqi2 = sbCqis.at (1);
-            }
-
-          uint8_t sbCqi;
-          if ((cqi1 > 0)||(cqi2 > 0))               // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
-            {
-              for (uint8_t k = 0; k < nLayer; k++)
-                {
-                  if (sbCqis.size () > k)
-                    {
-                      sbCqi = sbCqis.at (k);
-                    }
-                  else
-                    {
-                      // no info on this subband
-                      sbCqi = 0;
-                    }
-                  sum += sbCqi;
-                }
-            }               // end if cqi
-        }        // end of rbgNum
-
-      sbCqiSum.insert (std::pair<uint16_t, uint8_t> ((*itrbr).first.m_rnti, sum));
     }
 
   // availableRBGs - set that contains indexes of available resource block groups
@@ -1407,34 +1338,33 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
               double metric = 0;
               uint8_t worstCQIAmongRBGsAllocatedForThisUser = 15;
               int numberOfRBGAllocatedForThisUser = 0;
-              LogicalChannelConfigListElement_s lc = m_ueLogicalChannelsConfigList.find (flowId)->second;
-              std::map <uint16_t,SbMeasResult_s>::iterator itRntiCQIsMap = m_a30CqiRxed.find (flowId.m_rnti);
-
-              std::map <uint16_t, CqasFlowPerf_t>::iterator itStats;
+              const LogicalChannelConfigListElement_s& lc = m_ueLogicalChannelsConfigList.find (flowId)->second;
+              uint32_t slot = GetUeSlot (flowId.m_rnti);
 
               if ((m_ffrSapProvider->IsDlRbgAvailableForUe (currentRB, flowId.m_rnti)) == false)
                 {
                   continue;
                 }
 
-              if (m_flowStatsDl.find (flowId.m_rnti) == m_flowStatsDl.end ())
+              if (!m_flowStatsDl.Has (slot))
                 {
                   continue;                               // TO DO:  check if this should be logged and how.
                 }
               currentRBchecked = true;
 
-              itStats = m_flowStatsDl.find (flowId.m_rnti);
-              double tbr_weight = (*itStats).second.targetThroughput / (*itStats).second.lastAveragedThroughput;
+              const CqasFlowPerf_t& flowStats = m_flowStatsDl.Get (slot);
+              double tbr_weight = flowStats.targetThroughput / flowStats.lastAveragedThroughput;
               if (tbr_weight < 1.0)
                 tbr_weight = 1.0;
 
-              if (itRntiCQIsMap != m_a30CqiRxed.end ())
+              if (m_a30CqiRxed.Has (slot))
                 {
+                  const SbMeasResult_s& sbMeasResult = m_a30CqiRxed.Get (slot);
                   for(std::set<int>::iterator it=availableRBGs.begin (); it!=availableRBGs.end (); it++)
                     {
                       try
                         {
-                          int val = (itRntiCQIsMap->second.m_higherLayerSelected.at (*it).m_sbCqi.at (0));
+                          int val = (sbMeasResult.m_higherLayerSelected.at (*it).m_sbCqi.at (0));
                           if (val==0)
                             val=1;                                             //if no info, use minimum
                           if (*it == currentRB)
@@ -1481,10 +1411,9 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
 
 
               double achievableRate = (( m_amc->GetTbSizeFromMcs (mcsForThisUser, rbgSize)/ 8) / 0.001);
-              double pf_weight = achievableRate / (*itStats).second.secondLastAveragedThroughput;
+              double pf_weight = achievableRate / flowStats.secondLastAveragedThroughput;
 
               UeToAmountOfAssignedResources.find (flowId)->second = tbSize;
-              FfMacSchedSapProvider::SchedDlRlcBufferReqParameters lcBufferInfo = m_rlcBufferReq.find (flowId)->second;
 
               if (UeToAmountOfDataToTransfer.find (flowId)->second - UeToAmountOfAssignedResources.find (flowId)->second < 0)
                 {
@@ -1493,9 +1422,9 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
 
               double bitRateWithNewRBG = 0;
 
-              if (m_flowStatsDl.find (flowId.m_rnti)!= m_flowStatsDl.end ())                         // there are some statistics{
+              if (m_flowStatsDl.Has (slot))                         // there are some statistics{
                 {
-                  bitRateWithNewRBG = (1.0 - (1.0 / m_timeWindow)) * (m_flowStatsDl.find (flowId.m_rnti)->second.lastAveragedThroughput) + ((1.0 / m_timeWindow) * (double)(tbSize*1000));
+                  bitRateWithNewRBG = (1.0 - (1.0 / m_timeWindow)) * (flowStats.lastAveragedThroughput) + ((1.0 / m_timeWindow) * (double)(tbSize*1000));
                 }
               else
                 {
@@ -1574,10 +1503,13 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
 
 
   // reset TTI stats of users
-  std::map <uint16_t, CqasFlowPerf_t>::iterator itStats;
-  for (itStats = m_flowStatsDl.begin (); itStats != m_flowStatsDl.end (); itStats++)
+  for (uint32_t u = 0; u < m_ues.GetNUes (); u++)
     {
-      (*itStats).second.lastTtiBytesTransmitted = 0;
+      uint32_t slot = m_ues.GetUeSlot (u);
+      if (m_flowStatsDl.Has (slot))
+        {
+          m_flowStatsDl.Get (slot).lastTtiBytesTransmitted = 0;
+        }
     }
 
   // 3) Creating the correspondent DCIs (Generate the transmission opportunities by grouping the RBGs of the same RNTI)
@@ -1597,6 +1529,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
       std::vector <struct RlcPduListElement_s> newRlcPduLe;
       newDci.m_rnti = (*itMap).first;
       newDci.m_harqProcess = UpdateHarqProcessId ((*itMap).first);
+      uint32_t slot = GetUeSlot ((*itMap).first);
       uint16_t lcActives = LcActivePerFlow (itMap->first);
       if (lcActives==0)           // if there is still no buffer report information on any flow
         lcActives = 1;
@@ -1606,8 +1539,6 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
       double doubleRbgNum = numberOfRBGs;
       double rrRatio = doubleRBgPerRnti/doubleRbgNum;
       m_rnti_per_ratio.insert (std::pair<uint16_t,double>((*itMap).first,rrRatio));
-      std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-      itCqi = m_a30CqiRxed.find ((*itMap).first);
       uint8_t worstCqi = 15;
 
       // assign the worst value of CQI that user experienced on any of its subbands
@@ -1635,7 +1566,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
       // NOTE: In this first version of CqaFfMacScheduler, it is assumed one flow per user.
       // create the rlc PDUs -> equally divide resources among active LCs
       std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itBufReq;
-      for (itBufReq = m_rlcBufferReq.begin (); itBufReq != m_rlcBufferReq.end (); itBufReq++)
+      for (itBufReq = m_rlcBufferReq.lower_bound (LteFlowId_t ((*itMap).first, 0)); itBufReq != m_rlcBufferReq.end (); itBufReq++)
         {
           if (((*itBufReq).first.m_rnti == (*itMap).first)
               && (((*itBufReq).second.m_rlcTransmissionQueueSize > 0)
@@ -1655,13 +1586,8 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
               if (m_harqOn == true)
                 {
                   // store RLC PDU list for HARQ
-                  std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find ((*itMap).first);
-                  if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
-                    {
-                      NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << (*itMap).first);
-                    }
                   int j=0;
-                  (*itRlcPdu).second.at (j).at (newDci.m_harqProcess).push_back (newRlcEl);
+                  m_dlHarqProcessesRlcPduListBuffer[slot].at (j).at (newDci.m_harqProcess).push_back (newRlcEl);
                 }
               // }
               newEl.m_rlcPduList.push_back (newRlcPduLe);
@@ -1684,30 +1610,18 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
       if (m_harqOn == true)
         {
           // store DCI for HARQ
-          std::map <uint16_t, DlHarqProcessesDciBuffer_t>::iterator itDci = m_dlHarqProcessesDciBuffer.find (newEl.m_rnti);
-          if (itDci == m_dlHarqProcessesDciBuffer.end ())
-            {
-              NS_FATAL_ERROR ("Unable to find RNTI entry in DCI HARQ buffer for RNTI " << newEl.m_rnti);
-            }
-          (*itDci).second.at (newDci.m_harqProcess) = newDci;
+          m_dlHarqProcessesDciBuffer[slot].at (newDci.m_harqProcess) = newDci;
           // refresh timer
-          std::map <uint16_t, DlHarqProcessesTimer_t>::iterator itHarqTimer =  m_dlHarqProcessesTimer.find (newEl.m_rnti);
-          if (itHarqTimer== m_dlHarqProcessesTimer.end ())
-            {
-              NS_FATAL_ERROR ("Unable to find HARQ timer for RNTI " << (uint16_t)newEl.m_rnti);
-            }
-          (*itHarqTimer).second.at (newDci.m_harqProcess) = 0;
+          m_dlHarqProcessesTimer[slot * HARQ_PROC_NUM + newDci.m_harqProcess] = 0;
         }
 
       // ...more parameters -> ingored in this version
 
       ret.m_buildDataList.push_back (newEl);
       // update UE stats
-      std::map <uint16_t, CqasFlowPerf_t>::iterator it;
-      it = m_flowStatsDl.find ((*itMap).first);
-      if (it != m_flowStatsDl.end ())
+      if (m_flowStatsDl.Has (slot))
         {
-          (*it).second.lastTtiBytesTransmitted = tbSize;
+          m_flowStatsDl.Get (slot).lastTtiBytesTransmitted = tbSize;
         }
       else
         {
@@ -1720,19 +1634,25 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
 
   // update UEs stats
   NS_LOG_INFO (this << " Update UEs statistics");
-  for (itStats = m_flowStatsDl.begin (); itStats != m_flowStatsDl.end (); itStats++)
+  for (uint32_t u = 0; u < m_ues.GetNUes (); u++)
     {
-      if (allocationMapPerRntiPerLCId.find (itStats->first)!= allocationMapPerRntiPerLCId.end ())
+      uint32_t slot = m_ues.GetUeSlot (u);
+      if (!m_flowStatsDl.Has (slot))
+        {
+          continue;
+        }
+      CqasFlowPerf_t& stats = m_flowStatsDl.Get (slot);
+      if (allocationMapPerRntiPerLCId.find (m_ues.GetRnti (slot))!= allocationMapPerRntiPerLCId.end ())
         {
-          (*itStats).second.secondLastAveragedThroughput = ((1.0 - (1 / m_timeWindow)) * (*itStats).second.secondLastAveragedThroughput) + ((1 / m_timeWindow) * (double)((*itStats).second.lastTtiBytesTransmitted / 0.001));
+          stats.secondLastAveragedThroughput = ((1.0 - (1 / m_timeWindow)) * stats.secondLastAveragedThroughput) + ((1 / m_timeWindow) * (double)(stats.lastTtiBytesTransmitted / 0.001));
         }
 
-      (*itStats).second.totalBytesTransmitted += (*itStats).second.lastTtiBytesTransmitted;
+      stats.totalBytesTransmitted += stats.lastTtiBytesTransmitted;
       // update average throughput (see eq. 12.3 of Sec 12.3.1.2 of LTE – The UMTS Long Term Evolution, Ed Wiley)
-      (*itStats).second.lastAveragedThroughput = ((1.0 - (1.0 / m_timeWindow)) * (*itStats).second.lastAveragedThroughput) + ((1.0 / m_timeWindow) * (double)((*itStats).second.lastTtiBytesTransmitted / 0.001));
-      NS_LOG_INFO (this << " UE total bytes " << (*itStats).second.totalBytesTransmitted);
-      NS_LOG_INFO (this << " UE average throughput " << (*itStats).second.lastAveragedThroughput);
-      (*itStats).second.lastTtiBytesTransmitted = 0;
+      stats.lastAveragedThroughput = ((1.0 - (1.0 / m_timeWindow)) * stats.lastAveragedThroughput) + ((1.0 / m_timeWindow) * (double)(stats.lastTtiBytesTransmitted / 0.001));
+      NS_LOG_INFO (this << " UE total bytes " << stats.totalBytesTransmitted);
+      NS_LOG_INFO (this << " UE average throughput " << stats.lastAveragedThroughput);
+      stats.lastTtiBytesTransmitted = 0;
     }
 
   m_schedSapUser->SchedDlConfigInd (ret);
@@ -1768,46 +1688,30 @@ CqaFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::Sche
       if ( params.m_cqiList.at (i).m_cqiType == CqiListElement_s::P10 )
         {
           NS_LOG_LOGIC ("wideband CQI " <<  (uint32_t) params.m_cqiList.at (i).m_wbCqi.at (0) << " reported");
-          std::map <uint16_t,uint8_t>::iterator it;
           uint16_t rnti = params.m_cqiList.at (i).m_rnti;
-          it = m_p10CqiRxed.find (rnti);
-          if (it == m_p10CqiRxed.end ())
+          uint32_t slot = m_ues.GetSlot (rnti);
+          if (slot == FfMacSchedulerUeTable::NO_SLOT)
             {
-              // create the new entry
-              m_p10CqiRxed.insert ( std::pair<uint16_t, uint8_t > (rnti, params.m_cqiList.at (i).m_wbCqi.at (0)) ); // only codeword 0 at this stage (SISO)
-              // generate correspondent timer
-              m_p10CqiTimers.insert ( std::pair<uint16_t, uint32_t > (rnti, m_cqiTimersThreshold));
-            }
-          else
-            {
-              // update the CQI value and refresh correspondent timer
-              (*it).second = params.m_cqiList.at (i).m_wbCqi.at (0);
-              // update correspondent timer
-              std::map <uint16_t,uint32_t>::iterator itTimers;
-              itTimers = m_p10CqiTimers.find (rnti);
-              (*itTimers).second = m_cqiTimersThreshold;
+              NS_LOG_ERROR (this << " CQI of unknown RNTI " << rnti);
+              continue;
             }
+          // store the CQI value and refresh correspondent timer
+          m_p10CqiRxed.Set (slot, params.m_cqiList.at (i).m_wbCqi.at (0)); // only codeword 0 at this stage (SISO)
+          m_p10CqiTimers[slot] = m_cqiTimersThreshold;
         }
       else if ( params.m_cqiList.at (i).m_cqiType == CqiListElement_s::A30 )
         {
           // subband CQI reporting high layer configured
-          std::map <uint16_t,SbMeasResult_s>::iterator it;
           uint16_t rnti = params.m_cqiList.at (i).m_rnti;
-          it = m_a30CqiRxed.find (rnti);
-          if (it == m_a30CqiRxed.end ())
+          uint32_t slot = m_ues.GetSlot (rnti);
+          if (slot == FfMacSchedulerUeTable::NO_SLOT)
             {
-              // create the new entry
-              m_a30CqiRxed.insert ( std::pair<uint16_t, SbMeasResult_s > (rnti, params.m_cqiList.at (i).m_sbMeasResult) );
-              m_a30CqiTimers.insert ( std::pair<uint16_t, uint32_t > (rnti, m_cqiTimersThreshold));
-            }
-          else
-            {
-              // update the CQI value and refresh correspondent timer
-              (*it).second = params.m_cqiList.at (i).m_sbMeasResult;
-              std::map <uint16_t,uint32_t>::iterator itTimers;
-              itTimers = m_a30CqiTimers.find (rnti);
-              (*itTimers).second = m_cqiTimersThreshold;
+              NS_LOG_ERROR (this << " CQI of unknown RNTI " << rnti);
+              continue;
             }
+          // store the CQI value and refresh correspondent timer
+          m_a30CqiRxed.Set (slot, params.m_cqiList.at (i).m_sbMeasResult);
+          m_a30CqiTimers[slot] = m_cqiTimersThreshold;
         }
       else
         {
@@ -1905,26 +1809,19 @@ CqaFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sche
             {
               // retx correspondent block: retrieve the UL-DCI
               uint16_t rnti = params.m_ulInfoList.at (i).m_rnti;
-              std::map <uint16_t, uint8_t>::iterator itProcId = m_ulHarqCurrentProcessId.find (rnti);
-              if (itProcId == m_ulHarqCurrentProcessId.end ())
-                {
-                  NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << rnti);
-                }
-              uint8_t harqId = (uint8_t)((*itProcId).second - HARQ_PERIOD) % HARQ_PROC_NUM;
-              NS_LOG_INFO (this << " UL-HARQ retx RNTI " << rnti << " harqId " << (uint16_t)harqId << " i " << i << " size "  << params.m_ulInfoList.size ());
-              std::map <uint16_t, UlHarqProcessesDciBuffer_t>::iterator itHarq = m_ulHarqProcessesDciBuffer.find (rnti);
-              if (itHarq == m_ulHarqProcessesDciBuffer.end ())
+              uint32_t slot = m_ues.GetSlot (rnti);
+              if (slot == FfMacSchedulerUeTable::NO_SLOT)
                 {
                   NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << rnti);
                   continue;
                 }
-              UlDciListElement_s dci = (*itHarq).second.at (harqId);
-              std::map <uint16_t, UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (rnti);
-              if (itStat == m_ulHarqProcessesStatus.end ())
-                {
-                  NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << rnti);
-                }
-              if ((*itStat).second.at (harqId) >= 3)
+              uint8_t procId = m_ulHarqCurrentProcessId[slot];
+              uint8_t harqId = (uint8_t)(procId - HARQ_PERIOD) % HARQ_PROC_NUM;
+              NS_LOG_INFO (this << " UL-HARQ retx RNTI " << rnti << " harqId " << (uint16_t)harqId << " i " << i << " size "  << params.m_ulInfoList.size ());
+              UlHarqProcessesDciBuffer_t& harqDci = m_ulHarqProcessesDciBuffer[slot];
+              UlDciListElement_s dci = harqDci.at (harqId);
+              uint8_t *status = &m_ulHarqProcessesStatus[slot * HARQ_PROC_NUM];
+              if (status[harqId] >= 3)
                 {
                   NS_LOG_INFO ("Max number of retransmissions reached (UL)-> drop process");
                   continue;
@@ -1949,7 +1846,7 @@ CqaFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sche
                       NS_LOG_INFO ("\tRB " << j);
                       rbAllocatedNum++;
                     }
-                  NS_LOG_INFO (this << " Send retx in the same RBs " << (uint16_t)dci.m_rbStart << " to " << dci.m_rbStart + dci.m_rbLen << " RV " << (*itStat).second.at (harqId) + 1);
+                  NS_LOG_INFO (this << " Send retx in the same RBs " << (uint16_t)dci.m_rbStart << " to " << dci.m_rbStart + dci.m_rbLen << " RV " << status[harqId] + 1);
                 }
               else
                 {
@@ -1958,9 +1855,9 @@ CqaFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sche
                 }
               dci.m_ndi = 0;
               // Update HARQ buffers with new HarqId
-              (*itStat).second.at ((*itProcId).second) = (*itStat).second.at (harqId) + 1;
-              (*itStat).second.at (harqId) = 0;
-              (*itHarq).second.at ((*itProcId).second) = dci;
+              status[procId] = status[harqId] + 1;
+              status[harqId] = 0;
+              harqDci.at (procId) = dci;
               ret.m_dciList.push_back (dci);
               rntiAllocated.insert (dci.m_rnti);
             }
@@ -1971,14 +1868,24 @@ CqaFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sche
         }
     }
 
-  std::map <uint16_t,uint32_t>::iterator it;
+  // the UEs with a buffer status report, in RNTI order
+  m_ulUes.clear ();
+  for (uint32_t u = 0; u < m_ues.GetNUes (); u++)
+    {
+      if (m_ceBsrRxed.Has (m_ues.GetUeSlot (u)))
+        {
+          m_ulUes.push_back (m_ues.GetUeSlot (u));
+        }
+    }
+
+  uint32_t pos;
   int nflows = 0;
 
-  for (it = m_ceBsrRxed.begin (); it != m_ceBsrRxed.end (); it++)
+  for (pos = 0; pos < m_ulUes.size (); pos++)
     {
-      std::set <uint16_t>::iterator itRnti = rntiAllocated.find ((*it).first);
+      std::set <uint16_t>::iterator itRnti = rntiAllocated.find (m_ues.GetRnti (m_ulUes[pos]));
       // select UEs with queues not empty and not yet allocated for HARQ
-      if (((*it).second > 0)&&(itRnti == rntiAllocated.end ()))
+      if ((m_ceBsrRxed.Get (m_ulUes[pos]) > 0)&&(itRnti == rntiAllocated.end ()))
         {
           nflows++;
         }
@@ -2006,38 +1913,40 @@ CqaFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sche
     }
   int rbAllocated = 0;
 
-  std::map <uint16_t, CqasFlowPerf_t>::iterator itStats;
   if (m_nextRntiUl != 0)
     {
-      for (it = m_ceBsrRxed.begin (); it != m_ceBsrRxed.end (); it++)
+      for (pos = 0; pos < m_ulUes.size (); pos++)
         {
-          if ((*it).first == m_nextRntiUl)
+          if (m_ues.GetRnti (m_ulUes[pos]) == m_nextRntiUl)
             {
               break;
             }
         }
-      if (it == m_ceBsrRxed.end ())
+      if (pos == m_ulUes.size ())
         {
           NS_LOG_ERROR (this << " no user found");
+          pos = 0;
         }
     }
   else
     {
-      it = m_ceBsrRxed.begin ();
-      m_nextRntiUl = (*it).first;
+      pos = 0;
+      m_nextRntiUl = m_ues.GetRnti (m_ulUes[pos]);
     }
   do
     {
-      std::set <uint16_t>::iterator itRnti = rntiAllocated.find ((*it).first);
-      if ((itRnti != rntiAllocated.end ())||((*it).second == 0))
+      uint32_t slot = m_ulUes[pos];
+      uint16_t rnti = m_ues.GetRnti (slot);
+      std::set <uint16_t>::iterator itRnti = rntiAllocated.find (rnti);
+      if ((itRnti != rntiAllocated.end ())||(m_ceBsrRxed.Get (slot) == 0))
         {
           // UE already allocated for UL-HARQ -> skip it
-          NS_LOG_DEBUG (this << " UE already allocated in HARQ -> discared, RNTI " << (*it).first);
-          it++;
-          if (it == m_ceBsrRxed.end ())
+          NS_LOG_DEBUG (this << " UE already allocated in HARQ -> discared, RNTI " << rnti);
+          pos++;
+          if (pos == m_ulUes.size ())
             {
               // restart from the first
-              it = m_ceBsrRxed.begin ();
+              pos = 0;
             }
           continue;
         }
@@ -2055,7 +1964,7 @@ CqaFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sche
 
       rbAllocated = 0;
       UlDciListElement_s uldci;
-      uldci.m_rnti = (*it).first;
+      uldci.m_rnti = rnti;
       uldci.m_rbLen = rbPerFlow;
       bool allocated = false;
       NS_LOG_INFO (this << " RB Allocated " << rbAllocated << " rbPerFlow " << rbPerFlow << " flows " << nflows);
@@ -2070,7 +1979,7 @@ CqaFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sche
                   free = false;
                   break;
                 }
-              if ((m_ffrSapProvider->IsUlRbgAvailableForUe (j, (*it).first)) == false)
+              if ((m_ffrSapProvider->IsUlRbgAvailableForUe (j, rnti)) == false)
                 {
                   free = false;
                   break;
@@ -2078,14 +1987,14 @@ CqaFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sche
             }
           if (free)
             {
-        	  NS_LOG_INFO (this << "RNTI: "<< (*it).first<< " RB Allocated " << rbAllocated << " rbPerFlow " << rbPerFlow << " flows " << nflows);
+        	  NS_LOG_INFO (this << "RNTI: "<< rnti<< " RB Allocated " << rbAllocated << " rbPerFlow " << rbPerFlow << " flows " << nflows);
               uldci.m_rbStart = rbAllocated;
 
               for (uint16_t j = rbAllocated; j < rbAllocated + rbPerFlow; j++)
                 {
                   rbMap.at (j) = true;
                   // store info on allocation for managing ul-cqi interpretation
-                  rbgAllocationMap.at (j) = (*it).first;
+                  rbgAllocationMap.at (j) = rnti;
                 }
               rbAllocated += rbPerFlow;
               allocated = true;
@@ -2107,7 +2016,7 @@ CqaFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sche
       if (!allocated)
         {
           // unable to allocate new resource: finish scheduling
-//          m_nextRntiUl = (*it).first;
+//          m_nextRntiUl = rnti;
 //          if (ret.m_dciList.size () > 0)
 //            {
 //              m_schedSapUser->SchedUlConfigInd (ret);
@@ -2119,7 +2028,7 @@ CqaFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sche
 
 
 
-      std::map <uint16_t, std::vector <double> >::iterator itCqi = m_ueCqi.find ((*it).first);
+      std::map <uint16_t, std::vector <double> >::iterator itCqi = m_ueCqi.find (rnti);
       int cqi = 0;
       if (itCqi == m_ueCqi.end ())
         {
@@ -2132,14 +2041,14 @@ CqaFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sche
           double minSinr = (*itCqi).second.at (uldci.m_rbStart);
           if (minSinr == NO_SINR)
             {
-              minSinr = EstimateUlSinr ((*it).first, uldci.m_rbStart);
+              minSinr = EstimateUlSinr (rnti, uldci.m_rbStart);
             }
           for (uint16_t i = uldci.m_rbStart; i < uldci.m_rbStart + uldci.m_rbLen; i++)
             {
               double sinr = (*itCqi).second.at (i);
               if (sinr == NO_SINR)
                 {
-                  sinr = EstimateUlSinr ((*it).first, i);
+                  sinr = EstimateUlSinr (rnti, i);
                 }
               if ((*itCqi).second.at (i) < minSinr)
                 {
@@ -2154,11 +2063,11 @@ CqaFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sche
           cqi = m_amc->GetCqiFromSpectralEfficiency (s);
           if (cqi == 0)
             {
-              it++;
-              if (it == m_ceBsrRxed.end ())
+              pos++;
+              if (pos == m_ulUes.size ())
                 {
                   // restart from the first
-                  it = m_ceBsrRxed.begin ();
+                  pos = 0;
                 }
               NS_LOG_DEBUG (this << " UE discared for CQI=0, RNTI " << uldci.m_rnti);
               // remove UE from allocation map
@@ -2190,35 +2099,18 @@ CqaFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sche
       uint8_t harqId = 0;
       if (m_harqOn == true)
         {
-          std::map <uint16_t, uint8_t>::iterator itProcId;
-          itProcId = m_ulHarqCurrentProcessId.find (uldci.m_rnti);
-          if (itProcId == m_ulHarqCurrentProcessId.end ())
-            {
-              NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << uldci.m_rnti);
-            }
-          harqId = (*itProcId).second;
-          std::map <uint16_t, UlHarqProcessesDciBuffer_t>::iterator itDci = m_ulHarqProcessesDciBuffer.find (uldci.m_rnti);
-          if (itDci == m_ulHarqProcessesDciBuffer.end ())
-            {
-              NS_FATAL_ERROR ("Unable to find RNTI entry in UL DCI HARQ buffer for RNTI " << uldci.m_rnti);
-            }
-          (*itDci).second.at (harqId) = uldci;
+          harqId = m_ulHarqCurrentProcessId[slot];
+          m_ulHarqProcessesDciBuffer[slot].at (harqId) = uldci;
           // Update HARQ process status (RV 0)
-          std::map <uint16_t, UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (uldci.m_rnti);
-          if (itStat == m_ulHarqProcessesStatus.end ())
-            {
-              NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << uldci.m_rnti);
-            }
-          (*itStat).second.at (harqId) = 0;
+          m_ulHarqProcessesStatus[slot * HARQ_PROC_NUM + harqId] = 0;
         }
 
-      NS_LOG_INFO (this << " UE Allocation RNTI " << (*it).first << " startPRB " << (uint32_t)uldci.m_rbStart << " nPRB " << (uint32_t)uldci.m_rbLen << " CQI " << cqi << " MCS " << (uint32_t)uldci.m_mcs << " TBsize " << uldci.m_tbSize << " RbAlloc " << rbAllocated << " harqId " << (uint16_t)harqId);
+      NS_LOG_INFO (this << " UE Allocation RNTI " << rnti << " startPRB " << (uint32_t)uldci.m_rbStart << " nPRB " << (uint32_t)uldci.m_rbLen << " CQI " << cqi << " MCS " << (uint32_t)uldci.m_mcs << " TBsize " << uldci.m_tbSize << " RbAlloc " << rbAllocated << " harqId " << (uint16_t)harqId);
 
       // update TTI  UE stats
-      itStats = m_flowStatsUl.find ((*it).first);
-      if (itStats != m_flowStatsUl.end ())
+      if (m_flowStatsUl.Has (slot))
         {
-          (*itStats).second.lastTtiBytesTransmitted =  uldci.m_tbSize;
+          m_flowStatsUl.Get (slot).lastTtiBytesTransmitted =  uldci.m_tbSize;
         }
       else
         {
@@ -2226,32 +2118,38 @@ CqaFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sche
         }
 
 
-      it++;
-      if (it == m_ceBsrRxed.end ())
+      pos++;
+      if (pos == m_ulUes.size ())
         {
           // restart from the first
-          it = m_ceBsrRxed.begin ();
+          pos = 0;
         }
       if ((rbAllocated == m_cschedCellConfig.m_ulBandwidth) || (rbPerFlow == 0))
         {
           // Stop allocation: no more PRBs
-          m_nextRntiUl = (*it).first;
+          m_nextRntiUl = m_ues.GetRnti (m_ulUes[pos]);
           break;
         }
     }
-  while (((*it).first != m_nextRntiUl)&&(rbPerFlow!=0));
+  while ((m_ues.GetRnti (m_ulUes[pos]) != m_nextRntiUl)&&(rbPerFlow!=0));
 
 
   // Update global UE stats
   // update UEs stats
-  for (itStats = m_flowStatsUl.begin (); itStats != m_flowStatsUl.end (); itStats++)
+  for (uint32_t u = 0; u < m_ues.GetNUes (); u++)
     {
-      (*itStats).second.totalBytesTransmitted += (*itStats).second.lastTtiBytesTransmitted;
+      uint32_t slot = m_ues.GetUeSlot (u);
+      if (!m_flowStatsUl.Has (slot))
+        {
+          continue;
+        }
+      CqasFlowPerf_t& stats = m_flowStatsUl.Get (slot);
+      stats.totalBytesTransmitted += stats.lastTtiBytesTransmitted;
       // update average throughput (see eq. 12.3 of Sec 12.3.1.2 of LTE – The UMTS Long Term Evolution, Ed Wiley)
-      (*itStats).second.lastAveragedThroughput = ((1.0 - (1.0 / m_timeWindow)) * (*itStats).second.lastAveragedThroughput) + ((1.0 / m_timeWindow) * (double)((*itStats).second.lastTtiBytesTransmitted / 0.001));
-      NS_LOG_INFO (this << " UE total bytes " << (*itStats).second.totalBytesTransmitted);
-      NS_LOG_INFO (this << " UE average throughput " << (*itStats).second.lastAveragedThroughput);
-      (*itStats).second.lastTtiBytesTransmitted = 0;
+      stats.lastAveragedThroughput = ((1.0 - (1.0 / m_timeWindow)) * stats.lastAveragedThroughput) + ((1.0 / m_timeWindow) * (double)(stats.lastTtiBytesTransmitted / 0.001));
+      NS_LOG_INFO (this << " UE total bytes " << stats.totalBytesTransmitted);
+      NS_LOG_INFO (this << " UE average throughput " << stats.lastAveragedThroughput);
+      stats.lastTtiBytesTransmitted = 0;
     }
   m_allocationMaps.insert (std::pair <uint16_t, std::vector <uint16_t> > (params.m_sfnSf, rbgAllocationMap));
   m_schedSapUser->SchedUlConfigInd (ret);
@@ -2278,8 +2176,6 @@ CqaFfMacScheduler::DoSchedUlMacCtrlInfoReq (const struct FfMacSchedSapProvider::
 {
   NS_LOG_FUNCTION (this);
 
-  std::map <uint16_t,uint32_t>::iterator it;
-
   for (unsigned int i = 0; i < params.m_macCeList.size (); i++)
     {
       if ( params.m_macCeList.at (i).m_macCeType == MacCeListElement_s::BSR )
@@ -2300,17 +2196,13 @@ CqaFfMacScheduler::DoSchedUlMacCtrlInfoReq (const struct FfMacSchedSapProvider::
 
           uint16_t rnti = params.m_macCeList.at (i).m_rnti;
           NS_LOG_LOGIC (this << "RNTI=" << rnti << " buffer=" << buffer);
-          it = m_ceBsrRxed.find (rnti);
-          if (it == m_ceBsrRxed.end ())
+          uint32_t slot = m_ues.GetSlot (rnti);
+          if (slot == FfMacSchedulerUeTable::NO_SLOT)
             {
-              // create the new entry
-              m_ceBsrRxed.insert ( std::pair<uint16_t, uint32_t > (rnti, buffer));
-            }
-          else
-            {
-              // update the buffer size value
-              (*it).second = buffer;
+              NS_LOG_ERROR (this << " BSR of unknown RNTI " << rnti);
+              continue;
             }
+          m_ceBsrRxed.Set (slot, buffer);
         }
     }
 
@@ -2469,49 +2361,37 @@ CqaFfMacScheduler::DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::Sche
 void
 CqaFfMacScheduler::RefreshDlCqiMaps (void)
 {
-  // refresh DL CQI P01 Map
-  std::map <uint16_t,uint32_t>::iterator itP10 = m_p10CqiTimers.begin ();
-  while (itP10 != m_p10CqiTimers.end ())
+  for (uint32_t u = 0; u < m_ues.GetNUes (); u++)
     {
-      NS_LOG_INFO (this << " P10-CQI for user " << (*itP10).first << " is " << (uint32_t)(*itP10).second << " thr " << (uint32_t)m_cqiTimersThreshold);
-      if ((*itP10).second == 0)
-        {
-          // delete correspondent entries
-          std::map <uint16_t,uint8_t>::iterator itMap = m_p10CqiRxed.find ((*itP10).first);
-          NS_ASSERT_MSG (itMap != m_p10CqiRxed.end (), " Does not find CQI report for user " << (*itP10).first);
-          NS_LOG_INFO (this << " P10-CQI expired for user " << (*itP10).first);
-          m_p10CqiRxed.erase (itMap);
-          std::map <uint16_t,uint32_t>::iterator temp = itP10;
-          itP10++;
-          m_p10CqiTimers.erase (temp);
-        }
-      else
+      uint32_t slot = m_ues.GetUeSlot (u);
+      // refresh DL CQI P01
+      if (m_p10CqiRxed.Has (slot))
         {
-          (*itP10).second--;
-          itP10++;
+          NS_LOG_INFO (this << " P10-CQI for user " << m_ues.GetRnti (slot) << " is " << m_p10CqiTimers[slot] << " thr " << (uint32_t)m_cqiTimersThreshold);
+          if (m_p10CqiTimers[slot] == 0)
+            {
+              NS_LOG_INFO (this << " P10-CQI expired for user " << m_ues.GetRnti (slot));
+              m_p10CqiRxed.Reset (slot);
+            }
+          else
+            {
+              m_p10CqiTimers[slot]--;
+            }
         }
-    }
 
-  // refresh DL CQI A30 Map
-  std::map <uint16_t,uint32_t>::iterator itA30 = m_a30CqiTimers.begin ();
-  while (itA30 != m_a30CqiTimers.end ())
-    {
-      NS_LOG_INFO (this << " A30-CQI for user " << (*itA30).first << " is " << (uint32_t)(*itA30).second << " thr " << (uint32_t)m_cqiTimersThreshold);
-      if ((*itA30).second == 0)
+      // refresh DL CQI A30
+      if (m_a30CqiRxed.Has (slot))
         {
-          // delete correspondent entries
-          std::map <uint16_t,SbMeasResult_s>::iterator itMap = m_a30CqiRxed.find ((*itA30).first);
-          NS_ASSERT_MSG (itMap != m_a30CqiRxed.end (), " Does not find CQI report for user " << (*itA30).first);
-          NS_LOG_INFO (this << " A30-CQI expired for user " << (*itA30).first);
-          m_a30CqiRxed.erase (itMap);
-          std::map <uint16_t,uint32_t>::iterator temp = itA30;
-          itA30++;
-          m_a30CqiTimers.erase (temp);
-        }
-      else
-        {
-          (*itA30).second--;
-          itA30++;
+          NS_LOG_INFO (this << " A30-CQI for user " << m_ues.GetRnti (slot) << " is " << m_a30CqiTimers[slot] << " thr " << (uint32_t)m_cqiTimersThreshold);
+          if (m_a30CqiTimers[slot] == 0)
+            {
+              NS_LOG_INFO (this << " A30-CQI expired for user " << m_ues.GetRnti (slot));
+              m_a30CqiRxed.Reset (slot);
+            }
+          else
+            {
+              m_a30CqiTimers[slot]--;
+            }
         }
     }
 
@@ -2606,17 +2486,18 @@ CqaFfMacScheduler::UpdateUlRlcBufferInfo (uint16_t rnti, uint16_t size)
 {
 
   size = size - 2; // remove the minimum RLC overhead
-  std::map <uint16_t,uint32_t>::iterator it = m_ceBsrRxed.find (rnti);
-  if (it != m_ceBsrRxed.end ())
+  uint32_t slot = m_ues.GetSlot (rnti);
+  if (m_ceBsrRxed.Has (slot))
     {
-      NS_LOG_INFO (this << " UE " << rnti << " size " << size << " BSR " << (*it).second);
-      if ((*it).second >= size)
+      uint32_t& bsr = m_ceBsrRxed.Get (slot);
+      NS_LOG_INFO (this << " UE " << rnti << " size " << size << " BSR " << bsr);
+      if (bsr >= size)
         {
-          (*it).second -= size;
+          bsr -= size;
         }
       else
         {
-          (*it).second = 0;
+          bsr = 0;
         }
     }
   else
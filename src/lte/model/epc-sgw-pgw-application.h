@@ -36,6 +36,7 @@
 #include <ns3/application.h>
 #include <ns3/epc-s1ap-sap.h>
 #include <ns3/epc-s11-sap.h>
+#include <ns3/open-hash-map.h>
 #include <map>
 
 namespace ns3 {
@@ -238,14 +239,30 @@ public:
   Ptr<VirtualNetDevice> m_tunDevice;
 
   /**
-   * Map telling for each UE address the corresponding UE info 
+   * Hash of an IMSI
    */
-  std::map<Ipv4Address, Ptr<UeInfo> > m_ueInfoByAddrMap;
+  struct ImsiHash
+  {
+    /**
+     * \param imsi the IMSI
+     * \return the hash of the IMSI
+     */
+    uint64_t operator() (uint64_t imsi) const
+    {
+      return imsi;
+    }
+  };
+
+  /**
+   * Map telling for each UE address the corresponding UE info,
+   * looked up for every downlink packet
+   */
+  OpenHashMap<Ipv4Address, Ptr<UeInfo>, Ipv4AddressHash> m_ueInfoByAddrMap;
 
   /**
    * Map telling for each IMSI the corresponding UE info 
    */
-  std::map<uint64_t, Ptr<UeInfo> > m_ueInfoByImsiMap;
+  OpenHashMap<uint64_t, Ptr<UeInfo>, ImsiHash> m_ueInfoByImsiMap;
 
   /**
    * UDP port to be used for GTP
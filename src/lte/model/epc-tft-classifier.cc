@@ -30,17 +30,17 @@
 #include "epc-tft.h"
 #include "ns3/log.h"
 #include "ns3/packet.h"
-#include "ns3/ipv4-header.h"
-#include "ns3/udp-header.h"
-#include "ns3/tcp-header.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/tcp-l4-protocol.h"
 
+#include <algorithm>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EpcTftClassifier");
 
 EpcTftClassifier::EpcTftClassifier ()
+  : m_isCompiled (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -51,6 +51,7 @@ EpcTftClassifier::Add (Ptr<EpcTft> tft, uint32_t id)
   NS_LOG_FUNCTION (this << tft);
   
   m_tftMap[id] = tft;  
+  m_isCompiled = false;
   
   // simple sanity check: there shouldn't be more than 16 bearers (hence TFTs) per UE
   NS_ASSERT (m_tftMap.size () <= 16);
@@ -61,6 +62,87 @@ EpcTftClassifier::Delete (uint32_t id)
 {
   NS_LOG_FUNCTION (this << id);
   m_tftMap.erase (id);
+  m_isCompiled = false;
+}
+
+bool
+EpcTftClassifier::CompareRangeFilterIds (const RangeFilter &range, const RangeFilter &other)
+{
+  return range.id > other.id;
+}
+
+void
+EpcTftClassifier::Compile ()
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t d = 0; d < 2; d++)
+    {
+      Compiled &compiled = m_compiled[d];
+      EpcTft::Direction direction = (d == 0) ? EpcTft::DOWNLINK : EpcTft::UPLINK;
+      compiled.tuples.clear ();
+      compiled.ids.clear ();
+      compiled.ranges.clear ();
+      for (std::map <uint32_t, Ptr<EpcTft> >::const_iterator it = m_tftMap.begin (); it != m_tftMap.end (); ++it)
+        {
+          std::list<EpcTft::PacketFilter> filters = it->second->GetPacketFilters ();
+          for (std::list<EpcTft::PacketFilter>::const_iterator f = filters.begin (); f != filters.end (); ++f)
+            {
+              if (!(f->direction & direction))
+                {
+                  continue;
+                }
+              bool remotePortAny = (f->remotePortStart == 0 && f->remotePortEnd == 0xffff);
+              bool localPortAny = (f->localPortStart == 0 && f->localPortEnd == 0xffff);
+              if ((!remotePortAny && f->remotePortStart != f->remotePortEnd)
+                  || (!localPortAny && f->localPortStart != f->localPortEnd))
+                {
+                  RangeFilter range;
+                  range.filter = *f;
+                  range.id = it->first;
+                  compiled.ranges.push_back (range);
+                  continue;
+                }
+
+              Tuple tuple;
+              tuple.remoteMask = f->remoteMask.Get ();
+              tuple.localMask = f->localMask.Get ();
+              tuple.remotePortExact = !remotePortAny;
+              tuple.localPortExact = !localPortAny;
+              tuple.tosMask = f->typeOfServiceMask;
+              uint32_t t;
+              for (t = 0; t < compiled.tuples.size (); t++)
+                {
+                  const Tuple &other = compiled.tuples[t];
+                  if (other.remoteMask == tuple.remoteMask && other.localMask == tuple.localMask
+                      && other.remotePortExact == tuple.remotePortExact
+                      && other.localPortExact == tuple.localPortExact
+                      && other.tosMask == tuple.tosMask)
+                    {
+                      break;
+                    }
+                }
+              if (t == compiled.tuples.size ())
+                {
+                  compiled.tuples.push_back (tuple);
+                }
+
+              Key key;
+              key.remoteAddress = f->remoteAddress.Get () & tuple.remoteMask;
+              key.localAddress = f->localAddress.Get () & tuple.localMask;
+              key.remotePort = tuple.remotePortExact ? f->remotePortStart : 0;
+              key.localPort = tuple.localPortExact ? f->localPortStart : 0;
+              key.tos = f->typeOfService & tuple.tosMask;
+              key.tuple = t;
+              uint32_t &id = compiled.ids[key];
+              id = std::max (id, it->first);
+            }
+        }
+      std::stable_sort (compiled.ranges.begin (), compiled.ranges.end (), CompareRangeFilterIds);
+      NS_LOG_LOGIC ("direction " << direction << ": " << compiled.tuples.size () << " tuples, "
+                                 << compiled.ids.size () << " keys, "
+                                 << compiled.ranges.size () << " port ranges");
+    }
+  m_isCompiled = true;
 }
 
  
@@ -69,71 +151,47 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
 {
   NS_LOG_FUNCTION (this << p << direction);
 
-  Ptr<Packet> pCopy = p->Copy ();
+  // the IPv4 header, with its options, and the ports of the UDP or TCP
+  // header are read in place, without copying the packet
+  uint8_t buffer[64];
+  uint32_t size = p->CopyData (buffer, sizeof (buffer));
+  NS_ASSERT_MSG (size >= 20, "packet too small for an IPv4 header");
+  uint32_t ihl = (buffer[0] & 0x0f) * 4;
 
-  Ipv4Header ipv4Header;
-  pCopy->RemoveHeader (ipv4Header);
+  uint8_t tos = buffer[1];
+  uint8_t protocol = buffer[9];
+  Ipv4Address source ((buffer[12] << 24) | (buffer[13] << 16) | (buffer[14] << 8) | buffer[15]);
+  Ipv4Address destination ((buffer[16] << 24) | (buffer[17] << 16) | (buffer[18] << 8) | buffer[19]);
 
-  Ipv4Address localAddress;
-  Ipv4Address remoteAddress;
+  if (protocol != UdpL4Protocol::PROT_NUMBER && protocol != TcpL4Protocol::PROT_NUMBER)
+    {
+      NS_LOG_INFO ("Unknown protocol: " << protocol);
+      return 0;  // no match
+    }
+  NS_ASSERT_MSG (size >= ihl + 4, "packet too small for the ports of its L4 header");
+  uint16_t sourcePort = (buffer[ihl] << 8) | buffer[ihl + 1];
+  uint16_t destinationPort = (buffer[ihl + 2] << 8) | buffer[ihl + 3];
 
-  
   if (direction ==  EpcTft::UPLINK)
     {
-      localAddress = ipv4Header.GetSource ();
-      remoteAddress = ipv4Header.GetDestination ();
+      return Classify (direction, destination, source, destinationPort, sourcePort, tos);
     }
   else
     { 
       NS_ASSERT (direction ==  EpcTft::DOWNLINK);
-      remoteAddress = ipv4Header.GetSource ();
-      localAddress = ipv4Header.GetDestination ();      
-    }
-  
-  uint8_t protocol = ipv4Header.GetProtocol ();
-
-  uint8_t tos = ipv4Header.GetTos ();
-
-  uint16_t localPort = 0;
-  uint16_t remotePort = 0;
-
-  if (protocol == UdpL4Protocol::PROT_NUMBER)
-    {
-      UdpHeader udpHeader;
-      pCopy->RemoveHeader (udpHeader);
-
-      if (direction ==  EpcTft::UPLINK)
-	{
-	  localPort = udpHeader.GetSourcePort ();
-	  remotePort = udpHeader.GetDestinationPort ();
-	}
-      else
-	{
-	  remotePort = udpHeader.GetSourcePort ();
-	  localPort = udpHeader.GetDestinationPort ();
-	}
-    }
-  else if (protocol == TcpL4Protocol::PROT_NUMBER)
-    {
-      TcpHeader tcpHeader;
-      pCopy->RemoveHeader (tcpHeader);
-      if (direction ==  EpcTft::UPLINK)
-	{
-	  localPort = tcpHeader.GetSourcePort ();
-	  remotePort = tcpHeader.GetDestinationPort ();
-	}
-      else
-	{
-	  remotePort = tcpHeader.GetSourcePort ();
-	  localPort = tcpHeader.GetDestinationPort ();
-	}
-    }
-  else
-    {
-      NS_LOG_INFO ("Unknown protocol: " << protocol);
-      return 0;  // no match
+      return Classify (direction, source, destination, sourcePort, destinationPort, tos);
     }
+}
 
+uint32_t
+EpcTftClassifier::Classify (EpcTft::Direction direction,
+                            Ipv4Address remoteAddress,
+                            Ipv4Address localAddress,
+                            uint16_t remotePort,
+                            uint16_t localPort,
+                            uint8_t tos)
+{
+  NS_LOG_FUNCTION (this << direction << remoteAddress << localAddress << remotePort << localPort << (uint16_t) tos);
   NS_LOG_INFO ("Classifing packet:"
 	       << " localAddr="  << localAddress 
 	       << " remoteAddr=" << remoteAddress 
@@ -141,25 +199,49 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
 	       << " remotePort=" << remotePort 
 	       << " tos=0x" << (uint16_t) tos );
 
-  // now it is possible to classify the packet!
-  // we use a reverse iterator since filter priority is not implemented properly.
-  // This way, since the default bearer is expected to be added first, it will be evaluated last.
-  std::map <uint32_t, Ptr<EpcTft> >::const_reverse_iterator it;
-  NS_LOG_LOGIC ("TFT MAP size: " << m_tftMap.size ());
-
-  for (it = m_tftMap.rbegin (); it != m_tftMap.rend (); ++it)
+  if (!m_isCompiled)
+    {
+      Compile ();
+    }
+  Compiled &compiled = m_compiled[direction == EpcTft::UPLINK ? 1 : 0];
+
+  // filter priority is not implemented properly: as when evaluating the
+  // TFTs by decreasing identifier, the matching TFT with the highest
+  // identifier is returned, so that the default bearer, which is
+  // expected to be added first, is the last resort.
+  uint32_t best = 0;
+  if (!compiled.ids.empty ())
+    {
+      uint32_t ra = remoteAddress.Get ();
+      uint32_t la = localAddress.Get ();
+      for (uint32_t t = 0; t < compiled.tuples.size (); t++)
+        {
+          const Tuple &tuple = compiled.tuples[t];
+          Key key;
+          key.remoteAddress = ra & tuple.remoteMask;
+          key.localAddress = la & tuple.localMask;
+          key.remotePort = tuple.remotePortExact ? remotePort : 0;
+          key.localPort = tuple.localPortExact ? localPort : 0;
+          key.tos = tos & tuple.tosMask;
+          key.tuple = t;
+          OpenHashMap<Key, uint32_t, KeyHash>::const_iterator it = compiled.ids.find (key);
+          if (it != compiled.ids.end () && it->second > best)
+            {
+              best = it->second;
+            }
+        }
+    }
+  for (std::vector<RangeFilter>::iterator it = compiled.ranges.begin ();
+       it != compiled.ranges.end () && it->id > best; ++it)
     {
-      NS_LOG_LOGIC ("TFT id: " << it->first );
-      NS_LOG_LOGIC (" Ptr<EpcTft>: " << it->second);
-      Ptr<EpcTft> tft = it->second;         
-      if (tft->Matches (direction, remoteAddress, localAddress, remotePort, localPort, tos))
+      if (it->filter.Matches (direction, remoteAddress, localAddress, remotePort, localPort, tos))
         {
-	  NS_LOG_LOGIC ("matches with TFT ID = " << it->first);
-	  return it->first; // the id of the matching TFT
+          best = it->id;
+          break;
         }
     }
-  NS_LOG_LOGIC ("no match");
-  return 0;  // no match
+  NS_LOG_LOGIC ("matches with TFT ID = " << best);
+  return best;
 }
 
 
@@ -26,8 +26,10 @@
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
 #include "ns3/epc-tft.h"
+#include "ns3/open-hash-map.h"
 
 #include <map>
+#include <vector>
 
 
 namespace ns3 {
@@ -38,6 +40,14 @@ class Packet;
 /**
  * \brief classifies IP packets accoding to Traffic Flow Templates (TFTs)
  * 
+ * The packet filters of the TFTs are compiled, on the first
+ * classification after a TFT is added or deleted, into a hash table per
+ * direction: the filters matching exact ports (or any port) are grouped
+ * by their masks into tuples, and a packet is looked up once per tuple,
+ * with its fields masked as those of the tuple. The few filters matching
+ * port ranges are kept aside, and tested in turn only when they may
+ * yield a better TFT than the tuples.
+ *
  * \note this implementation works with IPv4 only.
  */
 class EpcTftClassifier : public SimpleRefCount<EpcTftClassifier>
@@ -49,8 +59,9 @@ public:
   /** 
    * add a TFT to the Classifier
    * 
-   * \param tft the TFT to be added
-   * 
+   * \param tft the TFT to be added, whose PacketFilters must not change
+   * once added
+   * \param id the identifier of the TFT
    */
   void Add (Ptr<EpcTft> tft, uint32_t id);
 
@@ -70,10 +81,121 @@ public:
    * \return the identifier (>0) of the first TFT that matches with the IP packet; 0 if no TFT matched.
    */
   uint32_t Classify (Ptr<Packet> p, EpcTft::Direction direction);
+
+  /** 
+   * classify the fields of an IP packet
+   * 
+   * \param direction the direction of the packet
+   * \param remoteAddress the address of the remote host
+   * \param localAddress the address of the UE
+   * \param remotePort the port of the remote host
+   * \param localPort the port of the UE
+   * \param tos the type of service
+   * 
+   * \return the identifier (>0) of the first TFT that matches with the fields; 0 if no TFT matched.
+   */
+  uint32_t Classify (EpcTft::Direction direction,
+                     Ipv4Address remoteAddress,
+                     Ipv4Address localAddress,
+                     uint16_t remotePort,
+                     uint16_t localPort,
+                     uint8_t tos);
   
 protected:
   
   std::map <uint32_t, Ptr<EpcTft> > m_tftMap;
+
+private:
+
+  /**
+   * compile the PacketFilters of the TFTs
+   */
+  void Compile ();
+
+  /**
+   * the masks shared by the PacketFilters of a tuple
+   */
+  struct Tuple
+  {
+    uint32_t remoteMask;    ///< the mask of the remote address
+    uint32_t localMask;     ///< the mask of the local address
+    bool remotePortExact;   ///< whether the remote port is matched, or any
+    bool localPortExact;    ///< whether the local port is matched, or any
+    uint8_t tosMask;        ///< the mask of the type of service
+  };
+
+  /**
+   * the masked fields of a packet, in a tuple
+   */
+  struct Key
+  {
+    uint32_t remoteAddress; ///< the masked remote address
+    uint32_t localAddress;  ///< the masked local address
+    uint16_t remotePort;    ///< the remote port, or 0
+    uint16_t localPort;     ///< the local port, or 0
+    uint8_t tos;            ///< the masked type of service
+    uint8_t tuple;          ///< the index of the tuple
+
+    /**
+     * \param o the other key
+     * \return true if the keys are equal
+     */
+    bool operator== (const Key &o) const
+    {
+      return remoteAddress == o.remoteAddress && localAddress == o.localAddress
+             && remotePort == o.remotePort && localPort == o.localPort
+             && tos == o.tos && tuple == o.tuple;
+    }
+  };
+
+  /**
+   * hash of a Key
+   */
+  struct KeyHash
+  {
+    /**
+     * \param key the key
+     * \return the hash of the key
+     */
+    uint64_t operator() (const Key &key) const
+    {
+      uint64_t h = (static_cast<uint64_t> (key.remoteAddress) << 32) | key.localAddress;
+      uint64_t l = (static_cast<uint64_t> (key.remotePort) << 32) | (static_cast<uint64_t> (key.localPort) << 16)
+        | (static_cast<uint64_t> (key.tos) << 8) | key.tuple;
+      return h ^ (l * 0xff51afd7ed558ccdULL);
+    }
+  };
+
+  /**
+   * a PacketFilter matching a range of ports
+   */
+  struct RangeFilter
+  {
+    EpcTft::PacketFilter filter; ///< the filter
+    uint32_t id;                 ///< the identifier of its TFT
+  };
+
+  /**
+   * \param range a RangeFilter
+   * \param other another RangeFilter
+   * \return true if the TFT of range has a higher identifier than that of other
+   */
+  static bool CompareRangeFilterIds (const RangeFilter &range, const RangeFilter &other);
+
+  /**
+   * the compiled PacketFilters of a direction
+   */
+  struct Compiled
+  {
+    std::vector<Tuple> tuples;  ///< the tuples
+    /// the highest identifier of the TFTs with a filter matching each key
+    OpenHashMap<Key, uint32_t, KeyHash> ids;
+    /// the filters matching a range of ports, by decreasing TFT identifier
+    std::vector<RangeFilter> ranges;
+  };
+
+  Compiled m_compiled[2];  ///< the compiled filters, for DOWNLINK and UPLINK
+  bool m_isCompiled;       ///< whether m_compiled is up to date
   
 };
 
@@ -150,6 +150,11 @@ public:
 		  uint16_t localPort,
 		  uint8_t typeOfService);
 
+  /**
+   * \return the PacketFilters of the TFT, by increasing precedence
+   */
+  std::list<PacketFilter> GetPacketFilters () const;
+
 
 private:
 
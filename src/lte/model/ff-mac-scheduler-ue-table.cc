@@ -0,0 +1,99 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ff-mac-scheduler-ue-table.h"
+
+#include <ns3/log.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FfMacSchedulerUeTable");
+
+const uint32_t FfMacSchedulerUeTable::NO_SLOT;
+
+FfMacSchedulerUeTable::FfMacSchedulerUeTable ()
+{
+}
+
+uint32_t
+FfMacSchedulerUeTable::AddUe (uint16_t rnti)
+{
+  NS_LOG_FUNCTION (this << rnti);
+  NS_ASSERT_MSG (rnti != 0, "RNTI 0 is not a UE");
+  NS_ASSERT_MSG (GetSlot (rnti) == NO_SLOT, "UE " << rnti << " already in the table");
+
+  uint32_t slot;
+  if (m_freeSlots.empty ())
+    {
+      slot = m_slotRnti.size ();
+      m_slotRnti.push_back (rnti);
+    }
+  else
+    {
+      slot = m_freeSlots.back ();
+      m_freeSlots.pop_back ();
+      m_slotRnti[slot] = rnti;
+    }
+  if (rnti >= m_rntiSlot.size ())
+    {
+      m_rntiSlot.resize (rnti + 1, NO_SLOT);
+    }
+  m_rntiSlot[rnti] = slot;
+
+  // keep the UEs sorted by RNTI; UEs are mostly added with increasing RNTIs
+  std::vector<uint32_t>::iterator it = m_ueSlots.end ();
+  while (it != m_ueSlots.begin () && m_slotRnti[*(it - 1)] > rnti)
+    {
+      --it;
+    }
+  m_ueSlots.insert (it, slot);
+  return slot;
+}
+
+uint32_t
+FfMacSchedulerUeTable::RemoveUe (uint16_t rnti)
+{
+  NS_LOG_FUNCTION (this << rnti);
+  uint32_t slot = GetSlot (rnti);
+  if (slot == NO_SLOT)
+    {
+      return NO_SLOT;
+    }
+  m_rntiSlot[rnti] = NO_SLOT;
+  m_slotRnti[slot] = 0;
+  m_freeSlots.push_back (slot);
+  for (std::vector<uint32_t>::iterator it = m_ueSlots.begin (); it != m_ueSlots.end (); ++it)
+    {
+      if (*it == slot)
+        {
+          m_ueSlots.erase (it);
+          break;
+        }
+    }
+  return slot;
+}
+
+void
+FfMacSchedulerUeTable::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_rntiSlot.clear ();
+  m_slotRnti.clear ();
+  m_freeSlots.clear ();
+  m_ueSlots.clear ();
+}
+
+} // namespace ns3
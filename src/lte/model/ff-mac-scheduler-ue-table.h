@@ -0,0 +1,208 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FF_MAC_SCHEDULER_UE_TABLE_H
+#define FF_MAC_SCHEDULER_UE_TABLE_H
+
+#include <ns3/assert.h>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup ff-api
+ * \brief Dense table of the UEs of a scheduler
+ *
+ * Maps the RNTI of each UE known to a scheduler to a slot, that is, to
+ * a small index into arrays. The scheduler keeps the per-UE state in one
+ * array per field, indexed by slot and at least GetNSlots () long,
+ * instead of in one map per field keyed by RNTI: looking up a UE is then
+ * an array access, and the state of consecutive UEs is contiguous.
+ *
+ * The slot of a removed UE is reused by the next UE added. The UEs are
+ * iterated in increasing RNTI order, as in a map keyed by RNTI, so that
+ * the decisions of a scheduler do not depend on which slots its UEs got.
+ */
+class FfMacSchedulerUeTable
+{
+public:
+  /// the slot of a RNTI which is not in the table
+  static const uint32_t NO_SLOT = 0xffffffff;
+
+  FfMacSchedulerUeTable ();
+
+  /**
+   * \brief Add a UE
+   *
+   * \param rnti the RNTI of the UE, which must not be in the table
+   * \return the slot of the UE
+   */
+  uint32_t AddUe (uint16_t rnti);
+
+  /**
+   * \brief Remove a UE
+   *
+   * \param rnti the RNTI of the UE
+   * \return the slot the UE had, or NO_SLOT if it was not in the table
+   */
+  uint32_t RemoveUe (uint16_t rnti);
+
+  /**
+   * \brief Remove all the UEs
+   */
+  void Clear (void);
+
+  /**
+   * \param rnti the RNTI of a UE
+   * \return the slot of the UE, or NO_SLOT if it is not in the table
+   */
+  uint32_t GetSlot (uint16_t rnti) const
+  {
+    return rnti < m_rntiSlot.size () ? m_rntiSlot[rnti] : NO_SLOT;
+  }
+
+  /**
+   * \param slot a slot in use
+   * \return the RNTI of the UE of the slot
+   */
+  uint16_t GetRnti (uint32_t slot) const
+  {
+    NS_ASSERT (slot < m_slotRnti.size () && m_slotRnti[slot] != 0);
+    return m_slotRnti[slot];
+  }
+
+  /**
+   * \return the number of slots, in use or free: the length the arrays
+   * of per-UE state must have
+   */
+  uint32_t GetNSlots (void) const
+  {
+    return m_slotRnti.size ();
+  }
+
+  /**
+   * \return the number of UEs in the table
+   */
+  uint32_t GetNUes (void) const
+  {
+    return m_ueSlots.size ();
+  }
+
+  /**
+   * \param i the rank of a UE in increasing RNTI order, less than GetNUes ()
+   * \return the slot of the UE
+   */
+  uint32_t GetUeSlot (uint32_t i) const
+  {
+    return m_ueSlots[i];
+  }
+
+private:
+  std::vector<uint32_t> m_rntiSlot;  ///< the slot of each RNTI, NO_SLOT if none
+  std::vector<uint16_t> m_slotRnti;  ///< the RNTI of each slot, 0 if free
+  std::vector<uint32_t> m_freeSlots; ///< the free slots
+  std::vector<uint32_t> m_ueSlots;   ///< the slots in use, in increasing RNTI order
+};
+
+/**
+ * \ingroup ff-api
+ * \brief A field of the per-UE state of a scheduler which a UE may lack
+ *
+ * An array of values indexed by the slots of a FfMacSchedulerUeTable,
+ * with a flag telling whether each slot holds a value; it replaces a map
+ * keyed by RNTI whose entries come and go, such as the last CQI reported
+ * by each UE. The storage of a value is kept when it is reset, and reused
+ * when the slot gets a value again.
+ */
+template <typename T>
+class FfMacSchedulerUeColumn
+{
+public:
+  /**
+   * \param slot a slot
+   * \return whether the slot holds a value
+   */
+  bool Has (uint32_t slot) const
+  {
+    return slot < m_has.size () && m_has[slot];
+  }
+
+  /**
+   * \param slot a slot holding a value
+   * \return the value of the slot
+   */
+  T& Get (uint32_t slot)
+  {
+    NS_ASSERT (Has (slot));
+    return m_values[slot];
+  }
+
+  /**
+   * \param slot a slot holding a value
+   * \return the value of the slot
+   */
+  const T& Get (uint32_t slot) const
+  {
+    NS_ASSERT (Has (slot));
+    return m_values[slot];
+  }
+
+  /**
+   * \brief Set the value of a slot
+   * \param slot the slot
+   * \param value the value
+   */
+  void Set (uint32_t slot, const T& value)
+  {
+    if (slot >= m_has.size ())
+      {
+        m_has.resize (slot + 1, false);
+        m_values.resize (slot + 1);
+      }
+    m_has[slot] = true;
+    m_values[slot] = value;
+  }
+
+  /**
+   * \brief Remove the value of a slot, if any
+   * \param slot the slot
+   */
+  void Reset (uint32_t slot)
+  {
+    if (slot < m_has.size ())
+      {
+        m_has[slot] = false;
+      }
+  }
+
+  /**
+   * \brief Remove all the values
+   */
+  void Clear (void)
+  {
+    m_has.clear ();
+    m_values.clear ();
+  }
+
+private:
+  std::vector<T> m_values; ///< the value of each slot
+  std::vector<bool> m_has; ///< whether each slot holds a value
+};
+
+} // namespace ns3
+
+#endif /* FF_MAC_SCHEDULER_UE_TABLE_H */
@@ -0,0 +1,504 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/simulator.h>
+#include <ns3/log.h>
+#include <ns3/net-device.h>
+#include <ns3/node.h>
+#include <ns3/double.h>
+#include <ns3/mobility-model.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/propagation-delay-model.h>
+#include <ns3/antenna-model.h>
+#include <ns3/angles.h>
+
+#include "lte-abstract-spectrum-channel.h"
+#include "lte-spectrum-phy.h"
+#include "lte-spectrum-signal-parameters.h"
+#include "lte-spectrum-value-helper.h"
+
+#include <cmath>
+#include <algorithm>
+
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteAbstractSpectrumChannel");
+
+NS_OBJECT_ENSURE_REGISTERED (LteAbstractSpectrumChannel);
+
+LteAbstractSpectrumChannel::LteAbstractSpectrumChannel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LteAbstractSpectrumChannel::~LteAbstractSpectrumChannel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LteAbstractSpectrumChannel::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  m_deliverEvent.Cancel ();
+  m_pendingTxs.clear ();
+  m_rxs.clear ();
+  m_txs.clear ();
+  m_txIndex.clear ();
+  m_rxIndex.clear ();
+  m_converters.clear ();
+  m_dataInterference.psd = 0;
+  m_ctrlInterference.psd = 0;
+  m_propagationLoss = 0;
+  m_spectrumPropagationLoss = 0;
+  SpectrumChannel::DoDispose ();
+}
+
+TypeId
+LteAbstractSpectrumChannel::GetTypeId (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  static TypeId tid = TypeId ("ns3::LteAbstractSpectrumChannel")
+    .SetParent<SpectrumChannel> ()
+    .SetGroupName ("Lte")
+    .AddConstructor<LteAbstractSpectrumChannel> ()
+    .AddAttribute ("MaxLossDb",
+                   "If a single-frequency PropagationLossModel is used, "
+                   "this value represents the maximum loss in dB for which "
+                   "transmissions will be passed to the receiving PHY. "
+                   "Signals for which the PropagationLossModel returns "
+                   "a loss bigger than this value will not be propagated "
+                   "to the receiver. Note that the default value "
+                   "corresponds to considering all signals for reception.",
+                   DoubleValue (1.0e9),
+                   MakeDoubleAccessor (&LteAbstractSpectrumChannel::m_maxLossDb),
+                   MakeDoubleChecker<double> ())
+    .AddTraceSource ("PathLoss",
+                     "This trace is fired whenever a new path loss value "
+                     "is calculated, i.e., the first time a PHY transmits "
+                     "to another one and whenever one of them has moved since. "
+                     "The first and second parameters "
+                     "to the trace are pointers respectively to the TX and "
+                     "RX SpectrumPhy instances, whereas the third parameters "
+                     "is the loss value in dB. Note that the loss value "
+                     "reported by this trace is the single-frequency loss "
+                     "value obtained by evaluating only the TX and RX "
+                     "AntennaModels and the PropagationLossModel.",
+                     MakeTraceSourceAccessor (&LteAbstractSpectrumChannel::m_pathLossTrace),
+                     "ns3::SpectrumChannel::LossTracedCallback")
+  ;
+  return tid;
+}
+
+
+void
+LteAbstractSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  Ptr<const SpectrumModel> model = phy->GetRxSpectrumModel ();
+  NS_ASSERT_MSG ((0 != model), "phy->GetRxSpectrumModel () returned 0. Please check that the RxSpectrumModel is already set for the phy before calling LteAbstractSpectrumChannel::AddRx (phy)");
+
+  // a PHY changing its SpectrumModel is added again
+  std::map<Ptr<SpectrumPhy>, uint32_t>::const_iterator it = m_rxIndex.find (phy);
+  if (it != m_rxIndex.end ())
+    {
+      m_rxs[it->second].model = model;
+      return;
+    }
+  RxInfo rx;
+  rx.phy = phy;
+  rx.ltePhy = DynamicCast<LteSpectrumPhy> (phy);
+  rx.model = model;
+  rx.version = 1;
+  m_rxIndex[phy] = m_rxs.size ();
+  m_rxs.push_back (rx);
+}
+
+
+void
+LteAbstractSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
+{
+  NS_LOG_FUNCTION (this << txParams->psd << txParams->duration << txParams->txPhy);
+  NS_ASSERT_MSG (txParams->psd, "NULL txPsd");
+  NS_ASSERT_MSG (txParams->txPhy, "NULL txPhy");
+
+  PendingTx tx;
+  tx.params = txParams;
+  std::map<Ptr<SpectrumPhy>, uint32_t>::const_iterator it = m_txIndex.find (txParams->txPhy);
+  if (it == m_txIndex.end ())
+    {
+      tx.txIndex = m_txs.size ();
+      m_txIndex[txParams->txPhy] = tx.txIndex;
+      m_txs.push_back (TxInfo ());
+      m_txs.back ().version = 1;
+    }
+  else
+    {
+      tx.txIndex = it->second;
+    }
+  tx.type = OTHER_SIGNAL;
+  tx.cellId = 0;
+  tx.pss = false;
+  Ptr<LteSpectrumSignalParametersDataFrame> data = DynamicCast<LteSpectrumSignalParametersDataFrame> (txParams);
+  Ptr<LteSpectrumSignalParametersDlCtrlFrame> dlCtrl = DynamicCast<LteSpectrumSignalParametersDlCtrlFrame> (txParams);
+  Ptr<LteSpectrumSignalParametersUlSrsFrame> ulSrs = DynamicCast<LteSpectrumSignalParametersUlSrsFrame> (txParams);
+  if (data != 0)
+    {
+      tx.type = DATA_FRAME;
+      tx.cellId = data->cellId;
+    }
+  else if (dlCtrl != 0)
+    {
+      tx.type = DL_CTRL_FRAME;
+      tx.cellId = dlCtrl->cellId;
+      tx.pss = dlCtrl->pss;
+    }
+  else if (ulSrs != 0)
+    {
+      tx.type = UL_SRS_FRAME;
+      tx.cellId = ulSrs->cellId;
+    }
+  LteSpectrumValueHelper::GetOccupiedRbs (*txParams->psd, tx.first, tx.end);
+  m_pendingTxs.push_back (tx);
+
+  // the signals of the other PHYs transmitting now are delivered together
+  if (!m_deliverEvent.IsRunning ())
+    {
+      m_deliverEvent = Simulator::ScheduleNow (&LteAbstractSpectrumChannel::DeliverPendingTxs, this);
+    }
+}
+
+
+void
+LteAbstractSpectrumChannel::UpdatePosition (Ptr<MobilityModel> mobility, Vector &position, uint32_t &version)
+{
+  if (mobility)
+    {
+      Vector current = mobility->GetPosition ();
+      if (current.x != position.x || current.y != position.y || current.z != position.z)
+        {
+          position = current;
+          ++version;
+        }
+    }
+}
+
+
+const LteAbstractSpectrumChannel::CouplingLoss &
+LteAbstractSpectrumChannel::GetCouplingLoss (const PendingTx &tx, uint32_t rxIndex,
+                                             Ptr<MobilityModel> txMobility, Ptr<MobilityModel> rxMobility)
+{
+  TxInfo &txInfo = m_txs[tx.txIndex];
+  if (txInfo.losses.size () <= rxIndex)
+    {
+      CouplingLoss none;
+      none.txVersion = 0;
+      none.rxVersion = 0;
+      none.lossDb = 0;
+      none.gain = 1;
+      txInfo.losses.resize (m_rxs.size (), none);
+    }
+  CouplingLoss &loss = txInfo.losses[rxIndex];
+  const RxInfo &rx = m_rxs[rxIndex];
+  if (loss.txVersion == txInfo.version && loss.rxVersion == rx.version)
+    {
+      return loss;
+    }
+
+  // same as SingleModelSpectrumChannel, for the current positions
+  double pathLossDb = 0;
+  if (tx.params->txAntenna != 0)
+    {
+      Angles txAngles (rxMobility->GetPosition (), txMobility->GetPosition ());
+      double txAntennaGain = tx.params->txAntenna->GetGainDb (txAngles);
+      NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
+      pathLossDb -= txAntennaGain;
+    }
+  Ptr<AntennaModel> rxAntenna = rx.phy->GetRxAntenna ();
+  if (rxAntenna != 0)
+    {
+      Angles rxAngles (txMobility->GetPosition (), rxMobility->GetPosition ());
+      double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
+      NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
+      pathLossDb -= rxAntennaGain;
+    }
+  if (m_propagationLoss)
+    {
+      double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, rxMobility);
+      NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
+      pathLossDb -= propagationGainDb;
+    }
+  NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");
+  m_pathLossTrace (tx.params->txPhy, rx.phy, pathLossDb);
+
+  loss.txVersion = txInfo.version;
+  loss.rxVersion = rx.version;
+  loss.lossDb = pathLossDb;
+  loss.gain = std::pow (10.0, (-pathLossDb) / 10.0);
+  return loss;
+}
+
+
+void
+LteAbstractSpectrumChannel::DeliverPendingTxs ()
+{
+  NS_LOG_FUNCTION (this << m_pendingTxs.size ());
+  std::vector<PendingTx> txs;
+  txs.swap (m_pendingTxs);
+
+  for (std::vector<PendingTx>::const_iterator tx = txs.begin (); tx != txs.end (); ++tx)
+    {
+      TxInfo &txInfo = m_txs[tx->txIndex];
+      UpdatePosition (tx->params->txPhy->GetMobility (), txInfo.position, txInfo.version);
+    }
+
+  for (uint32_t rxIndex = 0; rxIndex < m_rxs.size (); ++rxIndex)
+    {
+      RxInfo &rx = m_rxs[rxIndex];
+      Ptr<MobilityModel> rxMobility = rx.phy->GetMobility ();
+      UpdatePosition (rxMobility, rx.position, rx.version);
+      uint16_t rxCellId = rx.ltePhy ? rx.ltePhy->GetCellId () : 0;
+      SpectrumModelUid_t rxModelUid = rx.model->GetUid ();
+      if (rx.ltePhy && (m_dataInterference.psd == 0 || m_dataInterference.psd->GetSpectrumModelUid () != rxModelUid))
+        {
+          m_dataInterference.psd = Create<SpectrumValue> (rx.model);
+          m_dataInterference.first = m_dataInterference.end = 0;
+          m_ctrlInterference.psd = Create<SpectrumValue> (rx.model);
+          m_ctrlInterference.first = m_ctrlInterference.end = 0;
+        }
+
+      for (std::vector<PendingTx>::const_iterator tx = txs.begin (); tx != txs.end (); ++tx)
+        {
+          if (rx.phy == tx->params->txPhy)
+            {
+              continue;
+            }
+          Ptr<MobilityModel> txMobility = tx->params->txPhy->GetMobility ();
+          double gain = 1;
+          if (txMobility && rxMobility)
+            {
+              const CouplingLoss &loss = GetCouplingLoss (*tx, rxIndex, txMobility, rxMobility);
+              if (loss.lossDb > m_maxLossDb)
+                {
+                  // beyond range
+                  continue;
+                }
+              gain = loss.gain;
+            }
+
+          if (rx.ltePhy && tx->type != OTHER_SIGNAL && tx->cellId != rxCellId
+              && tx->params->psd->GetSpectrumModelUid () == rxModelUid)
+            {
+              // not in sync with this signal: only interference
+              Ptr<SpectrumValue> rxPsd;
+              if (m_spectrumPropagationLoss && txMobility && rxMobility)
+                {
+                  Ptr<SpectrumValue> psd = tx->params->psd->Copy ();
+                  *psd *= gain;
+                  rxPsd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (psd, txMobility, rxMobility);
+                }
+              bool ctrl = (tx->type != DATA_FRAME);
+              Interference &interference = ctrl ? m_ctrlInterference : m_dataInterference;
+              if (rxPsd)
+                {
+                  AddInterference (interference, rxPsd, 1, tx->first, tx->end, tx->params->duration, rx.ltePhy, ctrl);
+                }
+              else
+                {
+                  // scaled while being added up
+                  AddInterference (interference, tx->params->psd, gain, tx->first, tx->end, tx->params->duration, rx.ltePhy, ctrl);
+                }
+              if (tx->type == DL_CTRL_FRAME && tx->pss)
+                {
+                  if (!rxPsd)
+                    {
+                      rxPsd = tx->params->psd->Copy ();
+                      *rxPsd *= gain;
+                    }
+                  rx.ltePhy->ReceivePss (tx->cellId, rxPsd);
+                }
+              continue;
+            }
+
+          // a signal to be received: delivered as by the other channels
+          NS_LOG_LOGIC ("copying signal parameters " << tx->params);
+          Ptr<SpectrumSignalParameters> rxParams = tx->params->Copy ();
+          if (tx->params->psd->GetSpectrumModelUid () != rxModelUid)
+            {
+              rxParams->psd = Convert (tx->params->psd, rx.model);
+            }
+          if (txMobility && rxMobility)
+            {
+              *(rxParams->psd) *= gain;
+              if (m_spectrumPropagationLoss)
+                {
+                  rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, rxMobility);
+                }
+            }
+          Ptr<NetDevice> netDev = rx.phy->GetDevice ();
+          if (netDev)
+            {
+              // the receiver has a NetDevice, so we expect that it is attached to a Node
+              uint32_t dstNode =  netDev->GetNode ()->GetId ();
+              Simulator::ScheduleWithContext (dstNode, Seconds (0), &LteAbstractSpectrumChannel::StartRx, this,
+                                              rxParams, rx.phy);
+            }
+          else
+            {
+              // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
+              Simulator::ScheduleNow (&LteAbstractSpectrumChannel::StartRx, this,
+                                      rxParams, rx.phy);
+            }
+        }
+
+      if (rx.ltePhy)
+        {
+          FlushInterference (m_dataInterference, rx.ltePhy, false);
+          FlushInterference (m_ctrlInterference, rx.ltePhy, true);
+        }
+    }
+}
+
+
+Ptr<SpectrumValue>
+LteAbstractSpectrumChannel::Convert (Ptr<const SpectrumValue> psd, Ptr<const SpectrumModel> rxModel)
+{
+  std::pair<SpectrumModelUid_t, SpectrumModelUid_t> key (psd->GetSpectrumModelUid (), rxModel->GetUid ());
+  ConverterMap::iterator it = m_converters.find (key);
+  if (it == m_converters.end ())
+    {
+      NS_LOG_LOGIC ("Creating converters between SpectrumModelUids " << key.first << " and " << key.second);
+      it = m_converters.insert (std::make_pair (key, SpectrumConverter (psd->GetSpectrumModel (), rxModel))).first;
+    }
+  return it->second.Convert (psd);
+}
+
+
+void
+LteAbstractSpectrumChannel::AddInterference (Interference &interference, Ptr<const SpectrumValue> psd, double gain,
+                                             uint32_t first, uint32_t end, Time duration,
+                                             Ptr<LteSpectrumPhy> rx, bool ctrl)
+{
+  if (interference.first != interference.end && interference.duration != duration)
+    {
+      FlushInterference (interference, rx, ctrl);
+    }
+  if (interference.first == interference.end)
+    {
+      interference.first = first;
+      interference.end = end;
+      interference.duration = duration;
+    }
+  else
+    {
+      interference.first = std::min (interference.first, first);
+      interference.end = std::max (interference.end, end);
+    }
+  Values::iterator sum = interference.psd->ValuesBegin ();
+  Values::const_iterator signal = psd->ConstValuesBegin ();
+  for (uint32_t i = first; i < end; ++i)
+    {
+      sum[i] += signal[i] * gain;
+    }
+}
+
+
+void
+LteAbstractSpectrumChannel::FlushInterference (Interference &interference, Ptr<LteSpectrumPhy> rx, bool ctrl)
+{
+  if (interference.first == interference.end)
+    {
+      return;
+    }
+  rx->AddInterference (interference.psd, interference.duration, ctrl);
+  Values::iterator sum = interference.psd->ValuesBegin ();
+  for (uint32_t i = interference.first; i < interference.end; ++i)
+    {
+      sum[i] = 0;
+    }
+  interference.first = interference.end = 0;
+}
+
+
+void
+LteAbstractSpectrumChannel::StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver)
+{
+  NS_LOG_FUNCTION (this << params);
+  receiver->StartRx (params);
+}
+
+
+uint32_t
+LteAbstractSpectrumChannel::GetNDevices (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_rxs.size ();
+}
+
+
+Ptr<NetDevice>
+LteAbstractSpectrumChannel::GetDevice (uint32_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  return m_rxs.at (i).phy->GetDevice ()->GetObject<NetDevice> ();
+}
+
+
+void
+LteAbstractSpectrumChannel::AddPropagationLossModel (Ptr<PropagationLossModel> loss)
+{
+  NS_LOG_FUNCTION (this << loss);
+  NS_ASSERT (m_propagationLoss == 0);
+  m_propagationLoss = loss;
+}
+
+
+void
+LteAbstractSpectrumChannel::AddSpectrumPropagationLossModel (Ptr<SpectrumPropagationLossModel> loss)
+{
+  NS_LOG_FUNCTION (this << loss);
+  NS_ASSERT (m_spectrumPropagationLoss == 0);
+  m_spectrumPropagationLoss = loss;
+}
+
+
+void
+LteAbstractSpectrumChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel> delay)
+{
+  NS_LOG_FUNCTION (this << delay);
+  NS_LOG_WARN ("the propagation delay is neglected by LteAbstractSpectrumChannel");
+}
+
+
+Ptr<PropagationLossModel>
+LteAbstractSpectrumChannel::GetPropagationLossModel (void)
+{
+  NS_LOG_FUNCTION (this);
+  return m_propagationLoss;
+}
+
+Ptr<SpectrumPropagationLossModel>
+LteAbstractSpectrumChannel::GetSpectrumPropagationLossModel (void)
+{
+  NS_LOG_FUNCTION (this);
+  return m_spectrumPropagationLoss;
+}
+
+
+} // namespace ns3
@@ -0,0 +1,257 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_ABSTRACT_SPECTRUM_CHANNEL_H
+#define LTE_ABSTRACT_SPECTRUM_CHANNEL_H
+
+#include <ns3/spectrum-channel.h>
+#include <ns3/spectrum-model.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/spectrum-converter.h>
+#include <ns3/event-id.h>
+#include <ns3/vector.h>
+#include <ns3/traced-callback.h>
+
+#include <vector>
+#include <map>
+
+namespace ns3 {
+
+class LteSpectrumPhy;
+class MobilityModel;
+
+/**
+ * \ingroup lte
+ *
+ * SpectrumChannel for system-level simulations with many cells and
+ * UEs, to be set with LteHelper::SetSpectrumChannelType.
+ *
+ * The signals transmitted at the same time are delivered together, in
+ * a single pass over the receivers:
+ *  - the signals of the cell of a LteSpectrumPhy are delivered to it
+ *    one by one, as by the other channels, to be received;
+ *  - the signals of the other cells are summed up and added to the
+ *    interference of the LteSpectrumPhy at once, and the PSS of their
+ *    DL control frames is notified to it directly;
+ *  - any other signal, any signal of another SpectrumModel than the
+ *    one of the receiver (e.g., while a UE is synchronizing), and any
+ *    signal to another kind of SpectrumPhy is delivered one by one,
+ *    converted to the SpectrumModel of the receiver as by
+ *    MultiModelSpectrumChannel.
+ *
+ * The coupling loss of each pair of transmitter and receiver (antenna
+ * gains and PropagationLossModel) is kept in a matrix and computed
+ * again only when the position of one of them changes, rather than
+ * for every signal. The SINR perceived is thus the same as with the
+ * other channels, as long as the PropagationLossModel gives the same
+ * loss for the same positions; a SpectrumPropagationLossModel (e.g., a
+ * fading model) is still applied to every signal.
+ *
+ * The signals are summed up only when the transmitter and the receiver
+ * use the same SpectrumModel, i.e., the same EARFCN and bandwidth, and
+ * the propagation delay is neglected.
+ */
+class LteAbstractSpectrumChannel : public SpectrumChannel
+{
+public:
+  LteAbstractSpectrumChannel ();
+  virtual ~LteAbstractSpectrumChannel ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  // inherited from SpectrumChannel
+  virtual void AddPropagationLossModel (Ptr<PropagationLossModel> loss);
+  virtual void AddSpectrumPropagationLossModel (Ptr<SpectrumPropagationLossModel> loss);
+  virtual void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay);
+  virtual void AddRx (Ptr<SpectrumPhy> phy);
+  virtual void StartTx (Ptr<SpectrumSignalParameters> params);
+
+  /**
+   * Get the single-frequency propagation loss model.
+   * \returns a pointer to the propagation loss model.
+   */
+  virtual Ptr<PropagationLossModel> GetPropagationLossModel (void);
+
+  /**
+   * Get the frequency-dependent propagation loss model.
+   * \returns a pointer to the propagation loss model.
+   */
+  virtual Ptr<SpectrumPropagationLossModel> GetSpectrumPropagationLossModel (void);
+
+  // inherited from Channel
+  virtual uint32_t GetNDevices (void) const;
+  virtual Ptr<NetDevice> GetDevice (uint32_t i) const;
+
+private:
+  virtual void DoDispose ();
+
+  /// the kind of a signal
+  enum SignalType
+  {
+    DATA_FRAME,
+    DL_CTRL_FRAME,
+    UL_SRS_FRAME,
+    OTHER_SIGNAL
+  };
+
+  /// the coupling loss of a pair of transmitter and receiver
+  struct CouplingLoss
+  {
+    uint32_t txVersion;  ///< the version of the position of the transmitter, 0 if not computed
+    uint32_t rxVersion;  ///< the version of the position of the receiver
+    double lossDb;       ///< the loss
+    double gain;         ///< the linear gain
+  };
+
+  /// a transmitter, and its coupling losses to the receivers
+  struct TxInfo
+  {
+    Vector position;                  ///< the last position known
+    uint32_t version;                 ///< incremented when the position changes
+    std::vector<CouplingLoss> losses; ///< the coupling losses, by receiver
+  };
+
+  /// a receiver
+  struct RxInfo
+  {
+    Ptr<SpectrumPhy> phy;             ///< the PHY
+    Ptr<LteSpectrumPhy> ltePhy;       ///< the PHY, if it is a LteSpectrumPhy
+    Ptr<const SpectrumModel> model;   ///< the SpectrumModel of the PHY when it was added
+    Vector position;                  ///< the last position known
+    uint32_t version;                 ///< incremented when the position changes
+  };
+
+  /// a signal transmitted and not yet delivered
+  struct PendingTx
+  {
+    Ptr<SpectrumSignalParameters> params; ///< the signal
+    uint32_t txIndex;                     ///< the transmitter
+    SignalType type;                      ///< the kind of signal
+    uint16_t cellId;                      ///< the cell of a LTE signal
+    bool pss;                             ///< whether a DL control frame carries the PSS
+    uint32_t first;                       ///< the first RB occupied
+    uint32_t end;                         ///< one past the last RB occupied
+  };
+
+  /// the interference of the other cells being summed up for a receiver
+  struct Interference
+  {
+    Ptr<SpectrumValue> psd;           ///< the sum of the signals, 0 until the first receiver
+    Time duration;                    ///< the duration of the signals
+    uint32_t first;                   ///< the first RB of the sum
+    uint32_t end;                     ///< one past the last RB of the sum
+  };
+
+  /**
+   * Deliver the signals pending to all the receivers
+   */
+  void DeliverPendingTxs ();
+
+  /**
+   * Update the position of a mobility model, and its version if it changed
+   *
+   * \param mobility the mobility model, or 0
+   * \param position the last position known
+   * \param version the version of the position
+   */
+  static void UpdatePosition (Ptr<MobilityModel> mobility, Vector &position, uint32_t &version);
+
+  /**
+   * \param tx the signal
+   * \param rxIndex the receiver
+   * \param txMobility the mobility of the transmitter
+   * \param rxMobility the mobility of the receiver
+   * \return the coupling loss of the transmitter of the signal and the receiver
+   */
+  const CouplingLoss & GetCouplingLoss (const PendingTx &tx, uint32_t rxIndex,
+                                        Ptr<MobilityModel> txMobility, Ptr<MobilityModel> rxMobility);
+
+  /**
+   * \param psd a signal
+   * \param rxModel the SpectrumModel of the receiver
+   * \return the signal converted to the SpectrumModel of the receiver
+   */
+  Ptr<SpectrumValue> Convert (Ptr<const SpectrumValue> psd, Ptr<const SpectrumModel> rxModel);
+
+  /**
+   * Add a signal to the interference of a receiver, delivering the
+   * interference summed up so far first if its duration differs
+   *
+   * \param interference the interference
+   * \param psd the signal
+   * \param gain the gain of the signal to the receiver
+   * \param first the first RB of the signal
+   * \param end one past the last RB of the signal
+   * \param duration the duration of the signal
+   * \param rx the receiver
+   * \param ctrl whether the interference is to control frames
+   */
+  void AddInterference (Interference &interference, Ptr<const SpectrumValue> psd, double gain,
+                        uint32_t first, uint32_t end, Time duration,
+                        Ptr<LteSpectrumPhy> rx, bool ctrl);
+
+  /**
+   * Add the interference summed up to a receiver, and reset it
+   *
+   * \param interference the interference
+   * \param rx the receiver
+   * \param ctrl whether the interference is to control frames
+   */
+  void FlushInterference (Interference &interference, Ptr<LteSpectrumPhy> rx, bool ctrl);
+
+  /**
+   * Used internally to deliver a signal to a receiver in its context.
+   *
+   * \param params the signal
+   * \param receiver the receiver
+   */
+  void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
+
+  std::vector<RxInfo> m_rxs;                       ///< the receivers
+  std::vector<TxInfo> m_txs;                       ///< the transmitters
+  std::map<Ptr<SpectrumPhy>, uint32_t> m_txIndex;  ///< the index of the transmitters in m_txs
+  std::map<Ptr<SpectrumPhy>, uint32_t> m_rxIndex;  ///< the index of the receivers in m_rxs
+
+  /// the converters between SpectrumModels, by the Uids of the models
+  typedef std::map<std::pair<SpectrumModelUid_t, SpectrumModelUid_t>, SpectrumConverter> ConverterMap;
+  ConverterMap m_converters; ///< the converters used so far
+
+  std::vector<PendingTx> m_pendingTxs;  ///< the signals transmitted at the current time
+  EventId m_deliverEvent;               ///< the delivery of m_pendingTxs
+
+  Interference m_dataInterference;      ///< the interference to data frames of the receiver
+  Interference m_ctrlInterference;      ///< the interference to control frames of the receiver
+
+  Ptr<PropagationLossModel> m_propagationLoss;                 ///< single-frequency propagation loss
+  Ptr<SpectrumPropagationLossModel> m_spectrumPropagationLoss; ///< frequency-dependent propagation loss
+
+  double m_maxLossDb; ///< the loss beyond which the signals are not delivered
+
+  /**
+   * \deprecated The non-const \c Ptr<SpectrumPhy> argument
+   * is deprecated and will be changed to \c Ptr<const SpectrumPhy>
+   * in a future release.
+   */
+  TracedCallback<Ptr<SpectrumPhy>, Ptr<SpectrumPhy>, double > m_pathLossTrace;
+};
+
+} // namespace ns3
+
+#endif // LTE_ABSTRACT_SPECTRUM_CHANNEL_H
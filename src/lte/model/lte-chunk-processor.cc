@@ -50,7 +50,10 @@ void
 LteChunkProcessor::Start ()
 {
   NS_LOG_FUNCTION (this);
-  m_sumValues = 0;
+  if (m_sumValues != 0)
+    {
+      (*m_sumValues) = 0.0;
+    }
   m_totDuration = MicroSeconds (0);
 }
 
@@ -59,11 +62,18 @@ void
 LteChunkProcessor::EvaluateChunk (const SpectrumValue& sinr, Time duration)
 {
   NS_LOG_FUNCTION (this << sinr << duration);
-  if (m_sumValues == 0)
+  if (m_sumValues == 0 || m_sumValues->GetSpectrumModelUid () != sinr.GetSpectrumModelUid ())
     {
       m_sumValues = Create<SpectrumValue> (sinr.GetSpectrumModel ());
     }
-  (*m_sumValues) += sinr * duration.GetSeconds ();
+  Values::iterator sum = m_sumValues->ValuesBegin ();
+  Values::const_iterator value = sinr.ConstValuesBegin ();
+  Values::const_iterator end = sinr.ConstValuesEnd ();
+  double seconds = duration.GetSeconds ();
+  while (value != end)
+    {
+      *sum++ += *value++ * seconds;
+    }
   m_totDuration += duration;
 }
 
@@ -73,10 +83,12 @@ LteChunkProcessor::End ()
   NS_LOG_FUNCTION (this);
   if (m_totDuration.GetSeconds () > 0)
     {
+      // the sum is reset by the next Start (), so it is averaged in place
+      (*m_sumValues) /= m_totDuration.GetSeconds ();
       std::vector<LteChunkProcessorCallback>::iterator it;
       for (it = m_lteChunkProcessorCallbacks.begin (); it != m_lteChunkProcessorCallbacks.end (); it++)
         {
-          (*it)((*m_sumValues) / m_totDuration.GetSeconds ());
+          (*it)(*m_sumValues);
         }
     }
   else
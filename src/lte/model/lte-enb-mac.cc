@@ -31,6 +31,7 @@
 #include "lte-ue-net-device.h"
 
 #include <ns3/lte-enb-mac.h>
+#include <ns3/lte-scheduler-thread-pool.h>
 #include <ns3/lte-radio-bearer-tag.h>
 #include <ns3/lte-ue-phy.h>
 
@@ -346,6 +347,7 @@ LteEnbMac::GetTypeId (void)
 
 
 LteEnbMac::LteEnbMac ()
+  : m_deferSchedulerIndications (false)
 {
   NS_LOG_FUNCTION (this);
   m_macSapProvider = new EnbMacMemberLteMacSapProvider<LteEnbMac> (this);
@@ -376,6 +378,7 @@ LteEnbMac::DoDispose ()
   delete m_schedSapUser;
   delete m_cschedSapUser;
   delete m_enbPhySapUser;
+  m_schedulerThreadPool = 0;
 }
 
 
@@ -403,6 +406,13 @@ LteEnbMac::GetFfMacCschedSapUser (void)
   return m_cschedSapUser;
 }
 
+void
+LteEnbMac::SetSchedulerThreadPool (Ptr<LteSchedulerThreadPool> pool)
+{
+  NS_LOG_FUNCTION (this << pool);
+  m_schedulerThreadPool = pool;
+}
+
 
 
 void
@@ -454,11 +464,17 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
   m_subframeNo = subframeNo;
 
 
+  // the requests to the scheduler are prepared here, and made by
+  // DoDlSchedulerRequests and DoUlSchedulerRequests, possibly on another thread
+  SchedulerRequests &req = m_schedulerRequests;
+
   // --- DOWNLINK ---
   // Send Dl-CQI info to the scheduler
+  req.hasDlCqiInfo = false;
   if (m_dlCqiReceived.size () > 0)
     {
-      FfMacSchedSapProvider::SchedDlCqiInfoReqParameters dlcqiInfoReq;
+      FfMacSchedSapProvider::SchedDlCqiInfoReqParameters &dlcqiInfoReq = req.dlCqiInfo;
+      dlcqiInfoReq.m_cqiList.clear ();
       dlcqiInfoReq.m_sfnSf = ((0x3FF & frameNo) << 4) | (0xF & subframeNo);
 
       int cqiNum = m_dlCqiReceived.size ();
@@ -468,13 +484,15 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
         }
       dlcqiInfoReq.m_cqiList.insert (dlcqiInfoReq.m_cqiList.begin (), m_dlCqiReceived.begin (), m_dlCqiReceived.end ());
       m_dlCqiReceived.erase (m_dlCqiReceived.begin (), m_dlCqiReceived.end ());
-      m_schedSapProvider->SchedDlCqiInfoReq (dlcqiInfoReq);
+      req.hasDlCqiInfo = true;
     }
 
+  req.hasDlRachInfo = false;
   if (!m_receivedRachPreambleCount.empty ())
     {
       // process received RACH preambles and notify the scheduler
-      FfMacSchedSapProvider::SchedDlRachInfoReqParameters rachInfoReqParams;
+      FfMacSchedSapProvider::SchedDlRachInfoReqParameters &rachInfoReqParams = req.dlRachInfo;
+      rachInfoReqParams.m_rachList.clear ();
       NS_ASSERT (subframeNo > 0 && subframeNo <= 10); // subframe in 1..10
       for (std::map<uint8_t, uint32_t>::const_iterator it = m_receivedRachPreambleCount.begin ();
            it != m_receivedRachPreambleCount.end ();
@@ -511,7 +529,7 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
               m_rapIdRntiMap.insert (std::pair <uint16_t, uint32_t> (rnti, it->first));
             }
         }
-      m_schedSapProvider->SchedDlRachInfoReq (rachInfoReqParams);
+      req.hasDlRachInfo = true;
       m_receivedRachPreambleCount.clear ();
     }
   // Get downlink transmission opportunities
@@ -527,7 +545,8 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
     {
       dlSchedSubframeNo = dlSchedSubframeNo + m_macChTtiDelay;
     }
-  FfMacSchedSapProvider::SchedDlTriggerReqParameters dlparams;
+  FfMacSchedSapProvider::SchedDlTriggerReqParameters &dlparams = req.dlTrigger;
+  dlparams.m_dlInfoList.clear ();
   dlparams.m_sfnSf = ((0x3FF & dlSchedFrameNo) << 4) | (0xF & dlSchedSubframeNo);
 
   // Forward DL HARQ feebacks collected during last TTI
@@ -538,8 +557,6 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
       m_dlInfoListReceived.clear ();
     }
 
-  m_schedSapProvider->SchedDlTriggerReq (dlparams);
-
 
   // --- UPLINK ---
   // Send UL-CQI info to the scheduler
@@ -554,18 +571,20 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
         {
           m_ulCqiReceived.at (i).m_sfnSf = ((0x3FF & (frameNo - 1)) << 4) | (0xF & 10);
         }
-      m_schedSapProvider->SchedUlCqiInfoReq (m_ulCqiReceived.at (i));
     }
-    m_ulCqiReceived.clear ();
+  req.ulCqiInfo.swap (m_ulCqiReceived);
+  m_ulCqiReceived.clear ();
   
   // Send BSR reports to the scheduler
+  req.hasUlMacCtrlInfo = false;
   if (m_ulCeReceived.size () > 0)
     {
-      FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters ulMacReq;
+      FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters &ulMacReq = req.ulMacCtrlInfo;
+      ulMacReq.m_macCeList.clear ();
       ulMacReq.m_sfnSf = ((0x3FF & frameNo) << 4) | (0xF & subframeNo);
       ulMacReq.m_macCeList.insert (ulMacReq.m_macCeList.begin (), m_ulCeReceived.begin (), m_ulCeReceived.end ());
       m_ulCeReceived.erase (m_ulCeReceived.begin (), m_ulCeReceived.end ());
-      m_schedSapProvider->SchedUlMacCtrlInfoReq (ulMacReq);
+      req.hasUlMacCtrlInfo = true;
     }
 
 
@@ -582,7 +601,8 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
     {
       ulSchedSubframeNo = ulSchedSubframeNo + (m_macChTtiDelay + UL_PUSCH_TTIS_DELAY);
     }
-  FfMacSchedSapProvider::SchedUlTriggerReqParameters ulparams;
+  FfMacSchedSapProvider::SchedUlTriggerReqParameters &ulparams = req.ulTrigger;
+  ulparams.m_ulInfoList.clear ();
   ulparams.m_sfnSf = ((0x3FF & ulSchedFrameNo) << 4) | (0xF & ulSchedSubframeNo);
 
   // Forward DL HARQ feebacks collected during last TTI
@@ -593,8 +613,94 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
       m_ulInfoListReceived.clear ();
     }
 
-  m_schedSapProvider->SchedUlTriggerReq (ulparams);
+  if (m_schedulerThreadPool == 0)
+    {
+      DoDlSchedulerRequests ();
+      DoUlSchedulerRequests ();
+    }
+  else
+    {
+      // the UL job is submitted once the DL indications are delivered
+      m_schedulerThreadPool->Submit (MakeCallback (&LteEnbMac::DoDlSchedulerRequests, this),
+                                     MakeCallback (&LteEnbMac::DeliverDlSchedulerIndications, this));
+    }
+}
 
+void
+LteEnbMac::DoDlSchedulerRequests (void)
+{
+  NS_LOG_FUNCTION (this);
+  // with a pool, this may run on another thread, so that the indications
+  // of the scheduler are only stored until DeliverDlSchedulerIndications
+  m_deferSchedulerIndications = (m_schedulerThreadPool != 0);
+  SchedulerRequests &req = m_schedulerRequests;
+  if (req.hasDlCqiInfo)
+    {
+      m_schedSapProvider->SchedDlCqiInfoReq (req.dlCqiInfo);
+    }
+  if (req.hasDlRachInfo)
+    {
+      m_schedSapProvider->SchedDlRachInfoReq (req.dlRachInfo);
+    }
+  m_schedSapProvider->SchedDlTriggerReq (req.dlTrigger);
+  m_deferSchedulerIndications = false;
+}
+
+void
+LteEnbMac::DoUlSchedulerRequests (void)
+{
+  NS_LOG_FUNCTION (this);
+  // with a pool, this may run on another thread, so that the indications
+  // of the scheduler are only stored until DeliverUlSchedulerIndications
+  m_deferSchedulerIndications = (m_schedulerThreadPool != 0);
+  SchedulerRequests &req = m_schedulerRequests;
+  for (uint16_t i = 0; i < req.ulCqiInfo.size (); i++)
+    {
+      m_schedSapProvider->SchedUlCqiInfoReq (req.ulCqiInfo.at (i));
+    }
+  if (req.hasUlMacCtrlInfo)
+    {
+      m_schedSapProvider->SchedUlMacCtrlInfoReq (req.ulMacCtrlInfo);
+    }
+  m_schedSapProvider->SchedUlTriggerReq (req.ulTrigger);
+  m_deferSchedulerIndications = false;
+}
+
+void
+LteEnbMac::DeliverDlSchedulerIndications (void)
+{
+  NS_LOG_FUNCTION (this);
+  // in the order the scheduler gives them when it is invoked directly
+  for (uint32_t i = 0; i < m_deferredUeConfigUpdateInd.size (); i++)
+    {
+      DoCschedUeConfigUpdateInd (m_deferredUeConfigUpdateInd[i]);
+    }
+  m_deferredUeConfigUpdateInd.clear ();
+  for (uint32_t i = 0; i < m_deferredDlConfigInd.size (); i++)
+    {
+      DoSchedDlConfigInd (m_deferredDlConfigInd[i]);
+    }
+  m_deferredDlConfigInd.clear ();
+  // as when the scheduler is invoked directly, the UL requests are made
+  // after the DL indications, and the reports of the RLC they trigger
+  m_schedulerThreadPool->Submit (MakeCallback (&LteEnbMac::DoUlSchedulerRequests, this),
+                                 MakeCallback (&LteEnbMac::DeliverUlSchedulerIndications, this));
+}
+
+void
+LteEnbMac::DeliverUlSchedulerIndications (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_deferredUeConfigUpdateInd.size (); i++)
+    {
+      DoCschedUeConfigUpdateInd (m_deferredUeConfigUpdateInd[i]);
+    }
+  m_deferredUeConfigUpdateInd.clear ();
+  for (uint32_t i = 0; i < m_deferredUlConfigInd.size (); i++)
+    {
+      DoSchedUlConfigInd (m_deferredUlConfigInd[i]);
+    }
+  m_deferredUlConfigInd.clear ();
 }
 
 
@@ -969,6 +1075,11 @@ void
 LteEnbMac::DoSchedDlConfigInd (FfMacSchedSapUser::SchedDlConfigIndParameters ind)
 {
   NS_LOG_FUNCTION (this);
+  if (m_deferSchedulerIndications)
+    {
+      m_deferredDlConfigInd.push_back (ind);
+      return;
+    }
   // Create DL PHY PDU
   Ptr<PacketBurst> pb = CreateObject<PacketBurst> ();
   std::map <LteFlowId_t, LteMacSapUser* >::iterator it;
@@ -1096,6 +1207,11 @@ void
 LteEnbMac::DoSchedUlConfigInd (FfMacSchedSapUser::SchedUlConfigIndParameters ind)
 {
   NS_LOG_FUNCTION (this);
+  if (m_deferSchedulerIndications)
+    {
+      m_deferredUlConfigInd.push_back (ind);
+      return;
+    }
 
   for (unsigned int i = 0; i < ind.m_dciList.size (); i++)
     {
@@ -1160,6 +1276,11 @@ void
 LteEnbMac::DoCschedUeConfigUpdateInd (FfMacCschedSapUser::CschedUeConfigUpdateIndParameters params)
 {
   NS_LOG_FUNCTION (this);
+  if (m_deferSchedulerIndications)
+    {
+      m_deferredUeConfigUpdateInd.push_back (params);
+      return;
+    }
   // propagates to RRC
   LteEnbCmacSapUser::UeConfig ueConfigUpdate;
   ueConfigUpdate.m_rnti = params.m_rnti;
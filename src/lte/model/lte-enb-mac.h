@@ -38,6 +38,7 @@
 
 namespace ns3 {
 
+class LteSchedulerThreadPool;
 class DlCqiLteControlMessage;
 class UlCqiLteControlMessage;
 class PdcchMapLteControlMessage;
@@ -84,6 +85,15 @@ public:
    */
   FfMacCschedSapUser* GetFfMacCschedSapUser (void);
 
+  /**
+   * \brief Set the pool making the requests of the subframes to the scheduler
+   *
+   * With a pool, the requests of the eNBs of a TTI are made in parallel,
+   * see LteSchedulerThreadPool.
+   *
+   * \param pool the pool, or 0 to make the requests directly
+   */
+  void SetSchedulerThreadPool (Ptr<LteSchedulerThreadPool> pool);
 
 
   /**
@@ -201,6 +211,30 @@ private:
 
   // forwarded from LteEnbPhySapUser
   void DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo);
+
+  /**
+   * \brief Make the DL requests of the subframe to the scheduler
+   *
+   * With a pool, the indications of the scheduler are stored, to be
+   * delivered by DeliverDlSchedulerIndications.
+   */
+  void DoDlSchedulerRequests (void);
+  /**
+   * \brief Make the UL requests of the subframe to the scheduler
+   *
+   * With a pool, the indications of the scheduler are stored, to be
+   * delivered by DeliverUlSchedulerIndications.
+   */
+  void DoUlSchedulerRequests (void);
+  /**
+   * \brief Act upon the indications of the scheduler stored by
+   * DoDlSchedulerRequests, then submit the UL requests to the pool
+   */
+  void DeliverDlSchedulerIndications (void);
+  /**
+   * \brief Act upon the indications of the scheduler stored by DoUlSchedulerRequests
+   */
+  void DeliverUlSchedulerIndications (void);
   void DoReceiveRachPreamble (uint8_t prachId);
 
 public:
@@ -290,6 +324,31 @@ private:
   std::map<uint8_t, uint32_t> m_receivedRachPreambleCount;
 
   std::map<uint8_t, uint32_t> m_rapIdRntiMap;
+
+  /**
+   * The requests of a subframe to the scheduler
+   */
+  struct SchedulerRequests
+  {
+    bool hasDlCqiInfo; ///< whether there are DL CQIs
+    FfMacSchedSapProvider::SchedDlCqiInfoReqParameters dlCqiInfo; ///< the DL CQIs
+    bool hasDlRachInfo; ///< whether there are RACH preambles
+    FfMacSchedSapProvider::SchedDlRachInfoReqParameters dlRachInfo; ///< the RACH preambles
+    FfMacSchedSapProvider::SchedDlTriggerReqParameters dlTrigger; ///< the DL trigger
+    std::vector <FfMacSchedSapProvider::SchedUlCqiInfoReqParameters> ulCqiInfo; ///< the UL CQIs
+    bool hasUlMacCtrlInfo; ///< whether there are BSRs
+    FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters ulMacCtrlInfo; ///< the BSRs
+    FfMacSchedSapProvider::SchedUlTriggerReqParameters ulTrigger; ///< the UL trigger
+  };
+
+  SchedulerRequests m_schedulerRequests; ///< the requests of the current subframe
+
+  Ptr<LteSchedulerThreadPool> m_schedulerThreadPool; ///< the pool making the requests, if any
+
+  bool m_deferSchedulerIndications; ///< whether to store the indications of the scheduler
+  std::vector <FfMacCschedSapUser::CschedUeConfigUpdateIndParameters> m_deferredUeConfigUpdateInd; ///< the UE config updates stored
+  std::vector <FfMacSchedSapUser::SchedDlConfigIndParameters> m_deferredDlConfigInd; ///< the DL config indications stored
+  std::vector <FfMacSchedSapUser::SchedUlConfigIndParameters> m_deferredUlConfigInd; ///< the UL config indications stored
 };
 
 } // end namespace ns3
@@ -21,9 +21,11 @@
 
 #include "lte-interference.h"
 #include "lte-chunk-processor.h"
+#include "lte-spectrum-value-helper.h"
 
 #include <ns3/simulator.h>
 #include <ns3/log.h>
+#include <algorithm>
 
 
 namespace ns3 {
@@ -32,6 +34,8 @@ NS_LOG_COMPONENT_DEFINE ("LteInterference");
 
 LteInterference::LteInterference ()
   : m_receiving (false),
+    m_rxFirst (0),
+    m_rxEnd (0),
     m_lastSignalId (0),
     m_lastSignalIdBeforeReset (0)
 {
@@ -53,6 +57,9 @@ LteInterference::DoDispose ()
   m_rxSignal = 0;
   m_allSignals = 0;
   m_noise = 0;
+  m_interf = 0;
+  m_sinr = 0;
+  m_pendingSignals = 0;
   Object::DoDispose ();
 } 
 
@@ -75,7 +82,16 @@ LteInterference::StartRx (Ptr<const SpectrumValue> rxPsd)
   if (m_receiving == false)
     {
       NS_LOG_LOGIC ("first signal");
-      m_rxSignal = rxPsd->Copy ();
+      if (m_rxSignal == 0)
+        {
+          m_rxSignal = rxPsd->Copy ();
+        }
+      else
+        {
+          *m_rxSignal = *rxPsd;
+        }
+      LteSpectrumValueHelper::GetOccupiedRbs (*m_rxSignal, m_rxFirst, m_rxEnd);
+      *m_sinr = 0.0;
       m_lastChangeTime = Now ();
       m_receiving = true;
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
@@ -99,6 +115,13 @@ LteInterference::StartRx (Ptr<const SpectrumValue> rxPsd)
       // make sure they use orthogonal resource blocks
       NS_ASSERT (Sum ((*rxPsd) * (*m_rxSignal)) == 0.0);
       (*m_rxSignal) += (*rxPsd);
+      uint32_t first, end;
+      LteSpectrumValueHelper::GetOccupiedRbs (*rxPsd, first, end);
+      if (first < end)
+        {
+          m_rxFirst = m_rxFirst < m_rxEnd ? std::min (m_rxFirst, first) : first;
+          m_rxEnd = std::max (m_rxEnd, end);
+        }
     }
 }
 
@@ -135,7 +158,22 @@ void
 LteInterference::AddSignal (Ptr<const SpectrumValue> spd, const Time duration)
 {
   NS_LOG_FUNCTION (this << *spd << duration);
-  DoAddSignal (spd);
+  uint32_t first, end;
+  LteSpectrumValueHelper::GetOccupiedRbs (*spd, first, end);
+  DoAddSignal (spd, first, end);
+  // the signals of a TTI all end at the same time: rather than scheduling
+  // the subtraction of each of them, add them up and subtract the sum
+  if (m_pendingSignals != 0 && m_pendingSubtraction.IsRunning ()
+      && static_cast<int64_t> (m_pendingSubtraction.GetTs ()) == (Now () + duration).GetTimeStep ())
+    {
+      Values::iterator pending = m_pendingSignals->ValuesBegin ();
+      Values::const_iterator signal = spd->ConstValuesBegin ();
+      for (uint32_t i = first; i < end; ++i)
+        {
+          pending[i] += signal[i];
+        }
+      return;
+    }
   uint32_t signalId = ++m_lastSignalId;
   if (signalId == m_lastSignalIdBeforeReset)
     {
@@ -146,16 +184,23 @@ LteInterference::AddSignal (Ptr<const SpectrumValue> spd, const Time duration)
       // boundary further.
       m_lastSignalIdBeforeReset += 0x10000000;
     }
-  Simulator::Schedule (duration, &LteInterference::DoSubtractSignal, this, spd, signalId);
+  m_pendingSignals = spd->Copy ();
+  m_pendingSubtraction = Simulator::Schedule (duration, &LteInterference::DoSubtractSignal, this, m_pendingSignals, signalId);
 }
 
 
 void
-LteInterference::DoAddSignal  (Ptr<const SpectrumValue> spd)
+LteInterference::DoAddSignal  (Ptr<const SpectrumValue> spd, uint32_t first, uint32_t end)
 { 
   NS_LOG_FUNCTION (this << *spd);
   ConditionallyEvaluateChunk ();
-  (*m_allSignals) += (*spd);
+  // the signal is zero outside of its RBs
+  Values::iterator all = m_allSignals->ValuesBegin ();
+  Values::const_iterator signal = spd->ConstValuesBegin ();
+  for (uint32_t i = first; i < end; ++i)
+    {
+      all[i] += signal[i];
+    }
 }
 
 void
@@ -166,7 +211,14 @@ LteInterference::DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t signa
   int32_t deltaSignalId = signalId - m_lastSignalIdBeforeReset;
   if (deltaSignalId > 0)
     {   
-      (*m_allSignals) -= (*spd);
+      uint32_t first, end;
+      LteSpectrumValueHelper::GetOccupiedRbs (*spd, first, end);
+      Values::iterator all = m_allSignals->ValuesBegin ();
+      Values::const_iterator signal = spd->ConstValuesBegin ();
+      for (uint32_t i = first; i < end; ++i)
+        {
+          all[i] -= signal[i];
+        }
     }
   else
     {
@@ -188,17 +240,38 @@ LteInterference::ConditionallyEvaluateChunk ()
     {
       NS_LOG_LOGIC (this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
 
-      SpectrumValue interf =  (*m_allSignals) - (*m_rxSignal) + (*m_noise);
+      // the interference is needed over the whole bandwidth by the
+      // interference processors only, and the SINR is zero outside of
+      // the RBs of the signal being RX
+      uint32_t first = m_rxFirst;
+      uint32_t end = m_rxEnd;
+      if (!m_interfChunkProcessorList.empty ())
+        {
+          first = 0;
+          end = m_interf->GetSpectrumModel ()->GetNumBands ();
+        }
+      Values::iterator interf = m_interf->ValuesBegin ();
+      Values::iterator sinr = m_sinr->ValuesBegin ();
+      Values::const_iterator all = m_allSignals->ConstValuesBegin ();
+      Values::const_iterator signal = m_rxSignal->ConstValuesBegin ();
+      Values::const_iterator noise = m_noise->ConstValuesBegin ();
+      for (uint32_t i = first; i < end; ++i)
+        {
+          interf[i] = all[i] - signal[i] + noise[i];
+        }
+      for (uint32_t i = m_rxFirst; i < m_rxEnd; ++i)
+        {
+          sinr[i] = signal[i] / interf[i];
+        }
 
-      SpectrumValue sinr = (*m_rxSignal) / interf;
       Time duration = Now () - m_lastChangeTime;
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
         {
-          (*it)->EvaluateChunk (sinr, duration);
+          (*it)->EvaluateChunk (*m_sinr, duration);
         }
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
         {
-          (*it)->EvaluateChunk (interf, duration);
+          (*it)->EvaluateChunk (*m_interf, duration);
         }
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
         {
@@ -217,6 +290,10 @@ LteInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd
   // reset m_allSignals (will reset if already set previously)
   // this is needed since this method can potentially change the SpectrumModel
   m_allSignals = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_interf = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_sinr = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  // the signals added from now on are not summed with those pending
+  m_pendingSignals = 0;
   if (m_receiving == true)
     {
       // abort rx
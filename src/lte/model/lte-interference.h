@@ -25,6 +25,7 @@
 #include <ns3/object.h>
 #include <ns3/packet.h>
 #include <ns3/nstime.h>
+#include <ns3/event-id.h>
 #include <ns3/spectrum-value.h>
 
 #include <list>
@@ -116,7 +117,7 @@ public:
 
 private:
   void ConditionallyEvaluateChunk ();
-  void DoAddSignal  (Ptr<const SpectrumValue> spd);
+  void DoAddSignal  (Ptr<const SpectrumValue> spd, uint32_t first, uint32_t end);
   void DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t signalId);
 
 
@@ -135,12 +136,24 @@ private:
 
   Ptr<const SpectrumValue> m_noise;
 
+  uint32_t m_rxFirst; ///< the first RB of the signal being RX
+  uint32_t m_rxEnd;   ///< one past the last RB of the signal being RX
+
+  Ptr<SpectrumValue> m_interf; ///< the interference plus noise of the last chunk
+  Ptr<SpectrumValue> m_sinr;   ///< the SINR of the last chunk, zero outside of the signal being RX
+
   Time m_lastChangeTime;     /**< the time of the last change in
                                 m_TotalPower */
 
   uint32_t m_lastSignalId;
   uint32_t m_lastSignalIdBeforeReset;
 
+  Ptr<SpectrumValue> m_pendingSignals; /**< the sum of the last signals
+                                        * added, which end at the same
+                                        * time and are subtracted at once
+                                        */
+  EventId m_pendingSubtraction; ///< the subtraction of m_pendingSignals
+
   /** all the processor instances that need to be notified whenever
   a new interference chunk is calculated */
   std::list<Ptr<LteChunkProcessor> > m_rsPowerChunkProcessorList;
@@ -36,6 +36,7 @@
 #include <ns3/pointer.h>
 #include <stdint.h>
 #include <cmath>
+#include <algorithm>
 #include <stdint.h>
 #include "stdlib.h"
 #include <ns3/lte-mi-error-model.h>
@@ -323,90 +324,121 @@ static const double cEcrTable [9][38] = {
 };
 
 
+/**
+ * A SINR to MI map sampled on a uniform grid of linear SINR values
+ */
+struct MiMap
+{
+  const double *mi;   ///< the MI at each point of the grid
+  double sinrMin;     ///< the linear SINR of the first point
+  double sinrMax;     ///< the linear SINR of the last point
+  double scale;       ///< the number of points per unit of linear SINR
+  uint32_t last;      ///< the index of the last point
+};
+
+static const MiMap MiMapQpsk = {
+  MI_map_qpsk, MI_map_qpsk_axis[0], MI_map_qpsk_axis[MI_MAP_QPSK_SIZE - 1],
+  (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE - 1] - MI_map_qpsk_axis[0]),
+  MI_MAP_QPSK_SIZE - 1
+};
+
+static const MiMap MiMap16qam = {
+  MI_map_16qam, MI_map_16qam_axis[0], MI_map_16qam_axis[MI_MAP_16QAM_SIZE - 1],
+  (MI_MAP_16QAM_SIZE - 1) / (MI_map_16qam_axis[MI_MAP_16QAM_SIZE - 1] - MI_map_16qam_axis[0]),
+  MI_MAP_16QAM_SIZE - 1
+};
+
+static const MiMap MiMap64qam = {
+  MI_map_64qam, MI_map_64qam_axis[0], MI_map_64qam_axis[MI_MAP_64QAM_SIZE - 1],
+  (MI_MAP_64QAM_SIZE - 1) / (MI_map_64qam_axis[MI_MAP_64QAM_SIZE - 1] - MI_map_64qam_axis[0]),
+  MI_MAP_64QAM_SIZE - 1
+};
+
+/// number of SINR values gathered in a contiguous buffer before being mapped
+static const uint32_t MI_BATCH_SIZE = 64;
+
+/**
+ * \brief get the MI map of the modulation of an MCS
+ * \param mcs the MCS
+ * \return the MI map
+ */
+static const MiMap &
+GetMiMap (uint8_t mcs)
+{
+  if (mcs <= MI_QPSK_MAX_ID)
+    {
+      return MiMapQpsk;
+    }
+  else if (mcs <= MI_16QAM_MAX_ID)
+    {
+      return MiMap16qam;
+    }
+  return MiMap64qam;
+}
+
+/**
+ * \brief sum the MI of a batch of SINR values
+ *
+ * Since the points of the map are uniformly spaced, the position of a
+ * SINR in the grid is (sinr - sinrMin) * scale, and the SINR takes the MI
+ * of the first point above it; beyond the last point the MI is 1. The
+ * loop has no data dependent branch, so that the compiler can vectorize
+ * it.
+ *
+ * \param map the MI map
+ * \param sinr the linear SINR values
+ * \param n the number of SINR values
+ * \return the sum of the MI of the SINR values
+ */
+static double
+MiSum (const MiMap &map, const double *sinr, uint32_t n)
+{
+  double sum = 0.0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double x = (sinr[i] - map.sinrMin) * map.scale + 1;
+      x = std::min (std::max (x, 0.0), (double) map.last);
+      double mi = map.mi[(uint32_t) x];
+      sum += sinr[i] > map.sinrMax ? 1.0 : mi;
+    }
+  return sum;
+}
+
+
 double 
 LteMiErrorModel::Mib (const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs)
 {
   NS_LOG_FUNCTION (sinr << &map << (uint32_t) mcs);
-  
-  double MI;
+
+  const MiMap &miMap = GetMiMap (mcs);
+  Values::const_iterator sinrIt = sinr.ConstValuesBegin ();
+  double batch[MI_BATCH_SIZE];
   double MIsum = 0.0;
-  SpectrumValue sinrCopy = sinr;
-  
-  for (uint32_t i = 0; i < map.size (); i++)
+  uint32_t size = map.size ();
+
+  for (uint32_t i = 0; i < size; i += MI_BATCH_SIZE)
     {
-      double sinrLin = sinrCopy[map.at (i)];
-      if (mcs <= MI_QPSK_MAX_ID) // QPSK
+      uint32_t n = std::min (size - i, MI_BATCH_SIZE);
+      for (uint32_t j = 0; j < n; j++)
         {
-
-          if (sinrLin > MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1])
-            {
-              MI = 1;
-            }
-          else 
-            { 
-              // since the values in MI_map_qpsk_axis are uniformly spaced, we have
-              // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-              // the scaling coefficient is always the same, so we use a static const
-              // to speed up the calculation
-              static const double scalingCoeffQpsk = 
-                (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1] - MI_map_qpsk_axis[0]);
-              double sinrIndexDouble = (sinrLin -  MI_map_qpsk_axis[0]) * scalingCoeffQpsk + 1;
-              uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-              NS_ASSERT_MSG (sinrIndex < MI_MAP_QPSK_SIZE, "MI map out of data");
-              MI = MI_map_qpsk[sinrIndex];
-            }
+          NS_ASSERT_MSG (map[i + j] >= 0 && (uint32_t) map[i + j] < sinr.GetSpectrumModel ()->GetNumBands (),
+                         "RB " << map[i + j] << " out of the bandwidth");
+          batch[j] = sinrIt[map[i + j]];
         }
-      else
-        {
-          if (mcs > MI_QPSK_MAX_ID && mcs <= MI_16QAM_MAX_ID )	// 16-QAM
-            {
-              if (sinrLin > MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1])
-                {
-                  MI = 1;
-                }
-              else 
-                {
-                  // since the values in MI_map_16QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff16qam = 
-                    (MI_MAP_16QAM_SIZE - 1) / (MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1] - MI_map_16qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_16qam_axis[0]) * scalingCoeff16qam + 1;
-                  uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_16QAM_SIZE, "MI map out of data");
-                  MI = MI_map_16qam[sinrIndex];
-                }
-            }
-          else // 64-QAM
-            {
-              if (sinrLin > MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1])
-                {
-                  MI = 1;
-                }
-              else
-                {
-                  // since the values in MI_map_64QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff64qam = 
-                    (MI_MAP_64QAM_SIZE - 1) / (MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1] - MI_map_64qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_64qam_axis[0]) * scalingCoeff64qam + 1;
-                  uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_64QAM_SIZE, "MI map out of data");
-                  MI = MI_map_64qam[sinrIndex];
-                }
-            }
-        }
-      NS_LOG_LOGIC (" RB " << map.at (i) << "Minimum SNR = " << 10 * std::log10 (sinrLin) << " dB, " << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
-      MIsum += MI;
+      MIsum += MiSum (miMap, batch, n);
     }
-  MI = MIsum / map.size ();
-  NS_LOG_LOGIC (" MI = " << MI);
+
+  double MI = MIsum / size;
+  NS_LOG_LOGIC (" MCS = " << (uint16_t)mcs << ", MI = " << MI);
   return MI;
 }
 
+double
+LteMiErrorModel::MappingSinrMi (double sinr, uint8_t mcs)
+{
+  return MiSum (GetMiMap (mcs), &sinr, 1);
+}
+
 
 double 
 LteMiErrorModel::MappingMiBler (double mib, uint8_t ecrId, uint16_t cbSize)
@@ -458,37 +490,16 @@ double
 LteMiErrorModel::GetPcfichPdcchError (const SpectrumValue& sinr)
 {
   NS_LOG_FUNCTION (sinr);
-  double MI;
   double MIsum = 0.0;
-  SpectrumValue sinrCopy = sinr;
-  Values::iterator sinrIt = sinrCopy.ValuesBegin ();
-  uint16_t rb = 0;
-  NS_ASSERT (sinrIt!=sinrCopy.ValuesEnd ());
-  while (sinrIt!=sinrCopy.ValuesEnd ())
+  Values::const_iterator sinrIt = sinr.ConstValuesBegin ();
+  uint32_t rb = sinr.GetSpectrumModel ()->GetNumBands ();
+  NS_ASSERT (rb > 0);
+  // the values of a SpectrumValue are contiguous: map them in place
+  for (uint32_t i = 0; i < rb; i += MI_BATCH_SIZE)
     {
-      double sinrLin = *sinrIt;
-      if (sinrLin > MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1])
-        {
-          MI = 1;
-        }
-      else 
-        { 
-          // since the values in MI_map_qpsk_axis are uniformly spaced, we have
-          // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-              // the scaling coefficient is always the same, so we use a static const
-              // to speed up the calculation
-          static const double scalingCoeffQpsk = 
-            (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1] - MI_map_qpsk_axis[0]);
-          double sinrIndexDouble = (sinrLin -  MI_map_qpsk_axis[0]) * scalingCoeffQpsk + 1;
-          uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-          NS_ASSERT_MSG (sinrIndex < MI_MAP_QPSK_SIZE, "MI map out of data");
-          MI = MI_map_qpsk[sinrIndex];
-        }
-      MIsum += MI;
-      sinrIt++;
-      rb++;
+      MIsum += MiSum (MiMapQpsk, &sinrIt[i], std::min (rb - i, MI_BATCH_SIZE));
     }
-  MI = MIsum / rb;
+  double MI = MIsum / rb;
   // return to the effective SINR value
   int j = 0;
   double esinr = 0.0;
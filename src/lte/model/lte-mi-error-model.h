@@ -80,6 +80,17 @@ public:
    * \return the mmib
    */
   static double Mib (const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs);
+  /** 
+   * \brief map a SINR to the mutual information per bit of the modulation of a MCS
+   *
+   * The SINR takes the MI of the first point above it in the MI map of
+   * the modulation; beyond the last point of the map the MI is 1.
+   *
+   * \param sinr the linear SINR
+   * \param mcs the MCS
+   * \return the mutual information per bit
+   */
+  static double MappingSinrMi (double sinr, uint8_t mcs);
   /** 
    * \brief map the mmib (mean mutual information per bit) for different MCS
    * \param mib mean mutual information per bit of a code-block
@@ -26,7 +26,7 @@
 #include <ns3/lte-rlc.h>
 
 #include <vector>
-#include <map>
+#include <deque>
 
 namespace ns3 {
 
@@ -79,7 +79,7 @@ private:
   void DoReportBufferStatus ();
 
 private:
-    std::vector < Ptr<Packet> > m_txonBuffer;       // Transmission buffer
+    std::deque < Ptr<Packet> > m_txonBuffer;        // Transmission buffer
 
     struct RetxPdu
     {
@@ -101,20 +101,19 @@ private:
 
     struct PduBuffer
     {
-      SequenceNumber10  m_seqNumber;
-      std::list < Ptr<Packet> >  m_byteSegments;
+      Ptr<Packet> m_pdu;  ///< the PDU received, or 0; re-segmentation is not supported
 
       bool      m_pduComplete;
     };
 
-    std::map <uint16_t, PduBuffer > m_rxonBuffer; // Reception buffer
+    std::vector <PduBuffer> m_rxonBuffer;         ///< Reception buffer, indexed by SN
 
     Ptr<Packet> m_controlPduBuffer;               // Control PDU buffer (just one PDU)
 
     // SDU reassembly
 //   std::vector < Ptr<Packet> > m_reasBuffer;     // Reassembling buffer
 // 
-    std::list < Ptr<Packet> > m_sdusBuffer;       // List of SDUs in a packet (PDU)
+    std::deque < Ptr<Packet> > m_sdusBuffer;      // List of SDUs in a packet (PDU)
 
   /**
    * State variables. See section 7.1 in TS 36.322
@@ -0,0 +1,270 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-scheduler-thread-pool.h"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/uinteger.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteSchedulerThreadPool");
+
+NS_OBJECT_ENSURE_REGISTERED (LteSchedulerThreadPool);
+
+/**
+ * Maximum time a thread waits before checking again for a wakeup, in
+ * nanoseconds
+ */
+static const uint64_t POLL_NS = 1000000;
+
+TypeId
+LteSchedulerThreadPool::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LteSchedulerThreadPool")
+    .SetParent<Object> ()
+    .SetGroupName ("Lte")
+    .AddConstructor<LteSchedulerThreadPool> ()
+    .AddAttribute ("Threads",
+                   "The number of threads running the jobs, the simulation thread included. "
+                   "With a single thread, the jobs are run in turn on the simulation thread.",
+                   UintegerValue (4),
+                   MakeUintegerAccessor (&LteSchedulerThreadPool::m_nThreads),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+LteSchedulerThreadPool::LteSchedulerThreadPool ()
+  : m_flushScheduled (false),
+    m_nextJob (0),
+    m_nFlushes (0),
+    m_nJobs (0)
+#ifdef HAVE_PTHREAD_H
+    ,
+    m_generation (0),
+    m_nWorking (0),
+    m_stop (false)
+#endif /* HAVE_PTHREAD_H */
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LteSchedulerThreadPool::~LteSchedulerThreadPool ()
+{
+  NS_LOG_FUNCTION (this);
+  StopWorkers ();
+}
+
+void
+LteSchedulerThreadPool::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  StopWorkers ();
+  m_jobs.clear ();
+  m_running.clear ();
+  Object::DoDispose ();
+}
+
+void
+LteSchedulerThreadPool::Submit (Callback<void> job, Callback<void> merge)
+{
+  NS_LOG_FUNCTION (this);
+  Job j;
+  j.job = job;
+  j.merge = merge;
+  m_jobs.push_back (j);
+  if (!m_flushScheduled)
+    {
+      // the events scheduled now run after those already scheduled at
+      // the current time, which may submit further jobs
+      Simulator::ScheduleNow (&LteSchedulerThreadPool::Flush, this);
+      m_flushScheduled = true;
+    }
+}
+
+uint64_t
+LteSchedulerThreadPool::GetNFlushes (void) const
+{
+  return m_nFlushes;
+}
+
+uint64_t
+LteSchedulerThreadPool::GetNJobs (void) const
+{
+  return m_nJobs;
+}
+
+bool
+LteSchedulerThreadPool::IsParallel (void) const
+{
+  if (m_nThreads <= 1 || m_running.size () <= 1)
+    {
+      return false;
+    }
+#ifdef NS3_LOG_ENABLE
+  // the log lines of concurrent jobs would be interleaved
+  LogComponent::ComponentList *components = LogComponent::GetComponentList ();
+  for (LogComponent::ComponentList::const_iterator it = components->begin ();
+       it != components->end ();
+       ++it)
+    {
+      if (!it->second->IsNoneEnabled ())
+        {
+          return false;
+        }
+    }
+#endif /* NS3_LOG_ENABLE */
+  return true;
+}
+
+void
+LteSchedulerThreadPool::Flush (void)
+{
+  NS_LOG_FUNCTION (this << m_jobs.size ());
+  m_flushScheduled = false;
+  // the merge callbacks may submit jobs, run by a further flush
+  m_running.swap (m_jobs);
+  m_nextJob = 0;
+#ifdef HAVE_PTHREAD_H
+  if (IsParallel ())
+    {
+      if (m_workers.empty ())
+        {
+          StartWorkers ();
+        }
+      // the jobs are published to the workers by the new generation,
+      // and their results to this thread by m_nWorking
+      __atomic_store_n (&m_nWorking, m_workers.size (), __ATOMIC_RELAXED);
+      __atomic_store_n (&m_generation, m_generation + 1, __ATOMIC_RELEASE);
+      for (std::vector<Worker>::iterator it = m_workers.begin (); it != m_workers.end (); ++it)
+        {
+          it->wake->SetCondition (true);
+          it->wake->Signal ();
+        }
+      RunJobs ();
+      while (true)
+        {
+          // Cleared before checking the workers, so that the last one
+          // being done after the check cuts the wait short
+          m_done.SetCondition (false);
+          if (__atomic_load_n (&m_nWorking, __ATOMIC_ACQUIRE) == 0)
+            {
+              break;
+            }
+          m_done.TimedWait (POLL_NS);
+        }
+    }
+  else
+#endif /* HAVE_PTHREAD_H */
+    {
+      RunJobs ();
+    }
+
+  ++m_nFlushes;
+  m_nJobs += m_running.size ();
+  for (std::vector<Job>::iterator it = m_running.begin (); it != m_running.end (); ++it)
+    {
+      it->merge ();
+    }
+  m_running.clear ();
+}
+
+void
+LteSchedulerThreadPool::RunJobs (void)
+{
+  uint32_t nJobs = m_running.size ();
+  while (true)
+    {
+      uint32_t i = __atomic_fetch_add (&m_nextJob, 1, __ATOMIC_RELAXED);
+      if (i >= nJobs)
+        {
+          break;
+        }
+      m_running[i].job ();
+    }
+}
+
+void
+LteSchedulerThreadPool::StartWorkers (void)
+{
+  NS_LOG_FUNCTION (this << m_nThreads);
+#ifdef HAVE_PTHREAD_H
+  m_stop = false;
+  // the workers refer to their entry, which must not move
+  m_workers.reserve (m_nThreads - 1);
+  for (uint32_t i = 0; i + 1 < m_nThreads; i++)
+    {
+      Worker worker;
+      worker.wake = new SystemCondition ();
+      worker.thread = Create<SystemThread> (MakeCallback (&LteSchedulerThreadPool::WorkerLoop, this).Bind (i));
+      m_workers.push_back (worker);
+      worker.thread->Start ();
+    }
+#endif /* HAVE_PTHREAD_H */
+}
+
+void
+LteSchedulerThreadPool::StopWorkers (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  __atomic_store_n (&m_stop, true, __ATOMIC_RELEASE);
+  for (std::vector<Worker>::iterator it = m_workers.begin (); it != m_workers.end (); ++it)
+    {
+      it->wake->SetCondition (true);
+      it->wake->Signal ();
+      it->thread->Join ();
+      delete it->wake;
+    }
+  m_workers.clear ();
+#endif /* HAVE_PTHREAD_H */
+}
+
+void
+LteSchedulerThreadPool::WorkerLoop (uint32_t worker)
+{
+#ifdef HAVE_PTHREAD_H
+  SystemCondition *wake = m_workers[worker].wake;
+  uint64_t generation = 0;
+  while (true)
+    {
+      // Cleared before checking for a new generation, so that a new
+      // generation after the check cuts the wait short
+      wake->SetCondition (false);
+      if (__atomic_load_n (&m_stop, __ATOMIC_ACQUIRE))
+        {
+          break;
+        }
+      uint64_t current = __atomic_load_n (&m_generation, __ATOMIC_ACQUIRE);
+      if (current == generation)
+        {
+          wake->TimedWait (POLL_NS);
+          continue;
+        }
+      generation = current;
+      RunJobs ();
+      if (__atomic_sub_fetch (&m_nWorking, 1, __ATOMIC_ACQ_REL) == 0)
+        {
+          m_done.SetCondition (true);
+          m_done.Signal ();
+        }
+    }
+#endif /* HAVE_PTHREAD_H */
+}
+
+} // namespace ns3
@@ -0,0 +1,174 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_SCHEDULER_THREAD_POOL_H
+#define LTE_SCHEDULER_THREAD_POOL_H
+
+#include <ns3/object.h>
+#include <ns3/callback.h>
+#include <ns3/core-config.h>
+#include <vector>
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-thread.h>
+#include <ns3/system-condition.h>
+#endif /* HAVE_PTHREAD_H */
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * \brief Runs the scheduler invocations of the eNBs of a TTI in parallel
+ *
+ * Within a TTI the decisions of the schedulers of different cells are
+ * independent. An eNB MAC using a pool prepares the requests of a
+ * subframe to its scheduler on the simulation thread, and submits a job
+ * making them; the pool defers the jobs submitted at a given time until
+ * the events already scheduled at that time have run, and then runs all
+ * of them on its threads, the simulation thread included.
+ *
+ * While a job runs, the MAC stores the indications of its scheduler
+ * instead of acting upon them. Once all the jobs are done, the merge
+ * callback of each job delivers these indications on the simulation
+ * thread, in the order the jobs were submitted: the results do not
+ * depend on the number of threads, nor on the way the jobs are spread
+ * among them. A merge callback may submit a further job, which is run
+ * with the others submitted by the merge callbacks, still at the same
+ * time: the MAC makes the DL requests in a first job, and the UL ones
+ * in a second job once the DL indications are delivered, as when it
+ * invokes the scheduler directly.
+ *
+ * A job may only access the state of its own cell, that is, of its
+ * MAC, scheduler and FFR algorithm, and the parameters of the requests,
+ * which the MAC copies into plain structures. Much of the shared state
+ * of the simulator is not thread safe, so a job must not:
+ *  - call GetObject, nor look up the attributes or trace sources of a
+ *    TypeId, as these update caches (see Object::GetObject and
+ *    TypeId::LookupAttributeByName);
+ *  - copy or release a Ptr to an object which another cell may use, as
+ *    the reference counts are not atomic;
+ *  - schedule or cancel events, nor create Objects.
+ *
+ * The schedulers and FFR algorithms of the lte module meet these
+ * requirements: the only Ptr they handle in a request is the vendor
+ * specific value of the UL CQI of their own cell. The NS_LOG output of
+ * concurrent jobs would be interleaved: while a log component is
+ * enabled, the jobs are run in turn on the simulation thread.
+ */
+class LteSchedulerThreadPool : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  LteSchedulerThreadPool ();
+  virtual ~LteSchedulerThreadPool ();
+
+  /**
+   * \brief Submit a job to be run at the end of the current time
+   *
+   * \param job the job, run on any thread of the pool
+   * \param merge called on the simulation thread once all the jobs run
+   * with this one are done; it may submit a further job
+   */
+  void Submit (Callback<void> job, Callback<void> merge);
+
+  /**
+   * \return the number of times the jobs were run
+   */
+  uint64_t GetNFlushes (void) const;
+
+  /**
+   * \return the number of jobs run
+   */
+  uint64_t GetNJobs (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * A job and the callback delivering its results
+   */
+  struct Job
+  {
+    Callback<void> job;   ///< the job
+    Callback<void> merge; ///< the delivery of its results
+  };
+
+  /**
+   * Run the jobs submitted, then deliver their results
+   */
+  void Flush (void);
+
+  /**
+   * \return true if the jobs may run on several threads
+   */
+  bool IsParallel (void) const;
+
+  /**
+   * Run the jobs not yet taken by another thread
+   */
+  void RunJobs (void);
+
+  /**
+   * Start the worker threads
+   */
+  void StartWorkers (void);
+
+  /**
+   * Stop the worker threads
+   */
+  void StopWorkers (void);
+
+  /**
+   * The loop of a worker thread
+   * \param worker the index of the worker
+   */
+  void WorkerLoop (uint32_t worker);
+
+  uint32_t m_nThreads;       ///< the number of threads, the simulation thread included
+  std::vector<Job> m_jobs;   ///< the jobs submitted, to be run by the next flush
+  std::vector<Job> m_running; ///< the jobs being run, and whose results are being delivered
+  bool m_flushScheduled;     ///< whether the jobs of the current time are scheduled to run
+  uint32_t m_nextJob;        ///< the next job to be taken by a thread
+  uint64_t m_nFlushes;       ///< the number of times the jobs were run
+  uint64_t m_nJobs;          ///< the number of jobs run
+
+#ifdef HAVE_PTHREAD_H
+  /**
+   * A worker thread
+   */
+  struct Worker
+  {
+    Ptr<SystemThread> thread; ///< the thread
+    SystemCondition *wake;    ///< signaled when there are jobs to run
+  };
+
+  std::vector<Worker> m_workers; ///< the worker threads
+  uint64_t m_generation;         ///< incremented when there are jobs to run
+  uint32_t m_nWorking;           ///< the number of workers not done with the jobs yet
+  bool m_stop;                   ///< set to stop the workers
+  SystemCondition m_done;        ///< signaled when the last worker is done
+#endif /* HAVE_PTHREAD_H */
+};
+
+} // namespace ns3
+
+#endif /* LTE_SCHEDULER_THREAD_POOL_H */
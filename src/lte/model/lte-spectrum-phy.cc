@@ -900,6 +900,33 @@ LteSpectrumPhy::StartRxUlSrs (Ptr<LteSpectrumSignalParametersUlSrsFrame> lteUlSr
 }
 
 
+void
+LteSpectrumPhy::AddInterference (Ptr<const SpectrumValue> psd, Time duration, bool ctrl)
+{
+  NS_LOG_FUNCTION (this << duration << ctrl);
+  if (ctrl)
+    {
+      m_interferenceCtrl->AddSignal (psd, duration);
+    }
+  else
+    {
+      m_interferenceData->AddSignal (psd, duration);
+    }
+}
+
+
+void
+LteSpectrumPhy::ReceivePss (uint16_t cellId, Ptr<SpectrumValue> psd)
+{
+  NS_LOG_FUNCTION (this << cellId);
+  NS_ASSERT_MSG (cellId != m_cellId, "the PSS of the serving cell comes with its DL control frame");
+  if (!m_ltePhyRxPssCallback.IsNull ())
+    {
+      m_ltePhyRxPssCallback (cellId, psd);
+    }
+}
+
+
 void
 LteSpectrumPhy::UpdateSinrPerceived (const SpectrumValue& sinr)
 {
@@ -1189,6 +1216,12 @@ LteSpectrumPhy::SetCellId (uint16_t cellId)
   m_cellId = cellId;
 }
 
+uint16_t
+LteSpectrumPhy::GetCellId () const
+{
+  return m_cellId;
+}
+
 
 void
 LteSpectrumPhy::AddRsPowerChunkProcessor (Ptr<LteChunkProcessor> p)
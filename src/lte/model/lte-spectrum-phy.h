@@ -182,6 +182,28 @@ public:
   void StartRxDlCtrl (Ptr<LteSpectrumSignalParametersDlCtrlFrame> lteDlCtrlRxParams);
   void StartRxUlSrs (Ptr<LteSpectrumSignalParametersUlSrsFrame> lteUlSrsRxParams);
 
+  /**
+   * Add the signals of other cells to the interference, as StartRx
+   * does for each of them, without processing them further; used by
+   * LteAbstractSpectrumChannel to deliver them as a whole.
+   *
+   * \param psd the sum of the power spectral densities of the signals;
+   * not retained
+   * \param duration the duration of the signals
+   * \param ctrl true if the signals are DL control or UL SRS frames,
+   * false if they are data frames
+   */
+  void AddInterference (Ptr<const SpectrumValue> psd, Time duration, bool ctrl);
+
+  /**
+   * Notify the PSS of a DL control frame of another cell, as StartRx
+   * does when receiving the frame; used by LteAbstractSpectrumChannel.
+   *
+   * \param cellId the cell of the frame
+   * \param psd the power spectral density of the frame
+   */
+  void ReceivePss (uint16_t cellId, Ptr<SpectrumValue> psd);
+
   void SetHarqPhyModule (Ptr<LteHarqPhy> harq);
 
   /**
@@ -323,6 +345,11 @@ public:
    */
   void SetCellId (uint16_t cellId);
 
+  /**
+   * \return the cell Identifier of the signals this PHY synchronizes with
+   */
+  uint16_t GetCellId () const;
+
 
   /**
   *
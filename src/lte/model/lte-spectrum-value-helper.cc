@@ -321,4 +321,21 @@ LteSpectrumValueHelper::CreateNoisePowerSpectralDensity (double noiseFigureDb, P
   return noisePsd;
 }
 
+void
+LteSpectrumValueHelper::GetOccupiedRbs (const SpectrumValue& psd, uint32_t& first, uint32_t& end)
+{
+  Values::const_iterator values = psd.ConstValuesBegin ();
+  uint32_t n = psd.GetSpectrumModel ()->GetNumBands ();
+  first = 0;
+  while (first < n && values[first] == 0.0)
+    {
+      ++first;
+    }
+  end = n;
+  while (end > first && values[end - 1] == 0.0)
+    {
+      --end;
+    }
+}
+
 } // namespace ns3
@@ -24,6 +24,7 @@
 
 #include <ns3/spectrum-value.h>
 #include <vector>
+#include <map>
 
 namespace ns3 {
 
@@ -157,6 +158,20 @@ public:
    */
   static Ptr<SpectrumValue> CreateNoisePowerSpectralDensity (double noiseFigure, Ptr<SpectrumModel> spectrumModel);
 
+  /**
+   *  find the resource blocks occupied by a power spectral density
+   *
+   * The power spectral densities of LTE signals are zero outside of the
+   * resource blocks allocated to the transmission, so that the sums
+   * over the signals only need to be updated over the occupied range.
+   *
+   * \param psd the power spectral density
+   * \param first the first resource block where the PSD is not zero
+   * \param end one past the last resource block where the PSD is not
+   * zero, or first if the PSD is zero everywhere
+   */
+  static void GetOccupiedRbs (const SpectrumValue& psd, uint32_t& first, uint32_t& end);
+
 };
 
 
@@ -143,6 +143,8 @@ LteUePhy::LteUePhy (Ptr<LteSpectrumPhy> dlPhy, Ptr<LteSpectrumPhy> ulPhy)
   : LtePhy (dlPhy, ulPhy),
     m_p10CqiPeriocity (MilliSeconds (1)),  // ideal behavior
     m_a30CqiPeriocity (MilliSeconds (1)),  // ideal behavior
+    m_inactivityTimer (Seconds (0)),
+    m_lastActivity (Seconds (0)),
     m_uePhySapUser (0),
     m_ueCphySapUser (0),
     m_state (CELL_SEARCH),
@@ -281,6 +283,15 @@ LteUePhy::GetTypeId (void)
                    TimeValue (MilliSeconds (200)),
                    MakeTimeAccessor (&LteUePhy::m_ueMeasurementsFilterPeriod),
                    MakeTimeChecker ())
+    .AddAttribute ("InactivityTimer",
+                   "Time after which a UE which was neither scheduled nor had "
+                   "anything but CQIs to send stops reporting CQIs and SRS, until "
+                   "it is scheduled again or has something else to send, as "
+                   "outside the Active Time of DRX. Zero means that the UE "
+                   "always reports them.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&LteUePhy::m_inactivityTimer),
+                   MakeTimeChecker ())
     .AddTraceSource ("ReportUeMeasurements",
                      "Report UE measurements RSRP (dBm) and RSRQ (dB).",
                      MakeTraceSourceAccessor (&LteUePhy::m_reportUeMeasurements),
@@ -484,7 +495,7 @@ LteUePhy::GenerateCqiRsrpRsrq (const SpectrumValue& sinr)
   NS_ASSERT (m_state != CELL_SEARCH);
   NS_ASSERT (m_cellId > 0);
 
-  if (m_dlConfigured && m_ulConfigured && (m_rnti > 0))
+  if (m_dlConfigured && m_ulConfigured && (m_rnti > 0) && !IsInactive ())
     {
       // check periodic wideband CQI
       if (Simulator::Now () > m_p10CqiLast + m_p10CqiPeriocity)
@@ -836,11 +847,22 @@ LteUePhy::ReportUeMeasurements ()
   Simulator::Schedule (m_ueMeasurementsFilterPeriod, &LteUePhy::ReportUeMeasurements, this);
 }
 
+bool
+LteUePhy::IsInactive () const
+{
+  return m_inactivityTimer > Seconds (0)
+         && Simulator::Now () > m_lastActivity + m_inactivityTimer;
+}
+
 void
 LteUePhy::DoSendLteControlMessage (Ptr<LteControlMessage> msg)
 {
   NS_LOG_FUNCTION (this << msg);
 
+  if (msg->GetMessageType () != LteControlMessage::DL_CQI)
+    {
+      m_lastActivity = Simulator::Now ();
+    }
   SetControlMessages (msg);
 }
 
@@ -854,6 +876,7 @@ LteUePhy::DoSendRachPreamble (uint32_t raPreambleId, uint32_t raRnti)
   msg->SetRapId (raPreambleId);
   m_raPreambleId = raPreambleId;
   m_raRnti = raRnti;
+  m_lastActivity = Simulator::Now ();
   m_controlMessagesQueue.at (0).push_back (msg);
 }
 
@@ -878,6 +901,7 @@ LteUePhy::ReceiveLteControlMessageList (std::list<Ptr<LteControlMessage> > msgLi
               // DCI not for me
               continue;
             }
+          m_lastActivity = Simulator::Now ();
 
           if (dci.m_resAlloc != 0)
             {
@@ -927,6 +951,7 @@ LteUePhy::ReceiveLteControlMessageList (std::list<Ptr<LteControlMessage> > msgLi
               // DCI not for me
               continue;
             }
+          m_lastActivity = Simulator::Now ();
           NS_LOG_INFO (this << " UL DCI");
           std::vector <int> ulRb;
           for (int i = 0; i < dci.m_rbLen; i++)
@@ -967,6 +992,7 @@ LteUePhy::ReceiveLteControlMessageList (std::list<Ptr<LteControlMessage> > msgLi
                   else
                     {
                       NS_LOG_INFO ("received RAR RNTI " << m_raRnti);
+                      m_lastActivity = Simulator::Now ();
                       // set the uplink bandwidht according to the UL grant
                       std::vector <int> ulRb;
                       for (int i = 0; i < it->rarPayload.m_grant.m_rbLen; i++)
@@ -1096,7 +1122,7 @@ LteUePhy::SubframeIndication (uint32_t frameNo, uint32_t subframeNo)
         }
       m_subChannelsForTransmissionQueue.at (m_macChTtiDelay-1).clear ();
 
-      if (m_srsConfigured && (m_srsStartTime <= Simulator::Now ()))
+      if (m_srsConfigured && (m_srsStartTime <= Simulator::Now ()) && !IsInactive ())
         {
 
           NS_ASSERT_MSG (subframeNo > 0 && subframeNo <= 10, "the SRS index check code assumes that subframeNo starts at 1");
@@ -1200,6 +1226,7 @@ LteUePhy::DoReset ()
   m_rsrpSinrSampleCounter = 0;
   m_p10CqiLast = Simulator::Now ();
   m_a30CqiLast = Simulator::Now ();
+  m_lastActivity = Simulator::Now ();
   m_paLinear = 1;
 
   m_packetBurstQueue.clear ();
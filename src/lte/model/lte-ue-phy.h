@@ -292,6 +292,13 @@ private:
    */
   void GenerateCqiRsrpRsrq (const SpectrumValue& sinr);
 
+  /**
+   * \return true if the `InactivityTimer` expired, i.e., if the UE has
+   *         neither been scheduled nor had anything but CQIs to send for
+   *         longer, and hence reports neither CQIs nor SRS
+   */
+  bool IsInactive () const;
+
 
   /**
    * \brief Layer-1 filtering of RSRP and RSRQ measurements and reporting to
@@ -356,6 +363,18 @@ private:
   Time m_a30CqiPeriocity;
   Time m_a30CqiLast;
 
+  /**
+   * The `InactivityTimer` attribute. Time without activity after which the
+   * UE stops reporting CQIs and SRS, as outside the Active Time of DRX, or
+   * zero if the UE always reports them.
+   */
+  Time m_inactivityTimer;
+  /**
+   * The last time the UE was scheduled, performed a random access or had
+   * anything but a CQI to send.
+   */
+  Time m_lastActivity;
+
   LteUePhySapProvider* m_uePhySapProvider;
   LteUePhySapUser* m_uePhySapUser;
 
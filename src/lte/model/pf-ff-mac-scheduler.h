@@ -25,6 +25,7 @@
 #include <ns3/ff-mac-csched-sap.h>
 #include <ns3/ff-mac-sched-sap.h>
 #include <ns3/ff-mac-scheduler.h>
+#include <ns3/ff-mac-scheduler-ue-table.h>
 #include <vector>
 #include <map>
 #include <ns3/nstime.h>
@@ -148,6 +149,20 @@ private:
 
   int GetRbgSize (int dlbandwidth);
 
+  /**
+  * \brief Add a UE to the table of UEs, with empty HARQ processes
+  *
+  * \param rnti the RNTI of the UE
+  * \return the slot of the UE
+  */
+  uint32_t AddUe (uint16_t rnti);
+
+  /**
+  * \param rnti the RNTI of a UE
+  * \return the slot of the UE, which must be in the table of UEs
+  */
+  uint32_t GetUeSlot (uint16_t rnti) const;
+
   int LcActivePerFlow (uint16_t rnti);
 
   double EstimateUlSinr (uint16_t rnti, uint16_t rb);
@@ -189,33 +204,39 @@ private:
 
 
   /*
-  * Map of UE statistics (per RNTI basis) in downlink
+   * Dense table of the UEs: the per-UE state below is indexed by the
+   * slot of the UE in this table
+   */
+  FfMacSchedulerUeTable m_ues;
+
+  /*
+  * UE statistics in downlink, set once the UE has a LC
   */
-  std::map <uint16_t, pfsFlowPerf_t> m_flowStatsDl;
+  FfMacSchedulerUeColumn<pfsFlowPerf_t> m_flowStatsDl;
 
   /*
-  * Map of UE statistics (per RNTI basis)
+  * UE statistics in uplink, set once the UE has a LC
   */
-  std::map <uint16_t, pfsFlowPerf_t> m_flowStatsUl;
+  FfMacSchedulerUeColumn<pfsFlowPerf_t> m_flowStatsUl;
 
 
   /*
-  * Map of UE's DL CQI P01 received
+  * UE's DL CQI P01 received
   */
-  std::map <uint16_t,uint8_t> m_p10CqiRxed;
+  FfMacSchedulerUeColumn<uint8_t> m_p10CqiRxed;
   /*
-  * Map of UE's timers on DL CQI P01 received
+  * UE's timers on DL CQI P01 received
   */
-  std::map <uint16_t,uint32_t> m_p10CqiTimers;
+  std::vector <uint32_t> m_p10CqiTimers;
 
   /*
-  * Map of UE's DL CQI A30 received
+  * UE's DL CQI A30 received
   */
-  std::map <uint16_t,SbMeasResult_s> m_a30CqiRxed;
+  FfMacSchedulerUeColumn<SbMeasResult_s> m_a30CqiRxed;
   /*
-  * Map of UE's timers on DL CQI A30 received
+  * UE's timers on DL CQI A30 received
   */
-  std::map <uint16_t,uint32_t> m_a30CqiTimers;
+  std::vector <uint32_t> m_a30CqiTimers;
 
   /*
   * Map of previous allocated UE per RBG
@@ -224,7 +245,7 @@ private:
   std::map <uint16_t, std::vector <uint16_t> > m_allocationMaps;
 
   /*
-  * Map of UEs' UL-CQI per RBG
+  * Map of UEs' UL-CQI per RBG (a map, as reported to the FFR algorithm)
   */
   std::map <uint16_t, std::vector <double> > m_ueCqi;
   /*
@@ -233,9 +254,15 @@ private:
   std::map <uint16_t, uint32_t> m_ueCqiTimers;
 
   /*
-  * Map of UE's buffer status reports received
+  * UE's buffer status reports received
+  */
+  FfMacSchedulerUeColumn<uint32_t> m_ceBsrRxed;
+
+  /*
+  * Slots of the UEs with a buffer status report, in increasing RNTI
+  * order, rebuilt at each UL trigger
   */
-  std::map <uint16_t,uint32_t> m_ceBsrRxed;
+  std::vector <uint32_t> m_ulUes;
 
   // MAC SAPs
   FfMacCschedSapUser* m_cschedSapUser;
@@ -257,29 +284,29 @@ private:
 
   uint32_t m_cqiTimersThreshold; // # of TTIs for which a CQI canbe considered valid
 
-  std::map <uint16_t,uint8_t> m_uesTxMode; // txMode of the UEs
+  std::vector <uint8_t> m_uesTxMode; // txMode of the UEs
 
   // HARQ attributes
   /**
   * m_harqOn when false inhibit te HARQ mechanisms (by default active)
   */
   bool m_harqOn;
-  std::map <uint16_t, uint8_t> m_dlHarqCurrentProcessId;
-  //HARQ status
+  std::vector <uint8_t> m_dlHarqCurrentProcessId;
+  //HARQ status, HARQ_PROC_NUM entries per UE
   // 0: process Id available
   // x>0: process Id equal to `x` trasmission count
-  std::map <uint16_t, DlHarqProcessesStatus_t> m_dlHarqProcessesStatus;
-  std::map <uint16_t, DlHarqProcessesTimer_t> m_dlHarqProcessesTimer;
-  std::map <uint16_t, DlHarqProcessesDciBuffer_t> m_dlHarqProcessesDciBuffer;
-  std::map <uint16_t, DlHarqRlcPduListBuffer_t> m_dlHarqProcessesRlcPduListBuffer;
+  std::vector <uint8_t> m_dlHarqProcessesStatus;
+  std::vector <uint8_t> m_dlHarqProcessesTimer; // HARQ_PROC_NUM entries per UE
+  std::vector <DlHarqProcessesDciBuffer_t> m_dlHarqProcessesDciBuffer;
+  std::vector <DlHarqRlcPduListBuffer_t> m_dlHarqProcessesRlcPduListBuffer;
   std::vector <DlInfoListElement_s> m_dlInfoListBuffered; // HARQ retx buffered
 
-  std::map <uint16_t, uint8_t> m_ulHarqCurrentProcessId;
-  //HARQ status
+  std::vector <uint8_t> m_ulHarqCurrentProcessId;
+  //HARQ status, HARQ_PROC_NUM entries per UE
   // 0: process Id available
   // x>0: process Id equal to `x` trasmission count
-  std::map <uint16_t, UlHarqProcessesStatus_t> m_ulHarqProcessesStatus;
-  std::map <uint16_t, UlHarqProcessesDciBuffer_t> m_ulHarqProcessesDciBuffer;
+  std::vector <uint8_t> m_ulHarqProcessesStatus;
+  std::vector <UlHarqProcessesDciBuffer_t> m_ulHarqProcessesDciBuffer;
 
 
   // RACH attributes
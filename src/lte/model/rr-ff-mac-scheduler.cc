@@ -235,6 +235,7 @@ void
 RrFfMacScheduler::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_ues.Clear ();
   m_dlHarqProcessesDciBuffer.clear ();
   m_dlHarqProcessesTimer.clear ();
   m_dlHarqProcessesRlcPduListBuffer.clear ();
@@ -242,6 +243,8 @@ RrFfMacScheduler::DoDispose ()
   m_ulHarqCurrentProcessId.clear ();
   m_ulHarqProcessesStatus.clear ();
   m_ulHarqProcessesDciBuffer.clear ();
+  m_p10CqiRxed.Clear ();
+  m_ceBsrRxed.Clear ();
   delete m_cschedSapProvider;
   delete m_schedSapProvider;
 }
@@ -327,39 +330,66 @@ void
 RrFfMacScheduler::DoCschedUeConfigReq (const struct FfMacCschedSapProvider::CschedUeConfigReqParameters& params)
 {
   NS_LOG_FUNCTION (this << " RNTI " << params.m_rnti << " txMode " << (uint16_t)params.m_transmissionMode);
-  std::map <uint16_t,uint8_t>::iterator it = m_uesTxMode.find (params.m_rnti);
-  if (it == m_uesTxMode.end ())
+  uint32_t slot = m_ues.GetSlot (params.m_rnti);
+  if (slot == FfMacSchedulerUeTable::NO_SLOT)
     {
-      m_uesTxMode.insert (std::pair <uint16_t, double> (params.m_rnti, params.m_transmissionMode));
-      // generate HARQ buffers
-      m_dlHarqCurrentProcessId.insert (std::pair <uint16_t,uint8_t > (params.m_rnti, 0));
-      DlHarqProcessesStatus_t dlHarqPrcStatus;
-      dlHarqPrcStatus.resize (8,0);
-      m_dlHarqProcessesStatus.insert (std::pair <uint16_t, DlHarqProcessesStatus_t> (params.m_rnti, dlHarqPrcStatus));
-      DlHarqProcessesTimer_t dlHarqProcessesTimer;
-      dlHarqProcessesTimer.resize (8,0);
-      m_dlHarqProcessesTimer.insert (std::pair <uint16_t, DlHarqProcessesTimer_t> (params.m_rnti, dlHarqProcessesTimer));
-      DlHarqProcessesDciBuffer_t dlHarqdci;
-      dlHarqdci.resize (8);
-      m_dlHarqProcessesDciBuffer.insert (std::pair <uint16_t, DlHarqProcessesDciBuffer_t> (params.m_rnti, dlHarqdci));
-      DlHarqRlcPduListBuffer_t dlHarqRlcPdu;
-      dlHarqRlcPdu.resize (2);
-      dlHarqRlcPdu.at (0).resize (8);
-      dlHarqRlcPdu.at (1).resize (8);
-      m_dlHarqProcessesRlcPduListBuffer.insert (std::pair <uint16_t, DlHarqRlcPduListBuffer_t> (params.m_rnti, dlHarqRlcPdu));
-      m_ulHarqCurrentProcessId.insert (std::pair <uint16_t,uint8_t > (params.m_rnti, 0));
-      UlHarqProcessesStatus_t ulHarqPrcStatus;
-      ulHarqPrcStatus.resize (8,0);
-      m_ulHarqProcessesStatus.insert (std::pair <uint16_t, UlHarqProcessesStatus_t> (params.m_rnti, ulHarqPrcStatus));
-      UlHarqProcessesDciBuffer_t ulHarqdci;
-      ulHarqdci.resize (8);
-      m_ulHarqProcessesDciBuffer.insert (std::pair <uint16_t, UlHarqProcessesDciBuffer_t> (params.m_rnti, ulHarqdci));
+      slot = AddUe (params.m_rnti);
     }
-  else
+  m_uesTxMode.at (slot) = params.m_transmissionMode;
+  return;
+}
+
+uint32_t
+RrFfMacScheduler::AddUe (uint16_t rnti)
+{
+  uint32_t slot = m_ues.AddUe (rnti);
+  uint32_t nSlots = m_ues.GetNSlots ();
+  if (m_uesTxMode.size () < nSlots)
     {
-      (*it).second = params.m_transmissionMode;
+      m_uesTxMode.resize (nSlots);
+      m_dlHarqCurrentProcessId.resize (nSlots);
+      m_dlHarqProcessesStatus.resize (nSlots * HARQ_PROC_NUM);
+      m_dlHarqProcessesTimer.resize (nSlots * HARQ_PROC_NUM);
+      m_dlHarqProcessesDciBuffer.resize (nSlots);
+      m_dlHarqProcessesRlcPduListBuffer.resize (nSlots);
+      m_ulHarqCurrentProcessId.resize (nSlots);
+      m_ulHarqProcessesStatus.resize (nSlots * HARQ_PROC_NUM);
+      m_ulHarqProcessesDciBuffer.resize (nSlots);
+      m_p10CqiTimers.resize (nSlots);
     }
-  return;
+  // generate HARQ buffers, reusing those of the previous UE of the slot
+  m_dlHarqCurrentProcessId.at (slot) = 0;
+  m_ulHarqCurrentProcessId.at (slot) = 0;
+  for (uint16_t i = 0; i < HARQ_PROC_NUM; i++)
+    {
+      m_dlHarqProcessesStatus.at (slot * HARQ_PROC_NUM + i) = 0;
+      m_dlHarqProcessesTimer.at (slot * HARQ_PROC_NUM + i) = 0;
+      m_ulHarqProcessesStatus.at (slot * HARQ_PROC_NUM + i) = 0;
+    }
+  m_dlHarqProcessesDciBuffer.at (slot).assign (HARQ_PROC_NUM, DlDciListElement_s ());
+  DlHarqRlcPduListBuffer_t& dlHarqRlcPdu = m_dlHarqProcessesRlcPduListBuffer.at (slot);
+  dlHarqRlcPdu.resize (2);
+  for (uint16_t layer = 0; layer < 2; layer++)
+    {
+      dlHarqRlcPdu.at (layer).resize (HARQ_PROC_NUM);
+      for (uint16_t i = 0; i < HARQ_PROC_NUM; i++)
+        {
+          dlHarqRlcPdu.at (layer).at (i).clear ();
+        }
+    }
+  m_ulHarqProcessesDciBuffer.at (slot).assign (HARQ_PROC_NUM, UlDciListElement_s ());
+  return slot;
+}
+
+uint32_t
+RrFfMacScheduler::GetUeSlot (uint16_t rnti) const
+{
+  uint32_t slot = m_ues.GetSlot (rnti);
+  if (slot == FfMacSchedulerUeTable::NO_SLOT)
+    {
+      NS_FATAL_ERROR ("No info found for this RNTI " << rnti);
+    }
+  return slot;
 }
 
 void
@@ -397,16 +427,13 @@ RrFfMacScheduler::DoCschedUeReleaseReq (const struct FfMacCschedSapProvider::Csc
 {
   NS_LOG_FUNCTION (this << " Release RNTI " << params.m_rnti);
   
-  m_uesTxMode.erase (params.m_rnti);
-  m_dlHarqCurrentProcessId.erase (params.m_rnti);
-  m_dlHarqProcessesStatus.erase  (params.m_rnti);
-  m_dlHarqProcessesTimer.erase (params.m_rnti);
-  m_dlHarqProcessesDciBuffer.erase  (params.m_rnti);
-  m_dlHarqProcessesRlcPduListBuffer.erase  (params.m_rnti);
-  m_ulHarqCurrentProcessId.erase  (params.m_rnti);
-  m_ulHarqProcessesStatus.erase  (params.m_rnti);
-  m_ulHarqProcessesDciBuffer.erase  (params.m_rnti);
-  m_ceBsrRxed.erase (params.m_rnti);
+  uint32_t slot = m_ues.RemoveUe (params.m_rnti);
+  if (slot != FfMacSchedulerUeTable::NO_SLOT)
+    {
+      // the HARQ buffers are reset when the slot is reused
+      m_p10CqiRxed.Reset (slot);
+      m_ceBsrRxed.Reset (slot);
+    }
   std::list<FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it = m_rlcBufferReq.begin ();
   while (it != m_rlcBufferReq.end ())
     {
@@ -460,9 +487,17 @@ RrFfMacScheduler::DoSchedDlRlcBufferReq (const struct FfMacSchedSapProvider::Sch
   // initialize statistics of the flow in case of new flows
   if (newLc == true)
     {
-      m_p10CqiRxed.insert ( std::pair<uint16_t, uint8_t > (params.m_rnti, 1)); // only codeword 0 at this stage (SISO)
-      // initialized to 1 (i.e., the lowest value for transmitting a signal)
-      m_p10CqiTimers.insert ( std::pair<uint16_t, uint32_t > (params.m_rnti, m_cqiTimersThreshold));
+      uint32_t slot = m_ues.GetSlot (params.m_rnti);
+      if (slot == FfMacSchedulerUeTable::NO_SLOT)
+        {
+          NS_LOG_ERROR (this << " RLC buffer report of unknown RNTI " << params.m_rnti);
+        }
+      else if (!m_p10CqiRxed.Has (slot))
+        {
+          m_p10CqiRxed.Set (slot, 1); // only codeword 0 at this stage (SISO)
+          // initialized to 1 (i.e., the lowest value for transmitting a signal)
+          m_p10CqiTimers[slot] = m_cqiTimersThreshold;
+        }
     }
 
   return;
@@ -510,23 +545,16 @@ RrFfMacScheduler::HarqProcessAvailability (uint16_t rnti)
 {
   NS_LOG_FUNCTION (this << rnti);
 
-  std::map <uint16_t, uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
-  if (it == m_dlHarqCurrentProcessId.end ())
-    {
-      NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
-    }
-  std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
-  if (itStat == m_dlHarqProcessesStatus.end ())
-    {
-      NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
-    }
-  uint8_t i = (*it).second;
+  uint32_t slot = GetUeSlot (rnti);
+  uint8_t current = m_dlHarqCurrentProcessId[slot];
+  const uint8_t *status = &m_dlHarqProcessesStatus[slot * HARQ_PROC_NUM];
+  uint8_t i = current;
   do
     {
       i = (i + 1) % HARQ_PROC_NUM;
     }
-  while ( ((*itStat).second.at (i) != 0)&&(i != (*it).second));
-  if ((*itStat).second.at (i) == 0)
+  while ((status[i] != 0)&&(i != current));
+  if (status[i] == 0)
     {
       return (true);
     }
@@ -549,33 +577,26 @@ RrFfMacScheduler::UpdateHarqProcessId (uint16_t rnti)
       return (0);
     }
 
-  std::map <uint16_t, uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
-  if (it == m_dlHarqCurrentProcessId.end ())
-    {
-      NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
-    }
-  std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
-  if (itStat == m_dlHarqProcessesStatus.end ())
-    {
-      NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
-    }
-  uint8_t i = (*it).second;
+  uint32_t slot = GetUeSlot (rnti);
+  uint8_t& current = m_dlHarqCurrentProcessId[slot];
+  uint8_t *status = &m_dlHarqProcessesStatus[slot * HARQ_PROC_NUM];
+  uint8_t i = current;
   do
     {
       i = (i + 1) % HARQ_PROC_NUM;
     }
-  while ( ((*itStat).second.at (i) != 0)&&(i != (*it).second));
-  if ((*itStat).second.at (i) == 0)
+  while ((status[i] != 0)&&(i != current));
+  if (status[i] == 0)
     {
-      (*it).second = i;
-      (*itStat).second.at (i) = 1;
+      current = i;
+      status[i] = 1;
     }
   else
     {
       return (9); // return a not valid harq proc id
     }
 
-  return ((*it).second);
+  return (current);
 }
 
 
@@ -584,27 +605,23 @@ RrFfMacScheduler::RefreshHarqProcesses ()
 {
   NS_LOG_FUNCTION (this);
 
-  std::map <uint16_t, DlHarqProcessesTimer_t>::iterator itTimers;
-  for (itTimers = m_dlHarqProcessesTimer.begin (); itTimers != m_dlHarqProcessesTimer.end (); itTimers ++)
+  for (uint32_t u = 0; u < m_ues.GetNUes (); u++)
     {
+      uint32_t slot = m_ues.GetUeSlot (u);
+      uint8_t *timers = &m_dlHarqProcessesTimer[slot * HARQ_PROC_NUM];
       for (uint16_t i = 0; i < HARQ_PROC_NUM; i++)
         {
-          if ((*itTimers).second.at (i) == HARQ_DL_TIMEOUT)
+          if (timers[i] == HARQ_DL_TIMEOUT)
             {
               // reset HARQ process
 
-              NS_LOG_INFO (this << " Reset HARQ proc " << i << " for RNTI " << (*itTimers).first);
-              std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find ((*itTimers).first);
-              if (itStat == m_dlHarqProcessesStatus.end ())
-                {
-                  NS_FATAL_ERROR ("No Process Id Status found for this RNTI " << (*itTimers).first);
-                }
-              (*itStat).second.at (i) = 0;
-              (*itTimers).second.at (i) = 0;
+              NS_LOG_INFO (this << " Reset HARQ proc " << i << " for RNTI " << m_ues.GetRnti (slot));
+              m_dlHarqProcessesStatus[slot * HARQ_PROC_NUM + i] = 0;
+              timers[i] = 0;
             }
           else
             {
-              (*itTimers).second.at (i)++;
+              timers[i]++;
             }
         }
     }
@@ -631,10 +648,10 @@ RrFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
   rbgMap.resize (m_cschedCellConfig.m_dlBandwidth / rbgSize, false);
 
   //   update UL HARQ proc id
-  std::map <uint16_t, uint8_t>::iterator itProcId;
-  for (itProcId = m_ulHarqCurrentProcessId.begin (); itProcId != m_ulHarqCurrentProcessId.end (); itProcId++)
+  for (uint32_t u = 0; u < m_ues.GetNUes (); u++)
     {
-      (*itProcId).second = ((*itProcId).second + 1) % HARQ_PROC_NUM;
+      uint8_t& procId = m_ulHarqCurrentProcessId[m_ues.GetUeSlot (u)];
+      procId = (procId + 1) % HARQ_PROC_NUM;
     }
 
   // RACH Allocation
@@ -700,19 +717,13 @@ RrFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
           uldci.m_pdcchPowerOffset = 0; // not used
 
           uint8_t harqId = 0;
-          std::map <uint16_t, uint8_t>::iterator itProcId;
-          itProcId = m_ulHarqCurrentProcessId.find (uldci.m_rnti);
-          if (itProcId == m_ulHarqCurrentProcessId.end ())
+          uint32_t slot = m_ues.GetSlot (uldci.m_rnti);
+          if (slot == FfMacSchedulerUeTable::NO_SLOT)
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << uldci.m_rnti);
             }
-          harqId = (*itProcId).second;
-          std::map <uint16_t, UlHarqProcessesDciBuffer_t>::iterator itDci = m_ulHarqProcessesDciBuffer.find (uldci.m_rnti);
-          if (itDci == m_ulHarqProcessesDciBuffer.end ())
-            {
-              NS_FATAL_ERROR ("Unable to find RNTI entry in UL DCI HARQ buffer for RNTI " << uldci.m_rnti);
-            }
-          (*itDci).second.at (harqId) = uldci;
+          harqId = m_ulHarqCurrentProcessId[slot];
+          m_ulHarqProcessesDciBuffer[slot].at (harqId) = uldci;
         }
 
       rbStart = rbStart + rbLen;
@@ -771,13 +782,15 @@ RrFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
           uint16_t rnti = m_dlInfoListBuffered.at (i).m_rnti;
           uint8_t harqId = m_dlInfoListBuffered.at (i).m_harqProcessId;
           NS_LOG_INFO (this << " HARQ retx RNTI " << rnti << " harqId " << (uint16_t)harqId);
-          std::map <uint16_t, DlHarqProcessesDciBuffer_t>::iterator itHarq = m_dlHarqProcessesDciBuffer.find (rnti);
-          if (itHarq == m_dlHarqProcessesDciBuffer.end ())
+          uint32_t slot = m_ues.GetSlot (rnti);
+          if (slot == FfMacSchedulerUeTable::NO_SLOT)
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << rnti);
             }
+          DlHarqProcessesDciBuffer_t& harqDci = m_dlHarqProcessesDciBuffer[slot];
+          DlHarqRlcPduListBuffer_t& harqRlcPdu = m_dlHarqProcessesRlcPduListBuffer[slot];
 
-          DlDciListElement_s dci = (*itHarq).second.at (harqId);
+          DlDciListElement_s dci = harqDci.at (harqId);
           int rv = 0;
           if (dci.m_rv.size () == 1)
             {
@@ -792,20 +805,10 @@ RrFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
             {
               // maximum number of retx reached -> drop process
               NS_LOG_INFO ("Max number of retransmissions reached -> drop process");
-              std::map <uint16_t, DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (rnti);
-              if (it == m_dlHarqProcessesStatus.end ())
-                {
-                  NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << m_dlInfoListBuffered.at (i).m_rnti);
-                }
-              (*it).second.at (harqId) = 0;
-              std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
-              if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
+              m_dlHarqProcessesStatus[slot * HARQ_PROC_NUM + harqId] = 0;
+              for (uint16_t k = 0; k < harqRlcPdu.size (); k++)
                 {
-                  NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << m_dlInfoListBuffered.at (i).m_rnti);
-                }
-              for (uint16_t k = 0; k < (*itRlcPdu).second.size (); k++)
-                {
-                  (*itRlcPdu).second.at (k).at (harqId).clear ();
+                  harqRlcPdu.at (k).at (harqId).clear ();
                 }
               continue;
             }
@@ -884,11 +887,6 @@ RrFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
             }
           // retrieve RLC PDU list for retx TBsize and update DCI
           BuildDataListElement_s newEl;
-          std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
-          if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
-            {
-              NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << rnti);
-            }
           for (uint8_t j = 0; j < nLayers; j++)
             {
               if (retx.at (j))
@@ -907,7 +905,7 @@ RrFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
                     {
                       dci.m_ndi.at (j) = 0;
                       dci.m_rv.at (j)++;
-                      (*itHarq).second.at (harqId).m_rv.at (j)++;
+                      harqDci.at (harqId).m_rv.at (j)++;
                       NS_LOG_INFO (this << " layer " << (uint16_t)j << " RV " << (uint16_t)dci.m_rv.at (j));
                     }
                 }
@@ -922,7 +920,7 @@ RrFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
                 }
             }
 
-          for (uint16_t k = 0; k < (*itRlcPdu).second.at (0).at (dci.m_harqProcess).size (); k++)
+          for (uint16_t k = 0; k < harqRlcPdu.at (0).at (dci.m_harqProcess).size (); k++)
             {
               std::vector <struct RlcPduListElement_s> rlcPduListPerLc;
               for (uint8_t j = 0; j < nLayers; j++)
@@ -931,7 +929,7 @@ RrFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
                     {
                       if (j < dci.m_ndi.size ())
                         {
-                          rlcPduListPerLc.push_back ((*itRlcPdu).second.at (j).at (dci.m_harqProcess).at (k));
+                          rlcPduListPerLc.push_back (harqRlcPdu.at (j).at (dci.m_harqProcess).at (k));
                         }
                     }
                 }
@@ -943,14 +941,9 @@ RrFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
             }
           newEl.m_rnti = rnti;
           newEl.m_dci = dci;
-          (*itHarq).second.at (harqId).m_rv = dci.m_rv;
+          harqDci.at (harqId).m_rv = dci.m_rv;
           // refresh timer
-          std::map <uint16_t, DlHarqProcessesTimer_t>::iterator itHarqTimer = m_dlHarqProcessesTimer.find (rnti);
-          if (itHarqTimer== m_dlHarqProcessesTimer.end ())
-            {
-              NS_FATAL_ERROR ("Unable to find HARQ timer for RNTI " << (uint16_t)rnti);
-            }
-          (*itHarqTimer).second.at (harqId) = 0;
+          m_dlHarqProcessesTimer[slot * HARQ_PROC_NUM + harqId] = 0;
           ret.m_buildDataList.push_back (newEl);
           rntiAllocated.insert (rnti);
         }
@@ -958,20 +951,17 @@ RrFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
         {
           // update HARQ process status
           NS_LOG_INFO (this << " HARQ ACK UE " << m_dlInfoListBuffered.at (i).m_rnti);
-          std::map <uint16_t, DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (m_dlInfoListBuffered.at (i).m_rnti);
-          if (it == m_dlHarqProcessesStatus.end ())
+          uint32_t slot = m_ues.GetSlot (m_dlInfoListBuffered.at (i).m_rnti);
+          if (slot == FfMacSchedulerUeTable::NO_SLOT)
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << m_dlInfoListBuffered.at (i).m_rnti);
             }
-          (*it).second.at (m_dlInfoListBuffered.at (i).m_harqProcessId) = 0;
-          std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (m_dlInfoListBuffered.at (i).m_rnti);
-          if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
-            {
-              NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << m_dlInfoListBuffered.at (i).m_rnti);
-            }
-          for (uint16_t k = 0; k < (*itRlcPdu).second.size (); k++)
+          uint8_t harqId = m_dlInfoListBuffered.at (i).m_harqProcessId;
+          m_dlHarqProcessesStatus[slot * HARQ_PROC_NUM + harqId] = 0;
+          DlHarqRlcPduListBuffer_t& harqRlcPdu = m_dlHarqProcessesRlcPduListBuffer[slot];
+          for (uint16_t k = 0; k < harqRlcPdu.size (); k++)
             {
-              (*itRlcPdu).second.at (k).at (m_dlInfoListBuffered.at (i).m_harqProcessId).clear ();
+              harqRlcPdu.at (k).at (harqId).clear ();
             }
         }
     }
@@ -1007,11 +997,11 @@ RrFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
 
         {
           NS_LOG_LOGIC (this << " User " << (*it).m_rnti << " LC " << (uint16_t)(*it).m_logicalChannelIdentity << " is active, status  " << (*it).m_rlcStatusPduSize << " retx " << (*it).m_rlcRetransmissionQueueSize << " tx " << (*it).m_rlcTransmissionQueueSize);
-          std::map <uint16_t,uint8_t>::iterator itCqi = m_p10CqiRxed.find ((*it).m_rnti);
+          uint32_t slot = GetUeSlot ((*it).m_rnti);
           uint8_t cqi = 0;
-          if (itCqi != m_p10CqiRxed.end ())
+          if (m_p10CqiRxed.Has (slot))
             {
-              cqi = (*itCqi).second;
+              cqi = m_p10CqiRxed.Get (slot);
             }
           else
             {
@@ -1085,7 +1075,6 @@ RrFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
       it = m_rlcBufferReq.begin ();
       m_nextRntiDl = (*it).m_rnti;
     }
-  std::map <uint16_t,uint8_t>::iterator itTxMode;
   do
     {
       itLcRnti = lcActivesPerRnti.find ((*it).m_rnti);
@@ -1109,12 +1098,12 @@ RrFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
             }
           continue;
         }
-      itTxMode = m_uesTxMode.find ((*it).m_rnti);
-      if (itTxMode == m_uesTxMode.end ())
+      uint32_t slot = m_ues.GetSlot ((*it).m_rnti);
+      if (slot == FfMacSchedulerUeTable::NO_SLOT)
         {
           NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).m_rnti);
         }
-      int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
+      int nLayer = TransmissionModesLayers::TxMode2LayerNum (m_uesTxMode[slot]);
       int lcNum = (*itLcRnti).second;
       // create new BuildDataListElement_s for this RNTI
       BuildDataListElement_s newEl;
@@ -1125,16 +1114,15 @@ RrFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
       newDci.m_harqProcess = UpdateHarqProcessId ((*it).m_rnti);
       newDci.m_resAlloc = 0;
       newDci.m_rbBitmap = 0;
-      std::map <uint16_t,uint8_t>::iterator itCqi = m_p10CqiRxed.find (newEl.m_rnti);
       for (uint8_t i = 0; i < nLayer; i++)
         {
-          if (itCqi == m_p10CqiRxed.end ())
+          if (!m_p10CqiRxed.Has (slot))
             {
               newDci.m_mcs.push_back (0); // no info on this user -> lowest MCS
             }
           else
             {
-              newDci.m_mcs.push_back ( m_amc->GetMcsFromCqi ((*itCqi).second) );
+              newDci.m_mcs.push_back ( m_amc->GetMcsFromCqi (m_p10CqiRxed.Get (slot)) );
             }
         }
       int tbSize = (m_amc->GetTbSizeFromMcs (newDci.m_mcs.at (0), rbgPerTb * rbgSize) / 8);
@@ -1158,12 +1146,7 @@ RrFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
                   if (m_harqOn == true)
                     {
                       // store RLC PDU list for HARQ
-                      std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find ((*it).m_rnti);
-                      if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
-                        {
-                          NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << (*it).m_rnti);
-                        }
-                      (*itRlcPdu).second.at (j).at (newDci.m_harqProcess).push_back (newRlcEl);
+                      m_dlHarqProcessesRlcPduListBuffer[slot].at (j).at (newDci.m_harqProcess).push_back (newRlcEl);
                     }
 
                 }
@@ -1209,19 +1192,9 @@ RrFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
       if (m_harqOn == true)
         {
           // store DCI for HARQ
-          std::map <uint16_t, DlHarqProcessesDciBuffer_t>::iterator itDci = m_dlHarqProcessesDciBuffer.find (newEl.m_rnti);
-          if (itDci == m_dlHarqProcessesDciBuffer.end ())
-            {
-              NS_FATAL_ERROR ("Unable to find RNTI entry in DCI HARQ buffer for RNTI " << newEl.m_rnti);
-            }
-          (*itDci).second.at (newDci.m_harqProcess) = newDci;
+          m_dlHarqProcessesDciBuffer[slot].at (newDci.m_harqProcess) = newDci;
           // refresh timer
-          std::map <uint16_t, DlHarqProcessesTimer_t>::iterator itHarqTimer =  m_dlHarqProcessesTimer.find (newEl.m_rnti);
-          if (itHarqTimer== m_dlHarqProcessesTimer.end ())
-            {
-              NS_FATAL_ERROR ("Unable to find HARQ timer for RNTI " << (uint16_t)newEl.m_rnti);
-            }
-          (*itHarqTimer).second.at (newDci.m_harqProcess) = 0;
+          m_dlHarqProcessesTimer[slot * HARQ_PROC_NUM + newDci.m_harqProcess] = 0;
         }
       // ...more parameters -> ignored in this version
 
@@ -1255,31 +1228,21 @@ RrFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::Sched
 {
   NS_LOG_FUNCTION (this);
 
-  std::map <uint16_t,uint8_t>::iterator it;
   for (unsigned int i = 0; i < params.m_cqiList.size (); i++)
     {
       if ( params.m_cqiList.at (i).m_cqiType == CqiListElement_s::P10 )
         {
           NS_LOG_LOGIC ("wideband CQI " <<  (uint32_t) params.m_cqiList.at (i).m_wbCqi.at (0) << " reported");
-          std::map <uint16_t,uint8_t>::iterator it;
           uint16_t rnti = params.m_cqiList.at (i).m_rnti;
-          it = m_p10CqiRxed.find (rnti);
-          if (it == m_p10CqiRxed.end ())
-            {
-              // create the new entry
-              m_p10CqiRxed.insert ( std::pair<uint16_t, uint8_t > (rnti, params.m_cqiList.at (i).m_wbCqi.at (0)) ); // only codeword 0 at this stage (SISO)
-              // generate correspondent timer
-              m_p10CqiTimers.insert ( std::pair<uint16_t, uint32_t > (rnti, m_cqiTimersThreshold));
-            }
-          else
+          uint32_t slot = m_ues.GetSlot (rnti);
+          if (slot == FfMacSchedulerUeTable::NO_SLOT)
             {
-              // update the CQI value
-              (*it).second = params.m_cqiList.at (i).m_wbCqi.at (0);
-              // update correspondent timer
-              std::map <uint16_t,uint32_t>::iterator itTimers;
-              itTimers = m_p10CqiTimers.find (rnti);
-              (*itTimers).second = m_cqiTimersThreshold;
+              NS_LOG_ERROR (this << " CQI of unknown RNTI " << rnti);
+              continue;
             }
+          // store the CQI value and refresh correspondent timer
+          m_p10CqiRxed.Set (slot, params.m_cqiList.at (i).m_wbCqi.at (0)); // only codeword 0 at this stage (SISO)
+          m_p10CqiTimers[slot] = m_cqiTimersThreshold;
         }
       else if ( params.m_cqiList.at (i).m_cqiType == CqiListElement_s::A30 )
         {
@@ -1334,25 +1297,19 @@ RrFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sched
             {
               // retx correspondent block: retrieve the UL-DCI
               uint16_t rnti = params.m_ulInfoList.at (i).m_rnti;
-              std::map <uint16_t, uint8_t>::iterator itProcId = m_ulHarqCurrentProcessId.find (rnti);
-              if (itProcId == m_ulHarqCurrentProcessId.end ())
+              uint32_t slot = m_ues.GetSlot (rnti);
+              if (slot == FfMacSchedulerUeTable::NO_SLOT)
                 {
                   NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << rnti);
+                  continue;
                 }
-              uint8_t harqId = (uint8_t)((*itProcId).second - HARQ_PERIOD) % HARQ_PROC_NUM;
+              uint8_t procId = m_ulHarqCurrentProcessId[slot];
+              uint8_t harqId = (uint8_t)(procId - HARQ_PERIOD) % HARQ_PROC_NUM;
               NS_LOG_INFO (this << " UL-HARQ retx RNTI " << rnti << " harqId " << (uint16_t)harqId);
-              std::map <uint16_t, UlHarqProcessesDciBuffer_t>::iterator itHarq = m_ulHarqProcessesDciBuffer.find (rnti);
-              if (itHarq == m_ulHarqProcessesDciBuffer.end ())
-                {
-                  NS_LOG_ERROR ("No info find in UL-HARQ buffer for UE (might change eNB) " << rnti);
-                }
-              UlDciListElement_s dci = (*itHarq).second.at (harqId);
-              std::map <uint16_t, UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (rnti);
-              if (itStat == m_ulHarqProcessesStatus.end ())
-                {
-                  NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << rnti);
-                }
-              if ((*itStat).second.at (harqId) > 3)
+              UlHarqProcessesDciBuffer_t& harqDci = m_ulHarqProcessesDciBuffer[slot];
+              UlDciListElement_s dci = harqDci.at (harqId);
+              uint8_t *status = &m_ulHarqProcessesStatus[slot * HARQ_PROC_NUM];
+              if (status[harqId] > 3)
                 {
                   NS_LOG_INFO ("Max number of retransmissions reached (UL)-> drop process");
                   continue;
@@ -1376,7 +1333,7 @@ RrFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sched
                       NS_LOG_INFO ("\tRB " << j);
                       rbAllocatedNum++;
                     }
-                  NS_LOG_INFO (this << " Send retx in the same RBGs " << (uint16_t)dci.m_rbStart << " to " << dci.m_rbStart + dci.m_rbLen << " RV " << (*itStat).second.at (harqId) + 1);
+                  NS_LOG_INFO (this << " Send retx in the same RBGs " << (uint16_t)dci.m_rbStart << " to " << dci.m_rbStart + dci.m_rbLen << " RV " << status[harqId] + 1);
                 }
               else
                 {
@@ -1385,24 +1342,35 @@ RrFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sched
                 }
               dci.m_ndi = 0;
               // Update HARQ buffers with new HarqId
-              (*itStat).second.at ((*itProcId).second) = (*itStat).second.at (harqId) + 1;
-              (*itStat).second.at (harqId) = 0;
-              (*itHarq).second.at ((*itProcId).second) = dci;
+              status[procId] = status[harqId] + 1;
+              status[harqId] = 0;
+              harqDci.at (procId) = dci;
               ret.m_dciList.push_back (dci);
               rntiAllocated.insert (dci.m_rnti);
             }
         }
     }
 
-  std::map <uint16_t,uint32_t>::iterator it;
+  // the UEs with a buffer status report, in RNTI order
+  m_ulUes.clear ();
+  for (uint32_t u = 0; u < m_ues.GetNUes (); u++)
+    {
+      if (m_ceBsrRxed.Has (m_ues.GetUeSlot (u)))
+        {
+          m_ulUes.push_back (m_ues.GetUeSlot (u));
+        }
+    }
+
+  uint32_t pos;
   int nflows = 0;
 
-  for (it = m_ceBsrRxed.begin (); it != m_ceBsrRxed.end (); it++)
+  for (pos = 0; pos < m_ulUes.size (); pos++)
     {
-      std::set <uint16_t>::iterator itRnti = rntiAllocated.find ((*it).first);
+      uint16_t rnti = m_ues.GetRnti (m_ulUes[pos]);
+      std::set <uint16_t>::iterator itRnti = rntiAllocated.find (rnti);
       // select UEs with queues not empty and not yet allocated for HARQ
-      NS_LOG_INFO (this << " UE " << (*it).first << " queue " << (*it).second);
-      if (((*it).second > 0)&&(itRnti == rntiAllocated.end ()))
+      NS_LOG_INFO (this << " UE " << rnti << " queue " << m_ceBsrRxed.Get (m_ulUes[pos]));
+      if ((m_ceBsrRxed.Get (m_ulUes[pos]) > 0)&&(itRnti == rntiAllocated.end ()))
         {
           nflows++;
         }
@@ -1429,35 +1397,38 @@ RrFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sched
 
   if (m_nextRntiUl != 0)
     {
-      for (it = m_ceBsrRxed.begin (); it != m_ceBsrRxed.end (); it++)
+      for (pos = 0; pos < m_ulUes.size (); pos++)
         {
-          if ((*it).first == m_nextRntiUl)
+          if (m_ues.GetRnti (m_ulUes[pos]) == m_nextRntiUl)
             {
               break;
             }
         }
-      if (it == m_ceBsrRxed.end ())
+      if (pos == m_ulUes.size ())
         {
           NS_LOG_ERROR (this << " no user found");
+          pos = 0;
         }
     }
   else
     {
-      it = m_ceBsrRxed.begin ();
-      m_nextRntiUl = (*it).first;
+      pos = 0;
+      m_nextRntiUl = m_ues.GetRnti (m_ulUes[pos]);
     }
   NS_LOG_INFO (this << " NFlows " << nflows << " RB per Flow " << rbPerFlow);
   do
     {
-      std::set <uint16_t>::iterator itRnti = rntiAllocated.find ((*it).first);
-      if ((itRnti != rntiAllocated.end ())||((*it).second == 0))
+      uint32_t slot = m_ulUes[pos];
+      uint16_t rnti = m_ues.GetRnti (slot);
+      std::set <uint16_t>::iterator itRnti = rntiAllocated.find (rnti);
+      if ((itRnti != rntiAllocated.end ())||(m_ceBsrRxed.Get (slot) == 0))
         {
           // UE already allocated for UL-HARQ -> skip it
-          it++;
-          if (it == m_ceBsrRxed.end ())
+          pos++;
+          if (pos == m_ulUes.size ())
             {
               // restart from the first
-              it = m_ceBsrRxed.begin ();
+              pos = 0;
             }
           continue;
         }
@@ -1472,9 +1443,9 @@ RrFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sched
               rbPerFlow = 0;      
             }
         }
-      NS_LOG_INFO (this << " try to allocate " << (*it).first);
+      NS_LOG_INFO (this << " try to allocate " << rnti);
       UlDciListElement_s uldci;
-      uldci.m_rnti = (*it).first;
+      uldci.m_rnti = rnti;
       uldci.m_rbLen = rbPerFlow;
       bool allocated = false;
       NS_LOG_INFO (this << " RB Allocated " << rbAllocated << " rbPerFlow " << rbPerFlow << " flows " << nflows);
@@ -1498,7 +1469,7 @@ RrFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sched
                 {
                   rbMap.at (j) = true;
                   // store info on allocation for managing ul-cqi interpretation
-                  rbgAllocationMap.at (j) = (*it).first;
+                  rbgAllocationMap.at (j) = rnti;
                   NS_LOG_INFO ("\t " << j);
                 }
               rbAllocated += rbPerFlow;
@@ -1521,7 +1492,7 @@ RrFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sched
       if (!allocated)
         {
           // unable to allocate new resource: finish scheduling
-          m_nextRntiUl = (*it).first;
+          m_nextRntiUl = rnti;
           if (ret.m_dciList.size () > 0)
             {
               m_schedSapUser->SchedUlConfigInd (ret);
@@ -1529,13 +1500,13 @@ RrFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sched
           m_allocationMaps.insert (std::pair <uint16_t, std::vector <uint16_t> > (params.m_sfnSf, rbgAllocationMap));
           return;
         }
-      std::map <uint16_t, std::vector <double> >::iterator itCqi = m_ueCqi.find ((*it).first);
+      std::map <uint16_t, std::vector <double> >::iterator itCqi = m_ueCqi.find (rnti);
       int cqi = 0;
       if (itCqi == m_ueCqi.end ())
         {
           // no cqi info about this UE
           uldci.m_mcs = 0; // MCS 0 -> UL-AMC TBD
-          NS_LOG_INFO (this << " UE does not have ULCQI " << (*it).first );
+          NS_LOG_INFO (this << " UE does not have ULCQI " << rnti );
         }
       else
         {
@@ -1557,11 +1528,11 @@ RrFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sched
           cqi = m_amc->GetCqiFromSpectralEfficiency (s);
           if (cqi == 0)
             {
-              it++;
-              if (it == m_ceBsrRxed.end ())
+              pos++;
+              if (pos == m_ulUes.size ())
                 {
                   // restart from the first
-                  it = m_ceBsrRxed.begin ();
+                  pos = 0;
                 }
               NS_LOG_DEBUG (this << " UE discared for CQI=0, RNTI " << uldci.m_rnti);
               // remove UE from allocation map
@@ -1593,44 +1564,28 @@ RrFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sched
       uint8_t harqId = 0;
       if (m_harqOn == true)
         {
-          std::map <uint16_t, uint8_t>::iterator itProcId;
-          itProcId = m_ulHarqCurrentProcessId.find (uldci.m_rnti);
-          if (itProcId == m_ulHarqCurrentProcessId.end ())
-            {
-              NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << uldci.m_rnti);
-            }
-          harqId = (*itProcId).second;
-          std::map <uint16_t, UlHarqProcessesDciBuffer_t>::iterator itDci = m_ulHarqProcessesDciBuffer.find (uldci.m_rnti);
-          if (itDci == m_ulHarqProcessesDciBuffer.end ())
-            {
-              NS_FATAL_ERROR ("Unable to find RNTI entry in UL DCI HARQ buffer for RNTI " << uldci.m_rnti);
-            }
-          (*itDci).second.at (harqId) = uldci;
+          harqId = m_ulHarqCurrentProcessId[slot];
+          m_ulHarqProcessesDciBuffer[slot].at (harqId) = uldci;
           // Update HARQ process status (RV 0)
-          std::map <uint16_t, UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (uldci.m_rnti);
-          if (itStat == m_ulHarqProcessesStatus.end ())
-            {
-              NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << uldci.m_rnti);
-            }
-          (*itStat).second.at (harqId) = 0;
+          m_ulHarqProcessesStatus[slot * HARQ_PROC_NUM + harqId] = 0;
         }
         
-      NS_LOG_INFO (this << " UL Allocation - UE " << (*it).first << " startPRB " << (uint32_t)uldci.m_rbStart << " nPRB " << (uint32_t)uldci.m_rbLen << " CQI " << cqi << " MCS " << (uint32_t)uldci.m_mcs << " TBsize " << uldci.m_tbSize << " harqId " << (uint16_t)harqId);
+      NS_LOG_INFO (this << " UL Allocation - UE " << rnti << " startPRB " << (uint32_t)uldci.m_rbStart << " nPRB " << (uint32_t)uldci.m_rbLen << " CQI " << cqi << " MCS " << (uint32_t)uldci.m_mcs << " TBsize " << uldci.m_tbSize << " harqId " << (uint16_t)harqId);
 
-      it++;
-      if (it == m_ceBsrRxed.end ())
+      pos++;
+      if (pos == m_ulUes.size ())
         {
           // restart from the first
-          it = m_ceBsrRxed.begin ();
+          pos = 0;
         }
       if ((rbAllocated == m_cschedCellConfig.m_ulBandwidth) || (rbPerFlow == 0))
         {
           // Stop allocation: no more PRBs
-          m_nextRntiUl = (*it).first;
+          m_nextRntiUl = m_ues.GetRnti (m_ulUes[pos]);
           break;
         }
     }
-  while (((*it).first != m_nextRntiUl)&&(rbPerFlow!=0));
+  while ((m_ues.GetRnti (m_ulUes[pos]) != m_nextRntiUl)&&(rbPerFlow!=0));
 
   m_allocationMaps.insert (std::pair <uint16_t, std::vector <uint16_t> > (params.m_sfnSf, rbgAllocationMap));
 
@@ -1657,8 +1612,6 @@ RrFfMacScheduler::DoSchedUlMacCtrlInfoReq (const struct FfMacSchedSapProvider::S
 {
   NS_LOG_FUNCTION (this);
 
-  std::map <uint16_t,uint32_t>::iterator it;
-
   for (unsigned int i = 0; i < params.m_macCeList.size (); i++)
     {
       if ( params.m_macCeList.at (i).m_macCeType == MacCeListElement_s::BSR )
@@ -1678,19 +1631,14 @@ RrFfMacScheduler::DoSchedUlMacCtrlInfoReq (const struct FfMacSchedSapProvider::S
             }
 
           uint16_t rnti = params.m_macCeList.at (i).m_rnti;
-          it = m_ceBsrRxed.find (rnti);
-          if (it == m_ceBsrRxed.end ())
-            {
-              // create the new entry
-              m_ceBsrRxed.insert ( std::pair<uint16_t, uint32_t > (rnti, buffer));
-              NS_LOG_INFO (this << " Insert RNTI " << rnti << " queue " << buffer);
-            }
-          else
+          uint32_t slot = m_ues.GetSlot (rnti);
+          if (slot == FfMacSchedulerUeTable::NO_SLOT)
             {
-              // update the buffer size value
-              (*it).second = buffer;
-              NS_LOG_INFO (this << " Update RNTI " << rnti << " queue " << buffer);
+              NS_LOG_ERROR (this << " BSR of unknown RNTI " << rnti);
+              continue;
             }
+          NS_LOG_INFO (this << " Update RNTI " << rnti << " queue " << buffer);
+          m_ceBsrRxed.Set (slot, buffer);
         }
     }
 
@@ -1848,26 +1796,23 @@ void
 RrFfMacScheduler::RefreshDlCqiMaps (void)
 {
   NS_LOG_FUNCTION (this << m_p10CqiTimers.size ());
-  // refresh DL CQI P01 Map
-  std::map <uint16_t,uint32_t>::iterator itP10 = m_p10CqiTimers.begin ();
-  while (itP10 != m_p10CqiTimers.end ())
+  // refresh DL CQI P01
+  for (uint32_t u = 0; u < m_ues.GetNUes (); u++)
     {
-      NS_LOG_INFO (this << " P10-CQI for user " << (*itP10).first << " is " << (uint32_t)(*itP10).second << " thr " << (uint32_t)m_cqiTimersThreshold);
-      if ((*itP10).second == 0)
+      uint32_t slot = m_ues.GetUeSlot (u);
+      if (!m_p10CqiRxed.Has (slot))
         {
-          // delete correspondent entries
-          std::map <uint16_t,uint8_t>::iterator itMap = m_p10CqiRxed.find ((*itP10).first);
-          NS_ASSERT_MSG (itMap != m_p10CqiRxed.end (), " Does not find CQI report for user " << (*itP10).first);
-          NS_LOG_INFO (this << " P10-CQI exired for user " << (*itP10).first);
-          m_p10CqiRxed.erase (itMap);
-          std::map <uint16_t,uint32_t>::iterator temp = itP10;
-          itP10++;
-          m_p10CqiTimers.erase (temp);
+          continue;
+        }
+      NS_LOG_INFO (this << " P10-CQI for user " << m_ues.GetRnti (slot) << " is " << m_p10CqiTimers[slot] << " thr " << (uint32_t)m_cqiTimersThreshold);
+      if (m_p10CqiTimers[slot] == 0)
+        {
+          NS_LOG_INFO (this << " P10-CQI exired for user " << m_ues.GetRnti (slot));
+          m_p10CqiRxed.Reset (slot);
         }
       else
         {
-          (*itP10).second--;
-          itP10++;
+          m_p10CqiTimers[slot]--;
         }
     }
 
@@ -1961,17 +1906,18 @@ RrFfMacScheduler::UpdateUlRlcBufferInfo (uint16_t rnti, uint16_t size)
 {
 
   size = size - 2; // remove the minimum RLC overhead
-  std::map <uint16_t,uint32_t>::iterator it = m_ceBsrRxed.find (rnti);
-  if (it != m_ceBsrRxed.end ())
+  uint32_t slot = m_ues.GetSlot (rnti);
+  if (m_ceBsrRxed.Has (slot))
     {
-      NS_LOG_INFO (this << " Update RLC BSR UE " << rnti << " size " << size << " BSR " << (*it).second);
-      if ((*it).second >= size)
+      uint32_t& bsr = m_ceBsrRxed.Get (slot);
+      NS_LOG_INFO (this << " Update RLC BSR UE " << rnti << " size " << size << " BSR " << bsr);
+      if (bsr >= size)
         {
-          (*it).second -= size;
+          bsr -= size;
         }
       else
         {
-          (*it).second = 0;
+          bsr = 0;
         }
     }
   else
@@ -0,0 +1,299 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/config.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/mobility-model.h"
+#include "ns3/lte-helper.h"
+#include "ns3/lte-enb-net-device.h"
+#include "ns3/lte-ue-net-device.h"
+#include "ns3/lte-enb-phy.h"
+#include "ns3/lte-ue-phy.h"
+#include "ns3/lte-chunk-processor.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestAbstractSpectrumChannel");
+
+/**
+ * Record the values reported by the PHYs of a simulation, in order
+ */
+class LteAbstractChannelRecorder
+{
+public:
+  /// a value reported
+  struct Report
+  {
+    Time time;       ///< when it was reported
+    uint32_t source; ///< what reported it
+    double value;    ///< the value
+  };
+
+  /**
+   * \param source what reports the SINRs
+   * \param sinr the SINR of a data frame, by RB
+   */
+  void ReportSinr (uint32_t source, const SpectrumValue& sinr)
+  {
+    Record (source, Sum (sinr) / sinr.GetSpectrumModel ()->GetNumBands ());
+  }
+
+  /**
+   * \param source the UE, as the RNTIs depend on the order of the random accesses
+   * \param rsrp the RSRP of the serving cell
+   * \param sinr the SINR of the control frames
+   */
+  void ReportRsrpSinr (uint32_t source, double rsrp, double sinr)
+  {
+    Record (source, rsrp);
+    Record (source, sinr);
+  }
+
+  /**
+   * \param source the UE and the cell measured
+   * \param rsrp the RSRP of the cell
+   * \param rsrq the RSRQ of the cell
+   */
+  void ReportUeMeasurements (uint32_t source, double rsrp, double rsrq)
+  {
+    Record (source, rsrp);
+    Record (source, rsrq);
+  }
+
+  /**
+   * \param a a value reported
+   * \param b another value reported
+   * \return whether a was reported before b, or at the same time by a PHY of a lower index
+   */
+  static bool Before (const Report &a, const Report &b)
+  {
+    return a.time < b.time || (a.time == b.time && a.source < b.source);
+  }
+
+  std::vector<Report> m_reports; ///< the values reported
+
+private:
+  void Record (uint32_t source, double value)
+  {
+    Report report;
+    report.time = Simulator::Now ();
+    report.source = source;
+    report.value = value;
+    m_reports.push_back (report);
+  }
+};
+
+/**
+ * Run the same multi-cell scenario over a MultiModelSpectrumChannel and
+ * over a LteAbstractSpectrumChannel, and check that the PHYs report the
+ * same SINRs and measurements over both. The UEs measure the other
+ * cells from their PSS, and one of them moves half-way through.
+ */
+class LteAbstractSpectrumChannelTestCase : public TestCase
+{
+public:
+  /**
+   * \param name the name of the test case
+   * \param enbs the number of eNBs
+   * \param uesPerEnb the number of UEs per eNB
+   * \param pathlossModel the TypeId of the pathloss model
+   */
+  LteAbstractSpectrumChannelTestCase (std::string name, uint32_t enbs, uint32_t uesPerEnb, std::string pathlossModel);
+  virtual ~LteAbstractSpectrumChannelTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run the scenario
+   *
+   * \param channelType the TypeId of the spectrum channels
+   * \param recorder where the values reported are recorded
+   */
+  void RunScenario (std::string channelType, LteAbstractChannelRecorder *recorder);
+
+  uint32_t m_enbs;
+  uint32_t m_uesPerEnb;
+  std::string m_pathlossModel;
+};
+
+static void
+LteAbstractChannelReportSinr (LteAbstractChannelRecorder *recorder, uint32_t source, const SpectrumValue& sinr)
+{
+  recorder->ReportSinr (source, sinr);
+}
+
+static void
+LteAbstractChannelReportRsrpSinr (LteAbstractChannelRecorder *recorder, uint32_t source,
+                                  uint16_t cellId, uint16_t rnti, double rsrp, double sinr)
+{
+  recorder->ReportRsrpSinr (source, rsrp, sinr);
+}
+
+static void
+LteAbstractChannelReportUeMeasurements (LteAbstractChannelRecorder *recorder, uint32_t source,
+                                        uint16_t rnti, uint16_t cellId, double rsrp, double rsrq, bool isServingCell)
+{
+  recorder->ReportUeMeasurements (source * 100 + cellId, rsrp, rsrq);
+}
+
+static void
+LteAbstractChannelMoveUe (Ptr<MobilityModel> mobility, Vector position)
+{
+  mobility->SetPosition (position);
+}
+
+LteAbstractSpectrumChannelTestCase::LteAbstractSpectrumChannelTestCase (std::string name, uint32_t enbs, uint32_t uesPerEnb,
+                                                                        std::string pathlossModel)
+  : TestCase (name),
+    m_enbs (enbs),
+    m_uesPerEnb (uesPerEnb),
+    m_pathlossModel (pathlossModel)
+{
+}
+
+LteAbstractSpectrumChannelTestCase::~LteAbstractSpectrumChannelTestCase ()
+{
+}
+
+void
+LteAbstractSpectrumChannelTestCase::RunScenario (std::string channelType, LteAbstractChannelRecorder *recorder)
+{
+  Config::SetDefault ("ns3::LteSpectrumPhy::CtrlErrorModelEnabled", BooleanValue (false));
+  Config::SetDefault ("ns3::LteSpectrumPhy::DataErrorModelEnabled", BooleanValue (false));
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("PathlossModel", StringValue (m_pathlossModel));
+  lteHelper->SetSpectrumChannelType (channelType);
+
+  // the eNBs on a line, 500 m apart, and their UEs around them
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (m_enbs);
+  ueNodes.Create (m_enbs * m_uesPerEnb);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < m_enbs; i++)
+    {
+      positionAlloc->Add (Vector (500.0 * i, 0.0, 0.0));
+    }
+  for (uint32_t i = 0; i < m_enbs; i++)
+    {
+      for (uint32_t j = 0; j < m_uesPerEnb; j++)
+        {
+          positionAlloc->Add (Vector (500.0 * i + 40.0 * j - 60.0, 30.0 + 50.0 * j, 0.0));
+        }
+    }
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  // the same random access in both runs
+  int64_t stream = lteHelper->AssignStreams (enbDevs, 1);
+  lteHelper->AssignStreams (ueDevs, 1 + stream);
+  lteHelper->AttachToClosestEnb (ueDevs, enbDevs);
+  EpsBearer bearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT);
+  lteHelper->ActivateDataRadioBearer (ueDevs, bearer);
+
+  uint32_t source = 0;
+  for (uint32_t i = 0; i < enbDevs.GetN (); i++)
+    {
+      Ptr<LteEnbPhy> enbPhy = enbDevs.Get (i)->GetObject<LteEnbNetDevice> ()->GetPhy ();
+      Ptr<LteChunkProcessor> ulSinr = Create<LteChunkProcessor> ();
+      ulSinr->AddCallback (MakeBoundCallback (&LteAbstractChannelReportSinr, recorder, source++));
+      enbPhy->GetUplinkSpectrumPhy ()->AddDataSinrChunkProcessor (ulSinr);
+    }
+  for (uint32_t i = 0; i < ueDevs.GetN (); i++)
+    {
+      Ptr<LteUePhy> uePhy = ueDevs.Get (i)->GetObject<LteUeNetDevice> ()->GetPhy ();
+      Ptr<LteChunkProcessor> dlSinr = Create<LteChunkProcessor> ();
+      dlSinr->AddCallback (MakeBoundCallback (&LteAbstractChannelReportSinr, recorder, source++));
+      uePhy->GetDownlinkSpectrumPhy ()->AddDataSinrChunkProcessor (dlSinr);
+      uePhy->TraceConnectWithoutContext ("ReportCurrentCellRsrpSinr",
+                                         MakeBoundCallback (&LteAbstractChannelReportRsrpSinr, recorder, 1000 + i));
+      uePhy->TraceConnectWithoutContext ("ReportUeMeasurements",
+                                         MakeBoundCallback (&LteAbstractChannelReportUeMeasurements, recorder, 1000 + i));
+    }
+
+  // the first UE moves towards the second eNB
+  Simulator::Schedule (MilliSeconds (150), &LteAbstractChannelMoveUe,
+                       ueNodes.Get (0)->GetObject<MobilityModel> (), Vector (350.0, 20.0, 0.0));
+
+  Simulator::Stop (MilliSeconds (300));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+LteAbstractSpectrumChannelTestCase::DoRun (void)
+{
+  LteAbstractChannelRecorder expected;
+  RunScenario ("ns3::MultiModelSpectrumChannel", &expected);
+  LteAbstractChannelRecorder actual;
+  RunScenario ("ns3::LteAbstractSpectrumChannel", &actual);
+
+  // the PHYs are not given the signals of a subframe in the same order
+  std::stable_sort (expected.m_reports.begin (), expected.m_reports.end (), &LteAbstractChannelRecorder::Before);
+  std::stable_sort (actual.m_reports.begin (), actual.m_reports.end (), &LteAbstractChannelRecorder::Before);
+
+  NS_TEST_ASSERT_MSG_GT (expected.m_reports.size (), 1000, "too few values reported");
+  NS_TEST_ASSERT_MSG_EQ (actual.m_reports.size (), expected.m_reports.size (), "not as many values reported");
+  for (uint32_t i = 0; i < expected.m_reports.size () && i < actual.m_reports.size (); i++)
+    {
+      const LteAbstractChannelRecorder::Report &e = expected.m_reports[i];
+      const LteAbstractChannelRecorder::Report &a = actual.m_reports[i];
+      NS_TEST_ASSERT_MSG_EQ (a.time, e.time, "value " << i << " reported at another time");
+      NS_TEST_ASSERT_MSG_EQ (a.source, e.source, "value " << i << " reported by another PHY");
+      NS_TEST_ASSERT_MSG_EQ_TOL (a.value, e.value, std::fabs (e.value) * 1e-6 + 1e-12,
+                                 "value " << i << " of " << e.source << " at " << e.time.GetMilliSeconds () << " ms differs");
+    }
+}
+
+
+/**
+ * Test suite of LteAbstractSpectrumChannel
+ */
+class LteAbstractSpectrumChannelTestSuite : public TestSuite
+{
+public:
+  LteAbstractSpectrumChannelTestSuite ();
+};
+
+LteAbstractSpectrumChannelTestSuite::LteAbstractSpectrumChannelTestSuite ()
+  : TestSuite ("lte-abstract-spectrum-channel", SYSTEM)
+{
+  AddTestCase (new LteAbstractSpectrumChannelTestCase ("2 eNBs, 2 UEs each, Friis", 2, 2,
+                                                       "ns3::FriisPropagationLossModel"),
+               TestCase::QUICK);
+  AddTestCase (new LteAbstractSpectrumChannelTestCase ("3 eNBs, 3 UEs each, Friis", 3, 3,
+                                                       "ns3::FriisPropagationLossModel"),
+               TestCase::QUICK);
+  AddTestCase (new LteAbstractSpectrumChannelTestCase ("3 eNBs, 2 UEs each, spectrum Friis", 3, 2,
+                                                       "ns3::FriisSpectrumPropagationLossModel"),
+               TestCase::QUICK);
+}
+
+static LteAbstractSpectrumChannelTestSuite lteAbstractSpectrumChannelTestSuite;
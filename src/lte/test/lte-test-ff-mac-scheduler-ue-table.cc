@@ -0,0 +1,103 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/ff-mac-scheduler-ue-table.h"
+
+using namespace ns3;
+
+/**
+ * Test the slots of the UEs and their order
+ */
+class FfMacSchedulerUeTableTestCase : public TestCase
+{
+public:
+  FfMacSchedulerUeTableTestCase ();
+  virtual ~FfMacSchedulerUeTableTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+FfMacSchedulerUeTableTestCase::FfMacSchedulerUeTableTestCase ()
+  : TestCase ("Slots and order of the UEs of the table")
+{
+}
+
+FfMacSchedulerUeTableTestCase::~FfMacSchedulerUeTableTestCase ()
+{
+}
+
+void
+FfMacSchedulerUeTableTestCase::DoRun (void)
+{
+  FfMacSchedulerUeTable table;
+  NS_TEST_ASSERT_MSG_EQ (table.GetSlot (1), FfMacSchedulerUeTable::NO_SLOT, "empty table");
+
+  uint32_t slot5 = table.AddUe (5);
+  uint32_t slot2 = table.AddUe (2);
+  uint32_t slot9 = table.AddUe (9);
+  NS_TEST_ASSERT_MSG_EQ (table.GetNUes (), 3, "wrong number of UEs");
+  NS_TEST_ASSERT_MSG_EQ (table.GetNSlots (), 3, "wrong number of slots");
+  NS_TEST_ASSERT_MSG_EQ (table.GetSlot (5), slot5, "wrong slot of RNTI 5");
+  NS_TEST_ASSERT_MSG_EQ (table.GetRnti (slot2), 2, "wrong RNTI of the slot");
+  NS_TEST_ASSERT_MSG_EQ (table.GetSlot (100), FfMacSchedulerUeTable::NO_SLOT, "RNTI beyond the table");
+
+  // the UEs are iterated by increasing RNTI, whatever their slots
+  NS_TEST_ASSERT_MSG_EQ (table.GetUeSlot (0), slot2, "wrong order");
+  NS_TEST_ASSERT_MSG_EQ (table.GetUeSlot (1), slot5, "wrong order");
+  NS_TEST_ASSERT_MSG_EQ (table.GetUeSlot (2), slot9, "wrong order");
+
+  // the slot of a removed UE is reused
+  NS_TEST_ASSERT_MSG_EQ (table.RemoveUe (5), slot5, "wrong slot removed");
+  NS_TEST_ASSERT_MSG_EQ (table.RemoveUe (5), FfMacSchedulerUeTable::NO_SLOT, "UE removed twice");
+  NS_TEST_ASSERT_MSG_EQ (table.GetSlot (5), FfMacSchedulerUeTable::NO_SLOT, "removed UE still in the table");
+  uint32_t slot7 = table.AddUe (7);
+  NS_TEST_ASSERT_MSG_EQ (slot7, slot5, "free slot not reused");
+  NS_TEST_ASSERT_MSG_EQ (table.GetNSlots (), 3, "wrong number of slots");
+  NS_TEST_ASSERT_MSG_EQ (table.GetUeSlot (0), slot2, "wrong order");
+  NS_TEST_ASSERT_MSG_EQ (table.GetUeSlot (1), slot7, "wrong order");
+  NS_TEST_ASSERT_MSG_EQ (table.GetUeSlot (2), slot9, "wrong order");
+
+  // the values of a column come and go with their slots
+  FfMacSchedulerUeColumn<uint32_t> column;
+  NS_TEST_ASSERT_MSG_EQ (column.Has (slot9), false, "empty column");
+  column.Set (slot9, 42);
+  NS_TEST_ASSERT_MSG_EQ (column.Has (slot9), true, "value not set");
+  NS_TEST_ASSERT_MSG_EQ (column.Has (slot2), false, "value set in the wrong slot");
+  NS_TEST_ASSERT_MSG_EQ (column.Get (slot9), 42, "wrong value");
+  column.Get (slot9)--;
+  NS_TEST_ASSERT_MSG_EQ (column.Get (slot9), 41, "value not updated");
+  column.Reset (slot9);
+  NS_TEST_ASSERT_MSG_EQ (column.Has (slot9), false, "value not reset");
+}
+
+/**
+ * The test suite of the table of the UEs of a scheduler
+ */
+class FfMacSchedulerUeTableTestSuite : public TestSuite
+{
+public:
+  FfMacSchedulerUeTableTestSuite ();
+};
+
+FfMacSchedulerUeTableTestSuite::FfMacSchedulerUeTableTestSuite ()
+  : TestSuite ("lte-ff-mac-scheduler-ue-table", UNIT)
+{
+  AddTestCase (new FfMacSchedulerUeTableTestCase (), TestCase::QUICK);
+}
+
+static FfMacSchedulerUeTableTestSuite ffMacSchedulerUeTableTestSuite;
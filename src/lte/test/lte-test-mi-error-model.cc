@@ -0,0 +1,160 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/lte-spectrum-value-helper.h"
+#include "ns3/lte-mi-error-model.h"
+#include <sstream>
+#include <cmath>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestMiErrorModel");
+
+/**
+ * Test the mapping of a SINR to the MI against points of the MI maps
+ */
+class LteMiMapTestCase : public TestCase
+{
+public:
+  LteMiMapTestCase (std::string name, uint8_t mcs, double sinr, double mi);
+  virtual ~LteMiMapTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  uint8_t m_mcs;
+  double m_sinr;
+  double m_mi;
+};
+
+LteMiMapTestCase::LteMiMapTestCase (std::string name, uint8_t mcs, double sinr, double mi)
+  : TestCase (name),
+    m_mcs (mcs),
+    m_sinr (sinr),
+    m_mi (mi)
+{
+}
+
+LteMiMapTestCase::~LteMiMapTestCase ()
+{
+}
+
+void
+LteMiMapTestCase::DoRun (void)
+{
+  double mi = LteMiErrorModel::MappingSinrMi (m_sinr, m_mcs);
+  NS_TEST_ASSERT_MSG_EQ_TOL (mi, m_mi, 1e-9, "wrong MI for SINR " << m_sinr << " and MCS " << (uint16_t) m_mcs);
+}
+
+/**
+ * Test that the MI of a TB is the mean of the MI of its RBs
+ */
+class LteMiBatchTestCase : public TestCase
+{
+public:
+  static std::string BuildNameString (uint8_t mcs, uint8_t bandwidth);
+  LteMiBatchTestCase (uint8_t mcs, uint8_t bandwidth);
+  virtual ~LteMiBatchTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  uint8_t m_mcs;
+  uint8_t m_bandwidth;
+};
+
+std::string
+LteMiBatchTestCase::BuildNameString (uint8_t mcs, uint8_t bandwidth)
+{
+  std::ostringstream oss;
+  oss << "MI of a TB of MCS " << (uint16_t) mcs << " over " << (uint16_t) bandwidth << " RBs";
+  return oss.str ();
+}
+
+LteMiBatchTestCase::LteMiBatchTestCase (uint8_t mcs, uint8_t bandwidth)
+  : TestCase (BuildNameString (mcs, bandwidth)),
+    m_mcs (mcs),
+    m_bandwidth (bandwidth)
+{
+}
+
+LteMiBatchTestCase::~LteMiBatchTestCase ()
+{
+}
+
+void
+LteMiBatchTestCase::DoRun (void)
+{
+  Ptr<SpectrumModel> sm = LteSpectrumValueHelper::GetSpectrumModel (100, m_bandwidth);
+  SpectrumValue sinr (sm);
+  Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable> ();
+  rv->SetStream (1);
+
+  // the SINRs span the MI maps of all the modulations, from -10 dB to 25 dB
+  std::vector<int> map;
+  double miSum = 0.0;
+  for (uint8_t rb = 0; rb < m_bandwidth; rb++)
+    {
+      sinr[rb] = std::pow (10.0, rv->GetValue (-1.0, 2.5));
+      // every other RB is allocated to the TB, then all the last ones
+      if (rb % 2 == 0 || rb >= m_bandwidth / 2)
+        {
+          map.push_back (rb);
+          miSum += LteMiErrorModel::MappingSinrMi (sinr[rb], m_mcs);
+        }
+    }
+
+  double mi = LteMiErrorModel::Mib (sinr, map, m_mcs);
+  NS_TEST_ASSERT_MSG_EQ_TOL (mi, miSum / map.size (), 1e-12, "the MI of the TB is not the mean of the MI of its RBs");
+}
+
+/**
+ * The test suite of the MI error model
+ */
+class LteMiErrorModelTestSuite : public TestSuite
+{
+public:
+  LteMiErrorModelTestSuite ();
+};
+
+LteMiErrorModelTestSuite::LteMiErrorModelTestSuite ()
+  : TestSuite ("lte-mi-error-model", UNIT)
+{
+  // a SINR takes the MI of the first point above it in the map
+  AddTestCase (new LteMiMapTestCase ("QPSK below the map", 0, 0.001, 0.008922), TestCase::QUICK);
+  AddTestCase (new LteMiMapTestCase ("QPSK first point", 0, 0.013, 0.011813), TestCase::QUICK);
+  AddTestCase (new LteMiMapTestCase ("QPSK between points", 5, 0.019, 0.014697), TestCase::QUICK);
+  AddTestCase (new LteMiMapTestCase ("QPSK beyond the map", 9, 3.2, 1.0), TestCase::QUICK);
+  AddTestCase (new LteMiMapTestCase ("16QAM first point", 10, 0.063, 0.021859), TestCase::QUICK);
+  AddTestCase (new LteMiMapTestCase ("16QAM between points", 16, 0.1, 0.030631), TestCase::QUICK);
+  AddTestCase (new LteMiMapTestCase ("16QAM beyond the map", 16, 10.0, 1.0), TestCase::QUICK);
+  AddTestCase (new LteMiMapTestCase ("64QAM first point", 17, 0.25, 0.064415), TestCase::QUICK);
+  AddTestCase (new LteMiMapTestCase ("64QAM between points", 28, 1.0, 0.136597), TestCase::QUICK);
+  AddTestCase (new LteMiMapTestCase ("64QAM beyond the map", 28, 158.0, 1.0), TestCase::QUICK);
+
+  // 100 RBs span more than one batch of SINR values
+  AddTestCase (new LteMiBatchTestCase (0, 6), TestCase::QUICK);
+  AddTestCase (new LteMiBatchTestCase (14, 25), TestCase::QUICK);
+  AddTestCase (new LteMiBatchTestCase (9, 100), TestCase::QUICK);
+  AddTestCase (new LteMiBatchTestCase (16, 100), TestCase::QUICK);
+  AddTestCase (new LteMiBatchTestCase (28, 100), TestCase::QUICK);
+}
+
+static LteMiErrorModelTestSuite lteMiErrorModelTestSuite;
@@ -0,0 +1,280 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/integer.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/mobility-model.h"
+#include "ns3/spectrum-channel.h"
+#include "ns3/lte-helper.h"
+#include "ns3/lte-enb-net-device.h"
+#include "ns3/lte-enb-phy.h"
+#include "ns3/lte-spectrum-phy.h"
+#include "ns3/radio-environment-map-helper.h"
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cmath>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestRadioEnvironmentMap");
+
+/**
+ * Generate the REM of 3 eNBs with sector antennas and different
+ * transmission powers, both by simulation and directly, and check that
+ * both maps are the same. Then move one of the eNBs and change its
+ * power, recompute the map computed directly for this eNB only, and
+ * check that it is the same as the map computed directly from scratch.
+ */
+class LteRadioEnvironmentMapTestCase : public TestCase
+{
+public:
+  /**
+   * \param name the name of the test case
+   * \param pathlossModel the TypeId of the pathloss model
+   * \param bandwidth the bandwidth of the map, in RBs
+   * \param rbId the RB of the map, or -1 for all RBs
+   */
+  LteRadioEnvironmentMapTestCase (std::string name, std::string pathlossModel,
+                                  uint16_t bandwidth, int32_t rbId);
+  virtual ~LteRadioEnvironmentMapTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// a point of a map
+  struct RemPoint
+  {
+    double x;    ///< the x coordinate
+    double y;    ///< the y coordinate
+    double sinr; ///< the SINR
+  };
+
+  /**
+   * Generate a map
+   *
+   * \param direct whether the map is computed directly
+   * \param fileName the file to which the map is written
+   * \param moved whether eNB 1 is moved before the map is generated
+   * \param recomputedFileName if not empty, the file to which the map
+   *        is written once recomputed after moving eNB 1
+   */
+  void GenerateRem (bool direct, std::string fileName, bool moved, std::string recomputedFileName);
+
+  /**
+   * Read a map
+   *
+   * \param fileName the file to which a map was written
+   * \param points the points of the map
+   */
+  void ReadRem (std::string fileName, std::vector<RemPoint> &points);
+
+  /**
+   * Check that two maps are the same
+   *
+   * \param actualFileName the file of the map checked
+   * \param expectedFileName the file of the map expected
+   */
+  void CheckRem (std::string actualFileName, std::string expectedFileName);
+
+  std::string m_pathlossModel;
+  uint16_t m_bandwidth;
+  int32_t m_rbId;
+};
+
+LteRadioEnvironmentMapTestCase::LteRadioEnvironmentMapTestCase (std::string name, std::string pathlossModel,
+                                                                uint16_t bandwidth, int32_t rbId)
+  : TestCase (name),
+    m_pathlossModel (pathlossModel),
+    m_bandwidth (bandwidth),
+    m_rbId (rbId)
+{
+}
+
+LteRadioEnvironmentMapTestCase::~LteRadioEnvironmentMapTestCase ()
+{
+}
+
+static void
+LteRemTestMoveEnb (Ptr<NetDevice> enbDevice)
+{
+  enbDevice->GetNode ()->GetObject<MobilityModel> ()->SetPosition (Vector (300.0, -100.0, 30.0));
+  DynamicCast<LteEnbNetDevice> (enbDevice)->GetPhy ()->SetTxPower (40.0);
+}
+
+void
+LteRadioEnvironmentMapTestCase::GenerateRem (bool direct, std::string fileName, bool moved,
+                                             std::string recomputedFileName)
+{
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("PathlossModel", StringValue (m_pathlossModel));
+  lteHelper->SetEnbAntennaModelType ("ns3::CosineAntennaModel");
+  lteHelper->SetEnbAntennaModelAttribute ("Beamwidth", DoubleValue (70));
+
+  NodeContainer enbNodes;
+  enbNodes.Create (3);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 30.0));
+  positionAlloc->Add (Vector (500.0, 0.0, 30.0));
+  positionAlloc->Add (Vector (250.0, 400.0, 30.0));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+
+  NetDeviceContainer enbDevs;
+  for (uint32_t i = 0; i < enbNodes.GetN (); i++)
+    {
+      lteHelper->SetEnbAntennaModelAttribute ("Orientation", DoubleValue (120.0 * i));
+      enbDevs.Add (lteHelper->InstallEnbDevice (enbNodes.Get (i)));
+      DynamicCast<LteEnbNetDevice> (enbDevs.Get (i))->GetPhy ()->SetTxPower (46.0 - 3 * i);
+    }
+  if (moved)
+    {
+      LteRemTestMoveEnb (enbDevs.Get (1));
+    }
+
+  uint32_t channelId = DynamicCast<LteEnbNetDevice> (enbDevs.Get (0))->GetPhy ()
+    ->GetDownlinkSpectrumPhy ()->GetChannel ()->GetId ();
+  std::ostringstream channelPath;
+  channelPath << "/ChannelList/" << channelId;
+  Ptr<RadioEnvironmentMapHelper> remHelper = CreateObject<RadioEnvironmentMapHelper> ();
+  remHelper->SetAttribute ("ChannelPath", StringValue (channelPath.str ()));
+  remHelper->SetAttribute ("OutputFile", StringValue (fileName));
+  remHelper->SetAttribute ("XMin", DoubleValue (-200.0));
+  remHelper->SetAttribute ("XMax", DoubleValue (800.0));
+  remHelper->SetAttribute ("XRes", UintegerValue (30));
+  remHelper->SetAttribute ("YMin", DoubleValue (-300.0));
+  remHelper->SetAttribute ("YMax", DoubleValue (600.0));
+  remHelper->SetAttribute ("YRes", UintegerValue (20));
+  remHelper->SetAttribute ("Z", DoubleValue (1.5));
+  remHelper->SetAttribute ("MaxPointsPerIteration", UintegerValue (97));
+  remHelper->SetAttribute ("Bandwidth", UintegerValue (m_bandwidth));
+  remHelper->SetAttribute ("RbId", IntegerValue (m_rbId));
+  remHelper->SetAttribute ("UseDirectComputation", BooleanValue (direct));
+  remHelper->Install ();
+
+  Simulator::Run ();
+  if (!recomputedFileName.empty ())
+    {
+      LteRemTestMoveEnb (enbDevs.Get (1));
+      remHelper->SetAttribute ("OutputFile", StringValue (recomputedFileName));
+      remHelper->Recompute (enbDevs.Get (1));
+    }
+  Simulator::Destroy ();
+}
+
+void
+LteRadioEnvironmentMapTestCase::ReadRem (std::string fileName, std::vector<RemPoint> &points)
+{
+  points.clear ();
+  std::ifstream file (fileName.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (file.is_open (), true, "cannot open " << fileName);
+  RemPoint point;
+  double z;
+  while (file >> point.x >> point.y >> z >> point.sinr)
+    {
+      points.push_back (point);
+    }
+}
+
+void
+LteRadioEnvironmentMapTestCase::CheckRem (std::string actualFileName, std::string expectedFileName)
+{
+  std::vector<RemPoint> actual;
+  ReadRem (actualFileName, actual);
+  std::vector<RemPoint> expected;
+  ReadRem (expectedFileName, expected);
+  NS_TEST_ASSERT_MSG_EQ (actual.size (), 30u * 20u, "wrong number of points in " << actualFileName);
+  NS_TEST_ASSERT_MSG_EQ (expected.size (), 30u * 20u, "wrong number of points in " << expectedFileName);
+  for (uint32_t i = 0; i < actual.size (); i++)
+    {
+      const RemPoint &a = actual[i];
+      const RemPoint &e = expected[i];
+      NS_TEST_ASSERT_MSG_EQ_TOL (a.x, e.x, 1e-3, "x of point " << i << " differs");
+      NS_TEST_ASSERT_MSG_EQ_TOL (a.y, e.y, 1e-3, "y of point " << i << " differs");
+      // the output has 6 significant digits
+      NS_TEST_ASSERT_MSG_EQ_TOL (a.sinr, e.sinr, std::fabs (e.sinr) * 2e-5,
+                                 "SINR of point " << i << " (" << e.x << ", " << e.y << ") differs");
+    }
+}
+
+void
+LteRadioEnvironmentMapTestCase::DoRun (void)
+{
+  std::string simulated = CreateTempDirFilename ("rem-simulated.out");
+  std::string direct = CreateTempDirFilename ("rem-direct.out");
+  GenerateRem (false, simulated, false, "");
+  GenerateRem (true, direct, false, "");
+  CheckRem (direct, simulated);
+
+  std::string recomputed = CreateTempDirFilename ("rem-recomputed.out");
+  std::string moved = CreateTempDirFilename ("rem-moved.out");
+  GenerateRem (true, direct, false, recomputed);
+  GenerateRem (true, moved, true, "");
+  CheckRem (recomputed, moved);
+
+  // the maps before and after the move differ
+  std::vector<RemPoint> before;
+  ReadRem (direct, before);
+  std::vector<RemPoint> after;
+  ReadRem (moved, after);
+  uint32_t changed = 0;
+  for (uint32_t i = 0; i < before.size () && i < after.size (); i++)
+    {
+      if (std::fabs (before[i].sinr - after[i].sinr) > std::fabs (before[i].sinr) * 1e-3)
+        {
+          changed++;
+        }
+    }
+  NS_TEST_ASSERT_MSG_GT (changed, before.size () / 2, "moving the eNB changed too few points");
+}
+
+
+/**
+ * Test suite of RadioEnvironmentMapHelper
+ */
+class LteRadioEnvironmentMapTestSuite : public TestSuite
+{
+public:
+  LteRadioEnvironmentMapTestSuite ();
+};
+
+LteRadioEnvironmentMapTestSuite::LteRadioEnvironmentMapTestSuite ()
+  : TestSuite ("lte-radio-environment-map", SYSTEM)
+{
+  AddTestCase (new LteRadioEnvironmentMapTestCase ("Friis, all RBs",
+                                                   "ns3::FriisPropagationLossModel", 25, -1),
+               TestCase::QUICK);
+  AddTestCase (new LteRadioEnvironmentMapTestCase ("log-distance, RB 7",
+                                                   "ns3::LogDistancePropagationLossModel", 25, 7),
+               TestCase::QUICK);
+  AddTestCase (new LteRadioEnvironmentMapTestCase ("Friis, map of 50 RBs",
+                                                   "ns3::FriisPropagationLossModel", 50, -1),
+               TestCase::QUICK);
+  AddTestCase (new LteRadioEnvironmentMapTestCase ("spectrum Friis, all RBs",
+                                                   "ns3::FriisSpectrumPropagationLossModel", 25, -1),
+               TestCase::QUICK);
+}
+
+static LteRadioEnvironmentMapTestSuite lteRadioEnvironmentMapTestSuite;
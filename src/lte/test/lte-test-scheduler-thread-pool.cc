@@ -0,0 +1,441 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/uinteger.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/lte-helper.h"
+#include "ns3/lte-scheduler-thread-pool.h"
+#include <map>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestSchedulerThreadPool");
+
+/**
+ * Test that the jobs submitted at a time are all run once, and that
+ * their results are delivered in the order they were submitted
+ */
+class LteSchedulerThreadPoolTestCase : public TestCase
+{
+public:
+  static std::string BuildNameString (uint32_t threads, uint32_t jobs);
+  LteSchedulerThreadPoolTestCase (uint32_t threads, uint32_t jobs);
+  virtual ~LteSchedulerThreadPoolTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Submit all the jobs
+   */
+  void SubmitJobs (void);
+  /**
+   * A job, summing the integers up to its index
+   * \param job the index of the job
+   */
+  void Job (uint32_t job);
+  /**
+   * Record the result of a job
+   * \param job the index of the job
+   */
+  void Merge (uint32_t job);
+
+  uint32_t m_threads;
+  uint32_t m_nJobs;
+  Ptr<LteSchedulerThreadPool> m_pool;
+  std::vector<uint64_t> m_results;
+  std::vector<uint32_t> m_merged;
+};
+
+std::string
+LteSchedulerThreadPoolTestCase::BuildNameString (uint32_t threads, uint32_t jobs)
+{
+  std::ostringstream oss;
+  oss << jobs << " jobs on " << threads << " threads";
+  return oss.str ();
+}
+
+LteSchedulerThreadPoolTestCase::LteSchedulerThreadPoolTestCase (uint32_t threads, uint32_t jobs)
+  : TestCase (BuildNameString (threads, jobs)),
+    m_threads (threads),
+    m_nJobs (jobs)
+{
+}
+
+LteSchedulerThreadPoolTestCase::~LteSchedulerThreadPoolTestCase ()
+{
+}
+
+void
+LteSchedulerThreadPoolTestCase::SubmitJobs (void)
+{
+  for (uint32_t i = 0; i < m_nJobs; i++)
+    {
+      m_pool->Submit (MakeCallback (&LteSchedulerThreadPoolTestCase::Job, this).Bind (i),
+                      MakeCallback (&LteSchedulerThreadPoolTestCase::Merge, this).Bind (i));
+    }
+}
+
+void
+LteSchedulerThreadPoolTestCase::Job (uint32_t job)
+{
+  uint64_t sum = 0;
+  for (uint64_t i = 0; i <= job; i++)
+    {
+      sum += i;
+    }
+  m_results[job] += sum;
+}
+
+void
+LteSchedulerThreadPoolTestCase::Merge (uint32_t job)
+{
+  m_merged.push_back (job);
+}
+
+void
+LteSchedulerThreadPoolTestCase::DoRun (void)
+{
+  m_pool = CreateObject<LteSchedulerThreadPool> ();
+  m_pool->SetAttribute ("Threads", UintegerValue (m_threads));
+  m_results.assign (m_nJobs, 0);
+
+  // the jobs of two events at the same time are run together
+  Simulator::Schedule (MilliSeconds (1), &LteSchedulerThreadPoolTestCase::SubmitJobs, this);
+  Simulator::Schedule (MilliSeconds (1), &LteSchedulerThreadPoolTestCase::SubmitJobs, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_pool->GetNFlushes (), 1, "the jobs of the same time should be run together");
+  NS_TEST_ASSERT_MSG_EQ (m_pool->GetNJobs (), 2 * m_nJobs, "wrong number of jobs run");
+  NS_TEST_ASSERT_MSG_EQ (m_merged.size (), 2 * m_nJobs, "wrong number of results delivered");
+  for (uint32_t i = 0; i < 2 * m_nJobs; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_merged[i], i % m_nJobs, "the results are not delivered in the order of the jobs");
+    }
+  for (uint32_t i = 0; i < m_nJobs; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_results[i], (uint64_t) i * (i + 1), "job " << i << " was not run twice");
+    }
+  m_pool->Dispose ();
+  m_pool = 0;
+}
+
+
+/**
+ * Test that the jobs submitted by the merge callbacks are run together,
+ * at the same time, once the results of all the first jobs are delivered
+ */
+class LteSchedulerThreadPoolStagesTestCase : public TestCase
+{
+public:
+  LteSchedulerThreadPoolStagesTestCase (uint32_t threads, uint32_t jobs);
+  virtual ~LteSchedulerThreadPoolStagesTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Submit the jobs of the first stage
+   */
+  void SubmitJobs (void);
+  /**
+   * A job of the first stage
+   * \param job the index of the job
+   */
+  void JobFirst (uint32_t job);
+  /**
+   * A job of the second stage
+   * \param job the index of the job
+   */
+  void JobSecond (uint32_t job);
+  /**
+   * Record the result of a job of the first stage, and submit its second stage
+   * \param job the index of the job
+   */
+  void MergeFirst (uint32_t job);
+  /**
+   * Record the result of a job of the second stage
+   * \param job the index of the job
+   */
+  void MergeSecond (uint32_t job);
+
+  uint32_t m_threads;
+  uint32_t m_nJobs;
+  Ptr<LteSchedulerThreadPool> m_pool;
+  std::vector<uint32_t> m_stages;
+  uint32_t m_nMergedFirst;
+  uint32_t m_nMergedSecond;
+};
+
+LteSchedulerThreadPoolStagesTestCase::LteSchedulerThreadPoolStagesTestCase (uint32_t threads, uint32_t jobs)
+  : TestCase (LteSchedulerThreadPoolTestCase::BuildNameString (threads, jobs) + " in two stages"),
+    m_threads (threads),
+    m_nJobs (jobs),
+    m_nMergedFirst (0),
+    m_nMergedSecond (0)
+{
+}
+
+LteSchedulerThreadPoolStagesTestCase::~LteSchedulerThreadPoolStagesTestCase ()
+{
+}
+
+void
+LteSchedulerThreadPoolStagesTestCase::SubmitJobs (void)
+{
+  for (uint32_t i = 0; i < m_nJobs; i++)
+    {
+      m_pool->Submit (MakeCallback (&LteSchedulerThreadPoolStagesTestCase::JobFirst, this).Bind (i),
+                      MakeCallback (&LteSchedulerThreadPoolStagesTestCase::MergeFirst, this).Bind (i));
+    }
+}
+
+void
+LteSchedulerThreadPoolStagesTestCase::JobFirst (uint32_t job)
+{
+  m_stages[job] = 1;
+}
+
+void
+LteSchedulerThreadPoolStagesTestCase::JobSecond (uint32_t job)
+{
+  m_stages[job] = 2;
+}
+
+void
+LteSchedulerThreadPoolStagesTestCase::MergeFirst (uint32_t job)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_stages[job], 1, "job " << job << " did not run its first stage");
+  NS_TEST_ASSERT_MSG_EQ (m_nMergedSecond, 0, "a second stage ran before the first stages were delivered");
+  m_nMergedFirst++;
+  m_pool->Submit (MakeCallback (&LteSchedulerThreadPoolStagesTestCase::JobSecond, this).Bind (job),
+                  MakeCallback (&LteSchedulerThreadPoolStagesTestCase::MergeSecond, this).Bind (job));
+}
+
+void
+LteSchedulerThreadPoolStagesTestCase::MergeSecond (uint32_t job)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_stages[job], 2, "job " << job << " did not run its second stage");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), MilliSeconds (1), "the second stage did not run at the same time");
+  m_nMergedSecond++;
+}
+
+void
+LteSchedulerThreadPoolStagesTestCase::DoRun (void)
+{
+  m_pool = CreateObject<LteSchedulerThreadPool> ();
+  m_pool->SetAttribute ("Threads", UintegerValue (m_threads));
+  m_stages.assign (m_nJobs, 0);
+
+  Simulator::Schedule (MilliSeconds (1), &LteSchedulerThreadPoolStagesTestCase::SubmitJobs, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_pool->GetNFlushes (), 2, "the jobs of each stage should be run together");
+  NS_TEST_ASSERT_MSG_EQ (m_pool->GetNJobs (), 2 * m_nJobs, "wrong number of jobs run");
+  NS_TEST_ASSERT_MSG_EQ (m_nMergedFirst, m_nJobs, "wrong number of results of the first stage");
+  NS_TEST_ASSERT_MSG_EQ (m_nMergedSecond, m_nJobs, "wrong number of results of the second stage");
+  m_pool->Dispose ();
+  m_pool = 0;
+}
+
+
+/**
+ * Test that the schedulers of several cells take the same decisions
+ * whether their requests are made in parallel or not
+ */
+class LteParallelSchedulingTestCase : public TestCase
+{
+public:
+  static std::string BuildNameString (std::string scheduler, uint32_t threads);
+  LteParallelSchedulingTestCase (std::string scheduler, uint32_t threads);
+  virtual ~LteParallelSchedulingTestCase ();
+
+  /**
+   * Record a DL scheduling decision
+   */
+  void DlScheduling (std::string context, uint32_t frameNo, uint32_t subframeNo, uint16_t rnti,
+                     uint8_t mcsTb1, uint16_t sizeTb1, uint8_t mcsTb2, uint16_t sizeTb2);
+  /**
+   * Record a UL scheduling decision
+   */
+  void UlScheduling (std::string context, uint32_t frameNo, uint32_t subframeNo, uint16_t rnti,
+                     uint8_t mcs, uint16_t sizeTb);
+
+private:
+  virtual void DoRun (void);
+
+  /// The scheduling decisions of each cell, in the order they were taken
+  typedef std::map<std::string, std::vector<std::string> > Decisions;
+
+  /**
+   * Run the scenario
+   * \param threads the value of the SchedulerThreads attribute of LteHelper
+   * \return the scheduling decisions
+   */
+  Decisions RunScenario (uint32_t threads);
+
+  std::string m_scheduler;
+  uint32_t m_threads;
+  Decisions m_decisions;
+};
+
+std::string
+LteParallelSchedulingTestCase::BuildNameString (std::string scheduler, uint32_t threads)
+{
+  std::ostringstream oss;
+  oss << scheduler << " with " << threads << " scheduler threads";
+  return oss.str ();
+}
+
+LteParallelSchedulingTestCase::LteParallelSchedulingTestCase (std::string scheduler, uint32_t threads)
+  : TestCase (BuildNameString (scheduler, threads)),
+    m_scheduler (scheduler),
+    m_threads (threads)
+{
+}
+
+LteParallelSchedulingTestCase::~LteParallelSchedulingTestCase ()
+{
+}
+
+void
+LteParallelSchedulingTestCase::DlScheduling (std::string context, uint32_t frameNo, uint32_t subframeNo, uint16_t rnti,
+                                             uint8_t mcsTb1, uint16_t sizeTb1, uint8_t mcsTb2, uint16_t sizeTb2)
+{
+  std::ostringstream oss;
+  oss << Simulator::Now ().GetMicroSeconds () << " DL " << frameNo << " " << subframeNo
+      << " " << rnti << " " << (uint16_t) mcsTb1 << " " << sizeTb1 << " " << (uint16_t) mcsTb2 << " " << sizeTb2;
+  m_decisions[context].push_back (oss.str ());
+}
+
+void
+LteParallelSchedulingTestCase::UlScheduling (std::string context, uint32_t frameNo, uint32_t subframeNo, uint16_t rnti,
+                                             uint8_t mcs, uint16_t sizeTb)
+{
+  std::ostringstream oss;
+  oss << Simulator::Now ().GetMicroSeconds () << " UL " << frameNo << " " << subframeNo
+      << " " << rnti << " " << (uint16_t) mcs << " " << sizeTb;
+  m_decisions[context].push_back (oss.str ());
+}
+
+LteParallelSchedulingTestCase::Decisions
+LteParallelSchedulingTestCase::RunScenario (uint32_t threads)
+{
+  m_decisions.clear ();
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("SchedulerThreads", UintegerValue (threads));
+  lteHelper->SetSchedulerType (m_scheduler);
+
+  // four cells on a line, with UEs at different distances from their eNB
+  uint32_t nEnbs = 4;
+  uint32_t nUesPerEnb = 5;
+  NodeContainer enbNodes;
+  enbNodes.Create (nEnbs);
+  NodeContainer ueNodes;
+  ueNodes.Create (nEnbs * nUesPerEnb);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < nEnbs; i++)
+    {
+      positionAlloc->Add (Vector (1000.0 * i, 0.0, 0.0));
+    }
+  for (uint32_t i = 0; i < nEnbs * nUesPerEnb; i++)
+    {
+      positionAlloc->Add (Vector (1000.0 * (i / nUesPerEnb), 50.0 + 100.0 * (i % nUesPerEnb), 0.0));
+    }
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  int64_t stream = 1;
+  stream += lteHelper->AssignStreams (enbDevs, stream);
+  lteHelper->AssignStreams (ueDevs, stream);
+  for (uint32_t i = 0; i < nEnbs * nUesPerEnb; i++)
+    {
+      lteHelper->Attach (ueDevs.Get (i), enbDevs.Get (i / nUesPerEnb));
+    }
+  EpsBearer bearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT);
+  lteHelper->ActivateDataRadioBearer (ueDevs, bearer);
+
+  Config::Connect ("/NodeList/*/DeviceList/*/LteEnbMac/DlScheduling",
+                   MakeCallback (&LteParallelSchedulingTestCase::DlScheduling, this));
+  Config::Connect ("/NodeList/*/DeviceList/*/LteEnbMac/UlScheduling",
+                   MakeCallback (&LteParallelSchedulingTestCase::UlScheduling, this));
+
+  Simulator::Stop (Seconds (0.2));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return m_decisions;
+}
+
+void
+LteParallelSchedulingTestCase::DoRun (void)
+{
+  // With a pool, the DL requests of all the cells are made before their
+  // UL requests, so that only the order within each cell is the same
+  Decisions sequential = RunScenario (0);
+  Decisions parallel = RunScenario (m_threads);
+  NS_TEST_ASSERT_MSG_GT (sequential.size (), 0, "no scheduling decision");
+  NS_TEST_ASSERT_MSG_EQ (parallel.size (), sequential.size (), "different number of cells scheduling");
+  for (Decisions::const_iterator it = sequential.begin (); it != sequential.end (); ++it)
+    {
+      const std::vector<std::string> &cell = parallel[it->first];
+      NS_TEST_ASSERT_MSG_EQ (cell.size (), it->second.size (), "different number of scheduling decisions in " << it->first);
+      for (uint32_t i = 0; i < it->second.size () && i < cell.size (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (cell[i], it->second[i], "different scheduling decision " << i << " in " << it->first);
+        }
+    }
+}
+
+
+/**
+ * Test suite of the parallel requests to the schedulers
+ */
+class LteSchedulerThreadPoolTestSuite : public TestSuite
+{
+public:
+  LteSchedulerThreadPoolTestSuite ();
+};
+
+LteSchedulerThreadPoolTestSuite::LteSchedulerThreadPoolTestSuite ()
+  : TestSuite ("lte-scheduler-thread-pool", SYSTEM)
+{
+  AddTestCase (new LteSchedulerThreadPoolTestCase (1, 10), TestCase::QUICK);
+  AddTestCase (new LteSchedulerThreadPoolTestCase (4, 1), TestCase::QUICK);
+  AddTestCase (new LteSchedulerThreadPoolTestCase (4, 3), TestCase::QUICK);
+  AddTestCase (new LteSchedulerThreadPoolTestCase (4, 100), TestCase::QUICK);
+  AddTestCase (new LteSchedulerThreadPoolStagesTestCase (1, 10), TestCase::QUICK);
+  AddTestCase (new LteSchedulerThreadPoolStagesTestCase (4, 10), TestCase::QUICK);
+
+  AddTestCase (new LteParallelSchedulingTestCase ("ns3::PfFfMacScheduler", 1), TestCase::QUICK);
+  AddTestCase (new LteParallelSchedulingTestCase ("ns3::PfFfMacScheduler", 4), TestCase::QUICK);
+  AddTestCase (new LteParallelSchedulingTestCase ("ns3::RrFfMacScheduler", 4), TestCase::QUICK);
+  AddTestCase (new LteParallelSchedulingTestCase ("ns3::CqaFfMacScheduler", 3), TestCase::EXTENSIVE);
+}
+
+static LteSchedulerThreadPoolTestSuite lteSchedulerThreadPoolTestSuite;
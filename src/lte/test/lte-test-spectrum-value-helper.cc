@@ -139,6 +139,45 @@ LteTxPsdTestCase::DoRun (void)
 
 
 
+class LteOccupiedRbsTestCase : public TestCase
+{
+public:
+  LteOccupiedRbsTestCase (const char* str, uint8_t bw, std::vector<int> activeRbs, uint32_t first, uint32_t end);
+  virtual ~LteOccupiedRbsTestCase ();
+
+protected:
+  Ptr<SpectrumValue> m_psd;
+  uint32_t m_first;
+  uint32_t m_end;
+
+private:
+  virtual void DoRun (void);
+};
+
+LteOccupiedRbsTestCase::LteOccupiedRbsTestCase (const char* str, uint8_t bw, std::vector<int> activeRbs, uint32_t first, uint32_t end)
+  :   TestCase (std::string ("Occupied RBs ") + str),
+    m_psd (LteSpectrumValueHelper::CreateTxPowerSpectralDensity (500, bw, 30.0, activeRbs)),
+    m_first (first),
+    m_end (end)
+{
+  NS_LOG_FUNCTION (this << str << bw << first << end);
+}
+
+LteOccupiedRbsTestCase::~LteOccupiedRbsTestCase ()
+{
+}
+
+void 
+LteOccupiedRbsTestCase::DoRun (void)
+{
+  uint32_t first, end;
+  LteSpectrumValueHelper::GetOccupiedRbs (*m_psd, first, end);
+  NS_TEST_ASSERT_MSG_EQ (first, m_first, "wrong first occupied RB");
+  NS_TEST_ASSERT_MSG_EQ (end, m_end, "wrong end of the occupied RBs");
+}
+
+
+
 class LteSpectrumValueHelperTestSuite : public TestSuite
 {
 public:
@@ -1650,5 +1689,23 @@ LteSpectrumValueHelperTestSuite::LteSpectrumValueHelperTestSuite ()
   AddTestCase (new LteTxPsdTestCase ("txpowdB30nrb100run2earfcn500", 500, 100, 30.000000, activeRbs_txpowdB30nrb100run2earfcn500, spectrumValue_txpowdB30nrb100run2earfcn500), TestCase::QUICK);
 
 
+  std::vector<int> activeRbs_none;
+  AddTestCase (new LteOccupiedRbsTestCase ("none", 100, activeRbs_none, 100, 100), TestCase::QUICK);
+  std::vector<int> activeRbs_all;
+  for (int rb = 0; rb < 25; rb++)
+    {
+      activeRbs_all.push_back (rb);
+    }
+  AddTestCase (new LteOccupiedRbsTestCase ("all", 25, activeRbs_all, 0, 25), TestCase::QUICK);
+  std::vector<int> activeRbs_sparse;
+  activeRbs_sparse.push_back (40);
+  activeRbs_sparse.push_back (41);
+  activeRbs_sparse.push_back (57);
+  AddTestCase (new LteOccupiedRbsTestCase ("sparse", 100, activeRbs_sparse, 40, 58), TestCase::QUICK);
+  std::vector<int> activeRbs_last;
+  activeRbs_last.push_back (99);
+  AddTestCase (new LteOccupiedRbsTestCase ("last", 100, activeRbs_last, 99, 100), TestCase::QUICK);
+
+
 
 }
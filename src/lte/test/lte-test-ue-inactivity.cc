@@ -0,0 +1,316 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/lte-helper.h"
+#include "ns3/lte-enb-net-device.h"
+#include "ns3/lte-ue-net-device.h"
+#include "ns3/lte-enb-phy.h"
+#include "ns3/lte-enb-mac.h"
+#include "ns3/lte-enb-rrc.h"
+#include "ns3/lte-ue-rrc.h"
+#include "ns3/epc-enb-s1-sap.h"
+#include <vector>
+#include <map>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestUeInactivity");
+
+/**
+ * Attach 4 UEs to an eNB, with a full buffer bearer for the first one
+ * only, and check that the other ones stop sending SRS once the
+ * `InactivityTimer` of LteUePhy expired, without the DL allocations of
+ * the first UE changing. Optionally, a bearer is set up for the last UE
+ * while it is inactive, and it is then checked that it is scheduled and
+ * sends SRS again. If its CQIs expired in the scheduler in the meantime,
+ * it is first scheduled with the lowest MCS, until it reports CQIs again.
+ */
+class LteUeInactivityTestCase : public TestCase
+{
+public:
+  /**
+   * \param name the name of the test case
+   * \param inactivityTimer the inactivity timer of the UEs
+   * \param wakeUp whether a bearer is set up for the last UE at 300 ms
+   * \param cqiTimerThreshold the `CqiTimerThreshold` of the scheduler, in TTIs
+   */
+  LteUeInactivityTestCase (std::string name, Time inactivityTimer, bool wakeUp,
+                           uint32_t cqiTimerThreshold);
+  virtual ~LteUeInactivityTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// a DL allocation
+  struct DlAllocation
+  {
+    uint32_t frameNo;    ///< the frame number
+    uint32_t subframeNo; ///< the subframe number
+    uint8_t mcs;         ///< the MCS of the first TB
+    uint16_t size;       ///< the size of the first TB
+    Time time;           ///< the time of the allocation
+  };
+
+  /**
+   * Run the scenario
+   *
+   * \param inactivityTimer the inactivity timer of the UEs
+   * \param wakeUp whether a bearer is set up for the last UE at 300 ms
+   */
+  void RunScenario (Time inactivityTimer, bool wakeUp);
+
+  /**
+   * Set up a full buffer bearer for a connected UE
+   *
+   * \param ueDevice the UE
+   */
+  static void ActivateBearer (Ptr<NetDevice> ueDevice);
+
+  /**
+   * Trace sink of the SRS SINRs reported by the eNB PHY
+   *
+   * \param cellId the cell ID
+   * \param rnti the RNTI of the UE
+   * \param sinr the SINR
+   */
+  void ReportUeSinr (uint16_t cellId, uint16_t rnti, double sinr);
+
+  /**
+   * Trace sink of the DL scheduling of the eNB MAC
+   *
+   * \param frameNo the frame number
+   * \param subframeNo the subframe number
+   * \param rnti the RNTI of the UE
+   * \param mcsTb1 the MCS of the first TB
+   * \param sizeTb1 the size of the first TB
+   * \param mcsTb2 the MCS of the second TB
+   * \param sizeTb2 the size of the second TB
+   */
+  void DlScheduling (uint32_t frameNo, uint32_t subframeNo, uint16_t rnti,
+                     uint8_t mcsTb1, uint16_t sizeTb1, uint8_t mcsTb2, uint16_t sizeTb2);
+
+  Time m_inactivityTimer;
+  bool m_wakeUp;
+  uint32_t m_cqiTimerThreshold;
+  /// the RNTIs of the UEs
+  std::vector<uint16_t> m_rntis;
+  /// the number of SRS received after 400 ms, per RNTI
+  std::map<uint16_t, uint32_t> m_lateSrs;
+  /// the DL allocations, per RNTI
+  std::map<uint16_t, std::vector<DlAllocation> > m_dlAllocations;
+};
+
+LteUeInactivityTestCase::LteUeInactivityTestCase (std::string name, Time inactivityTimer, bool wakeUp,
+                                                  uint32_t cqiTimerThreshold)
+  : TestCase (name),
+    m_inactivityTimer (inactivityTimer),
+    m_wakeUp (wakeUp),
+    m_cqiTimerThreshold (cqiTimerThreshold)
+{
+}
+
+LteUeInactivityTestCase::~LteUeInactivityTestCase ()
+{
+}
+
+void
+LteUeInactivityTestCase::ActivateBearer (Ptr<NetDevice> ueDevice)
+{
+  Ptr<LteUeNetDevice> ueLteDevice = ueDevice->GetObject<LteUeNetDevice> ();
+  Ptr<LteEnbRrc> enbRrc = ueLteDevice->GetTargetEnb ()->GetRrc ();
+  EpcEnbS1SapUser::DataRadioBearerSetupRequestParameters params;
+  params.rnti = ueLteDevice->GetRrc ()->GetRnti ();
+  params.bearer = EpsBearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT);
+  params.bearerId = 0;
+  params.gtpTeid = 0; // don't care
+  enbRrc->GetS1SapUser ()->DataRadioBearerSetupRequest (params);
+}
+
+void
+LteUeInactivityTestCase::ReportUeSinr (uint16_t cellId, uint16_t rnti, double sinr)
+{
+  if (Simulator::Now () >= MilliSeconds (400))
+    {
+      m_lateSrs[rnti]++;
+    }
+}
+
+void
+LteUeInactivityTestCase::DlScheduling (uint32_t frameNo, uint32_t subframeNo, uint16_t rnti,
+                                       uint8_t mcsTb1, uint16_t sizeTb1, uint8_t mcsTb2, uint16_t sizeTb2)
+{
+  DlAllocation allocation;
+  allocation.frameNo = frameNo;
+  allocation.subframeNo = subframeNo;
+  allocation.mcs = mcsTb1;
+  allocation.size = sizeTb1;
+  allocation.time = Simulator::Now ();
+  m_dlAllocations[rnti].push_back (allocation);
+}
+
+void
+LteUeInactivityTestCase::RunScenario (Time inactivityTimer, bool wakeUp)
+{
+  m_rntis.clear ();
+  m_lateSrs.clear ();
+  m_dlAllocations.clear ();
+  Config::SetDefault ("ns3::LteUePhy::InactivityTimer", TimeValue (inactivityTimer));
+  Config::SetDefault ("ns3::PfFfMacScheduler::CqiTimerThreshold", UintegerValue (m_cqiTimerThreshold));
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  NodeContainer enbNodes;
+  enbNodes.Create (1);
+  NodeContainer ueNodes;
+  ueNodes.Create (4);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  for (uint32_t i = 0; i < ueNodes.GetN (); i++)
+    {
+      positionAlloc->Add (Vector (100.0 + 50.0 * i, 0.0, 0.0));
+    }
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  lteHelper->Attach (ueDevs, enbDevs.Get (0));
+  int64_t stream = lteHelper->AssignStreams (enbDevs, 1);
+  lteHelper->AssignStreams (ueDevs, 1 + stream);
+  lteHelper->ActivateDataRadioBearer (ueDevs.Get (0), EpsBearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT));
+  if (wakeUp)
+    {
+      Simulator::Schedule (MilliSeconds (300), &LteUeInactivityTestCase::ActivateBearer, ueDevs.Get (3));
+    }
+
+  Ptr<LteEnbNetDevice> enbDev = DynamicCast<LteEnbNetDevice> (enbDevs.Get (0));
+  enbDev->GetPhy ()->TraceConnectWithoutContext ("ReportUeSinr",
+                                                 MakeCallback (&LteUeInactivityTestCase::ReportUeSinr, this));
+  enbDev->GetMac ()->TraceConnectWithoutContext ("DlScheduling",
+                                                 MakeCallback (&LteUeInactivityTestCase::DlScheduling, this));
+
+  Simulator::Stop (MilliSeconds (600));
+  Simulator::Run ();
+  for (uint32_t i = 0; i < ueDevs.GetN (); i++)
+    {
+      m_rntis.push_back (ueDevs.Get (i)->GetObject<LteUeNetDevice> ()->GetRrc ()->GetRnti ());
+    }
+  Simulator::Destroy ();
+}
+
+void
+LteUeInactivityTestCase::DoRun (void)
+{
+  RunScenario (Seconds (0), m_wakeUp);
+  std::vector<DlAllocation> expected = m_dlAllocations[m_rntis[0]];
+  NS_TEST_ASSERT_MSG_GT (expected.size (), 0u, "the active UE was not scheduled");
+
+  RunScenario (m_inactivityTimer, m_wakeUp);
+  for (uint32_t i = 0; i < m_rntis.size (); i++)
+    {
+      uint16_t rnti = m_rntis[i];
+      if (i == 0 || m_inactivityTimer == Seconds (0) || (m_wakeUp && i == 3))
+        {
+          NS_TEST_ASSERT_MSG_GT (m_lateSrs[rnti], 0u, "UE " << i << " (RNTI " << rnti << ") sent no SRS");
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_lateSrs[rnti], 0u, "inactive UE " << i << " (RNTI " << rnti << ") sent SRS");
+        }
+    }
+
+  // the inactive UEs do not change how the active UE is scheduled, until
+  // the last UE is woken up and gets no DL CQI for a while
+  std::vector<DlAllocation> actual = m_dlAllocations[m_rntis[0]];
+  if (m_wakeUp)
+    {
+      while (!actual.empty () && actual.back ().time >= MilliSeconds (300))
+        {
+          actual.pop_back ();
+        }
+      while (!expected.empty () && expected.back ().time >= MilliSeconds (300))
+        {
+          expected.pop_back ();
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (actual.size (), expected.size (), "wrong number of DL allocations");
+  for (uint32_t i = 0; i < actual.size () && i < expected.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (actual[i].frameNo, expected[i].frameNo, "frame of DL allocation " << i << " differs");
+      NS_TEST_ASSERT_MSG_EQ (actual[i].subframeNo, expected[i].subframeNo,
+                             "subframe of DL allocation " << i << " differs");
+      NS_TEST_ASSERT_MSG_EQ ((uint16_t) actual[i].mcs, (uint16_t) expected[i].mcs,
+                             "MCS of DL allocation " << i << " differs");
+      NS_TEST_ASSERT_MSG_EQ (actual[i].size, expected[i].size, "size of DL allocation " << i << " differs");
+    }
+
+  if (m_wakeUp)
+    {
+      const std::vector<DlAllocation> &woken = m_dlAllocations[m_rntis[3]];
+      NS_TEST_ASSERT_MSG_GT (woken.size (), 0u, "the UE woken up was not scheduled");
+      // the UE stopped reporting CQIs about 10 ms after it connected
+      if (MilliSeconds (m_cqiTimerThreshold) < MilliSeconds (200))
+        {
+          NS_TEST_ASSERT_MSG_EQ ((uint16_t) woken.front ().mcs, 0,
+                                 "the UE woken up was not scheduled with the lowest MCS");
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_GT ((uint16_t) woken.front ().mcs, 0,
+                                 "the UE woken up was not scheduled with its last CQI");
+        }
+      NS_TEST_ASSERT_MSG_GT ((uint16_t) woken.back ().mcs, 0,
+                             "the UE woken up was not scheduled with its new CQIs");
+    }
+}
+
+
+/**
+ * Test suite of the `InactivityTimer` of LteUePhy
+ */
+class LteUeInactivityTestSuite : public TestSuite
+{
+public:
+  LteUeInactivityTestSuite ();
+};
+
+LteUeInactivityTestSuite::LteUeInactivityTestSuite ()
+  : TestSuite ("lte-ue-inactivity", SYSTEM)
+{
+  AddTestCase (new LteUeInactivityTestCase ("no inactivity timer", Seconds (0), false, 1000),
+               TestCase::QUICK);
+  AddTestCase (new LteUeInactivityTestCase ("10 ms inactivity timer", MilliSeconds (10), false, 1000),
+               TestCase::QUICK);
+  AddTestCase (new LteUeInactivityTestCase ("10 ms inactivity timer, bearer set up at 300 ms",
+                                            MilliSeconds (10), true, 1000),
+               TestCase::QUICK);
+  AddTestCase (new LteUeInactivityTestCase ("10 ms inactivity timer, bearer set up at 300 ms, "
+                                            "after the CQIs expired",
+                                            MilliSeconds (10), true, 100),
+               TestCase::QUICK);
+}
+
+static LteUeInactivityTestSuite lteUeInactivityTestSuite;
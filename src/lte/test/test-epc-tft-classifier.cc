@@ -30,6 +30,7 @@
 #include "ns3/tcp-l4-protocol.h"
 
 #include "ns3/epc-tft-classifier.h"
+#include "ns3/random-variable-stream.h"
 
 #include <iomanip>
 
@@ -135,6 +136,116 @@ EpcTftClassifierTestCase::DoRun (void)
 
 
 
+/**
+ * Checks the classification of random packets against random TFTs
+ * with the TFTs evaluated in turn, by decreasing identifier
+ */
+class EpcTftClassifierRandomTestCase : public TestCase
+{
+public:
+  EpcTftClassifierRandomTestCase ();
+  virtual ~EpcTftClassifierRandomTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+EpcTftClassifierRandomTestCase::EpcTftClassifierRandomTestCase ()
+  : TestCase ("random TFTs and packets")
+{
+}
+
+EpcTftClassifierRandomTestCase::~EpcTftClassifierRandomTestCase ()
+{
+}
+
+void
+EpcTftClassifierRandomTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+  // few distinct values, so that the packets often match
+  const uint32_t addresses[] = { 0x0a000001, 0x0a000002, 0x0a000101, 0x07000001 };
+  const uint32_t masks[] = { 0, 0xff000000, 0xffffff00, 0xffffffff };
+  const uint16_t ports[] = { 80, 443, 1024, 1030, 5000 };
+  const uint8_t toss[] = { 0, 0xb8, 0x28 };
+
+  for (uint32_t run = 0; run < 20; run++)
+    {
+      EpcTftClassifier c;
+      std::map<uint32_t, Ptr<EpcTft> > tfts;
+      uint32_t nTfts = rng->GetInteger (1, 8);
+      for (uint32_t i = 0; i < nTfts; i++)
+        {
+          Ptr<EpcTft> tft = Create<EpcTft> ();
+          uint32_t nFilters = rng->GetInteger (1, 4);
+          for (uint32_t j = 0; j < nFilters; j++)
+            {
+              EpcTft::PacketFilter f;
+              f.direction = (EpcTft::Direction) rng->GetInteger (1, 3);
+              f.remoteAddress.Set (addresses[rng->GetInteger (0, 3)]);
+              f.remoteMask.Set (masks[rng->GetInteger (0, 3)]);
+              f.localAddress.Set (addresses[rng->GetInteger (0, 3)]);
+              f.localMask.Set (masks[rng->GetInteger (0, 3)]);
+              // any port, a single port or a range of ports
+              uint32_t kind = rng->GetInteger (0, 2);
+              if (kind == 1)
+                {
+                  f.remotePortStart = f.remotePortEnd = ports[rng->GetInteger (0, 4)];
+                }
+              else if (kind == 2)
+                {
+                  f.remotePortStart = 1024;
+                  f.remotePortEnd = 1030;
+                }
+              kind = rng->GetInteger (0, 2);
+              if (kind == 1)
+                {
+                  f.localPortStart = f.localPortEnd = ports[rng->GetInteger (0, 4)];
+                }
+              else if (kind == 2)
+                {
+                  f.localPortStart = 443;
+                  f.localPortEnd = 1024;
+                }
+              f.typeOfService = toss[rng->GetInteger (0, 2)];
+              f.typeOfServiceMask = rng->GetInteger (0, 1) ? 0xff : 0;
+              tft->Add (f);
+            }
+          // identifiers are not contiguous, and the TFTs are not added in order
+          uint32_t id = rng->GetInteger (1, 20);
+          c.Add (tft, id);
+          tfts[id] = tft;
+        }
+      if (rng->GetInteger (0, 1) && tfts.size () > 1)
+        {
+          c.Delete (tfts.begin ()->first);
+          tfts.erase (tfts.begin ());
+        }
+
+      for (uint32_t k = 0; k < 200; k++)
+        {
+          EpcTft::Direction d = rng->GetInteger (0, 1) ? EpcTft::UPLINK : EpcTft::DOWNLINK;
+          Ipv4Address ra (addresses[rng->GetInteger (0, 3)]);
+          Ipv4Address la (addresses[rng->GetInteger (0, 3)]);
+          uint16_t rp = ports[rng->GetInteger (0, 4)];
+          uint16_t lp = ports[rng->GetInteger (0, 4)];
+          uint8_t tos = toss[rng->GetInteger (0, 2)];
+          uint32_t expected = 0;
+          for (std::map<uint32_t, Ptr<EpcTft> >::reverse_iterator it = tfts.rbegin (); it != tfts.rend (); ++it)
+            {
+              if (it->second->Matches (d, ra, la, rp, lp, tos))
+                {
+                  expected = it->first;
+                  break;
+                }
+            }
+          NS_TEST_ASSERT_MSG_EQ (c.Classify (d, ra, la, rp, lp, tos), expected,
+                                 "bad classification, run " << run << " packet " << k);
+        }
+    }
+}
+
 
 class EpcTftClassifierTestSuite : public TestSuite
 {
@@ -328,4 +439,11 @@ EpcTftClassifierTestSuite::EpcTftClassifierTestSuite ()
   AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::UPLINK,   Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),     9,     5897,     0,    2), TestCase::QUICK);
   AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::DOWNLINK, Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),  5897,       10,     0,    2), TestCase::QUICK);
 
+
+  ///////////////////////////////////////////
+  // check random TFTs
+  ///////////////////////////////////////////
+
+  AddTestCase (new EpcTftClassifierRandomTestCase (), TestCase::QUICK);
+
 }
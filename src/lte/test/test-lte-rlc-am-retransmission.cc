@@ -0,0 +1,336 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/ptr.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+
+#include "ns3/lte-mac-sap.h"
+#include "ns3/lte-rlc-sap.h"
+#include "ns3/lte-rlc-am.h"
+#include "ns3/lte-rlc-am-header.h"
+
+#include <set>
+#include <vector>
+
+
+NS_LOG_COMPONENT_DEFINE ("TestLteRlcAmRetransmission");
+
+namespace ns3 {
+
+/**
+ * MAC connecting two AM RLC entities back to back. On every buffer
+ * status report it schedules enough transmission opportunities of a
+ * fixed size, one per TTI, to empty the reported queues, and it
+ * delivers the PDUs to the peer entity one TTI later, except the first
+ * transmission of the data PDUs whose SN has been marked as lost.
+ */
+class RlcAmLossyMac : public LteMacSapProvider
+{
+public:
+  RlcAmLossyMac (uint32_t txOppSize);
+
+  void SetLteMacSapUser (LteMacSapUser* s);
+  void SetPeer (RlcAmLossyMac* peer);
+  void LoseDataPdu (uint16_t sn);
+  bool IsRetransmitted (uint16_t sn) const;
+
+  // inherited from LteMacSapProvider
+  virtual void TransmitPdu (TransmitPduParameters params);
+  virtual void ReportBufferStatus (ReportBufferStatusParameters params);
+
+private:
+  void Receive (Ptr<Packet> p);
+
+  LteMacSapUser* m_macSapUser;
+  RlcAmLossyMac* m_peer;
+  uint32_t m_txOppSize;
+  std::vector<EventId> m_txOpps;
+  std::set<uint16_t> m_lostSns;
+  std::set<uint16_t> m_txedSns;
+  std::set<uint16_t> m_retxSns;
+};
+
+RlcAmLossyMac::RlcAmLossyMac (uint32_t txOppSize)
+  : m_macSapUser (0),
+    m_peer (0),
+    m_txOppSize (txOppSize)
+{
+}
+
+void
+RlcAmLossyMac::SetLteMacSapUser (LteMacSapUser* s)
+{
+  m_macSapUser = s;
+}
+
+void
+RlcAmLossyMac::SetPeer (RlcAmLossyMac* peer)
+{
+  m_peer = peer;
+}
+
+void
+RlcAmLossyMac::LoseDataPdu (uint16_t sn)
+{
+  m_lostSns.insert (sn);
+}
+
+bool
+RlcAmLossyMac::IsRetransmitted (uint16_t sn) const
+{
+  return m_retxSns.find (sn) != m_retxSns.end ();
+}
+
+void
+RlcAmLossyMac::TransmitPdu (TransmitPduParameters params)
+{
+  LteRlcAmHeader rlcAmHeader;
+  params.pdu->PeekHeader (rlcAmHeader);
+  if (rlcAmHeader.IsDataPdu ())
+    {
+      uint16_t sn = rlcAmHeader.GetSequenceNumber ().GetValue ();
+      NS_LOG_LOGIC ("data PDU SN=" << sn << " size=" << params.pdu->GetSize ());
+      if (!m_txedSns.insert (sn).second)
+        {
+          m_retxSns.insert (sn);
+        }
+      if (m_lostSns.erase (sn) > 0)
+        {
+          NS_LOG_LOGIC ("losing data PDU SN=" << sn);
+          return;
+        }
+    }
+  Simulator::Schedule (MilliSeconds (1), &RlcAmLossyMac::Receive, m_peer, params.pdu);
+}
+
+void
+RlcAmLossyMac::ReportBufferStatus (ReportBufferStatusParameters params)
+{
+  for (std::vector<EventId>::iterator it = m_txOpps.begin ();
+       it != m_txOpps.end ();
+       ++it)
+    {
+      it->Cancel ();
+    }
+  m_txOpps.clear ();
+
+  int32_t size = params.statusPduSize + params.txQueueSize + params.retxQueueSize;
+  Time time = MilliSeconds (1);
+  while (size > 0)
+    {
+      m_txOpps.push_back (Simulator::Schedule (time, &LteMacSapUser::NotifyTxOpportunity,
+                                               m_macSapUser, m_txOppSize, 0, 0));
+      size -= m_txOppSize;
+      time += MilliSeconds (1);
+    }
+}
+
+void
+RlcAmLossyMac::Receive (Ptr<Packet> p)
+{
+  m_macSapUser->ReceivePdu (p);
+}
+
+
+/**
+ * PDCP receiving side: concatenates the payload of the SDUs delivered
+ * by the RLC.
+ */
+class RlcAmSduSink : public LteRlcSapUser
+{
+public:
+  RlcAmSduSink ();
+
+  // inherited from LteRlcSapUser
+  virtual void ReceivePdcpPdu (Ptr<Packet> p);
+
+  std::string m_data; ///< payload of the SDUs received, concatenated
+  uint32_t m_sdus; ///< number of SDUs received
+};
+
+RlcAmSduSink::RlcAmSduSink ()
+  : m_sdus (0)
+{
+}
+
+void
+RlcAmSduSink::ReceivePdcpPdu (Ptr<Packet> p)
+{
+  std::vector<uint8_t> buf (p->GetSize ());
+  p->CopyData (buf.data (), buf.size ());
+  m_data.append (buf.begin (), buf.end ());
+  ++m_sdus;
+}
+
+
+/**
+ * Sends SDUs larger than the transmission opportunities through an AM
+ * RLC entity, so that they are segmented and concatenated, loses the
+ * first transmission of some data PDUs and checks that the receiving
+ * entity reassembles and delivers every SDU, in order and unchanged,
+ * after the lost PDUs are retransmitted. It also checks that the SDUs
+ * given to the transmitting entity are not modified by the segmentation.
+ */
+class RlcAmRetransmissionTestCase : public TestCase
+{
+public:
+  RlcAmRetransmissionTestCase (uint32_t sduSize, uint32_t nSdus, uint32_t txOppSize,
+                               std::set<uint16_t> lostSns);
+
+protected:
+  virtual void DoRun (void);
+
+  uint32_t m_sduSize;
+  uint32_t m_nSdus;
+  uint32_t m_txOppSize;
+  std::set<uint16_t> m_lostSns;
+};
+
+static std::string
+BuildName (uint32_t sduSize, uint32_t nSdus, uint32_t txOppSize, std::set<uint16_t> lostSns)
+{
+  std::ostringstream oss;
+  oss << nSdus << " SDUs of " << sduSize << " bytes, TxOpp " << txOppSize
+      << " bytes, lost SNs";
+  for (std::set<uint16_t>::iterator it = lostSns.begin (); it != lostSns.end (); ++it)
+    {
+      oss << " " << *it;
+    }
+  return oss.str ();
+}
+
+RlcAmRetransmissionTestCase::RlcAmRetransmissionTestCase (uint32_t sduSize, uint32_t nSdus,
+                                                          uint32_t txOppSize,
+                                                          std::set<uint16_t> lostSns)
+  : TestCase (BuildName (sduSize, nSdus, txOppSize, lostSns)),
+    m_sduSize (sduSize),
+    m_nSdus (nSdus),
+    m_txOppSize (txOppSize),
+    m_lostSns (lostSns)
+{
+}
+
+void
+RlcAmRetransmissionTestCase::DoRun ()
+{
+  NS_LOG_FUNCTION (this << GetName ());
+
+  uint16_t rnti = 1111;
+  uint8_t lcid = 222;
+
+  Ptr<LteRlcAm> txRlc = CreateObject<LteRlcAm> ();
+  txRlc->SetRnti (rnti);
+  txRlc->SetLcId (lcid);
+  Ptr<LteRlcAm> rxRlc = CreateObject<LteRlcAm> ();
+  rxRlc->SetRnti (rnti);
+  rxRlc->SetLcId (lcid);
+
+  RlcAmSduSink txPdcp;
+  RlcAmSduSink rxPdcp;
+  txRlc->SetLteRlcSapUser (&txPdcp);
+  rxRlc->SetLteRlcSapUser (&rxPdcp);
+
+  RlcAmLossyMac txMac (m_txOppSize);
+  RlcAmLossyMac rxMac (m_txOppSize);
+  txMac.SetPeer (&rxMac);
+  rxMac.SetPeer (&txMac);
+  for (std::set<uint16_t>::iterator it = m_lostSns.begin (); it != m_lostSns.end (); ++it)
+    {
+      txMac.LoseDataPdu (*it);
+    }
+  txRlc->SetLteMacSapProvider (&txMac);
+  txMac.SetLteMacSapUser (txRlc->GetLteMacSapUser ());
+  rxRlc->SetLteMacSapProvider (&rxMac);
+  rxMac.SetLteMacSapUser (rxRlc->GetLteMacSapUser ());
+
+  std::string sent;
+  std::vector<Ptr<Packet> > sdus;
+  for (uint32_t i = 0; i < m_nSdus; ++i)
+    {
+      std::string data;
+      for (uint32_t j = 0; j < m_sduSize; ++j)
+        {
+          data.push_back ('A' + (i + j) % 26);
+        }
+      sent += data;
+      Ptr<Packet> sdu = Create<Packet> ((const uint8_t *) data.data (), data.size ());
+      sdus.push_back (sdu);
+
+      LteRlcSapProvider::TransmitPdcpPduParameters params;
+      params.pdcpPdu = sdu;
+      params.rnti = rnti;
+      params.lcid = lcid;
+      Simulator::Schedule (MilliSeconds (10 + i), &LteRlcSapProvider::TransmitPdcpPdu,
+                           txRlc->GetLteRlcSapProvider (), params);
+    }
+
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+
+  for (std::set<uint16_t>::iterator it = m_lostSns.begin (); it != m_lostSns.end (); ++it)
+    {
+      NS_TEST_ASSERT_MSG_EQ (txMac.IsRetransmitted (*it), true, "lost data PDU " << *it << " not retransmitted");
+    }
+  NS_TEST_ASSERT_MSG_EQ (rxPdcp.m_sdus, m_nSdus, "wrong number of SDUs delivered");
+  NS_TEST_ASSERT_MSG_EQ (rxPdcp.m_data, sent, "SDUs not delivered in order or corrupted");
+
+  std::string given;
+  for (std::vector<Ptr<Packet> >::iterator it = sdus.begin (); it != sdus.end (); ++it)
+    {
+      std::vector<uint8_t> buf ((*it)->GetSize ());
+      (*it)->CopyData (buf.data (), buf.size ());
+      given.append (buf.begin (), buf.end ());
+    }
+  NS_TEST_ASSERT_MSG_EQ (given, sent, "SDUs given to the transmitting RLC were modified");
+
+  Simulator::Destroy ();
+  txRlc->Dispose ();
+  rxRlc->Dispose ();
+}
+
+
+class LteRlcAmRetransmissionTestSuite : public TestSuite
+{
+public:
+  LteRlcAmRetransmissionTestSuite ();
+} staticLteRlcAmRetransmissionTestSuiteInstance;
+
+LteRlcAmRetransmissionTestSuite::LteRlcAmRetransmissionTestSuite ()
+  : TestSuite ("lte-rlc-am-retransmission", UNIT)
+{
+  std::set<uint16_t> lostSns;
+  AddTestCase (new RlcAmRetransmissionTestCase (100, 4, 60, lostSns), TestCase::QUICK);
+
+  // SN 1 carries the end of the first SDU and the start of the second
+  lostSns.insert (1);
+  AddTestCase (new RlcAmRetransmissionTestCase (100, 4, 60, lostSns), TestCase::QUICK);
+
+  lostSns.insert (4);
+  AddTestCase (new RlcAmRetransmissionTestCase (100, 4, 60, lostSns), TestCase::QUICK);
+
+  // a whole SDU spans several PDUs, each one lost once
+  lostSns.clear ();
+  lostSns.insert (2);
+  lostSns.insert (3);
+  lostSns.insert (4);
+  AddTestCase (new RlcAmRetransmissionTestCase (300, 3, 80, lostSns), TestCase::QUICK);
+}
+
+
+} // namespace ns3
@@ -28,6 +28,9 @@
 #include "ns3/names.h"
 #include "ns3/net-device.h"
 #include "ns3/pcap-file-wrapper.h"
+#include "ns3/binary-trace-file.h"
+#include "ns3/global-value.h"
+#include "ns3/boolean.h"
 
 #include "trace-helper.h"
 
@@ -35,6 +38,17 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TraceHelper");
 
+/**
+ * \ingroup binary-trace
+ * A global switch to write the files of AsciiTraceHelper in the binary
+ * trace format.
+ */
+static GlobalValue g_asciiTraceBinary = GlobalValue ("AsciiTraceBinary",
+                                                     "Write the ascii trace files created by AsciiTraceHelper "
+                                                     "in the compressed binary trace format",
+                                                     BooleanValue (false),
+                                                     MakeBooleanChecker ());
+
 PcapHelper::PcapHelper ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -192,7 +206,19 @@ AsciiTraceHelper::CreateFileStream (std::string filename, std::ios::openmode fil
 {
   NS_LOG_FUNCTION (filename << filemode);
 
+  BooleanValue binary;
+  g_asciiTraceBinary.GetValue (binary);
+  if (binary.Get ())
+    {
+      filemode |= std::ios::binary;
+    }
   Ptr<OutputStreamWrapper> StreamWrapper = Create<OutputStreamWrapper> (filename, filemode);
+  if (binary.Get ())
+    {
+      Ptr<BinaryTraceWriter> writer = CreateObject<BinaryTraceWriter> ();
+      writer->Open (StreamWrapper->GetStream ());
+      StreamWrapper->SetBinaryTraceWriter (writer);
+    }
 
   //
   // Note that the ascii trace helper promptly forgets all about the trace file.
@@ -295,6 +321,18 @@ AsciiTraceHelper::GetFilenameFromInterfacePair (
   return oss.str ();
 }
 
+bool
+AsciiTraceHelper::WriteBinaryEvent (Ptr<OutputStreamWrapper> stream, char event, std::string const &context, Ptr<const Packet> p)
+{
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryTraceWriter ();
+  if (writer == 0)
+    {
+      return false;
+    }
+  writer->Write (event, context, p);
+  return true;
+}
+
 //
 // One of the basic default trace sink sets.  Enqueue:
 //
@@ -310,14 +348,20 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
-  *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+  if (!WriteBinaryEvent (stream, '+', std::string (), p))
+    {
+      *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+    }
 }
 
 void
 AsciiTraceHelper::DefaultEnqueueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
-  *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
+  if (!WriteBinaryEvent (stream, '+', context, p))
+    {
+      *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
+    }
 }
 
 //
@@ -336,14 +380,20 @@ void
 AsciiTraceHelper::DefaultDropSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
-  *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+  if (!WriteBinaryEvent (stream, 'd', std::string (), p))
+    {
+      *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+    }
 }
 
 void
 AsciiTraceHelper::DefaultDropSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
-  *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
+  if (!WriteBinaryEvent (stream, 'd', context, p))
+    {
+      *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
+    }
 }
 
 //
@@ -363,14 +413,20 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
-  *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+  if (!WriteBinaryEvent (stream, '-', std::string (), p))
+    {
+      *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+    }
 }
 
 void
 AsciiTraceHelper::DefaultDequeueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
-  *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
+  if (!WriteBinaryEvent (stream, '-', context, p))
+    {
+      *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
+    }
 }
 
 //
@@ -387,14 +443,20 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
-  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+  if (!WriteBinaryEvent (stream, 'r', std::string (), p))
+    {
+      *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+    }
 }
 
 void
 AsciiTraceHelper::DefaultReceiveSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
-  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
+  if (!WriteBinaryEvent (stream, 'r', context, p))
+    {
+      *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
+    }
 }
 
 void 
@@ -96,6 +96,11 @@ public:
 
   /**
    * @brief Create and initialize a pcap file.
+   *
+   * The file is a PcapFileWrapper created with the default values of its
+   * attributes: setting ns3::PcapFileWrapper::AsyncWrite selects the
+   * asynchronous writer for every file created by the pcap helpers, and
+   * ns3::PcapFileWrapper::Pcapng the pcapng format.
    * 
    * @param filename file name
    * @param filemode file mode
@@ -214,6 +219,15 @@ public:
    * run into object lifetime issues.  Ns-3 has a nice reference counted object
    * that can solve the problem so we use one of those to carry the stream
    * around and deal with the lifetime issues.
+   *
+   * When the "AsciiTraceBinary" global value is true, the file is written
+   * by a BinaryTraceWriter, in the compressed binary trace format, by the
+   * default trace sinks of this class and by the sinks which call
+   * WriteBinaryEvent, such as the ones of InternetStackHelper and of the
+   * wifi, wave and lr-wpan helpers. The text of the other sinks goes to a
+   * separate text file (see OutputStreamWrapper::GetStream). The
+   * print-binary-trace program
+   * converts such a file back to text.
    * 
    * @param filename file name
    * @param filemode file mode
@@ -455,6 +469,22 @@ public:
    * @param p the packet
    */
   static void DefaultReceiveSinkWithContext (Ptr<OutputStreamWrapper> file, std::string context, Ptr<const Packet> p);
+
+  /**
+   * @brief Write an event in the binary trace format, if the stream has a
+   * binary trace writer.
+   *
+   * The default trace sinks above, and the ascii trace sinks of other
+   * helpers, call this first and only write their text line when it
+   * returns false.
+   *
+   * @param stream the output stream wrapper
+   * @param event the event type, as written at the start of the text line
+   * @param context the context, or an empty string
+   * @param p the packet
+   * @returns false if the event must be written as text
+   */
+  static bool WriteBinaryEvent (Ptr<OutputStreamWrapper> stream, char event, std::string const &context, Ptr<const Packet> p);
 };
 
 template <typename T> void
@@ -281,4 +281,10 @@ NetDevice::~NetDevice ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+NetDevice::SetReceiveBurstCallback (ReceiveBurstCallback cb)
+{
+  NS_LOG_FUNCTION (this << &cb);
+}
+
 } // namespace ns3
@@ -37,6 +37,7 @@ namespace ns3 {
 class Node;
 class Channel;
 class Packet;
+class PacketBurst;
 class QueueLimits;
 
 /**
@@ -636,6 +637,30 @@ public:
    */
   virtual void SetReceiveCallback (ReceiveCallback cb) = 0;
 
+  /**
+   * \param device a pointer to the net device which is calling this callback
+   * \param burst the packets received, in order of arrival
+   * \param protocol the 16 bit protocol number shared by all the packets
+   *        of the burst.
+   * \param sender the address of the sender of all the packets of the burst
+   * \returns true if the callback could handle the packets successfully, false
+   *          otherwise.
+   */
+  typedef Callback< bool, Ptr<NetDevice>, Ptr<const PacketBurst>, uint16_t, const Address & > ReceiveBurstCallback;
+
+  /**
+   * \param cb callback to invoke whenever the device hands a burst of
+   *        packets to the higher layers at once.
+   *
+   * Devices which coalesce received frames may use this callback to deliver
+   * them in a single call, so that the higher layers can amortize their
+   * per-packet processing. The packets of a burst must be equivalent to as
+   * many calls to the ReceiveCallback, in the same order. Devices which do
+   * not coalesce frames can ignore this callback, which is what the default
+   * implementation does.
+   */
+  virtual void SetReceiveBurstCallback (ReceiveBurstCallback cb);
+
 
   /**
    * \param device a pointer to the net device which is calling this callback
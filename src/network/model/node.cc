@@ -23,6 +23,7 @@
 #include "net-device.h"
 #include "application.h"
 #include "ns3/packet.h"
+#include "ns3/packet-burst.h"
 #include "ns3/simulator.h"
 #include "ns3/object-vector.h"
 #include "ns3/uinteger.h"
@@ -133,6 +134,7 @@ Node::AddDevice (Ptr<NetDevice> device)
   device->SetNode (this);
   device->SetIfIndex (index);
   device->SetReceiveCallback (MakeCallback (&Node::NonPromiscReceiveFromDevice, this));
+  device->SetReceiveBurstCallback (MakeCallback (&Node::NonPromiscReceiveBurstFromDevice, this));
   Simulator::ScheduleWithContext (GetId (), Seconds (0.0), 
                                   &NetDevice::Initialize, device);
   NotifyDeviceAdded (device);
@@ -257,6 +259,18 @@ Node::RegisterProtocolHandler (ProtocolHandler handler,
   m_handlers.push_back (entry);
 }
 
+void
+Node::RegisterProtocolHandler (ProtocolHandler handler,
+                               BurstProtocolHandler burstHandler,
+                               uint16_t protocolType,
+                               Ptr<NetDevice> device,
+                               bool promiscuous)
+{
+  NS_LOG_FUNCTION (this << &handler << &burstHandler << protocolType << device << promiscuous);
+  RegisterProtocolHandler (handler, protocolType, device, promiscuous);
+  m_handlers.back ().burstHandler = burstHandler;
+}
+
 void
 Node::UnregisterProtocolHandler (ProtocolHandler handler)
 {
@@ -297,6 +311,45 @@ Node::NonPromiscReceiveFromDevice (Ptr<NetDevice> device, Ptr<const Packet> pack
   return ReceiveFromDevice (device, packet, protocol, from, device->GetAddress (), NetDevice::PacketType (0), false);
 }
 
+bool
+Node::NonPromiscReceiveBurstFromDevice (Ptr<NetDevice> device, Ptr<const PacketBurst> burst,
+                                        uint16_t protocol, const Address &from)
+{
+  NS_LOG_FUNCTION (this << device << burst << protocol << &from);
+  NS_ASSERT_MSG (Simulator::GetContext () == GetId (), "Received packet with erroneous context ; " <<
+                 "make sure the channels in use are correctly updating events context " <<
+                 "when transfering events from one node to another.");
+  NS_LOG_DEBUG ("Node " << GetId () << " ReceiveBurstFromDevice:  dev "
+                        << device->GetIfIndex () << " (type=" << device->GetInstanceTypeId ().GetName ()
+                        << ") " << burst->GetNPackets () << " packets");
+  const Address &to = device->GetAddress ();
+  bool found = false;
+
+  for (ProtocolHandlerList::iterator i = m_handlers.begin ();
+       i != m_handlers.end (); i++)
+    {
+      if ((i->device == 0 || i->device == device)
+          && (i->protocol == 0 || i->protocol == protocol)
+          && !i->promiscuous)
+        {
+          if (!i->burstHandler.IsNull ())
+            {
+              i->burstHandler (device, burst, protocol, from, to, NetDevice::PacketType (0));
+            }
+          else
+            {
+              for (std::list<Ptr<Packet> >::const_iterator p = burst->Begin ();
+                   p != burst->End (); ++p)
+                {
+                  i->handler (device, *p, protocol, from, to, NetDevice::PacketType (0));
+                }
+            }
+          found = true;
+        }
+    }
+  return found;
+}
+
 bool
 Node::ReceiveFromDevice (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
                          const Address &from, const Address &to, NetDevice::PacketType packetType, bool promiscuous)
@@ -32,6 +32,7 @@ namespace ns3 {
 
 class Application;
 class Packet;
+class PacketBurst;
 class Address;
 class Time;
 
@@ -174,6 +175,40 @@ public:
                                 uint16_t protocolType,
                                 Ptr<NetDevice> device,
                                 bool promiscuous=false);
+  /**
+   * A protocol handler which processes a burst of packets received by
+   * a device at once.
+   *
+   * \param device a pointer to the net device which received the packets
+   * \param burst the packets received, in order of arrival
+   * \param protocol the protocol number shared by all the packets
+   * \param sender the address of the sender of all the packets
+   * \param receiver the address of the receiver
+   * \param packetType type of packet received; only valid for
+   *                   promiscuous mode protocol handlers.
+   */
+  typedef Callback<void,Ptr<NetDevice>, Ptr<const PacketBurst>,uint16_t,const Address &,
+                   const Address &, NetDevice::PacketType> BurstProtocolHandler;
+  /**
+   * \param handler the handler to register
+   * \param burstHandler the handler to invoke instead of handler when a
+   *        device delivers a burst of packets at once
+   * \param protocolType the type of protocol this handler is
+   *        interested in (see above)
+   * \param device the device attached to this handler. If the
+   *        value is zero, the handler is attached to all
+   *        devices on this node.
+   * \param promiscuous whether to register a promiscuous mode handler
+   *
+   * Bursts are only delivered to non-promiscuous handlers. Handlers
+   * registered without a burst handler receive the packets of a burst
+   * one at a time.
+   */
+  void RegisterProtocolHandler (ProtocolHandler handler,
+                                BurstProtocolHandler burstHandler,
+                                uint16_t protocolType,
+                                Ptr<NetDevice> device,
+                                bool promiscuous=false);
   /**
    * \param handler the handler to unregister
    *
@@ -235,6 +270,16 @@ private:
    * \returns true if the packet has been delivered to a protocol handler.
    */
   bool NonPromiscReceiveFromDevice (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+  /**
+   * \brief Receive a burst of packets from a device in non-promiscuous mode.
+   * \param device the device
+   * \param burst the packets
+   * \param protocol the protocol
+   * \param from the sender
+   * \returns true if the packets have been delivered to a protocol handler.
+   */
+  bool NonPromiscReceiveBurstFromDevice (Ptr<NetDevice> device, Ptr<const PacketBurst> burst,
+                                         uint16_t protocol, const Address &from);
   /**
    * \brief Receive a packet from a device in promiscuous mode.
    * \param device the device
@@ -272,6 +317,7 @@ private:
    */
   struct ProtocolHandlerEntry {
     ProtocolHandler handler; //!< the protocol handler
+    BurstProtocolHandler burstHandler; //!< the burst handler, if any
     Ptr<NetDevice> device;   //!< the NetDevice
     uint16_t protocol;       //!< the protocol number
     bool promiscuous;        //!< true if it is a promiscuous handler
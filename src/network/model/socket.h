@@ -28,6 +28,7 @@
 #include "ns3/tag.h"
 #include "ns3/object.h"
 #include "ns3/net-device.h"
+#include "ns3/data-rate.h"
 #include "address.h"
 #include <stdint.h>
 #include "ns3/inet-socket-address.h"
@@ -1344,6 +1345,55 @@ private:
   uint8_t m_priority;  //!< the priority carried by the tag
 };
 
+/**
+ * \brief indicates the pacing rate of the socket which sent the packet.
+ *
+ * This tag is used by the queue discs which pace the flows at the rate
+ * of their socket.
+ */
+class SocketPacingRateTag : public Tag
+{
+public:
+  SocketPacingRateTag ();
+
+  /**
+   * \brief Set the tag's pacing rate
+   *
+   * \param rate the pacing rate
+   */
+  void SetPacingRate (DataRate rate);
+
+  /**
+   * \brief Get the tag's pacing rate
+   *
+   * \returns the pacing rate
+   */
+  DataRate GetPacingRate (void) const;
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  // inherited function, no need to doc.
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  // inherited function, no need to doc.
+  virtual uint32_t GetSerializedSize (void) const;
+
+  // inherited function, no need to doc.
+  virtual void Serialize (TagBuffer i) const;
+
+  // inherited function, no need to doc.
+  virtual void Deserialize (TagBuffer i);
+
+  // inherited function, no need to doc.
+  virtual void Print (std::ostream &os) const;
+private:
+  uint64_t m_pacingRate;  //!< the pacing rate carried by the tag, in bit/s
+};
+
 /**
  * \brief indicates whether the socket has IPV6_TCLASS set.
  * This tag is for IPv6 socket.
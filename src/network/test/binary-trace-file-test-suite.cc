@@ -0,0 +1,325 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "ns3/test.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/config.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/binary-trace-file.h"
+#include "ns3/trace-helper.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Write events with the default ascii trace sinks to a text stream and to
+ * a binary trace file, and check that the reader prints the text.
+ */
+class BinaryTraceAsciiTestCase : public TestCase
+{
+public:
+  BinaryTraceAsciiTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Write an event to the text and binary streams
+   * \param i the index of the event
+   */
+  void Trace (uint32_t i);
+
+  Ptr<OutputStreamWrapper> m_text;   //!< The text stream
+  Ptr<OutputStreamWrapper> m_binary; //!< The binary stream
+  std::ostringstream m_expected;     //!< The text written
+};
+
+BinaryTraceAsciiTestCase::BinaryTraceAsciiTestCase ()
+  : TestCase ("Check that a binary trace file is printed as the ascii trace")
+{
+}
+
+void
+BinaryTraceAsciiTestCase::Trace (uint32_t i)
+{
+  Ptr<Packet> p = Create<Packet> (100 + i % 50);
+  EthernetHeader header;
+  header.SetLengthType (i);
+  p->AddHeader (header);
+  std::ostringstream context;
+  context << "/NodeList/" << i % 3 << "/DeviceList/" << i % 2 << "/$ns3::PointToPointNetDevice/TxQueue/Enqueue";
+  switch (i % 8)
+    {
+    case 0:
+      AsciiTraceHelper::DefaultEnqueueSinkWithoutContext (m_text, p);
+      AsciiTraceHelper::DefaultEnqueueSinkWithoutContext (m_binary, p);
+      break;
+    case 1:
+      AsciiTraceHelper::DefaultEnqueueSinkWithContext (m_text, context.str (), p);
+      AsciiTraceHelper::DefaultEnqueueSinkWithContext (m_binary, context.str (), p);
+      break;
+    case 2:
+      AsciiTraceHelper::DefaultDequeueSinkWithoutContext (m_text, p);
+      AsciiTraceHelper::DefaultDequeueSinkWithoutContext (m_binary, p);
+      break;
+    case 3:
+      AsciiTraceHelper::DefaultDequeueSinkWithContext (m_text, context.str (), p);
+      AsciiTraceHelper::DefaultDequeueSinkWithContext (m_binary, context.str (), p);
+      break;
+    case 4:
+      AsciiTraceHelper::DefaultDropSinkWithoutContext (m_text, p);
+      AsciiTraceHelper::DefaultDropSinkWithoutContext (m_binary, p);
+      break;
+    case 5:
+      AsciiTraceHelper::DefaultDropSinkWithContext (m_text, context.str (), p);
+      AsciiTraceHelper::DefaultDropSinkWithContext (m_binary, context.str (), p);
+      break;
+    case 6:
+      AsciiTraceHelper::DefaultReceiveSinkWithoutContext (m_text, p);
+      AsciiTraceHelper::DefaultReceiveSinkWithoutContext (m_binary, p);
+      break;
+    default:
+      AsciiTraceHelper::DefaultReceiveSinkWithContext (m_text, context.str (), p);
+      AsciiTraceHelper::DefaultReceiveSinkWithContext (m_binary, context.str (), p);
+      break;
+    }
+}
+
+void
+BinaryTraceAsciiTestCase::DoRun (void)
+{
+  Packet::EnablePrinting ();
+  std::string filename = CreateTempDirFilename ("binary-trace.tr");
+  Config::SetGlobal ("AsciiTraceBinary", BooleanValue (true));
+  AsciiTraceHelper helper;
+  m_binary = helper.CreateFileStream (filename);
+  Config::SetGlobal ("AsciiTraceBinary", BooleanValue (false));
+  NS_TEST_ASSERT_MSG_NE (m_binary->GetBinaryTraceWriter (), 0, "No binary trace writer");
+  m_binary->GetBinaryTraceWriter ()->SetAttribute ("BlockRecords", UintegerValue (100));
+  m_text = Create<OutputStreamWrapper> (&m_expected);
+
+  const uint32_t events = 1000;
+  for (uint32_t i = 0; i < events; ++i)
+    {
+      Simulator::ScheduleWithContext (7, MicroSeconds (1234567 * i), &BinaryTraceAsciiTestCase::Trace, this, i);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  // Closes the file
+  m_binary = 0;
+  m_text = 0;
+
+  BinaryTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Unable to read " << filename);
+  NS_TEST_ASSERT_MSG_EQ (reader.HasPacketData (), true, "No packets stored");
+  std::ostringstream printed;
+  BinaryTraceReader::Record record;
+  uint32_t n = 0;
+  while (reader.Read (record))
+    {
+      if (n == 1)
+        {
+          NS_TEST_ASSERT_MSG_EQ (record.event, '+', "Wrong event type");
+          NS_TEST_ASSERT_MSG_EQ (record.node, 1, "Wrong node parsed from the context");
+          NS_TEST_ASSERT_MSG_EQ (record.device, 1, "Wrong device parsed from the context");
+        }
+      if (n == 2)
+        {
+          NS_TEST_ASSERT_MSG_EQ (record.event, '-', "Wrong event type");
+          NS_TEST_ASSERT_MSG_EQ (record.node, 7, "Wrong node taken from the simulator context");
+          NS_TEST_ASSERT_MSG_EQ (record.device, 0xffffffff, "Device should be unknown");
+        }
+      BinaryTraceReader::PrintAscii (printed, record);
+      ++n;
+    }
+  NS_TEST_ASSERT_MSG_EQ (n, events, "Wrong number of records");
+  NS_TEST_ASSERT_MSG_EQ (printed.str (), m_expected.str (), "Binary trace not printed as the ascii trace");
+  std::remove (filename.c_str ());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check that the compressed blocks are read back as the uncompressed ones,
+ * and are much smaller.
+ */
+class BinaryTraceCompressionTestCase : public TestCase
+{
+public:
+  BinaryTraceCompressionTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Write the test records
+   * \param writer the writer
+   * \param p the packet of the records
+   */
+  void WriteRecords (Ptr<BinaryTraceWriter> writer, Ptr<const Packet> p);
+};
+
+BinaryTraceCompressionTestCase::BinaryTraceCompressionTestCase ()
+  : TestCase ("Check the compression of a binary trace file")
+{
+}
+
+void
+BinaryTraceCompressionTestCase::WriteRecords (Ptr<BinaryTraceWriter> writer, Ptr<const Packet> p)
+{
+  for (uint32_t i = 0; i < 20000; ++i)
+    {
+      std::ostringstream context;
+      context << "/NodeList/" << i % 10 << "/DeviceList/0/$ns3::PointToPointNetDevice/MacRx";
+      writer->Write ("+-dr"[i % 4], context.str (), p);
+    }
+}
+
+void
+BinaryTraceCompressionTestCase::DoRun (void)
+{
+  std::string names[2] = { CreateTempDirFilename ("binary-trace-raw.tr"),
+                           CreateTempDirFilename ("binary-trace-lz4.tr") };
+  uint64_t sizes[2];
+  Ptr<Packet> p = Create<Packet> (1000);
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      std::ofstream os (names[i].c_str (), std::ios::out | std::ios::binary);
+      Ptr<BinaryTraceWriter> writer = CreateObject<BinaryTraceWriter> ();
+      writer->SetAttribute ("Compress", BooleanValue (i == 1));
+      writer->SetAttribute ("PacketData", BooleanValue (false));
+      writer->Open (&os);
+      WriteRecords (writer, p);
+      NS_TEST_ASSERT_MSG_EQ (writer->GetNRecords (), 20000, "Wrong number of records");
+      writer->Close ();
+      sizes[i] = os.tellp ();
+    }
+  NS_TEST_ASSERT_MSG_LT (sizes[1] * 2, sizes[0], "Blocks not compressed");
+
+  BinaryTraceReader raw;
+  BinaryTraceReader lz4;
+  NS_TEST_ASSERT_MSG_EQ (raw.Open (names[0]), true, "Unable to read " << names[0]);
+  NS_TEST_ASSERT_MSG_EQ (lz4.Open (names[1]), true, "Unable to read " << names[1]);
+  BinaryTraceReader::Record a;
+  BinaryTraceReader::Record b;
+  uint32_t n = 0;
+  while (raw.Read (a))
+    {
+      NS_TEST_ASSERT_MSG_EQ (lz4.Read (b), true, "Compressed file too short");
+      NS_TEST_ASSERT_MSG_EQ (b.event, a.event, "Wrong event type");
+      NS_TEST_ASSERT_MSG_EQ (b.context, a.context, "Wrong context");
+      NS_TEST_ASSERT_MSG_EQ (b.node, a.node, "Wrong node");
+      NS_TEST_ASSERT_MSG_EQ (b.uid, a.uid, "Wrong uid");
+      NS_TEST_ASSERT_MSG_EQ (b.size, 1000, "Wrong size");
+      NS_TEST_ASSERT_MSG_EQ (b.packet, 0, "Packet stored");
+      ++n;
+    }
+  NS_TEST_ASSERT_MSG_EQ (lz4.Read (b), false, "Compressed file too long");
+  NS_TEST_ASSERT_MSG_EQ (n, 20000, "Wrong number of records");
+  std::remove (names[0].c_str ());
+  std::remove (names[1].c_str ());
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check that the text written by a trace sink to a stream with a binary
+ * trace writer goes to a separate text file, and leaves the binary trace
+ * file readable.
+ */
+class BinaryTraceTextFallbackTestCase : public TestCase
+{
+public:
+  BinaryTraceTextFallbackTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BinaryTraceTextFallbackTestCase::BinaryTraceTextFallbackTestCase ()
+  : TestCase ("Check that the text written to a binary trace stream goes to a text file")
+{
+}
+
+void
+BinaryTraceTextFallbackTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("binary-trace-fallback.tr");
+  Config::SetGlobal ("AsciiTraceBinary", BooleanValue (true));
+  AsciiTraceHelper helper;
+  Ptr<OutputStreamWrapper> stream = helper.CreateFileStream (filename);
+  Config::SetGlobal ("AsciiTraceBinary", BooleanValue (false));
+
+  AsciiTraceHelper::DefaultEnqueueSinkWithoutContext (stream, Create<Packet> (100));
+  *stream->GetStream () << "a text line" << std::endl;
+  AsciiTraceHelper::DefaultDequeueSinkWithoutContext (stream, Create<Packet> (100));
+  *stream->GetStream () << "another text line" << std::endl;
+  // Closes the files
+  stream = 0;
+
+  BinaryTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Unable to read " << filename);
+  BinaryTraceReader::Record record;
+  uint32_t n = 0;
+  while (reader.Read (record))
+    {
+      ++n;
+    }
+  NS_TEST_ASSERT_MSG_EQ (n, 2, "Wrong number of records");
+
+  std::string textFilename = filename + ".txt";
+  std::ifstream text (textFilename.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (text.is_open (), true, "No text file " << textFilename);
+  std::ostringstream written;
+  written << text.rdbuf ();
+  NS_TEST_ASSERT_MSG_EQ (written.str (), "a text line\nanother text line\n", "Wrong text written");
+  text.close ();
+  std::remove (filename.c_str ());
+  std::remove (textFilename.c_str ());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Binary trace file test suite
+ */
+class BinaryTraceFileTestSuite : public TestSuite
+{
+public:
+  BinaryTraceFileTestSuite ();
+};
+
+BinaryTraceFileTestSuite::BinaryTraceFileTestSuite ()
+  : TestSuite ("binary-trace-file", UNIT)
+{
+  AddTestCase (new BinaryTraceAsciiTestCase, TestCase::QUICK);
+  AddTestCase (new BinaryTraceCompressionTestCase, TestCase::QUICK);
+  AddTestCase (new BinaryTraceTextFallbackTestCase, TestCase::QUICK);
+}
+
+static BinaryTraceFileTestSuite g_binaryTraceFileTestSuite; //!< Static variable for test initialization
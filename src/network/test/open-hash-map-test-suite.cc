@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/open-hash-map.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/test.h"
+#include <map>
+#include <stdlib.h>
+
+using namespace ns3;
+
+/**
+ * Hash returning a small range of values, so that long probe sequences
+ * wrap around the table.
+ */
+struct CollidingHash
+{
+  /**
+   * \param key the key
+   * \returns the hash of the key
+   */
+  size_t operator() (uint32_t key) const
+  {
+    return key % 7;
+  }
+};
+
+/**
+ * Check OpenHashMap against std::map with random insertions and
+ * erasures.
+ */
+class OpenHashMapTestCase : public TestCase
+{
+public:
+  OpenHashMapTestCase ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Run random operations on both maps and compare them
+   * \param hashMap the map under test
+   */
+  template <typename Hash>
+  void Compare (OpenHashMap<uint32_t, uint32_t, Hash> &hashMap);
+};
+
+OpenHashMapTestCase::OpenHashMapTestCase ()
+  : TestCase ("Check OpenHashMap against std::map")
+{
+}
+
+template <typename Hash>
+void
+OpenHashMapTestCase::Compare (OpenHashMap<uint32_t, uint32_t, Hash> &hashMap)
+{
+  std::map<uint32_t, uint32_t> reference;
+  for (uint32_t i = 0; i < 20000; ++i)
+    {
+      uint32_t key = rand () % 500;
+      switch (rand () % 3)
+        {
+        case 0:
+          hashMap[key] = i;
+          reference[key] = i;
+          break;
+        case 1:
+          NS_TEST_ASSERT_MSG_EQ (hashMap.erase (key), reference.erase (key), "Wrong erase result");
+          break;
+        default:
+          {
+            typename OpenHashMap<uint32_t, uint32_t, Hash>::iterator it = hashMap.find (key);
+            if (it != hashMap.end ())
+              {
+                hashMap.erase (it);
+              }
+            reference.erase (key);
+          }
+        }
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (hashMap.size (), reference.size (), "Wrong size");
+  for (std::map<uint32_t, uint32_t>::const_iterator it = reference.begin (); it != reference.end (); ++it)
+    {
+      typename OpenHashMap<uint32_t, uint32_t, Hash>::const_iterator found = hashMap.find (it->first);
+      NS_TEST_ASSERT_MSG_EQ ((found != hashMap.end ()), true, "Key not found");
+      NS_TEST_ASSERT_MSG_EQ (found->second, it->second, "Wrong value");
+    }
+  uint32_t n = 0;
+  for (typename OpenHashMap<uint32_t, uint32_t, Hash>::iterator it = hashMap.begin (); it != hashMap.end (); ++it)
+    {
+      NS_TEST_ASSERT_MSG_EQ (reference.count (it->first), 1, "Unexpected key");
+      ++n;
+    }
+  NS_TEST_ASSERT_MSG_EQ (n, reference.size (), "Wrong number of iterated elements");
+
+  hashMap.clear ();
+  NS_TEST_ASSERT_MSG_EQ (hashMap.empty (), true, "Map not empty after clear");
+  NS_TEST_ASSERT_MSG_EQ ((hashMap.begin () == hashMap.end ()), true, "Map not empty after clear");
+}
+
+void
+OpenHashMapTestCase::DoRun (void)
+{
+  srand (1);
+  OpenHashMap<uint32_t, uint32_t, CollidingHash> colliding;
+  Compare (colliding);
+
+  OpenHashMap<Ipv4Address, uint32_t, Ipv4AddressHash> addresses;
+  for (uint32_t i = 0; i < 1000; ++i)
+    {
+      addresses[Ipv4Address (0x0a000000 + i)] = i;
+    }
+  NS_TEST_ASSERT_MSG_EQ (addresses.size (), 1000, "Wrong size");
+  NS_TEST_ASSERT_MSG_EQ (addresses.insert (std::make_pair (Ipv4Address ("10.0.0.5"), 0)).second, false,
+                         "Duplicate key inserted");
+  NS_TEST_ASSERT_MSG_EQ (addresses.find (Ipv4Address ("10.0.0.5"))->second, 5, "Wrong value");
+  NS_TEST_ASSERT_MSG_EQ ((addresses.find (Ipv4Address ("10.0.4.0")) == addresses.end ()), true,
+                         "Unexpected key found");
+}
+
+/**
+ * OpenHashMap test suite
+ */
+static class OpenHashMapTestSuite : public TestSuite
+{
+public:
+  OpenHashMapTestSuite ()
+    : TestSuite ("open-hash-map", UNIT)
+  {
+    AddTestCase (new OpenHashMapTestCase (), TestCase::QUICK);
+  }
+} g_openHashMapTestSuite;
@@ -0,0 +1,284 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/pcap-file-wrapper.h"
+#include "ns3/ethernet-header.h"
+
+using namespace ns3;
+
+namespace {
+
+/**
+ * \param filename a file name
+ * \returns the content of the file
+ */
+std::vector<uint8_t>
+ReadAll (std::string filename)
+{
+  std::ifstream f (filename.c_str (), std::ios::binary);
+  return std::vector<uint8_t> ((std::istreambuf_iterator<char> (f)),
+                               std::istreambuf_iterator<char> ());
+}
+
+/**
+ * \param i the index of a record
+ * \returns a packet whose size and content depend on i
+ */
+Ptr<Packet>
+MakePacket (uint32_t i)
+{
+  uint32_t size = (i * 37) % 300;
+  std::vector<uint8_t> data (size + 1);
+  for (uint32_t j = 0; j < size; ++j)
+    {
+      data[j] = (i + j) & 0xff;
+    }
+  return Create<Packet> (&data[0], size);
+}
+
+/**
+ * \param buffer a buffer
+ * \param offset an offset in the buffer
+ * \returns the 32 bits value at this offset, in host byte order
+ */
+uint32_t
+Get32 (const std::vector<uint8_t> &buffer, uint32_t offset)
+{
+  uint32_t value;
+  std::memcpy (&value, &buffer[offset], sizeof (value));
+  return value;
+}
+
+} // anonymous namespace
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Write the same records with the synchronous and the asynchronous pcap
+ * writers, and check that the files are identical.
+ */
+class PcapAsyncIdenticalTestCase : public TestCase
+{
+public:
+  PcapAsyncIdenticalTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Write the test records
+   * \param filename the file to write
+   * \param async whether to use the asynchronous writer
+   */
+  void WriteFile (std::string filename, bool async);
+};
+
+PcapAsyncIdenticalTestCase::PcapAsyncIdenticalTestCase ()
+  : TestCase ("Check that the asynchronous writer writes the same pcap file")
+{
+}
+
+void
+PcapAsyncIdenticalTestCase::WriteFile (std::string filename, bool async)
+{
+  Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+  file->SetAttribute ("AsyncWrite", BooleanValue (async));
+  // A small buffer, to hand over many chunks
+  file->SetAttribute ("AsyncBufferSize", UintegerValue (16 * 1024));
+  file->Open (filename, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (file->Fail (), false, "Unable to open " << filename);
+  // A snaplen shorter than some of the packets
+  file->Init (1, 200);
+  NS_TEST_ASSERT_MSG_EQ (file->IsAsync (), async, "Wrong writer");
+  EthernetHeader header;
+  for (uint32_t i = 0; i < 5000; ++i)
+    {
+      Time t = MicroSeconds (1000003 * i);
+      if (i % 3 == 0)
+        {
+          file->Write (t, header, MakePacket (i));
+        }
+      else
+        {
+          file->Write (t, MakePacket (i));
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (file->GetNDroppedRecords (), 0, "Records dropped");
+  file->Close ();
+}
+
+void
+PcapAsyncIdenticalTestCase::DoRun (void)
+{
+  std::string syncFilename = CreateTempDirFilename ("pcap-sync.pcap");
+  std::string asyncFilename = CreateTempDirFilename ("pcap-async.pcap");
+  WriteFile (syncFilename, false);
+  WriteFile (asyncFilename, true);
+
+  std::vector<uint8_t> sync = ReadAll (syncFilename);
+  std::vector<uint8_t> async = ReadAll (asyncFilename);
+  NS_TEST_ASSERT_MSG_GT (sync.size (), 5000 * 16, "File too short");
+  NS_TEST_ASSERT_MSG_EQ (async.size (), sync.size (), "Files of different sizes");
+  NS_TEST_ASSERT_MSG_EQ ((async == sync), true, "Files differ");
+
+  std::remove (syncFilename.c_str ());
+  std::remove (asyncFilename.c_str ());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check the blocks of a pcapng file.
+ */
+class PcapAsyncPcapngTestCase : public TestCase
+{
+public:
+  PcapAsyncPcapngTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PcapAsyncPcapngTestCase::PcapAsyncPcapngTestCase ()
+  : TestCase ("Check the blocks of a pcapng file")
+{
+}
+
+void
+PcapAsyncPcapngTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("pcap-async.pcapng");
+  Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+  file->SetAttribute ("AsyncWrite", BooleanValue (true));
+  file->SetAttribute ("Pcapng", BooleanValue (true));
+  file->SetAttribute ("NanosecMode", BooleanValue (true));
+  file->Open (filename, std::ios::out);
+  file->Init (1, 100);
+  const uint32_t records = 1000;
+  for (uint32_t i = 0; i < records; ++i)
+    {
+      file->Write (NanoSeconds (1000000007ULL * i), MakePacket (i));
+    }
+  file->Close ();
+
+  std::vector<uint8_t> data = ReadAll (filename);
+  NS_TEST_ASSERT_MSG_GT (data.size (), 60, "File too short");
+  NS_TEST_ASSERT_MSG_EQ (Get32 (data, 0), 0x0a0d0d0a, "No Section Header Block");
+  NS_TEST_ASSERT_MSG_EQ (Get32 (data, 8), 0x1a2b3c4d, "Wrong byte order magic");
+  uint32_t offset = Get32 (data, 4);
+  NS_TEST_ASSERT_MSG_EQ (Get32 (data, offset), 1, "No Interface Description Block");
+  NS_TEST_ASSERT_MSG_EQ (Get32 (data, offset + 12), 100, "Wrong snaplen");
+  offset += Get32 (data, offset + 4);
+
+  uint32_t i = 0;
+  while (offset < data.size ())
+    {
+      uint32_t length = Get32 (data, offset + 4);
+      NS_TEST_ASSERT_MSG_EQ (Get32 (data, offset), 6, "Not an Enhanced Packet Block");
+      NS_TEST_ASSERT_MSG_EQ (length % 4, 0, "Block not padded");
+      NS_TEST_ASSERT_MSG_EQ (Get32 (data, offset + length - 4), length, "Wrong trailing length");
+      uint64_t ts = (static_cast<uint64_t> (Get32 (data, offset + 12)) << 32) | Get32 (data, offset + 16);
+      NS_TEST_ASSERT_MSG_EQ (ts, 1000000007ULL * i, "Wrong timestamp");
+      uint32_t size = MakePacket (i)->GetSize ();
+      NS_TEST_ASSERT_MSG_EQ (Get32 (data, offset + 20), std::min (size, 100U), "Wrong captured length");
+      NS_TEST_ASSERT_MSG_EQ (Get32 (data, offset + 24), size, "Wrong original length");
+      offset += length;
+      ++i;
+    }
+  NS_TEST_ASSERT_MSG_EQ (offset, data.size (), "Truncated block");
+  NS_TEST_ASSERT_MSG_EQ (i, records, "Wrong number of records");
+  std::remove (filename.c_str ());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check that the records dropped when the buffer is full are accounted for.
+ */
+class PcapAsyncDropTestCase : public TestCase
+{
+public:
+  PcapAsyncDropTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PcapAsyncDropTestCase::PcapAsyncDropTestCase ()
+  : TestCase ("Check the accounting of dropped records")
+{
+}
+
+void
+PcapAsyncDropTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("pcap-async-drop.pcap");
+  Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+  file->SetAttribute ("AsyncWrite", BooleanValue (true));
+  file->SetAttribute ("AsyncBufferSize", UintegerValue (0));
+  file->SetAttribute ("DropWhenFull", BooleanValue (true));
+  file->Open (filename, std::ios::out);
+  file->Init (1);
+  const uint32_t records = 20000;
+  Ptr<Packet> p = Create<Packet> (1000);
+  for (uint32_t i = 0; i < records; ++i)
+    {
+      file->Write (MicroSeconds (i), p);
+    }
+  uint64_t dropped = file->GetNDroppedRecords ();
+  NS_TEST_ASSERT_MSG_EQ (file->GetNBackpressuredRecords (), 0, "Records waited");
+  file->Close ();
+
+  // The file holds the records which were not dropped
+  std::vector<uint8_t> data = ReadAll (filename);
+  NS_TEST_ASSERT_MSG_EQ (data.size (), 24 + (records - dropped) * (16 + 1000), "Wrong file size");
+  std::remove (filename.c_str ());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Asynchronous pcap writer test suite
+ */
+class PcapAsyncWriterTestSuite : public TestSuite
+{
+public:
+  PcapAsyncWriterTestSuite ();
+};
+
+PcapAsyncWriterTestSuite::PcapAsyncWriterTestSuite ()
+  : TestSuite ("pcap-async-writer", UNIT)
+{
+  AddTestCase (new PcapAsyncIdenticalTestCase, TestCase::QUICK);
+  AddTestCase (new PcapAsyncPcapngTestCase, TestCase::QUICK);
+  AddTestCase (new PcapAsyncDropTestCase, TestCase::QUICK);
+}
+
+static PcapAsyncWriterTestSuite g_pcapAsyncWriterTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,750 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <cstdlib>
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "binary-trace-file.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceFile");
+
+NS_OBJECT_ENSURE_REGISTERED (BinaryTraceWriter);
+
+namespace {
+
+const char MAGIC[8] = { 'n', 's', '3', 'b', 't', 'r', 'c', 0 }; //!< Magic of a file
+const uint32_t VERSION = 1;            //!< Version of the file format
+const uint32_t FLAG_PACKET_DATA = 1;   //!< The file stores the packets
+const uint32_t MAX_BLOCK_SIZE = 1 << 30; //!< Sanity limit on the size of a block
+
+/**
+ * The columns of a block
+ */
+enum Column
+{
+  CONTEXTS = 0, //!< The contexts added to the table of strings
+  TIME,         //!< The timestamps
+  NODE,         //!< The node indexes
+  DEVICE,       //!< The device indexes
+  EVENT,        //!< The event types
+  CONTEXT,      //!< The context indexes
+  UID,          //!< The packet uids
+  SIZE,         //!< The packet sizes
+  PACKET,       //!< The serialized packets
+  N_COLUMNS     //!< The number of columns
+};
+
+/**
+ * Append a 32 bits value in little endian
+ * \param buffer the buffer
+ * \param value the value
+ */
+void
+Put32 (std::vector<uint8_t> &buffer, uint32_t value)
+{
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      buffer.push_back ((value >> (8 * i)) & 0xff);
+    }
+}
+
+/**
+ * \param buffer a buffer of at least 4 bytes
+ * \returns the 32 bits value in little endian at the start of the buffer
+ */
+uint32_t
+Get32 (const uint8_t *buffer)
+{
+  return buffer[0] | (buffer[1] << 8) | (buffer[2] << 16) | (static_cast<uint32_t> (buffer[3]) << 24);
+}
+
+/**
+ * Append an unsigned integer, 7 bits per byte
+ * \param buffer the buffer
+ * \param value the value
+ */
+void
+PutVarint (std::vector<uint8_t> &buffer, uint64_t value)
+{
+  while (value >= 0x80)
+    {
+      buffer.push_back ((value & 0x7f) | 0x80);
+      value >>= 7;
+    }
+  buffer.push_back (value);
+}
+
+/**
+ * \param value a signed integer
+ * \returns an unsigned integer which is small when the value is close to 0
+ */
+uint64_t
+ZigZag (int64_t value)
+{
+  return (static_cast<uint64_t> (value) << 1) ^ static_cast<uint64_t> (value >> 63);
+}
+
+/**
+ * \param value the result of ZigZag
+ * \returns the signed integer
+ */
+int64_t
+UnZigZag (uint64_t value)
+{
+  return static_cast<int64_t> (value >> 1) ^ -static_cast<int64_t> (value & 1);
+}
+
+/**
+ * \param context a trace context
+ * \param key the name of a list in the context, such as "/NodeList/"
+ * \returns the index following the key in the context plus one, or 0
+ */
+uint32_t
+ParseIndex (std::string const &context, char const *key)
+{
+  std::string::size_type pos = context.find (key);
+  if (pos == std::string::npos)
+    {
+      return 0;
+    }
+  char const *start = context.c_str () + pos + std::strlen (key);
+  char *end;
+  unsigned long index = std::strtoul (start, &end, 10);
+  if (end == start || (*end != '/' && *end != 0))
+    {
+      return 0;
+    }
+  return index + 1;
+}
+
+const uint32_t LZ4_HASH_BITS = 12;      //!< Size of the LZ4 match finder
+const uint32_t LZ4_MIN_MATCH = 4;       //!< Shortest LZ4 match
+const uint32_t LZ4_LAST_LITERALS = 5;   //!< A block ends with this many literals
+const uint32_t LZ4_MF_LIMIT = 12;       //!< No match starts this close to the end
+const uint32_t LZ4_MAX_DISTANCE = 65535; //!< Farthest LZ4 match
+
+/**
+ * \param buffer a buffer of at least 4 bytes
+ * \returns a hash of the first 4 bytes of the buffer
+ */
+uint32_t
+Lz4Hash (const uint8_t *buffer)
+{
+  uint32_t value;
+  std::memcpy (&value, buffer, sizeof (value));
+  return (value * 2654435761U) >> (32 - LZ4_HASH_BITS);
+}
+
+/**
+ * Append a length in the LZ4 format, after the 15 stored in a token
+ * \param dst the buffer
+ * \param length the length minus 15
+ */
+void
+Lz4PutLength (std::vector<uint8_t> &dst, uint32_t length)
+{
+  while (length >= 255)
+    {
+      dst.push_back (255);
+      length -= 255;
+    }
+  dst.push_back (length);
+}
+
+/**
+ * Append an LZ4 sequence: literals followed by an optional match
+ * \param dst the buffer
+ * \param literals the literals
+ * \param nLiterals the number of literals
+ * \param distance the distance of the match
+ * \param matchLength the length of the match, or 0 for the last sequence
+ */
+void
+Lz4PutSequence (std::vector<uint8_t> &dst, const uint8_t *literals, uint32_t nLiterals,
+                uint32_t distance, uint32_t matchLength)
+{
+  uint32_t match = matchLength > 0 ? matchLength - LZ4_MIN_MATCH : 0;
+  dst.push_back ((std::min (nLiterals, 15U) << 4) | std::min (match, 15U));
+  if (nLiterals >= 15)
+    {
+      Lz4PutLength (dst, nLiterals - 15);
+    }
+  dst.insert (dst.end (), literals, literals + nLiterals);
+  if (matchLength == 0)
+    {
+      return;
+    }
+  dst.push_back (distance & 0xff);
+  dst.push_back (distance >> 8);
+  if (match >= 15)
+    {
+      Lz4PutLength (dst, match - 15);
+    }
+}
+
+/**
+ * Compress a buffer in the LZ4 block format, with a greedy match finder
+ * \param src the buffer
+ * \param size the size of the buffer
+ * \param dst the compressed buffer
+ */
+void
+Lz4Compress (const uint8_t *src, uint32_t size, std::vector<uint8_t> &dst)
+{
+  dst.clear ();
+  std::vector<int32_t> table (1 << LZ4_HASH_BITS, -1);
+  uint32_t anchor = 0;
+  uint32_t ip = 0;
+  while (ip + LZ4_MF_LIMIT <= size)
+    {
+      uint32_t h = Lz4Hash (src + ip);
+      int32_t ref = table[h];
+      table[h] = ip;
+      if (ref < 0 || ip - ref > LZ4_MAX_DISTANCE
+          || std::memcmp (src + ref, src + ip, LZ4_MIN_MATCH) != 0)
+        {
+          ++ip;
+          continue;
+        }
+      uint32_t length = LZ4_MIN_MATCH;
+      uint32_t maxLength = size - LZ4_LAST_LITERALS - ip;
+      while (length < maxLength && src[ref + length] == src[ip + length])
+        {
+          ++length;
+        }
+      Lz4PutSequence (dst, src + anchor, ip - anchor, ip - ref, length);
+      ip += length;
+      anchor = ip;
+    }
+  Lz4PutSequence (dst, src + anchor, size - anchor, 0, 0);
+}
+
+/**
+ * Read a length in the LZ4 format, after the 15 stored in a token
+ * \param src the compressed buffer
+ * \param size the size of the compressed buffer
+ * \param ip the position in the compressed buffer
+ * \param length the length to increase
+ * \returns false if the buffer is truncated
+ */
+bool
+Lz4GetLength (const uint8_t *src, uint32_t size, uint32_t &ip, uint32_t &length)
+{
+  uint8_t byte;
+  do
+    {
+      if (ip >= size)
+        {
+          return false;
+        }
+      byte = src[ip++];
+      length += byte;
+    }
+  while (byte == 255);
+  return true;
+}
+
+/**
+ * Uncompress a buffer in the LZ4 block format
+ * \param src the compressed buffer
+ * \param size the size of the compressed buffer
+ * \param dst the buffer, of the uncompressed size
+ * \returns false if the compressed buffer is corrupted
+ */
+bool
+Lz4Decompress (const uint8_t *src, uint32_t size, std::vector<uint8_t> &dst)
+{
+  uint32_t ip = 0;
+  uint32_t op = 0;
+  while (ip < size)
+    {
+      uint8_t token = src[ip++];
+      uint32_t nLiterals = token >> 4;
+      if (nLiterals == 15 && !Lz4GetLength (src, size, ip, nLiterals))
+        {
+          return false;
+        }
+      if (nLiterals > size - ip || nLiterals > dst.size () - op)
+        {
+          return false;
+        }
+      std::memcpy (&dst[op], src + ip, nLiterals);
+      ip += nLiterals;
+      op += nLiterals;
+      if (ip == size)
+        {
+          break;
+        }
+      if (size - ip < 2)
+        {
+          return false;
+        }
+      uint32_t distance = src[ip] | (src[ip + 1] << 8);
+      ip += 2;
+      uint32_t length = token & 15;
+      if (length == 15 && !Lz4GetLength (src, size, ip, length))
+        {
+          return false;
+        }
+      length += LZ4_MIN_MATCH;
+      if (distance == 0 || distance > op || length > dst.size () - op)
+        {
+          return false;
+        }
+      // The match may overlap the bytes it produces
+      for (uint32_t i = 0; i < length; ++i, ++op)
+        {
+          dst[op] = dst[op - distance];
+        }
+    }
+  return op == dst.size ();
+}
+
+} // anonymous namespace
+
+TypeId
+BinaryTraceWriter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BinaryTraceWriter")
+    .SetParent<Object> ()
+    .SetGroupName ("Network")
+    .AddConstructor<BinaryTraceWriter> ()
+    .AddAttribute ("BlockRecords",
+                   "The number of records of a block. Larger blocks compress "
+                   "better, but more records are lost if the program aborts.",
+                   UintegerValue (4096),
+                   MakeUintegerAccessor (&BinaryTraceWriter::m_blockRecords),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Compress",
+                   "Whether to compress the blocks.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&BinaryTraceWriter::m_compress),
+                   MakeBooleanChecker ())
+    .AddAttribute ("PacketData",
+                   "Whether to store the serialized packets, with their "
+                   "metadata, so that the packets can be printed when the "
+                   "file is read.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&BinaryTraceWriter::m_packetData),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+BinaryTraceWriter::BinaryTraceWriter ()
+  : m_os (0),
+    m_columns (N_COLUMNS),
+    m_nRecords (0),
+    m_lastTime (0),
+    m_lastUid (0),
+    m_totalRecords (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BinaryTraceWriter::~BinaryTraceWriter ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+BinaryTraceWriter::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+  Object::DoDispose ();
+}
+
+void
+BinaryTraceWriter::Open (std::ostream *os)
+{
+  NS_LOG_FUNCTION (this << os);
+  NS_ASSERT (!IsOpen ());
+  m_os = os;
+  m_contexts.clear ();
+  m_totalRecords = 0;
+  ResetBlock ();
+
+  std::vector<uint8_t> header (MAGIC, MAGIC + sizeof (MAGIC));
+  Put32 (header, VERSION);
+  Put32 (header, m_packetData ? FLAG_PACKET_DATA : 0);
+  m_os->write (reinterpret_cast<const char *> (&header[0]), header.size ());
+}
+
+void
+BinaryTraceWriter::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!IsOpen ())
+    {
+      return;
+    }
+  WriteBlock ();
+  m_os->flush ();
+  m_os = 0;
+}
+
+bool
+BinaryTraceWriter::IsOpen (void) const
+{
+  return m_os != 0;
+}
+
+uint64_t
+BinaryTraceWriter::GetNRecords (void) const
+{
+  return m_totalRecords;
+}
+
+const BinaryTraceWriter::ContextInfo &
+BinaryTraceWriter::GetContextInfo (std::string const &context)
+{
+  std::map<std::string, ContextInfo>::iterator it = m_contexts.find (context);
+  if (it != m_contexts.end ())
+    {
+      return it->second;
+    }
+  ContextInfo info;
+  info.id = m_contexts.size () + 1;
+  info.node = ParseIndex (context, "/NodeList/");
+  info.device = ParseIndex (context, "/DeviceList/");
+  it = m_contexts.insert (std::make_pair (context, info)).first;
+  // The reader adds the new contexts to its table before reading the
+  // records of the block
+  std::vector<uint8_t> &column = m_columns[CONTEXTS];
+  PutVarint (column, context.size ());
+  column.insert (column.end (), context.begin (), context.end ());
+  return it->second;
+}
+
+void
+BinaryTraceWriter::Write (char event, std::string const &context, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << event << context << p);
+  if (!IsOpen ())
+    {
+      return;
+    }
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  PutVarint (m_columns[TIME], ZigZag (now - m_lastTime));
+  m_lastTime = now;
+
+  uint32_t id = 0;
+  uint32_t node = 0;
+  uint32_t device = 0;
+  if (context.empty ())
+    {
+      uint32_t simulatorContext = Simulator::GetContext ();
+      node = simulatorContext == 0xffffffff ? 0 : simulatorContext + 1;
+    }
+  else
+    {
+      const ContextInfo &info = GetContextInfo (context);
+      id = info.id;
+      node = info.node;
+      device = info.device;
+    }
+  PutVarint (m_columns[NODE], node);
+  PutVarint (m_columns[DEVICE], device);
+  m_columns[EVENT].push_back (event);
+  PutVarint (m_columns[CONTEXT], id);
+
+  uint64_t uid = p->GetUid ();
+  PutVarint (m_columns[UID], ZigZag (static_cast<int64_t> (uid - m_lastUid)));
+  m_lastUid = uid;
+  PutVarint (m_columns[SIZE], p->GetSize ());
+
+  if (m_packetData)
+    {
+      // Packet::Serialize writes 32 bits words
+      uint32_t size = p->GetSerializedSize ();
+      m_serialized.resize (size / 4 + 1);
+      uint8_t *buffer = reinterpret_cast<uint8_t *> (&m_serialized[0]);
+      p->Serialize (buffer, size);
+      std::vector<uint8_t> &column = m_columns[PACKET];
+      PutVarint (column, size);
+      column.insert (column.end (), buffer, buffer + size);
+    }
+
+  ++m_totalRecords;
+  if (++m_nRecords >= m_blockRecords)
+    {
+      WriteBlock ();
+    }
+}
+
+void
+BinaryTraceWriter::WriteBlock (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_nRecords == 0)
+    {
+      return;
+    }
+  m_raw.clear ();
+  for (uint32_t i = 0; i < N_COLUMNS; ++i)
+    {
+      Put32 (m_raw, m_columns[i].size ());
+      m_raw.insert (m_raw.end (), m_columns[i].begin (), m_columns[i].end ());
+    }
+
+  const std::vector<uint8_t> *stored = &m_raw;
+  if (m_compress)
+    {
+      Lz4Compress (&m_raw[0], m_raw.size (), m_compressed);
+      if (m_compressed.size () < m_raw.size ())
+        {
+          stored = &m_compressed;
+        }
+    }
+
+  std::vector<uint8_t> header;
+  Put32 (header, m_nRecords);
+  Put32 (header, m_raw.size ());
+  Put32 (header, stored->size ());
+  m_os->write (reinterpret_cast<const char *> (&header[0]), header.size ());
+  m_os->write (reinterpret_cast<const char *> (&(*stored)[0]), stored->size ());
+  NS_LOG_LOGIC ("Block of " << m_nRecords << " records, " << m_raw.size ()
+                            << " bytes stored in " << stored->size ());
+  ResetBlock ();
+}
+
+void
+BinaryTraceWriter::ResetBlock (void)
+{
+  for (uint32_t i = 0; i < N_COLUMNS; ++i)
+    {
+      m_columns[i].clear ();
+    }
+  m_nRecords = 0;
+  m_lastTime = 0;
+  m_lastUid = 0;
+}
+
+BinaryTraceReader::BinaryTraceReader ()
+  : m_packetData (false),
+    m_start (N_COLUMNS),
+    m_end (N_COLUMNS),
+    m_left (0),
+    m_lastTime (0),
+    m_lastUid (0),
+    m_error (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+BinaryTraceReader::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_file.open (filename.c_str (), std::ios::in | std::ios::binary);
+  uint8_t header[16];
+  m_file.read (reinterpret_cast<char *> (header), sizeof (header));
+  if (m_file.gcount () != sizeof (header)
+      || std::memcmp (header, MAGIC, sizeof (MAGIC)) != 0
+      || Get32 (header + 8) != VERSION)
+    {
+      m_file.close ();
+      return false;
+    }
+  m_packetData = (Get32 (header + 12) & FLAG_PACKET_DATA) != 0;
+  m_contexts.clear ();
+  m_left = 0;
+  m_error = false;
+  return true;
+}
+
+bool
+BinaryTraceReader::HasPacketData (void) const
+{
+  return m_packetData;
+}
+
+bool
+BinaryTraceReader::ReadBlock (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint8_t header[12];
+  m_file.read (reinterpret_cast<char *> (header), sizeof (header));
+  if (m_file.gcount () == 0)
+    {
+      return false;
+    }
+  uint32_t nRecords = Get32 (header);
+  uint32_t rawSize = Get32 (header + 4);
+  uint32_t storedSize = Get32 (header + 8);
+  if (m_file.gcount () != sizeof (header) || rawSize > MAX_BLOCK_SIZE || storedSize > rawSize)
+    {
+      m_error = true;
+      return false;
+    }
+  m_stored.resize (storedSize);
+  m_file.read (reinterpret_cast<char *> (&m_stored[0]), storedSize);
+  if (static_cast<uint32_t> (m_file.gcount ()) != storedSize)
+    {
+      m_error = true;
+      return false;
+    }
+  if (storedSize == rawSize)
+    {
+      m_block.swap (m_stored);
+    }
+  else
+    {
+      m_block.resize (rawSize);
+      if (!Lz4Decompress (&m_stored[0], storedSize, m_block))
+        {
+          m_error = true;
+          return false;
+        }
+    }
+
+  uint32_t offset = 0;
+  for (uint32_t i = 0; i < N_COLUMNS; ++i)
+    {
+      if (rawSize - offset < 4 || rawSize - offset - 4 < Get32 (&m_block[offset]))
+        {
+          m_error = true;
+          return false;
+        }
+      m_start[i] = offset + 4;
+      m_end[i] = m_start[i] + Get32 (&m_block[offset]);
+      offset = m_end[i];
+    }
+
+  while (m_start[CONTEXTS] < m_end[CONTEXTS])
+    {
+      uint64_t length = ReadVarint (CONTEXTS);
+      if (m_error || length > m_end[CONTEXTS] - m_start[CONTEXTS])
+        {
+          m_error = true;
+          return false;
+        }
+      const char *start = reinterpret_cast<const char *> (&m_block[m_start[CONTEXTS]]);
+      std::string context (start, length);
+      m_start[CONTEXTS] += length;
+      m_contexts.push_back (context);
+    }
+  m_left = nRecords;
+  m_lastTime = 0;
+  m_lastUid = 0;
+  return true;
+}
+
+uint64_t
+BinaryTraceReader::ReadVarint (uint32_t column)
+{
+  uint64_t value = 0;
+  for (uint32_t shift = 0; shift < 64; shift += 7)
+    {
+      if (m_start[column] >= m_end[column])
+        {
+          break;
+        }
+      uint8_t byte = m_block[m_start[column]++];
+      value |= static_cast<uint64_t> (byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0)
+        {
+          return value;
+        }
+    }
+  m_error = true;
+  return 0;
+}
+
+bool
+BinaryTraceReader::Read (Record &record)
+{
+  NS_LOG_FUNCTION (this);
+  while (m_left == 0)
+    {
+      if (m_error || !ReadBlock ())
+        {
+          return false;
+        }
+    }
+
+  m_lastTime += UnZigZag (ReadVarint (TIME));
+  record.time = TimeStep (m_lastTime);
+  uint32_t node = ReadVarint (NODE);
+  record.node = node - 1;
+  uint32_t device = ReadVarint (DEVICE);
+  record.device = device - 1;
+  if (m_start[EVENT] < m_end[EVENT])
+    {
+      record.event = m_block[m_start[EVENT]++];
+    }
+  else
+    {
+      m_error = true;
+    }
+  uint64_t id = ReadVarint (CONTEXT);
+  if (id > m_contexts.size ())
+    {
+      m_error = true;
+    }
+  record.context = id == 0 || m_error ? std::string () : m_contexts[id - 1];
+  m_lastUid += UnZigZag (ReadVarint (UID));
+  record.uid = m_lastUid;
+  record.size = ReadVarint (SIZE);
+
+  record.packet = 0;
+  if (m_packetData && !m_error)
+    {
+      uint64_t size = ReadVarint (PACKET);
+      if (m_error || size > m_end[PACKET] - m_start[PACKET])
+        {
+          m_error = true;
+          return false;
+        }
+      // The Packet constructor reads 32 bits words
+      m_serialized.resize (size / 4 + 1);
+      uint8_t *buffer = reinterpret_cast<uint8_t *> (&m_serialized[0]);
+      std::memcpy (buffer, &m_block[m_start[PACKET]], size);
+      m_start[PACKET] += size;
+      record.packet = Create<Packet> (buffer, size, true);
+    }
+  --m_left;
+  return !m_error;
+}
+
+void
+BinaryTraceReader::PrintAscii (std::ostream &os, Record const &record)
+{
+  os << record.event << " " << record.time.GetSeconds () << " ";
+  if (!record.context.empty ())
+    {
+      os << record.context << " ";
+    }
+  if (record.packet != 0)
+    {
+      os << *record.packet;
+    }
+  else
+    {
+      os << "uid=" << record.uid << " size=" << record.size;
+    }
+  os << "\n";
+}
+
+} // namespace ns3
@@ -0,0 +1,241 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_FILE_H
+#define BINARY_TRACE_FILE_H
+
+#include <string>
+#include <fstream>
+#include <map>
+#include <vector>
+#include <stdint.h>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \ingroup network
+ * \defgroup binary-trace Binary trace files
+ *
+ * A compact replacement for the text files written by the default sinks
+ * of AsciiTraceHelper.
+ *
+ * The events are stored in blocks of records. Each block is stored column
+ * by column: the timestamps, the node and device indexes, the event
+ * types, the trace contexts, the packet uids, the packet sizes and,
+ * optionally, the serialized packets. The timestamps and uids are stored
+ * as variable-length differences from the previous record, the contexts
+ * as indexes into a table of strings which grows with the file. Each
+ * block is then compressed with the LZ4 block format.
+ *
+ * The serialized packets carry the packet metadata, so that the reader
+ * can print the packets exactly as the ascii sinks would have.
+ *
+ * File layout, all integers in little endian:
+ * - header: the 8 bytes "ns3btrc\0", a 32 bits version, 32 bits of flags
+ * - blocks: the number of records, the size of the columns, the size of
+ *   the stored data (equal to the size of the columns if the block could
+ *   not be compressed), then the stored data.
+ */
+
+/**
+ * \ingroup binary-trace
+ *
+ * \brief Write trace events to a binary trace file
+ */
+class BinaryTraceWriter : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  BinaryTraceWriter ();
+  virtual ~BinaryTraceWriter ();
+
+  /**
+   * Start writing to a stream. The stream must stay valid until Close.
+   *
+   * \param os the output stream, opened in binary mode
+   */
+  void Open (std::ostream *os);
+
+  /**
+   * Write the pending records, and stop writing to the stream.
+   */
+  void Close (void);
+
+  /**
+   * \returns true if the writer has a stream
+   */
+  bool IsOpen (void) const;
+
+  /**
+   * \brief Write an event
+   *
+   * The node and device indexes are parsed from contexts of the form
+   * "/NodeList/n/DeviceList/d/...". With an empty context, the node
+   * index is the context of the current simulator event.
+   *
+   * \param event the event type: '+', '-', 'd', 'r' or 't'
+   * \param context the trace context, or an empty string
+   * \param p the packet
+   */
+  void Write (char event, std::string const &context, Ptr<const Packet> p);
+
+  /**
+   * \returns the number of records written
+   */
+  uint64_t GetNRecords (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /**
+   * Compress and write the block of records.
+   */
+  void WriteBlock (void);
+
+  /**
+   * Empty the columns of the block of records.
+   */
+  void ResetBlock (void);
+
+  /**
+   * Node and device indexes of a context
+   */
+  struct ContextInfo
+  {
+    uint32_t id;     //!< Index in the table of strings, plus one
+    uint32_t node;   //!< Node index plus one, or zero
+    uint32_t device; //!< Device index plus one, or zero
+  };
+
+  /**
+   * Find a context in the table of strings, adding it if needed
+   * \param context a trace context
+   * \returns the indexes of the context
+   */
+  const ContextInfo &GetContextInfo (std::string const &context);
+
+  std::ostream *m_os;                //!< The output stream
+  uint32_t m_blockRecords;           //!< Number of records of a block
+  bool m_compress;                   //!< Whether to compress the blocks
+  bool m_packetData;                 //!< Whether to store the serialized packets
+  std::vector<std::vector<uint8_t> > m_columns; //!< The columns of the block
+  std::vector<uint32_t> m_serialized; //!< Space to serialize a packet
+  std::vector<uint8_t> m_raw;        //!< Space to assemble a block
+  std::vector<uint8_t> m_compressed; //!< Space to compress a block
+  std::map<std::string, ContextInfo> m_contexts; //!< The table of strings
+  uint32_t m_nRecords;               //!< Number of records of the block
+  int64_t m_lastTime;                //!< Timestamp of the previous record
+  uint64_t m_lastUid;                //!< Uid of the previous record
+  uint64_t m_totalRecords;           //!< Number of records written
+};
+
+/**
+ * \ingroup binary-trace
+ *
+ * \brief Read the events of a binary trace file
+ */
+class BinaryTraceReader
+{
+public:
+  /**
+   * An event read from a file
+   */
+  struct Record
+  {
+    Time time;           //!< The time of the event
+    char event;          //!< The event type
+    uint32_t node;       //!< The node index, or 0xffffffff if unknown
+    uint32_t device;     //!< The device index, or 0xffffffff if unknown
+    std::string context; //!< The trace context, possibly empty
+    uint64_t uid;        //!< The packet uid
+    uint32_t size;       //!< The packet size
+    Ptr<Packet> packet;  //!< The packet, if the file stores packets
+  };
+
+  BinaryTraceReader ();
+
+  /**
+   * \param filename the name of the file
+   * \returns false if the file could not be opened or is not a binary
+   *          trace file
+   */
+  bool Open (std::string const &filename);
+
+  /**
+   * \brief Read the next event
+   * \param record the event read
+   * \returns false at the end of the file, or if the file is corrupted
+   */
+  bool Read (Record &record);
+
+  /**
+   * \returns true if the file stores the serialized packets
+   */
+  bool HasPacketData (void) const;
+
+  /**
+   * \brief Print an event as the default ascii trace sinks do.
+   *
+   * The packets are printed as Packet::Print does when the file stores
+   * them, hence Packet::EnablePrinting should be called before the file
+   * is read. Otherwise, the uid and size of the packet are printed.
+   *
+   * \param os the output stream
+   * \param record the event
+   */
+  static void PrintAscii (std::ostream &os, Record const &record);
+
+private:
+  /**
+   * Read and uncompress the next block.
+   * \returns false at the end of the file, or if the file is corrupted
+   */
+  bool ReadBlock (void);
+
+  /**
+   * Read an unsigned integer from a column of the current block.
+   * \param column the column
+   * \returns the value
+   */
+  uint64_t ReadVarint (uint32_t column);
+
+  std::ifstream m_file;             //!< The file
+  bool m_packetData;                //!< Whether the file stores packets
+  std::vector<uint8_t> m_block;     //!< The uncompressed block
+  std::vector<uint8_t> m_stored;    //!< The block as stored
+  std::vector<uint32_t> m_serialized; //!< Space to deserialize a packet
+  std::vector<uint32_t> m_start;    //!< Start of each column in the block
+  std::vector<uint32_t> m_end;      //!< End of each column in the block
+  std::vector<std::string> m_contexts; //!< The table of strings
+  uint32_t m_left;                  //!< Records left in the block
+  int64_t m_lastTime;               //!< Timestamp of the previous record
+  uint64_t m_lastUid;               //!< Uid of the previous record
+  bool m_error;                     //!< Whether the file is corrupted
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_FILE_H */
@@ -0,0 +1,412 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef OPEN_HASH_MAP_H
+#define OPEN_HASH_MAP_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ * \brief A hash map with open addressing.
+ *
+ * The elements are stored in a single array of slots, indexed by linear
+ * probing: a lookup touches a few contiguous slots instead of following
+ * the bucket lists of a node-based map, and an insertion does not
+ * allocate memory unless the table grows. The number of slots is a
+ * power of two, and the hash of the keys is mixed by a multiplicative
+ * (Fibonacci) hash, so that hash functions returning the key itself
+ * (such as Ipv4AddressHash) spread over the whole table.
+ *
+ * Erasing an element shifts the following elements of its probe
+ * sequence backwards instead of leaving a tombstone, so lookups never
+ * slow down as elements come and go.
+ *
+ * The interface is a subset of that of std::map. Unlike std::map,
+ * inserting or erasing an element invalidates all the iterators, and
+ * the iteration order is unspecified.
+ *
+ * \tparam Key the key type; must be default-constructible and
+ *         equality-comparable
+ * \tparam Value the mapped type; must be default-constructible
+ * \tparam Hash a functor returning the hash of a key
+ */
+template <typename Key, typename Value, typename Hash>
+class OpenHashMap
+{
+public:
+  /// Element type
+  typedef std::pair<Key, Value> value_type;
+  /// Key type
+  typedef Key key_type;
+  /// Mapped type
+  typedef Value mapped_type;
+
+private:
+  /**
+   * \brief Iterator over the used slots of the table
+   * \tparam Map the (possibly const) map type
+   * \tparam Ref the (possibly const) reference to an element
+   * \tparam Ptr the (possibly const) pointer to an element
+   */
+  template <typename Map, typename Ref, typename Ptr>
+  class Iterator
+  {
+public:
+    /// Iterator category
+    typedef std::forward_iterator_tag iterator_category;
+    /// Element type
+    typedef typename OpenHashMap::value_type value_type;
+    /// Distance type
+    typedef std::ptrdiff_t difference_type;
+    /// Pointer type
+    typedef Ptr pointer;
+    /// Reference type
+    typedef Ref reference;
+
+    Iterator ()
+      : m_map (0),
+        m_index (0)
+    {
+    }
+    /**
+     * \brief Constructor
+     * \param map the map
+     * \param index the slot pointed to, or the number of slots for end ()
+     */
+    Iterator (Map *map, uint32_t index)
+      : m_map (map),
+        m_index (index)
+    {
+    }
+    /**
+     * \brief Conversion from a non-const iterator
+     * \param o the other iterator
+     */
+    template <typename M, typename R, typename P>
+    Iterator (const Iterator<M, R, P> &o)
+      : m_map (o.m_map),
+        m_index (o.m_index)
+    {
+    }
+    /** \returns the element pointed to */
+    Ref operator* () const
+    {
+      return m_map->m_slots[m_index];
+    }
+    /** \returns a pointer to the element pointed to */
+    Ptr operator-> () const
+    {
+      return &m_map->m_slots[m_index];
+    }
+    /** \returns the iterator, advanced to the next element */
+    Iterator &operator++ ()
+    {
+      m_index = m_map->NextUsed (m_index + 1);
+      return *this;
+    }
+    /** \returns a copy of the iterator before it is advanced */
+    Iterator operator++ (int)
+    {
+      Iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    /**
+     * \param o the other iterator
+     * \returns true if both iterators point to the same slot
+     */
+    bool operator== (const Iterator &o) const
+    {
+      return m_index == o.m_index && m_map == o.m_map;
+    }
+    /**
+     * \param o the other iterator
+     * \returns true if the iterators point to different slots
+     */
+    bool operator!= (const Iterator &o) const
+    {
+      return !(*this == o);
+    }
+
+    Map *m_map;       //!< The map
+    uint32_t m_index; //!< The slot pointed to
+  };
+
+public:
+  /// Iterator
+  typedef Iterator<OpenHashMap, value_type &, value_type *> iterator;
+  /// Const iterator
+  typedef Iterator<const OpenHashMap, const value_type &, const value_type *> const_iterator;
+
+  OpenHashMap ()
+    : m_size (0),
+      m_shift (64)
+  {
+  }
+
+  /** \returns an iterator to the first element */
+  iterator begin (void)
+  {
+    return iterator (this, NextUsed (0));
+  }
+  /** \returns an iterator past the last element */
+  iterator end (void)
+  {
+    return iterator (this, m_slots.size ());
+  }
+  /** \returns an iterator to the first element */
+  const_iterator begin (void) const
+  {
+    return const_iterator (this, NextUsed (0));
+  }
+  /** \returns an iterator past the last element */
+  const_iterator end (void) const
+  {
+    return const_iterator (this, m_slots.size ());
+  }
+
+  /** \returns the number of elements */
+  std::size_t size (void) const
+  {
+    return m_size;
+  }
+  /** \returns true if the map has no element */
+  bool empty (void) const
+  {
+    return m_size == 0;
+  }
+
+  /**
+   * \param key the key to look for
+   * \returns an iterator to the element with that key, or end ()
+   */
+  iterator find (const Key &key)
+  {
+    return iterator (this, Find (key));
+  }
+  /**
+   * \param key the key to look for
+   * \returns an iterator to the element with that key, or end ()
+   */
+  const_iterator find (const Key &key) const
+  {
+    return const_iterator (this, Find (key));
+  }
+
+  /**
+   * \brief Insert an element, unless an element with the same key exists
+   * \param v the element
+   * \returns an iterator to the element with the key of v, and true if
+   * v has been inserted
+   */
+  std::pair<iterator, bool> insert (const value_type &v)
+  {
+    uint32_t i = Find (v.first);
+    if (i != m_slots.size ())
+      {
+        return std::make_pair (iterator (this, i), false);
+      }
+    if ((m_size + 1) * 4 > m_slots.size () * 3)
+      {
+        Rehash (m_slots.empty () ? 8 : m_slots.size () * 2);
+      }
+    i = Place (v);
+    return std::make_pair (iterator (this, i), true);
+  }
+
+  /**
+   * \param key the key
+   * \returns a reference to the value with that key, inserted with the
+   * default value if needed
+   */
+  Value &operator[] (const Key &key)
+  {
+    return insert (value_type (key, Value ())).first->second;
+  }
+
+  /**
+   * \brief Erase an element
+   * \param it an iterator to the element
+   */
+  void erase (iterator it)
+  {
+    NS_ASSERT (it.m_map == this && m_used[it.m_index]);
+    EraseSlot (it.m_index);
+  }
+  /**
+   * \brief Erase the element with a key, if any
+   * \param key the key
+   * \returns the number of elements erased
+   */
+  std::size_t erase (const Key &key)
+  {
+    uint32_t i = Find (key);
+    if (i == m_slots.size ())
+      {
+        return 0;
+      }
+    EraseSlot (i);
+    return 1;
+  }
+
+  /**
+   * \brief Erase all the elements, keeping the storage
+   */
+  void clear (void)
+  {
+    for (uint32_t i = 0; i < m_slots.size (); ++i)
+      {
+        if (m_used[i])
+          {
+            m_slots[i] = value_type ();
+            m_used[i] = 0;
+          }
+      }
+    m_size = 0;
+  }
+
+private:
+  /**
+   * \param key a key
+   * \returns the first slot of the probe sequence of the key
+   */
+  uint32_t Home (const Key &key) const
+  {
+    uint64_t h = static_cast<uint64_t> (m_hash (key));
+    return static_cast<uint32_t> ((h * 0x9E3779B97F4A7C15ULL) >> m_shift);
+  }
+  /**
+   * \param key a key
+   * \returns the slot holding the key, or the number of slots
+   */
+  uint32_t Find (const Key &key) const
+  {
+    if (m_size == 0)
+      {
+        return m_slots.size ();
+      }
+    uint32_t mask = m_slots.size () - 1;
+    for (uint32_t i = Home (key); m_used[i]; i = (i + 1) & mask)
+      {
+        if (m_slots[i].first == key)
+          {
+            return i;
+          }
+      }
+    return m_slots.size ();
+  }
+  /**
+   * \param i a slot
+   * \returns the first used slot at or after i, or the number of slots
+   */
+  uint32_t NextUsed (uint32_t i) const
+  {
+    while (i < m_used.size () && !m_used[i])
+      {
+        ++i;
+      }
+    return i;
+  }
+  /**
+   * \brief Store an element whose key is not in the table
+   * \param v the element
+   * \returns the slot of the element
+   */
+  uint32_t Place (const value_type &v)
+  {
+    uint32_t mask = m_slots.size () - 1;
+    uint32_t i = Home (v.first);
+    while (m_used[i])
+      {
+        i = (i + 1) & mask;
+      }
+    m_slots[i] = v;
+    m_used[i] = 1;
+    ++m_size;
+    return i;
+  }
+  /**
+   * \brief Resize the table
+   * \param n the new number of slots, a power of two
+   */
+  void Rehash (uint32_t n)
+  {
+    std::vector<value_type> slots (n);
+    std::vector<uint8_t> used (n, 0);
+    slots.swap (m_slots);
+    used.swap (m_used);
+    m_size = 0;
+    m_shift = 64;
+    for (uint32_t s = n; s > 1; s >>= 1)
+      {
+        --m_shift;
+      }
+    for (uint32_t i = 0; i < slots.size (); ++i)
+      {
+        if (used[i])
+          {
+            Place (slots[i]);
+          }
+      }
+  }
+  /**
+   * \brief Erase the element of a slot, and move back the following
+   * elements of its probe sequence
+   * \param i the slot
+   */
+  void EraseSlot (uint32_t i)
+  {
+    uint32_t mask = m_slots.size () - 1;
+    uint32_t j = i;
+    while (true)
+      {
+        j = (j + 1) & mask;
+        if (!m_used[j])
+          {
+            break;
+          }
+        // The element of slot j can fill the hole at i only if its home
+        // slot is not in the (cyclic) interval (i, j]
+        uint32_t home = Home (m_slots[j].first);
+        if (((j - home) & mask) >= ((j - i) & mask))
+          {
+            m_slots[i] = m_slots[j];
+            i = j;
+          }
+      }
+    m_slots[i] = value_type ();
+    m_used[i] = 0;
+    --m_size;
+  }
+
+  std::vector<value_type> m_slots; //!< The slots
+  std::vector<uint8_t> m_used;     //!< Whether each slot holds an element
+  uint32_t m_size;                 //!< Number of elements
+  uint32_t m_shift;                //!< 64 - log2 (number of slots)
+  Hash m_hash;                     //!< The hash functor
+};
+
+} // namespace ns3
+
+#endif /* OPEN_HASH_MAP_H */
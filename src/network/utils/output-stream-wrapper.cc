@@ -17,17 +17,21 @@
  */
 
 #include "output-stream-wrapper.h"
+#include "binary-trace-file.h"
 #include "ns3/log.h"
 #include "ns3/fatal-impl.h"
 #include "ns3/abort.h"
 #include <fstream>
+#include <iostream>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("OutputStreamWrapper");
 
 OutputStreamWrapper::OutputStreamWrapper (std::string filename, std::ios::openmode filemode)
-  : m_destroyable (true)
+  : m_destroyable (true),
+    m_filename (filename),
+    m_textStream (0)
 {
   NS_LOG_FUNCTION (this << filename << filemode);
   std::ofstream* os = new std::ofstream ();
@@ -39,7 +43,7 @@ OutputStreamWrapper::OutputStreamWrapper (std::string filename, std::ios::openmo
 }
 
 OutputStreamWrapper::OutputStreamWrapper (std::ostream* os)
-  : m_ostream (os), m_destroyable (false)
+  : m_ostream (os), m_destroyable (false), m_textStream (0)
 {
   NS_LOG_FUNCTION (this << os);
   FatalImpl::RegisterStream (m_ostream);
@@ -49,6 +53,17 @@ OutputStreamWrapper::OutputStreamWrapper (std::ostream* os)
 OutputStreamWrapper::~OutputStreamWrapper ()
 {
   NS_LOG_FUNCTION (this);
+  if (m_binaryTraceWriter != 0)
+    {
+      m_binaryTraceWriter->Close ();
+      m_binaryTraceWriter = 0;
+    }
+  if (m_textStream != 0)
+    {
+      FatalImpl::UnregisterStream (m_textStream);
+      delete m_textStream;
+      m_textStream = 0;
+    }
   FatalImpl::UnregisterStream (m_ostream);
   if (m_destroyable) delete m_ostream;
   m_ostream = 0;
@@ -58,7 +73,35 @@ std::ostream *
 OutputStreamWrapper::GetStream (void)
 {
   NS_LOG_FUNCTION (this);
-  return m_ostream;
+  if (m_binaryTraceWriter == 0)
+    {
+      return m_ostream;
+    }
+  if (m_textStream == 0)
+    {
+      NS_ABORT_MSG_IF (m_filename.empty (), "Text written to a binary trace stream; "
+                       "this trace sink does not support the AsciiTraceBinary global value");
+      std::string textFilename = m_filename + ".txt";
+      std::cerr << "Warning: a trace sink of " << m_filename << " does not support "
+                << "the binary trace format; its text is written to " << textFilename << std::endl;
+      m_textStream = new std::ofstream (textFilename.c_str (), std::ios::out);
+      NS_ABORT_MSG_UNLESS (m_textStream->is_open (), "Unable to Open " << textFilename);
+      FatalImpl::RegisterStream (m_textStream);
+    }
+  return m_textStream;
+}
+
+void
+OutputStreamWrapper::SetBinaryTraceWriter (Ptr<BinaryTraceWriter> writer)
+{
+  NS_LOG_FUNCTION (this << writer);
+  m_binaryTraceWriter = writer;
+}
+
+Ptr<BinaryTraceWriter>
+OutputStreamWrapper::GetBinaryTraceWriter (void) const
+{
+  return m_binaryTraceWriter;
 }
 
 } // namespace ns3
@@ -26,6 +26,8 @@
 
 namespace ns3 {
 
+class BinaryTraceWriter;
+
 /**
  * @brief A class encapsulating an output stream.
  *
@@ -86,15 +88,41 @@ public:
   /**
    * Return a pointer to an ostream previously set in the wrapper.
    *
+   * If the stream has a binary trace writer, the text written by a trace
+   * sink which does not support the binary trace format would corrupt the
+   * binary trace file.  A text file named after the file of the stream,
+   * with a ".txt" suffix, is then opened on the first call and returned
+   * instead, and a warning is printed.  The simulation is aborted if the
+   * wrapper was not created with a file name.
+   *
    * \see SetStream
    *
-   * \returns a pointer to the encapsulated std::ostream
+   * \returns a pointer to the encapsulated std::ostream, or to the text
+   *          file of a stream with a binary trace writer
    */
   std::ostream *GetStream (void);
 
+  /**
+   * Make the ascii trace sinks write their events in the binary trace
+   * format to this stream, through AsciiTraceHelper::WriteBinaryEvent.
+   * The writer is closed with the stream.
+   *
+   * \param writer the binary trace writer, opened on the stream
+   */
+  void SetBinaryTraceWriter (Ptr<BinaryTraceWriter> writer);
+
+  /**
+   * \returns the binary trace writer of this stream, or 0 if the events
+   *          are written as text
+   */
+  Ptr<BinaryTraceWriter> GetBinaryTraceWriter (void) const;
+
 private:
   std::ostream *m_ostream; //!< The output stream
   bool m_destroyable; //!< Can be destroyed
+  std::string m_filename; //!< The file name, if created with one
+  Ptr<BinaryTraceWriter> m_binaryTraceWriter; //!< Binary trace writer, if any
+  std::ofstream *m_textStream; //!< Text file of the sinks not supporting the binary trace writer
 };
 
 } // namespace ns3
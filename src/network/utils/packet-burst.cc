@@ -23,6 +23,7 @@
 #include "ns3/packet.h"
 #include "packet-burst.h"
 #include "ns3/log.h"
+#include "ns3/simulator.h"
 
 namespace ns3 {
 
@@ -62,6 +63,7 @@ PacketBurst::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
   m_packets.clear ();
+  m_arrivals.clear ();
 }
 
 Ptr<PacketBurst> PacketBurst::Copy (void) const
@@ -75,6 +77,7 @@ Ptr<PacketBurst> PacketBurst::Copy (void) const
       Ptr<Packet> packet = (*iter)->Copy ();
       burst->AddPacket (packet);
     }
+  burst->m_arrivals = m_arrivals;
   return burst;
 }
 
@@ -88,6 +91,19 @@ PacketBurst::AddPacket (Ptr<Packet> packet)
     }
 }
 
+void
+PacketBurst::AddPacket (Ptr<Packet> packet, Time arrival)
+{
+  NS_LOG_FUNCTION (this << packet << arrival);
+  if (packet)
+    {
+      // Packets added without their arrival time are taken as received now
+      m_arrivals.resize (m_packets.size (), Simulator::Now ());
+      m_packets.push_back (packet);
+      m_arrivals.push_back (arrival);
+    }
+}
+
 std::list<Ptr<Packet> >
 PacketBurst::GetPackets (void) const
 {
@@ -116,6 +132,18 @@ PacketBurst::GetSize (void) const
   return size;
 }
 
+Time
+PacketBurst::GetArrivalTime (uint32_t index) const
+{
+  NS_LOG_FUNCTION (this << index);
+  NS_ASSERT (index < m_packets.size ());
+  if (index < m_arrivals.size ())
+    {
+      return m_arrivals[index];
+    }
+  return Simulator::Now ();
+}
+
 std::list<Ptr<Packet> >::const_iterator
 PacketBurst::Begin (void) const
 {
@@ -23,7 +23,9 @@
 
 #include <stdint.h>
 #include <list>
+#include <vector>
 #include "ns3/object.h"
+#include "ns3/nstime.h"
 
 namespace ns3 {
 
@@ -51,6 +53,14 @@ public:
    * \param packet the packet to add
    */
   void AddPacket (Ptr<Packet> packet);
+  /**
+   * \brief add a packet to the list of packet, with the time it has been
+   * received, when a device holds packets before handing them to the higher
+   * layers in a burst
+   * \param packet the packet to add
+   * \param arrival the time the packet has been received
+   */
+  void AddPacket (Ptr<Packet> packet, Time arrival);
   /**
    * \return the list of packet of this burst
    */
@@ -63,6 +73,12 @@ public:
    * \return the size of the burst in byte (the size of all packets)
    */
   uint32_t GetSize (void) const;
+  /**
+   * \param index the index of a packet in the burst
+   * \return the time the packet has been received, if it has been added with
+   *         it, or the current time otherwise
+   */
+  Time GetArrivalTime (uint32_t index) const;
 
   /**
    * \brief Returns an iterator to the begin of the burst
@@ -86,6 +102,7 @@ public:
 private:
   void DoDispose (void);
   std::list<Ptr<Packet> > m_packets; //!< the list of packets in the burst
+  std::vector<Time> m_arrivals;      //!< the arrival times of the packets, if known
 };
 } // namespace ns3
 
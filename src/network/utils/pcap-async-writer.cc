@@ -0,0 +1,463 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <algorithm>
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/header.h"
+#include "ns3/buffer.h"
+#include "pcap-async-writer.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapAsyncWriter");
+
+namespace {
+
+const uint32_t PCAP_MAGIC = 0xa1b2c3d4;       //!< Magic number of a pcap file
+const uint32_t PCAP_NS_MAGIC = 0xa1b23c4d;    //!< Magic number of a nanosecond pcap file
+const uint32_t PCAP_RECORD_HEADER = 16;       //!< Size of a pcap record header
+
+const uint32_t PCAPNG_SHB = 0x0a0d0d0a;       //!< Section Header Block type
+const uint32_t PCAPNG_IDB = 0x00000001;       //!< Interface Description Block type
+const uint32_t PCAPNG_EPB = 0x00000006;       //!< Enhanced Packet Block type
+const uint32_t PCAPNG_BYTE_ORDER = 0x1a2b3c4d; //!< Byte order magic number
+const uint32_t PCAPNG_EPB_OVERHEAD = 32;      //!< Size of an Enhanced Packet Block without data
+
+/**
+ * The smallest chunk, to keep the writes large
+ */
+const uint32_t MIN_CHUNK_SIZE = 64 * 1024;
+
+/**
+ * Time to wait for the other thread before checking again its progress,
+ * in case a signal was missed
+ */
+const uint64_t POLL_NS = 1000000;
+
+/**
+ * Append a value to a buffer in host byte order
+ * \param buffer the buffer
+ * \param value the value
+ * \returns the end of the value in the buffer
+ */
+template <typename T>
+uint8_t *
+Put (uint8_t *buffer, T value)
+{
+  std::memcpy (buffer, &value, sizeof (T));
+  return buffer + sizeof (T);
+}
+
+/**
+ * \param size a size
+ * \returns the size rounded up to a multiple of 4 bytes
+ */
+uint32_t
+Pad4 (uint32_t size)
+{
+  return (size + 3) & ~3U;
+}
+
+} // anonymous namespace
+
+PcapAsyncWriter::PcapAsyncWriter ()
+  : m_pcapng (false),
+    m_nanosecMode (false),
+    m_snapLen (0),
+    m_dropWhenFull (false),
+    m_fill (0),
+    m_produced (0),
+    m_consumed (0),
+    m_stop (false),
+    m_nRecords (0),
+    m_nDropped (0),
+    m_nBackpressured (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PcapAsyncWriter::~PcapAsyncWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+PcapAsyncWriter::Open (std::string const &filename, uint32_t dataLinkType, uint32_t snapLen,
+                       int32_t tzCorrection, bool nanosecMode, bool pcapng,
+                       uint32_t bufferSize, bool dropWhenFull)
+{
+  NS_LOG_FUNCTION (this << filename << dataLinkType << snapLen << tzCorrection
+                        << nanosecMode << pcapng << bufferSize << dropWhenFull);
+  NS_ASSERT (!IsOpen ());
+  m_file.open (filename.c_str (), std::ios::out | std::ios::trunc | std::ios::binary);
+  if (m_file.fail ())
+    {
+      return false;
+    }
+  m_pcapng = pcapng;
+  m_nanosecMode = nanosecMode;
+  m_snapLen = snapLen;
+  m_dropWhenFull = dropWhenFull;
+  m_fill = 0;
+  m_produced = 0;
+  m_consumed = 0;
+  m_stop = false;
+  m_nRecords = 0;
+  m_nDropped = 0;
+  m_nBackpressured = 0;
+
+  // At least two chunks, each one large enough for the largest record
+  uint32_t maxRecord = GetRecordSize (snapLen);
+  uint32_t chunkSize = std::max (std::max (bufferSize / 8, MIN_CHUNK_SIZE), maxRecord);
+  uint32_t nChunks = std::max (bufferSize / chunkSize, 2U);
+  m_chunks.resize (nChunks);
+  for (uint32_t i = 0; i < nChunks; ++i)
+    {
+      m_chunks[i].data.resize (chunkSize);
+      m_chunks[i].size = 0;
+    }
+
+  // The file header goes into the first chunk
+  uint8_t header[64];
+  uint8_t *end = header;
+  if (m_pcapng)
+    {
+      // Section Header Block, of unknown section length
+      end = Put<uint32_t> (end, PCAPNG_SHB);
+      end = Put<uint32_t> (end, 28);
+      end = Put<uint32_t> (end, PCAPNG_BYTE_ORDER);
+      end = Put<uint16_t> (end, 1);
+      end = Put<uint16_t> (end, 0);
+      end = Put<int64_t> (end, -1);
+      end = Put<uint32_t> (end, 28);
+      // Interface Description Block, with the if_tsresol option for
+      // nanosecond timestamps
+      uint32_t idbLength = nanosecMode ? 32 : 20;
+      end = Put<uint32_t> (end, PCAPNG_IDB);
+      end = Put<uint32_t> (end, idbLength);
+      end = Put<uint16_t> (end, dataLinkType);
+      end = Put<uint16_t> (end, 0);
+      end = Put<uint32_t> (end, snapLen);
+      if (nanosecMode)
+        {
+          end = Put<uint16_t> (end, 9);
+          end = Put<uint16_t> (end, 1);
+          end = Put<uint32_t> (end, 9);
+          end = Put<uint32_t> (end, 0);
+        }
+      end = Put<uint32_t> (end, idbLength);
+    }
+  else
+    {
+      end = Put<uint32_t> (end, nanosecMode ? PCAP_NS_MAGIC : PCAP_MAGIC);
+      end = Put<uint16_t> (end, 2);
+      end = Put<uint16_t> (end, 4);
+      end = Put<int32_t> (end, tzCorrection);
+      end = Put<uint32_t> (end, 0);
+      end = Put<uint32_t> (end, snapLen);
+      end = Put<uint32_t> (end, dataLinkType);
+    }
+  std::memcpy (&m_chunks[0].data[0], header, end - header);
+  m_fill = end - header;
+
+#ifdef HAVE_PTHREAD_H
+  m_thread = Create<SystemThread> (MakeCallback (&PcapAsyncWriter::WriterLoop, this));
+  m_thread->Start ();
+#endif /* HAVE_PTHREAD_H */
+  return true;
+}
+
+bool
+PcapAsyncWriter::IsOpen (void) const
+{
+  return m_file.is_open ();
+}
+
+void
+PcapAsyncWriter::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!IsOpen ())
+    {
+      return;
+    }
+  Publish ();
+#ifdef HAVE_PTHREAD_H
+  __atomic_store_n (&m_stop, true, __ATOMIC_RELEASE);
+  m_wakeWriter.SetCondition (true);
+  m_wakeWriter.Signal ();
+  m_thread->Join ();
+  m_thread = 0;
+#else
+  WritePending ();
+#endif /* HAVE_PTHREAD_H */
+  m_file.close ();
+  m_chunks.clear ();
+  if (m_nDropped > 0 || m_nBackpressured > 0)
+    {
+      NS_LOG_WARN (m_nDropped << " records dropped and " << m_nBackpressured
+                   << " records delayed out of " << m_nRecords + m_nDropped);
+    }
+}
+
+void
+PcapAsyncWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!IsOpen ())
+    {
+      return;
+    }
+  Publish ();
+#ifdef HAVE_PTHREAD_H
+  WaitConsumed (m_produced);
+#else
+  WritePending ();
+#endif /* HAVE_PTHREAD_H */
+}
+
+uint32_t
+PcapAsyncWriter::GetRecordSize (uint32_t inclLen) const
+{
+  if (m_pcapng)
+    {
+      return PCAPNG_EPB_OVERHEAD + Pad4 (inclLen);
+    }
+  return PCAP_RECORD_HEADER + inclLen;
+}
+
+void
+PcapAsyncWriter::Publish (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_fill == 0)
+    {
+      return;
+    }
+  m_chunks[m_produced % m_chunks.size ()].size = m_fill;
+  m_fill = 0;
+  // The chunk, including its size, is visible to the writer thread once
+  // the new count is.
+  __atomic_store_n (&m_produced, m_produced + 1, __ATOMIC_RELEASE);
+#ifdef HAVE_PTHREAD_H
+  m_wakeWriter.SetCondition (true);
+  m_wakeWriter.Signal ();
+#else
+  WritePending ();
+#endif /* HAVE_PTHREAD_H */
+}
+
+uint8_t *
+PcapAsyncWriter::Reserve (uint32_t size)
+{
+  if (m_fill + size > m_chunks[0].data.size ())
+    {
+      Publish ();
+    }
+  // The current chunk is free once the writer thread has written its
+  // previous content.
+  if (m_produced - __atomic_load_n (&m_consumed, __ATOMIC_ACQUIRE) >= m_chunks.size ())
+    {
+      if (m_dropWhenFull)
+        {
+          ++m_nDropped;
+          return 0;
+        }
+      ++m_nBackpressured;
+#ifdef HAVE_PTHREAD_H
+      WaitConsumed (m_produced - m_chunks.size () + 1);
+#endif /* HAVE_PTHREAD_H */
+    }
+  uint8_t *start = &m_chunks[m_produced % m_chunks.size ()].data[m_fill];
+  m_fill += size;
+  ++m_nRecords;
+  return start;
+}
+
+uint8_t *
+PcapAsyncWriter::WriteRecordHeader (uint8_t *buffer, uint32_t tsSec, uint32_t tsFrac,
+                                    uint32_t inclLen, uint32_t origLen)
+{
+  if (m_pcapng)
+    {
+      uint64_t ts = static_cast<uint64_t> (tsSec) * (m_nanosecMode ? 1000000000 : 1000000) + tsFrac;
+      uint32_t length = GetRecordSize (inclLen);
+      buffer = Put<uint32_t> (buffer, PCAPNG_EPB);
+      buffer = Put<uint32_t> (buffer, length);
+      buffer = Put<uint32_t> (buffer, 0);
+      buffer = Put<uint32_t> (buffer, ts >> 32);
+      buffer = Put<uint32_t> (buffer, ts & 0xffffffff);
+      buffer = Put<uint32_t> (buffer, inclLen);
+      buffer = Put<uint32_t> (buffer, origLen);
+      return buffer;
+    }
+  buffer = Put<uint32_t> (buffer, tsSec);
+  buffer = Put<uint32_t> (buffer, tsFrac);
+  buffer = Put<uint32_t> (buffer, inclLen);
+  buffer = Put<uint32_t> (buffer, origLen);
+  return buffer;
+}
+
+void
+PcapAsyncWriter::WriteRecordTrailer (uint8_t *data, uint32_t inclLen)
+{
+  if (m_pcapng)
+    {
+      uint32_t padding = Pad4 (inclLen) - inclLen;
+      std::memset (data, 0, padding);
+      Put<uint32_t> (data + padding, GetRecordSize (inclLen));
+    }
+}
+
+void
+PcapAsyncWriter::Write (uint32_t tsSec, uint32_t tsFrac, uint8_t const *data, uint32_t totalLen)
+{
+  NS_LOG_FUNCTION (this << tsSec << tsFrac << &data << totalLen);
+  uint32_t inclLen = std::min (totalLen, m_snapLen);
+  uint8_t *buffer = Reserve (GetRecordSize (inclLen));
+  if (buffer == 0)
+    {
+      return;
+    }
+  buffer = WriteRecordHeader (buffer, tsSec, tsFrac, inclLen, totalLen);
+  std::memcpy (buffer, data, inclLen);
+  WriteRecordTrailer (buffer + inclLen, inclLen);
+}
+
+void
+PcapAsyncWriter::Write (uint32_t tsSec, uint32_t tsFrac, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << tsSec << tsFrac << p);
+  uint32_t totalLen = p->GetSize ();
+  uint32_t inclLen = std::min (totalLen, m_snapLen);
+  uint8_t *buffer = Reserve (GetRecordSize (inclLen));
+  if (buffer == 0)
+    {
+      return;
+    }
+  buffer = WriteRecordHeader (buffer, tsSec, tsFrac, inclLen, totalLen);
+  p->CopyData (buffer, inclLen);
+  WriteRecordTrailer (buffer + inclLen, inclLen);
+}
+
+void
+PcapAsyncWriter::Write (uint32_t tsSec, uint32_t tsFrac, const Header &header, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << tsSec << tsFrac << &header << p);
+  uint32_t headerSize = header.GetSerializedSize ();
+  uint32_t totalLen = headerSize + p->GetSize ();
+  uint32_t inclLen = std::min (totalLen, m_snapLen);
+  uint8_t *buffer = Reserve (GetRecordSize (inclLen));
+  if (buffer == 0)
+    {
+      return;
+    }
+  buffer = WriteRecordHeader (buffer, tsSec, tsFrac, inclLen, totalLen);
+
+  Buffer headerBuffer;
+  headerBuffer.AddAtStart (headerSize);
+  header.Serialize (headerBuffer.Begin ());
+  uint32_t toCopy = std::min (headerSize, inclLen);
+  headerBuffer.CopyData (buffer, toCopy);
+  p->CopyData (buffer + toCopy, inclLen - toCopy);
+  WriteRecordTrailer (buffer + inclLen, inclLen);
+}
+
+uint64_t
+PcapAsyncWriter::GetNRecords (void) const
+{
+  return m_nRecords;
+}
+
+uint64_t
+PcapAsyncWriter::GetNDroppedRecords (void) const
+{
+  return m_nDropped;
+}
+
+uint64_t
+PcapAsyncWriter::GetNBackpressuredRecords (void) const
+{
+  return m_nBackpressured;
+}
+
+void
+PcapAsyncWriter::WaitConsumed (uint64_t count)
+{
+  NS_LOG_FUNCTION (this << count);
+#ifdef HAVE_PTHREAD_H
+  while (true)
+    {
+      m_wakeProducer.SetCondition (false);
+      if (__atomic_load_n (&m_consumed, __ATOMIC_ACQUIRE) >= count)
+        {
+          break;
+        }
+      m_wakeProducer.TimedWait (POLL_NS);
+    }
+#endif /* HAVE_PTHREAD_H */
+}
+
+bool
+PcapAsyncWriter::WritePending (void)
+{
+  bool written = false;
+  uint64_t produced = __atomic_load_n (&m_produced, __ATOMIC_ACQUIRE);
+  while (m_consumed < produced)
+    {
+      Chunk &chunk = m_chunks[m_consumed % m_chunks.size ()];
+      m_file.write (reinterpret_cast<const char *> (&chunk.data[0]), chunk.size);
+      __atomic_store_n (&m_consumed, m_consumed + 1, __ATOMIC_RELEASE);
+      written = true;
+    }
+  return written;
+}
+
+void
+PcapAsyncWriter::WriterLoop (void)
+{
+#ifdef HAVE_PTHREAD_H
+  while (true)
+    {
+      // Cleared before checking for chunks, so that a chunk handed over
+      // after the check cuts the wait short
+      m_wakeWriter.SetCondition (false);
+      if (WritePending ())
+        {
+          m_wakeProducer.SetCondition (true);
+          m_wakeProducer.Signal ();
+          continue;
+        }
+      if (__atomic_load_n (&m_stop, __ATOMIC_ACQUIRE))
+        {
+          // Chunks handed over before the stop request are visible now
+          if (!WritePending ())
+            {
+              break;
+            }
+          continue;
+        }
+      m_wakeWriter.TimedWait (POLL_NS);
+    }
+  m_file.flush ();
+#endif /* HAVE_PTHREAD_H */
+}
+
+} // namespace ns3
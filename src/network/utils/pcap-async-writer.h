@@ -0,0 +1,245 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAP_ASYNC_WRITER_H
+#define PCAP_ASYNC_WRITER_H
+
+#include <string>
+#include <fstream>
+#include <vector>
+#include <stdint.h>
+#include "ns3/core-config.h"
+#include "ns3/ptr.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#include "ns3/system-condition.h"
+#endif /* HAVE_PTHREAD_H */
+
+namespace ns3 {
+
+class Packet;
+class Header;
+
+/**
+ * \brief A pcap or pcapng file writer which writes from a background thread
+ *
+ * The records are serialized on the simulation thread into large memory
+ * chunks. The chunks form a single-producer, single-consumer ring: a
+ * chunk is handed over to a writer thread once it is full, and the
+ * writer thread writes it to the file with a single sequential write
+ * before handing it back. The two threads only share the number of
+ * chunks filled and the number of chunks written, hence the ring needs
+ * no lock.
+ *
+ * When every chunk is waiting to be written, a record is either dropped
+ * or the simulation thread waits for the writer thread (backpressure),
+ * depending on the dropWhenFull parameter of Open. Both events are
+ * counted.
+ *
+ * The records of a chunk reach the file when the chunk is full, or on
+ * Flush and Close. Without thread support, the chunks are written
+ * synchronously when they are full.
+ *
+ * The records are written in the byte order of the host.
+ */
+class PcapAsyncWriter
+{
+public:
+  PcapAsyncWriter ();
+  ~PcapAsyncWriter ();
+
+  /**
+   * Create the file, write its header and start the writer thread.
+   *
+   * \param filename the name of the file
+   * \param dataLinkType the data link type of the records
+   * \param snapLen the maximum number of bytes of packet data of a record;
+   *        longer packets are truncated.
+   * \param tzCorrection the time zone offset written in a pcap file header
+   * \param nanosecMode true if the timestamps are in nanoseconds, false
+   *        for microseconds.
+   * \param pcapng true to write a pcapng file, false for a pcap file
+   * \param bufferSize the total size of the memory chunks, in bytes
+   * \param dropWhenFull true to drop the records which do not fit in the
+   *        chunks, false to wait for the writer thread.
+   * \returns false if the file could not be created
+   */
+  bool Open (std::string const &filename, uint32_t dataLinkType, uint32_t snapLen,
+             int32_t tzCorrection, bool nanosecMode, bool pcapng,
+             uint32_t bufferSize, bool dropWhenFull);
+
+  /**
+   * Write the pending records and stop the writer thread.
+   */
+  void Close (void);
+
+  /**
+   * Hand over the records serialized so far to the writer thread and wait
+   * until they are written.
+   */
+  void Flush (void);
+
+  /**
+   * \returns true if the file is open
+   */
+  bool IsOpen (void) const;
+
+  /**
+   * \brief Write a record
+   *
+   * \param tsSec the seconds of the timestamp
+   * \param tsFrac the microseconds or nanoseconds of the timestamp
+   * \param data the packet data
+   * \param totalLen the size of the packet data
+   */
+  void Write (uint32_t tsSec, uint32_t tsFrac, uint8_t const *data, uint32_t totalLen);
+
+  /**
+   * \brief Write a record
+   *
+   * \param tsSec the seconds of the timestamp
+   * \param tsFrac the microseconds or nanoseconds of the timestamp
+   * \param p the packet
+   */
+  void Write (uint32_t tsSec, uint32_t tsFrac, Ptr<const Packet> p);
+
+  /**
+   * \brief Write a record
+   *
+   * \param tsSec the seconds of the timestamp
+   * \param tsFrac the microseconds or nanoseconds of the timestamp
+   * \param header a header to prepend to the packet
+   * \param p the packet
+   */
+  void Write (uint32_t tsSec, uint32_t tsFrac, const Header &header, Ptr<const Packet> p);
+
+  /**
+   * \returns the number of records written or waiting to be written
+   */
+  uint64_t GetNRecords (void) const;
+
+  /**
+   * \returns the number of records dropped because the chunks were full
+   */
+  uint64_t GetNDroppedRecords (void) const;
+
+  /**
+   * \returns the number of records which had to wait for the writer thread
+   */
+  uint64_t GetNBackpressuredRecords (void) const;
+
+private:
+  /**
+   * A memory chunk of the ring.
+   */
+  struct Chunk
+  {
+    std::vector<uint8_t> data; //!< The serialized records
+    uint32_t size;             //!< The number of bytes used, set when handed over
+  };
+
+  /**
+   * Reserve space for a record in the current chunk, handing over the
+   * current chunk and waiting for a free one if needed.
+   *
+   * \param size the size of the record
+   * \returns the start of the reserved space, or 0 if the record is dropped
+   */
+  uint8_t *Reserve (uint32_t size);
+
+  /**
+   * Serialize the record header into the space reserved for a record.
+   *
+   * \param buffer the reserved space
+   * \param tsSec the seconds of the timestamp
+   * \param tsFrac the microseconds or nanoseconds of the timestamp
+   * \param inclLen the number of bytes of packet data stored
+   * \param origLen the size of the packet data
+   * \returns the start of the packet data in the reserved space
+   */
+  uint8_t *WriteRecordHeader (uint8_t *buffer, uint32_t tsSec, uint32_t tsFrac,
+                              uint32_t inclLen, uint32_t origLen);
+
+  /**
+   * Finish a record whose packet data has been copied.
+   *
+   * \param data the end of the packet data
+   * \param inclLen the number of bytes of packet data stored
+   */
+  void WriteRecordTrailer (uint8_t *data, uint32_t inclLen);
+
+  /**
+   * \param inclLen the number of bytes of packet data stored
+   * \returns the size of a record
+   */
+  uint32_t GetRecordSize (uint32_t inclLen) const;
+
+  /**
+   * Hand the current chunk over to the writer thread.
+   */
+  void Publish (void);
+
+  /**
+   * Wait until the writer thread has written a number of chunks.
+   * \param count the number of chunks
+   */
+  void WaitConsumed (uint64_t count);
+
+  /**
+   * Write the chunks handed over, until Close is called.
+   */
+  void WriterLoop (void);
+
+  /**
+   * Write the chunks handed over and not written yet.
+   * \returns true if a chunk was written
+   */
+  bool WritePending (void);
+
+  std::ofstream m_file;         //!< The file
+  bool m_pcapng;                //!< Whether the file is a pcapng file
+  bool m_nanosecMode;           //!< Whether the timestamps are in nanoseconds
+  uint32_t m_snapLen;           //!< Maximum number of bytes of packet data
+  bool m_dropWhenFull;          //!< Drop the records instead of waiting
+  std::vector<Chunk> m_chunks;  //!< The ring of chunks
+  uint32_t m_fill;              //!< Bytes used in the chunk being filled
+
+  /**
+   * The number of chunks handed over to the writer thread. Only written
+   * by the simulation thread.
+   */
+  uint64_t m_produced;
+  /**
+   * The number of chunks written to the file. Only written by the writer
+   * thread.
+   */
+  uint64_t m_consumed;
+  bool m_stop;                  //!< Set to stop the writer thread
+
+  uint64_t m_nRecords;          //!< Number of records accepted
+  uint64_t m_nDropped;          //!< Number of records dropped
+  uint64_t m_nBackpressured;    //!< Number of records which waited
+
+#ifdef HAVE_PTHREAD_H
+  Ptr<SystemThread> m_thread;   //!< The writer thread
+  SystemCondition m_wakeWriter; //!< Signaled when a chunk is handed over
+  SystemCondition m_wakeProducer; //!< Signaled when a chunk is written
+#endif /* HAVE_PTHREAD_H */
+};
+
+} // namespace ns3
+
+#endif /* PCAP_ASYNC_WRITER_H */
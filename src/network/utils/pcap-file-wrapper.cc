@@ -17,6 +17,7 @@
  */
 
 #include "ns3/log.h"
+#include "ns3/abort.h"
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
 #include "ns3/buffer.h"
@@ -46,12 +47,37 @@ PcapFileWrapper::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&PcapFileWrapper::m_nanosecMode),
                    MakeBooleanChecker())
+    .AddAttribute ("AsyncWrite",
+                   "Whether a file opened for writing only is written by a "
+                   "background thread, from records staged in memory.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_asyncWrite),
+                   MakeBooleanChecker ())
+    .AddAttribute ("AsyncBufferSize",
+                   "The memory, in bytes, in which the records wait to be written "
+                   "by the background thread.",
+                   UintegerValue (4 * 1024 * 1024),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_asyncBufferSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("DropWhenFull",
+                   "Whether the records are dropped when the memory of the background "
+                   "thread is full, rather than waiting for it.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_dropWhenFull),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Pcapng",
+                   "Whether the file is written in the pcapng format. Only "
+                   "supported with AsyncWrite.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_pcapng),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 
 PcapFileWrapper::PcapFileWrapper ()
+  : m_writeOnly (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -86,6 +112,7 @@ void
 PcapFileWrapper::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  m_async.Close ();
   m_file.Close ();
 }
 
@@ -93,6 +120,8 @@ void
 PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
 {
   NS_LOG_FUNCTION (this << filename << mode);
+  m_filename = filename;
+  m_writeOnly = (mode & std::ios::out) && !(mode & std::ios::in);
   m_file.Open (filename, mode);
 }
 
@@ -105,21 +134,43 @@ PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrec
   // a snaplen, we use the one provided.
   //
   NS_LOG_FUNCTION (this << dataLinkType << snapLen << tzCorrection);
-  if (snapLen != std::numeric_limits<uint32_t>::max ())
+  if (snapLen == std::numeric_limits<uint32_t>::max ())
     {
-      m_file.Init (dataLinkType, snapLen, tzCorrection, false, m_nanosecMode);
-    } 
-  else
+      snapLen = m_snapLen;
+    }
+  m_file.Init (dataLinkType, snapLen, tzCorrection, false, m_nanosecMode);
+
+  //
+  // The asynchronous writer rewrites the file header, in its own format,
+  // and writes the records through its own stream. If it cannot create the
+  // file, the records are written synchronously.
+  //
+  if (m_asyncWrite && m_writeOnly && !m_file.Fail ())
     {
-      m_file.Init (dataLinkType, m_snapLen, tzCorrection, false, m_nanosecMode);
-    } 
+      m_file.Close ();
+      if (!m_async.Open (m_filename, dataLinkType, snapLen, tzCorrection, m_nanosecMode,
+                         m_pcapng, m_asyncBufferSize, m_dropWhenFull))
+        {
+          NS_LOG_WARN ("Unable to write " << m_filename << " asynchronously");
+          m_file.Open (m_filename, std::ios::out);
+          m_file.Init (dataLinkType, snapLen, tzCorrection, false, m_nanosecMode);
+        }
+    }
+  NS_ABORT_MSG_IF (m_pcapng && !m_async.IsOpen (), "The pcapng format requires AsyncWrite");
 }
 
 void
 PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << p);
-  if (m_file.IsNanoSecMode())
+  if (m_async.IsOpen ())
+    {
+      uint32_t s;
+      uint32_t frac;
+      SplitTimestamp (t, s, frac);
+      m_async.Write (s, frac, p);
+    }
+  else if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
       uint64_t s       = current / 1000000000;
@@ -139,7 +190,14 @@ void
 PcapFileWrapper::Write (Time t, const Header &header, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << &header << p);
-  if (m_file.IsNanoSecMode())
+  if (m_async.IsOpen ())
+    {
+      uint32_t s;
+      uint32_t frac;
+      SplitTimestamp (t, s, frac);
+      m_async.Write (s, frac, header, p);
+    }
+  else if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
       uint64_t s       = current / 1000000000;
@@ -159,7 +217,14 @@ void
 PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
 {
   NS_LOG_FUNCTION (this << t << &buffer << length);
-  if (m_file.IsNanoSecMode())
+  if (m_async.IsOpen ())
+    {
+      uint32_t s;
+      uint32_t frac;
+      SplitTimestamp (t, s, frac);
+      m_async.Write (s, frac, buffer, length);
+    }
+  else if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
       uint64_t s       = current / 1000000000;
@@ -175,6 +240,48 @@ PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
     }
 }
 
+void
+PcapFileWrapper::SplitTimestamp (Time t, uint32_t &s, uint32_t &frac) const
+{
+  if (m_nanosecMode)
+    {
+      uint64_t current = t.GetNanoSeconds ();
+      s = current / 1000000000;
+      frac = current % 1000000000;
+    }
+  else
+    {
+      uint64_t current = t.GetMicroSeconds ();
+      s = current / 1000000;
+      frac = current % 1000000;
+    }
+}
+
+void
+PcapFileWrapper::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_async.Flush ();
+}
+
+bool
+PcapFileWrapper::IsAsync (void) const
+{
+  return m_async.IsOpen ();
+}
+
+uint64_t
+PcapFileWrapper::GetNDroppedRecords (void) const
+{
+  return m_async.GetNDroppedRecords ();
+}
+
+uint64_t
+PcapFileWrapper::GetNBackpressuredRecords (void) const
+{
+  return m_async.GetNBackpressuredRecords ();
+}
+
 Ptr<Packet> 
 PcapFileWrapper::Read (Time &t)
 {
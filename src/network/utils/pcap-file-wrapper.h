@@ -27,6 +27,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "pcap-file.h"
+#include "pcap-async-writer.h"
 
 namespace ns3 {
 
@@ -35,6 +36,15 @@ namespace ns3 {
  * ns-3 interface to the low-level public methods of PcapFile.  Users are
  * encouraged to use this object instead of class ns3::PcapFile in ns-3
  * public APIs.
+ *
+ * When the AsyncWrite attribute is set, a file opened for writing only is
+ * written by a PcapAsyncWriter from a background thread instead, optionally
+ * in the pcapng format. Since the pcap helpers create their files through
+ * this class, setting the attribute default enables the asynchronous
+ * writer for all the captures of a simulation:
+ * \code
+ *   Config::SetDefault ("ns3::PcapFileWrapper::AsyncWrite", BooleanValue (true));
+ * \endcode
  */
 class PcapFileWrapper : public Object
 {
@@ -220,10 +230,49 @@ public:
    */ 
   uint32_t GetDataLinkType (void);
 
+  /**
+   * \brief Write the records staged by the asynchronous writer to the file.
+   *
+   * This method does nothing if the file is written synchronously.
+   */
+  void Flush (void);
+
+  /**
+   * \returns true if the records are written by a background thread
+   */
+  bool IsAsync (void) const;
+
+  /**
+   * \returns the number of records dropped by the asynchronous writer
+   * because its buffer was full
+   */
+  uint64_t GetNDroppedRecords (void) const;
+
+  /**
+   * \returns the number of records for which the simulation waited for
+   * the asynchronous writer because its buffer was full
+   */
+  uint64_t GetNBackpressuredRecords (void) const;
+
 private:
+  /**
+   * Split a timestamp as expected by the pcap records
+   * \param t the timestamp
+   * \param s the seconds
+   * \param frac the microseconds or nanoseconds
+   */
+  void SplitTimestamp (Time t, uint32_t &s, uint32_t &frac) const;
+
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
   bool     m_nanosecMode; //!< Timestamps in nanosecond mode
+  bool     m_asyncWrite; //!< Write from a background thread
+  bool     m_pcapng; //!< Write the pcapng format (asynchronous writer only)
+  uint32_t m_asyncBufferSize; //!< Memory used by the asynchronous writer
+  bool     m_dropWhenFull; //!< Drop the records when the buffer is full
+  std::string m_filename; //!< Name of the file
+  bool     m_writeOnly; //!< Whether the file was opened for writing only
+  PcapAsyncWriter m_async; //!< Asynchronous writer
 };
 
 } // namespace ns3
@@ -25,6 +25,7 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 #include "ns3/pointer.h"
+#include "ns3/packet-burst.h"
 #include "point-to-point-net-device.h"
 #include "point-to-point-channel.h"
 #include "ppp-header.h"
@@ -67,6 +68,27 @@ PointToPointNetDevice::GetTypeId (void)
                    TimeValue (Seconds (0.0)),
                    MakeTimeAccessor (&PointToPointNetDevice::m_tInterframeGap),
                    MakeTimeChecker ())
+    .AddAttribute ("RxCoalesceFrames",
+                   "The maximum number of received frames that the device holds "
+                   "before handing them to the higher layers in a single burst, "
+                   "like the interrupt moderation of a NIC. The value 1 disables "
+                   "the coalescing. Frames are only coalesced if the device has "
+                   "no promiscuous receive callback. The delivery of a frame to the "
+                   "higher layers is then delayed by up to RxCoalesceTime, while the "
+                   "MacRx and sniffer traces still fire when the frame is received.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&PointToPointNetDevice::m_rxCoalesceFrames),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("RxCoalesceTime",
+                   "The maximum time a received frame is held when RxCoalesceFrames "
+                   "is greater than 1, i.e., the largest delay added to the delivery "
+                   "of a frame to the higher layers. The frames of a burst keep their "
+                   "own arrival time (see PacketBurst::GetArrivalTime). With a null "
+                   "time, only the frames received at the same time are delivered "
+                   "together.",
+                   TimeValue (Seconds (0.0)),
+                   MakeTimeAccessor (&PointToPointNetDevice::m_rxCoalesceTime),
+                   MakeTimeChecker (Seconds (0.0)))
 
     //
     // Transmit queueing discipline for the device which includes its own set
@@ -176,6 +198,7 @@ PointToPointNetDevice::PointToPointNetDevice ()
   :
     m_txMachineState (READY),
     m_channel (0),
+    m_rxCoalesceFrames (1),
     m_linkUp (false),
     m_currentPkt (0)
 {
@@ -230,6 +253,8 @@ PointToPointNetDevice::DoDispose ()
   m_node = 0;
   m_channel = 0;
   m_receiveErrorModel = 0;
+  m_rxFlushEvent.Cancel ();
+  m_rxPending.clear ();
   m_currentPkt = 0;
   m_queue = 0;
   m_queueInterface = 0;
@@ -430,7 +455,62 @@ PointToPointNetDevice::Receive (Ptr<Packet> packet)
         }
 
       m_macRxTrace (originalPacket);
-      m_rxCallback (this, packet, protocol, GetRemote ());
+      if (m_rxCoalesceFrames <= 1 || m_rxBurstCallback.IsNull () || !m_promiscCallback.IsNull ())
+        {
+          m_rxCallback (this, packet, protocol, GetRemote ());
+          return;
+        }
+
+      RxPendingFrame frame;
+      frame.packet = packet;
+      frame.protocol = protocol;
+      frame.arrival = Simulator::Now ();
+      m_rxPending.push_back (frame);
+      if (m_rxPending.size () >= m_rxCoalesceFrames)
+        {
+          m_rxFlushEvent.Cancel ();
+          FlushRxPending ();
+        }
+      else if (!m_rxFlushEvent.IsRunning ())
+        {
+          m_rxFlushEvent = Simulator::Schedule (m_rxCoalesceTime,
+                                                &PointToPointNetDevice::FlushRxPending, this);
+        }
+    }
+}
+
+void
+PointToPointNetDevice::FlushRxPending (void)
+{
+  NS_LOG_FUNCTION (this << m_rxPending.size ());
+  std::vector<RxPendingFrame> pending;
+  pending.swap (m_rxPending);
+  Address remote = GetRemote ();
+  std::vector<RxPendingFrame>::const_iterator i = pending.begin ();
+  while (i != pending.end ())
+    {
+      uint16_t protocol = i->protocol;
+      std::vector<RxPendingFrame>::const_iterator j = i + 1;
+      while (j != pending.end () && j->protocol == protocol)
+        {
+          ++j;
+        }
+      if (j - i == 1)
+        {
+          m_rxCallback (this, i->packet, protocol, remote);
+        }
+      else
+        {
+          // The higher layers get the arrival time of each frame, e.g., to
+          // refresh the ARP cache as of the frame reception
+          Ptr<PacketBurst> burst = CreateObject<PacketBurst> ();
+          for (; i != j; ++i)
+            {
+              burst->AddPacket (i->packet, i->arrival);
+            }
+          m_rxBurstCallback (this, burst, protocol, remote);
+        }
+      i = j;
     }
 }
 
@@ -700,6 +780,14 @@ void
 PointToPointNetDevice::SetReceiveCallback (NetDevice::ReceiveCallback cb)
 {
   m_rxCallback = cb;
+  // A burst callback set earlier may no longer match the receive callback
+  m_rxBurstCallback = NetDevice::ReceiveBurstCallback ();
+}
+
+void
+PointToPointNetDevice::SetReceiveBurstCallback (NetDevice::ReceiveBurstCallback cb)
+{
+  m_rxBurstCallback = cb;
 }
 
 void
@@ -20,6 +20,7 @@
 #define POINT_TO_POINT_NET_DEVICE_H
 
 #include <cstring>
+#include <vector>
 #include "ns3/address.h"
 #include "ns3/node.h"
 #include "ns3/net-device.h"
@@ -27,6 +28,7 @@
 #include "ns3/packet.h"
 #include "ns3/traced-callback.h"
 #include "ns3/nstime.h"
+#include "ns3/event-id.h"
 #include "ns3/data-rate.h"
 #include "ns3/ptr.h"
 #include "ns3/mac48-address.h"
@@ -184,6 +186,7 @@ public:
   virtual bool NeedsArp (void) const;
 
   virtual void SetReceiveCallback (NetDevice::ReceiveCallback cb);
+  virtual void SetReceiveBurstCallback (NetDevice::ReceiveBurstCallback cb);
 
   virtual Address GetMulticast (Ipv6Address addr) const;
 
@@ -252,6 +255,12 @@ private:
    */
   bool ProcessHeader (Ptr<Packet> p, uint16_t& param);
 
+  /**
+   * Deliver the frames held by the receive coalescing to the higher layers,
+   * consecutive frames of the same protocol as a single burst.
+   */
+  void FlushRxPending (void);
+
   /**
    * Start Sending a Packet Down the Wire.
    *
@@ -328,6 +337,33 @@ private:
    */
   Ptr<ErrorModel> m_receiveErrorModel;
 
+  /**
+   * The maximum number of received frames held before they are delivered
+   * to the higher layers as a burst; 1 disables the receive coalescing.
+   */
+  uint32_t m_rxCoalesceFrames;
+
+  /**
+   * The maximum time a received frame is held before being delivered to
+   * the higher layers, when the receive coalescing is enabled.
+   */
+  Time m_rxCoalesceTime;
+
+  /**
+   * A frame held by the receive coalescing.
+   */
+  struct RxPendingFrame
+  {
+    Ptr<Packet> packet;     //!< The frame, without its PPP header
+    uint16_t protocol;      //!< The protocol number of the frame
+    Time arrival;           //!< The time the frame has been received
+  };
+
+  /// Frames held by the receive coalescing, in order of arrival
+  std::vector<RxPendingFrame> m_rxPending;
+
+  EventId m_rxFlushEvent; //!< Delivery of the frames held
+
   /**
    * The trace source fired when packets come into the "top" of the device
    * at the L3/L2 transition, before being queued for transmission.
@@ -440,6 +476,7 @@ private:
   Ptr<NetDeviceQueueInterface> m_queueInterface;   //!< NetDevice queue interface
   Mac48Address m_address;   //!< Mac48Address of this NetDevice
   NetDevice::ReceiveCallback m_rxCallback;   //!< Receive callback
+  NetDevice::ReceiveBurstCallback m_rxBurstCallback;   //!< Burst receive callback
   NetDevice::PromiscReceiveCallback m_promiscCallback;  //!< Receive callback
                                                         //   (promisc data)
   uint32_t m_ifIndex; //!< Index of the interface
@@ -23,6 +23,9 @@
 #include "ns3/simulator.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
+#include "ns3/packet-burst.h"
+#include "ns3/uinteger.h"
+#include "ns3/data-rate.h"
 
 using namespace ns3;
 
@@ -100,6 +103,188 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Test the receive coalescing of the PointToPointNetDevice
+ *
+ * It sends ten packets from one NetDevice to another whose receive
+ * coalescing holds up to four frames, and checks that the packets are
+ * delivered in order, as two bursts of four packets and a last burst of
+ * two packets once the coalescing time is over. It also checks the
+ * delivery time of each packet, and that a burst reports the time each of
+ * its packets has been received, i.e., when the MacRx trace fired.
+ */
+class PointToPointRxCoalesceTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointRxCoalesceTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send packets to the device specified
+   *
+   * \param device NetDevice to send to
+   * \param n number of packets to send
+   */
+  void SendPackets (Ptr<PointToPointNetDevice> device, uint32_t n);
+  /**
+   * \brief Record the time a packet is received by the device
+   * \param packet the packet
+   */
+  void MacRx (Ptr<const Packet> packet);
+  /**
+   * \brief Handle a packet received alone
+   * \param device the receiving device
+   * \param packet the packet
+   * \param protocol the protocol number
+   * \param from the sender
+   * \param to the receiver
+   * \param packetType the packet type
+   */
+  void Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                const Address &from, const Address &to, NetDevice::PacketType packetType);
+  /**
+   * \brief Handle a burst of packets
+   * \param device the receiving device
+   * \param burst the packets
+   * \param protocol the protocol number
+   * \param from the sender
+   * \param to the receiver
+   * \param packetType the packet type
+   */
+  void ReceiveBurst (Ptr<NetDevice> device, Ptr<const PacketBurst> burst, uint16_t protocol,
+                     const Address &from, const Address &to, NetDevice::PacketType packetType);
+
+  std::vector<uint32_t> m_sizes;      //!< Sizes of the packets received, in order
+  std::vector<uint32_t> m_deliveries; //!< Number of packets of each delivery
+  std::vector<Time> m_macRxTimes;     //!< Times the MacRx trace fired, in order
+  std::vector<Time> m_arrivals;       //!< Arrival times reported with the packets delivered
+  std::vector<Time> m_deliveryTimes;  //!< Delivery times of the packets
+};
+
+PointToPointRxCoalesceTest::PointToPointRxCoalesceTest ()
+  : TestCase ("PointToPoint receive coalescing")
+{
+}
+
+void
+PointToPointRxCoalesceTest::SendPackets (Ptr<PointToPointNetDevice> device, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      device->Send (Create<Packet> (100 + i), device->GetBroadcast (), 0x800);
+    }
+}
+
+void
+PointToPointRxCoalesceTest::MacRx (Ptr<const Packet> packet)
+{
+  m_macRxTimes.push_back (Simulator::Now ());
+}
+
+void
+PointToPointRxCoalesceTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                                     const Address &from, const Address &to,
+                                     NetDevice::PacketType packetType)
+{
+  m_sizes.push_back (packet->GetSize ());
+  m_deliveries.push_back (1);
+  m_arrivals.push_back (Simulator::Now ());
+  m_deliveryTimes.push_back (Simulator::Now ());
+}
+
+void
+PointToPointRxCoalesceTest::ReceiveBurst (Ptr<NetDevice> device, Ptr<const PacketBurst> burst,
+                                          uint16_t protocol, const Address &from, const Address &to,
+                                          NetDevice::PacketType packetType)
+{
+  uint32_t index = 0;
+  for (std::list<Ptr<Packet> >::const_iterator i = burst->Begin (); i != burst->End (); ++i, ++index)
+    {
+      m_sizes.push_back ((*i)->GetSize ());
+      m_arrivals.push_back (burst->GetArrivalTime (index));
+      m_deliveryTimes.push_back (Simulator::Now ());
+    }
+  m_deliveries.push_back (burst->GetNPackets ());
+}
+
+void
+PointToPointRxCoalesceTest::DoRun (void)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue> ());
+  devA->SetDataRate (DataRate ("1Gbps"));
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue> ());
+  devB->SetAttribute ("RxCoalesceFrames", UintegerValue (4));
+  devB->SetAttribute ("RxCoalesceTime", TimeValue (MilliSeconds (1)));
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+  b->RegisterProtocolHandler (MakeCallback (&PointToPointRxCoalesceTest::Receive, this),
+                              MakeCallback (&PointToPointRxCoalesceTest::ReceiveBurst, this),
+                              0x800, devB);
+  devB->TraceConnectWithoutContext ("MacRx", MakeCallback (&PointToPointRxCoalesceTest::MacRx, this));
+
+  Ptr<NetDeviceQueueInterface> ifaceA = CreateObject<NetDeviceQueueInterface> ();
+  devA->AggregateObject (ifaceA);
+  ifaceA->CreateTxQueues ();
+  Ptr<NetDeviceQueueInterface> ifaceB = CreateObject<NetDeviceQueueInterface> ();
+  devB->AggregateObject (ifaceB);
+  ifaceB->CreateTxQueues ();
+
+  Simulator::Schedule (Seconds (1.0), &PointToPointRxCoalesceTest::SendPackets, this, devA, 10);
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_sizes.size (), 10, "Packets lost");
+  for (uint32_t i = 0; i < m_sizes.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_sizes[i], 100 + i, "Packets reordered");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_deliveries.size (), 3, "Wrong number of deliveries");
+  NS_TEST_ASSERT_MSG_EQ (m_deliveries[0], 4, "Wrong size of the first burst");
+  NS_TEST_ASSERT_MSG_EQ (m_deliveries[1], 4, "Wrong size of the second burst");
+  NS_TEST_ASSERT_MSG_EQ (m_deliveries[2], 2, "Wrong size of the last burst");
+
+  NS_TEST_ASSERT_MSG_EQ (m_macRxTimes.size (), 10, "MacRx trace not fired for each frame");
+  for (uint32_t i = 0; i < m_sizes.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_arrivals[i], m_macRxTimes[i], "Wrong arrival time of packet " << i);
+      NS_TEST_ASSERT_MSG_GT_OR_EQ (m_deliveryTimes[i], m_macRxTimes[i], "Packet " << i << " delivered before its arrival");
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (m_deliveryTimes[i], m_macRxTimes[i] + MilliSeconds (1),
+                                   "Packet " << i << " held longer than the coalescing time");
+    }
+  // The first two bursts are delivered when their fourth frame arrives,
+  // the frames of the last one when the coalescing time of the first of
+  // them expires
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_deliveryTimes[i], m_macRxTimes[3], "Wrong delivery time of packet " << i);
+      NS_TEST_ASSERT_MSG_EQ (m_deliveryTimes[4 + i], m_macRxTimes[7], "Wrong delivery time of packet " << 4 + i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_deliveryTimes[8], m_macRxTimes[8] + MilliSeconds (1), "Wrong delivery time of packet 8");
+  NS_TEST_ASSERT_MSG_EQ (m_deliveryTimes[9], m_macRxTimes[8] + MilliSeconds (1), "Wrong delivery time of packet 9");
+  NS_TEST_ASSERT_MSG_LT (m_macRxTimes[8], m_macRxTimes[9], "Frames of the last burst received at the same time");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -116,6 +301,7 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointRxCoalesceTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
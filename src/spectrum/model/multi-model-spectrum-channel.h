@@ -127,6 +127,12 @@ public:
   virtual uint32_t GetNDevices (void) const;
   virtual Ptr<NetDevice> GetDevice (uint32_t i) const;
 
+  /**
+   * Get the single-frequency propagation loss model.
+   * \returns a pointer to the propagation loss model.
+   */
+  virtual Ptr<PropagationLossModel> GetPropagationLossModel (void);
+
   /**
    * Get the frequency-dependent propagation loss model.
    * \returns a pointer to the propagation loss model.
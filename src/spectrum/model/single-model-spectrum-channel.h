@@ -64,6 +64,12 @@ public:
   /// Container: SpectrumPhy objects
   typedef std::vector<Ptr<SpectrumPhy> > PhyList;
 
+  /**
+   * Get the single-frequency propagation loss model.
+   * \returns a pointer to the propagation loss model.
+   */
+  virtual Ptr<PropagationLossModel> GetPropagationLossModel (void);
+
   /**
    * Get the frequency-dependent propagation loss model.
    * \returns a pointer to the propagation loss model.
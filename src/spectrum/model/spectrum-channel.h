@@ -99,6 +99,18 @@ public:
    */
   virtual void AddRx (Ptr<SpectrumPhy> phy) = 0;
 
+  /**
+   * Get the single-frequency propagation loss model.
+   * \returns a pointer to the propagation loss model, or 0 if none is used.
+   */
+  virtual Ptr<PropagationLossModel> GetPropagationLossModel (void);
+
+  /**
+   * Get the frequency-dependent propagation loss model.
+   * \returns a pointer to the propagation loss model, or 0 if none is used.
+   */
+  virtual Ptr<SpectrumPropagationLossModel> GetSpectrumPropagationLossModel (void);
+
   /**
    * TracedCallback signature for path loss calculation events.
    *
@@ -0,0 +1,311 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This is a system test of the "AsciiTraceBinary" global value: the ascii
+// traces of the devices, of the wifi phys and of the internet stack are
+// written once as text and once in the binary trace format, and the binary
+// trace file must print as the text one.
+
+#include <string>
+#include <sstream>
+
+#include "ns3/binary-trace-file.h"
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/mac48-address.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/packet.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/trace-helper.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/wifi-mac-helper.h"
+#include "ns3/yans-wifi-helper.h"
+
+using namespace ns3;
+
+/**
+ * Trace the IPv4 and IPv6 stacks and the devices of a point to point link
+ * with InternetStackHelper and PointToPointHelper, and check that the binary
+ * trace file prints as the text trace.
+ */
+class InternetStackBinaryTraceTestCase : public TestCase
+{
+public:
+  InternetStackBinaryTraceTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Run the scenario, with all the ascii traces written to a stream
+   * \param stream the output stream wrapper
+   */
+  void RunScenario (Ptr<OutputStreamWrapper> stream);
+  /**
+   * Send a packet
+   * \param socket the socket
+   */
+  void SendPacket (Ptr<Socket> socket);
+};
+
+InternetStackBinaryTraceTestCase::InternetStackBinaryTraceTestCase ()
+  : TestCase ("Check that the ascii traces of InternetStackHelper are written in the binary trace format")
+{
+}
+
+void
+InternetStackBinaryTraceTestCase::SendPacket (Ptr<Socket> socket)
+{
+  socket->Send (Create<Packet> (500));
+}
+
+void
+InternetStackBinaryTraceTestCase::RunScenario (Ptr<OutputStreamWrapper> stream)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+  // The two runs must give the devices, hence the IPv6 interfaces, the same addresses
+  devices.Get (0)->SetAddress (Mac48Address ("00:00:00:00:00:01"));
+  devices.Get (1)->SetAddress (Mac48Address ("00:00:00:00:00:02"));
+
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  // The IPv6 stack draws random delays: the two runs must draw the same ones
+  stack.AssignStreams (nodes, 0);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer ipv4Interfaces = ipv4.Assign (devices);
+  Ipv6AddressHelper ipv6;
+  ipv6.SetBase (Ipv6Address ("2001:1::"), Ipv6Prefix (64));
+  Ipv6InterfaceContainer ipv6Interfaces = ipv6.Assign (devices);
+
+  stack.EnableAsciiIpv4All (stream);
+  stack.EnableAsciiIpv6All (stream);
+  pointToPoint.EnableAsciiAll (stream);
+
+  // No socket is bound on the receiver, which answers with ICMP errors
+  Ptr<Socket> socket4 = Socket::CreateSocket (nodes.Get (0), UdpSocketFactory::GetTypeId ());
+  socket4->Bind ();
+  socket4->Connect (InetSocketAddress (ipv4Interfaces.GetAddress (1), 9));
+  Ptr<Socket> socket6 = Socket::CreateSocket (nodes.Get (0), UdpSocketFactory::GetTypeId ());
+  socket6->Bind6 ();
+  socket6->Connect (Inet6SocketAddress (ipv6Interfaces.GetAddress (1, 1), 9));
+  for (uint32_t i = 0; i < 5; ++i)
+    {
+      Simulator::Schedule (Seconds (3) + MilliSeconds (10 * i),
+                           &InternetStackBinaryTraceTestCase::SendPacket, this, socket4);
+      Simulator::Schedule (Seconds (3) + MilliSeconds (10 * i + 5),
+                           &InternetStackBinaryTraceTestCase::SendPacket, this, socket6);
+    }
+
+  Simulator::Stop (Seconds (4));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+InternetStackBinaryTraceTestCase::DoRun (void)
+{
+  std::ostringstream expected;
+  RunScenario (Create<OutputStreamWrapper> (&expected));
+
+  std::string filename = CreateTempDirFilename ("internet-binary-trace.tr");
+  Config::SetGlobal ("AsciiTraceBinary", BooleanValue (true));
+  AsciiTraceHelper helper;
+  Ptr<OutputStreamWrapper> stream = helper.CreateFileStream (filename);
+  Config::SetGlobal ("AsciiTraceBinary", BooleanValue (false));
+  RunScenario (stream);
+  // InternetStackHelper keeps the stream until the end of the program
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryTraceWriter ();
+  NS_TEST_ASSERT_MSG_NE (writer, 0, "No binary trace writer");
+  writer->Close ();
+
+  BinaryTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Unable to read " << filename);
+  std::ostringstream printed;
+  BinaryTraceReader::Record record;
+  uint32_t ipv4Events = 0;
+  uint32_t ipv6Events = 0;
+  while (reader.Read (record))
+    {
+      BinaryTraceReader::PrintAscii (printed, record);
+      if (record.context.find ("$ns3::Ipv4L3Protocol") != std::string::npos)
+        {
+          NS_TEST_ASSERT_MSG_LT (record.node, 2u, "Node of " << record.context << " not parsed");
+          ipv4Events++;
+        }
+      if (record.context.find ("$ns3::Ipv6L3Protocol") != std::string::npos)
+        {
+          ipv6Events++;
+        }
+    }
+  NS_TEST_ASSERT_MSG_GT (ipv4Events, 0u, "No IPv4 event");
+  NS_TEST_ASSERT_MSG_GT (ipv6Events, 0u, "No IPv6 event");
+  NS_TEST_ASSERT_MSG_EQ (printed.str (), expected.str (), "The binary trace file does not print as the text trace");
+}
+
+/**
+ * Trace the phys of an ad hoc wifi network with YansWifiPhyHelper, and
+ * check that the binary trace file prints as the text trace.
+ */
+class WifiBinaryTraceTestCase : public TestCase
+{
+public:
+  WifiBinaryTraceTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Run the scenario, with the ascii traces of the phys written to a stream
+   * \param stream the output stream wrapper
+   */
+  void RunScenario (Ptr<OutputStreamWrapper> stream);
+  /**
+   * Send a packet
+   * \param from the sending device
+   * \param to the destination address
+   */
+  void SendPacket (Ptr<NetDevice> from, Address to);
+};
+
+WifiBinaryTraceTestCase::WifiBinaryTraceTestCase ()
+  : TestCase ("Check that the ascii traces of YansWifiPhyHelper are written in the binary trace format")
+{
+}
+
+void
+WifiBinaryTraceTestCase::SendPacket (Ptr<NetDevice> from, Address to)
+{
+  from->Send (Create<Packet> (500), to, 0x0800);
+}
+
+void
+WifiBinaryTraceTestCase::RunScenario (Ptr<OutputStreamWrapper> stream)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0.0, 0.0, 0.0));
+  positions->Add (Vector (5.0, 0.0, 0.0));
+  mobility.SetPositionAllocator (positions);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate6Mbps"));
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  // The two runs must give the devices the same addresses and draw the same backoffs
+  devices.Get (0)->SetAddress (Mac48Address ("00:00:00:00:00:01"));
+  devices.Get (1)->SetAddress (Mac48Address ("00:00:00:00:00:02"));
+  wifi.AssignStreams (devices, 0);
+
+  phy.EnableAsciiAll (stream);
+
+  for (uint32_t i = 0; i < 5; ++i)
+    {
+      Simulator::Schedule (Seconds (1) + MilliSeconds (10 * i), &WifiBinaryTraceTestCase::SendPacket,
+                           this, devices.Get (0), devices.Get (1)->GetAddress ());
+      Simulator::Schedule (Seconds (1) + MilliSeconds (10 * i + 5), &WifiBinaryTraceTestCase::SendPacket,
+                           this, devices.Get (1), devices.Get (0)->GetAddress ());
+    }
+
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+WifiBinaryTraceTestCase::DoRun (void)
+{
+  std::ostringstream expected;
+  RunScenario (Create<OutputStreamWrapper> (&expected));
+
+  std::string filename = CreateTempDirFilename ("wifi-binary-trace.tr");
+  Config::SetGlobal ("AsciiTraceBinary", BooleanValue (true));
+  AsciiTraceHelper helper;
+  Ptr<OutputStreamWrapper> stream = helper.CreateFileStream (filename);
+  Config::SetGlobal ("AsciiTraceBinary", BooleanValue (false));
+  RunScenario (stream);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryTraceWriter ();
+  NS_TEST_ASSERT_MSG_NE (writer, 0, "No binary trace writer");
+  writer->Close ();
+
+  BinaryTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Unable to read " << filename);
+  std::ostringstream printed;
+  BinaryTraceReader::Record record;
+  uint32_t txEvents = 0;
+  uint32_t rxEvents = 0;
+  while (reader.Read (record))
+    {
+      BinaryTraceReader::PrintAscii (printed, record);
+      NS_TEST_ASSERT_MSG_LT (record.node, 2u, "Node of " << record.context << " not parsed");
+      if (record.event == 't')
+        {
+          txEvents++;
+        }
+      if (record.event == 'r')
+        {
+          rxEvents++;
+        }
+    }
+  NS_TEST_ASSERT_MSG_GT (txEvents, 0u, "No transmit event");
+  NS_TEST_ASSERT_MSG_GT (rxEvents, 0u, "No receive event");
+  NS_TEST_ASSERT_MSG_EQ (printed.str (), expected.str (), "The binary trace file does not print as the text trace");
+}
+
+/**
+ * Binary trace format system test suite
+ */
+class AsciiBinaryTraceTestSuite : public TestSuite
+{
+public:
+  AsciiBinaryTraceTestSuite ();
+};
+
+AsciiBinaryTraceTestSuite::AsciiBinaryTraceTestSuite ()
+  : TestSuite ("ascii-binary-trace", SYSTEM)
+{
+  AddTestCase (new InternetStackBinaryTraceTestCase, TestCase::QUICK);
+  AddTestCase (new WifiBinaryTraceTestCase, TestCase::QUICK);
+}
+
+static AsciiBinaryTraceTestSuite asciiBinaryTraceTestSuite; //!< Static variable for test initialization
@@ -97,7 +97,7 @@ public:
 
 private:
   virtual void DoRun (void);
-  void AddPacket (Ptr<FqCoDelQueueDisc> queue, Ipv4Header hdr);
+  uint32_t AddPacket (Ptr<FqCoDelQueueDisc> queue, Ipv4Header hdr);
 };
 
 FqCoDelQueueDiscIPFlowsSeparationAndPacketLimit::FqCoDelQueueDiscIPFlowsSeparationAndPacketLimit ()
@@ -109,13 +109,15 @@ FqCoDelQueueDiscIPFlowsSeparationAndPacketLimit::~FqCoDelQueueDiscIPFlowsSeparat
 {
 }
 
-void
+uint32_t
 FqCoDelQueueDiscIPFlowsSeparationAndPacketLimit::AddPacket (Ptr<FqCoDelQueueDisc> queue, Ipv4Header hdr)
 {
   Ptr<Packet> p = Create<Packet> (100);
   Address dest;
   Ptr<Ipv4QueueDiscItem> item = Create<Ipv4QueueDiscItem> (p, dest, 0, hdr);
+  uint32_t index = queue->GetFlowIndex (item);
   queue->Enqueue (item);
+  return index;
 }
 
 void
@@ -137,24 +139,24 @@ FqCoDelQueueDiscIPFlowsSeparationAndPacketLimit::DoRun (void)
   hdr.SetProtocol (7);
 
   // Add three packets from the first flow
-  AddPacket (queueDisc, hdr);
+  uint32_t flow1 = AddPacket (queueDisc, hdr);
   AddPacket (queueDisc, hdr);
   AddPacket (queueDisc, hdr);
   NS_TEST_ASSERT_MSG_EQ (queueDisc->QueueDisc::GetNPackets (), 3, "unexpected number of packets in the queue disc");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 3, "unexpected number of packets in the flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow1), 3, "unexpected number of packets in the flow queue");
 
   // Add two packets from the second flow
   hdr.SetDestination (Ipv4Address ("10.10.1.7"));
   // Add the first packet
-  AddPacket (queueDisc, hdr);
+  uint32_t flow2 = AddPacket (queueDisc, hdr);
   NS_TEST_ASSERT_MSG_EQ (queueDisc->QueueDisc::GetNPackets (), 4, "unexpected number of packets in the queue disc");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 3, "unexpected number of packets in the flow queue");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (1)->GetQueueDisc ()->GetNPackets (), 1, "unexpected number of packets in the flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow1), 3, "unexpected number of packets in the flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow2), 1, "unexpected number of packets in the flow queue");
   // Add the second packet that causes two packets to be dropped from the fat flow (max backlog = 300, threshold = 150)
   AddPacket (queueDisc, hdr);
   NS_TEST_ASSERT_MSG_EQ (queueDisc->QueueDisc::GetNPackets (), 3, "unexpected number of packets in the queue disc");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 1, "unexpected number of packets in the flow queue");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (1)->GetQueueDisc ()->GetNPackets (), 2, "unexpected number of packets in the flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow1), 1, "unexpected number of packets in the flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow2), 2, "unexpected number of packets in the flow queue");
 
   Simulator::Destroy ();
 }
@@ -170,7 +172,7 @@ public:
 
 private:
   virtual void DoRun (void);
-  void AddPacket (Ptr<FqCoDelQueueDisc> queue, Ipv4Header hdr);
+  uint32_t AddPacket (Ptr<FqCoDelQueueDisc> queue, Ipv4Header hdr);
 };
 
 FqCoDelQueueDiscDeficit::FqCoDelQueueDiscDeficit ()
@@ -182,13 +184,15 @@ FqCoDelQueueDiscDeficit::~FqCoDelQueueDiscDeficit ()
 {
 }
 
-void
+uint32_t
 FqCoDelQueueDiscDeficit::AddPacket (Ptr<FqCoDelQueueDisc> queue, Ipv4Header hdr)
 {
   Ptr<Packet> p = Create<Packet> (100);
   Address dest;
   Ptr<Ipv4QueueDiscItem> item = Create<Ipv4QueueDiscItem> (p, dest, 0, hdr);
+  uint32_t index = queue->GetFlowIndex (item);
   queue->Enqueue (item);
+  return index;
 }
 
 void
@@ -210,84 +214,82 @@ FqCoDelQueueDiscDeficit::DoRun (void)
   hdr.SetProtocol (7);
 
   // Add a packet from the first flow
-  AddPacket (queueDisc, hdr);
+  uint32_t flow1 = AddPacket (queueDisc, hdr);
   NS_TEST_ASSERT_MSG_EQ (queueDisc->QueueDisc::GetNPackets (), 1, "unexpected number of packets in the queue disc");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 1, "unexpected number of packets in the first flow queue");
-  Ptr<FqCoDelFlow> flow1 = StaticCast<FqCoDelFlow> (queueDisc->GetQueueDiscClass (0));
-  NS_TEST_ASSERT_MSG_EQ (flow1->GetDeficit (), static_cast<int32_t> (queueDisc->GetQuantum ()), "the deficit of the first flow must equal the quantum");
-  NS_TEST_ASSERT_MSG_EQ (flow1->GetStatus (), FqCoDelFlow::NEW_FLOW, "the first flow must be in the list of new queues");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow1), 1, "unexpected number of packets in the first flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowDeficit (flow1), static_cast<int32_t> (queueDisc->GetQuantum ()), "the deficit of the first flow must equal the quantum");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowStatus (flow1), FqCoDelQueueDisc::NEW_FLOW, "the first flow must be in the list of new queues");
   // Dequeue a packet
   queueDisc->Dequeue ();
   NS_TEST_ASSERT_MSG_EQ (queueDisc->QueueDisc::GetNPackets (), 0, "unexpected number of packets in the queue disc");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 0, "unexpected number of packets in the first flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow1), 0, "unexpected number of packets in the first flow queue");
   // the deficit for the first flow becomes 90 - (100+20) = -30
-  NS_TEST_ASSERT_MSG_EQ (flow1->GetDeficit (), -30, "unexpected deficit for the first flow");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowDeficit (flow1), -30, "unexpected deficit for the first flow");
 
   // Add two packets from the first flow
   AddPacket (queueDisc, hdr);
   AddPacket (queueDisc, hdr);
   NS_TEST_ASSERT_MSG_EQ (queueDisc->QueueDisc::GetNPackets (), 2, "unexpected number of packets in the queue disc");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 2, "unexpected number of packets in the first flow queue");
-  NS_TEST_ASSERT_MSG_EQ (flow1->GetStatus (), FqCoDelFlow::NEW_FLOW, "the first flow must still be in the list of new queues");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow1), 2, "unexpected number of packets in the first flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowStatus (flow1), FqCoDelQueueDisc::NEW_FLOW, "the first flow must still be in the list of new queues");
 
   // Add two packets from the second flow
   hdr.SetDestination (Ipv4Address ("10.10.1.10"));
-  AddPacket (queueDisc, hdr);
+  uint32_t flow2 = AddPacket (queueDisc, hdr);
   AddPacket (queueDisc, hdr);
   NS_TEST_ASSERT_MSG_EQ (queueDisc->QueueDisc::GetNPackets (), 4, "unexpected number of packets in the queue disc");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 2, "unexpected number of packets in the first flow queue");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (1)->GetQueueDisc ()->GetNPackets (), 2, "unexpected number of packets in the second flow queue");
-  Ptr<FqCoDelFlow> flow2 = StaticCast<FqCoDelFlow> (queueDisc->GetQueueDiscClass (1));
-  NS_TEST_ASSERT_MSG_EQ (flow2->GetDeficit (), static_cast<int32_t> (queueDisc->GetQuantum ()), "the deficit of the second flow must equal the quantum");
-  NS_TEST_ASSERT_MSG_EQ (flow2->GetStatus (), FqCoDelFlow::NEW_FLOW, "the second flow must be in the list of new queues");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow1), 2, "unexpected number of packets in the first flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow2), 2, "unexpected number of packets in the second flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowDeficit (flow2), static_cast<int32_t> (queueDisc->GetQuantum ()), "the deficit of the second flow must equal the quantum");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowStatus (flow2), FqCoDelQueueDisc::NEW_FLOW, "the second flow must be in the list of new queues");
 
   // Dequeue a packet (from the second flow, as the first flow has a negative deficit)
   queueDisc->Dequeue ();
   NS_TEST_ASSERT_MSG_EQ (queueDisc->QueueDisc::GetNPackets (), 3, "unexpected number of packets in the queue disc");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 2, "unexpected number of packets in the first flow queue");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (1)->GetQueueDisc ()->GetNPackets (), 1, "unexpected number of packets in the second flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow1), 2, "unexpected number of packets in the first flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow2), 1, "unexpected number of packets in the second flow queue");
   // the first flow got a quantum of deficit (-30+90=60) and has been moved to the end of the list of old queues
-  NS_TEST_ASSERT_MSG_EQ (flow1->GetDeficit (), 60, "unexpected deficit for the first flow");
-  NS_TEST_ASSERT_MSG_EQ (flow1->GetStatus (), FqCoDelFlow::OLD_FLOW, "the first flow must be in the list of old queues");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowDeficit (flow1), 60, "unexpected deficit for the first flow");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowStatus (flow1), FqCoDelQueueDisc::OLD_FLOW, "the first flow must be in the list of old queues");
   // the second flow has a negative deficit (-30) and is still in the list of new queues
-  NS_TEST_ASSERT_MSG_EQ (flow2->GetDeficit (), -30, "unexpected deficit for the second flow");
-  NS_TEST_ASSERT_MSG_EQ (flow2->GetStatus (), FqCoDelFlow::NEW_FLOW, "the second flow must be in the list of new queues");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowDeficit (flow2), -30, "unexpected deficit for the second flow");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowStatus (flow2), FqCoDelQueueDisc::NEW_FLOW, "the second flow must be in the list of new queues");
 
   // Dequeue a packet (from the first flow, as the second flow has a negative deficit)
   queueDisc->Dequeue ();
   NS_TEST_ASSERT_MSG_EQ (queueDisc->QueueDisc::GetNPackets (), 2, "unexpected number of packets in the queue disc");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 1, "unexpected number of packets in the first flow queue");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (1)->GetQueueDisc ()->GetNPackets (), 1, "unexpected number of packets in the second flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow1), 1, "unexpected number of packets in the first flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow2), 1, "unexpected number of packets in the second flow queue");
   // the first flow has a negative deficit (60-(100+20)= -60) and stays in the list of old queues
-  NS_TEST_ASSERT_MSG_EQ (flow1->GetDeficit (), -60, "unexpected deficit for the first flow");
-  NS_TEST_ASSERT_MSG_EQ (flow1->GetStatus (), FqCoDelFlow::OLD_FLOW, "the first flow must be in the list of old queues");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowDeficit (flow1), -60, "unexpected deficit for the first flow");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowStatus (flow1), FqCoDelQueueDisc::OLD_FLOW, "the first flow must be in the list of old queues");
   // the second flow got a quantum of deficit (-30+90=60) and has been moved to the end of the list of old queues
-  NS_TEST_ASSERT_MSG_EQ (flow2->GetDeficit (), 60, "unexpected deficit for the second flow");
-  NS_TEST_ASSERT_MSG_EQ (flow2->GetStatus (), FqCoDelFlow::OLD_FLOW, "the second flow must be in the list of new queues");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowDeficit (flow2), 60, "unexpected deficit for the second flow");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowStatus (flow2), FqCoDelQueueDisc::OLD_FLOW, "the second flow must be in the list of new queues");
 
   // Dequeue a packet (from the second flow, as the first flow has a negative deficit)
   queueDisc->Dequeue ();
   NS_TEST_ASSERT_MSG_EQ (queueDisc->QueueDisc::GetNPackets (), 1, "unexpected number of packets in the queue disc");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 1, "unexpected number of packets in the first flow queue");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (1)->GetQueueDisc ()->GetNPackets (), 0, "unexpected number of packets in the second flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow1), 1, "unexpected number of packets in the first flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow2), 0, "unexpected number of packets in the second flow queue");
   // the first flow got a quantum of deficit (-60+90=30) and has been moved to the end of the list of old queues
-  NS_TEST_ASSERT_MSG_EQ (flow1->GetDeficit (), 30, "unexpected deficit for the first flow");
-  NS_TEST_ASSERT_MSG_EQ (flow1->GetStatus (), FqCoDelFlow::OLD_FLOW, "the first flow must be in the list of old queues");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowDeficit (flow1), 30, "unexpected deficit for the first flow");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowStatus (flow1), FqCoDelQueueDisc::OLD_FLOW, "the first flow must be in the list of old queues");
   // the second flow has a negative deficit (60-(100+20)= -60)
-  NS_TEST_ASSERT_MSG_EQ (flow2->GetDeficit (), -60, "unexpected deficit for the second flow");
-  NS_TEST_ASSERT_MSG_EQ (flow2->GetStatus (), FqCoDelFlow::OLD_FLOW, "the second flow must be in the list of new queues");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowDeficit (flow2), -60, "unexpected deficit for the second flow");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowStatus (flow2), FqCoDelQueueDisc::OLD_FLOW, "the second flow must be in the list of new queues");
 
   // Dequeue a packet (from the first flow, as the second flow has a negative deficit)
   queueDisc->Dequeue ();
   NS_TEST_ASSERT_MSG_EQ (queueDisc->QueueDisc::GetNPackets (), 0, "unexpected number of packets in the queue disc");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 0, "unexpected number of packets in the first flow queue");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (1)->GetQueueDisc ()->GetNPackets (), 0, "unexpected number of packets in the second flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow1), 0, "unexpected number of packets in the first flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow2), 0, "unexpected number of packets in the second flow queue");
   // the first flow has a negative deficit (30-(100+20)= -90)
-  NS_TEST_ASSERT_MSG_EQ (flow1->GetDeficit (), -90, "unexpected deficit for the first flow");
-  NS_TEST_ASSERT_MSG_EQ (flow1->GetStatus (), FqCoDelFlow::OLD_FLOW, "the first flow must be in the list of old queues");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowDeficit (flow1), -90, "unexpected deficit for the first flow");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowStatus (flow1), FqCoDelQueueDisc::OLD_FLOW, "the first flow must be in the list of old queues");
   // the second flow got a quantum of deficit (-60+90=30) and has been moved to the end of the list of old queues
-  NS_TEST_ASSERT_MSG_EQ (flow2->GetDeficit (), 30, "unexpected deficit for the second flow");
-  NS_TEST_ASSERT_MSG_EQ (flow2->GetStatus (), FqCoDelFlow::OLD_FLOW, "the second flow must be in the list of new queues");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowDeficit (flow2), 30, "unexpected deficit for the second flow");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowStatus (flow2), FqCoDelQueueDisc::OLD_FLOW, "the second flow must be in the list of new queues");
 
   // Dequeue a packet
   queueDisc->Dequeue ();
@@ -297,10 +299,10 @@ FqCoDelQueueDiscDeficit::DoRun (void)
   // reconsidered, but it has a null deficit, hence it gets another quantum of deficit (0+90=90). Then, the first
   // flow is reconsidered again, now it has a positive deficit and hence it is selected. But, it is empty and
   // therefore is set to inactive, too.
-  NS_TEST_ASSERT_MSG_EQ (flow1->GetDeficit (), 90, "unexpected deficit for the first flow");
-  NS_TEST_ASSERT_MSG_EQ (flow1->GetStatus (), FqCoDelFlow::INACTIVE, "the first flow must be inactive");
-  NS_TEST_ASSERT_MSG_EQ (flow2->GetDeficit (), 30, "unexpected deficit for the second flow");
-  NS_TEST_ASSERT_MSG_EQ (flow2->GetStatus (), FqCoDelFlow::INACTIVE, "the second flow must be inactive");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowDeficit (flow1), 90, "unexpected deficit for the first flow");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowStatus (flow1), FqCoDelQueueDisc::INACTIVE, "the first flow must be inactive");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowDeficit (flow2), 30, "unexpected deficit for the second flow");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowStatus (flow2), FqCoDelQueueDisc::INACTIVE, "the second flow must be inactive");
 
   Simulator::Destroy ();
 }
@@ -316,7 +318,7 @@ public:
 
 private:
   virtual void DoRun (void);
-  void AddPacket (Ptr<FqCoDelQueueDisc> queue, Ipv4Header ipHdr, TcpHeader tcpHdr);
+  uint32_t AddPacket (Ptr<FqCoDelQueueDisc> queue, Ipv4Header ipHdr, TcpHeader tcpHdr);
 };
 
 FqCoDelQueueDiscTCPFlowsSeparation::FqCoDelQueueDiscTCPFlowsSeparation ()
@@ -328,14 +330,16 @@ FqCoDelQueueDiscTCPFlowsSeparation::~FqCoDelQueueDiscTCPFlowsSeparation ()
 {
 }
 
-void
+uint32_t
 FqCoDelQueueDiscTCPFlowsSeparation::AddPacket (Ptr<FqCoDelQueueDisc> queue, Ipv4Header ipHdr, TcpHeader tcpHdr)
 {
   Ptr<Packet> p = Create<Packet> (100);
   p->AddHeader (tcpHdr);
   Address dest;
   Ptr<Ipv4QueueDiscItem> item = Create<Ipv4QueueDiscItem> (p, dest, 0, ipHdr);
+  uint32_t index = queue->GetFlowIndex (item);
   queue->Enqueue (item);
+  return index;
 }
 
 void
@@ -361,36 +365,36 @@ FqCoDelQueueDiscTCPFlowsSeparation::DoRun (void)
   tcpHdr.SetDestinationPort (27);
 
   // Add three packets from the first flow
-  AddPacket (queueDisc, hdr, tcpHdr);
+  uint32_t flow1 = AddPacket (queueDisc, hdr, tcpHdr);
   AddPacket (queueDisc, hdr, tcpHdr);
   AddPacket (queueDisc, hdr, tcpHdr);
   NS_TEST_ASSERT_MSG_EQ (queueDisc->QueueDisc::GetNPackets (), 3, "unexpected number of packets in the queue disc");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 3, "unexpected number of packets in the first flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow1), 3, "unexpected number of packets in the first flow queue");
 
   // Add a packet from the second flow
   tcpHdr.SetSourcePort (8);
-  AddPacket (queueDisc, hdr, tcpHdr);
+  uint32_t flow2 = AddPacket (queueDisc, hdr, tcpHdr);
   NS_TEST_ASSERT_MSG_EQ (queueDisc->QueueDisc::GetNPackets (), 4, "unexpected number of packets in the queue disc");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 3, "unexpected number of packets in the first flow queue");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (1)->GetQueueDisc ()->GetNPackets (), 1, "unexpected number of packets in the second flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow1), 3, "unexpected number of packets in the first flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow2), 1, "unexpected number of packets in the second flow queue");
 
   // Add a packet from the third flow
   tcpHdr.SetDestinationPort (28);
-  AddPacket (queueDisc, hdr, tcpHdr);
+  uint32_t flow3 = AddPacket (queueDisc, hdr, tcpHdr);
   NS_TEST_ASSERT_MSG_EQ (queueDisc->QueueDisc::GetNPackets (), 5, "unexpected number of packets in the queue disc");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 3, "unexpected number of packets in the first flow queue");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (1)->GetQueueDisc ()->GetNPackets (), 1, "unexpected number of packets in the second flow queue");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (2)->GetQueueDisc ()->GetNPackets (), 1, "unexpected number of packets in the third flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow1), 3, "unexpected number of packets in the first flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow2), 1, "unexpected number of packets in the second flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow3), 1, "unexpected number of packets in the third flow queue");
 
   // Add two packets from the fourth flow
   tcpHdr.SetSourcePort (7);
-  AddPacket (queueDisc, hdr, tcpHdr);
+  uint32_t flow4 = AddPacket (queueDisc, hdr, tcpHdr);
   AddPacket (queueDisc, hdr, tcpHdr);
   NS_TEST_ASSERT_MSG_EQ (queueDisc->QueueDisc::GetNPackets (), 7, "unexpected number of packets in the queue disc");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 3, "unexpected number of packets in the first flow queue");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (1)->GetQueueDisc ()->GetNPackets (), 1, "unexpected number of packets in the second flow queue");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (2)->GetQueueDisc ()->GetNPackets (), 1, "unexpected number of packets in the third flow queue");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (3)->GetQueueDisc ()->GetNPackets (), 2, "unexpected number of packets in the third flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow1), 3, "unexpected number of packets in the first flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow2), 1, "unexpected number of packets in the second flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow3), 1, "unexpected number of packets in the third flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow4), 2, "unexpected number of packets in the third flow queue");
 
   Simulator::Destroy ();
 }
@@ -406,7 +410,7 @@ public:
 
 private:
   virtual void DoRun (void);
-  void AddPacket (Ptr<FqCoDelQueueDisc> queue, Ipv4Header ipHdr, UdpHeader udpHdr);
+  uint32_t AddPacket (Ptr<FqCoDelQueueDisc> queue, Ipv4Header ipHdr, UdpHeader udpHdr);
 };
 
 FqCoDelQueueDiscUDPFlowsSeparation::FqCoDelQueueDiscUDPFlowsSeparation ()
@@ -418,14 +422,16 @@ FqCoDelQueueDiscUDPFlowsSeparation::~FqCoDelQueueDiscUDPFlowsSeparation ()
 {
 }
 
-void
+uint32_t
 FqCoDelQueueDiscUDPFlowsSeparation::AddPacket (Ptr<FqCoDelQueueDisc> queue, Ipv4Header ipHdr, UdpHeader udpHdr)
 {
   Ptr<Packet> p = Create<Packet> (100);
   p->AddHeader (udpHdr);
   Address dest;
   Ptr<Ipv4QueueDiscItem> item = Create<Ipv4QueueDiscItem> (p, dest, 0, ipHdr);
+  uint32_t index = queue->GetFlowIndex (item);
   queue->Enqueue (item);
+  return index;
 }
 
 void
@@ -451,36 +457,176 @@ FqCoDelQueueDiscUDPFlowsSeparation::DoRun (void)
   udpHdr.SetDestinationPort (27);
 
   // Add three packets from the first flow
-  AddPacket (queueDisc, hdr, udpHdr);
+  uint32_t flow1 = AddPacket (queueDisc, hdr, udpHdr);
   AddPacket (queueDisc, hdr, udpHdr);
   AddPacket (queueDisc, hdr, udpHdr);
   NS_TEST_ASSERT_MSG_EQ (queueDisc->QueueDisc::GetNPackets (), 3, "unexpected number of packets in the queue disc");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 3, "unexpected number of packets in the first flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow1), 3, "unexpected number of packets in the first flow queue");
 
   // Add a packet from the second flow
   udpHdr.SetSourcePort (8);
-  AddPacket (queueDisc, hdr, udpHdr);
+  uint32_t flow2 = AddPacket (queueDisc, hdr, udpHdr);
   NS_TEST_ASSERT_MSG_EQ (queueDisc->QueueDisc::GetNPackets (), 4, "unexpected number of packets in the queue disc");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 3, "unexpected number of packets in the first flow queue");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (1)->GetQueueDisc ()->GetNPackets (), 1, "unexpected number of packets in the second flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow1), 3, "unexpected number of packets in the first flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow2), 1, "unexpected number of packets in the second flow queue");
 
   // Add a packet from the third flow
   udpHdr.SetDestinationPort (28);
-  AddPacket (queueDisc, hdr, udpHdr);
+  uint32_t flow3 = AddPacket (queueDisc, hdr, udpHdr);
   NS_TEST_ASSERT_MSG_EQ (queueDisc->QueueDisc::GetNPackets (), 5, "unexpected number of packets in the queue disc");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 3, "unexpected number of packets in the first flow queue");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (1)->GetQueueDisc ()->GetNPackets (), 1, "unexpected number of packets in the second flow queue");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (2)->GetQueueDisc ()->GetNPackets (), 1, "unexpected number of packets in the third flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow1), 3, "unexpected number of packets in the first flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow2), 1, "unexpected number of packets in the second flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow3), 1, "unexpected number of packets in the third flow queue");
 
   // Add two packets from the fourth flow
   udpHdr.SetSourcePort (7);
-  AddPacket (queueDisc, hdr, udpHdr);
+  uint32_t flow4 = AddPacket (queueDisc, hdr, udpHdr);
   AddPacket (queueDisc, hdr, udpHdr);
   NS_TEST_ASSERT_MSG_EQ (queueDisc->QueueDisc::GetNPackets (), 7, "unexpected number of packets in the queue disc");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 3, "unexpected number of packets in the first flow queue");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (1)->GetQueueDisc ()->GetNPackets (), 1, "unexpected number of packets in the second flow queue");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (2)->GetQueueDisc ()->GetNPackets (), 1, "unexpected number of packets in the third flow queue");
-  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (3)->GetQueueDisc ()->GetNPackets (), 2, "unexpected number of packets in the third flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow1), 3, "unexpected number of packets in the first flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow2), 1, "unexpected number of packets in the second flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow3), 1, "unexpected number of packets in the third flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetFlowNPackets (flow4), 2, "unexpected number of packets in the third flow queue");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * This class tests the CoDel algorithm run on each flow queue
+ */
+class FqCoDelQueueDiscCoDelDrops : public TestCase
+{
+public:
+  FqCoDelQueueDiscCoDelDrops ();
+  virtual ~FqCoDelQueueDiscCoDelDrops ();
+
+private:
+  virtual void DoRun (void);
+  void Dequeue (Ptr<FqCoDelQueueDisc> queue, uint32_t flow, uint32_t packets, uint32_t drops);
+};
+
+FqCoDelQueueDiscCoDelDrops::FqCoDelQueueDiscCoDelDrops ()
+  : TestCase ("Test CoDel drops in a flow queue")
+{
+}
+
+FqCoDelQueueDiscCoDelDrops::~FqCoDelQueueDiscCoDelDrops ()
+{
+}
+
+void
+FqCoDelQueueDiscCoDelDrops::Dequeue (Ptr<FqCoDelQueueDisc> queue, uint32_t flow, uint32_t packets, uint32_t drops)
+{
+  Ptr<QueueDiscItem> item = queue->Dequeue ();
+  NS_TEST_EXPECT_MSG_NE (item, 0, "a packet should have been dequeued");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetFlowNPackets (flow), packets, "unexpected number of packets in the flow queue");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedPackets (), drops, "unexpected number of dropped packets");
+}
+
+void
+FqCoDelQueueDiscCoDelDrops::DoRun (void)
+{
+  Ptr<FqCoDelQueueDisc> queueDisc = CreateObject<FqCoDelQueueDisc> ();
+  Ptr<FqCoDelIpv4PacketFilter> ipv4Filter = CreateObject<FqCoDelIpv4PacketFilter> ();
+  queueDisc->AddPacketFilter (ipv4Filter);
+
+  queueDisc->SetQuantum (1500);
+  queueDisc->Initialize ();
+
+  Ipv4Header hdr;
+  hdr.SetPayloadSize (1000);
+  hdr.SetSource (Ipv4Address ("10.10.1.1"));
+  hdr.SetDestination (Ipv4Address ("10.10.1.2"));
+  hdr.SetProtocol (7);
+
+  uint32_t flow = 0;
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      Ptr<Ipv4QueueDiscItem> item = Create<Ipv4QueueDiscItem> (Create<Packet> (1000), Address (), 0, hdr);
+      flow = queueDisc->GetFlowIndex (item);
+      queueDisc->Enqueue (item);
+    }
+
+  // the sojourn time goes above the target: no drop for an interval
+  Simulator::Schedule (MilliSeconds (200), &FqCoDelQueueDiscCoDelDrops::Dequeue, this, queueDisc, flow, 19, 0);
+  // the sojourn time stayed above the target for an interval: drop a packet and enter the dropping state
+  Simulator::Schedule (MilliSeconds (301), &FqCoDelQueueDiscCoDelDrops::Dequeue, this, queueDisc, flow, 17, 1);
+  // the next drop is an interval later
+  Simulator::Schedule (MilliSeconds (302), &FqCoDelQueueDiscCoDelDrops::Dequeue, this, queueDisc, flow, 16, 1);
+  // the next drop is interval / sqrt (2) later
+  Simulator::Schedule (MilliSeconds (402), &FqCoDelQueueDiscCoDelDrops::Dequeue, this, queueDisc, flow, 14, 2);
+  Simulator::Schedule (MilliSeconds (403), &FqCoDelQueueDiscCoDelDrops::Dequeue, this, queueDisc, flow, 13, 2);
+  Simulator::Schedule (MilliSeconds (473), &FqCoDelQueueDiscCoDelDrops::Dequeue, this, queueDisc, flow, 11, 3);
+  Simulator::Run ();
+
+  Simulator::Destroy ();
+}
+
+/**
+ * This class tests the MinBytes attribute of the CoDel algorithm run on each flow queue
+ */
+class FqCoDelQueueDiscMinBytes : public TestCase
+{
+public:
+  FqCoDelQueueDiscMinBytes ();
+  virtual ~FqCoDelQueueDiscMinBytes ();
+
+private:
+  virtual void DoRun (void);
+  void Dequeue (Ptr<FqCoDelQueueDisc> queue, uint32_t flow, uint32_t packets);
+};
+
+FqCoDelQueueDiscMinBytes::FqCoDelQueueDiscMinBytes ()
+  : TestCase ("Test the MinBytes of the CoDel algorithm of the flow queues")
+{
+}
+
+FqCoDelQueueDiscMinBytes::~FqCoDelQueueDiscMinBytes ()
+{
+}
+
+void
+FqCoDelQueueDiscMinBytes::Dequeue (Ptr<FqCoDelQueueDisc> queue, uint32_t flow, uint32_t packets)
+{
+  Ptr<QueueDiscItem> item = queue->Dequeue ();
+  NS_TEST_EXPECT_MSG_NE (item, 0, "a packet should have been dequeued");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetFlowNPackets (flow), packets, "unexpected number of packets in the flow queue");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedPackets (), 0u, "no packet should have been dropped");
+}
+
+void
+FqCoDelQueueDiscMinBytes::DoRun (void)
+{
+  // the flow queue never holds MinBytes bytes, hence CoDel never drops
+  Ptr<FqCoDelQueueDisc> queueDisc = CreateObjectWithAttributes<FqCoDelQueueDisc> ("MinBytes", UintegerValue (30000));
+  Ptr<FqCoDelIpv4PacketFilter> ipv4Filter = CreateObject<FqCoDelIpv4PacketFilter> ();
+  queueDisc->AddPacketFilter (ipv4Filter);
+
+  queueDisc->SetQuantum (1500);
+  queueDisc->Initialize ();
+
+  Ipv4Header hdr;
+  hdr.SetPayloadSize (1000);
+  hdr.SetSource (Ipv4Address ("10.10.1.1"));
+  hdr.SetDestination (Ipv4Address ("10.10.1.2"));
+  hdr.SetProtocol (7);
+
+  uint32_t flow = 0;
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      Ptr<Ipv4QueueDiscItem> item = Create<Ipv4QueueDiscItem> (Create<Packet> (1000), Address (), 0, hdr);
+      flow = queueDisc->GetFlowIndex (item);
+      queueDisc->Enqueue (item);
+    }
+
+  // the same dequeues as in FqCoDelQueueDiscCoDelDrops
+  Simulator::Schedule (MilliSeconds (200), &FqCoDelQueueDiscMinBytes::Dequeue, this, queueDisc, flow, 19);
+  Simulator::Schedule (MilliSeconds (301), &FqCoDelQueueDiscMinBytes::Dequeue, this, queueDisc, flow, 18);
+  Simulator::Schedule (MilliSeconds (302), &FqCoDelQueueDiscMinBytes::Dequeue, this, queueDisc, flow, 17);
+  Simulator::Schedule (MilliSeconds (402), &FqCoDelQueueDiscMinBytes::Dequeue, this, queueDisc, flow, 16);
+  Simulator::Schedule (MilliSeconds (403), &FqCoDelQueueDiscMinBytes::Dequeue, this, queueDisc, flow, 15);
+  Simulator::Schedule (MilliSeconds (473), &FqCoDelQueueDiscMinBytes::Dequeue, this, queueDisc, flow, 14);
+  Simulator::Run ();
 
   Simulator::Destroy ();
 }
@@ -499,6 +645,8 @@ FqCoDelQueueDiscTestSuite::FqCoDelQueueDiscTestSuite ()
   AddTestCase (new FqCoDelQueueDiscDeficit, TestCase::QUICK);
   AddTestCase (new FqCoDelQueueDiscTCPFlowsSeparation, TestCase::QUICK);
   AddTestCase (new FqCoDelQueueDiscUDPFlowsSeparation, TestCase::QUICK);
+  AddTestCase (new FqCoDelQueueDiscCoDelDrops, TestCase::QUICK);
+  AddTestCase (new FqCoDelQueueDiscMinBytes, TestCase::QUICK);
 }
 
 static FqCoDelQueueDiscTestSuite fqCoDelQueueDiscTestSuite;
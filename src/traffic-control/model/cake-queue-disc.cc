@@ -0,0 +1,533 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/enum.h"
+#include "ns3/boolean.h"
+#include "ns3/integer.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "cake-queue-disc.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CakeQueueDisc");
+
+/**
+ * Minimum number of bytes in a flow queue to drop packets from it,
+ * the default MinBytes of CoDelQueueDisc
+ */
+static const uint32_t CAKE_MIN_BYTES = 1500;
+
+CakeQueueDisc::Flow::Flow ()
+  : deficit (0),
+    status (INACTIVE),
+    srcHost (0),
+    dstHost (0)
+{
+}
+
+NS_OBJECT_ENSURE_REGISTERED (CakeQueueDisc);
+
+TypeId CakeQueueDisc::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CakeQueueDisc")
+    .SetParent<QueueDisc> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<CakeQueueDisc> ()
+    .AddAttribute ("Bandwidth",
+                   "The rate of the shaper; zero disables the shaper",
+                   DataRateValue (DataRate (0)),
+                   MakeDataRateAccessor (&CakeQueueDisc::m_bandwidth),
+                   MakeDataRateChecker ())
+    .AddAttribute ("Overhead",
+                   "The number of bytes added to the size of each packet by the shaper",
+                   IntegerValue (0),
+                   MakeIntegerAccessor (&CakeQueueDisc::m_overhead),
+                   MakeIntegerChecker<int32_t> (-64, 256))
+    .AddAttribute ("Isolation",
+                   "The fairness among the hosts",
+                   EnumValue (ISOLATE_TRIPLE),
+                   MakeEnumAccessor (&CakeQueueDisc::m_isolation),
+                   MakeEnumChecker (ISOLATE_FLOWS, "ISOLATE_FLOWS",
+                                    ISOLATE_SRC_HOST, "ISOLATE_SRC_HOST",
+                                    ISOLATE_DST_HOST, "ISOLATE_DST_HOST",
+                                    ISOLATE_TRIPLE, "ISOLATE_TRIPLE"))
+    .AddAttribute ("AckFilter",
+                   "Whether a pure TCP ACK replaces an older ACK of the same connection",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&CakeQueueDisc::m_ackFilter),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Interval",
+                   "The CoDel algorithm interval for each flow queue",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&CakeQueueDisc::m_interval),
+                   MakeTimeChecker ())
+    .AddAttribute ("Target",
+                   "The CoDel algorithm target queue delay for each flow queue",
+                   TimeValue (MilliSeconds (5)),
+                   MakeTimeAccessor (&CakeQueueDisc::m_target),
+                   MakeTimeChecker ())
+    .AddAttribute ("PacketLimit",
+                   "The hard limit on the real queue size, measured in packets",
+                   UintegerValue (10 * 1024),
+                   MakeUintegerAccessor (&CakeQueueDisc::m_limit),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Quantum",
+                   "The number of bytes each flow queue gets to dequeue on each round",
+                   UintegerValue (1514),
+                   MakeUintegerAccessor (&CakeQueueDisc::m_quantum),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Flows",
+                   "The number of queues into which the incoming packets are classified",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&CakeQueueDisc::m_flows),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Perturbation",
+                   "The salt used as an additional input to the hash function of the packets",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&CakeQueueDisc::m_perturbation),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+CakeQueueDisc::CakeQueueDisc ()
+  : m_ackDrops (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_codel.SetDropCallback (MakeCallback (&CakeQueueDisc::Drop, this));
+}
+
+CakeQueueDisc::~CakeQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+CakeQueueDisc::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_watchdog.Cancel ();
+  m_flowTable.Clear ();
+  m_hosts.clear ();
+  m_ackSlots.clear ();
+  m_newFlows = FqFlowList ();
+  m_oldFlows = FqFlowList ();
+  QueueDisc::DoDispose ();
+}
+
+uint32_t
+CakeQueueDisc::GetFlowIndex (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+  uint32_t hash;
+  if (!ClassifyFlow (item, hash))
+    {
+      return m_flows;
+    }
+  return hash % m_flows;
+}
+
+uint32_t
+CakeQueueDisc::GetFlowNPackets (uint32_t index) const
+{
+  NS_ASSERT (index < m_flowTable.GetNFlows ());
+  return m_flowTable[index].nPackets;
+}
+
+CakeQueueDisc::FlowStatus
+CakeQueueDisc::GetFlowStatus (uint32_t index) const
+{
+  NS_ASSERT (index < m_flowTable.GetNFlows ());
+  return m_flowTable[index].status;
+}
+
+uint32_t
+CakeQueueDisc::GetAckFilterDrops (void) const
+{
+  return m_ackDrops;
+}
+
+bool
+CakeQueueDisc::ClassifyFlow (Ptr<QueueDiscItem> item, uint32_t &hash)
+{
+  if (GetNPacketFilters () == 0)
+    {
+      hash = item->Hash (m_perturbation);
+      return true;
+    }
+  int32_t ret = Classify (item);
+  if (ret == PacketFilter::PF_NO_MATCH)
+    {
+      return false;
+    }
+  hash = ret;
+  return true;
+}
+
+void
+CakeQueueDisc::ActivateHosts (Flow &flow, Ptr<QueueDiscItem> item)
+{
+  if (m_isolation == ISOLATE_FLOWS)
+    {
+      return;
+    }
+  uint32_t src = 0;
+  uint32_t dst = 0;
+  item->GetHostHashes (src, dst);
+  flow.srcHost = src % m_flows;
+  flow.dstHost = dst % m_flows;
+  m_hosts[flow.srcHost].srcFlows++;
+  m_hosts[flow.dstHost].dstFlows++;
+}
+
+void
+CakeQueueDisc::DeactivateHosts (Flow &flow)
+{
+  if (m_isolation == ISOLATE_FLOWS)
+    {
+      return;
+    }
+  NS_ASSERT (m_hosts[flow.srcHost].srcFlows > 0 && m_hosts[flow.dstHost].dstFlows > 0);
+  m_hosts[flow.srcHost].srcFlows--;
+  m_hosts[flow.dstHost].dstFlows--;
+}
+
+int32_t
+CakeQueueDisc::GetFlowQuantum (const Flow &flow) const
+{
+  uint32_t load = 1;
+  switch (m_isolation)
+    {
+    case ISOLATE_SRC_HOST:
+      load = m_hosts[flow.srcHost].srcFlows;
+      break;
+    case ISOLATE_DST_HOST:
+      load = m_hosts[flow.dstHost].dstFlows;
+      break;
+    case ISOLATE_TRIPLE:
+      load = std::max (m_hosts[flow.srcHost].srcFlows, m_hosts[flow.dstHost].dstFlows);
+      break;
+    default:
+      break;
+    }
+  return std::max<uint32_t> (m_quantum / std::max<uint32_t> (load, 1), 1);
+}
+
+bool
+CakeQueueDisc::IsAckCovered (const AckSlot &older, const AckSlot &newer)
+{
+  for (uint32_t i = 0; i < older.sackBlocks.size (); i++)
+    {
+      const std::pair<uint32_t, uint32_t> &block = older.sackBlocks[i];
+      if ((int32_t)(block.second - newer.ack) <= 0)
+        {
+          // the block has been acknowledged since
+          continue;
+        }
+      bool covered = false;
+      for (uint32_t j = 0; j < newer.sackBlocks.size () && !covered; j++)
+        {
+          covered = (int32_t)(newer.sackBlocks[j].first - block.first) <= 0
+            && (int32_t)(block.second - newer.sackBlocks[j].second) <= 0;
+        }
+      if (!covered)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+CakeQueueDisc::FilterAck (Flow &flow, uint32_t slot)
+{
+  NS_LOG_FUNCTION (this << slot);
+  AckSlot &ack = m_ackSlots[slot];
+  uint32_t prev = FQ_FLOW_NONE;
+  uint32_t dropPrev = FQ_FLOW_NONE;
+  uint32_t drop = FQ_FLOW_NONE;
+  for (uint32_t cur = flow.head; cur != slot; prev = cur, cur = m_flowTable.GetNextSlot (cur))
+    {
+      AckSlot &older = m_ackSlots[cur];
+      if (!older.pureAck || older.hash != ack.hash)
+        {
+          continue;
+        }
+      if (older.ack == ack.ack)
+        {
+          // duplicate ACKs signal losses to the sender: keep all of them
+          older.dupAck = true;
+          ack.dupAck = true;
+        }
+      else if (drop == FQ_FLOW_NONE && !older.dupAck && (int32_t)(older.ack - ack.ack) < 0
+               && IsAckCovered (older, ack))
+        {
+          drop = cur;
+          dropPrev = prev;
+        }
+    }
+  if (drop == FQ_FLOW_NONE)
+    {
+      return;
+    }
+  // the newer ACK acknowledges more data and carries the same SACK information
+  Ptr<QueueDiscItem> item = m_flowTable.RemovePacket (flow, dropPrev, drop);
+
+  NS_LOG_LOGIC ("Dropping the ACK " << item << " replaced by a newer one");
+  m_ackDrops++;
+  Drop (item);
+}
+
+bool
+CakeQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  uint32_t hash;
+  if (!ClassifyFlow (item, hash))
+    {
+      NS_LOG_ERROR ("No filter has been able to classify this packet, drop it.");
+      Drop (item);
+      return false;
+    }
+
+  uint32_t h = hash % m_flows;
+  Flow &flow = m_flowTable[h];
+
+  if (flow.status == INACTIVE)
+    {
+      flow.status = NEW_FLOW;
+      ActivateHosts (flow, item);
+      flow.deficit = GetFlowQuantum (flow);
+      m_flowTable.PushFlow (m_newFlows, h);
+    }
+
+  uint32_t slot = m_flowTable.PushPacket (flow, item);
+
+  NS_LOG_DEBUG ("Packet enqueued into flow " << h);
+
+  if (m_ackFilter)
+    {
+      if (slot >= m_ackSlots.size ())
+        {
+          m_ackSlots.resize (slot + 1);
+        }
+      AckSlot &s = m_ackSlots[slot];
+      s.pureAck = item->GetPureTcpAck (s.ack, s.sackBlocks);
+      if (s.pureAck)
+        {
+          s.dupAck = false;
+          s.hash = item->Hash (m_perturbation);
+          FilterAck (flow, slot);
+        }
+    }
+
+  if (GetNPackets () > m_limit)
+    {
+      CakeDrop ();
+    }
+
+  return true;
+}
+
+Ptr<QueueDiscItem>
+CakeQueueDisc::DoDequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Time now = Simulator::Now ();
+  if (m_bandwidth.GetBitRate () > 0 && now < m_timeNextPacket)
+    {
+      NS_LOG_LOGIC ("The shaper holds the packets until " << m_timeNextPacket);
+      if (!m_watchdog.IsRunning ())
+        {
+          m_watchdog = Simulator::Schedule (m_timeNextPacket - now, &CakeQueueDisc::Watchdog, this);
+        }
+      return 0;
+    }
+
+  uint32_t index = FQ_FLOW_NONE;
+  Ptr<QueueDiscItem> item;
+
+  do
+    {
+      bool found = false;
+
+      while (!found && m_newFlows.head != FQ_FLOW_NONE)
+        {
+          index = m_newFlows.head;
+          Flow &flow = m_flowTable[index];
+
+          if (flow.deficit <= 0)
+            {
+              flow.deficit += GetFlowQuantum (flow);
+              flow.status = OLD_FLOW;
+              m_flowTable.PopFlow (m_newFlows);
+              m_flowTable.PushFlow (m_oldFlows, index);
+            }
+          else
+            {
+              NS_LOG_DEBUG ("Found a new flow with positive deficit");
+              found = true;
+            }
+        }
+
+      while (!found && m_oldFlows.head != FQ_FLOW_NONE)
+        {
+          index = m_oldFlows.head;
+          Flow &flow = m_flowTable[index];
+
+          if (flow.deficit <= 0)
+            {
+              flow.deficit += GetFlowQuantum (flow);
+              m_flowTable.PopFlow (m_oldFlows);
+              m_flowTable.PushFlow (m_oldFlows, index);
+            }
+          else
+            {
+              NS_LOG_DEBUG ("Found an old flow with positive deficit");
+              found = true;
+            }
+        }
+
+      if (!found)
+        {
+          NS_LOG_DEBUG ("No flow found to dequeue a packet");
+          return 0;
+        }
+
+      Flow &flow = m_flowTable[index];
+      item = m_codel.Dequeue (m_flowTable, flow, flow.codel);
+
+      if (!item)
+        {
+          NS_LOG_DEBUG ("Could not get a packet from the selected flow queue");
+          if (m_newFlows.head != FQ_FLOW_NONE)
+            {
+              flow.status = OLD_FLOW;
+              m_flowTable.PopFlow (m_newFlows);
+              m_flowTable.PushFlow (m_oldFlows, index);
+            }
+          else
+            {
+              flow.status = INACTIVE;
+              DeactivateHosts (flow);
+              m_flowTable.PopFlow (m_oldFlows);
+            }
+        }
+    } while (item == 0);
+
+  m_flowTable[index].deficit -= item->GetPacketSize ();
+
+  if (m_bandwidth.GetBitRate () > 0)
+    {
+      int32_t bytes = std::max<int32_t> (item->GetPacketSize () + m_overhead, 0);
+      m_timeNextPacket = now + m_bandwidth.CalculateBytesTxTime (bytes);
+    }
+
+  return item;
+}
+
+Ptr<const QueueDiscItem>
+CakeQueueDisc::DoPeek (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_bandwidth.GetBitRate () > 0 && Simulator::Now () < m_timeNextPacket)
+    {
+      return 0;
+    }
+
+  uint32_t index;
+
+  if (m_newFlows.head != FQ_FLOW_NONE)
+    {
+      index = m_newFlows.head;
+    }
+  else if (m_oldFlows.head != FQ_FLOW_NONE)
+    {
+      index = m_oldFlows.head;
+    }
+  else
+    {
+      return 0;
+    }
+
+  uint32_t slot = m_flowTable[index].head;
+  if (slot == FQ_FLOW_NONE)
+    {
+      return 0;
+    }
+  return m_flowTable.GetPacket (slot);
+}
+
+void
+CakeQueueDisc::Watchdog (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (GetNetDevice ())
+    {
+      Run ();
+    }
+}
+
+bool
+CakeQueueDisc::CheckConfig (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (GetNQueueDiscClasses () > 0)
+    {
+      NS_LOG_ERROR ("CakeQueueDisc cannot have classes");
+      return false;
+    }
+
+  if (GetNInternalQueues () > 0)
+    {
+      NS_LOG_ERROR ("CakeQueueDisc cannot have internal queues");
+      return false;
+    }
+
+  return true;
+}
+
+void
+CakeQueueDisc::InitializeParams (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_codel.SetParams (m_interval, m_target, CAKE_MIN_BYTES);
+
+  m_flowTable.Assign (m_flows, Flow ());
+  Host host;
+  host.srcFlows = 0;
+  host.dstFlows = 0;
+  m_hosts.assign (m_isolation == ISOLATE_FLOWS ? 0 : m_flows, host);
+}
+
+void
+CakeQueueDisc::CakeDrop (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  /* Queue is full! Find the fat flow and drop a packet from it */
+  uint32_t index = m_flowTable.GetFatFlow ();
+  Drop (m_flowTable.PopPacket (m_flowTable[index]));
+}
+
+} // namespace ns3
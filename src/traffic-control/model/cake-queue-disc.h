@@ -0,0 +1,239 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CAKE_QUEUE_DISC_H
+#define CAKE_QUEUE_DISC_H
+
+#include "ns3/queue-disc.h"
+#include "ns3/nstime.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "fq-flow-table.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A CAKE-like queue disc: a shaper in front of flow queues
+ * managed by CoDel, with host fairness and ACK filtering
+ *
+ * The packets are classified into flow queues by the packet filters, if
+ * any, or else by the hash of their 5-tuple. The flow queues are served
+ * by a deficit round robin scheduler with lists of new and old flows, as
+ * in FqCoDelQueueDisc. With host isolation, the quantum given to a flow
+ * at each round is divided by the number of active flows of its source
+ * host, of its destination host, or by the largest of both (triple
+ * isolation), so that the hosts get the same share of the link whatever
+ * the number of their flows.
+ *
+ * With a Bandwidth, the queue disc dequeues the packets no faster than
+ * this rate, accounting for the Overhead of each packet. While the
+ * shaper holds the packets, a single timer restarts the transmission
+ * when the next packet is due.
+ *
+ * With the AckFilter, a pure TCP acknowledgment enqueued in a flow queue
+ * holding an older acknowledgment of the same connection replaces it, if
+ * it acknowledges strictly more data and its SACK blocks cover those of
+ * the older one. Duplicate acknowledgments are never dropped.
+ *
+ * As in FqCoDelQueueDisc, the flow queues and their CoDel instances are
+ * those of FqFlowTable and FqCoDelAqm: no memory is allocated per packet
+ * or per flow once the pool of packets has grown to the backlog.
+ */
+class CakeQueueDisc : public QueueDisc {
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief CakeQueueDisc constructor
+   */
+  CakeQueueDisc ();
+
+  virtual ~CakeQueueDisc ();
+
+  /**
+   * \enum IsolationMode
+   * \brief Fairness among the hosts
+   */
+  enum IsolationMode
+    {
+      ISOLATE_FLOWS,     /**< Fairness among the flows only */
+      ISOLATE_SRC_HOST,  /**< Fairness among the source hosts, then their flows */
+      ISOLATE_DST_HOST,  /**< Fairness among the destination hosts, then their flows */
+      ISOLATE_TRIPLE     /**< Fairness among the source and the destination hosts */
+    };
+
+  /**
+   * \enum FlowStatus
+   * \brief Used to determine the status of a flow queue
+   */
+  enum FlowStatus
+    {
+      INACTIVE,
+      NEW_FLOW,
+      OLD_FLOW
+    };
+
+  /**
+   * \brief Get the flow queue a packet is enqueued into.
+   *
+   * \param item the packet
+   * \returns the index of the flow queue, or the number of flow queues if
+   *          no filter is able to classify the packet
+   */
+  uint32_t GetFlowIndex (Ptr<QueueDiscItem> item);
+
+  /**
+   * \param index the index of a flow queue
+   * \returns the number of packets in the flow queue
+   */
+  uint32_t GetFlowNPackets (uint32_t index) const;
+
+  /**
+   * \param index the index of a flow queue
+   * \returns the status of the flow queue
+   */
+  FlowStatus GetFlowStatus (uint32_t index) const;
+
+  /**
+   * \returns the number of acknowledgments dropped by the ACK filter
+   */
+  uint32_t GetAckFilterDrops (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
+  virtual Ptr<QueueDiscItem> DoDequeue (void);
+  virtual Ptr<const QueueDiscItem> DoPeek (void) const;
+  virtual bool CheckConfig (void);
+  virtual void InitializeParams (void);
+
+  /**
+   * A flow queue
+   */
+  struct Flow : public FqFlowQueue
+  {
+    Flow ();
+    int32_t deficit;         //!< The deficit
+    FlowStatus status;       //!< The status
+    uint32_t srcHost;        //!< The entry of the source host
+    uint32_t dstHost;        //!< The entry of the destination host
+    FqCoDelState codel;      //!< The CoDel state
+  };
+
+  /**
+   * The active flows of a host
+   */
+  struct Host
+  {
+    uint32_t srcFlows;       //!< Number of active flows from the host
+    uint32_t dstFlows;       //!< Number of active flows to the host
+  };
+
+  /**
+   * The pure ACK held in a packet slot
+   */
+  struct AckSlot
+  {
+    bool pureAck;            //!< Whether the packet is a pure ACK
+    uint32_t hash;           //!< The 5-tuple hash, if the packet is a pure ACK
+    uint32_t ack;            //!< The acknowledgment number, if the packet is a pure ACK
+    bool dupAck;             //!< Whether another queued ACK of the connection has the same number
+    std::vector<std::pair<uint32_t, uint32_t> > sackBlocks; //!< The SACK blocks, if the packet is a pure ACK
+  };
+
+  /**
+   * \brief Classify a packet
+   * \param item the packet
+   * \param hash the hash of the packet
+   * \returns false if no filter is able to classify the packet
+   */
+  bool ClassifyFlow (Ptr<QueueDiscItem> item, uint32_t &hash);
+  /**
+   * \brief Count a flow queue in the active flows of its hosts
+   * \param flow the flow queue
+   * \param item the first packet of the flow queue
+   */
+  void ActivateHosts (Flow &flow, Ptr<QueueDiscItem> item);
+  /**
+   * \brief Remove a flow queue from the active flows of its hosts
+   * \param flow the flow queue
+   */
+  void DeactivateHosts (Flow &flow);
+  /**
+   * \brief Get the quantum of a flow queue for a round
+   * \param flow the flow queue
+   * \returns the quantum divided by the number of flows of the hosts
+   */
+  int32_t GetFlowQuantum (const Flow &flow) const;
+  /**
+   * \brief Drop an older acknowledgment of the connection of a pure ACK
+   * \param flow the flow queue of the pure ACK
+   * \param slot the slot of the pure ACK
+   */
+  void FilterAck (Flow &flow, uint32_t slot);
+  /**
+   * \brief Check whether a pure ACK carries all the information of an older one
+   * \param older the older pure ACK
+   * \param newer the newer pure ACK of the same connection
+   * \returns true if every SACK block of the older ACK is acknowledged or
+   *          included in a SACK block of the newer ACK
+   */
+  static bool IsAckCovered (const AckSlot &older, const AckSlot &newer);
+  /**
+   * \brief Restart the transmission when the shaper releases a packet
+   */
+  void Watchdog (void);
+
+  /**
+   * \brief Drop a packet from the head of the queue with the largest current byte count
+   */
+  void CakeDrop (void);
+
+  DataRate m_bandwidth;      //!< Shaper rate, or zero for no shaping
+  int32_t m_overhead;        //!< Bytes added to each packet by the shaper
+  IsolationMode m_isolation; //!< Fairness among the hosts
+  bool m_ackFilter;          //!< Whether to filter the pure ACKs
+  Time m_interval;           //!< CoDel interval
+  Time m_target;             //!< CoDel target
+  uint32_t m_limit;          //!< Maximum number of packets in the queue disc
+  uint32_t m_quantum;        //!< Deficit assigned to flows at each round
+  uint32_t m_flows;          //!< Number of flow queues
+  uint32_t m_perturbation;   //!< Hash perturbation value
+
+  uint32_t m_ackDrops;       //!< Number of acknowledgments dropped by the ACK filter
+
+  Time m_timeNextPacket;     //!< Time the shaper releases the next packet
+  EventId m_watchdog;        //!< Timer of the shaper
+
+  FqFlowTable<Flow> m_flowTable;      //!< The flow queues, indexed by hash
+  FqCoDelAqm m_codel;                 //!< The CoDel algorithm of the flow queues
+  std::vector<Host> m_hosts;          //!< The hosts, indexed by hash
+  std::vector<AckSlot> m_ackSlots;    //!< The pure ACKs, indexed by packet slot
+  FqFlowList m_newFlows;              //!< The list of new flows
+  FqFlowList m_oldFlows;              //!< The list of old flows
+};
+
+} // namespace ns3
+
+#endif /* CAKE_QUEUE_DISC_H */
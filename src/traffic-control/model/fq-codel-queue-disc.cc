@@ -21,72 +21,20 @@
 
 #include "ns3/log.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
 #include "fq-codel-queue-disc.h"
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("FqCoDelQueueDisc");
 
-NS_OBJECT_ENSURE_REGISTERED (FqCoDelFlow);
-
-TypeId FqCoDelFlow::GetTypeId (void)
-{
-  static TypeId tid = TypeId ("ns3::FqCoDelFlow")
-    .SetParent<QueueDiscClass> ()
-    .SetGroupName ("TrafficControl")
-    .AddConstructor<FqCoDelFlow> ()
-  ;
-  return tid;
-}
-
-FqCoDelFlow::FqCoDelFlow ()
-  : m_deficit (0),
-    m_status (INACTIVE)
-{
-  NS_LOG_FUNCTION (this);
-}
-
-FqCoDelFlow::~FqCoDelFlow ()
+FqCoDelQueueDisc::Flow::Flow ()
+  : deficit (0),
+    status (INACTIVE)
 {
-  NS_LOG_FUNCTION (this);
-}
-
-void
-FqCoDelFlow::SetDeficit (uint32_t deficit)
-{
-  NS_LOG_FUNCTION (this << deficit);
-  m_deficit = deficit;
-}
-
-int32_t
-FqCoDelFlow::GetDeficit (void) const
-{
-  NS_LOG_FUNCTION (this);
-  return m_deficit;
 }
 
-void
-FqCoDelFlow::IncreaseDeficit (int32_t deficit)
-{
-  NS_LOG_FUNCTION (this << deficit);
-  m_deficit += deficit;
-}
-
-void
-FqCoDelFlow::SetStatus (FlowStatus status)
-{
-  NS_LOG_FUNCTION (this);
-  m_status = status;
-}
-
-FqCoDelFlow::FlowStatus
-FqCoDelFlow::GetStatus (void) const
-{
-  NS_LOG_FUNCTION (this);
-  return m_status;
-}
-
-
 NS_OBJECT_ENSURE_REGISTERED (FqCoDelQueueDisc);
 
 TypeId FqCoDelQueueDisc::GetTypeId (void)
@@ -105,6 +53,11 @@ TypeId FqCoDelQueueDisc::GetTypeId (void)
                    StringValue ("5ms"),
                    MakeStringAccessor (&FqCoDelQueueDisc::m_target),
                    MakeStringChecker ())
+    .AddAttribute ("MinBytes",
+                   "The CoDel algorithm minbytes parameter for each FQCoDel queue",
+                   UintegerValue (1500),
+                   MakeUintegerAccessor (&FqCoDelQueueDisc::m_minBytes),
+                   MakeUintegerChecker<uint32_t> ())
     .AddAttribute ("PacketLimit",
                    "The hard limit on the real queue size, measured in packets",
                    UintegerValue (10 * 1024),
@@ -114,7 +67,7 @@ TypeId FqCoDelQueueDisc::GetTypeId (void)
                    "The number of queues into which the incoming packets are classified",
                    UintegerValue (1024),
                    MakeUintegerAccessor (&FqCoDelQueueDisc::m_flows),
-                   MakeUintegerChecker<uint32_t> ())
+                   MakeUintegerChecker<uint32_t> (1))
     .AddAttribute ("DropBatchSize",
                    "The maximum number of packets dropped from the fat flow",
                    UintegerValue (64),
@@ -129,6 +82,7 @@ FqCoDelQueueDisc::FqCoDelQueueDisc ()
     m_overlimitDroppedPackets (0)
 {
   NS_LOG_FUNCTION (this);
+  m_codel.SetDropCallback (MakeCallback (&FqCoDelQueueDisc::Drop, this));
 }
 
 FqCoDelQueueDisc::~FqCoDelQueueDisc ()
@@ -136,6 +90,16 @@ FqCoDelQueueDisc::~FqCoDelQueueDisc ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+FqCoDelQueueDisc::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_flowTable.Clear ();
+  m_newFlows = FqFlowList ();
+  m_oldFlows = FqFlowList ();
+  QueueDisc::DoDispose ();
+}
+
 void
 FqCoDelQueueDisc::SetQuantum (uint32_t quantum)
 {
@@ -149,6 +113,46 @@ FqCoDelQueueDisc::GetQuantum (void) const
   return m_quantum;
 }
 
+uint32_t
+FqCoDelQueueDisc::GetFlowIndex (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+  int32_t ret = Classify (item);
+  if (ret == PacketFilter::PF_NO_MATCH)
+    {
+      return m_flows;
+    }
+  return ret % m_flows;
+}
+
+uint32_t
+FqCoDelQueueDisc::GetFlowNPackets (uint32_t index) const
+{
+  NS_ASSERT (index < m_flowTable.GetNFlows ());
+  return m_flowTable[index].nPackets;
+}
+
+uint32_t
+FqCoDelQueueDisc::GetFlowNBytes (uint32_t index) const
+{
+  NS_ASSERT (index < m_flowTable.GetNFlows ());
+  return m_flowTable[index].nBytes;
+}
+
+int32_t
+FqCoDelQueueDisc::GetFlowDeficit (uint32_t index) const
+{
+  NS_ASSERT (index < m_flowTable.GetNFlows ());
+  return m_flowTable[index].deficit;
+}
+
+FqCoDelQueueDisc::FlowStatus
+FqCoDelQueueDisc::GetFlowStatus (uint32_t index) const
+{
+  NS_ASSERT (index < m_flowTable.GetNFlows ());
+  return m_flowTable[index].status;
+}
+
 bool
 FqCoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
 {
@@ -164,34 +168,18 @@ FqCoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
     }
 
   uint32_t h = ret % m_flows;
+  Flow &flow = m_flowTable[h];
 
-  Ptr<FqCoDelFlow> flow;
-  if (m_flowsIndices.find (h) == m_flowsIndices.end ())
-    {
-      NS_LOG_DEBUG ("Creating a new flow queue with index " << h);
-      flow = m_flowFactory.Create<FqCoDelFlow> ();
-      Ptr<QueueDisc> qd = m_queueDiscFactory.Create<QueueDisc> ();
-      qd->Initialize ();
-      flow->SetQueueDisc (qd);
-      AddQueueDiscClass (flow);
-
-      m_flowsIndices[h] = GetNQueueDiscClasses () - 1;
-    }
-  else
-    {
-      flow = StaticCast<FqCoDelFlow> (GetQueueDiscClass (m_flowsIndices[h]));
-    }
-
-  if (flow->GetStatus () == FqCoDelFlow::INACTIVE)
+  if (flow.status == INACTIVE)
     {
-      flow->SetStatus (FqCoDelFlow::NEW_FLOW);
-      flow->SetDeficit (m_quantum);
-      m_newFlows.push_back (flow);
+      flow.status = NEW_FLOW;
+      flow.deficit = m_quantum;
+      m_flowTable.PushFlow (m_newFlows, h);
     }
 
-  flow->GetQueueDisc ()->Enqueue (item);
+  m_flowTable.PushPacket (flow, item);
 
-  NS_LOG_DEBUG ("Packet enqueued into flow " << h << "; flow index " << m_flowsIndices[h]);
+  NS_LOG_DEBUG ("Packet enqueued into flow " << h);
 
   if (GetNPackets () > m_limit)
     {
@@ -206,23 +194,24 @@ FqCoDelQueueDisc::DoDequeue (void)
 {
   NS_LOG_FUNCTION (this);
 
-  Ptr<FqCoDelFlow> flow;
+  uint32_t index = FQ_FLOW_NONE;
   Ptr<QueueDiscItem> item;
 
   do
     {
       bool found = false;
 
-      while (!found && !m_newFlows.empty ())
+      while (!found && m_newFlows.head != FQ_FLOW_NONE)
         {
-          flow = m_newFlows.front ();
+          index = m_newFlows.head;
+          Flow &flow = m_flowTable[index];
 
-          if (flow->GetDeficit () <= 0)
+          if (flow.deficit <= 0)
             {
-              flow->IncreaseDeficit (m_quantum);
-              flow->SetStatus (FqCoDelFlow::OLD_FLOW);
-              m_oldFlows.push_back (flow);
-              m_newFlows.pop_front ();
+              flow.deficit += m_quantum;
+              flow.status = OLD_FLOW;
+              m_flowTable.PopFlow (m_newFlows);
+              m_flowTable.PushFlow (m_oldFlows, index);
             }
           else
             {
@@ -231,15 +220,16 @@ FqCoDelQueueDisc::DoDequeue (void)
             }
         }
 
-      while (!found && !m_oldFlows.empty ())
+      while (!found && m_oldFlows.head != FQ_FLOW_NONE)
         {
-          flow = m_oldFlows.front ();
+          index = m_oldFlows.head;
+          Flow &flow = m_flowTable[index];
 
-          if (flow->GetDeficit () <= 0)
+          if (flow.deficit <= 0)
             {
-              flow->IncreaseDeficit (m_quantum);
-              m_oldFlows.push_back (flow);
-              m_oldFlows.pop_front ();
+              flow.deficit += m_quantum;
+              m_flowTable.PopFlow (m_oldFlows);
+              m_flowTable.PushFlow (m_oldFlows, index);
             }
           else
             {
@@ -254,21 +244,22 @@ FqCoDelQueueDisc::DoDequeue (void)
           return 0;
         }
 
-      item = flow->GetQueueDisc ()->Dequeue ();
+      Flow &flow = m_flowTable[index];
+      item = m_codel.Dequeue (m_flowTable, flow, flow.codel);
 
       if (!item)
         {
           NS_LOG_DEBUG ("Could not get a packet from the selected flow queue");
-          if (!m_newFlows.empty ())
+          if (m_newFlows.head != FQ_FLOW_NONE)
             {
-              flow->SetStatus (FqCoDelFlow::OLD_FLOW);
-              m_oldFlows.push_back (flow);
-              m_newFlows.pop_front ();
+              flow.status = OLD_FLOW;
+              m_flowTable.PopFlow (m_newFlows);
+              m_flowTable.PushFlow (m_oldFlows, index);
             }
           else
             {
-              flow->SetStatus (FqCoDelFlow::INACTIVE);
-              m_oldFlows.pop_front ();
+              flow.status = INACTIVE;
+              m_flowTable.PopFlow (m_oldFlows);
             }
         }
       else
@@ -277,7 +268,7 @@ FqCoDelQueueDisc::DoDequeue (void)
         }
     } while (item == 0);
 
-  flow->IncreaseDeficit (-item->GetPacketSize ());
+  m_flowTable[index].deficit -= item->GetPacketSize ();
 
   return item;
 }
@@ -287,17 +278,17 @@ FqCoDelQueueDisc::DoPeek (void) const
 {
   NS_LOG_FUNCTION (this);
 
-  Ptr<FqCoDelFlow> flow;
+  uint32_t index;
 
-  if (!m_newFlows.empty ())
+  if (m_newFlows.head != FQ_FLOW_NONE)
     {
-      flow = m_newFlows.front ();
+      index = m_newFlows.head;
     }
   else
     {
-      if (!m_oldFlows.empty ())
+      if (m_oldFlows.head != FQ_FLOW_NONE)
         {
-          flow = m_oldFlows.front ();
+          index = m_oldFlows.head;
         }
       else
         {
@@ -305,7 +296,12 @@ FqCoDelQueueDisc::DoPeek (void) const
         }
     }
 
-  return flow->GetQueueDisc ()->Peek ();
+  uint32_t slot = m_flowTable[index].head;
+  if (slot == FQ_FLOW_NONE)
+    {
+      return 0;
+    }
+  return m_flowTable.GetPacket (slot);
 }
 
 bool
@@ -348,13 +344,9 @@ FqCoDelQueueDisc::InitializeParams (void)
       NS_LOG_DEBUG ("Setting the quantum to the MTU of the device: " << m_quantum);
     }
 
-  m_flowFactory.SetTypeId ("ns3::FqCoDelFlow");
+  m_codel.SetParams (Time (m_interval), Time (m_target), m_minBytes);
 
-  m_queueDiscFactory.SetTypeId ("ns3::CoDelQueueDisc");
-  m_queueDiscFactory.Set ("Mode", EnumValue (Queue::QUEUE_MODE_PACKETS));
-  m_queueDiscFactory.Set ("MaxPackets", UintegerValue (m_limit + 1));
-  m_queueDiscFactory.Set ("Interval", StringValue (m_interval));
-  m_queueDiscFactory.Set ("Target", StringValue (m_target));
+  m_flowTable.Assign (m_flows, Flow ());
 }
 
 uint32_t
@@ -362,31 +354,20 @@ FqCoDelQueueDisc::FqCoDelDrop (void)
 {
   NS_LOG_FUNCTION (this);
 
-  uint32_t maxBacklog = 0, index = 0;
-  Ptr<QueueDisc> qd;
-
   /* Queue is full! Find the fat flow and drop packet(s) from it */
-  for (uint32_t i = 0; i < GetNQueueDiscClasses (); i++)
-    {
-      qd = GetQueueDiscClass (i)->GetQueueDisc ();
-      uint32_t bytes = qd->GetNBytes ();
-      if (bytes > maxBacklog)
-        {
-          maxBacklog = bytes;
-          index = i;
-        }
-    }
+  uint32_t index = m_flowTable.GetFatFlow ();
+  Flow &flow = m_flowTable[index];
 
   /* Our goal is to drop half of this fat flow backlog */
-  uint32_t len = 0, count = 0, threshold = maxBacklog >> 1;
-  qd = GetQueueDiscClass (index)->GetQueueDisc ();
-  Ptr<QueueItem> item;
+  uint32_t len = 0, count = 0, threshold = flow.nBytes >> 1;
+  Ptr<QueueDiscItem> item;
 
   do
     {
-      item = qd->GetInternalQueue (0)->Remove ();
+      item = m_flowTable.PopPacket (flow);
       len += item->GetPacketSize ();
-    } while (++count < m_dropBatchSize && len < threshold);
+      Drop (item);
+    } while (++count < m_dropBatchSize && len < threshold && flow.nPackets > 0);
 
   m_overlimitDroppedPackets += count;
 
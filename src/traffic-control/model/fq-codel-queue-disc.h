@@ -23,19 +23,26 @@
 #define FQ_CODEL_QUEUE_DISC
 
 #include "ns3/queue-disc.h"
-#include "ns3/object-factory.h"
-#include <list>
-#include <map>
+#include "fq-flow-table.h"
 
 namespace ns3 {
 
 /**
  * \ingroup traffic-control
  *
- * \brief A flow queue used by the FqCoDel queue disc
+ * \brief A FqCoDel packet queue disc
+ *
+ * The flow queues are the entries of a FqFlowTable indexed by the hash
+ * of the packets modulo the number of flows. A flow queue is a FIFO of
+ * packets taken from a pool shared by all the flows, its deficit, its
+ * status and the state of its CoDel instance, run by FqCoDelAqm. The
+ * lists of new and old flows link the flow queues through their index
+ * in the table, hence no object is created per flow and enqueue and
+ * dequeue take constant time, except for the search of the fat flow
+ * when the packet limit is exceeded.
  */
 
-class FqCoDelFlow : public QueueDiscClass {
+class FqCoDelQueueDisc : public QueueDisc {
 public:
   /**
    * \brief Get the type ID.
@@ -43,15 +50,15 @@ public:
    */
   static TypeId GetTypeId (void);
   /**
-   * \brief FqCoDelFlow constructor
+   * \brief FqCoDelQueueDisc constructor
    */
-  FqCoDelFlow ();
+  FqCoDelQueueDisc ();
 
-  virtual ~FqCoDelFlow ();
+  virtual ~FqCoDelQueueDisc ();
 
   /**
    * \enum FlowStatus
-   * \brief Used to determine the status of this flow queue
+   * \brief Used to determine the status of a flow queue
    */
   enum FlowStatus
     {
@@ -60,58 +67,6 @@ public:
       OLD_FLOW
     };
 
-  /**
-   * \brief Set the deficit for this flow
-   * \param deficit the deficit for this flow
-   */
-  void SetDeficit (uint32_t deficit);
-  /**
-   * \brief Get the deficit for this flow
-   * \return the deficit for this flow
-   */
-  int32_t GetDeficit (void) const;
-  /**
-   * \brief Increase the deficit for this flow
-   * \param deficit the amount by which the deficit is to be increased
-   */
-  void IncreaseDeficit (int32_t deficit);
-  /**
-   * \brief Set the status for this flow
-   * \param status the status for this flow
-   */
-  void SetStatus (FlowStatus status);
-  /**
-   * \brief Get the status of this flow
-   * \return the status of this flow
-   */
-  FlowStatus GetStatus (void) const;
-
-private:
-  int32_t m_deficit;    //!< the deficit for this flow
-  FlowStatus m_status;  //!< the status of this flow
-};
-
-
-/**
- * \ingroup traffic-control
- *
- * \brief A FqCoDel packet queue disc
- */
-
-class FqCoDelQueueDisc : public QueueDisc {
-public:
-  /**
-   * \brief Get the type ID.
-   * \return the object TypeId
-   */
-  static TypeId GetTypeId (void);
-  /**
-   * \brief FqCoDelQueueDisc constructor
-   */
-  FqCoDelQueueDisc ();
-
-  virtual ~FqCoDelQueueDisc ();
-
    /**
     * \brief Set the quantum value.
     *
@@ -126,6 +81,42 @@ public:
     */
    uint32_t GetQuantum (void) const;
 
+  /**
+   * \brief Get the flow queue a packet is enqueued into.
+   *
+   * \param item the packet
+   * \returns the index of the flow queue, or the number of flow queues if
+   *          no filter is able to classify the packet
+   */
+  uint32_t GetFlowIndex (Ptr<QueueDiscItem> item);
+
+  /**
+   * \param index the index of a flow queue
+   * \returns the number of packets in the flow queue
+   */
+  uint32_t GetFlowNPackets (uint32_t index) const;
+
+  /**
+   * \param index the index of a flow queue
+   * \returns the number of bytes in the flow queue
+   */
+  uint32_t GetFlowNBytes (uint32_t index) const;
+
+  /**
+   * \param index the index of a flow queue
+   * \returns the deficit of the flow queue
+   */
+  int32_t GetFlowDeficit (uint32_t index) const;
+
+  /**
+   * \param index the index of a flow queue
+   * \returns the status of the flow queue
+   */
+  FlowStatus GetFlowStatus (uint32_t index) const;
+
+protected:
+  virtual void DoDispose (void);
+
 private:
   virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
   virtual Ptr<QueueDiscItem> DoDequeue (void);
@@ -133,6 +124,17 @@ private:
   virtual bool CheckConfig (void);
   virtual void InitializeParams (void);
 
+  /**
+   * A flow queue
+   */
+  struct Flow : public FqFlowQueue
+  {
+    Flow ();
+    int32_t deficit;         //!< The deficit
+    FlowStatus status;       //!< The status
+    FqCoDelState codel;      //!< The CoDel state
+  };
+
   /**
    * \brief Drop a packet from the head of the queue with the largest current byte count
    * \return the index of the queue with the largest current byte count
@@ -141,6 +143,7 @@ private:
 
   std::string m_interval;    //!< CoDel interval attribute
   std::string m_target;      //!< CoDel target attribute
+  uint32_t m_minBytes;       //!< CoDel minbytes attribute
   uint32_t m_limit;          //!< Maximum number of packets in the queue disc
   uint32_t m_quantum;        //!< Deficit assigned to flows at each round
   uint32_t m_flows;          //!< Number of flow queues
@@ -148,13 +151,10 @@ private:
 
   uint32_t m_overlimitDroppedPackets; //!< Number of overlimit dropped packets
 
-  std::list<Ptr<FqCoDelFlow> > m_newFlows;    //!< The list of new flows
-  std::list<Ptr<FqCoDelFlow> > m_oldFlows;    //!< The list of old flows
-
-  std::map<uint32_t, uint32_t> m_flowsIndices;    //!< Map with the index of class for each flow
-
-  ObjectFactory m_flowFactory;         //!< Factory to create a new flow
-  ObjectFactory m_queueDiscFactory;    //!< Factory to create a new queue
+  FqFlowTable<Flow> m_flowTable;      //!< The flow queues, indexed by hash
+  FqCoDelAqm m_codel;                 //!< The CoDel algorithm of the flow queues
+  FqFlowList m_newFlows;              //!< The list of new flows
+  FqFlowList m_oldFlows;              //!< The list of old flows
 };
 
 } // namespace ns3
@@ -0,0 +1,350 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "fq-flow-table.h"
+#include "codel-queue-disc.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FqFlowTable");
+
+/**
+ * Performs a reciprocal divide, as in CoDelQueueDisc
+ * \param A numerator
+ * \param R reciprocal of the denominator B
+ * \return the value of A/B
+ */
+static inline uint32_t FqReciprocalDivide (uint32_t A, uint32_t R)
+{
+  return (uint32_t)(((uint64_t)A * R) >> 32);
+}
+
+/**
+ * \param a a time in CoDel time units
+ * \param b a time in CoDel time units
+ * \return true if a is after b
+ */
+static inline bool FqCoDelTimeAfter (uint32_t a, uint32_t b)
+{
+  return  ((int32_t)(a) - (int32_t)(b) > 0);
+}
+
+/**
+ * \param a a time in CoDel time units
+ * \param b a time in CoDel time units
+ * \return true if a is after or equal to b
+ */
+static inline bool FqCoDelTimeAfterEq (uint32_t a, uint32_t b)
+{
+  return ((int32_t)(a) - (int32_t)(b) >= 0);
+}
+
+/**
+ * \param a a time in CoDel time units
+ * \param b a time in CoDel time units
+ * \return true if a is before b
+ */
+static inline bool FqCoDelTimeBefore (uint32_t a, uint32_t b)
+{
+  return  ((int32_t)(a) - (int32_t)(b) < 0);
+}
+
+/**
+ * \param t a time
+ * \return the time in CoDel time units
+ */
+static inline uint32_t FqCoDelTime (Time t)
+{
+  return (t.GetNanoSeconds () >> CODEL_SHIFT);
+}
+
+FqFlowQueue::FqFlowQueue ()
+  : head (FQ_FLOW_NONE),
+    tail (FQ_FLOW_NONE),
+    nPackets (0),
+    nBytes (0),
+    next (FQ_FLOW_NONE)
+{
+}
+
+FqFlowList::FqFlowList ()
+  : head (FQ_FLOW_NONE),
+    tail (FQ_FLOW_NONE)
+{
+}
+
+FqPacketPool::FqPacketPool ()
+  : m_freeSlot (FQ_FLOW_NONE)
+{
+}
+
+uint32_t
+FqPacketPool::PushPacket (FqFlowQueue &flow, Ptr<QueueDiscItem> item)
+{
+  uint32_t slot = m_freeSlot;
+  if (slot != FQ_FLOW_NONE)
+    {
+      m_freeSlot = m_slots[slot].next;
+    }
+  else
+    {
+      slot = m_slots.size ();
+      m_slots.push_back (PacketSlot ());
+    }
+  m_slots[slot].item = item;
+  m_slots[slot].next = FQ_FLOW_NONE;
+
+  if (flow.tail == FQ_FLOW_NONE)
+    {
+      flow.head = slot;
+    }
+  else
+    {
+      m_slots[flow.tail].next = slot;
+    }
+  flow.tail = slot;
+  flow.nPackets++;
+  flow.nBytes += item->GetPacketSize ();
+  return slot;
+}
+
+Ptr<QueueDiscItem>
+FqPacketPool::PopPacket (FqFlowQueue &flow)
+{
+  NS_ASSERT (flow.head != FQ_FLOW_NONE);
+  return RemovePacket (flow, FQ_FLOW_NONE, flow.head);
+}
+
+Ptr<QueueDiscItem>
+FqPacketPool::RemovePacket (FqFlowQueue &flow, uint32_t prev, uint32_t slot)
+{
+  NS_ASSERT (slot < m_slots.size ());
+  Ptr<QueueDiscItem> item = m_slots[slot].item;
+  m_slots[slot].item = 0;
+
+  if (prev == FQ_FLOW_NONE)
+    {
+      flow.head = m_slots[slot].next;
+    }
+  else
+    {
+      m_slots[prev].next = m_slots[slot].next;
+    }
+  if (flow.tail == slot)
+    {
+      flow.tail = prev;
+    }
+  m_slots[slot].next = m_freeSlot;
+  m_freeSlot = slot;
+
+  flow.nPackets--;
+  flow.nBytes -= item->GetPacketSize ();
+  return item;
+}
+
+Ptr<QueueDiscItem>
+FqPacketPool::GetPacket (uint32_t slot) const
+{
+  NS_ASSERT (slot < m_slots.size ());
+  return m_slots[slot].item;
+}
+
+uint32_t
+FqPacketPool::GetNextSlot (uint32_t slot) const
+{
+  NS_ASSERT (slot < m_slots.size ());
+  return m_slots[slot].next;
+}
+
+void
+FqPacketPool::Clear (void)
+{
+  m_slots.clear ();
+  m_freeSlot = FQ_FLOW_NONE;
+}
+
+FqCoDelState::FqCoDelState ()
+  : count (0),
+    lastCount (0),
+    dropping (false),
+    recInvSqrt (~0U >> REC_INV_SQRT_SHIFT),
+    firstAboveTime (0),
+    dropNext (0)
+{
+}
+
+FqCoDelAqm::FqCoDelAqm ()
+  : m_interval (0),
+    m_target (0),
+    m_minBytes (0)
+{
+}
+
+void
+FqCoDelAqm::SetParams (Time interval, Time target, uint32_t minBytes)
+{
+  m_interval = FqCoDelTime (interval);
+  m_target = FqCoDelTime (target);
+  m_minBytes = minBytes;
+}
+
+void
+FqCoDelAqm::SetDropCallback (Callback<void, Ptr<QueueItem> > drop)
+{
+  m_drop = drop;
+}
+
+void
+FqCoDelAqm::NewtonStep (FqCoDelState &state)
+{
+  uint32_t invsqrt = ((uint32_t) state.recInvSqrt) << REC_INV_SQRT_SHIFT;
+  uint32_t invsqrt2 = ((uint64_t) invsqrt * invsqrt) >> 32;
+  uint64_t val = (3ll << 32) - ((uint64_t) state.count * invsqrt2);
+
+  val >>= 2; /* avoid overflow */
+  val = (val * invsqrt) >> (32 - 2 + 1);
+  state.recInvSqrt = val >> REC_INV_SQRT_SHIFT;
+}
+
+uint32_t
+FqCoDelAqm::ControlLaw (const FqCoDelState &state, uint32_t t) const
+{
+  return t + FqReciprocalDivide (m_interval, state.recInvSqrt << REC_INV_SQRT_SHIFT);
+}
+
+bool
+FqCoDelAqm::OkToDrop (const FqFlowQueue &flow, FqCoDelState &state, Ptr<QueueDiscItem> item, uint32_t now)
+{
+  uint32_t sojournTime = FqCoDelTime (Simulator::Now () - item->GetTimeStamp ());
+
+  if (FqCoDelTimeBefore (sojournTime, m_target)
+      || flow.nBytes < m_minBytes)
+    {
+      // went below so we'll stay below for at least interval
+      state.firstAboveTime = 0;
+      return false;
+    }
+  bool okToDrop = false;
+  if (state.firstAboveTime == 0)
+    {
+      // just went above from below. If we stay above
+      // for at least interval we'll say it's ok to drop
+      state.firstAboveTime = now + m_interval;
+    }
+  else if (FqCoDelTimeAfter (now, state.firstAboveTime))
+    {
+      okToDrop = true;
+    }
+  return okToDrop;
+}
+
+Ptr<QueueDiscItem>
+FqCoDelAqm::Dequeue (FqPacketPool &pool, FqFlowQueue &flow, FqCoDelState &state)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (flow.nPackets == 0)
+    {
+      // Leave dropping state when queue is empty
+      state.dropping = false;
+      state.firstAboveTime = 0;
+      return 0;
+    }
+  uint32_t now = FqCoDelTime (Simulator::Now ());
+  Ptr<QueueDiscItem> item = pool.PopPacket (flow);
+
+  // Determine if the packet should be dropped
+  bool okToDrop = OkToDrop (flow, state, item, now);
+
+  if (state.dropping)
+    {
+      if (!okToDrop)
+        {
+          // sojourn time fell below target - leave dropping state
+          state.dropping = false;
+        }
+      else
+        {
+          while (state.dropping && FqCoDelTimeAfterEq (now, state.dropNext))
+            {
+              // It's time for the next drop. Drop the current packet and
+              // dequeue the next. The dequeue might take us out of dropping
+              // state. If not, schedule the next drop.
+              NS_LOG_LOGIC ("Sojourn time is still above target and it's time for next drop; dropping " << item);
+              m_drop (item);
+
+              ++state.count;
+              NewtonStep (state);
+              if (flow.nPackets == 0)
+                {
+                  state.dropping = false;
+                  return 0;
+                }
+              item = pool.PopPacket (flow);
+
+              if (!OkToDrop (flow, state, item, now))
+                {
+                  // leave dropping state
+                  state.dropping = false;
+                }
+              else
+                {
+                  // schedule the next drop
+                  state.dropNext = ControlLaw (state, state.dropNext);
+                }
+            }
+        }
+    }
+  else if (okToDrop)
+    {
+      // Drop the first packet and enter dropping state unless the queue is empty
+      NS_LOG_LOGIC ("Sojourn time goes above target, dropping the first packet " << item << " and entering the dropping state");
+      m_drop (item);
+
+      if (flow.nPackets == 0)
+        {
+          item = 0;
+          state.dropping = false;
+        }
+      else
+        {
+          item = pool.PopPacket (flow);
+          OkToDrop (flow, state, item, now);
+          state.dropping = true;
+        }
+      // if min went above target close to when we last went below it
+      // assume that the drop rate that controlled the queue on the
+      // last cycle is a good starting point to control it now.
+      int delta = state.count - state.lastCount;
+      if (delta > 1 && FqCoDelTimeBefore (now - state.dropNext, 16 * m_interval))
+        {
+          state.count = delta;
+          NewtonStep (state);
+        }
+      else
+        {
+          state.count = 1;
+          state.recInvSqrt = ~0U >> REC_INV_SQRT_SHIFT;
+        }
+      state.lastCount = state.count;
+      state.dropNext = ControlLaw (state, now);
+    }
+  return item;
+}
+
+} // namespace ns3
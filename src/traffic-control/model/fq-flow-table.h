@@ -0,0 +1,354 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FQ_FLOW_TABLE_H
+#define FQ_FLOW_TABLE_H
+
+#include "ns3/queue-disc.h"
+#include "ns3/nstime.h"
+#include "ns3/callback.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * Index of no flow queue or no packet slot
+ */
+static const uint32_t FQ_FLOW_NONE = 0xffffffff;
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief The FIFO of packets of a flow queue, and its link in a list
+ * of flow queues
+ *
+ * The flow queues of the fair queueing queue discs extend this structure
+ * with their scheduling state.
+ */
+struct FqFlowQueue
+{
+  FqFlowQueue ();
+  uint32_t head;           //!< The slot of the first packet
+  uint32_t tail;           //!< The slot of the last packet
+  uint32_t nPackets;       //!< Number of packets
+  uint32_t nBytes;         //!< Number of bytes
+  uint32_t next;           //!< The next flow queue of the list of new or old flows
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A list of flow queues, linked through their index in the table
+ */
+struct FqFlowList
+{
+  FqFlowList ();
+  uint32_t head;           //!< The index of the first flow queue
+  uint32_t tail;           //!< The index of the last flow queue
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief The packets of the flow queues of a fair queueing queue disc
+ *
+ * The packets of all the flow queues are linked in a pool of slots. The
+ * slots of the dequeued packets are reused, so that no memory is
+ * allocated per packet once the pool has grown to the backlog.
+ */
+class FqPacketPool
+{
+public:
+  FqPacketPool ();
+
+  /**
+   * \brief Append a packet to a flow queue
+   * \param flow the flow queue
+   * \param item the packet
+   * \returns the slot of the packet
+   */
+  uint32_t PushPacket (FqFlowQueue &flow, Ptr<QueueDiscItem> item);
+  /**
+   * \brief Remove the first packet of a non empty flow queue
+   * \param flow the flow queue
+   * \returns the packet
+   */
+  Ptr<QueueDiscItem> PopPacket (FqFlowQueue &flow);
+  /**
+   * \brief Remove a packet from the middle of a flow queue
+   * \param flow the flow queue
+   * \param prev the slot of the previous packet, or FQ_FLOW_NONE for the first packet
+   * \param slot the slot of the packet
+   * \returns the packet
+   */
+  Ptr<QueueDiscItem> RemovePacket (FqFlowQueue &flow, uint32_t prev, uint32_t slot);
+  /**
+   * \param slot the slot of a packet
+   * \returns the packet
+   */
+  Ptr<QueueDiscItem> GetPacket (uint32_t slot) const;
+  /**
+   * \param slot the slot of a packet
+   * \returns the slot of the next packet of the flow queue, or FQ_FLOW_NONE
+   */
+  uint32_t GetNextSlot (uint32_t slot) const;
+  /**
+   * \brief Release all the packets
+   */
+  void Clear (void);
+
+private:
+  /**
+   * A packet of a flow queue
+   */
+  struct PacketSlot
+  {
+    Ptr<QueueDiscItem> item; //!< The packet
+    uint32_t next;           //!< The next packet of the flow queue, or of the free slots
+  };
+
+  std::vector<PacketSlot> m_slots;    //!< The packets of all the flow queues
+  uint32_t m_freeSlot;                //!< The first free slot
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief The flow queues of a fair queueing queue disc
+ *
+ * The flow queues are the entries of a table indexed by the hash of the
+ * packets modulo the number of flows, and the lists of new and old flows
+ * link them through their index. Hence no object is created per flow,
+ * and enqueue and dequeue take constant time.
+ *
+ * \tparam Flow the flow queue, derived from FqFlowQueue
+ */
+template <class Flow>
+class FqFlowTable : public FqPacketPool
+{
+public:
+  /**
+   * \brief Create the flow queues
+   * \param n the number of flow queues
+   * \param flow the initial state of the flow queues
+   */
+  void Assign (uint32_t n, const Flow &flow);
+  /**
+   * \brief Release the flow queues and their packets
+   */
+  void Clear (void);
+  /**
+   * \returns the number of flow queues
+   */
+  uint32_t GetNFlows (void) const;
+  /**
+   * \param index the index of a flow queue
+   * \returns the flow queue
+   */
+  Flow & operator [] (uint32_t index);
+  /**
+   * \param index the index of a flow queue
+   * \returns the flow queue
+   */
+  const Flow & operator [] (uint32_t index) const;
+  /**
+   * \brief Append a flow queue to a list
+   * \param list the list
+   * \param index the index of the flow queue
+   */
+  void PushFlow (FqFlowList &list, uint32_t index);
+  /**
+   * \brief Remove the first flow queue of a non empty list
+   * \param list the list
+   */
+  void PopFlow (FqFlowList &list);
+  /**
+   * \returns the index of the flow queue with the largest byte count
+   */
+  uint32_t GetFatFlow (void) const;
+
+private:
+  std::vector<Flow> m_flows;          //!< The flow queues, indexed by hash
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief The CoDel state of a flow queue
+ */
+struct FqCoDelState
+{
+  FqCoDelState ();
+  uint32_t count;          //!< Number of packets dropped since entering the dropping state
+  uint32_t lastCount;      //!< Count when last leaving the dropping state
+  bool dropping;           //!< Dropping state
+  uint16_t recInvSqrt;     //!< Reciprocal inverse square root of count
+  uint32_t firstAboveTime; //!< Time to declare the sojourn time above target
+  uint32_t dropNext;       //!< Time to drop the next packet
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief The CoDel algorithm run on each flow queue of FqCoDelQueueDisc
+ * and CakeQueueDisc
+ *
+ * The algorithm is the one of CoDelQueueDisc, in CoDel time units, with
+ * its state kept in the flow queue. The packets it drops are passed to
+ * the drop callback, which is the Drop method of the queue disc.
+ */
+class FqCoDelAqm
+{
+public:
+  FqCoDelAqm ();
+
+  /**
+   * \brief Set the parameters of the algorithm
+   * \param interval the interval
+   * \param target the target queue delay
+   * \param minBytes the minimum number of bytes of a flow queue to drop from it
+   */
+  void SetParams (Time interval, Time target, uint32_t minBytes);
+  /**
+   * \param drop the callback dropping a packet
+   */
+  void SetDropCallback (Callback<void, Ptr<QueueItem> > drop);
+  /**
+   * \brief Dequeue a packet from a flow queue
+   * \param pool the packets of the flow queue
+   * \param flow the flow queue
+   * \param state the CoDel state of the flow queue
+   * \returns the packet, or 0 if the flow queue is or becomes empty
+   */
+  Ptr<QueueDiscItem> Dequeue (FqPacketPool &pool, FqFlowQueue &flow, FqCoDelState &state);
+
+private:
+  /**
+   * \brief Check whether a packet dequeued from a flow queue may be dropped
+   * \param flow the flow queue
+   * \param state the CoDel state of the flow queue
+   * \param item the packet
+   * \param now the current time in CoDel time units
+   * \returns true if the sojourn time has been above target for at least an interval
+   */
+  bool OkToDrop (const FqFlowQueue &flow, FqCoDelState &state, Ptr<QueueDiscItem> item, uint32_t now);
+  /**
+   * \brief Update the reciprocal inverse square root of the count
+   * \param state the CoDel state of a flow queue
+   */
+  void NewtonStep (FqCoDelState &state);
+  /**
+   * \brief Compute the time of the next drop
+   * \param state the CoDel state of a flow queue
+   * \param t the time of the current drop, in CoDel time units
+   * \returns the time of the next drop, in CoDel time units
+   */
+  uint32_t ControlLaw (const FqCoDelState &state, uint32_t t) const;
+
+  uint32_t m_interval;       //!< Interval in CoDel time units
+  uint32_t m_target;         //!< Target in CoDel time units
+  uint32_t m_minBytes;       //!< Minimum number of bytes of a flow queue to drop from it
+  Callback<void, Ptr<QueueItem> > m_drop; //!< Drop callback
+};
+
+
+/****************************************************************
+ *  Implementation of the templates declared above.
+ ****************************************************************/
+
+template <class Flow>
+void
+FqFlowTable<Flow>::Assign (uint32_t n, const Flow &flow)
+{
+  m_flows.assign (n, flow);
+}
+
+template <class Flow>
+void
+FqFlowTable<Flow>::Clear (void)
+{
+  m_flows.clear ();
+  FqPacketPool::Clear ();
+}
+
+template <class Flow>
+uint32_t
+FqFlowTable<Flow>::GetNFlows (void) const
+{
+  return m_flows.size ();
+}
+
+template <class Flow>
+Flow &
+FqFlowTable<Flow>::operator [] (uint32_t index)
+{
+  return m_flows[index];
+}
+
+template <class Flow>
+const Flow &
+FqFlowTable<Flow>::operator [] (uint32_t index) const
+{
+  return m_flows[index];
+}
+
+template <class Flow>
+void
+FqFlowTable<Flow>::PushFlow (FqFlowList &list, uint32_t index)
+{
+  m_flows[index].next = FQ_FLOW_NONE;
+  if (list.tail == FQ_FLOW_NONE)
+    {
+      list.head = index;
+    }
+  else
+    {
+      m_flows[list.tail].next = index;
+    }
+  list.tail = index;
+}
+
+template <class Flow>
+void
+FqFlowTable<Flow>::PopFlow (FqFlowList &list)
+{
+  NS_ASSERT (list.head != FQ_FLOW_NONE);
+  list.head = m_flows[list.head].next;
+  if (list.head == FQ_FLOW_NONE)
+    {
+      list.tail = FQ_FLOW_NONE;
+    }
+}
+
+template <class Flow>
+uint32_t
+FqFlowTable<Flow>::GetFatFlow (void) const
+{
+  uint32_t maxBacklog = 0, index = 0;
+  for (uint32_t i = 0; i < m_flows.size (); i++)
+    {
+      if (m_flows[i].nBytes > maxBacklog)
+        {
+          maxBacklog = m_flows[i].nBytes;
+          index = i;
+        }
+    }
+  return index;
+}
+
+} // namespace ns3
+
+#endif /* FQ_FLOW_TABLE_H */
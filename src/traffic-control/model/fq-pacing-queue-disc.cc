@@ -0,0 +1,432 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "fq-pacing-queue-disc.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FqPacingQueueDisc");
+
+FqPacingQueueDisc::Flow::Flow ()
+  : credit (0),
+    status (INACTIVE)
+{
+}
+
+NS_OBJECT_ENSURE_REGISTERED (FqPacingQueueDisc);
+
+TypeId FqPacingQueueDisc::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FqPacingQueueDisc")
+    .SetParent<QueueDisc> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<FqPacingQueueDisc> ()
+    .AddAttribute ("PacketLimit",
+                   "The hard limit on the real queue size, measured in packets",
+                   UintegerValue (10000),
+                   MakeUintegerAccessor (&FqPacingQueueDisc::m_limit),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("FlowLimit",
+                   "The maximum number of packets in a flow queue",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&FqPacingQueueDisc::m_flowLimit),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Quantum",
+                   "The credit given to the flow queues at each round, in bytes",
+                   UintegerValue (2 * 1514),
+                   MakeUintegerAccessor (&FqPacingQueueDisc::m_quantum),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("InitialQuantum",
+                   "The credit of a flow queue used for the first time, in bytes",
+                   UintegerValue (10 * 1514),
+                   MakeUintegerAccessor (&FqPacingQueueDisc::m_initialQuantum),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("MaxRate",
+                   "The maximum pacing rate of each flow, and the pacing rate of the "
+                   "flows whose socket sets none; zero for no limit",
+                   DataRateValue (DataRate (0)),
+                   MakeDataRateAccessor (&FqPacingQueueDisc::m_maxRate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("FlowRefillDelay",
+                   "The idle time after which a flow queue gets at least a quantum of credit",
+                   TimeValue (MilliSeconds (40)),
+                   MakeTimeAccessor (&FqPacingQueueDisc::m_refillDelay),
+                   MakeTimeChecker ())
+    .AddAttribute ("Flows",
+                   "The number of queues into which the incoming packets are classified",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&FqPacingQueueDisc::m_flows),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Perturbation",
+                   "The salt used as an additional input to the hash function of the packets",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&FqPacingQueueDisc::m_perturbation),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+FqPacingQueueDisc::FqPacingQueueDisc ()
+  : m_flowLimitDrops (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+FqPacingQueueDisc::~FqPacingQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FqPacingQueueDisc::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_watchdog.Cancel ();
+  m_flowTable.Clear ();
+  m_throttled.clear ();
+  m_newFlows = FqFlowList ();
+  m_oldFlows = FqFlowList ();
+  QueueDisc::DoDispose ();
+}
+
+uint32_t
+FqPacingQueueDisc::GetFlowIndex (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+  uint32_t hash;
+  if (!ClassifyFlow (item, hash))
+    {
+      return m_flows;
+    }
+  return hash % m_flows;
+}
+
+uint32_t
+FqPacingQueueDisc::GetFlowNPackets (uint32_t index) const
+{
+  NS_ASSERT (index < m_flowTable.GetNFlows ());
+  return m_flowTable[index].nPackets;
+}
+
+FqPacingQueueDisc::FlowStatus
+FqPacingQueueDisc::GetFlowStatus (uint32_t index) const
+{
+  NS_ASSERT (index < m_flowTable.GetNFlows ());
+  return m_flowTable[index].status;
+}
+
+uint32_t
+FqPacingQueueDisc::GetNThrottledFlows (void) const
+{
+  return m_throttled.size ();
+}
+
+uint32_t
+FqPacingQueueDisc::GetFlowLimitDrops (void) const
+{
+  return m_flowLimitDrops;
+}
+
+bool
+FqPacingQueueDisc::ClassifyFlow (Ptr<QueueDiscItem> item, uint32_t &hash)
+{
+  if (GetNPacketFilters () == 0)
+    {
+      hash = item->Hash (m_perturbation);
+      return true;
+    }
+  int32_t ret = Classify (item);
+  if (ret == PacketFilter::PF_NO_MATCH)
+    {
+      return false;
+    }
+  hash = ret;
+  return true;
+}
+
+bool
+FqPacingQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  if (GetNPackets () > m_limit)
+    {
+      NS_LOG_LOGIC ("Queue disc limit exceeded -- dropping packet");
+      Drop (item);
+      return false;
+    }
+
+  uint32_t hash;
+  if (!ClassifyFlow (item, hash))
+    {
+      NS_LOG_ERROR ("No filter has been able to classify this packet, drop it.");
+      Drop (item);
+      return false;
+    }
+
+  uint32_t h = hash % m_flows;
+  Flow &flow = m_flowTable[h];
+
+  if (flow.nPackets >= m_flowLimit)
+    {
+      NS_LOG_LOGIC ("Flow queue " << h << " limit exceeded -- dropping packet");
+      m_flowLimitDrops++;
+      Drop (item);
+      return false;
+    }
+
+  if (flow.status == INACTIVE)
+    {
+      if (Simulator::Now () - flow.age > m_refillDelay)
+        {
+          flow.credit = std::max<int32_t> (flow.credit, m_quantum);
+        }
+      flow.status = NEW_FLOW;
+      m_flowTable.PushFlow (m_newFlows, h);
+    }
+
+  m_flowTable.PushPacket (flow, item);
+
+  NS_LOG_DEBUG ("Packet enqueued into flow " << h);
+
+  return true;
+}
+
+DataRate
+FqPacingQueueDisc::GetPacingRate (Ptr<const QueueDiscItem> item) const
+{
+  SocketPacingRateTag tag;
+  if (!item->GetPacket ()->PeekPacketTag (tag) || tag.GetPacingRate ().GetBitRate () == 0)
+    {
+      return m_maxRate;
+    }
+  if (m_maxRate.GetBitRate () > 0 && m_maxRate < tag.GetPacingRate ())
+    {
+      return m_maxRate;
+    }
+  return tag.GetPacingRate ();
+}
+
+void
+FqPacingQueueDisc::Unthrottle (Time now)
+{
+  ThrottledOrder order;
+  order.table = &m_flowTable;
+  while (!m_throttled.empty () && m_flowTable[m_throttled.front ()].timeNextPacket <= now)
+    {
+      uint32_t index = m_throttled.front ();
+      std::pop_heap (m_throttled.begin (), m_throttled.end (), order);
+      m_throttled.pop_back ();
+
+      NS_LOG_DEBUG ("Flow " << index << " may send again");
+      m_flowTable[index].status = OLD_FLOW;
+      m_flowTable.PushFlow (m_oldFlows, index);
+    }
+}
+
+void
+FqPacingQueueDisc::ArmWatchdog (Time now)
+{
+  Time t = m_flowTable[m_throttled.front ()].timeNextPacket;
+  if (m_watchdog.IsRunning () && m_watchdogTime <= t)
+    {
+      return;
+    }
+  m_watchdog.Cancel ();
+  m_watchdog = Simulator::Schedule (t - now, &FqPacingQueueDisc::Watchdog, this);
+  m_watchdogTime = t;
+}
+
+void
+FqPacingQueueDisc::Watchdog (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (GetNetDevice ())
+    {
+      Run ();
+    }
+}
+
+Ptr<QueueDiscItem>
+FqPacingQueueDisc::DoDequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Time now = Simulator::Now ();
+  Unthrottle (now);
+
+  while (true)
+    {
+      FqFlowList *list = &m_newFlows;
+      if (list->head == FQ_FLOW_NONE)
+        {
+          list = &m_oldFlows;
+        }
+      if (list->head == FQ_FLOW_NONE)
+        {
+          if (!m_throttled.empty ())
+            {
+              ArmWatchdog (now);
+            }
+          NS_LOG_DEBUG ("No flow found to dequeue a packet");
+          return 0;
+        }
+
+      uint32_t index = list->head;
+      Flow &flow = m_flowTable[index];
+
+      if (flow.credit <= 0)
+        {
+          flow.credit += m_quantum;
+          flow.status = OLD_FLOW;
+          m_flowTable.PopFlow (*list);
+          m_flowTable.PushFlow (m_oldFlows, index);
+          continue;
+        }
+
+      if (flow.nPackets > 0 && now < flow.timeNextPacket)
+        {
+          NS_LOG_DEBUG ("Flow " << index << " throttled until " << flow.timeNextPacket);
+          m_flowTable.PopFlow (*list);
+          flow.status = THROTTLED;
+          ThrottledOrder order;
+          order.table = &m_flowTable;
+          m_throttled.push_back (index);
+          std::push_heap (m_throttled.begin (), m_throttled.end (), order);
+          continue;
+        }
+
+      if (flow.nPackets == 0)
+        {
+          m_flowTable.PopFlow (*list);
+          // force a pass through the old flows to prevent their starvation
+          if (list == &m_newFlows && m_oldFlows.head != FQ_FLOW_NONE)
+            {
+              flow.status = OLD_FLOW;
+              m_flowTable.PushFlow (m_oldFlows, index);
+            }
+          else
+            {
+              flow.status = INACTIVE;
+              flow.age = now;
+            }
+          continue;
+        }
+
+      Ptr<QueueDiscItem> item = m_flowTable.PopPacket (flow);
+      flow.credit -= item->GetPacketSize ();
+      DataRate rate = GetPacingRate (item);
+      if (rate.GetBitRate () > 0)
+        {
+          flow.timeNextPacket = now + rate.CalculateBytesTxTime (item->GetPacketSize ());
+        }
+      NS_LOG_DEBUG ("Dequeued packet " << item->GetPacket () << " from flow " << index);
+      return item;
+    }
+}
+
+uint32_t
+FqPacingQueueDisc::FindSendingFlow (uint32_t head, bool withCredit, Time now) const
+{
+  for (uint32_t index = head; index != FQ_FLOW_NONE; index = m_flowTable[index].next)
+    {
+      const Flow &flow = m_flowTable[index];
+      if (flow.nPackets > 0 && flow.timeNextPacket <= now && (!withCredit || flow.credit > 0))
+        {
+          return index;
+        }
+    }
+  return FQ_FLOW_NONE;
+}
+
+Ptr<const QueueDiscItem>
+FqPacingQueueDisc::DoPeek (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  // Look for the flow DoDequeue serves: the first flow which has credit
+  // left among the new flows, the old flows and the throttled flows whose
+  // pacing time has come, or else the first of them once given credit
+  Time now = Simulator::Now ();
+  uint32_t index = FQ_FLOW_NONE;
+  for (uint32_t pass = 0; pass < 2 && index == FQ_FLOW_NONE; pass++)
+    {
+      bool withCredit = (pass == 0);
+      index = FindSendingFlow (m_newFlows.head, withCredit, now);
+      if (index == FQ_FLOW_NONE)
+        {
+          index = FindSendingFlow (m_oldFlows.head, withCredit, now);
+        }
+      if (index != FQ_FLOW_NONE)
+        {
+          break;
+        }
+      // the throttled flows are unthrottled in the order of their pacing time
+      for (uint32_t i = 0; i < m_throttled.size (); i++)
+        {
+          const Flow &flow = m_flowTable[m_throttled[i]];
+          if (flow.nPackets > 0 && flow.timeNextPacket <= now && (!withCredit || flow.credit > 0)
+              && (index == FQ_FLOW_NONE || flow.timeNextPacket < m_flowTable[index].timeNextPacket))
+            {
+              index = m_throttled[i];
+            }
+        }
+    }
+
+  if (index == FQ_FLOW_NONE)
+    {
+      NS_LOG_DEBUG ("No flow may send a packet now");
+      return 0;
+    }
+  return m_flowTable.GetPacket (m_flowTable[index].head);
+}
+
+bool
+FqPacingQueueDisc::CheckConfig (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (GetNQueueDiscClasses () > 0)
+    {
+      NS_LOG_ERROR ("FqPacingQueueDisc cannot have classes");
+      return false;
+    }
+
+  if (GetNInternalQueues () > 0)
+    {
+      NS_LOG_ERROR ("FqPacingQueueDisc cannot have internal queues");
+      return false;
+    }
+
+  return true;
+}
+
+void
+FqPacingQueueDisc::InitializeParams (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Flow flow;
+  flow.credit = m_initialQuantum;
+  m_flowTable.Assign (m_flows, flow);
+  m_throttled.reserve (m_flows);
+}
+
+} // namespace ns3
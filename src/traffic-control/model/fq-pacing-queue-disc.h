@@ -0,0 +1,208 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FQ_PACING_QUEUE_DISC_H
+#define FQ_PACING_QUEUE_DISC_H
+
+#include "ns3/queue-disc.h"
+#include "ns3/nstime.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "fq-flow-table.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A fair queueing packet scheduler with per-flow pacing, modelled
+ * after the Linux fq queue disc
+ *
+ * The packets are classified into flow queues by the packet filters, if
+ * any, or else by the hash of their 5-tuple. The flow queues are served
+ * by a deficit round robin scheduler giving priority to the new flows;
+ * a flow becoming active after being idle for the FlowRefillDelay gets
+ * at least a quantum of credit, and a flow seen for the first time gets
+ * the InitialQuantum. A flow queue holds up to FlowLimit packets.
+ *
+ * Each flow is paced at the pacing rate of its socket, carried by the
+ * SocketPacingRateTag of its packets, capped by the MaxRate; the flows
+ * whose socket sets no pacing rate are paced at the MaxRate, if any.
+ * After a packet is dequeued, the flow may not send before the
+ * transmission time of the packet at this rate. Flows waiting for their
+ * time are kept in a heap ordered by that time, and a single timer,
+ * armed for the earliest of them, restarts the transmission.
+ *
+ * The flow queues are those of FqFlowTable: no memory is allocated per
+ * packet or per flow once the pool of packets has grown to the backlog.
+ */
+class FqPacingQueueDisc : public QueueDisc {
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief FqPacingQueueDisc constructor
+   */
+  FqPacingQueueDisc ();
+
+  virtual ~FqPacingQueueDisc ();
+
+  /**
+   * \enum FlowStatus
+   * \brief Used to determine the status of a flow queue
+   */
+  enum FlowStatus
+    {
+      INACTIVE,
+      NEW_FLOW,
+      OLD_FLOW,
+      THROTTLED
+    };
+
+  /**
+   * \brief Get the flow queue a packet is enqueued into.
+   *
+   * \param item the packet
+   * \returns the index of the flow queue, or the number of flow queues if
+   *          no filter is able to classify the packet
+   */
+  uint32_t GetFlowIndex (Ptr<QueueDiscItem> item);
+
+  /**
+   * \param index the index of a flow queue
+   * \returns the number of packets in the flow queue
+   */
+  uint32_t GetFlowNPackets (uint32_t index) const;
+
+  /**
+   * \param index the index of a flow queue
+   * \returns the status of the flow queue
+   */
+  FlowStatus GetFlowStatus (uint32_t index) const;
+
+  /**
+   * \returns the number of flow queues waiting for their pacing time
+   */
+  uint32_t GetNThrottledFlows (void) const;
+
+  /**
+   * \returns the number of packets dropped because their flow queue was full
+   */
+  uint32_t GetFlowLimitDrops (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
+  virtual Ptr<QueueDiscItem> DoDequeue (void);
+  virtual Ptr<const QueueDiscItem> DoPeek (void) const;
+  virtual bool CheckConfig (void);
+  virtual void InitializeParams (void);
+
+  /**
+   * A flow queue
+   */
+  struct Flow : public FqFlowQueue
+  {
+    Flow ();
+    int32_t credit;          //!< The deficit
+    FlowStatus status;       //!< The status
+    Time timeNextPacket;     //!< The pacing time of the next packet
+    Time age;                //!< The time the flow became inactive
+  };
+
+  /**
+   * Order of the heap of the throttled flows: earliest pacing time first
+   */
+  struct ThrottledOrder
+  {
+    const FqFlowTable<Flow> *table; //!< The flow queues
+    /**
+     * \param a the index of a flow queue
+     * \param b the index of a flow queue
+     * \returns true if a is due after b
+     */
+    bool operator() (uint32_t a, uint32_t b) const
+    {
+      return (*table)[a].timeNextPacket > (*table)[b].timeNextPacket;
+    }
+  };
+
+  /**
+   * \brief Classify a packet
+   * \param item the packet
+   * \param hash the hash of the packet
+   * \returns false if no filter is able to classify the packet
+   */
+  bool ClassifyFlow (Ptr<QueueDiscItem> item, uint32_t &hash);
+  /**
+   * \brief Get the pacing rate of the flow of a packet
+   * \param item the packet
+   * \returns the pacing rate of the socket of the packet, capped by the
+   *          MaxRate, or the MaxRate if the socket sets none
+   */
+  DataRate GetPacingRate (Ptr<const QueueDiscItem> item) const;
+  /**
+   * \brief Find the first flow of a list which may send a packet now
+   * \param head the first flow of the list
+   * \param withCredit whether the flow must have credit left
+   * \param now the current time
+   * \returns the index of the flow, or FQ_FLOW_NONE
+   */
+  uint32_t FindSendingFlow (uint32_t head, bool withCredit, Time now) const;
+  /**
+   * \brief Move the throttled flows whose pacing time has come to the old flows
+   * \param now the current time
+   */
+  void Unthrottle (Time now);
+  /**
+   * \brief Arm the timer for the earliest throttled flow
+   * \param now the current time
+   */
+  void ArmWatchdog (Time now);
+  /**
+   * \brief Restart the transmission when a throttled flow may send
+   */
+  void Watchdog (void);
+
+  uint32_t m_limit;          //!< Maximum number of packets in the queue disc
+  uint32_t m_flowLimit;      //!< Maximum number of packets in a flow queue
+  uint32_t m_quantum;        //!< Credit given to the flows at each round
+  uint32_t m_initialQuantum; //!< Credit of a flow seen for the first time
+  DataRate m_maxRate;        //!< Maximum pacing rate of each flow, or zero for no limit
+  Time m_refillDelay;        //!< Idle time after which a flow gets a quantum of credit
+  uint32_t m_flows;          //!< Number of flow queues
+  uint32_t m_perturbation;   //!< Hash perturbation value
+
+  uint32_t m_flowLimitDrops; //!< Number of packets dropped because their flow queue was full
+
+  EventId m_watchdog;        //!< The timer of the throttled flows
+  Time m_watchdogTime;       //!< The time the timer expires
+
+  FqFlowTable<Flow> m_flowTable;      //!< The flow queues, indexed by hash
+  std::vector<uint32_t> m_throttled;  //!< Heap of the throttled flows
+  FqFlowList m_newFlows;              //!< The list of new flows
+  FqFlowList m_oldFlows;              //!< The list of old flows
+};
+
+} // namespace ns3
+
+#endif /* FQ_PACING_QUEUE_DISC_H */
@@ -25,7 +25,9 @@
 #include "ns3/packet.h"
 #include "ns3/socket.h"
 #include "ns3/unused.h"
+#include "ns3/simulator.h"
 #include "queue-disc.h"
+#include <algorithm>
 
 namespace ns3 {
 
@@ -68,6 +70,18 @@ QueueDiscItem::SetTxQueueIndex (uint8_t txq)
   m_txq = txq;
 }
 
+Time
+QueueDiscItem::GetTimeStamp (void) const
+{
+  return m_tstamp;
+}
+
+void
+QueueDiscItem::SetTimeStamp (Time t)
+{
+  m_tstamp = t;
+}
+
 void
 QueueDiscItem::Print (std::ostream& os) const
 {
@@ -78,6 +92,30 @@ QueueDiscItem::Print (std::ostream& os) const
   ;
 }
 
+uint32_t
+QueueDiscItem::Hash (uint32_t perturbation) const
+{
+  return 0;
+}
+
+bool
+QueueDiscItem::GetHostHashes (uint32_t &src, uint32_t &dst) const
+{
+  return false;
+}
+
+bool
+QueueDiscItem::GetPureTcpAck (uint32_t &ack, std::vector<std::pair<uint32_t, uint32_t> > &sackBlocks) const
+{
+  return false;
+}
+
+bool
+QueueDiscItem::Segment (std::vector<Ptr<QueueDiscItem> > &segments)
+{
+  return false;
+}
+
 
 NS_OBJECT_ENSURE_REGISTERED (QueueDiscClass);
 
@@ -181,6 +219,9 @@ QueueDisc::QueueDisc ()
      m_nTotalDroppedBytes (0),
      m_nTotalRequeuedPackets (0),
      m_nTotalRequeuedBytes (0),
+     m_nTotalDequeueDroppedPackets (0),
+     m_dequeuing (false),
+     m_sojournBinWidth (0),
      m_running (false)
 {
   NS_LOG_FUNCTION (this);
@@ -196,6 +237,7 @@ QueueDisc::DoDispose (void)
   m_device = 0;
   m_devQueueIface = 0;
   m_requeued = 0;
+  m_segments.clear ();
   Object::DoDispose ();
 }
 
@@ -282,6 +324,27 @@ QueueDisc:: GetTotalRequeuedBytes (void) const
   return m_nTotalRequeuedBytes;
 }
 
+uint32_t
+QueueDisc::GetTotalDequeueDroppedPackets (void) const
+{
+  return m_nTotalDequeueDroppedPackets;
+}
+
+void
+QueueDisc::EnableSojournHistogram (Time binWidth, uint32_t nBins)
+{
+  NS_LOG_FUNCTION (this << binWidth << nBins);
+  NS_ASSERT_MSG (nBins == 0 || binWidth.IsStrictlyPositive (), "The bins must have a width");
+  m_sojournBinWidth = binWidth.GetTimeStep ();
+  m_sojournHistogram.assign (nBins, 0);
+}
+
+const std::vector<uint32_t> &
+QueueDisc::GetSojournHistogram (void) const
+{
+  return m_sojournHistogram;
+}
+
 void
 QueueDisc::SetNetDevice (Ptr<NetDevice> device)
 {
@@ -429,6 +492,10 @@ QueueDisc::Drop (Ptr<QueueItem> item)
   m_nBytes -= item->GetPacketSize ();
   m_nTotalDroppedPackets++;
   m_nTotalDroppedBytes += item->GetPacketSize ();
+  if (m_dequeuing)
+    {
+      m_nTotalDequeueDroppedPackets++;
+    }
 
   NS_LOG_LOGIC ("m_traceDrop (p)");
   m_traceDrop (item);
@@ -456,6 +523,7 @@ QueueDisc::Enqueue (Ptr<QueueDiscItem> item)
   m_nBytes += item->GetPacketSize ();
   m_nTotalReceivedPackets++;
   m_nTotalReceivedBytes += item->GetPacketSize ();
+  item->SetTimeStamp (Simulator::Now ());
 
   NS_LOG_LOGIC ("m_traceEnqueue (p)");
   m_traceEnqueue (item);
@@ -469,13 +537,21 @@ QueueDisc::Dequeue (void)
   NS_LOG_FUNCTION (this);
 
   Ptr<QueueDiscItem> item;
+  m_dequeuing = true;
   item = DoDequeue ();
+  m_dequeuing = false;
 
   if (item != 0)
     {
       m_nPackets--;
       m_nBytes -= item->GetPacketSize ();
 
+      if (!m_sojournHistogram.empty ())
+        {
+          uint64_t bin = (Simulator::Now () - item->GetTimeStamp ()).GetTimeStep () / m_sojournBinWidth;
+          m_sojournHistogram[std::min<uint64_t> (bin, m_sojournHistogram.size () - 1)]++;
+        }
+
       NS_LOG_LOGIC ("m_traceDequeue (p)");
       m_traceDequeue (item);
     }
@@ -579,7 +655,24 @@ QueueDisc::DequeuePacket ()
       // is not stopped.
       if (m_devQueueIface->GetNTxQueues ()>1 || !m_devQueueIface->GetTxQueue (0)->IsStopped ())
         {
-          item = Dequeue ();
+          if (!m_segments.empty ())
+            {
+              item = m_segments.front ();
+              m_segments.pop_front ();
+            }
+          else
+            {
+              item = Dequeue ();
+              // Split segmentation offload packets, as Linux does when validating
+              // the packet before the transmission (validate_xmit_skb)
+              std::vector<Ptr<QueueDiscItem> > segments;
+              if (item != 0 && item->Segment (segments))
+                {
+                  NS_LOG_LOGIC ("Packet split in " << segments.size () << " segments");
+                  item = segments.front ();
+                  m_segments.insert (m_segments.end (), segments.begin () + 1, segments.end ());
+                }
+            }
           // If the item is not null, add the header to the packet.
           if (item != 0)
             {
@@ -646,7 +739,8 @@ QueueDisc::Transmit (Ptr<QueueDiscItem> item)
 
   // if the queue disc is empty or the device queue is now stopped, return false so
   // that the Run method does not attempt to dequeue other packets and exits
-  if (GetNPackets () == 0 || m_devQueueIface->GetTxQueue (item->GetTxQueueIndex ())->IsStopped ())
+  if ((GetNPackets () == 0 && m_segments.empty ())
+      || m_devQueueIface->GetTxQueue (item->GetTxQueueIndex ())->IsStopped ())
     {
       return false;
     }
@@ -24,7 +24,9 @@
 #include "ns3/traced-value.h"
 #include <ns3/queue.h>
 #include "ns3/net-device.h"
+#include "ns3/nstime.h"
 #include <vector>
+#include <deque>
 #include "packet-filter.h"
 
 namespace ns3 {
@@ -76,6 +78,18 @@ public:
    */
   void SetTxQueueIndex (uint8_t txq);
 
+  /**
+   * \brief Get the timestamp included in this item
+   * \return the time at which the item was last enqueued in a queue disc.
+   */
+  Time GetTimeStamp (void) const;
+
+  /**
+   * \brief Set the timestamp included in this item
+   * \param t the timestamp to include in this item.
+   */
+  void SetTimeStamp (Time t);
+
   /**
    * \brief Add the header to the packet
    *
@@ -91,6 +105,49 @@ public:
    */
   virtual void Print (std::ostream &os) const;
 
+  /**
+   * \brief Computes the hash of the packet's 5-tuple
+   *
+   * Queue discs isolating the flows use this hash when no packet filter
+   * is configured. Subclasses hash the addresses, the protocol and the
+   * ports of the packet.
+   *
+   * \param perturbation hash perturbation value
+   * \return the hash of the packet's 5-tuple, or 0 if the packet has none
+   */
+  virtual uint32_t Hash (uint32_t perturbation = 0) const;
+
+  /**
+   * \brief Computes the hashes of the source and destination addresses
+   * \param src the hash of the source address
+   * \param dst the hash of the destination address
+   * \return false if the packet has no addresses
+   */
+  virtual bool GetHostHashes (uint32_t &src, uint32_t &dst) const;
+
+  /**
+   * \brief Check whether the packet is a pure TCP acknowledgment
+   * \param ack the acknowledgment number
+   * \param sackBlocks the left and right edges of the SACK blocks, if any
+   * \return true if the packet is a TCP segment with the ACK flag only, no
+   *         payload and no option other than SACK and timestamps
+   */
+  virtual bool GetPureTcpAck (uint32_t &ack, std::vector<std::pair<uint32_t, uint32_t> > &sackBlocks) const;
+
+  /**
+   * \brief Split a segmentation offload packet in the segments to transmit
+   *
+   * Modelled after the Linux function skb_gso_segment (net/core/dev.c). A
+   * transport protocol may send a packet carrying several segments with a
+   * single header down the stack. It is queued as one packet and split just
+   * before being handed to the device. The segments do not carry their
+   * header yet, AddHeader must be called on each of them.
+   *
+   * \param segments the segments, appended if the packet is split
+   * \return true if the packet has been split
+   */
+  virtual bool Segment (std::vector<Ptr<QueueDiscItem> > &segments);
+
 private:
   /**
    * \brief Default constructor
@@ -115,6 +172,7 @@ private:
   Address m_address;      //!< MAC destination address
   uint16_t m_protocol;    //!< L3 Protocol number
   uint8_t m_txq;          //!< Transmission queue index
+  Time m_tstamp;          //!< Time at which the item was enqueued
 };
 
 
@@ -262,6 +320,14 @@ public:
    */
   uint32_t GetTotalDroppedBytes (void) const;
 
+  /**
+   * \brief Get the total number of packets dropped while dequeuing
+   * \return the number of packets dropped by DoDequeue, e.g., by an AQM
+   * dropping the packets at the head of the queue. The other drops happen
+   * when the packets are enqueued.
+   */
+  uint32_t GetTotalDequeueDroppedPackets (void) const;
+
   /**
    * \brief Get the total number of requeued packets
    * \return the total number of requeued packets.
@@ -274,6 +340,23 @@ public:
    */
   uint32_t GetTotalRequeuedBytes (void) const;
 
+  /**
+   * \brief Count the sojourn times of the dequeued packets in a histogram
+   * \param binWidth the width of the bins
+   * \param nBins the number of bins; the last one also counts the longer
+   *        sojourn times. Zero stops counting.
+   *
+   * The counts are reset.
+   */
+  void EnableSojournHistogram (Time binWidth, uint32_t nBins);
+
+  /**
+   * \brief Get the sojourn time histogram
+   * \return the number of packets dequeued since EnableSojournHistogram in
+   * each bin of sojourn time; empty if not enabled.
+   */
+  const std::vector<uint32_t> &GetSojournHistogram (void) const;
+
   /**
    * \brief Set the NetDevice on which this queue discipline is installed.
    * \param device the NetDevice on which this queue discipline is installed.
@@ -511,7 +594,10 @@ private:
 
   /**
    * Modelled after the Linux function dequeue_skb (net/sched/sch_generic.c)
-   * \return the requeued packet, if any, or the packet dequeued by the queue disc, otherwise.
+   * A segmentation offload packet dequeued by the queue disc is split here
+   * (see QueueDiscItem::Segment) and its segments are returned one at a time.
+   * \return the requeued packet, if any, the next segment of a split packet, if
+   *         any, or the packet dequeued by the queue disc, otherwise.
    */
   Ptr<QueueDiscItem> DequeuePacket (void);
 
@@ -546,11 +632,16 @@ private:
   uint32_t m_nTotalDroppedBytes;    //!< Total dropped bytes
   uint32_t m_nTotalRequeuedPackets; //!< Total requeued packets
   uint32_t m_nTotalRequeuedBytes;   //!< Total requeued bytes
+  uint32_t m_nTotalDequeueDroppedPackets; //!< Total packets dropped while dequeuing
+  bool m_dequeuing;                 //!< DoDequeue is running
+  int64_t m_sojournBinWidth;        //!< Width of the sojourn time bins, in time steps
+  std::vector<uint32_t> m_sojournHistogram; //!< Dequeued packets per sojourn time bin
   uint32_t m_quota;                 //!< Maximum number of packets dequeued in a qdisc run
   Ptr<NetDevice> m_device;          //!< The NetDevice on which this queue discipline is installed
   Ptr<NetDeviceQueueInterface> m_devQueueIface;   //!< NetDevice queue interface
   bool m_running;                   //!< The queue disc is performing multiple dequeue operations
   Ptr<QueueDiscItem> m_requeued;    //!< The last packet that failed to be transmitted
+  std::deque<Ptr<QueueDiscItem> > m_segments; //!< Segments of a dequeued offload packet still to transmit
   ParentDropCallback m_parentDropCallback;   //!< Parent drop callback
 
   /// Traced callback: fired when a packet is enqueued
@@ -20,9 +20,13 @@
 #include "traffic-control-layer.h"
 #include "ns3/log.h"
 #include "ns3/object-map.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
 #include "ns3/packet.h"
+#include "ns3/packet-burst.h"
 #include "ns3/socket.h"
 #include "ns3/queue-disc.h"
+#include <algorithm>
 
 namespace ns3 {
 
@@ -42,6 +46,25 @@ TrafficControlLayer::GetTypeId (void)
                    MakeObjectMapAccessor (&TrafficControlLayer::GetNDevices,
                                           &TrafficControlLayer::GetRootQueueDiscOnDeviceByIndex),
                    MakeObjectMapChecker<QueueDisc> ())
+    .AddAttribute ("SamplingInterval", "The interval between two samples of the root queue discs. "
+                   "Zero disables the sampling.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&TrafficControlLayer::SetSamplingInterval,
+                                     &TrafficControlLayer::GetSamplingInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("SamplingBufferSize", "The number of samples stored for each device.",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&TrafficControlLayer::m_samplingBufferSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("SojournBinWidth", "The width of the bins of the sampled sojourn time histograms.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&TrafficControlLayer::m_sojournBinWidth),
+                   MakeTimeChecker (TimeStep (1)))
+    .AddAttribute ("SojournBins", "The number of bins of the sampled sojourn time histograms; "
+                   "the last one also counts the longer sojourn times.",
+                   UintegerValue (10),
+                   MakeUintegerAccessor (&TrafficControlLayer::m_sojournBins),
+                   MakeUintegerChecker<uint32_t> (1))
   ;
   return tid;
 }
@@ -62,6 +85,9 @@ void
 TrafficControlLayer::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  ExportSamples ();
+  Simulator::Cancel (m_samplingEvent);
+  m_samplingStream = 0;
   m_node = 0;
   m_handlers.clear ();
   m_netDevices.clear ();
@@ -103,8 +129,17 @@ TrafficControlLayer::DoInitialize (void)
 
           // initialize the queue disc
           ndi->second.rootQueueDisc->Initialize ();
+
+          if (m_samplingInterval.IsStrictlyPositive ())
+            {
+              StartSampling (ndi->second);
+            }
         }
     }
+  if (m_samplingInterval.IsStrictlyPositive ())
+    {
+      m_samplingEvent = Simulator::Schedule (m_samplingInterval, &TrafficControlLayer::Sample, this);
+    }
   Object::DoInitialize ();
 }
 
@@ -140,7 +175,8 @@ TrafficControlLayer::SetupDevice (Ptr<NetDevice> device)
   NS_ASSERT_MSG (m_netDevices.find (device) == m_netDevices.end (), "This is a bug,"
                  << "  SetupDevice only can insert an entry in the m_netDevices map");
 
-  NetDeviceInfo entry = {0, devQueueIface, QueueDiscVector (), cb};
+  NetDeviceInfo entry = {0, devQueueIface, QueueDiscVector (), cb,
+                         std::vector<QueueDiscSample> (), 0, 0, 0, 0, std::vector<uint32_t> ()};
   m_netDevices[device] = entry;
 }
 
@@ -162,6 +198,16 @@ TrafficControlLayer::RegisterProtocolHandler (Node::ProtocolHandler handler,
                 protocolType << ".");
 }
 
+void
+TrafficControlLayer::RegisterProtocolHandler (Node::ProtocolHandler handler,
+                                              Node::BurstProtocolHandler burstHandler,
+                                              uint16_t protocolType, Ptr<NetDevice> device)
+{
+  NS_LOG_FUNCTION (this << protocolType << device);
+  RegisterProtocolHandler (handler, protocolType, device);
+  m_handlers.back ().burstHandler = burstHandler;
+}
+
 void
 TrafficControlLayer::SetRootQueueDiscOnDevice (Ptr<NetDevice> device, Ptr<QueueDisc> qDisc)
 {
@@ -183,6 +229,11 @@ TrafficControlLayer::SetRootQueueDiscOnDevice (Ptr<NetDevice> device, Ptr<QueueD
   NS_ASSERT_MSG (ndi->second.rootQueueDisc == 0, "Cannot install a root queue disc on a "
                   << "device already having one. Delete the existing queue disc first.");
   ndi->second.rootQueueDisc = qDisc;
+
+  if (IsInitialized () && m_samplingInterval.IsStrictlyPositive ())
+    {
+      StartSampling (ndi->second);
+    }
 }
 
 Ptr<QueueDisc>
@@ -217,6 +268,8 @@ TrafficControlLayer::DeleteRootQueueDiscOnDevice (Ptr<NetDevice> device)
                  << " installed on device " << device);
 
   // remove the root queue disc
+  WriteSamples (ndi->second);
+  ndi->second.samples.clear ();
   ndi->second.rootQueueDisc = 0;
   ndi->second.queueDiscsToWake.clear ();
 }
@@ -251,6 +304,189 @@ TrafficControlLayer::GetNDevices (void) const
   return m_node->GetNDevices ();
 }
 
+void
+TrafficControlLayer::SetSamplingInterval (Time interval)
+{
+  NS_LOG_FUNCTION (this << interval);
+  m_samplingInterval = interval;
+  Simulator::Cancel (m_samplingEvent);
+  // otherwise, the sampling starts with the simulation
+  if (IsInitialized () && m_samplingInterval.IsStrictlyPositive ())
+    {
+      std::map<Ptr<NetDevice>, NetDeviceInfo>::iterator ndi;
+      for (ndi = m_netDevices.begin (); ndi != m_netDevices.end (); ndi++)
+        {
+          if (ndi->second.rootQueueDisc && ndi->second.samples.empty ())
+            {
+              StartSampling (ndi->second);
+            }
+        }
+      m_samplingEvent = Simulator::Schedule (m_samplingInterval, &TrafficControlLayer::Sample, this);
+    }
+}
+
+Time
+TrafficControlLayer::GetSamplingInterval (void) const
+{
+  return m_samplingInterval;
+}
+
+void
+TrafficControlLayer::SetSamplingStream (Ptr<OutputStreamWrapper> stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_samplingStream = stream;
+}
+
+void
+TrafficControlLayer::StartSampling (NetDeviceInfo &info)
+{
+  NS_LOG_FUNCTION (this);
+  QueueDiscSample sample;
+  sample.sojournHistogram.resize (m_sojournBins);
+  info.samples.assign (m_samplingBufferSize, sample);
+  info.firstSample = 0;
+  info.nSamples = 0;
+  info.lastDropped = info.rootQueueDisc->GetTotalDroppedPackets ();
+  info.lastDequeueDropped = info.rootQueueDisc->GetTotalDequeueDroppedPackets ();
+  info.lastSojourn.assign (m_sojournBins, 0);
+  info.rootQueueDisc->EnableSojournHistogram (m_sojournBinWidth, m_sojournBins);
+}
+
+void
+TrafficControlLayer::Sample (void)
+{
+  NS_LOG_FUNCTION (this);
+  // in the order of the devices, for the sake of the output
+  for (uint32_t i = 0; i < m_node->GetNDevices (); i++)
+    {
+      std::map<Ptr<NetDevice>, NetDeviceInfo>::iterator ndi = m_netDevices.find (m_node->GetDevice (i));
+      if (ndi == m_netDevices.end () || !ndi->second.rootQueueDisc)
+        {
+          continue;
+        }
+      NetDeviceInfo &info = ndi->second;
+      if (info.samples.empty ())
+        {
+          StartSampling (info);
+        }
+      Ptr<QueueDisc> qd = info.rootQueueDisc;
+
+      uint32_t size = info.samples.size ();
+      if (info.nSamples == size)
+        {
+          if (m_samplingStream)
+            {
+              WriteSamples (info);
+            }
+          else
+            {
+              // overwrite the oldest sample
+              info.firstSample = (info.firstSample + 1) % size;
+              info.nSamples--;
+            }
+        }
+      QueueDiscSample &sample = info.samples[(info.firstSample + info.nSamples) % size];
+      info.nSamples++;
+
+      sample.time = Simulator::Now ();
+      sample.device = i;
+      sample.packets = qd->GetNPackets ();
+      sample.bytes = qd->GetNBytes ();
+      uint32_t dropped = qd->GetTotalDroppedPackets ();
+      uint32_t dequeueDropped = qd->GetTotalDequeueDroppedPackets ();
+      sample.dequeueDrops = dequeueDropped - info.lastDequeueDropped;
+      sample.enqueueDrops = dropped - info.lastDropped - sample.dequeueDrops;
+      info.lastDropped = dropped;
+      info.lastDequeueDropped = dequeueDropped;
+      const std::vector<uint32_t> &sojourn = qd->GetSojournHistogram ();
+      for (uint32_t b = 0; b < sojourn.size (); b++)
+        {
+          sample.sojournHistogram[b] = sojourn[b] - info.lastSojourn[b];
+          info.lastSojourn[b] = sojourn[b];
+        }
+    }
+  m_samplingEvent = Simulator::Schedule (m_samplingInterval, &TrafficControlLayer::Sample, this);
+}
+
+void
+TrafficControlLayer::WriteSamples (NetDeviceInfo &info)
+{
+  if (!m_samplingStream || info.nSamples == 0)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << info.nSamples);
+  std::ostream *os = m_samplingStream->GetStream ();
+  if (os->tellp () == 0)
+    {
+      *os << "time,node,device,packets,bytes,enqueueDrops,dequeueDrops";
+      for (uint32_t b = 0; b < m_sojournBins; b++)
+        {
+          *os << ",sojourn" << b;
+        }
+      *os << "\n";
+    }
+  uint32_t size = info.samples.size ();
+  for (uint32_t i = 0; i < info.nSamples; i++)
+    {
+      const QueueDiscSample &sample = info.samples[(info.firstSample + i) % size];
+      *os << sample.time.GetNanoSeconds () << ',' << m_node->GetId () << ',' << sample.device
+          << ',' << sample.packets << ',' << sample.bytes
+          << ',' << sample.enqueueDrops << ',' << sample.dequeueDrops;
+      for (uint32_t b = 0; b < sample.sojournHistogram.size (); b++)
+        {
+          *os << ',' << sample.sojournHistogram[b];
+        }
+      *os << '\n';
+    }
+  info.firstSample = 0;
+  info.nSamples = 0;
+}
+
+void
+TrafficControlLayer::ExportSamples (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_samplingStream)
+    {
+      return;
+    }
+  // in the order of the devices, which may have been disposed already
+  std::vector<std::pair<uint32_t, NetDeviceInfo *> > sampled;
+  std::map<Ptr<NetDevice>, NetDeviceInfo>::iterator ndi;
+  for (ndi = m_netDevices.begin (); ndi != m_netDevices.end (); ndi++)
+    {
+      NetDeviceInfo &info = ndi->second;
+      if (info.nSamples > 0)
+        {
+          sampled.push_back (std::make_pair (info.samples[info.firstSample].device, &info));
+        }
+    }
+  std::sort (sampled.begin (), sampled.end ());
+  for (uint32_t i = 0; i < sampled.size (); i++)
+    {
+      WriteSamples (*sampled[i].second);
+    }
+  m_samplingStream->GetStream ()->flush ();
+}
+
+std::vector<TrafficControlLayer::QueueDiscSample>
+TrafficControlLayer::GetSamples (Ptr<NetDevice> device) const
+{
+  std::vector<QueueDiscSample> samples;
+  std::map<Ptr<NetDevice>, NetDeviceInfo>::const_iterator ndi = m_netDevices.find (device);
+  if (ndi != m_netDevices.end ())
+    {
+      const NetDeviceInfo &info = ndi->second;
+      for (uint32_t i = 0; i < info.nSamples; i++)
+        {
+          samples.push_back (info.samples[(info.firstSample + i) % info.samples.size ()]);
+        }
+    }
+  return samples;
+}
+
 
 void
 TrafficControlLayer::Receive (Ptr<NetDevice> device, Ptr<const Packet> p,
@@ -286,6 +522,47 @@ TrafficControlLayer::Receive (Ptr<NetDevice> device, Ptr<const Packet> p,
     }
 }
 
+void
+TrafficControlLayer::ReceiveBurst (Ptr<NetDevice> device, Ptr<const PacketBurst> burst,
+                                   uint16_t protocol, const Address &from, const Address &to,
+                                   NetDevice::PacketType packetType)
+{
+  NS_LOG_FUNCTION (this << device << burst << protocol << from << to << packetType);
+
+  bool found = false;
+
+  for (ProtocolHandlerList::iterator i = m_handlers.begin ();
+       i != m_handlers.end (); i++)
+    {
+      if ((i->device == 0 || i->device == device)
+          && (i->protocol == 0 || i->protocol == protocol))
+        {
+          NS_LOG_DEBUG ("Found handler for burst " << burst << ", protocol " <<
+                        protocol << " and NetDevice " << device <<
+                        ". Send packets up");
+          if (!i->burstHandler.IsNull ())
+            {
+              i->burstHandler (device, burst, protocol, from, to, packetType);
+            }
+          else
+            {
+              for (std::list<Ptr<Packet> >::const_iterator p = burst->Begin ();
+                   p != burst->End (); ++p)
+                {
+                  i->handler (device, *p, protocol, from, to, packetType);
+                }
+            }
+          found = true;
+        }
+    }
+
+  if (! found)
+    {
+      NS_FATAL_ERROR ("Handler for protocol " << protocol << " and device " << device <<
+                      " not found. It isn't forwarded up; it dies here.");
+    }
+}
+
 void
 TrafficControlLayer::Send (Ptr<NetDevice> device, Ptr<QueueDiscItem> item)
 {
@@ -320,17 +597,25 @@ TrafficControlLayer::Send (Ptr<NetDevice> device, Ptr<QueueDiscItem> item)
   if (ndi->second.rootQueueDisc == 0)
     {
       // The device has no attached queue disc, thus add the header to the packet and
-      // send it directly to the device if the selected queue is not stopped
-      if (!devQueueIface->GetTxQueue (txq)->IsStopped ())
+      // send it directly to the device if the selected queue is not stopped.
+      // A segmentation offload packet is split first, and its segments are sent
+      // as long as the queue is not stopped
+      std::vector<Ptr<QueueDiscItem> > segments;
+      if (!item->Segment (segments))
+        {
+          segments.push_back (item);
+        }
+      for (std::vector<Ptr<QueueDiscItem> >::iterator it = segments.begin ();
+           it != segments.end () && !devQueueIface->GetTxQueue (txq)->IsStopped (); it++)
         {
-          item->AddHeader ();
+          (*it)->AddHeader ();
           // a single queue device makes no use of the priority tag
           if (devQueueIface->GetNTxQueues () == 1)
             {
               SocketPriorityTag priorityTag;
-              item->GetPacket ()->RemovePacketTag (priorityTag);
+              (*it)->GetPacket ()->RemovePacketTag (priorityTag);
             }
-          device->Send (item->GetPacket (), item->GetAddress (), item->GetProtocol ());
+          device->Send ((*it)->GetPacket (), (*it)->GetAddress (), (*it)->GetProtocol ());
         }
     }
   else
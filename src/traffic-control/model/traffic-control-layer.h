@@ -23,6 +23,8 @@
 #include "ns3/address.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
+#include "ns3/event-id.h"
+#include "ns3/output-stream-wrapper.h"
 #include "queue-disc.h"
 #include <map>
 #include <vector>
@@ -30,6 +32,7 @@
 namespace ns3 {
 
 class Packet;
+class PacketBurst;
 class QueueDiscItem;
 
 /**
@@ -84,6 +87,15 @@ class QueueDiscItem;
  * Discrimination through callbacks (in other words: what is the right upper-layer
  * callback for this packet?) is done through checks over the device and the
  * protocol number.
+ *
+ * When the SamplingInterval attribute is set, the root queue discs are sampled
+ * at that interval, without any trace sink: the occupancy of each queue disc,
+ * the drops and the histogram of the sojourn times of the packets dequeued
+ * since the previous sample are stored in a ring buffer of SamplingBufferSize
+ * samples per device, allocated once. The samples can be read with GetSamples.
+ * If a sampling stream is set, they are also written to it in bulk, each time
+ * a ring buffer is full, and when the layer is disposed; otherwise the oldest
+ * samples are overwritten. The stream may be shared by all the nodes.
  */
 class TrafficControlLayer : public Object
 {
@@ -126,6 +138,24 @@ public:
                                 uint16_t protocolType,
                                 Ptr<NetDevice> device);
 
+  /**
+   * \brief Register an upper-layer protocol handler which also processes
+   *        bursts of packets
+   *
+   * \param handler the handler to register
+   * \param burstHandler the handler to invoke instead of handler when a
+   *        burst of packets is received at once
+   * \param protocolType the type of protocol this handler is
+   *        interested in (see above)
+   * \param device the device attached to this handler. If the
+   *        value is zero, the handler is attached to all
+   *        devices.
+   */
+  void RegisterProtocolHandler (Node::ProtocolHandler handler,
+                                Node::BurstProtocolHandler burstHandler,
+                                uint16_t protocolType,
+                                Ptr<NetDevice> device);
+
   /// Typedef for queue disc vector
   typedef std::vector<Ptr<QueueDisc> > QueueDiscVector;
 
@@ -184,6 +214,22 @@ public:
   virtual void Receive (Ptr<NetDevice> device, Ptr<const Packet> p,
                         uint16_t protocol, const Address &from,
                         const Address &to, NetDevice::PacketType packetType);
+  /**
+   * \brief Called by NetDevices, burst of incoming packets
+   *
+   * The burst is passed to the burst handler of the upper layers, or packet
+   * by packet to the handlers which do not process bursts.
+   *
+   * \param device network device
+   * \param burst the packets, in order of arrival
+   * \param protocol next header value shared by all the packets
+   * \param from address of the correspondant
+   * \param to address of the destination
+   * \param packetType type of the packets
+   */
+  virtual void ReceiveBurst (Ptr<NetDevice> device, Ptr<const PacketBurst> burst,
+                             uint16_t protocol, const Address &from,
+                             const Address &to, NetDevice::PacketType packetType);
   /**
    * \brief Called from upper layer to queue a packet for the transmission.
    *
@@ -195,6 +241,45 @@ public:
   /// Callback invoked to determine the tx queue selected for a given packet
   typedef Callback< uint8_t, Ptr<QueueItem> > SelectQueueCallback;
 
+  /**
+   * \brief A sample of a root queue disc
+   */
+  struct QueueDiscSample
+  {
+    Time time;             //!< time of the sample
+    uint32_t device;       //!< index of the device on the node
+    uint32_t packets;      //!< packets in the queue disc
+    uint32_t bytes;        //!< bytes in the queue disc
+    uint32_t enqueueDrops; //!< packets dropped while enqueuing since the previous sample
+    uint32_t dequeueDrops; //!< packets dropped while dequeuing since the previous sample
+    /// packets dequeued since the previous sample, per bin of sojourn time
+    std::vector<uint32_t> sojournHistogram;
+  };
+
+  /**
+   * \brief Get the samples stored for a device
+   * \param device the device
+   * \return the samples of the root queue disc of the device which are not
+   *         written yet, oldest first
+   */
+  std::vector<QueueDiscSample> GetSamples (Ptr<NetDevice> device) const;
+
+  /**
+   * \brief Set the stream the samples are written to
+   * \param stream the stream, or 0 to keep the samples in the ring buffers
+   *
+   * The samples are written as comma separated values: time (in nanoseconds),
+   * node id, device index, packets, bytes, enqueue drops, dequeue drops, then
+   * the SojournBins counts of the sojourn time histogram. A header line is
+   * written first if the stream is empty.
+   */
+  void SetSamplingStream (Ptr<OutputStreamWrapper> stream);
+
+  /**
+   * \brief Write the stored samples of all the devices to the sampling stream
+   */
+  void ExportSamples (void);
+
 protected:
 
   virtual void DoDispose (void);
@@ -218,6 +303,7 @@ private:
    */
   struct ProtocolHandlerEntry {
     Node::ProtocolHandler handler; //!< the protocol handler
+    Node::BurstProtocolHandler burstHandler; //!< the burst handler, if any
     Ptr<NetDevice> device;         //!< the NetDevice
     uint16_t protocol;             //!< the protocol number
     bool promiscuous;              //!< true if it is a promiscuous handler
@@ -231,6 +317,12 @@ private:
     Ptr<NetDeviceQueueInterface> ndqi;  //!< the netdevice queue interface
     QueueDiscVector queueDiscsToWake;   //!< the vector of queue discs to wake
     SelectQueueCallback selectQueueCallback;  //!< the select queue callback
+    std::vector<QueueDiscSample> samples;  //!< ring buffer of samples
+    uint32_t firstSample;               //!< oldest sample in the ring buffer
+    uint32_t nSamples;                  //!< number of samples in the ring buffer
+    uint32_t lastDropped;               //!< dropped packets at the previous sample
+    uint32_t lastDequeueDropped;        //!< dequeue drops at the previous sample
+    std::vector<uint32_t> lastSojourn;  //!< sojourn histogram at the previous sample
   };
 
   /// Typedef for protocol handlers container
@@ -248,11 +340,45 @@ private:
    */
   Ptr<QueueDisc> GetRootQueueDiscOnDeviceByIndex (uint32_t index) const;
 
+  /**
+   * \brief Set the sampling interval, and schedule the next sample
+   * \param interval the interval, zero to stop sampling
+   */
+  void SetSamplingInterval (Time interval);
+  /**
+   * \brief Get the sampling interval
+   * \return the sampling interval
+   */
+  Time GetSamplingInterval (void) const;
+  /**
+   * \brief Allocate the ring buffer of a device, and start counting the
+   *        sojourn times in its root queue disc
+   * \param info the information of the device
+   */
+  void StartSampling (NetDeviceInfo &info);
+  /**
+   * \brief Sample the root queue discs, and schedule the next sample
+   */
+  void Sample (void);
+  /**
+   * \brief Write the stored samples of a device to the sampling stream,
+   *        and empty its ring buffer
+   * \param info the information of the device
+   */
+  void WriteSamples (NetDeviceInfo &info);
+
   /// The node this TrafficControlLayer object is aggregated to
   Ptr<Node> m_node;
   /// Map storing the required information for each device with a queue disc installed
   std::map<Ptr<NetDevice>, NetDeviceInfo> m_netDevices;
   ProtocolHandlerList m_handlers;  //!< List of upper-layer handlers
+
+  Time m_samplingInterval;         //!< Interval between two samples, zero if disabled
+  uint32_t m_samplingBufferSize;   //!< Number of samples stored per device
+  Time m_sojournBinWidth;          //!< Width of the sojourn time bins
+  uint32_t m_sojournBins;          //!< Number of sojourn time bins
+  EventId m_samplingEvent;         //!< Next sample
+  Ptr<OutputStreamWrapper> m_samplingStream; //!< Stream the samples are written to
 };
 
 } // namespace ns3
@@ -0,0 +1,392 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/cake-queue-disc.h"
+#include "ns3/uinteger.h"
+#include "ns3/integer.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/data-rate.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/*
+ * A queue disc item with a given flow hash, host hashes and, optionally,
+ * a pure TCP acknowledgment number and SACK blocks.
+ */
+class CakeQueueDiscTestItem : public QueueDiscItem {
+public:
+  CakeQueueDiscTestItem (Ptr<Packet> p, uint32_t hash, uint32_t src, uint32_t dst);
+  virtual ~CakeQueueDiscTestItem ();
+  virtual void AddHeader (void);
+  virtual uint32_t Hash (uint32_t perturbation) const;
+  virtual bool GetHostHashes (uint32_t &src, uint32_t &dst) const;
+  virtual bool GetPureTcpAck (uint32_t &ack, std::vector<std::pair<uint32_t, uint32_t> > &sackBlocks) const;
+  void SetPureTcpAck (uint32_t ack);
+  void AddSackBlock (uint32_t left, uint32_t right);
+
+private:
+  CakeQueueDiscTestItem ();
+  CakeQueueDiscTestItem (const CakeQueueDiscTestItem &);
+  CakeQueueDiscTestItem &operator = (const CakeQueueDiscTestItem &);
+  uint32_t m_hash;
+  uint32_t m_src;
+  uint32_t m_dst;
+  bool m_pureAck;
+  uint32_t m_ack;
+  std::vector<std::pair<uint32_t, uint32_t> > m_sackBlocks;
+};
+
+CakeQueueDiscTestItem::CakeQueueDiscTestItem (Ptr<Packet> p, uint32_t hash, uint32_t src, uint32_t dst)
+  : QueueDiscItem (p, Address (), 0),
+    m_hash (hash),
+    m_src (src),
+    m_dst (dst),
+    m_pureAck (false),
+    m_ack (0)
+{
+}
+
+CakeQueueDiscTestItem::~CakeQueueDiscTestItem ()
+{
+}
+
+void
+CakeQueueDiscTestItem::AddHeader (void)
+{
+}
+
+uint32_t
+CakeQueueDiscTestItem::Hash (uint32_t perturbation) const
+{
+  return m_hash;
+}
+
+bool
+CakeQueueDiscTestItem::GetHostHashes (uint32_t &src, uint32_t &dst) const
+{
+  src = m_src;
+  dst = m_dst;
+  return true;
+}
+
+bool
+CakeQueueDiscTestItem::GetPureTcpAck (uint32_t &ack, std::vector<std::pair<uint32_t, uint32_t> > &sackBlocks) const
+{
+  ack = m_ack;
+  sackBlocks = m_sackBlocks;
+  return m_pureAck;
+}
+
+void
+CakeQueueDiscTestItem::SetPureTcpAck (uint32_t ack)
+{
+  m_pureAck = true;
+  m_ack = ack;
+}
+
+void
+CakeQueueDiscTestItem::AddSackBlock (uint32_t left, uint32_t right)
+{
+  m_sackBlocks.push_back (std::make_pair (left, right));
+}
+
+// Test 1: the shaper releases the packets at the configured bandwidth
+class CakeQueueDiscShaper : public TestCase
+{
+public:
+  CakeQueueDiscShaper ();
+
+private:
+  virtual void DoRun (void);
+  void CheckDequeue (Ptr<CakeQueueDisc> queue, bool expected, std::string error);
+};
+
+CakeQueueDiscShaper::CakeQueueDiscShaper ()
+  : TestCase ("Test the shaper of CakeQueueDisc")
+{
+}
+
+void
+CakeQueueDiscShaper::CheckDequeue (Ptr<CakeQueueDisc> queue, bool expected, std::string error)
+{
+  Ptr<QueueDiscItem> item = queue->Dequeue ();
+  NS_TEST_EXPECT_MSG_EQ ((item != 0), expected, error);
+}
+
+void
+CakeQueueDiscShaper::DoRun (void)
+{
+  // 1000 bytes plus 250 bytes of overhead take 1 ms at 10 Mbps
+  Ptr<CakeQueueDisc> queue = CreateObject<CakeQueueDisc> ();
+  queue->SetAttribute ("Bandwidth", DataRateValue (DataRate ("10Mbps")));
+  queue->SetAttribute ("Overhead", IntegerValue (250));
+  queue->Initialize ();
+
+  Ptr<Packet> p = Create<Packet> (1000);
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      queue->Enqueue (Create<CakeQueueDiscTestItem> (p, 1, 1, 2));
+    }
+
+  Simulator::Schedule (Seconds (0), &CakeQueueDiscShaper::CheckDequeue, this, queue, true,
+                       "The first packet should be released at once");
+  Simulator::Schedule (MicroSeconds (500), &CakeQueueDiscShaper::CheckDequeue, this, queue, false,
+                       "The second packet should be held by the shaper");
+  Simulator::Schedule (MicroSeconds (1000), &CakeQueueDiscShaper::CheckDequeue, this, queue, true,
+                       "The second packet should be released after 1 ms");
+  Simulator::Schedule (MicroSeconds (1999), &CakeQueueDiscShaper::CheckDequeue, this, queue, false,
+                       "The third packet should be held by the shaper");
+  Simulator::Schedule (MicroSeconds (2000), &CakeQueueDiscShaper::CheckDequeue, this, queue, true,
+                       "The third packet should be released after 2 ms");
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 0, "All the packets should have been dequeued");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedPackets (), 0, "No packet should have been dropped");
+  Simulator::Destroy ();
+}
+
+// Test 2: the hosts share the link whatever the number of their flows
+class CakeQueueDiscHostIsolation : public TestCase
+{
+public:
+  CakeQueueDiscHostIsolation (CakeQueueDisc::IsolationMode mode, uint32_t expected);
+
+private:
+  virtual void DoRun (void);
+  CakeQueueDisc::IsolationMode m_mode;
+  uint32_t m_expected;
+};
+
+CakeQueueDiscHostIsolation::CakeQueueDiscHostIsolation (CakeQueueDisc::IsolationMode mode, uint32_t expected)
+  : TestCase ("Test the host isolation of CakeQueueDisc"),
+    m_mode (mode),
+    m_expected (expected)
+{
+}
+
+void
+CakeQueueDiscHostIsolation::DoRun (void)
+{
+  Ptr<CakeQueueDisc> queue = CreateObject<CakeQueueDisc> ();
+  queue->SetAttribute ("Isolation", EnumValue (m_mode));
+  queue->SetAttribute ("Quantum", UintegerValue (1000));
+  queue->Initialize ();
+
+  // host 1 sends a flow to each of the hosts 3 to 6, host 2 a single
+  // flow to the host 7
+  Ptr<Packet> p = Create<Packet> (1000);
+  for (uint32_t i = 0; i < 50; i++)
+    {
+      for (uint32_t flow = 1; flow <= 4; flow++)
+        {
+          queue->Enqueue (Create<CakeQueueDiscTestItem> (p, flow, 1, flow + 2));
+        }
+      queue->Enqueue (Create<CakeQueueDiscTestItem> (p, 5, 2, 7));
+    }
+
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      queue->Dequeue ();
+    }
+
+  uint32_t host2 = 50 - queue->GetFlowNPackets (5);
+  NS_TEST_EXPECT_MSG_EQ_TOL (host2, m_expected, 2, "Unexpected share of the host with a single flow");
+  Simulator::Destroy ();
+}
+
+// Test 3: a pure ACK replaces an older ACK of the same connection
+class CakeQueueDiscAckFilter : public TestCase
+{
+public:
+  CakeQueueDiscAckFilter ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CakeQueueDiscAckFilter::CakeQueueDiscAckFilter ()
+  : TestCase ("Test the ACK filter of CakeQueueDisc")
+{
+}
+
+void
+CakeQueueDiscAckFilter::DoRun (void)
+{
+  Ptr<CakeQueueDisc> queue = CreateObject<CakeQueueDisc> ();
+  queue->SetAttribute ("AckFilter", BooleanValue (true));
+  queue->Initialize ();
+
+  Ptr<Packet> ack = Create<Packet> (40);
+  Ptr<Packet> data = Create<Packet> (1000);
+  Ptr<CakeQueueDiscTestItem> item;
+
+  item = Create<CakeQueueDiscTestItem> (ack, 1, 1, 2);
+  item->SetPureTcpAck (1000);
+  queue->Enqueue (item);
+  queue->Enqueue (Create<CakeQueueDiscTestItem> (data, 1, 1, 2));
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 2, "A segment with data should not be filtered");
+
+  item = Create<CakeQueueDiscTestItem> (ack, 1, 1, 2);
+  item->SetPureTcpAck (2000);
+  queue->Enqueue (item);
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 2, "The older ACK should have been dropped");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetAckFilterDrops (), 1, "The older ACK should have been dropped");
+
+  item = Create<CakeQueueDiscTestItem> (ack, 1, 1, 2);
+  item->SetPureTcpAck (1500);
+  queue->Enqueue (item);
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 3, "A newer ACK should not be replaced by an older one");
+
+  item = Create<CakeQueueDiscTestItem> (ack, 2, 1, 2);
+  item->SetPureTcpAck (3000);
+  queue->Enqueue (item);
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 4, "The ACKs of another connection should not be filtered");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetAckFilterDrops (), 1, "Only one ACK should have been filtered");
+
+  Ptr<QueueDiscItem> first = queue->Dequeue ();
+  NS_TEST_EXPECT_MSG_EQ (first->GetPacket (), data, "The data segment should now be at the head of the flow");
+  Simulator::Destroy ();
+}
+
+// Test 4: the ACK filter keeps the duplicate ACKs and the ACKs with uncovered SACK blocks
+class CakeQueueDiscAckFilterSack : public TestCase
+{
+public:
+  CakeQueueDiscAckFilterSack ();
+
+private:
+  virtual void DoRun (void);
+  Ptr<CakeQueueDiscTestItem> CreateAck (uint32_t hash, uint32_t ack, uint32_t left = 0, uint32_t right = 0);
+};
+
+CakeQueueDiscAckFilterSack::CakeQueueDiscAckFilterSack ()
+  : TestCase ("Test the ACK filter of CakeQueueDisc with duplicate ACKs and SACK blocks")
+{
+}
+
+Ptr<CakeQueueDiscTestItem>
+CakeQueueDiscAckFilterSack::CreateAck (uint32_t hash, uint32_t ack, uint32_t left, uint32_t right)
+{
+  Ptr<CakeQueueDiscTestItem> item = Create<CakeQueueDiscTestItem> (Create<Packet> (40), hash, 1, 2);
+  item->SetPureTcpAck (ack);
+  if (left != right)
+    {
+      item->AddSackBlock (left, right);
+    }
+  return item;
+}
+
+void
+CakeQueueDiscAckFilterSack::DoRun (void)
+{
+  Ptr<CakeQueueDisc> queue = CreateObject<CakeQueueDisc> ();
+  queue->SetAttribute ("AckFilter", BooleanValue (true));
+  queue->Initialize ();
+
+  // duplicate ACKs, with and without SACK blocks
+  queue->Enqueue (CreateAck (1, 1000));
+  queue->Enqueue (CreateAck (1, 1000));
+  queue->Enqueue (CreateAck (1, 1000, 2000, 3000));
+  NS_TEST_EXPECT_MSG_EQ (queue->GetFlowNPackets (1), 3, "The duplicate ACKs should not be filtered");
+  queue->Enqueue (CreateAck (1, 4000));
+  NS_TEST_EXPECT_MSG_EQ (queue->GetFlowNPackets (1), 4, "The duplicate ACKs should not be replaced by a newer ACK");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetAckFilterDrops (), 0, "No ACK should have been filtered");
+
+  // the SACK block of the older ACK is also in the newer one
+  queue->Enqueue (CreateAck (2, 1000, 2000, 3000));
+  queue->Enqueue (CreateAck (2, 1500, 2000, 3000));
+  NS_TEST_EXPECT_MSG_EQ (queue->GetFlowNPackets (2), 1, "An ACK with the same SACK block should have been replaced");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetAckFilterDrops (), 1, "One ACK should have been filtered");
+
+  // the SACK block of the older ACK is missing from the newer one
+  queue->Enqueue (CreateAck (2, 1600, 4000, 5000));
+  NS_TEST_EXPECT_MSG_EQ (queue->GetFlowNPackets (2), 2, "An ACK with an uncovered SACK block should not be replaced");
+
+  // the SACK block of the older ACK is now acknowledged
+  queue->Enqueue (CreateAck (2, 3000, 4000, 5000));
+  NS_TEST_EXPECT_MSG_EQ (queue->GetFlowNPackets (2), 2, "An ACK with an acknowledged SACK block should have been replaced");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetAckFilterDrops (), 2, "Two ACKs should have been filtered");
+
+  uint32_t ack;
+  std::vector<std::pair<uint32_t, uint32_t> > sackBlocks;
+  // the four ACKs of the first connection are dequeued first
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      queue->Dequeue ();
+    }
+  Ptr<QueueDiscItem> item = queue->Dequeue ();
+  item->GetPureTcpAck (ack, sackBlocks);
+  NS_TEST_EXPECT_MSG_EQ (ack, 1600, "The ACK with the uncovered SACK block should be at the head of the flow");
+  Simulator::Destroy ();
+}
+
+// Test 5: on overflow, a packet is dropped from the fattest flow
+class CakeQueueDiscOverflow : public TestCase
+{
+public:
+  CakeQueueDiscOverflow ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CakeQueueDiscOverflow::CakeQueueDiscOverflow ()
+  : TestCase ("Test the overflow of CakeQueueDisc")
+{
+}
+
+void
+CakeQueueDiscOverflow::DoRun (void)
+{
+  Ptr<CakeQueueDisc> queue = CreateObject<CakeQueueDisc> ();
+  queue->SetAttribute ("PacketLimit", UintegerValue (5));
+  queue->Initialize ();
+
+  Ptr<Packet> p = Create<Packet> (1000);
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      queue->Enqueue (Create<CakeQueueDiscTestItem> (p, 1, 1, 2));
+    }
+  queue->Enqueue (Create<CakeQueueDiscTestItem> (p, 2, 1, 2));
+
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 5, "The queue disc should be at its limit");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedPackets (), 1, "A packet should have been dropped");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetFlowNPackets (1), 4, "The packet should have been dropped from the fat flow");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetFlowNPackets (2), 1, "The new packet should have been enqueued");
+  Simulator::Destroy ();
+}
+
+static class CakeQueueDiscTestSuite : public TestSuite
+{
+public:
+  CakeQueueDiscTestSuite ()
+    : TestSuite ("cake-queue-disc", UNIT)
+  {
+    AddTestCase (new CakeQueueDiscShaper (), TestCase::QUICK);
+    // each of the 5 flows gets a fifth of the link
+    AddTestCase (new CakeQueueDiscHostIsolation (CakeQueueDisc::ISOLATE_FLOWS, 20), TestCase::QUICK);
+    AddTestCase (new CakeQueueDiscHostIsolation (CakeQueueDisc::ISOLATE_DST_HOST, 20), TestCase::QUICK);
+    // each of the 2 source hosts gets half of the link
+    AddTestCase (new CakeQueueDiscHostIsolation (CakeQueueDisc::ISOLATE_SRC_HOST, 50), TestCase::QUICK);
+    AddTestCase (new CakeQueueDiscHostIsolation (CakeQueueDisc::ISOLATE_TRIPLE, 50), TestCase::QUICK);
+    AddTestCase (new CakeQueueDiscAckFilter (), TestCase::QUICK);
+    AddTestCase (new CakeQueueDiscAckFilterSack (), TestCase::QUICK);
+    AddTestCase (new CakeQueueDiscOverflow (), TestCase::QUICK);
+  }
+} g_cakeQueueDiscTestSuite;
@@ -0,0 +1,300 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/fq-pacing-queue-disc.h"
+#include "ns3/uinteger.h"
+#include "ns3/data-rate.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+
+using namespace ns3;
+
+/*
+ * A queue disc item with a given flow hash.
+ */
+class FqPacingQueueDiscTestItem : public QueueDiscItem {
+public:
+  FqPacingQueueDiscTestItem (Ptr<Packet> p, uint32_t hash);
+  virtual ~FqPacingQueueDiscTestItem ();
+  virtual void AddHeader (void);
+  virtual uint32_t Hash (uint32_t perturbation) const;
+
+private:
+  FqPacingQueueDiscTestItem ();
+  FqPacingQueueDiscTestItem (const FqPacingQueueDiscTestItem &);
+  FqPacingQueueDiscTestItem &operator = (const FqPacingQueueDiscTestItem &);
+  uint32_t m_hash;
+};
+
+FqPacingQueueDiscTestItem::FqPacingQueueDiscTestItem (Ptr<Packet> p, uint32_t hash)
+  : QueueDiscItem (p, Address (), 0),
+    m_hash (hash)
+{
+}
+
+FqPacingQueueDiscTestItem::~FqPacingQueueDiscTestItem ()
+{
+}
+
+void
+FqPacingQueueDiscTestItem::AddHeader (void)
+{
+}
+
+uint32_t
+FqPacingQueueDiscTestItem::Hash (uint32_t perturbation) const
+{
+  return m_hash;
+}
+
+// Test 1: each flow is paced at the maximum rate
+class FqPacingQueueDiscPacing : public TestCase
+{
+public:
+  FqPacingQueueDiscPacing ();
+
+private:
+  virtual void DoRun (void);
+  void CheckDequeue (Ptr<FqPacingQueueDisc> queue, uint32_t flow, uint32_t throttled, std::string error);
+};
+
+FqPacingQueueDiscPacing::FqPacingQueueDiscPacing ()
+  : TestCase ("Test the pacing of FqPacingQueueDisc")
+{
+}
+
+void
+FqPacingQueueDiscPacing::CheckDequeue (Ptr<FqPacingQueueDisc> queue, uint32_t flow,
+                                       uint32_t throttled, std::string error)
+{
+  Ptr<QueueDiscItem> item = queue->Dequeue ();
+  if (flow == 0)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((item == 0), true, error);
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_EQ ((item != 0), true, error);
+      if (item != 0)
+        {
+          NS_TEST_EXPECT_MSG_EQ (queue->GetFlowIndex (item), flow, error);
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNThrottledFlows (), throttled, "Unexpected number of throttled flows");
+}
+
+void
+FqPacingQueueDiscPacing::DoRun (void)
+{
+  // a packet of 1000 bytes takes 1 ms at 8 Mbps, a packet of 500 bytes 0.5 ms
+  Ptr<FqPacingQueueDisc> queue = CreateObject<FqPacingQueueDisc> ();
+  queue->SetAttribute ("MaxRate", DataRateValue (DataRate ("8Mbps")));
+  queue->Initialize ();
+
+  Ptr<Packet> p1 = Create<Packet> (1000);
+  Ptr<Packet> p2 = Create<Packet> (500);
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      queue->Enqueue (Create<FqPacingQueueDiscTestItem> (p1, 1));
+      queue->Enqueue (Create<FqPacingQueueDiscTestItem> (p2, 2));
+    }
+
+  // the flows are paced independently of each other
+  Simulator::Schedule (Seconds (0), &FqPacingQueueDiscPacing::CheckDequeue, this, queue, 1, 0,
+                       "The first packet of flow 1 should be sent at once");
+  Simulator::Schedule (Seconds (0), &FqPacingQueueDiscPacing::CheckDequeue, this, queue, 2, 1,
+                       "The first packet of flow 2 should be sent at once");
+  Simulator::Schedule (MicroSeconds (250), &FqPacingQueueDiscPacing::CheckDequeue, this, queue, 0, 2,
+                       "Both flows should be throttled");
+  Simulator::Schedule (MicroSeconds (500), &FqPacingQueueDiscPacing::CheckDequeue, this, queue, 2, 1,
+                       "Flow 2 should send after 0.5 ms");
+  Simulator::Schedule (MicroSeconds (750), &FqPacingQueueDiscPacing::CheckDequeue, this, queue, 0, 1,
+                       "Flow 1 should still be throttled");
+  Simulator::Schedule (MicroSeconds (1000), &FqPacingQueueDiscPacing::CheckDequeue, this, queue, 1, 0,
+                       "Flow 1 should send after 1 ms");
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 0, "All the packets should have been dequeued");
+  Simulator::Destroy ();
+}
+
+// Test 2: the packets exceeding the limit of a flow queue are dropped
+class FqPacingQueueDiscFlowLimit : public TestCase
+{
+public:
+  FqPacingQueueDiscFlowLimit ();
+
+private:
+  virtual void DoRun (void);
+};
+
+FqPacingQueueDiscFlowLimit::FqPacingQueueDiscFlowLimit ()
+  : TestCase ("Test the flow limit of FqPacingQueueDisc")
+{
+}
+
+void
+FqPacingQueueDiscFlowLimit::DoRun (void)
+{
+  Ptr<FqPacingQueueDisc> queue = CreateObject<FqPacingQueueDisc> ();
+  queue->SetAttribute ("FlowLimit", UintegerValue (3));
+  queue->Initialize ();
+
+  Ptr<Packet> p = Create<Packet> (1000);
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      queue->Enqueue (Create<FqPacingQueueDiscTestItem> (p, 1));
+    }
+  queue->Enqueue (Create<FqPacingQueueDiscTestItem> (p, 2));
+
+  NS_TEST_EXPECT_MSG_EQ (queue->GetFlowNPackets (1), 3, "The flow queue should be at its limit");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetFlowNPackets (2), 1, "Another flow should not be limited");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetFlowLimitDrops (), 2, "Two packets should have been dropped");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedPackets (), 2, "Two packets should have been dropped");
+  Simulator::Destroy ();
+}
+
+// Test 3: a new flow starts with the initial quantum, then gets a quantum per round
+class FqPacingQueueDiscQuantum : public TestCase
+{
+public:
+  FqPacingQueueDiscQuantum ();
+
+private:
+  virtual void DoRun (void);
+};
+
+FqPacingQueueDiscQuantum::FqPacingQueueDiscQuantum ()
+  : TestCase ("Test the quantum of FqPacingQueueDisc")
+{
+}
+
+void
+FqPacingQueueDiscQuantum::DoRun (void)
+{
+  Ptr<FqPacingQueueDisc> queue = CreateObject<FqPacingQueueDisc> ();
+  queue->SetAttribute ("Quantum", UintegerValue (1000));
+  queue->SetAttribute ("InitialQuantum", UintegerValue (3000));
+  queue->Initialize ();
+
+  Ptr<Packet> p = Create<Packet> (1000);
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      queue->Enqueue (Create<FqPacingQueueDiscTestItem> (p, 1));
+    }
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      queue->Enqueue (Create<FqPacingQueueDiscTestItem> (p, 2));
+    }
+
+  uint32_t expected[] = { 1, 1, 1, 2, 2, 2, 1, 2, 1, 2, 1, 2 };
+  for (uint32_t i = 0; i < 12; i++)
+    {
+      Ptr<QueueDiscItem> item = queue->Dequeue ();
+      NS_TEST_EXPECT_MSG_EQ (queue->GetFlowIndex (item), expected[i], "Unexpected flow of packet " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetFlowStatus (1), FqPacingQueueDisc::OLD_FLOW, "Flow 1 should be an old flow");
+  Simulator::Destroy ();
+}
+
+// Test 4: each flow is paced at the rate of its socket, capped by the maximum rate
+class FqPacingQueueDiscSocketRate : public TestCase
+{
+public:
+  FqPacingQueueDiscSocketRate ();
+
+private:
+  virtual void DoRun (void);
+  void CheckPeekDequeue (Ptr<FqPacingQueueDisc> queue, uint32_t flow, std::string error);
+};
+
+FqPacingQueueDiscSocketRate::FqPacingQueueDiscSocketRate ()
+  : TestCase ("Test the pacing of FqPacingQueueDisc at the rate of the sockets")
+{
+}
+
+void
+FqPacingQueueDiscSocketRate::CheckPeekDequeue (Ptr<FqPacingQueueDisc> queue, uint32_t flow, std::string error)
+{
+  Ptr<const QueueDiscItem> peeked = queue->Peek ();
+  if (flow == 0)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((peeked == 0), true, error);
+      NS_TEST_EXPECT_MSG_EQ ((queue->Dequeue () == 0), true, error);
+      return;
+    }
+  NS_TEST_EXPECT_MSG_EQ ((peeked != 0), true, error);
+  Ptr<QueueDiscItem> item = queue->Dequeue ();
+  NS_TEST_EXPECT_MSG_EQ ((item != 0), true, error);
+  if (item != 0)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((peeked == item), true, "The peeked packet should be the dequeued one");
+      NS_TEST_EXPECT_MSG_EQ (queue->GetFlowIndex (item), flow, error);
+    }
+}
+
+void
+FqPacingQueueDiscSocketRate::DoRun (void)
+{
+  // a packet of 1000 bytes takes 1 ms at 8 Mbps, and 0.5 ms at the maximum rate of 16 Mbps
+  Ptr<FqPacingQueueDisc> queue = CreateObject<FqPacingQueueDisc> ();
+  queue->SetAttribute ("MaxRate", DataRateValue (DataRate ("16Mbps")));
+  queue->Initialize ();
+
+  SocketPacingRateTag tag;
+  Ptr<Packet> p1 = Create<Packet> (1000);
+  tag.SetPacingRate (DataRate ("8Mbps"));
+  p1->AddPacketTag (tag);
+  Ptr<Packet> p2 = Create<Packet> (1000);
+  tag.SetPacingRate (DataRate ("80Mbps"));
+  p2->AddPacketTag (tag);
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      queue->Enqueue (Create<FqPacingQueueDiscTestItem> (p1, 1));
+      queue->Enqueue (Create<FqPacingQueueDiscTestItem> (p2, 2));
+    }
+
+  Simulator::Schedule (Seconds (0), &FqPacingQueueDiscSocketRate::CheckPeekDequeue, this, queue, 1,
+                       "The first packet of flow 1 should be sent at once");
+  Simulator::Schedule (Seconds (0), &FqPacingQueueDiscSocketRate::CheckPeekDequeue, this, queue, 2,
+                       "The first packet of flow 2 should be sent at once");
+  Simulator::Schedule (MicroSeconds (250), &FqPacingQueueDiscSocketRate::CheckPeekDequeue, this, queue, 0,
+                       "No packet should be peeked or dequeued while both flows are throttled");
+  Simulator::Schedule (MicroSeconds (500), &FqPacingQueueDiscSocketRate::CheckPeekDequeue, this, queue, 2,
+                       "Flow 2 should send after 0.5 ms, at the maximum rate");
+  Simulator::Schedule (MicroSeconds (750), &FqPacingQueueDiscSocketRate::CheckPeekDequeue, this, queue, 0,
+                       "Flow 1 should still be throttled");
+  Simulator::Schedule (MicroSeconds (1000), &FqPacingQueueDiscSocketRate::CheckPeekDequeue, this, queue, 1,
+                       "Flow 1 should send after 1 ms, at the rate of its socket");
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 0, "All the packets should have been dequeued");
+  Simulator::Destroy ();
+}
+
+static class FqPacingQueueDiscTestSuite : public TestSuite
+{
+public:
+  FqPacingQueueDiscTestSuite ()
+    : TestSuite ("fq-pacing-queue-disc", UNIT)
+  {
+    AddTestCase (new FqPacingQueueDiscPacing (), TestCase::QUICK);
+    AddTestCase (new FqPacingQueueDiscFlowLimit (), TestCase::QUICK);
+    AddTestCase (new FqPacingQueueDiscQuantum (), TestCase::QUICK);
+    AddTestCase (new FqPacingQueueDiscSocketRate (), TestCase::QUICK);
+  }
+} g_fqPacingQueueDiscTestSuite;
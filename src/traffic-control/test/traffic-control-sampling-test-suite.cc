@@ -0,0 +1,223 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+
+#include "ns3/test.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/queue-disc.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/output-stream-wrapper.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * Queue disc item of the sampling test
+ */
+class SamplingTestItem : public QueueDiscItem {
+public:
+  /**
+   * Constructor
+   * \param p the packet
+   */
+  SamplingTestItem (Ptr<Packet> p)
+    : QueueDiscItem (p, Address (), 0)
+  {
+  }
+  virtual void AddHeader (void)
+  {
+  }
+};
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * A FIFO queue disc of 5 packets, which drops the packets larger than
+ * 1000 bytes when they are dequeued.
+ */
+class SamplingTestQueueDisc : public QueueDisc {
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::SamplingTestQueueDisc")
+      .SetParent<QueueDisc> ()
+      .SetGroupName ("TrafficControl")
+    ;
+    return tid;
+  }
+
+private:
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item)
+  {
+    if (GetInternalQueue (0)->GetNPackets () == 5)
+      {
+        Drop (item);
+        return false;
+      }
+    return GetInternalQueue (0)->Enqueue (item);
+  }
+  virtual Ptr<QueueDiscItem> DoDequeue (void)
+  {
+    Ptr<QueueDiscItem> item;
+    while ((item = StaticCast<QueueDiscItem> (GetInternalQueue (0)->Dequeue ())) != 0
+           && item->GetPacketSize () > 1000)
+      {
+        Drop (item);
+      }
+    return item;
+  }
+  virtual Ptr<const QueueDiscItem> DoPeek (void) const
+  {
+    return StaticCast<const QueueDiscItem> (GetInternalQueue (0)->Peek ());
+  }
+  virtual bool CheckConfig (void)
+  {
+    AddInternalQueue (CreateObject<DropTailQueue> ());
+    return true;
+  }
+  virtual void InitializeParams (void)
+  {
+  }
+};
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * Check the samples of the root queue disc of a device
+ */
+class TrafficControlSamplingTestCase : public TestCase
+{
+public:
+  TrafficControlSamplingTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Enqueue packets in the queue disc
+   * \param n the number of packets
+   * \param size the size of the packets
+   */
+  void Enqueue (uint32_t n, uint32_t size);
+  /**
+   * Dequeue packets from the queue disc
+   * \param n the number of packets
+   */
+  void Dequeue (uint32_t n);
+
+  Ptr<QueueDisc> m_queueDisc; //!< The queue disc
+};
+
+TrafficControlSamplingTestCase::TrafficControlSamplingTestCase ()
+  : TestCase ("Check the sampling of the root queue discs")
+{
+}
+
+void
+TrafficControlSamplingTestCase::Enqueue (uint32_t n, uint32_t size)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      m_queueDisc->Enqueue (Create<SamplingTestItem> (Create<Packet> (size)));
+    }
+}
+
+void
+TrafficControlSamplingTestCase::Dequeue (uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      m_queueDisc->Dequeue ();
+    }
+}
+
+void
+TrafficControlSamplingTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+  node->AddDevice (device);
+  Ptr<TrafficControlLayer> tc = CreateObject<TrafficControlLayer> ();
+  tc->SetAttribute ("SamplingInterval", TimeValue (MilliSeconds (10)));
+  tc->SetAttribute ("SamplingBufferSize", UintegerValue (4));
+  tc->SetAttribute ("SojournBinWidth", TimeValue (MilliSeconds (1)));
+  tc->SetAttribute ("SojournBins", UintegerValue (5));
+  node->AggregateObject (tc);
+  m_queueDisc = CreateObject<SamplingTestQueueDisc> ();
+  tc->SetRootQueueDiscOnDevice (device, m_queueDisc);
+  std::ostringstream csv;
+  tc->SetSamplingStream (Create<OutputStreamWrapper> (&csv));
+
+  // 2 enqueue drops, 2 packets dequeued after 3 ms
+  Simulator::Schedule (MilliSeconds (1), &TrafficControlSamplingTestCase::Enqueue, this, 7, 100);
+  Simulator::Schedule (MilliSeconds (4), &TrafficControlSamplingTestCase::Dequeue, this, 2);
+  // 3 packets dequeued after 14 ms, then 1 dequeue drop
+  Simulator::Schedule (MilliSeconds (12), &TrafficControlSamplingTestCase::Enqueue, this, 1, 1500);
+  Simulator::Schedule (MilliSeconds (15), &TrafficControlSamplingTestCase::Dequeue, this, 4);
+  Simulator::Stop (MilliSeconds (65));
+  Simulator::Run ();
+
+  // the first 4 samples were written when the ring buffer was full
+  std::vector<TrafficControlLayer::QueueDiscSample> samples = tc->GetSamples (device);
+  NS_TEST_ASSERT_MSG_EQ (samples.size (), 2, "Wrong number of stored samples");
+  NS_TEST_EXPECT_MSG_EQ (samples[0].time, MilliSeconds (50), "Wrong time of the sample");
+  NS_TEST_EXPECT_MSG_EQ (samples[1].time, MilliSeconds (60), "Wrong time of the sample");
+  NS_TEST_EXPECT_MSG_EQ (samples[1].packets, 0, "Wrong number of packets");
+  NS_TEST_EXPECT_MSG_EQ (samples[1].bytes, 0, "Wrong number of bytes");
+
+  // the other samples are written when the node is disposed
+  Simulator::Destroy ();
+  std::string expected =
+    "time,node,device,packets,bytes,enqueueDrops,dequeueDrops,sojourn0,sojourn1,sojourn2,sojourn3,sojourn4\n";
+  std::ostringstream rows;
+  rows << "10000000," << node->GetId () << ",0,3,300,2,0,0,0,0,2,0\n"
+       << "20000000," << node->GetId () << ",0,0,0,0,1,0,0,0,0,3\n";
+  for (uint32_t t = 3; t <= 6; t++)
+    {
+      rows << t << "0000000," << node->GetId () << ",0,0,0,0,0,0,0,0,0,0\n";
+    }
+  NS_TEST_EXPECT_MSG_EQ (csv.str (), expected + rows.str (), "Wrong samples written");
+  m_queueDisc = 0;
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * Traffic control sampling test suite
+ */
+static class TrafficControlSamplingTestSuite : public TestSuite
+{
+public:
+  TrafficControlSamplingTestSuite ()
+    : TestSuite ("traffic-control-sampling", UNIT)
+  {
+    AddTestCase (new TrafficControlSamplingTestCase (), TestCase::QUICK);
+  }
+} g_trafficControlSamplingTestSuite; ///< the test suite
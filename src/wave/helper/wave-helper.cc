@@ -46,7 +46,10 @@ AsciiPhyTransmitSinkWithContext (
   uint8_t txLevel)
 {
   NS_LOG_FUNCTION (stream << context << p << mode << preamble << txLevel);
-  *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
+  if (!AsciiTraceHelper::WriteBinaryEvent (stream, 't', context, p))
+    {
+      *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
+    }
 }
 
 static void
@@ -58,7 +61,10 @@ AsciiPhyTransmitSinkWithoutContext (
   uint8_t txLevel)
 {
   NS_LOG_FUNCTION (stream << p << mode << preamble << txLevel);
-  *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+  if (!AsciiTraceHelper::WriteBinaryEvent (stream, 't', std::string (), p))
+    {
+      *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+    }
 }
 
 static void
@@ -71,7 +77,10 @@ AsciiPhyReceiveSinkWithContext (
   enum WifiPreamble preamble)
 {
   NS_LOG_FUNCTION (stream << context << p << snr << mode << preamble);
-  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
+  if (!AsciiTraceHelper::WriteBinaryEvent (stream, 'r', context, p))
+    {
+      *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
+    }
 }
 
 static void
@@ -83,7 +92,10 @@ AsciiPhyReceiveSinkWithoutContext (
   enum WifiPreamble preamble)
 {
   NS_LOG_FUNCTION (stream << p << snr << mode << preamble);
-  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+  if (!AsciiTraceHelper::WriteBinaryEvent (stream, 'r', std::string (), p))
+    {
+      *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+    }
 }
 
 
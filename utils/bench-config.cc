@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/config.h"
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/boolean.h"
+#include "ns3/node.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include <iostream>
+#include <sstream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/*
+ * Time the configuration of the devices of a large topology through the
+ * Config paths: one Config::Set or Config::Connect per node, as the
+ * helpers do, one call for all the nodes, and the same with a parsed
+ * Config::Path.
+ */
+
+static uint32_t g_connected = 0;
+
+static void
+Sink (Ptr<const Packet> p)
+{
+}
+
+static void
+SinkWithContext (std::string context, Ptr<const Packet> p)
+{
+}
+
+static void
+Print (std::string what, uint64_t ms, uint32_t matches)
+{
+  std::cout << what << ": " << ms << " ms, " << matches << " matches" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nNodes = 0;
+  uint32_t nDevices = 2;
+  bool perNode = true;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the Config paths on a large number of nodes");
+  cmd.AddValue ("nodes", "number of nodes", nNodes);
+  cmd.AddValue ("devices", "number of devices per node", nDevices);
+  cmd.AddValue ("per-node", "time one Config call per node", perNode);
+  cmd.Parse (argc, argv);
+
+  if (nNodes == 0 || nDevices == 0)
+    {
+      std::cerr << "Error-- number of nodes must be specified " <<
+        "by command-line argument --nodes=(number of nodes)" << std::endl;
+      exit (1);
+    }
+
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      for (uint32_t j = 0; j < nDevices; ++j)
+        {
+          node->AddDevice (CreateObject<SimpleNetDevice> ());
+        }
+    }
+
+  SystemWallClockMs time;
+  if (perNode)
+    {
+      time.Start ();
+      for (uint32_t i = 0; i < nNodes; ++i)
+        {
+          std::ostringstream oss;
+          oss << "/NodeList/" << i << "/DeviceList/0/$ns3::SimpleNetDevice/PointToPointMode";
+          Config::Set (oss.str (), BooleanValue (true));
+        }
+      Print ("Config::Set, one call per node", time.End (), nNodes);
+
+      time.Start ();
+      for (uint32_t i = 0; i < nNodes; ++i)
+        {
+          std::ostringstream oss;
+          oss << "/NodeList/" << i << "/DeviceList/*/$ns3::SimpleNetDevice/PhyRxDrop";
+          Config::ConnectWithoutContext (oss.str (), MakeCallback (&Sink));
+          g_connected += nDevices;
+        }
+      Print ("Config::ConnectWithoutContext, one call per node", time.End (), g_connected);
+    }
+
+  std::string devices = "/NodeList/*/DeviceList/*/$ns3::SimpleNetDevice";
+  time.Start ();
+  Config::Set (devices + "/PointToPointMode", BooleanValue (false));
+  Print ("Config::Set, one call", time.End (), nNodes * nDevices);
+
+  time.Start ();
+  Config::Connect (devices + "/PhyRxDrop", MakeCallback (&SinkWithContext));
+  Print ("Config::Connect, one call", time.End (), nNodes * nDevices);
+
+  time.Start ();
+  Config::MatchContainer matches = Config::LookupMatches (devices);
+  Print ("Config::LookupMatches", time.End (), matches.GetN ());
+
+  time.Start ();
+  Config::Path path (devices);
+  matches = path.LookupMatches ();
+  Print ("Config::Path::LookupMatches, first call", time.End (), matches.GetN ());
+
+  time.Start ();
+  matches = path.LookupMatches ();
+  Print ("Config::Path::LookupMatches", time.End (), matches.GetN ());
+
+  Simulator::Destroy ();
+  return 0;
+}
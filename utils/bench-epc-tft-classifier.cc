@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/epc-tft-classifier.h"
+#include "ns3/open-hash-map.h"
+#include "ns3/packet.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/udp-header.h"
+#include "ns3/udp-l4-protocol.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/*
+ * Cost of the downlink classification at the PGW: each packet from the
+ * internet is matched to its UE by destination address, then to a
+ * bearer of the UE by the TFT classifier of the UE. Every UE has a
+ * default bearer and dedicated bearers, each with a TFT made of a filter
+ * on the port of a remote server and a filter on a range of local
+ * ports, as set up for VoIP or video flows; the packets come from the
+ * servers or from other ports.
+ *
+ * The digest printed sums up the bearers the packets were classified to.
+ */
+
+/// the number of distinct packets classified in turn
+static const uint32_t N_PACKETS = 4096;
+
+static uint64_t
+RunBenchOneIteration (uint32_t n, uint32_t ues, uint32_t bearers, uint64_t *digest)
+{
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+
+  // the UEs, by address, as in the PGW
+  std::vector<Ptr<EpcTftClassifier> > classifiers;
+  OpenHashMap<Ipv4Address, uint32_t, Ipv4AddressHash> ueByAddress;
+  for (uint32_t ue = 0; ue < ues; ue++)
+    {
+      Ptr<EpcTftClassifier> c = Create<EpcTftClassifier> ();
+      c->Add (EpcTft::Default (), 1);
+      for (uint32_t b = 0; b < bearers; b++)
+        {
+          Ptr<EpcTft> tft = Create<EpcTft> ();
+          EpcTft::PacketFilter server;
+          server.remoteAddress.Set (0x01000000 + b);
+          server.remoteMask.Set (0xffffffff);
+          server.remotePortStart = server.remotePortEnd = 5000 + b;
+          tft->Add (server);
+          EpcTft::PacketFilter local;
+          local.localPortStart = 10000 + 100 * b;
+          local.localPortEnd = 10000 + 100 * b + 49;
+          tft->Add (local);
+          c->Add (tft, 2 + b);
+        }
+      classifiers.push_back (c);
+      ueByAddress[Ipv4Address (0x07000000 + ue)] = ue;
+    }
+
+  std::vector<Ptr<Packet> > packets;
+  for (uint32_t i = 0; i < N_PACKETS; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (100);
+      uint32_t b = rng->GetInteger (0, bearers);
+      UdpHeader udpHeader;
+      Ipv4Header ipHeader;
+      if (b < bearers && rng->GetInteger (0, 1))
+        {
+          // from a server of a dedicated bearer
+          ipHeader.SetSource (Ipv4Address (0x01000000 + b));
+          udpHeader.SetSourcePort (5000 + b);
+          udpHeader.SetDestinationPort (rng->GetInteger (1024, 65535));
+        }
+      else if (b < bearers)
+        {
+          // to the local ports of a dedicated bearer
+          ipHeader.SetSource (Ipv4Address (0x02000000 + rng->GetInteger (0, 255)));
+          udpHeader.SetSourcePort (rng->GetInteger (1024, 65535));
+          udpHeader.SetDestinationPort (10000 + 100 * b + rng->GetInteger (0, 49));
+        }
+      else
+        {
+          // to the default bearer
+          ipHeader.SetSource (Ipv4Address (0x02000000 + rng->GetInteger (0, 255)));
+          udpHeader.SetSourcePort (80);
+          udpHeader.SetDestinationPort (rng->GetInteger (1024, 9999));
+        }
+      ipHeader.SetDestination (Ipv4Address (0x07000000 + rng->GetInteger (0, ues - 1)));
+      ipHeader.SetProtocol (UdpL4Protocol::PROT_NUMBER);
+      ipHeader.SetPayloadSize (p->GetSize () + udpHeader.GetSerializedSize ());
+      p->AddHeader (udpHeader);
+      p->AddHeader (ipHeader);
+      packets.push_back (p);
+    }
+
+  uint64_t sum = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> p = packets[i % N_PACKETS];
+      Ipv4Header ipHeader;
+      p->PeekHeader (ipHeader);
+      OpenHashMap<Ipv4Address, uint32_t, Ipv4AddressHash>::iterator it = ueByAddress.find (ipHeader.GetDestination ());
+      sum = sum * 31 + classifiers[it->second]->Classify (p, EpcTft::DOWNLINK);
+    }
+  uint64_t deltaMs = time.End ();
+  *digest = sum;
+  return deltaMs;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t minIterations = 1;
+  uint32_t ues = 10000;
+  uint32_t bearers = 3;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the classification of downlink packets to the bearers of their UE at the PGW");
+  cmd.AddValue ("n", "number of packets", n);
+  cmd.AddValue ("min-iterations", "number of times the packets are classified", minIterations);
+  cmd.AddValue ("ues", "number of UEs", ues);
+  cmd.AddValue ("bearers", "number of dedicated bearers of each UE", bearers);
+  cmd.Parse (argc, argv);
+
+  if (n == 0 || ues == 0 || bearers > 15)
+    {
+      std::cerr << "Error-- number of packets must be specified " <<
+        "by command-line argument --n=(number of packets), " <<
+        "and a UE can have at most 15 dedicated bearers" << std::endl;
+      exit (1);
+    }
+
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  uint64_t digest = 0;
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      minDelay = std::min (minDelay, RunBenchOneIteration (n, ues, bearers, &digest));
+    }
+
+  double packetsPerSecond = 1000.0 * n / std::max<uint64_t> (minDelay, 1);
+  std::cout << packetsPerSecond / 1e6 << " Mpackets/s"
+            << " (" << minDelay << " ms elapsed)\t"
+            << ues << " UEs, " << bearers << " dedicated bearers"
+            << "\tdigest " << std::hex << digest << std::dec << std::endl;
+  return 0;
+}
@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/fq-codel-queue-disc.h"
+#include "ns3/packet-filter.h"
+#include "ns3/command-line.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/*
+ * Cost of the enqueue and dequeue operations of FqCoDelQueueDisc with a
+ * standing backlog spread over a number of flows. Each dequeued packet
+ * is enqueued again, so that the backlog and the set of active flows do
+ * not change while the operations are timed.
+ */
+
+/*
+ * A queue disc item carrying its flow in the protocol number.
+ */
+class BenchQueueDiscItem : public QueueDiscItem
+{
+public:
+  BenchQueueDiscItem (Ptr<Packet> p, uint16_t flow)
+    : QueueDiscItem (p, Address (), flow)
+  {
+  }
+  virtual void AddHeader (void)
+  {
+  }
+};
+
+/*
+ * A packet filter returning the flow of a BenchQueueDiscItem.
+ */
+class BenchPacketFilter : public PacketFilter
+{
+private:
+  virtual bool CheckProtocol (Ptr<QueueDiscItem> item) const
+  {
+    return true;
+  }
+  virtual int32_t DoClassify (Ptr<QueueDiscItem> item) const
+  {
+    return item->GetProtocol ();
+  }
+};
+
+static uint64_t
+RunBenchOneIteration (uint32_t n, uint32_t flows, uint32_t backlog, uint32_t buckets)
+{
+  Ptr<FqCoDelQueueDisc> queueDisc = CreateObject<FqCoDelQueueDisc> ();
+  queueDisc->SetAttribute ("Flows", UintegerValue (buckets));
+  queueDisc->SetAttribute ("PacketLimit", UintegerValue (backlog + 1));
+  queueDisc->AddPacketFilter (CreateObject<BenchPacketFilter> ());
+  queueDisc->SetQuantum (1500);
+  queueDisc->Initialize ();
+
+  Ptr<Packet> p = Create<Packet> (1000);
+  for (uint32_t i = 0; i < backlog; ++i)
+    {
+      queueDisc->Enqueue (Create<BenchQueueDiscItem> (p, i % flows));
+    }
+
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      Ptr<QueueDiscItem> item = queueDisc->Dequeue ();
+      queueDisc->Enqueue (item);
+    }
+  uint64_t deltaMs = time.End ();
+
+  if (queueDisc->GetNPackets () != backlog || queueDisc->GetTotalDroppedPackets () != 0)
+    {
+      std::cerr << "Error-- " << queueDisc->GetNPackets () << " packets queued, "
+                << queueDisc->GetTotalDroppedPackets () << " dropped" << std::endl;
+      exit (1);
+    }
+  queueDisc->Dispose ();
+  Simulator::Destroy ();
+  return deltaMs;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t minIterations = 1;
+  uint32_t flows = 100;
+  uint32_t backlog = 1000;
+  uint32_t buckets = 1024;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the enqueue and dequeue operations of FqCoDelQueueDisc");
+  cmd.AddValue ("n", "number of dequeue and enqueue pairs", n);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.AddValue ("flows", "number of active flows", flows);
+  cmd.AddValue ("backlog", "number of packets in the queue disc", backlog);
+  cmd.AddValue ("buckets", "value of the Flows attribute", buckets);
+  cmd.Parse (argc, argv);
+
+  if (n == 0 || flows == 0 || flows > 65535 || backlog < flows)
+    {
+      std::cerr << "Error-- number of operations must be specified " <<
+        "by command-line argument --n=(number of operations), " <<
+        "and the backlog must cover the flows" << std::endl;
+      exit (1);
+    }
+
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      minDelay = std::min (minDelay, RunBenchOneIteration (n, flows, backlog, buckets));
+    }
+
+  // an enqueue and a dequeue per step
+  double ops = 2.0 * n * 1000 / std::max<uint64_t> (minDelay, 1);
+  std::cout << ops << " ops/s"
+            << " (" << minDelay << " ms elapsed)\t"
+            << flows << " flows, " << backlog << " packets, "
+            << buckets << " buckets" << std::endl;
+  return 0;
+}
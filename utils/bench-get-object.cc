@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/udp-l4-protocol.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/simulator.h"
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/*
+ * Per-packet cost of the GetObject calls of the protocols: for each
+ * packet, Ipv4L3Protocol looks up the Ipv4 of its node for its traces,
+ * TcpSocketBase looks up the Ipv4 and Ipv6L3Protocol of its node, the
+ * TrafficControlLayer and the devices look up their interfaces, and
+ * some lookups find nothing.
+ */
+
+static uint64_t
+RunBenchOneIteration (uint32_t n, Ptr<Node> node)
+{
+  Ptr<UdpL4Protocol> udp = node->GetObject<UdpL4Protocol> ();
+  uint32_t found = 0;
+
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      found += (node->GetObject<Ipv4> () != 0);
+      found += (node->GetObject<Ipv6L3Protocol> () != 0);
+      found += (udp->GetObject<Ipv4L3Protocol> () != 0);
+      found += (udp->GetObject<TrafficControlLayer> () != 0);
+      found += (node->GetObject<Ipv4RoutingProtocol> () != 0);
+    }
+  uint64_t deltaMs = time.End ();
+
+  if (found != 4 * n)
+    {
+      std::cerr << "Error-- found " << found << " objects" << std::endl;
+      exit (1);
+    }
+  return deltaMs;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 1000000;
+  uint32_t minIterations = 1;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the per-packet GetObject calls of the protocols");
+  cmd.AddValue ("n", "number of packets", n);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of packets must be positive" << std::endl;
+      exit (1);
+    }
+
+  NodeContainer nodes;
+  nodes.Create (1);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      minDelay = std::min (minDelay, RunBenchOneIteration (n, nodes.Get (0)));
+    }
+
+  double ns = minDelay;
+  ns *= 1000000;
+  ns /= n;
+  std::cout << ns << " ns/packet"
+            << " (" << minDelay << " ms elapsed), 5 lookups per packet" << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/lte-interference.h"
+#include "ns3/lte-chunk-processor.h"
+#include "ns3/lte-spectrum-value-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/*
+ * Cost of the interference model of a receiving PHY in a TTI: the
+ * signals of a number of interferers, each occupying a few RBs of the
+ * carrier as uplink transmissions do, overlap the signal being received,
+ * and the SINR, interference and power chunk processors are evaluated
+ * as in LteSpectrumPhy.
+ */
+
+static void
+Tti (Ptr<LteInterference> interference, std::vector<Ptr<SpectrumValue> > *psds, uint32_t n)
+{
+  Time tti = MilliSeconds (1);
+  for (uint32_t i = 1; i < psds->size (); i++)
+    {
+      interference->AddSignal ((*psds)[i], tti);
+    }
+  interference->AddSignal ((*psds)[0], tti);
+  interference->StartRx ((*psds)[0]);
+  Simulator::Schedule (tti, &LteInterference::EndRx, interference);
+  if (n > 1)
+    {
+      Simulator::Schedule (tti, &Tti, interference, psds, n - 1);
+    }
+}
+
+static uint64_t
+RunBenchOneIteration (uint32_t n, uint32_t interferers, uint32_t rbs, uint8_t bandwidth)
+{
+  Ptr<LteInterference> interference = CreateObject<LteInterference> ();
+  interference->SetNoisePowerSpectralDensity (LteSpectrumValueHelper::CreateNoisePowerSpectralDensity (100, bandwidth, 9.0));
+  interference->AddSinrChunkProcessor (Create<LteChunkProcessor> ());
+  interference->AddInterferenceChunkProcessor (Create<LteChunkProcessor> ());
+  interference->AddRsPowerChunkProcessor (Create<LteChunkProcessor> ());
+
+  // the first signal is received, the others are interferers; each one
+  // occupies a block of contiguous RBs
+  std::vector<Ptr<SpectrumValue> > psds;
+  for (uint32_t i = 0; i <= interferers; i++)
+    {
+      std::vector<int> activeRbs;
+      for (uint32_t rb = 0; rb < rbs; rb++)
+        {
+          activeRbs.push_back ((i * rbs + rb) % bandwidth);
+        }
+      psds.push_back (LteSpectrumValueHelper::CreateTxPowerSpectralDensity (100, bandwidth, 23.0 - i % 20, activeRbs));
+    }
+
+  Simulator::Schedule (Seconds (0), &Tti, interference, &psds, n);
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Run ();
+  uint64_t deltaMs = time.End ();
+  Simulator::Destroy ();
+  interference->Dispose ();
+  return deltaMs;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t minIterations = 1;
+  uint32_t interferers = 50;
+  uint32_t rbs = 4;
+  uint32_t bandwidth = 100;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the interference model of a receiving LTE PHY");
+  cmd.AddValue ("n", "number of TTIs", n);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.AddValue ("interferers", "number of interfering signals in a TTI", interferers);
+  cmd.AddValue ("rbs", "number of RBs occupied by a signal", rbs);
+  cmd.AddValue ("bandwidth", "number of RBs of the carrier", bandwidth);
+  cmd.Parse (argc, argv);
+
+  if (n == 0 || rbs == 0 || bandwidth == 0 || bandwidth > 100 || rbs > bandwidth)
+    {
+      std::cerr << "Error-- number of TTIs must be specified " <<
+        "by command-line argument --n=(number of TTIs), " <<
+        "and the RBs of a signal must fit in a bandwidth of at most 100 RBs" << std::endl;
+      exit (1);
+    }
+
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      minDelay = std::min (minDelay, RunBenchOneIteration (n, interferers, rbs, bandwidth));
+    }
+
+  double ttis = 1.0 * n * 1000 / std::max<uint64_t> (minDelay, 1);
+  std::cout << ttis << " TTIs/s"
+            << " (" << minDelay << " ms elapsed)\t"
+            << interferers << " interferers of " << rbs << " RBs, "
+            << bandwidth << " RBs" << std::endl;
+  return 0;
+}
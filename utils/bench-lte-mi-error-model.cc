@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/lte-mi-error-model.h"
+#include "ns3/lte-spectrum-value-helper.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/*
+ * Cost of the error model of the data channel in a TTI: the RBs of the
+ * bandwidth are shared among the UEs scheduled in the TTI, and the
+ * error model evaluates the TB of each UE, as LteSpectrumPhy does at the
+ * end of a reception.
+ */
+
+static uint64_t
+RunBenchOneIteration (uint32_t n, uint32_t ues, uint8_t bandwidth, double &checksum)
+{
+  Ptr<SpectrumModel> sm = LteSpectrumValueHelper::GetSpectrumModel (100, bandwidth);
+  Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable> ();
+  rv->SetStream (1);
+
+  // a SINR per UE and RB, from -5 dB to 25 dB
+  std::vector<SpectrumValue> sinrs;
+  for (uint32_t ue = 0; ue < ues; ue++)
+    {
+      SpectrumValue sinr (sm);
+      for (uint8_t rb = 0; rb < bandwidth; rb++)
+        {
+          sinr[rb] = std::pow (10.0, rv->GetValue (-0.5, 2.5));
+        }
+      sinrs.push_back (sinr);
+    }
+
+  // contiguous RB allocations of the UEs, with MCSs spanning the modulations
+  std::vector<std::vector<int> > maps (ues);
+  std::vector<uint8_t> mcss (ues);
+  for (uint32_t ue = 0; ue < ues; ue++)
+    {
+      for (uint32_t rb = ue * bandwidth / ues; rb < (ue + 1) * bandwidth / ues; rb++)
+        {
+          maps[ue].push_back (rb);
+        }
+      mcss[ue] = ue % 29;
+    }
+
+  HarqProcessInfoList_t harq;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t tti = 0; tti < n; ++tti)
+    {
+      for (uint32_t ue = 0; ue < ues; ue++)
+        {
+          if (maps[ue].empty ())
+            {
+              continue;
+            }
+          uint16_t size = maps[ue].size () * (mcss[ue] + 1) * 6;
+          TbStats_t stats = LteMiErrorModel::GetTbDecodificationStats (sinrs[ue], maps[ue], size, mcss[ue], harq);
+          checksum += stats.tbler;
+        }
+    }
+  return time.End ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t minIterations = 1;
+  uint32_t ues = 10;
+  uint32_t bandwidth = 100;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the evaluation of the TBs of a TTI by LteMiErrorModel");
+  cmd.AddValue ("n", "number of TTIs", n);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.AddValue ("ues", "number of UEs scheduled in a TTI", ues);
+  cmd.AddValue ("bandwidth", "number of RBs", bandwidth);
+  cmd.Parse (argc, argv);
+
+  if (n == 0 || ues == 0 || bandwidth == 0 || bandwidth > 100)
+    {
+      std::cerr << "Error-- number of TTIs must be specified " <<
+        "by command-line argument --n=(number of TTIs), " <<
+        "and the bandwidth must not exceed 100 RBs" << std::endl;
+      exit (1);
+    }
+
+  double checksum = 0.0;
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      minDelay = std::min (minDelay, RunBenchOneIteration (n, ues, bandwidth, checksum));
+    }
+
+  double ttis = 1.0 * n * 1000 / std::max<uint64_t> (minDelay, 1);
+  std::cout << ttis << " TTIs/s"
+            << " (" << minDelay << " ms elapsed)\t"
+            << ues << " UEs, " << bandwidth << " RBs"
+            << "\t(checksum " << checksum << ")" << std::endl;
+  return 0;
+}
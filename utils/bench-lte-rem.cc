@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/lte-helper.h"
+#include "ns3/lte-enb-net-device.h"
+#include "ns3/lte-enb-phy.h"
+#include "ns3/lte-spectrum-phy.h"
+#include "ns3/spectrum-channel.h"
+#include "ns3/radio-environment-map-helper.h"
+#include "ns3/mobility-module.h"
+#include "ns3/string.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/*
+ * Cost of a Radio Environment Map: eNBs on a square grid, 500 m apart,
+ * with a map of n by n points covering them, generated by simulation or
+ * computed directly. With --recompute, the time measured is instead the
+ * one taken to compute again the map computed directly after one of the
+ * eNBs moved.
+ *
+ * The rate printed is the number of points of the map computed per
+ * second of wall-clock time, and the digest sums up the lines of the
+ * map.
+ */
+
+static uint64_t
+RunBenchOneIteration (uint32_t n, uint32_t enbs, bool direct, bool recompute, std::string fileName)
+{
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::LogDistancePropagationLossModel"));
+  lteHelper->SetPathlossModelAttribute ("Exponent", DoubleValue (3.5));
+
+  uint32_t side = (uint32_t) std::ceil (std::sqrt ((double) enbs));
+  NodeContainer enbNodes;
+  enbNodes.Create (enbs);
+  Ptr<ListPositionAllocator> enbPositions = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < enbs; i++)
+    {
+      enbPositions->Add (Vector (500.0 * (i % side), 500.0 * (i / side), 30.0));
+    }
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (enbPositions);
+  mobility.Install (enbNodes);
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+
+  uint32_t channelId = DynamicCast<LteEnbNetDevice> (enbDevs.Get (0))->GetPhy ()
+    ->GetDownlinkSpectrumPhy ()->GetChannel ()->GetId ();
+  std::ostringstream channelPath;
+  channelPath << "/ChannelList/" << channelId;
+  Ptr<RadioEnvironmentMapHelper> remHelper = CreateObject<RadioEnvironmentMapHelper> ();
+  remHelper->SetAttribute ("ChannelPath", StringValue (channelPath.str ()));
+  remHelper->SetAttribute ("OutputFile", StringValue (fileName));
+  remHelper->SetAttribute ("XMin", DoubleValue (-250.0));
+  remHelper->SetAttribute ("XMax", DoubleValue (500.0 * side - 250.0));
+  remHelper->SetAttribute ("XRes", UintegerValue (n));
+  remHelper->SetAttribute ("YMin", DoubleValue (-250.0));
+  remHelper->SetAttribute ("YMax", DoubleValue (500.0 * side - 250.0));
+  remHelper->SetAttribute ("YRes", UintegerValue (n));
+  remHelper->SetAttribute ("Z", DoubleValue (1.5));
+  remHelper->SetAttribute ("UseDirectComputation", BooleanValue (direct || recompute));
+  remHelper->Install ();
+
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Run ();
+  if (recompute)
+    {
+      time.Start ();
+      enbNodes.Get (0)->GetObject<MobilityModel> ()->SetPosition (Vector (100.0, 100.0, 30.0));
+      remHelper->Recompute (enbDevs.Get (0));
+    }
+  uint64_t deltaMs = time.End ();
+  Simulator::Destroy ();
+  return deltaMs;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t minIterations = 1;
+  uint32_t enbs = 9;
+  bool direct = false;
+  bool recompute = false;
+  std::string fileName = "bench-lte-rem.out";
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the generation of a Radio Environment Map");
+  cmd.AddValue ("n", "number of points of the map along each axis", n);
+  cmd.AddValue ("min-iterations", "number of times the map is generated", minIterations);
+  cmd.AddValue ("enbs", "number of eNBs", enbs);
+  cmd.AddValue ("direct", "compute the map directly, rather than by simulation", direct);
+  cmd.AddValue ("recompute", "time the computation of the map again after an eNB moved", recompute);
+  cmd.AddValue ("output", "file to which the map is written", fileName);
+  cmd.Parse (argc, argv);
+
+  if (n < 2 || enbs == 0)
+    {
+      std::cerr << "Error-- number of points must be specified " <<
+        "by command-line argument --n=(number of points along each axis), " <<
+        "at least 2, and there must be at least one eNB" << std::endl;
+      exit (1);
+    }
+
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      minDelay = std::min (minDelay, RunBenchOneIteration (n, enbs, direct, recompute, fileName));
+    }
+
+  uint64_t digest = 0;
+  std::ifstream file (fileName.c_str ());
+  std::string line;
+  while (std::getline (file, line))
+    {
+      for (uint32_t i = 0; i < line.size (); i++)
+        {
+          digest = digest * 31 + (unsigned char) line[i];
+        }
+    }
+
+  double pointsPerSecond = 1000.0 * n * n / std::max<uint64_t> (minDelay, 1);
+  std::cout << pointsPerSecond << " points/s"
+            << " (" << minDelay << " ms elapsed)\t"
+            << n << "x" << n << " points, " << enbs << " eNBs, "
+            << (recompute ? "recomputed" : (direct ? "direct" : "simulated"))
+            << "\tdigest " << std::hex << digest << std::dec << std::endl;
+  return 0;
+}
@@ -0,0 +1,227 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/lte-rlc-am.h"
+#include "ns3/lte-rlc-sap.h"
+#include "ns3/lte-mac-sap.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/*
+ * Cost of an AM RLC bearer at a high rate: an AM RLC entity transmits
+ * SDUs offered at the given rate to a peer AM RLC entity, which returns
+ * the STATUS PDUs. The MAC of each side gives transmission opportunities
+ * of the size of a transport block every TTI, enough for the offered
+ * rate plus 10%, and hands the PDUs straight to the peer, dropping them
+ * with the given probability so that the retransmission and reordering
+ * paths are exercised too.
+ *
+ * The rate printed is the rate at which the SDUs are delivered per second
+ * of wall-clock time, and the digest sums up the sizes of the SDUs
+ * delivered, in order.
+ */
+
+/// MAC of one side: gives the PDUs to the peer, or drops them
+class BenchMacSapProvider : public LteMacSapProvider
+{
+public:
+  BenchMacSapProvider (Ptr<UniformRandomVariable> rng, double loss)
+    : m_peer (0),
+      m_rng (rng),
+      m_loss (loss)
+  {
+  }
+  void SetPeer (LteMacSapUser *peer)
+  {
+    m_peer = peer;
+  }
+  virtual void TransmitPdu (TransmitPduParameters params)
+  {
+    if (m_loss == 0 || m_rng->GetValue () >= m_loss)
+      {
+        m_peer->ReceivePdu (params.pdu);
+      }
+  }
+  virtual void ReportBufferStatus (ReportBufferStatusParameters params)
+  {
+  }
+
+private:
+  LteMacSapUser *m_peer;
+  Ptr<UniformRandomVariable> m_rng;
+  double m_loss;
+};
+
+/// PDCP of the receiving side: counts the SDUs delivered
+class BenchRlcSapUser : public LteRlcSapUser
+{
+public:
+  BenchRlcSapUser ()
+    : m_bytes (0),
+      m_digest (0)
+  {
+  }
+  virtual void ReceivePdcpPdu (Ptr<Packet> p)
+  {
+    m_bytes += p->GetSize ();
+    m_digest = m_digest * 31 + p->GetSize ();
+  }
+  uint64_t m_bytes;
+  uint64_t m_digest;
+};
+
+/// PDCP of the transmitting side: never receives anything
+class BenchNullRlcSapUser : public LteRlcSapUser
+{
+public:
+  virtual void ReceivePdcpPdu (Ptr<Packet> p)
+  {
+  }
+};
+
+/// what happens every TTI
+struct BenchTti
+{
+  Ptr<LteRlcAm> tx;    ///< the transmitting entity
+  Ptr<LteRlcAm> rx;    ///< the receiving entity
+  uint32_t sdus;       ///< the number of SDUs offered
+  uint32_t sduSize;    ///< the size of the SDUs
+  uint32_t tbs;        ///< the number of transport blocks of the transmitting side
+  uint32_t tbSize;     ///< the size of the transport blocks
+};
+
+static void
+Tti (const BenchTti *tti, uint32_t n)
+{
+  LteRlcSapProvider::TransmitPdcpPduParameters params;
+  params.rnti = 1;
+  params.lcid = 3;
+  for (uint32_t i = 0; i < tti->sdus; i++)
+    {
+      params.pdcpPdu = Create<Packet> (tti->sduSize);
+      tti->tx->GetLteRlcSapProvider ()->TransmitPdcpPdu (params);
+    }
+  for (uint32_t i = 0; i < tti->tbs; i++)
+    {
+      tti->tx->GetLteMacSapUser ()->NotifyTxOpportunity (tti->tbSize, 0, 0);
+    }
+  tti->rx->GetLteMacSapUser ()->NotifyTxOpportunity (tti->tbSize, 0, 0);
+  if (n > 1)
+    {
+      Simulator::Schedule (MilliSeconds (1), &Tti, tti, n - 1);
+    }
+}
+
+static uint64_t
+RunBenchOneIteration (uint32_t n, double rate, uint32_t sduSize, uint32_t tbSize,
+                      double loss, uint64_t *bytes, uint64_t *digest)
+{
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+
+  Ptr<LteRlcAm> tx = CreateObject<LteRlcAm> ();
+  Ptr<LteRlcAm> rx = CreateObject<LteRlcAm> ();
+  BenchMacSapProvider txMac (rng, loss);
+  BenchMacSapProvider rxMac (rng, loss);
+  BenchNullRlcSapUser txPdcp;
+  BenchRlcSapUser rxPdcp;
+  tx->SetRnti (1);
+  tx->SetLcId (3);
+  tx->SetLteMacSapProvider (&txMac);
+  tx->SetLteRlcSapUser (&txPdcp);
+  rx->SetRnti (1);
+  rx->SetLcId (3);
+  rx->SetLteMacSapProvider (&rxMac);
+  rx->SetLteRlcSapUser (&rxPdcp);
+  txMac.SetPeer (rx->GetLteMacSapUser ());
+  rxMac.SetPeer (tx->GetLteMacSapUser ());
+
+  // the bytes offered every TTI, and the transport blocks to carry them
+  BenchTti tti;
+  tti.tx = tx;
+  tti.rx = rx;
+  tti.sdus = std::max<uint32_t> (rate * 1e6 / 8 / 1000 / sduSize, 1);
+  tti.sduSize = sduSize;
+  tti.tbs = (uint32_t) (1.1 * tti.sdus * sduSize / tbSize) + 1;
+  tti.tbSize = tbSize;
+
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Schedule (MilliSeconds (1), &Tti, &tti, n);
+  // the timers of the entities would run while some PDUs are unacknowledged
+  Simulator::Stop (MilliSeconds (n + 1));
+  Simulator::Run ();
+  uint64_t deltaMs = time.End ();
+  Simulator::Destroy ();
+  tx->Dispose ();
+  rx->Dispose ();
+  *bytes = rxPdcp.m_bytes;
+  *digest = rxPdcp.m_digest;
+  return deltaMs;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t minIterations = 1;
+  double rate = 1000;
+  uint32_t sduSize = 1400;
+  uint32_t tbSize = 9422;
+  double loss = 0.01;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the transmission of SDUs over a pair of AM RLC entities");
+  cmd.AddValue ("n", "number of TTIs", n);
+  cmd.AddValue ("min-iterations", "number of times the TTIs are run", minIterations);
+  cmd.AddValue ("rate", "rate of the SDUs offered, in Mbps", rate);
+  cmd.AddValue ("sdu-size", "size of the SDUs, in bytes", sduSize);
+  cmd.AddValue ("tb-size", "size of the transport blocks, in bytes", tbSize);
+  cmd.AddValue ("loss", "probability that a PDU is lost", loss);
+  cmd.Parse (argc, argv);
+
+  if (n == 0 || sduSize == 0 || tbSize < 7 || loss < 0 || loss >= 1)
+    {
+      std::cerr << "Error-- number of TTIs must be specified " <<
+        "by command-line argument --n=(number of TTIs), " <<
+        "transport blocks must have at least 7 bytes " <<
+        "and the loss must be in [0, 1)" << std::endl;
+      exit (1);
+    }
+
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  uint64_t bytes = 0;
+  uint64_t digest = 0;
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      minDelay = std::min (minDelay, RunBenchOneIteration (n, rate, sduSize, tbSize, loss, &bytes, &digest));
+    }
+
+  double bitsPerSecond = 8000.0 * bytes / std::max<uint64_t> (minDelay, 1);
+  std::cout << bitsPerSecond / 1e6 << " Mbps"
+            << " (" << minDelay << " ms elapsed)\t"
+            << 8.0 * bytes / n / 1e3 << " Mbps simulated, "
+            << sduSize << " byte SDUs, " << tbSize << " byte TBs, "
+            << loss << " loss"
+            << "\tdigest " << std::hex << digest << std::dec << std::endl;
+  return 0;
+}
@@ -0,0 +1,1234 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/lte-module.h"
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <string.h> // for memcmp ()
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/*
+ * Cost of a MAC scheduler, fed with the calls the MAC of an eNB made to
+ * its scheduler in a real simulation.
+ *
+ * With --record, a simulation of one eNB and its UEs, with full buffers
+ * in both directions, is run with its scheduler wrapped in a
+ * TraceRecorderFfMacScheduler, which writes the calls the MAC makes
+ * through the SAPs of the scheduler to a trace: cell and UE
+ * configuration, RACH, CQIs, BSRs and RLC buffer reports. With
+ * --replay, the calls of a trace are read into memory and made as fast
+ * as possible to a scheduler of any class, which is timed.
+ *
+ * The HARQ feedback a scheduler gets depends on its own allocations, so
+ * that it is not replayed as recorded: a TB allocated by the replayed
+ * scheduler is acknowledged DL_HARQ_DELAY TTIs later in DL and
+ * HARQ_PERIOD TTIs later in UL, unless a TB of the same UE failed at
+ * that TTI in the recorded simulation. The RLC buffer reports are
+ * replayed as recorded, whatever the replayed scheduler allocates.
+ *
+ * The trace holds the fields of the calls which the eNB MAC sets, in the
+ * byte order of the host.
+ */
+
+/// TTIs between a DL allocation and its HARQ feedback
+static const uint32_t DL_HARQ_DELAY = 4;
+
+/// the first bytes of a trace
+static const char TRACE_MAGIC[8] = { 'F', 'F', 'S', 'C', 'H', 'E', 'D', '1' };
+
+/// the calls recorded in a trace
+enum TraceCallType
+{
+  CSCHED_CELL_CONFIG_REQ = 1,
+  CSCHED_UE_CONFIG_REQ,
+  CSCHED_LC_CONFIG_REQ,
+  CSCHED_LC_RELEASE_REQ,
+  CSCHED_UE_RELEASE_REQ,
+  SCHED_DL_RLC_BUFFER_REQ,
+  SCHED_DL_TRIGGER_REQ,
+  SCHED_DL_RACH_INFO_REQ,
+  SCHED_DL_CQI_INFO_REQ,
+  SCHED_UL_TRIGGER_REQ,
+  SCHED_UL_MAC_CTRL_INFO_REQ,
+  SCHED_UL_CQI_INFO_REQ
+};
+
+/*
+ * Writing of the fields of the calls to a trace
+ */
+template <typename T>
+static void
+Write (std::ostream &os, T value)
+{
+  os.write (reinterpret_cast<const char *> (&value), sizeof (value));
+}
+
+template <typename T>
+static void
+WriteVector (std::ostream &os, const std::vector<T> &values)
+{
+  NS_ABORT_MSG_IF (values.size () > 0xffff, "list too long for the trace");
+  Write<uint16_t> (os, values.size ());
+  if (!values.empty ())
+    {
+      os.write (reinterpret_cast<const char *> (&values[0]), values.size () * sizeof (T));
+    }
+}
+
+static void
+WriteVendorSpecificList (std::ostream &os, const std::vector<VendorSpecificListElement_s> &list)
+{
+  // only the RNTI of the SRS CQIs is set by the MAC
+  Write<uint16_t> (os, list.size ());
+  for (uint32_t i = 0; i < list.size (); i++)
+    {
+      Write<uint32_t> (os, list[i].m_type);
+      uint16_t rnti = 0;
+      if (list[i].m_type == SRS_CQI_RNTI_VSP)
+        {
+          rnti = DynamicCast<SrsCqiRntiVsp> (list[i].m_value)->GetRnti ();
+        }
+      Write<uint16_t> (os, rnti);
+    }
+}
+
+/*
+ * Reading of the fields of the calls from a trace held in memory
+ */
+class TraceReader
+{
+public:
+  TraceReader (const std::vector<uint8_t> &buffer)
+    : m_buffer (buffer),
+      m_pos (0)
+  {
+  }
+
+  bool IsEnd (void) const
+  {
+    return m_pos == m_buffer.size ();
+  }
+
+  template <typename T>
+  T Read (void)
+  {
+    Check (sizeof (T));
+    T value;
+    memcpy (&value, &m_buffer[m_pos], sizeof (T));
+    m_pos += sizeof (T);
+    return value;
+  }
+
+  template <typename T>
+  void ReadVector (std::vector<T> &values)
+  {
+    uint16_t n = Read<uint16_t> ();
+    Check (n * sizeof (T));
+    values.resize (n);
+    if (n > 0)
+      {
+        memcpy (&values[0], &m_buffer[m_pos], n * sizeof (T));
+      }
+    m_pos += n * sizeof (T);
+  }
+
+  void ReadVendorSpecificList (std::vector<VendorSpecificListElement_s> &list)
+  {
+    uint16_t n = Read<uint16_t> ();
+    for (uint16_t i = 0; i < n; i++)
+      {
+        VendorSpecificListElement_s vsp;
+        vsp.m_type = Read<uint32_t> ();
+        uint16_t rnti = Read<uint16_t> ();
+        vsp.m_length = 0;
+        if (vsp.m_type == SRS_CQI_RNTI_VSP)
+          {
+            vsp.m_length = sizeof (SrsCqiRntiVsp);
+            vsp.m_value = Create<SrsCqiRntiVsp> (rnti);
+          }
+        list.push_back (vsp);
+      }
+  }
+
+private:
+  void Check (uint32_t size) const
+  {
+    if (m_pos + size > m_buffer.size ())
+      {
+        std::cerr << "Error-- truncated trace" << std::endl;
+        exit (1);
+      }
+  }
+
+  const std::vector<uint8_t> &m_buffer; ///< the trace
+  uint32_t m_pos;                       ///< the position of the next field
+};
+
+/*
+ * A scheduler recording the calls made to another one
+ */
+class TraceRecorderFfMacScheduler : public FfMacScheduler
+{
+public:
+  static TypeId GetTypeId (void);
+  TraceRecorderFfMacScheduler ();
+  virtual ~TraceRecorderFfMacScheduler ();
+
+  // inherited from FfMacScheduler
+  virtual void SetFfMacCschedSapUser (FfMacCschedSapUser* s);
+  virtual void SetFfMacSchedSapUser (FfMacSchedSapUser* s);
+  virtual FfMacCschedSapProvider* GetFfMacCschedSapProvider ();
+  virtual FfMacSchedSapProvider* GetFfMacSchedSapProvider ();
+  virtual void SetLteFfrSapProvider (LteFfrSapProvider* s);
+  virtual LteFfrSapUser* GetLteFfrSapUser ();
+
+  /// \return the number of calls recorded
+  uint64_t GetNCalls (void) const;
+
+  /**
+   * Write the type of a call to the trace, opening it on the first call
+   * \return the trace, to write the parameters of the call to
+   */
+  std::ostream &StartCall (TraceCallType type);
+
+  FfMacCschedSapProvider *m_cschedSapProvider; ///< the provider of the recorded scheduler
+  FfMacSchedSapProvider *m_schedSapProvider;   ///< the provider of the recorded scheduler
+
+protected:
+  virtual void DoInitialize (void);
+  virtual void DoDispose (void);
+
+private:
+  void SetScheduler (std::string type);
+  std::string GetScheduler (void) const;
+
+  Ptr<FfMacScheduler> m_scheduler;          ///< the recorded scheduler
+  std::string m_fileName;                   ///< the name of the trace
+  std::ofstream m_file;                     ///< the trace
+  uint64_t m_nCalls;                        ///< the number of calls recorded
+  FfMacCschedSapProvider *m_cschedSap;      ///< the provider given to the MAC
+  FfMacSchedSapProvider *m_schedSap;        ///< the provider given to the MAC
+};
+
+/*
+ * The CSCHED provider of a TraceRecorderFfMacScheduler
+ */
+class TraceRecorderCschedSapProvider : public FfMacCschedSapProvider
+{
+public:
+  TraceRecorderCschedSapProvider (TraceRecorderFfMacScheduler *recorder)
+    : m_recorder (recorder)
+  {
+  }
+
+  virtual void CschedCellConfigReq (const struct CschedCellConfigReqParameters& params)
+  {
+    std::ostream &os = m_recorder->StartCall (CSCHED_CELL_CONFIG_REQ);
+    Write<uint8_t> (os, params.m_ulBandwidth);
+    Write<uint8_t> (os, params.m_dlBandwidth);
+    m_recorder->m_cschedSapProvider->CschedCellConfigReq (params);
+  }
+
+  virtual void CschedUeConfigReq (const struct CschedUeConfigReqParameters& params)
+  {
+    std::ostream &os = m_recorder->StartCall (CSCHED_UE_CONFIG_REQ);
+    Write<uint16_t> (os, params.m_rnti);
+    Write<uint8_t> (os, params.m_reconfigureFlag);
+    Write<uint8_t> (os, params.m_transmissionMode);
+    m_recorder->m_cschedSapProvider->CschedUeConfigReq (params);
+  }
+
+  virtual void CschedLcConfigReq (const struct CschedLcConfigReqParameters& params)
+  {
+    std::ostream &os = m_recorder->StartCall (CSCHED_LC_CONFIG_REQ);
+    Write<uint16_t> (os, params.m_rnti);
+    Write<uint8_t> (os, params.m_reconfigureFlag);
+    Write<uint16_t> (os, params.m_logicalChannelConfigList.size ());
+    for (uint32_t i = 0; i < params.m_logicalChannelConfigList.size (); i++)
+      {
+        const LogicalChannelConfigListElement_s &lc = params.m_logicalChannelConfigList[i];
+        Write<uint8_t> (os, lc.m_logicalChannelIdentity);
+        Write<uint8_t> (os, lc.m_logicalChannelGroup);
+        Write<uint8_t> (os, lc.m_direction);
+        Write<uint8_t> (os, lc.m_qosBearerType);
+        Write<uint8_t> (os, lc.m_qci);
+        Write<uint64_t> (os, lc.m_eRabMaximulBitrateUl);
+        Write<uint64_t> (os, lc.m_eRabMaximulBitrateDl);
+        Write<uint64_t> (os, lc.m_eRabGuaranteedBitrateUl);
+        Write<uint64_t> (os, lc.m_eRabGuaranteedBitrateDl);
+      }
+    m_recorder->m_cschedSapProvider->CschedLcConfigReq (params);
+  }
+
+  virtual void CschedLcReleaseReq (const struct CschedLcReleaseReqParameters& params)
+  {
+    std::ostream &os = m_recorder->StartCall (CSCHED_LC_RELEASE_REQ);
+    Write<uint16_t> (os, params.m_rnti);
+    WriteVector (os, params.m_logicalChannelIdentity);
+    m_recorder->m_cschedSapProvider->CschedLcReleaseReq (params);
+  }
+
+  virtual void CschedUeReleaseReq (const struct CschedUeReleaseReqParameters& params)
+  {
+    std::ostream &os = m_recorder->StartCall (CSCHED_UE_RELEASE_REQ);
+    Write<uint16_t> (os, params.m_rnti);
+    m_recorder->m_cschedSapProvider->CschedUeReleaseReq (params);
+  }
+
+private:
+  TraceRecorderFfMacScheduler *m_recorder; ///< the recorder
+};
+
+/*
+ * The SCHED provider of a TraceRecorderFfMacScheduler
+ */
+class TraceRecorderSchedSapProvider : public FfMacSchedSapProvider
+{
+public:
+  TraceRecorderSchedSapProvider (TraceRecorderFfMacScheduler *recorder)
+    : m_recorder (recorder)
+  {
+  }
+
+  virtual void SchedDlRlcBufferReq (const struct SchedDlRlcBufferReqParameters& params)
+  {
+    std::ostream &os = m_recorder->StartCall (SCHED_DL_RLC_BUFFER_REQ);
+    Write<uint16_t> (os, params.m_rnti);
+    Write<uint8_t> (os, params.m_logicalChannelIdentity);
+    Write<uint32_t> (os, params.m_rlcTransmissionQueueSize);
+    Write<uint16_t> (os, params.m_rlcTransmissionQueueHolDelay);
+    Write<uint32_t> (os, params.m_rlcRetransmissionQueueSize);
+    Write<uint16_t> (os, params.m_rlcRetransmissionHolDelay);
+    Write<uint16_t> (os, params.m_rlcStatusPduSize);
+    m_recorder->m_schedSapProvider->SchedDlRlcBufferReq (params);
+  }
+
+  virtual void SchedDlPagingBufferReq (const struct SchedDlPagingBufferReqParameters& params)
+  {
+    m_recorder->m_schedSapProvider->SchedDlPagingBufferReq (params);
+  }
+
+  virtual void SchedDlMacBufferReq (const struct SchedDlMacBufferReqParameters& params)
+  {
+    m_recorder->m_schedSapProvider->SchedDlMacBufferReq (params);
+  }
+
+  virtual void SchedDlTriggerReq (const struct SchedDlTriggerReqParameters& params)
+  {
+    // only the UEs of the failed TBs are kept from the HARQ feedback
+    std::vector<uint16_t> failed;
+    for (uint32_t i = 0; i < params.m_dlInfoList.size (); i++)
+      {
+        const DlInfoListElement_s &info = params.m_dlInfoList[i];
+        for (uint32_t layer = 0; layer < info.m_harqStatus.size (); layer++)
+          {
+            if (info.m_harqStatus[layer] == DlInfoListElement_s::NACK)
+              {
+                failed.push_back (info.m_rnti);
+                break;
+              }
+          }
+      }
+    std::ostream &os = m_recorder->StartCall (SCHED_DL_TRIGGER_REQ);
+    Write<uint16_t> (os, params.m_sfnSf);
+    WriteVector (os, failed);
+    m_recorder->m_schedSapProvider->SchedDlTriggerReq (params);
+  }
+
+  virtual void SchedDlRachInfoReq (const struct SchedDlRachInfoReqParameters& params)
+  {
+    std::ostream &os = m_recorder->StartCall (SCHED_DL_RACH_INFO_REQ);
+    Write<uint16_t> (os, params.m_sfnSf);
+    Write<uint16_t> (os, params.m_rachList.size ());
+    for (uint32_t i = 0; i < params.m_rachList.size (); i++)
+      {
+        Write<uint16_t> (os, params.m_rachList[i].m_rnti);
+        Write<uint16_t> (os, params.m_rachList[i].m_estimatedSize);
+      }
+    m_recorder->m_schedSapProvider->SchedDlRachInfoReq (params);
+  }
+
+  virtual void SchedDlCqiInfoReq (const struct SchedDlCqiInfoReqParameters& params)
+  {
+    std::ostream &os = m_recorder->StartCall (SCHED_DL_CQI_INFO_REQ);
+    Write<uint16_t> (os, params.m_sfnSf);
+    Write<uint16_t> (os, params.m_cqiList.size ());
+    for (uint32_t i = 0; i < params.m_cqiList.size (); i++)
+      {
+        const CqiListElement_s &cqi = params.m_cqiList[i];
+        Write<uint16_t> (os, cqi.m_rnti);
+        Write<uint8_t> (os, cqi.m_ri);
+        Write<uint8_t> (os, cqi.m_cqiType);
+        WriteVector (os, cqi.m_wbCqi);
+        Write<uint8_t> (os, cqi.m_wbPmi);
+        const std::vector<HigherLayerSelected_s> &sb = cqi.m_sbMeasResult.m_higherLayerSelected;
+        Write<uint16_t> (os, sb.size ());
+        for (uint32_t j = 0; j < sb.size (); j++)
+          {
+            Write<uint8_t> (os, sb[j].m_sbPmi);
+            WriteVector (os, sb[j].m_sbCqi);
+          }
+      }
+    m_recorder->m_schedSapProvider->SchedDlCqiInfoReq (params);
+  }
+
+  virtual void SchedUlTriggerReq (const struct SchedUlTriggerReqParameters& params)
+  {
+    // only the UEs of the failed TBs are kept from the HARQ feedback
+    std::vector<uint16_t> failed;
+    for (uint32_t i = 0; i < params.m_ulInfoList.size (); i++)
+      {
+        if (params.m_ulInfoList[i].m_receptionStatus == UlInfoListElement_s::NotOk)
+          {
+            failed.push_back (params.m_ulInfoList[i].m_rnti);
+          }
+      }
+    std::ostream &os = m_recorder->StartCall (SCHED_UL_TRIGGER_REQ);
+    Write<uint16_t> (os, params.m_sfnSf);
+    WriteVector (os, failed);
+    m_recorder->m_schedSapProvider->SchedUlTriggerReq (params);
+  }
+
+  virtual void SchedUlNoiseInterferenceReq (const struct SchedUlNoiseInterferenceReqParameters& params)
+  {
+    m_recorder->m_schedSapProvider->SchedUlNoiseInterferenceReq (params);
+  }
+
+  virtual void SchedUlSrInfoReq (const struct SchedUlSrInfoReqParameters& params)
+  {
+    m_recorder->m_schedSapProvider->SchedUlSrInfoReq (params);
+  }
+
+  virtual void SchedUlMacCtrlInfoReq (const struct SchedUlMacCtrlInfoReqParameters& params)
+  {
+    std::ostream &os = m_recorder->StartCall (SCHED_UL_MAC_CTRL_INFO_REQ);
+    Write<uint16_t> (os, params.m_sfnSf);
+    Write<uint16_t> (os, params.m_macCeList.size ());
+    for (uint32_t i = 0; i < params.m_macCeList.size (); i++)
+      {
+        const MacCeListElement_s &ce = params.m_macCeList[i];
+        Write<uint16_t> (os, ce.m_rnti);
+        Write<uint8_t> (os, ce.m_macCeType);
+        Write<uint8_t> (os, ce.m_macCeValue.m_phr);
+        Write<uint8_t> (os, ce.m_macCeValue.m_crnti);
+        WriteVector (os, ce.m_macCeValue.m_bufferStatus);
+      }
+    m_recorder->m_schedSapProvider->SchedUlMacCtrlInfoReq (params);
+  }
+
+  virtual void SchedUlCqiInfoReq (const struct SchedUlCqiInfoReqParameters& params)
+  {
+    std::ostream &os = m_recorder->StartCall (SCHED_UL_CQI_INFO_REQ);
+    Write<uint16_t> (os, params.m_sfnSf);
+    Write<uint8_t> (os, params.m_ulCqi.m_type);
+    WriteVector (os, params.m_ulCqi.m_sinr);
+    WriteVendorSpecificList (os, params.m_vendorSpecificList);
+    m_recorder->m_schedSapProvider->SchedUlCqiInfoReq (params);
+  }
+
+private:
+  TraceRecorderFfMacScheduler *m_recorder; ///< the recorder
+};
+
+NS_OBJECT_ENSURE_REGISTERED (TraceRecorderFfMacScheduler);
+
+TypeId
+TraceRecorderFfMacScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TraceRecorderFfMacScheduler")
+    .SetParent<FfMacScheduler> ()
+    .AddConstructor<TraceRecorderFfMacScheduler> ()
+    .AddAttribute ("Scheduler",
+                   "The TypeId of the recorded scheduler",
+                   StringValue ("ns3::PfFfMacScheduler"),
+                   MakeStringAccessor (&TraceRecorderFfMacScheduler::SetScheduler,
+                                       &TraceRecorderFfMacScheduler::GetScheduler),
+                   MakeStringChecker ())
+    .AddAttribute ("FileName",
+                   "The name of the trace",
+                   StringValue ("lte-scheduler.trace"),
+                   MakeStringAccessor (&TraceRecorderFfMacScheduler::m_fileName),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+TraceRecorderFfMacScheduler::TraceRecorderFfMacScheduler ()
+  : m_cschedSapProvider (0),
+    m_schedSapProvider (0),
+    m_nCalls (0)
+{
+  m_cschedSap = new TraceRecorderCschedSapProvider (this);
+  m_schedSap = new TraceRecorderSchedSapProvider (this);
+}
+
+TraceRecorderFfMacScheduler::~TraceRecorderFfMacScheduler ()
+{
+}
+
+void
+TraceRecorderFfMacScheduler::DoInitialize (void)
+{
+  m_scheduler->Initialize ();
+  FfMacScheduler::DoInitialize ();
+}
+
+void
+TraceRecorderFfMacScheduler::DoDispose (void)
+{
+  m_scheduler->Dispose ();
+  m_scheduler = 0;
+  m_file.close ();
+  delete m_cschedSap;
+  delete m_schedSap;
+  FfMacScheduler::DoDispose ();
+}
+
+void
+TraceRecorderFfMacScheduler::SetScheduler (std::string type)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (type);
+  m_scheduler = factory.Create<FfMacScheduler> ();
+  m_cschedSapProvider = m_scheduler->GetFfMacCschedSapProvider ();
+  m_schedSapProvider = m_scheduler->GetFfMacSchedSapProvider ();
+}
+
+std::string
+TraceRecorderFfMacScheduler::GetScheduler (void) const
+{
+  return m_scheduler->GetInstanceTypeId ().GetName ();
+}
+
+void
+TraceRecorderFfMacScheduler::SetFfMacCschedSapUser (FfMacCschedSapUser* s)
+{
+  m_scheduler->SetFfMacCschedSapUser (s);
+}
+
+void
+TraceRecorderFfMacScheduler::SetFfMacSchedSapUser (FfMacSchedSapUser* s)
+{
+  m_scheduler->SetFfMacSchedSapUser (s);
+}
+
+FfMacCschedSapProvider*
+TraceRecorderFfMacScheduler::GetFfMacCschedSapProvider ()
+{
+  return m_cschedSap;
+}
+
+FfMacSchedSapProvider*
+TraceRecorderFfMacScheduler::GetFfMacSchedSapProvider ()
+{
+  return m_schedSap;
+}
+
+void
+TraceRecorderFfMacScheduler::SetLteFfrSapProvider (LteFfrSapProvider* s)
+{
+  m_scheduler->SetLteFfrSapProvider (s);
+}
+
+LteFfrSapUser*
+TraceRecorderFfMacScheduler::GetLteFfrSapUser ()
+{
+  return m_scheduler->GetLteFfrSapUser ();
+}
+
+uint64_t
+TraceRecorderFfMacScheduler::GetNCalls (void) const
+{
+  return m_nCalls;
+}
+
+std::ostream &
+TraceRecorderFfMacScheduler::StartCall (TraceCallType type)
+{
+  if (!m_file.is_open ())
+    {
+      m_file.open (m_fileName.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+      NS_ABORT_MSG_UNLESS (m_file.is_open (), "cannot open " << m_fileName);
+      m_file.write (TRACE_MAGIC, sizeof (TRACE_MAGIC));
+    }
+  m_nCalls++;
+  Write<uint8_t> (m_file, type);
+  return m_file;
+}
+
+/*
+ * A trace read into memory: the parameters of each call, and the order
+ * of the calls
+ */
+struct Trace
+{
+  struct Call
+  {
+    uint8_t type;   ///< the TraceCallType of the call
+    uint32_t index; ///< the index of the parameters of the call in their list
+  };
+  /// the HARQ feedback of a trigger, as the UEs of the failed TBs
+  struct Trigger
+  {
+    uint16_t sfnSf;
+    std::vector<uint16_t> failed;
+  };
+
+  std::vector<Call> calls;
+  std::vector<FfMacCschedSapProvider::CschedCellConfigReqParameters> cellConfig;
+  std::vector<FfMacCschedSapProvider::CschedUeConfigReqParameters> ueConfig;
+  std::vector<FfMacCschedSapProvider::CschedLcConfigReqParameters> lcConfig;
+  std::vector<FfMacCschedSapProvider::CschedLcReleaseReqParameters> lcRelease;
+  std::vector<FfMacCschedSapProvider::CschedUeReleaseReqParameters> ueRelease;
+  std::vector<FfMacSchedSapProvider::SchedDlRlcBufferReqParameters> dlRlcBuffer;
+  std::vector<Trigger> dlTrigger;
+  std::vector<FfMacSchedSapProvider::SchedDlRachInfoReqParameters> dlRachInfo;
+  std::vector<FfMacSchedSapProvider::SchedDlCqiInfoReqParameters> dlCqiInfo;
+  std::vector<Trigger> ulTrigger;
+  std::vector<FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters> ulMacCtrlInfo;
+  std::vector<FfMacSchedSapProvider::SchedUlCqiInfoReqParameters> ulCqiInfo;
+};
+
+/*
+ * Add a call to a trace, with the index of its parameters in their list
+ * \return the parameters, to be filled
+ */
+template <typename T>
+static T &
+AddCall (Trace &trace, std::vector<T> &list, TraceCallType type)
+{
+  Trace::Call call;
+  call.type = type;
+  call.index = list.size ();
+  trace.calls.push_back (call);
+  list.push_back (T ());
+  return list.back ();
+}
+
+static void
+ReadTrace (std::string fileName, Trace &trace)
+{
+  std::ifstream file (fileName.c_str (), std::ios::in | std::ios::binary);
+  if (!file.is_open ())
+    {
+      std::cerr << "Error-- cannot open " << fileName << std::endl;
+      exit (1);
+    }
+  std::vector<uint8_t> buffer ((std::istreambuf_iterator<char> (file)),
+                               std::istreambuf_iterator<char> ());
+  if (buffer.size () < sizeof (TRACE_MAGIC)
+      || memcmp (&buffer[0], TRACE_MAGIC, sizeof (TRACE_MAGIC)) != 0)
+    {
+      std::cerr << "Error-- " << fileName << " is not a scheduler trace" << std::endl;
+      exit (1);
+    }
+  buffer.erase (buffer.begin (), buffer.begin () + sizeof (TRACE_MAGIC));
+
+  TraceReader reader (buffer);
+  while (!reader.IsEnd ())
+    {
+      uint8_t type = reader.Read<uint8_t> ();
+      switch (type)
+        {
+        case CSCHED_CELL_CONFIG_REQ:
+          {
+            FfMacCschedSapProvider::CschedCellConfigReqParameters &params =
+              AddCall (trace, trace.cellConfig, CSCHED_CELL_CONFIG_REQ);
+            params.m_ulBandwidth = reader.Read<uint8_t> ();
+            params.m_dlBandwidth = reader.Read<uint8_t> ();
+            break;
+          }
+        case CSCHED_UE_CONFIG_REQ:
+          {
+            FfMacCschedSapProvider::CschedUeConfigReqParameters &params =
+              AddCall (trace, trace.ueConfig, CSCHED_UE_CONFIG_REQ);
+            params.m_rnti = reader.Read<uint16_t> ();
+            params.m_reconfigureFlag = reader.Read<uint8_t> ();
+            params.m_transmissionMode = reader.Read<uint8_t> ();
+            break;
+          }
+        case CSCHED_LC_CONFIG_REQ:
+          {
+            FfMacCschedSapProvider::CschedLcConfigReqParameters &params =
+              AddCall (trace, trace.lcConfig, CSCHED_LC_CONFIG_REQ);
+            params.m_rnti = reader.Read<uint16_t> ();
+            params.m_reconfigureFlag = reader.Read<uint8_t> ();
+            uint16_t n = reader.Read<uint16_t> ();
+            for (uint16_t i = 0; i < n; i++)
+              {
+                LogicalChannelConfigListElement_s lc;
+                lc.m_logicalChannelIdentity = reader.Read<uint8_t> ();
+                lc.m_logicalChannelGroup = reader.Read<uint8_t> ();
+                lc.m_direction = (LogicalChannelConfigListElement_s::Direction_e) reader.Read<uint8_t> ();
+                lc.m_qosBearerType = (LogicalChannelConfigListElement_s::QosBearerType_e) reader.Read<uint8_t> ();
+                lc.m_qci = reader.Read<uint8_t> ();
+                lc.m_eRabMaximulBitrateUl = reader.Read<uint64_t> ();
+                lc.m_eRabMaximulBitrateDl = reader.Read<uint64_t> ();
+                lc.m_eRabGuaranteedBitrateUl = reader.Read<uint64_t> ();
+                lc.m_eRabGuaranteedBitrateDl = reader.Read<uint64_t> ();
+                params.m_logicalChannelConfigList.push_back (lc);
+              }
+            break;
+          }
+        case CSCHED_LC_RELEASE_REQ:
+          {
+            FfMacCschedSapProvider::CschedLcReleaseReqParameters &params =
+              AddCall (trace, trace.lcRelease, CSCHED_LC_RELEASE_REQ);
+            params.m_rnti = reader.Read<uint16_t> ();
+            reader.ReadVector (params.m_logicalChannelIdentity);
+            break;
+          }
+        case CSCHED_UE_RELEASE_REQ:
+          {
+            FfMacCschedSapProvider::CschedUeReleaseReqParameters &params =
+              AddCall (trace, trace.ueRelease, CSCHED_UE_RELEASE_REQ);
+            params.m_rnti = reader.Read<uint16_t> ();
+            break;
+          }
+        case SCHED_DL_RLC_BUFFER_REQ:
+          {
+            FfMacSchedSapProvider::SchedDlRlcBufferReqParameters &params =
+              AddCall (trace, trace.dlRlcBuffer, SCHED_DL_RLC_BUFFER_REQ);
+            params.m_rnti = reader.Read<uint16_t> ();
+            params.m_logicalChannelIdentity = reader.Read<uint8_t> ();
+            params.m_rlcTransmissionQueueSize = reader.Read<uint32_t> ();
+            params.m_rlcTransmissionQueueHolDelay = reader.Read<uint16_t> ();
+            params.m_rlcRetransmissionQueueSize = reader.Read<uint32_t> ();
+            params.m_rlcRetransmissionHolDelay = reader.Read<uint16_t> ();
+            params.m_rlcStatusPduSize = reader.Read<uint16_t> ();
+            break;
+          }
+        case SCHED_DL_TRIGGER_REQ:
+        case SCHED_UL_TRIGGER_REQ:
+          {
+            Trace::Trigger &trigger = AddCall (trace, type == SCHED_DL_TRIGGER_REQ ? trace.dlTrigger : trace.ulTrigger,
+                                               (TraceCallType) type);
+            trigger.sfnSf = reader.Read<uint16_t> ();
+            reader.ReadVector (trigger.failed);
+            break;
+          }
+        case SCHED_DL_RACH_INFO_REQ:
+          {
+            FfMacSchedSapProvider::SchedDlRachInfoReqParameters &params =
+              AddCall (trace, trace.dlRachInfo, SCHED_DL_RACH_INFO_REQ);
+            params.m_sfnSf = reader.Read<uint16_t> ();
+            uint16_t n = reader.Read<uint16_t> ();
+            for (uint16_t i = 0; i < n; i++)
+              {
+                RachListElement_s rach;
+                rach.m_rnti = reader.Read<uint16_t> ();
+                rach.m_estimatedSize = reader.Read<uint16_t> ();
+                params.m_rachList.push_back (rach);
+              }
+            break;
+          }
+        case SCHED_DL_CQI_INFO_REQ:
+          {
+            FfMacSchedSapProvider::SchedDlCqiInfoReqParameters &params =
+              AddCall (trace, trace.dlCqiInfo, SCHED_DL_CQI_INFO_REQ);
+            params.m_sfnSf = reader.Read<uint16_t> ();
+            uint16_t n = reader.Read<uint16_t> ();
+            params.m_cqiList.resize (n);
+            for (uint16_t i = 0; i < n; i++)
+              {
+                CqiListElement_s &cqi = params.m_cqiList[i];
+                cqi.m_rnti = reader.Read<uint16_t> ();
+                cqi.m_ri = reader.Read<uint8_t> ();
+                cqi.m_cqiType = (CqiListElement_s::CqiType_e) reader.Read<uint8_t> ();
+                reader.ReadVector (cqi.m_wbCqi);
+                cqi.m_wbPmi = reader.Read<uint8_t> ();
+                std::vector<HigherLayerSelected_s> &sb = cqi.m_sbMeasResult.m_higherLayerSelected;
+                sb.resize (reader.Read<uint16_t> ());
+                for (uint32_t j = 0; j < sb.size (); j++)
+                  {
+                    sb[j].m_sbPmi = reader.Read<uint8_t> ();
+                    reader.ReadVector (sb[j].m_sbCqi);
+                  }
+              }
+            break;
+          }
+        case SCHED_UL_MAC_CTRL_INFO_REQ:
+          {
+            FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters &params =
+              AddCall (trace, trace.ulMacCtrlInfo, SCHED_UL_MAC_CTRL_INFO_REQ);
+            params.m_sfnSf = reader.Read<uint16_t> ();
+            uint16_t n = reader.Read<uint16_t> ();
+            params.m_macCeList.resize (n);
+            for (uint16_t i = 0; i < n; i++)
+              {
+                MacCeListElement_s &ce = params.m_macCeList[i];
+                ce.m_rnti = reader.Read<uint16_t> ();
+                ce.m_macCeType = (MacCeListElement_s::MacCeType_e) reader.Read<uint8_t> ();
+                ce.m_macCeValue.m_phr = reader.Read<uint8_t> ();
+                ce.m_macCeValue.m_crnti = reader.Read<uint8_t> ();
+                reader.ReadVector (ce.m_macCeValue.m_bufferStatus);
+              }
+            break;
+          }
+        case SCHED_UL_CQI_INFO_REQ:
+          {
+            FfMacSchedSapProvider::SchedUlCqiInfoReqParameters &params =
+              AddCall (trace, trace.ulCqiInfo, SCHED_UL_CQI_INFO_REQ);
+            params.m_sfnSf = reader.Read<uint16_t> ();
+            params.m_ulCqi.m_type = (UlCqi_s::Type_e) reader.Read<uint8_t> ();
+            reader.ReadVector (params.m_ulCqi.m_sinr);
+            reader.ReadVendorSpecificList (params.m_vendorSpecificList);
+            break;
+          }
+        default:
+          std::cerr << "Error-- unknown call " << (uint16_t) type << " in the trace" << std::endl;
+          exit (1);
+        }
+    }
+  if (trace.cellConfig.empty () || trace.calls[0].type != CSCHED_CELL_CONFIG_REQ)
+    {
+      std::cerr << "Error-- the trace does not start with the configuration of the cell" << std::endl;
+      exit (1);
+    }
+}
+
+/*
+ * The MAC side of the SAPs of the replayed scheduler
+ */
+class ReplaySchedulerUser : public FfMacSchedSapUser, public FfMacCschedSapUser
+{
+public:
+  ReplaySchedulerUser (uint8_t dlBandwidth);
+
+  virtual void SchedDlConfigInd (const struct SchedDlConfigIndParameters& params);
+  virtual void SchedUlConfigInd (const struct SchedUlConfigIndParameters& params);
+  virtual void CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params);
+  virtual void CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params);
+  virtual void CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params);
+  virtual void CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params);
+  virtual void CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params);
+  virtual void CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params);
+  virtual void CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params);
+
+  void Mix (uint64_t value);
+  /// drop the pending HARQ feedback of a released UE, which the schedulers do not expect
+  void RemoveUe (uint16_t rnti);
+
+  uint32_t m_tti;        ///< the current TTI
+  uint64_t m_digest;     ///< the digest of the allocations
+  int m_rbgSize;         ///< the number of RBs of a RBG in DL
+  uint64_t m_dlTbs;      ///< the number of DL TBs allocated
+  uint64_t m_dlRbs;      ///< the number of DL RBs allocated
+  uint64_t m_dlBytes;    ///< the size of the DL TBs allocated
+  uint64_t m_ulTbs;      ///< the number of UL TBs allocated
+  uint64_t m_ulRbs;      ///< the number of UL RBs allocated
+  uint64_t m_ulBytes;    ///< the size of the UL TBs allocated
+  uint64_t m_rars;       ///< the number of random access responses
+  /// the DL HARQ feedback due at each of the next TTIs
+  std::vector<std::vector<DlInfoListElement_s> > m_dlInfo;
+  /// the UL HARQ feedback due at each of the next TTIs
+  std::vector<std::vector<UlInfoListElement_s> > m_ulInfo;
+};
+
+ReplaySchedulerUser::ReplaySchedulerUser (uint8_t dlBandwidth)
+  : m_tti (0),
+    m_digest (14695981039346656037ULL),
+    m_dlTbs (0),
+    m_dlRbs (0),
+    m_dlBytes (0),
+    m_ulTbs (0),
+    m_ulRbs (0),
+    m_ulBytes (0),
+    m_rars (0),
+    m_dlInfo (DL_HARQ_DELAY + 1),
+    m_ulInfo (HARQ_PERIOD + 1)
+{
+  m_rbgSize = dlBandwidth < 11 ? 1 : dlBandwidth < 27 ? 2 : dlBandwidth < 64 ? 3 : 4;
+}
+
+void
+ReplaySchedulerUser::Mix (uint64_t value)
+{
+  m_digest = (m_digest ^ value) * 1099511628211ULL;
+}
+
+void
+ReplaySchedulerUser::RemoveUe (uint16_t rnti)
+{
+  for (uint32_t i = 0; i < m_dlInfo.size (); i++)
+    {
+      std::vector<DlInfoListElement_s> &feedback = m_dlInfo[i];
+      for (uint32_t j = 0; j < feedback.size (); )
+        {
+          if (feedback[j].m_rnti == rnti)
+            {
+              feedback.erase (feedback.begin () + j);
+            }
+          else
+            {
+              j++;
+            }
+        }
+    }
+  for (uint32_t i = 0; i < m_ulInfo.size (); i++)
+    {
+      std::vector<UlInfoListElement_s> &feedback = m_ulInfo[i];
+      for (uint32_t j = 0; j < feedback.size (); )
+        {
+          if (feedback[j].m_rnti == rnti)
+            {
+              feedback.erase (feedback.begin () + j);
+            }
+          else
+            {
+              j++;
+            }
+        }
+    }
+}
+
+void
+ReplaySchedulerUser::SchedDlConfigInd (const struct SchedDlConfigIndParameters& params)
+{
+  std::vector<DlInfoListElement_s> &feedback = m_dlInfo[(m_tti + DL_HARQ_DELAY) % m_dlInfo.size ()];
+  for (uint32_t i = 0; i < params.m_buildDataList.size (); i++)
+    {
+      const BuildDataListElement_s &data = params.m_buildDataList[i];
+      Mix (data.m_rnti);
+      Mix (data.m_dci.m_rbBitmap);
+      DlInfoListElement_s info;
+      info.m_rnti = data.m_rnti;
+      info.m_harqProcessId = data.m_dci.m_harqProcess;
+      for (uint32_t layer = 0; layer < data.m_dci.m_tbsSize.size (); layer++)
+        {
+          Mix (data.m_dci.m_tbsSize[layer]);
+          m_dlBytes += data.m_dci.m_tbsSize[layer];
+          // the outcome is set when the feedback is due
+          info.m_harqStatus.push_back (DlInfoListElement_s::ACK);
+        }
+      feedback.push_back (info);
+      m_dlTbs++;
+      for (uint32_t bitmap = data.m_dci.m_rbBitmap; bitmap != 0; bitmap &= bitmap - 1)
+        {
+          m_dlRbs += m_rbgSize;
+        }
+    }
+  m_rars += params.m_buildRarList.size ();
+}
+
+void
+ReplaySchedulerUser::SchedUlConfigInd (const struct SchedUlConfigIndParameters& params)
+{
+  std::vector<UlInfoListElement_s> &feedback = m_ulInfo[(m_tti + HARQ_PERIOD) % m_ulInfo.size ()];
+  for (uint32_t i = 0; i < params.m_dciList.size (); i++)
+    {
+      const UlDciListElement_s &dci = params.m_dciList[i];
+      Mix (dci.m_rnti);
+      Mix (dci.m_rbStart);
+      Mix (dci.m_rbLen);
+      Mix (dci.m_tbSize);
+      m_ulTbs++;
+      m_ulRbs += dci.m_rbLen;
+      m_ulBytes += dci.m_tbSize;
+      UlInfoListElement_s info;
+      info.m_rnti = dci.m_rnti;
+      info.m_receptionStatus = UlInfoListElement_s::Ok;
+      info.m_tpc = 0;
+      feedback.push_back (info);
+    }
+}
+
+void
+ReplaySchedulerUser::CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params)
+{
+}
+
+void
+ReplaySchedulerUser::CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params)
+{
+}
+
+void
+ReplaySchedulerUser::CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params)
+{
+}
+
+void
+ReplaySchedulerUser::CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params)
+{
+}
+
+void
+ReplaySchedulerUser::CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params)
+{
+}
+
+void
+ReplaySchedulerUser::CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params)
+{
+}
+
+void
+ReplaySchedulerUser::CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params)
+{
+}
+
+static bool
+HasFailed (const std::vector<uint16_t> &failed, uint16_t rnti)
+{
+  return std::find (failed.begin (), failed.end (), rnti) != failed.end ();
+}
+
+static uint64_t
+ReplayOneIteration (const Trace &trace, std::string scheduler, ReplaySchedulerUser &user)
+{
+  uint8_t ulBandwidth = trace.cellConfig[0].m_ulBandwidth;
+  uint8_t dlBandwidth = trace.cellConfig[0].m_dlBandwidth;
+  ObjectFactory factory;
+  factory.SetTypeId (scheduler);
+  Ptr<FfMacScheduler> sched = factory.Create<FfMacScheduler> ();
+  Ptr<LteFfrAlgorithm> ffr = CreateObject<LteFrNoOpAlgorithm> ();
+  ffr->SetDlBandwidth (dlBandwidth);
+  ffr->SetUlBandwidth (ulBandwidth);
+  sched->SetLteFfrSapProvider (ffr->GetLteFfrSapProvider ());
+  ffr->SetLteFfrSapUser (sched->GetLteFfrSapUser ());
+  sched->SetFfMacSchedSapUser (&user);
+  sched->SetFfMacCschedSapUser (&user);
+  sched->Initialize ();
+  ffr->Initialize ();
+  FfMacSchedSapProvider *schedSap = sched->GetFfMacSchedSapProvider ();
+  FfMacCschedSapProvider *cschedSap = sched->GetFfMacCschedSapProvider ();
+
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < trace.calls.size (); i++)
+    {
+      uint32_t index = trace.calls[i].index;
+      switch (trace.calls[i].type)
+        {
+        case CSCHED_CELL_CONFIG_REQ:
+          cschedSap->CschedCellConfigReq (trace.cellConfig[index]);
+          break;
+        case CSCHED_UE_CONFIG_REQ:
+          cschedSap->CschedUeConfigReq (trace.ueConfig[index]);
+          break;
+        case CSCHED_LC_CONFIG_REQ:
+          cschedSap->CschedLcConfigReq (trace.lcConfig[index]);
+          break;
+        case CSCHED_LC_RELEASE_REQ:
+          cschedSap->CschedLcReleaseReq (trace.lcRelease[index]);
+          break;
+        case CSCHED_UE_RELEASE_REQ:
+          user.RemoveUe (trace.ueRelease[index].m_rnti);
+          cschedSap->CschedUeReleaseReq (trace.ueRelease[index]);
+          break;
+        case SCHED_DL_RLC_BUFFER_REQ:
+          schedSap->SchedDlRlcBufferReq (trace.dlRlcBuffer[index]);
+          break;
+        case SCHED_DL_TRIGGER_REQ:
+          {
+            const Trace::Trigger &trigger = trace.dlTrigger[index];
+            FfMacSchedSapProvider::SchedDlTriggerReqParameters params;
+            params.m_sfnSf = trigger.sfnSf;
+            params.m_dlInfoList.swap (user.m_dlInfo[user.m_tti % user.m_dlInfo.size ()]);
+            for (uint32_t j = 0; j < params.m_dlInfoList.size (); j++)
+              {
+                DlInfoListElement_s &info = params.m_dlInfoList[j];
+                if (HasFailed (trigger.failed, info.m_rnti))
+                  {
+                    std::fill (info.m_harqStatus.begin (), info.m_harqStatus.end (), DlInfoListElement_s::NACK);
+                  }
+              }
+            schedSap->SchedDlTriggerReq (params);
+            break;
+          }
+        case SCHED_DL_RACH_INFO_REQ:
+          schedSap->SchedDlRachInfoReq (trace.dlRachInfo[index]);
+          break;
+        case SCHED_DL_CQI_INFO_REQ:
+          schedSap->SchedDlCqiInfoReq (trace.dlCqiInfo[index]);
+          break;
+        case SCHED_UL_TRIGGER_REQ:
+          {
+            const Trace::Trigger &trigger = trace.ulTrigger[index];
+            FfMacSchedSapProvider::SchedUlTriggerReqParameters params;
+            params.m_sfnSf = trigger.sfnSf;
+            params.m_ulInfoList.swap (user.m_ulInfo[user.m_tti % user.m_ulInfo.size ()]);
+            for (uint32_t j = 0; j < params.m_ulInfoList.size (); j++)
+              {
+                UlInfoListElement_s &info = params.m_ulInfoList[j];
+                if (HasFailed (trigger.failed, info.m_rnti))
+                  {
+                    info.m_receptionStatus = UlInfoListElement_s::NotOk;
+                  }
+              }
+            schedSap->SchedUlTriggerReq (params);
+            // the UL trigger ends the TTI
+            user.m_tti++;
+            break;
+          }
+        case SCHED_UL_MAC_CTRL_INFO_REQ:
+          schedSap->SchedUlMacCtrlInfoReq (trace.ulMacCtrlInfo[index]);
+          break;
+        case SCHED_UL_CQI_INFO_REQ:
+          schedSap->SchedUlCqiInfoReq (trace.ulCqiInfo[index]);
+          break;
+        }
+    }
+  uint64_t deltaMs = time.End ();
+
+  sched->Dispose ();
+  ffr->Dispose ();
+  Simulator::Destroy ();
+  return deltaMs;
+}
+
+static void
+Record (std::string fileName, std::string scheduler, uint16_t ues, uint8_t bandwidth,
+        double radius, double duration)
+{
+  // the SRS periodicity must leave an SRS offset to each UE
+  static const uint16_t srsPeriodicities[] = { 2, 5, 10, 20, 40, 80, 160, 320 };
+  uint16_t srsPeriodicity = 320;
+  for (uint32_t i = 0; i < sizeof (srsPeriodicities) / sizeof (srsPeriodicities[0]); i++)
+    {
+      if (srsPeriodicities[i] > ues)
+        {
+          srsPeriodicity = srsPeriodicities[i];
+          break;
+        }
+    }
+  Config::SetDefault ("ns3::LteEnbRrc::SrsPeriodicity", UintegerValue (srsPeriodicity));
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::LogDistancePropagationLossModel"));
+  lteHelper->SetPathlossModelAttribute ("Exponent", DoubleValue (3.5));
+  lteHelper->SetSchedulerType ("ns3::TraceRecorderFfMacScheduler");
+  lteHelper->SetSchedulerAttribute ("Scheduler", StringValue (scheduler));
+  lteHelper->SetSchedulerAttribute ("FileName", StringValue (fileName));
+  lteHelper->SetEnbDeviceAttribute ("DlBandwidth", UintegerValue (bandwidth));
+  lteHelper->SetEnbDeviceAttribute ("UlBandwidth", UintegerValue (bandwidth));
+
+  NodeContainer enbNodes;
+  enbNodes.Create (1);
+  NodeContainer ueNodes;
+  ueNodes.Create (ues);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (enbNodes);
+  mobility.SetPositionAllocator ("ns3::UniformDiscPositionAllocator",
+                                 "rho", DoubleValue (radius));
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  lteHelper->Attach (ueDevs, enbDevs.Get (0));
+  // without the EPC, the bearers are served by RLC SM, with full buffers
+  EpsBearer bearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT);
+  lteHelper->ActivateDataRadioBearer (ueDevs, bearer);
+
+  PointerValue sched;
+  enbDevs.Get (0)->GetAttribute ("FfMacScheduler", sched);
+  Ptr<TraceRecorderFfMacScheduler> recorder = sched.Get<TraceRecorderFfMacScheduler> ();
+  Simulator::Stop (Seconds (duration));
+  Simulator::Run ();
+  std::cout << recorder->GetNCalls () << " calls of " << scheduler << " recorded to " << fileName
+            << "\t" << ues << " UEs, " << (uint16_t) bandwidth << " RBs, " << duration << " s" << std::endl;
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  std::string record;
+  std::string replay;
+  uint32_t minIterations = 1;
+  std::string scheduler = "ns3::PfFfMacScheduler";
+  uint16_t ues = 20;
+  uint16_t bandwidth = 25;
+  double radius = 300.0;
+  double duration = 1.0;
+
+  CommandLine cmd;
+  cmd.Usage ("Record the calls made to a LTE MAC scheduler in a simulation, "
+             "or benchmark a scheduler replaying them");
+  cmd.AddValue ("record", "the trace to record", record);
+  cmd.AddValue ("replay", "the trace to replay", replay);
+  cmd.AddValue ("min-iterations", "number of times the trace is replayed", minIterations);
+  cmd.AddValue ("scheduler", "the TypeId of the scheduler recorded or replayed", scheduler);
+  cmd.AddValue ("ues", "number of UEs of the recorded simulation", ues);
+  cmd.AddValue ("bandwidth", "number of RBs in DL and UL of the recorded simulation", bandwidth);
+  cmd.AddValue ("radius", "radius in meters of the disc of the UEs of the recorded simulation", radius);
+  cmd.AddValue ("duration", "duration in seconds of the recorded simulation", duration);
+  cmd.Parse (argc, argv);
+
+  if (record.empty () == replay.empty ())
+    {
+      std::cerr << "Error-- either a trace to record must be specified "
+                << "by command-line argument --record=(file name), "
+                << "or a trace to replay by --replay=(file name)" << std::endl;
+      exit (1);
+    }
+  TypeId tid;
+  if (!TypeId::LookupByNameFailSafe (scheduler, &tid)
+      || !tid.IsChildOf (FfMacScheduler::GetTypeId ()))
+    {
+      std::cerr << "Error-- " << scheduler << " is not a MAC scheduler" << std::endl;
+      exit (1);
+    }
+
+  if (!record.empty ())
+    {
+      if (ues == 0 || ues >= 320 || (bandwidth != 6 && bandwidth != 15 && bandwidth != 25 && bandwidth != 50
+                       && bandwidth != 75 && bandwidth != 100))
+        {
+          std::cerr << "Error-- the number of UEs must be less than 320, "
+                    << "and the bandwidth must be 6, 15, 25, 50, 75 or 100 RBs" << std::endl;
+          exit (1);
+        }
+      Record (record, scheduler, ues, bandwidth, radius, duration);
+      return 0;
+    }
+
+  Trace trace;
+  ReadTrace (replay, trace);
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      ReplaySchedulerUser user (trace.cellConfig[0].m_dlBandwidth);
+      minDelay = std::min (minDelay, ReplayOneIteration (trace, scheduler, user));
+      if (i + 1 < minIterations)
+        {
+          continue;
+        }
+
+      uint32_t nTtis = std::max<uint32_t> (user.m_tti, 1);
+      double usPerTti = 1000.0 * std::max<uint64_t> (minDelay, 1) / nTtis;
+      std::cout << usPerTti << " us/TTI"
+                << " (" << minDelay << " ms elapsed)\t"
+                << scheduler << ", " << trace.calls.size () << " calls, " << user.m_tti << " TTIs"
+                << "\tdigest " << std::hex << user.m_digest << std::dec << std::endl;
+      std::cout << "DL: " << (double) user.m_dlTbs / nTtis << " TBs/TTI, "
+                << (double) user.m_dlRbs / nTtis << " RBs/TTI, "
+                << user.m_dlBytes * 8.0 / nTtis / 1000.0 << " Mbit/s"
+                << "\tUL: " << (double) user.m_ulTbs / nTtis << " TBs/TTI, "
+                << (double) user.m_ulRbs / nTtis << " RBs/TTI, "
+                << user.m_ulBytes * 8.0 / nTtis / 1000.0 << " Mbit/s"
+                << "\t" << user.m_rars << " RARs" << std::endl;
+    }
+  return 0;
+}
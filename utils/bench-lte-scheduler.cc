@@ -0,0 +1,408 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/ff-mac-scheduler.h"
+#include "ns3/ff-mac-csched-sap.h"
+#include "ns3/ff-mac-sched-sap.h"
+#include "ns3/lte-fr-no-op-algorithm.h"
+#include "ns3/lte-common.h"
+#include "ns3/lte-vendor-specific-parameters.h"
+#include "ns3/object-factory.h"
+#include "ns3/simulator.h"
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/*
+ * Cost of a MAC scheduler, fed through its SAPs with the inputs an eNB
+ * MAC gives it, without the PHY: every UE has a full buffer in both
+ * directions, reports its DL CQIs and sends an SRS every cqiPeriod TTIs and
+ * a BSR every bsrPeriod TTIs, and the HARQ feedback of its allocations
+ * arrives DL_HARQ_DELAY TTIs later in DL and HARQ_PERIOD TTIs later in
+ * UL, one transmission in ten failing.
+ *
+ * The digest printed sums up the allocations made: two implementations
+ * of a scheduler taking the same decisions print the same digest.
+ */
+
+/// TTIs between a DL allocation and its HARQ feedback
+static const uint32_t DL_HARQ_DELAY = 4;
+
+/*
+ * The MAC side of the SAPs of the scheduler
+ */
+class BenchSchedulerUser : public FfMacSchedSapUser, public FfMacCschedSapUser
+{
+public:
+  BenchSchedulerUser ();
+
+  virtual void SchedDlConfigInd (const struct SchedDlConfigIndParameters& params);
+  virtual void SchedUlConfigInd (const struct SchedUlConfigIndParameters& params);
+  virtual void CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params);
+  virtual void CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params);
+  virtual void CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params);
+  virtual void CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params);
+  virtual void CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params);
+  virtual void CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params);
+  virtual void CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params);
+
+  void Mix (uint64_t value);
+
+  uint32_t m_tti;     ///< the current TTI
+  uint64_t m_digest;  ///< the digest of the allocations
+  uint32_t m_nTbs;    ///< the number of TBs allocated, to make one in ten fail
+  /// the DL HARQ feedback due at each of the next TTIs
+  std::vector<std::vector<DlInfoListElement_s> > m_dlInfo;
+  /// the UL HARQ feedback due at each of the next TTIs
+  std::vector<std::vector<UlInfoListElement_s> > m_ulInfo;
+  /// the UEs allocated in DL in the current TTI, whose RLC reports the new buffer
+  std::vector<uint16_t> m_dlServed;
+};
+
+BenchSchedulerUser::BenchSchedulerUser ()
+  : m_tti (0),
+    m_digest (14695981039346656037ULL),
+    m_nTbs (0),
+    m_dlInfo (DL_HARQ_DELAY + 1),
+    m_ulInfo (HARQ_PERIOD + 1)
+{
+}
+
+void
+BenchSchedulerUser::Mix (uint64_t value)
+{
+  m_digest = (m_digest ^ value) * 1099511628211ULL;
+}
+
+void
+BenchSchedulerUser::SchedDlConfigInd (const struct SchedDlConfigIndParameters& params)
+{
+  std::vector<DlInfoListElement_s> &feedback = m_dlInfo[(m_tti + DL_HARQ_DELAY) % m_dlInfo.size ()];
+  for (uint32_t i = 0; i < params.m_buildDataList.size (); i++)
+    {
+      const BuildDataListElement_s &data = params.m_buildDataList[i];
+      Mix (data.m_rnti);
+      Mix (data.m_dci.m_rbBitmap);
+      DlInfoListElement_s info;
+      info.m_rnti = data.m_rnti;
+      info.m_harqProcessId = data.m_dci.m_harqProcess;
+      for (uint32_t layer = 0; layer < data.m_dci.m_tbsSize.size (); layer++)
+        {
+          Mix (data.m_dci.m_tbsSize[layer]);
+          info.m_harqStatus.push_back (++m_nTbs % 10 == 0 ? DlInfoListElement_s::NACK : DlInfoListElement_s::ACK);
+        }
+      feedback.push_back (info);
+      m_dlServed.push_back (data.m_rnti);
+    }
+}
+
+void
+BenchSchedulerUser::SchedUlConfigInd (const struct SchedUlConfigIndParameters& params)
+{
+  std::vector<UlInfoListElement_s> &feedback = m_ulInfo[(m_tti + HARQ_PERIOD) % m_ulInfo.size ()];
+  for (uint32_t i = 0; i < params.m_dciList.size (); i++)
+    {
+      const UlDciListElement_s &dci = params.m_dciList[i];
+      Mix (dci.m_rnti);
+      Mix (dci.m_rbStart);
+      Mix (dci.m_rbLen);
+      Mix (dci.m_tbSize);
+      UlInfoListElement_s info;
+      info.m_rnti = dci.m_rnti;
+      info.m_receptionStatus = (++m_nTbs % 10 == 0 ? UlInfoListElement_s::NotOk : UlInfoListElement_s::Ok);
+      info.m_tpc = 0;
+      feedback.push_back (info);
+    }
+}
+
+void
+BenchSchedulerUser::CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params)
+{
+}
+
+void
+BenchSchedulerUser::CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params)
+{
+}
+
+void
+BenchSchedulerUser::CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params)
+{
+}
+
+void
+BenchSchedulerUser::CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params)
+{
+}
+
+void
+BenchSchedulerUser::CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params)
+{
+}
+
+void
+BenchSchedulerUser::CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params)
+{
+}
+
+void
+BenchSchedulerUser::CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params)
+{
+}
+
+/*
+ * The channel of a UE: a CQI per RBG and a SINR per RB, drifting from
+ * one report to the next
+ */
+static uint8_t
+GetCqi (uint16_t rnti, uint32_t rbg, uint32_t report)
+{
+  return 1 + (rnti * 7 + rbg * 3 + report) % 15;
+}
+
+static double
+GetSinr (uint16_t rnti, uint32_t rb, uint32_t report)
+{
+  return -5.0 + (rnti * 11 + rb * 5 + report * 3) % 30;
+}
+
+static void
+ReportRlcBuffer (FfMacSchedSapProvider *sched, uint16_t rnti)
+{
+  FfMacSchedSapProvider::SchedDlRlcBufferReqParameters params;
+  params.m_rnti = rnti;
+  params.m_logicalChannelIdentity = 3;
+  params.m_rlcTransmissionQueueSize = 100000;
+  params.m_rlcTransmissionQueueHolDelay = 10;
+  params.m_rlcRetransmissionQueueSize = 0;
+  params.m_rlcRetransmissionHolDelay = 0;
+  params.m_rlcStatusPduSize = 0;
+  sched->SchedDlRlcBufferReq (params);
+}
+
+static uint64_t
+RunBenchOneIteration (std::string scheduler, uint32_t n, uint16_t ues, uint8_t bandwidth,
+                      uint32_t cqiPeriod, uint32_t bsrPeriod, uint64_t *digest)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (scheduler);
+  Ptr<FfMacScheduler> sched = factory.Create<FfMacScheduler> ();
+  Ptr<LteFfrAlgorithm> ffr = CreateObject<LteFrNoOpAlgorithm> ();
+  ffr->SetDlBandwidth (bandwidth);
+  ffr->SetUlBandwidth (bandwidth);
+  sched->SetLteFfrSapProvider (ffr->GetLteFfrSapProvider ());
+  ffr->SetLteFfrSapUser (sched->GetLteFfrSapUser ());
+  BenchSchedulerUser user;
+  sched->SetFfMacSchedSapUser (&user);
+  sched->SetFfMacCschedSapUser (&user);
+  sched->Initialize ();
+  ffr->Initialize ();
+  FfMacSchedSapProvider *schedSap = sched->GetFfMacSchedSapProvider ();
+  FfMacCschedSapProvider *cschedSap = sched->GetFfMacCschedSapProvider ();
+
+  FfMacCschedSapProvider::CschedCellConfigReqParameters cell;
+  cell.m_ulBandwidth = bandwidth;
+  cell.m_dlBandwidth = bandwidth;
+  cschedSap->CschedCellConfigReq (cell);
+
+  for (uint16_t rnti = 1; rnti <= ues; rnti++)
+    {
+      FfMacCschedSapProvider::CschedUeConfigReqParameters ue;
+      ue.m_rnti = rnti;
+      ue.m_reconfigureFlag = false;
+      ue.m_transmissionMode = 0;
+      cschedSap->CschedUeConfigReq (ue);
+
+      FfMacCschedSapProvider::CschedLcConfigReqParameters lc;
+      lc.m_rnti = rnti;
+      lc.m_reconfigureFlag = false;
+      LogicalChannelConfigListElement_s lcConfig;
+      lcConfig.m_logicalChannelIdentity = 3;
+      lcConfig.m_logicalChannelGroup = 1;
+      lcConfig.m_direction = LogicalChannelConfigListElement_s::DIR_BOTH;
+      lcConfig.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+      lcConfig.m_qci = 9;
+      lcConfig.m_eRabMaximulBitrateUl = 1000000;
+      lcConfig.m_eRabMaximulBitrateDl = 1000000;
+      lcConfig.m_eRabGuaranteedBitrateUl = 100000;
+      lcConfig.m_eRabGuaranteedBitrateDl = 100000;
+      lc.m_logicalChannelConfigList.push_back (lcConfig);
+      cschedSap->CschedLcConfigReq (lc);
+
+      ReportRlcBuffer (schedSap, rnti);
+    }
+
+  int rbgSize = bandwidth < 11 ? 1 : bandwidth < 27 ? 2 : bandwidth < 64 ? 3 : 4;
+  uint32_t rbgNum = bandwidth / rbgSize;
+
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t tti = 0; tti < n; tti++)
+    {
+      user.m_tti = tti;
+      uint16_t frame = 1 + (tti / 10) % 1024;
+      uint8_t subframe = 1 + tti % 10;
+      uint16_t sfnSf = (frame << 4) | subframe;
+
+      // the RLC of the UEs served in the previous TTI reports the new buffer
+      for (uint32_t i = 0; i < user.m_dlServed.size (); i++)
+        {
+          ReportRlcBuffer (schedSap, user.m_dlServed[i]);
+        }
+      user.m_dlServed.clear ();
+
+      FfMacSchedSapProvider::SchedDlCqiInfoReqParameters dlCqi;
+      dlCqi.m_sfnSf = sfnSf;
+      FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters bsr;
+      bsr.m_sfnSf = sfnSf;
+      for (uint16_t rnti = 1; rnti <= ues; rnti++)
+        {
+          if ((tti + rnti) % cqiPeriod == 0)
+            {
+              uint32_t report = tti / cqiPeriod;
+              // a periodic wideband CQI and an aperiodic subband one
+              CqiListElement_s wbCqi;
+              wbCqi.m_rnti = rnti;
+              wbCqi.m_ri = 1;
+              wbCqi.m_cqiType = CqiListElement_s::P10;
+              wbCqi.m_wbCqi.push_back (GetCqi (rnti, rbgNum, report));
+              wbCqi.m_wbPmi = 0;
+              dlCqi.m_cqiList.push_back (wbCqi);
+              CqiListElement_s cqi;
+              cqi.m_rnti = rnti;
+              cqi.m_ri = 1;
+              cqi.m_cqiType = CqiListElement_s::A30;
+              cqi.m_wbCqi.push_back (GetCqi (rnti, rbgNum, report));
+              cqi.m_wbPmi = 0;
+              for (uint32_t rbg = 0; rbg < rbgNum; rbg++)
+                {
+                  HigherLayerSelected_s sb;
+                  sb.m_sbPmi = 0;
+                  sb.m_sbCqi.push_back (GetCqi (rnti, rbg, report));
+                  cqi.m_sbMeasResult.m_higherLayerSelected.push_back (sb);
+                }
+              dlCqi.m_cqiList.push_back (cqi);
+
+              FfMacSchedSapProvider::SchedUlCqiInfoReqParameters srs;
+              srs.m_sfnSf = sfnSf;
+              srs.m_ulCqi.m_type = UlCqi_s::SRS;
+              for (uint32_t rb = 0; rb < bandwidth; rb++)
+                {
+                  srs.m_ulCqi.m_sinr.push_back (LteFfConverter::double2fpS11dot3 (GetSinr (rnti, rb, report)));
+                }
+              VendorSpecificListElement_s vsp;
+              vsp.m_type = SRS_CQI_RNTI_VSP;
+              vsp.m_length = sizeof (SrsCqiRntiVsp);
+              vsp.m_value = Create<SrsCqiRntiVsp> (rnti);
+              srs.m_vendorSpecificList.push_back (vsp);
+              schedSap->SchedUlCqiInfoReq (srs);
+            }
+          if ((tti + rnti) % bsrPeriod == 0)
+            {
+              MacCeListElement_s ce;
+              ce.m_rnti = rnti;
+              ce.m_macCeType = MacCeListElement_s::BSR;
+              ce.m_macCeValue.m_bufferStatus.resize (4, 0);
+              ce.m_macCeValue.m_bufferStatus[1] = 40;
+              bsr.m_macCeList.push_back (ce);
+            }
+        }
+      if (!dlCqi.m_cqiList.empty ())
+        {
+          schedSap->SchedDlCqiInfoReq (dlCqi);
+        }
+      if (!bsr.m_macCeList.empty ())
+        {
+          schedSap->SchedUlMacCtrlInfoReq (bsr);
+        }
+
+      FfMacSchedSapProvider::SchedDlTriggerReqParameters dlTrigger;
+      dlTrigger.m_sfnSf = sfnSf;
+      dlTrigger.m_dlInfoList.swap (user.m_dlInfo[tti % user.m_dlInfo.size ()]);
+      schedSap->SchedDlTriggerReq (dlTrigger);
+
+      FfMacSchedSapProvider::SchedUlTriggerReqParameters ulTrigger;
+      ulTrigger.m_sfnSf = sfnSf;
+      ulTrigger.m_ulInfoList.swap (user.m_ulInfo[tti % user.m_ulInfo.size ()]);
+      schedSap->SchedUlTriggerReq (ulTrigger);
+    }
+  uint64_t deltaMs = time.End ();
+
+  *digest = user.m_digest;
+  sched->Dispose ();
+  ffr->Dispose ();
+  Simulator::Destroy ();
+  return deltaMs;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t minIterations = 1;
+  std::string scheduler = "ns3::PfFfMacScheduler";
+  uint32_t ues = 100;
+  uint32_t bandwidth = 100;
+  uint32_t cqiPeriod = 10;
+  uint32_t bsrPeriod = 5;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark a LTE MAC scheduler fed with synthetic CQIs and buffer reports");
+  cmd.AddValue ("n", "number of TTIs", n);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.AddValue ("scheduler", "the TypeId of the scheduler", scheduler);
+  cmd.AddValue ("ues", "number of UEs", ues);
+  cmd.AddValue ("bandwidth", "number of RBs in DL and UL", bandwidth);
+  cmd.AddValue ("cqi-period", "TTIs between two CQI reports of a UE", cqiPeriod);
+  cmd.AddValue ("bsr-period", "TTIs between two BSRs of a UE", bsrPeriod);
+  cmd.Parse (argc, argv);
+
+  if (n == 0 || ues == 0 || ues > 65000 || cqiPeriod == 0 || bsrPeriod == 0
+      || (bandwidth != 6 && bandwidth != 15 && bandwidth != 25 && bandwidth != 50
+          && bandwidth != 75 && bandwidth != 100))
+    {
+      std::cerr << "Error-- number of TTIs must be specified " <<
+        "by command-line argument --n=(number of TTIs), " <<
+        "and the bandwidth must be 6, 15, 25, 50, 75 or 100 RBs" << std::endl;
+      exit (1);
+    }
+  TypeId tid;
+  if (!TypeId::LookupByNameFailSafe (scheduler, &tid)
+      || !tid.IsChildOf (FfMacScheduler::GetTypeId ()))
+    {
+      std::cerr << "Error-- " << scheduler << " is not a MAC scheduler" << std::endl;
+      exit (1);
+    }
+
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  uint64_t digest = 0;
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      minDelay = std::min (minDelay, RunBenchOneIteration (scheduler, n, ues, bandwidth,
+                                                           cqiPeriod, bsrPeriod, &digest));
+    }
+
+  double usPerTti = 1000.0 * std::max<uint64_t> (minDelay, 1) / n;
+  std::cout << usPerTti << " us/TTI"
+            << " (" << minDelay << " ms elapsed)\t"
+            << scheduler << ", " << ues << " UEs, " << bandwidth << " RBs"
+            << "\tdigest " << std::hex << digest << std::dec << std::endl;
+  return 0;
+}
@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/lte-helper.h"
+#include "ns3/mobility-module.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/type-id.h"
+#include "ns3/simulator.h"
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/*
+ * Cost of a system-level LTE simulation: eNBs on a square grid, 500 m
+ * apart, each serving UEs spread over a disc around it, with full
+ * buffers in both directions. Every signal of an eNB or UE reaches every
+ * UE or eNB, so that the spectrum channel given delivers a number of
+ * signals growing with the product of the number of eNBs and UEs.
+ *
+ * The rate printed is the number of TTIs simulated per second of
+ * wall-clock time, and the digest sums up the DL allocations made: two
+ * channels giving the PHYs the same SINRs print the same digest.
+ */
+
+static void
+DlScheduling (uint64_t *digest, uint32_t frameNo, uint32_t subframeNo, uint16_t rnti,
+              uint8_t mcsTb1, uint16_t sizeTb1, uint8_t mcsTb2, uint16_t sizeTb2)
+{
+  // the eNBs schedule in any order
+  uint64_t h = ((uint64_t) frameNo * 10 + subframeNo) * 0x9e3779b97f4a7c15ULL;
+  h ^= ((uint64_t) rnti << 32) | ((uint64_t) mcsTb1 << 16) | sizeTb1;
+  h *= 0xff51afd7ed558ccdULL;
+  *digest += h ^ (h >> 33);
+}
+
+static uint64_t
+RunBenchOneIteration (uint32_t n, std::string channel, uint32_t enbs, uint32_t ues,
+                      double radius, uint64_t *digest)
+{
+  // the SRS periodicity must leave an SRS offset to each UE, and to
+  // the UEs trying random access again while their context is kept
+  static const uint16_t srsPeriodicities[] = { 2, 5, 10, 20, 40, 80, 160, 320 };
+  uint16_t srsPeriodicity = 320;
+  for (uint32_t i = 0; i < sizeof (srsPeriodicities) / sizeof (srsPeriodicities[0]); i++)
+    {
+      if (srsPeriodicities[i] > 2 * ues)
+        {
+          srsPeriodicity = srsPeriodicities[i];
+          break;
+        }
+    }
+  Config::SetDefault ("ns3::LteEnbRrc::SrsPeriodicity", UintegerValue (srsPeriodicity));
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::LogDistancePropagationLossModel"));
+  lteHelper->SetPathlossModelAttribute ("Exponent", DoubleValue (3.5));
+  lteHelper->SetSpectrumChannelType (channel);
+
+  uint32_t side = (uint32_t) std::ceil (std::sqrt ((double) enbs));
+  NodeContainer enbNodes;
+  enbNodes.Create (enbs);
+  Ptr<ListPositionAllocator> enbPositions = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < enbs; i++)
+    {
+      enbPositions->Add (Vector (500.0 * (i % side), 500.0 * (i / side), 30.0));
+    }
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (enbPositions);
+  mobility.Install (enbNodes);
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+
+  NetDeviceContainer ueDevs;
+  for (uint32_t i = 0; i < enbs; i++)
+    {
+      NodeContainer ueNodes;
+      ueNodes.Create (ues);
+      mobility.SetPositionAllocator ("ns3::UniformDiscPositionAllocator",
+                                     "X", DoubleValue (500.0 * (i % side)),
+                                     "Y", DoubleValue (500.0 * (i / side)),
+                                     "rho", DoubleValue (radius));
+      mobility.Install (ueNodes);
+      NetDeviceContainer devs = lteHelper->InstallUeDevice (ueNodes);
+      lteHelper->Attach (devs, enbDevs.Get (i));
+      ueDevs.Add (devs);
+    }
+  int64_t stream = lteHelper->AssignStreams (enbDevs, 1);
+  lteHelper->AssignStreams (ueDevs, 1 + stream);
+  // without the EPC, the bearers are served by RLC SM, with full buffers
+  EpsBearer bearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT);
+  lteHelper->ActivateDataRadioBearer (ueDevs, bearer);
+
+  *digest = 0;
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/LteEnbMac/DlScheduling",
+                                 MakeBoundCallback (&DlScheduling, digest));
+
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Stop (MilliSeconds (n));
+  Simulator::Run ();
+  uint64_t deltaMs = time.End ();
+  Simulator::Destroy ();
+  return deltaMs;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t minIterations = 1;
+  std::string channel = "ns3::LteAbstractSpectrumChannel";
+  uint32_t enbs = 9;
+  uint32_t ues = 10;
+  double radius = 200;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark a multi-cell LTE simulation over a given spectrum channel");
+  cmd.AddValue ("n", "number of TTIs", n);
+  cmd.AddValue ("min-iterations", "number of times the TTIs are simulated", minIterations);
+  cmd.AddValue ("channel", "TypeId of the spectrum channel", channel);
+  cmd.AddValue ("enbs", "number of eNBs", enbs);
+  cmd.AddValue ("ues", "number of UEs of each eNB", ues);
+  cmd.AddValue ("radius", "radius of the disc of the UEs around their eNB, in m", radius);
+  cmd.Parse (argc, argv);
+
+  TypeId tid;
+  if (n == 0 || enbs == 0 || ues == 0 || ues > 160 || !TypeId::LookupByNameFailSafe (channel, &tid))
+    {
+      std::cerr << "Error-- number of TTIs must be specified " <<
+        "by command-line argument --n=(number of TTIs), " <<
+        "an eNB can have from 1 to 160 UEs " <<
+        "and the channel must be a registered TypeId" << std::endl;
+      exit (1);
+    }
+
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  uint64_t digest = 0;
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      minDelay = std::min (minDelay, RunBenchOneIteration (n, channel, enbs, ues, radius, &digest));
+    }
+
+  double ttisPerSecond = 1000.0 * n / std::max<uint64_t> (minDelay, 1);
+  std::cout << ttisPerSecond << " TTIs/s"
+            << " (" << minDelay << " ms elapsed)\t"
+            << enbs << " eNBs, " << ues << " UEs each, " << channel
+            << "\tdigest " << std::hex << digest << std::dec << std::endl;
+  return 0;
+}
@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/object.h"
+#include "ns3/object-factory.h"
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-value.h"
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/*
+ * Cost of creating objects through the attribute system, and of setting
+ * their attributes by name: a small object with a few attributes of its
+ * own and of its parent, as the headers, tags and queue items of the
+ * models have, is created by an ObjectFactory, as the helpers do, and
+ * with CreateObject.
+ */
+
+class BenchBase : public Object
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("BenchBase")
+      .SetParent<Object> ()
+      .AddAttribute ("Size", "The size",
+                     UintegerValue (1500),
+                     MakeUintegerAccessor (&BenchBase::m_size),
+                     MakeUintegerChecker<uint32_t> ())
+      .AddAttribute ("Delay", "The delay",
+                     TimeValue (MilliSeconds (2)),
+                     MakeTimeAccessor (&BenchBase::m_delay),
+                     MakeTimeChecker ())
+      .AddTraceSource ("Counter", "The counter",
+                       MakeTraceSourceAccessor (&BenchBase::m_counter),
+                       "ns3::TracedValueCallback::Uint32")
+      ;
+    return tid;
+  }
+  BenchBase () : m_size (0), m_counter (0) {}
+
+private:
+  uint32_t m_size;
+  Time m_delay;
+  TracedValue<uint32_t> m_counter;
+};
+
+class BenchObject : public BenchBase
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("BenchObject")
+      .SetParent<BenchBase> ()
+      .AddConstructor<BenchObject> ()
+      .AddAttribute ("Rate", "The rate",
+                     DoubleValue (1.0),
+                     MakeDoubleAccessor (&BenchObject::m_rate),
+                     MakeDoubleChecker<double> ())
+      .AddAttribute ("Flow", "The flow",
+                     UintegerValue (0),
+                     MakeUintegerAccessor (&BenchObject::m_flow),
+                     MakeUintegerChecker<uint32_t> ())
+      ;
+    return tid;
+  }
+  BenchObject () : m_rate (0), m_flow (0) {}
+
+private:
+  double m_rate;
+  uint32_t m_flow;
+};
+
+/** The benchmarks */
+enum Bench
+{
+  FACTORY,
+  CREATE_OBJECT,
+  SET_ATTRIBUTE
+};
+
+static uint64_t
+RunBenchOneIteration (uint32_t n, enum Bench bench)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (BenchObject::GetTypeId ());
+  factory.Set ("Size", UintegerValue (100));
+  factory.Set ("Flow", UintegerValue (7));
+  Ptr<BenchObject> object = CreateObject<BenchObject> ();
+
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      switch (bench)
+        {
+        case FACTORY:
+          factory.Create ();
+          break;
+        case CREATE_OBJECT:
+          CreateObject<BenchObject> ();
+          break;
+        case SET_ATTRIBUTE:
+          object->SetAttribute ("Size", UintegerValue (i));
+          break;
+        }
+    }
+  return time.End ();
+}
+
+static void
+RunBench (uint32_t n, uint32_t minIterations, enum Bench bench, std::string name)
+{
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      minDelay = std::min (minDelay, RunBenchOneIteration (n, bench));
+    }
+  double ns = minDelay;
+  ns *= 1000000;
+  ns /= n;
+  std::cout << name << ": " << ns << " ns/object"
+            << " (" << minDelay << " ms elapsed)" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 1000000;
+  uint32_t minIterations = 1;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the creation of objects with attributes");
+  cmd.AddValue ("n", "number of objects", n);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of objects must be positive" << std::endl;
+      exit (1);
+    }
+
+  RunBench (n, minIterations, FACTORY, "ObjectFactory::Create");
+  RunBench (n, minIterations, CREATE_OBJECT, "CreateObject");
+  RunBench (n, minIterations, SET_ATTRIBUTE, "SetAttribute");
+  return 0;
+}
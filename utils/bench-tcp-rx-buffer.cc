@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-rx-buffer.h"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/*
+ * Reassembly benchmark of TcpRxBuffer. The segments of a flow are spread
+ * round-robin over a number of paths with different delays, as ECMP would
+ * do with per-packet load balancing; each path delays its segments by
+ * pathIndex * spread segment times, so the receiver sees several
+ * interleaved in-order streams and a large number of holes.
+ */
+
+static uint32_t g_segmentSize = 1000;
+static uint32_t g_paths = 4;
+static uint32_t g_spread = 16;
+
+/* Arrival order of the segments */
+static std::vector<uint32_t>
+MakeArrivals (uint32_t n)
+{
+  std::vector<std::pair<uint64_t, uint32_t> > arrivals;
+  arrivals.reserve (n);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      uint64_t at = i + static_cast<uint64_t> (i % g_paths) * g_spread;
+      arrivals.push_back (std::make_pair (at, i));
+    }
+  std::stable_sort (arrivals.begin (), arrivals.end ());
+
+  std::vector<uint32_t> order;
+  order.reserve (n);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      order.push_back (arrivals[i].second);
+    }
+  return order;
+}
+
+static uint64_t
+RunBenchOneIteration (const std::vector<uint32_t> &order)
+{
+  TcpRxBuffer buffer (1);
+  buffer.SetMaxBufferSize (1 << 30);
+  Ptr<Packet> segment = Create<Packet> (g_segmentSize);
+  TcpHeader header;
+  uint64_t delivered = 0;
+
+  SystemWallClockMs time;
+  time.Start ();
+  for (std::vector<uint32_t>::const_iterator it = order.begin (); it != order.end (); ++it)
+    {
+      header.SetSequenceNumber (SequenceNumber32 (1 + *it * g_segmentSize));
+      buffer.Add (segment->Copy (), header);
+      buffer.GetSackList (4);
+      if (buffer.Available () > 0)
+        {
+          delivered += buffer.Extract (buffer.Available ())->GetSize ();
+        }
+    }
+  uint64_t deltaMs = time.End ();
+
+  if (delivered != static_cast<uint64_t> (order.size ()) * g_segmentSize)
+    {
+      std::cerr << "Error-- delivered " << delivered << " bytes out of "
+                << order.size () * g_segmentSize << std::endl;
+      exit (1);
+    }
+  return deltaMs;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t minIterations = 1;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark TcpRxBuffer reassembly under multipath reordering");
+  cmd.AddValue ("n", "number of segments", n);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.AddValue ("paths", "number of paths the segments are spread over", g_paths);
+  cmd.AddValue ("spread", "delay difference between two paths, in segments", g_spread);
+  cmd.AddValue ("segment-size", "segment size, in bytes", g_segmentSize);
+  cmd.Parse (argc, argv);
+
+  if (n == 0 || g_paths == 0)
+    {
+      std::cerr << "Error-- number of segments must be specified " <<
+        "by command-line argument --n=(number of segments)" << std::endl;
+      exit (1);
+    }
+
+  std::vector<uint32_t> order = MakeArrivals (n);
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      minDelay = std::min (minDelay, RunBenchOneIteration (order));
+    }
+
+  double ps = n;
+  ps *= 1000;
+  ps /= std::max<uint64_t> (minDelay, 1);
+  std::cout << ps << " segments/s"
+            << " (" << minDelay << " ms elapsed)\t"
+            << g_paths << " paths, spread " << g_spread << std::endl;
+  return 0;
+}
@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/traced-callback.h"
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/packet.h"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/*
+ * Per-packet cost of the trace sources of the devices and protocols:
+ * a set of TracedCallback<Ptr<const Packet> >, most of them without any
+ * sink, is fired for each packet, as PhyTxBegin, MacTx, MacRx, Tx and
+ * Rx are.
+ */
+
+static uint64_t g_bytes = 0;
+
+static void
+Sink (Ptr<const Packet> p)
+{
+  g_bytes += p->GetSize ();
+}
+
+static uint64_t
+RunBenchOneIteration (uint32_t n, uint32_t sources, uint32_t connected, uint32_t sinks)
+{
+  std::vector<TracedCallback<Ptr<const Packet> > > traces (sources);
+  for (uint32_t i = 0; i < connected; ++i)
+    {
+      for (uint32_t j = 0; j < sinks; ++j)
+        {
+          traces[i].ConnectWithoutContext (MakeCallback (&Sink));
+        }
+    }
+  Ptr<const Packet> p = Create<Packet> (100);
+  g_bytes = 0;
+
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      for (uint32_t j = 0; j < sources; ++j)
+        {
+          traces[j] (p);
+        }
+    }
+  uint64_t deltaMs = time.End ();
+
+  if (g_bytes != static_cast<uint64_t> (n) * connected * sinks * 100)
+    {
+      std::cerr << "Error-- sinks called for " << g_bytes << " bytes" << std::endl;
+      exit (1);
+    }
+  return deltaMs;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t minIterations = 1;
+  uint32_t sources = 10;
+  uint32_t connected = 0;
+  uint32_t sinks = 1;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the per-packet cost of TracedCallback trace sources");
+  cmd.AddValue ("n", "number of packets", n);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.AddValue ("sources", "number of trace sources fired per packet", sources);
+  cmd.AddValue ("connected", "number of trace sources with sinks", connected);
+  cmd.AddValue ("sinks", "number of sinks of a connected trace source", sinks);
+  cmd.Parse (argc, argv);
+
+  if (n == 0 || connected > sources)
+    {
+      std::cerr << "Error-- number of packets must be specified " <<
+        "by command-line argument --n=(number of packets)" << std::endl;
+      exit (1);
+    }
+
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      minDelay = std::min (minDelay, RunBenchOneIteration (n, sources, connected, sinks));
+    }
+
+  double ns = minDelay;
+  ns *= 1000000;
+  ns /= n;
+  std::cout << ns << " ns/packet"
+            << " (" << minDelay << " ms elapsed)\t"
+            << sources << " sources, " << connected << " connected, "
+            << sinks << " sinks each" << std::endl;
+  return 0;
+}
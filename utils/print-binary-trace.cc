@@ -0,0 +1,70 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Print a binary trace file, written when the "AsciiTraceBinary" global
+// value is true, as the ascii trace file which would have been written
+// otherwise.
+//
+//   ./waf --run "print-binary-trace --file=trace.tr" > trace.txt
+//
+// The packets are printed by their own headers, hence this program is
+// linked with all the enabled modules.
+
+#include <iostream>
+#include <fstream>
+#include "ns3/command-line.h"
+#include "ns3/packet.h"
+#include "ns3/binary-trace-file.h"
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  std::string file;
+  std::string output;
+  CommandLine cmd;
+  cmd.Usage ("Print a binary trace file as an ascii trace file");
+  cmd.AddValue ("file", "the binary trace file", file);
+  cmd.AddValue ("output", "the ascii trace file to write; standard output if empty", output);
+  cmd.Parse (argc, argv);
+
+  BinaryTraceReader reader;
+  if (!reader.Open (file))
+    {
+      std::cerr << "Unable to read the binary trace file \"" << file << "\"" << std::endl;
+      return 1;
+    }
+  std::ofstream os;
+  if (!output.empty ())
+    {
+      os.open (output.c_str ());
+      if (!os.is_open ())
+        {
+          std::cerr << "Unable to open \"" << output << "\"" << std::endl;
+          return 1;
+        }
+    }
+  std::ostream &out = output.empty () ? std::cout : os;
+
+  Packet::EnablePrinting ();
+  BinaryTraceReader::Record record;
+  while (reader.Read (record))
+    {
+      BinaryTraceReader::PrintAscii (out, record);
+    }
+  return 0;
+}